@@ -1,4 +1,5 @@
 #include "ANSITerminal.h"
+#include "Assets/CompiledANSI.h"
 #include "GraphicsDrivers/GraphicsDriver.h"
 #include "Timers/Timer.h"
 #include "Utils/LiteStream.h"
@@ -37,6 +38,17 @@ const unsigned int ansiColourMap[16] =
 namespace Agape
 {
 
+ANSITerminal::SGRState::SGRState() :
+    m_foregroundColour( 7 ),
+    m_backgroundColour( 0 ),
+    m_bold( false ),
+    m_blink( false ),
+    m_charset( 0 ),
+    m_attributes( 0x07 ), // Grey on black.
+    m_reset( false )
+{
+}
+
 ANSITerminal::ANSITerminal( int width,
                             int height,
                             const String& windowName,
@@ -45,12 +57,7 @@ ANSITerminal::ANSITerminal( int width,
                             Terminal* drawTerminal,
                             bool haveBuffer ) :
     Terminal( width, height, windowName, graphicsDriver, timer, drawTerminal, haveBuffer ),
-    m_consumingSequence( false ),
-    m_ansiForegroundColour( 7 ),
-    m_ansiBackgroundColour( 0 ),
-    m_sgrBold( false ),
-    m_sgrBlink( false ),
-    m_charset( 0 )
+    m_consumingSequence( false )
 {
 }
 
@@ -79,7 +86,9 @@ void ANSITerminal::consumeChar( char c,
         if( c == 'm' )
         {
             m_consumingSequence = false;
-            parseSGRSequence();
+            m_sgr.m_attributes = m_characterAttributes;
+            parseSGRSequence( m_currentSequence, m_sgr );
+            m_characterAttributes = m_sgr.m_attributes;
             m_currentSequence.clear();
         }
         else if( c == 'A' || c == 'B' || c == 'C' || c == 'D' )
@@ -151,7 +160,7 @@ void ANSITerminal::consumeChar( char c,
                 cx.m_attributes = m_characterAttributes;
                 if( charset == -1 )
                 {
-                    cx.m_charset = m_charset; // Use current terminal charset
+                    cx.m_charset = m_sgr.m_charset; // Use current terminal charset
                 }
                 else
                 {
@@ -199,6 +208,22 @@ void ANSITerminal::consumeChar( char c,
     }
 }
 
+void ANSITerminal::consumeCompiled( const Assets::CompiledANSI& compiled,
+                                    int frame,
+                                    int charMode,
+                                    char* drawMap,
+                                    int mapValue,
+                                    char charset )
+{
+    int currentCharset( m_sgr.m_charset );
+    Terminal::consumeCompiled( compiled, frame, charMode, drawMap, mapValue, ( charset == -1 ) ? currentCharset : charset );
+
+    // Leave things as the asset left them, as if we'd consumed it.
+    m_sgr = compiled.state();
+    if( m_sgr.m_charset == -1 ) m_sgr.m_charset = currentCharset;
+    m_characterAttributes = m_sgr.m_attributes;
+}
+
 int ANSITerminal::countPrinting( const String& string ) const
 {
     int numPrinting( 0 );
@@ -297,24 +322,24 @@ int ANSITerminal::fromTermColour( int termColour )
     return ansiColourMap[termColour];
 }
 
-void ANSITerminal::parseSGRSequence()
+void ANSITerminal::parseSGRSequence( const String& sequence, SGRState& state )
 {
-    std::size_t from( m_currentSequence.find( '[' ) );
+    std::size_t from( sequence.find( '[' ) );
     ++from;
 
-    std::size_t nextDelim = m_currentSequence.find( ';', from);
+    std::size_t nextDelim = sequence.find( ';', from);
     while( nextDelim != String::npos )
     {
-        String match( m_currentSequence.substr( from, nextDelim - from ) );
-        parseSGRAttribute( ::atoi( match.c_str() ) );
+        String match( sequence.substr( from, nextDelim - from ) );
+        parseSGRAttribute( ::atoi( match.c_str() ), state );
         from = nextDelim + 1;
-        nextDelim = m_currentSequence.find( ';', from);
+        nextDelim = sequence.find( ';', from);
     }
 
-    if( from != m_currentSequence.length() )
+    if( from != sequence.length() )
     {
-        String match( m_currentSequence.substr( from, m_currentSequence.length() - from - 1 ) );
-        parseSGRAttribute( ::atoi( match.c_str() ) );  
+        String match( sequence.substr( from, sequence.length() - from - 1 ) );
+        parseSGRAttribute( ::atoi( match.c_str() ), state );  
     }
 }
 
@@ -345,12 +370,12 @@ void ANSITerminal::parseCursorSequence()
     }
 }
 
-void ANSITerminal::parseSGRAttribute( int attribute )
+void ANSITerminal::parseSGRAttribute( int attribute, SGRState& state )
 {
     // Create bright foreground colour on "bold" attribute,
     // and bright background colour on "blink" attribute (iCE colours).
-    if( ( m_sgrBold && attribute >= 30 && attribute <= 37 ) ||
-        ( m_sgrBlink && attribute >= 40 && attribute <= 47 ) )
+    if( ( state.m_bold && attribute >= 30 && attribute <= 37 ) ||
+        ( state.m_blink && attribute >= 40 && attribute <= 47 ) )
     {
         attribute += 60;
     }
@@ -358,47 +383,48 @@ void ANSITerminal::parseSGRAttribute( int attribute )
     if( attribute == 0 )
     {
         // Grey on black.
-        m_ansiForegroundColour = 7;
-        m_ansiBackgroundColour = 0;
-        m_characterAttributes = ( ansiColourMap[m_ansiBackgroundColour] << 4 ) + ansiColourMap[m_ansiForegroundColour];
-        m_sgrBold = 0;
-        m_sgrBlink = 0;
+        state.m_foregroundColour = 7;
+        state.m_backgroundColour = 0;
+        state.m_attributes = ( ansiColourMap[state.m_backgroundColour] << 4 ) + ansiColourMap[state.m_foregroundColour];
+        state.m_bold = 0;
+        state.m_blink = 0;
+        state.m_reset = true;
     }
     else if( attribute == 1 )
     {
-        m_sgrBold = 1;
-        m_ansiForegroundColour |= 0x08;
-        m_characterAttributes = ( m_characterAttributes & 0xF0 ) + ansiColourMap[m_ansiForegroundColour];
+        state.m_bold = 1;
+        state.m_foregroundColour |= 0x08;
+        state.m_attributes = ( state.m_attributes & 0xF0 ) + ansiColourMap[state.m_foregroundColour];
     }
     else if( attribute == 5 )
     {
-        m_sgrBlink = 1;
-        m_ansiBackgroundColour |= 0x08;
-        m_characterAttributes = ( m_characterAttributes & 0x0F ) + ( ansiColourMap[m_ansiBackgroundColour] << 4 );
+        state.m_blink = 1;
+        state.m_backgroundColour |= 0x08;
+        state.m_attributes = ( state.m_attributes & 0x0F ) + ( ansiColourMap[state.m_backgroundColour] << 4 );
     }
     else if( attribute >= 10 && attribute <= 19 )
     {
-        m_charset = attribute - 10;
+        state.m_charset = attribute - 10;
     }
     else if( attribute >= 30 && attribute <= 37 )
     {
-        m_ansiForegroundColour = attribute - 30;
-        m_characterAttributes = ( m_characterAttributes & 0xF0 ) + ansiColourMap[m_ansiForegroundColour];
+        state.m_foregroundColour = attribute - 30;
+        state.m_attributes = ( state.m_attributes & 0xF0 ) + ansiColourMap[state.m_foregroundColour];
     }
     else if( attribute >= 90 && attribute <= 97 )
     {
-        m_ansiForegroundColour = attribute - 90 + 8;
-        m_characterAttributes = ( m_characterAttributes & 0xF0 ) + ansiColourMap[m_ansiForegroundColour];
+        state.m_foregroundColour = attribute - 90 + 8;
+        state.m_attributes = ( state.m_attributes & 0xF0 ) + ansiColourMap[state.m_foregroundColour];
     }
     else if( attribute >= 40 && attribute <= 47 )
     {
-        m_ansiBackgroundColour = attribute - 40;
-        m_characterAttributes = ( m_characterAttributes & 0x0F ) + ( ansiColourMap[m_ansiBackgroundColour] << 4 );
+        state.m_backgroundColour = attribute - 40;
+        state.m_attributes = ( state.m_attributes & 0x0F ) + ( ansiColourMap[state.m_backgroundColour] << 4 );
     }
     else if( attribute >= 100 && attribute <= 107 )
     {
-        m_ansiBackgroundColour = attribute - 100 + 8;
-        m_characterAttributes = ( m_characterAttributes & 0x0F ) + ( ansiColourMap[m_ansiBackgroundColour] << 4 );
+        state.m_backgroundColour = attribute - 100 + 8;
+        state.m_attributes = ( state.m_attributes & 0x0F ) + ( ansiColourMap[state.m_backgroundColour] << 4 );
     }
 }
 
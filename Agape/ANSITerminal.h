@@ -14,6 +14,23 @@ class Timer;
 class ANSITerminal : public Terminal
 {
 public:
+    /// @brief The colours and charset selected by SGR sequences so far.
+    struct SGRState
+    {
+        SGRState();
+
+        int m_foregroundColour;
+        int m_backgroundColour;
+        bool m_bold;
+        bool m_blink;
+        int m_charset;
+        int m_attributes;
+
+        // Set by a reset, after which the state no longer depends on what it
+        // was before.
+        bool m_reset;
+    };
+
     ANSITerminal( int width,
                   int height,
                   const String& windowName,
@@ -37,6 +54,13 @@ public:
                               int mapValue = 0,
                               char charset = -1 );
     
+    virtual void consumeCompiled( const Assets::CompiledANSI& compiled,
+                                  int frame = 0,
+                                  int charMode = 0,
+                                  char* drawMap = nullptr,
+                                  int mapValue = 0,
+                                  char charset = -1 );
+
     virtual int countPrinting( const String& string ) const;
 
     static String colours( int bgColour, int fgColour );
@@ -48,19 +72,16 @@ public:
 
     static int fromTermColour( int termColour );
 
+    static void parseSGRSequence( const String& sequence, SGRState& state );
+
 private:
-    void parseSGRSequence();
     void parseCursorSequence();
-    void parseSGRAttribute( int attribute );
+    static void parseSGRAttribute( int attribute, SGRState& state );
 
     bool m_consumingSequence;
     String m_currentSequence;
 
-    int m_ansiForegroundColour;
-    int m_ansiBackgroundColour;
-    bool m_sgrBold;
-    bool m_sgrBlink;
-    int m_charset;
+    SGRState m_sgr;
 };
 
 } // namespace Agape
@@ -2,6 +2,7 @@
 #define AGAPE_ASSET_LOADER_H
 
 #include "World/WorldCoordinates.h"
+#include "Collections.h"
 #include "RandomReadableWritable.h"
 #include "String.h"
 
@@ -17,6 +18,21 @@ public:
         modeWrite
     };
 
+    struct Revalidation
+    {
+        enum State
+        {
+            unknown,
+            current,
+            stale,
+            missing
+        };
+
+        String m_name;
+        String m_version;
+        enum State m_state;
+    };
+
     AssetLoader( const World::Coordinates& coordinates, const String& name );
     virtual ~AssetLoader();
 
@@ -33,7 +49,17 @@ public:
 
     virtual bool error() { return false; };
 
+    // Opaque content version (hash) of the opened asset. Empty if the loader
+    // doesn't know - in which case cached copies can't be revalidated.
+    virtual String version() { return String(); };
+
+    // Check a batch of (name, version) pairs against the backing store in a
+    // single request, setting m_state for each. Returns false if the loader
+    // can't revalidate, in which case callers should treat all as stale.
+    virtual bool revalidate( Vector< struct Revalidation >& revalidations ) { return false; };
+
     virtual void invalidateCached( bool all = false ) {};
+    virtual void revalidateCached() {};
 
 protected:
     const World::Coordinates m_coordinates;
@@ -298,6 +298,16 @@ bool Cache::error()
     return false;
 }
 
+String Cache::version()
+{
+    if( m_assetBackingLoader )
+    {
+        return m_assetBackingLoader->version();
+    }
+
+    return String();
+}
+
 void Cache::invalidateCached( bool all )
 {
     if( all )
@@ -310,6 +320,11 @@ void Cache::invalidateCached( bool all )
     }
 }
 
+void Cache::revalidateCached()
+{
+    m_assetCache.revalidateAll( m_coordinates, m_assetLoaderBackingFactory );
+}
+
 String Cache::nameOrHash( const String& name )
 {
     if( m_encryptName )
@@ -42,7 +42,10 @@ public:
 
     virtual bool error();
 
+    virtual String version();
+
     virtual void invalidateCached( bool all = false );
+    virtual void revalidateCached();
 
 private:
     String nameOrHash( const String& name );
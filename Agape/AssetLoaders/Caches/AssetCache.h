@@ -40,6 +40,12 @@ public:
     virtual void invalidate( const String& assetName,
                              const Coordinates& coordinates ) = 0;
     virtual void invalidateAll() = 0;
+
+    // Check every cached asset against the backing store in one batch and
+    // invalidate only those that have changed. Falls back to invalidateAll()
+    // if the backing loader can't revalidate.
+    virtual void revalidateAll( const Coordinates& coordinates,
+                                AssetLoaders::Factory& backingLoaderFactory ) = 0;
 };
 
 } // namespace AssetLoaders
@@ -13,9 +13,18 @@
 #include "KiamaFSAssetCache.h"
 #include "String.h"
 
+#include <string.h>
+
 namespace
 {
     const int maxBlockSize( 256 );
+
+    // Cached files are prefixed with a header holding the asset name and
+    // version, so that they can be revalidated after a restart:
+    // [magic (4)][name length (1)][name][version length (1)][version]
+    const char headerMagic[] = { '\0', 'A', 'C', '1' };
+    const int headerMagicSize( sizeof( headerMagic ) );
+    const int maxHeaderFieldLength( 255 );
 } // Anonymous namespace
 
 namespace Agape
@@ -29,8 +38,9 @@ namespace AssetLoaders
 namespace Caches
 {
 
-KiamaFSCachedAsset::KiamaFSCachedAsset( KiamaFS::File* file ) :
-  m_file( file )
+KiamaFSCachedAsset::KiamaFSCachedAsset( KiamaFS::File* file, int headerSize ) :
+  m_file( file ),
+  m_headerSize( headerSize )
 {
 }
 
@@ -41,13 +51,13 @@ KiamaFSCachedAsset::~KiamaFSCachedAsset()
 
 int KiamaFSCachedAsset::read( char* data, int offset, int len )
 {
-    m_file->seek( offset ); // FIXME: Unnecessary for reads at monotonic offsets?
+    m_file->seek( m_headerSize + offset ); // FIXME: Unnecessary for reads at monotonic offsets?
     return m_file->read( data, len );
 }
 
 int KiamaFSCachedAsset::size()
 {
-    return m_file->size();
+    return m_file->size() - m_headerSize;
 }
 
 void KiamaFSCachedAsset::close()
@@ -96,7 +106,8 @@ CachedAsset* KiamaFSAssetCache::tryOpen( const String& assetName,
             KiamaFS::File* file( m_fs.file( it->m_name ) );
             if( file->open( KiamaFS::File::readMode ) )
             {
-                cachedAsset = new KiamaFSCachedAsset( file );
+                it->m_lastAccessed = m_clock.epochS();
+                cachedAsset = new KiamaFSCachedAsset( file, it->m_headerSize );
                 break;
             }
             else
@@ -138,9 +149,7 @@ void KiamaFSAssetCache::invalidate( const String& assetName,
     {
         if( it->m_name == filename )
         {
-            KiamaFS::File* file( m_fs.file( it->m_name ) );
-            file->erase();
-            delete( file );
+            erase( it );
             break;
         }
     }
@@ -154,16 +163,88 @@ void KiamaFSAssetCache::invalidateAll()
     LOG_DEBUG( "KiamaFSAssetCache: Invalidating all" );
 #endif
     Vector< _KiamaFSCachedAsset >::iterator it( m_cachedAssets.begin() );
-    for( ; it != m_cachedAssets.end(); ++it )
+    while( it != m_cachedAssets.end() )
     {
-        KiamaFS::File* file( m_fs.file( it->m_name ) );
-        file->erase();
-        delete( file );
+        it = erase( it );
+    }
+}
+
+void KiamaFSAssetCache::revalidateAll( const Coordinates& coordinates,
+                                       AssetLoaders::Factory& backingLoaderFactory )
+{
+    if( !m_loaded ) load();
+
+    // Only assets belonging to the given world can be checked against the
+    // backing loader. Assets cached for other worlds have distinct filenames
+    // and so can't be confused with this world's, and are left alone.
+    String worldPart( worldPartForCoordinates( coordinates ) );
+
+    Vector< struct AssetLoader::Revalidation > revalidations;
+    Vector< String > filenames;
+    Vector< _KiamaFSCachedAsset >::iterator it( m_cachedAssets.begin() );
+    while( it != m_cachedAssets.end() )
+    {
+        if( it->m_name.compare( 1, worldPart.length(), worldPart ) != 0 )
+        {
+            ++it;
+        }
+        else if( it->m_version.empty() )
+        {
+            // Unversioned - can't revalidate.
+            it = erase( it );
+        }
+        else
+        {
+            struct AssetLoader::Revalidation revalidation;
+            revalidation.m_name = it->m_assetName;
+            revalidation.m_version = it->m_version;
+            revalidation.m_state = AssetLoader::Revalidation::unknown;
+            revalidations.push_back( revalidation );
+            filenames.push_back( it->m_name );
+            ++it;
+        }
+    }
+
+    if( revalidations.empty() )
+    {
+        return;
+    }
+
+#ifdef LOG_LOADERS
+    {
+    LiteStream stream;
+    stream << "KiamaFSAssetCache: Revalidating " << (int)revalidations.size() << " assets";
+    LOG_DEBUG( stream.str() );
+    }
+#endif
+
+    AssetLoader* assetBackingLoader( backingLoaderFactory.makeLoader( coordinates, String() ) );
+    bool success( assetBackingLoader->revalidate( revalidations ) );
+    delete( assetBackingLoader );
+
+    for( int i = 0; i < revalidations.size(); ++i )
+    {
+        if( !success || ( revalidations[i].m_state != AssetLoader::Revalidation::current ) )
+        {
+#ifdef LOG_LOADERS
+            LOG_DEBUG( "KiamaFSAssetCache: Stale: " + revalidations[i].m_name );
+#endif
+            for( it = m_cachedAssets.begin(); it != m_cachedAssets.end(); ++it )
+            {
+                if( it->m_name == filenames[i] )
+                {
+                    erase( it );
+                    break;
+                }
+            }
+        }
     }
 }
 
 void KiamaFSAssetCache::load()
 {
+    Vector< String > invalidFilenames;
+
     const Map< String, KiamaFS::IndexEntry >& index( m_fs.getIndex() );
     Map< String, KiamaFS::IndexEntry >::const_iterator it( index.begin() );
     for( ; it != index.end(); ++it )
@@ -182,13 +263,94 @@ void KiamaFSAssetCache::load()
             struct _KiamaFSCachedAsset _cachedAsset;
             _cachedAsset.m_name = it->first;
             _cachedAsset.m_lastAccessed = m_clock.epochS();
-            m_cachedAssets.push_back( _cachedAsset );
+
+            KiamaFS::File* file( m_fs.file( it->first ) );
+            if( file->open( KiamaFS::File::readMode ) &&
+                readHeader( file, _cachedAsset ) )
+            {
+                m_cachedAssets.push_back( _cachedAsset );
+            }
+            else
+            {
+                // Cached by an older version without a header.
+                invalidFilenames.push_back( it->first );
+            }
+            delete( file );
         }
     }
 
+    // Erase after iterating, as erasing modifies the index.
+    Vector< String >::const_iterator invalidIt( invalidFilenames.begin() );
+    for( ; invalidIt != invalidFilenames.end(); ++invalidIt )
+    {
+#ifdef LOG_LOADERS
+        LOG_DEBUG( "KiamaFSAssetCache: Erasing cached asset without valid header " + *invalidIt );
+#endif
+        KiamaFS::File* file( m_fs.file( *invalidIt ) );
+        file->erase();
+        delete( file );
+    }
+
     m_loaded = true;
 }
 
+bool KiamaFSAssetCache::readHeader( KiamaFS::File* file,
+                                    struct _KiamaFSCachedAsset& _cachedAsset )
+{
+    char magic[headerMagicSize];
+    if( ( file->read( magic, headerMagicSize ) != headerMagicSize ) ||
+        ( ::memcmp( magic, headerMagic, headerMagicSize ) != 0 ) )
+    {
+        return false;
+    }
+
+    String* fields[2] = { &_cachedAsset.m_assetName, &_cachedAsset.m_version };
+    int headerSize( headerMagicSize );
+    for( int i = 0; i < 2; ++i )
+    {
+        unsigned char fieldLength;
+        if( file->read( (char*)&fieldLength, 1 ) != 1 )
+        {
+            return false;
+        }
+
+        fields[i]->assign( fieldLength, '\0' );
+        if( ( fieldLength > 0 ) &&
+            ( file->read( &( *fields[i] )[0], fieldLength ) != fieldLength ) )
+        {
+            return false;
+        }
+
+        headerSize += 1 + fieldLength;
+    }
+
+    _cachedAsset.m_headerSize = headerSize;
+
+    return true;
+}
+
+bool KiamaFSAssetCache::writeHeader( KiamaFS::File* file,
+                                     const struct _KiamaFSCachedAsset& _cachedAsset )
+{
+    String header( headerMagic, headerMagicSize );
+    const String* fields[2] = { &_cachedAsset.m_assetName, &_cachedAsset.m_version };
+    for( int i = 0; i < 2; ++i )
+    {
+        header += (char)fields[i]->length();
+        header += *fields[i];
+    }
+
+    return( file->write( header.c_str(), header.length() ) == header.length() );
+}
+
+Vector< KiamaFSAssetCache::_KiamaFSCachedAsset >::iterator KiamaFSAssetCache::erase( Vector< _KiamaFSCachedAsset >::iterator it )
+{
+    KiamaFS::File* file( m_fs.file( it->m_name ) );
+    file->erase();
+    delete( file );
+    return m_cachedAssets.erase( it );
+}
+
 KiamaFSCachedAsset* KiamaFSAssetCache::tryCache( const String& assetName,
                                                  const Coordinates& coordinates,
                                                  AssetLoaders::Factory& backingLoaderFactory )
@@ -207,14 +369,28 @@ KiamaFSCachedAsset* KiamaFSAssetCache::tryCache( const String& assetName,
     LOG_DEBUG( "KiamaFSAssetCache: Opening asset with backing loader to cache" );
 #endif
     AssetLoader* assetBackingLoader( backingLoaderFactory.makeLoader( coordinates, assetName ) );
-    if( assetBackingLoader->open() && ( assetBackingLoader->size() <= m_maxAssetSize ) )
+    if( assetBackingLoader->open() &&
+        ( assetBackingLoader->size() <= m_maxAssetSize ) &&
+        ( assetName.length() <= maxHeaderFieldLength ) )
     {
 #ifdef LOG_LOADERS
         LOG_DEBUG( "KiamaFSAssetCache: Opening KiamaFS file to write" );
 #endif
         String filename( filenameForAsset( assetName, coordinates ) );
+
+        struct _KiamaFSCachedAsset _cachedAsset;
+        _cachedAsset.m_name = filename;
+        _cachedAsset.m_assetName = assetName;
+        _cachedAsset.m_version = assetBackingLoader->version();
+        if( _cachedAsset.m_version.length() > maxHeaderFieldLength )
+        {
+            _cachedAsset.m_version.clear();
+        }
+        _cachedAsset.m_headerSize = headerMagicSize + 2 + _cachedAsset.m_assetName.length() + _cachedAsset.m_version.length();
+
         KiamaFS::File* writeFile( m_fs.file( filename ) );
-        if( writeFile->open( KiamaFS::File::writeMode ) )
+        if( writeFile->open( KiamaFS::File::writeMode ) &&
+            writeHeader( writeFile, _cachedAsset ) )
         {
             char buffer[maxBlockSize];
             int offset( 0 );
@@ -253,11 +429,9 @@ KiamaFSCachedAsset* KiamaFSAssetCache::tryCache( const String& assetName,
                     LOG_DEBUG( "KiamaFSAssetCache: Committed and opened successfully." );
 #endif
                     // Return new cached asset to original caller.
-                    cachedAsset = new KiamaFSCachedAsset( readFile );
+                    cachedAsset = new KiamaFSCachedAsset( readFile, _cachedAsset.m_headerSize );
 
-                    // Store filename in our list of extant cached assets.
-                    struct _KiamaFSCachedAsset _cachedAsset;
-                    _cachedAsset.m_name = filename;
+                    // Store in our list of extant cached assets.
                     _cachedAsset.m_lastAccessed = m_clock.epochS();
                     m_cachedAssets.push_back( _cachedAsset );
                 }
@@ -305,10 +479,7 @@ bool KiamaFSAssetCache::evictOldest()
                << oldestIt->m_lastAccessed;
         LOG_DEBUG( stream.str() );
 #endif
-        KiamaFS::File* file( m_fs.file( oldestIt->m_name ) );
-        file->erase();
-        delete( file );
-        m_cachedAssets.erase( oldestIt );
+        erase( oldestIt );
         return true;
     }
 
@@ -324,7 +495,7 @@ String KiamaFSAssetCache::filenameForAsset( const String& assetName,
     // bbbbbbbb = First eight characters of Base64 of hash of assetName.
     // Base64 to have substitutions '_' => '/', '-' => '+'.
 
-    String worldPart( escapeBase64( coordinates.m_worldID.substr( 0, 8 ) ) );
+    String worldPart( worldPartForCoordinates( coordinates ) );
 
     m_hash.reset();
     m_hash.update( assetName.c_str(), assetName.length() );
@@ -342,6 +513,11 @@ String KiamaFSAssetCache::filenameForAsset( const String& assetName,
     return( "$" + worldPart + "_" + hashPart + "." + m_extension );
 }
 
+String KiamaFSAssetCache::worldPartForCoordinates( const Coordinates& coordinates )
+{
+    return escapeBase64( coordinates.m_worldID.substr( 0, 8 ) );
+}
+
 } // namespace Caches
 
 } // namespace AssetLoaders
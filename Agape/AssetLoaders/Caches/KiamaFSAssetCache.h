@@ -30,7 +30,7 @@ namespace Caches
 class KiamaFSCachedAsset : public CachedAsset
 {
 public:
-    KiamaFSCachedAsset( KiamaFS::File* file );
+    KiamaFSCachedAsset( KiamaFS::File* file, int headerSize );
     ~KiamaFSCachedAsset();
 
     virtual int read( char* data, int offset, int len );
@@ -39,6 +39,7 @@ public:
 
 private:
     KiamaFS::File* m_file;
+    int m_headerSize;
 };
 
 class KiamaFSAssetCache : public AssetCache
@@ -59,15 +60,28 @@ public:
                              const Coordinates& coordinates );
     virtual void invalidateAll();
 
+    virtual void revalidateAll( const Coordinates& coordinates,
+                                AssetLoaders::Factory& backingLoaderFactory );
+
 private:
     struct _KiamaFSCachedAsset
     {
-        String m_name;
+        String m_name; // Filename.
+        String m_assetName;
+        String m_version;
+        int m_headerSize;
         long long m_lastAccessed;
     };
 
     void load();
 
+    static bool readHeader( KiamaFS::File* file,
+                            struct _KiamaFSCachedAsset& _cachedAsset );
+    static bool writeHeader( KiamaFS::File* file,
+                             const struct _KiamaFSCachedAsset& _cachedAsset );
+
+    Vector< _KiamaFSCachedAsset >::iterator erase( Vector< _KiamaFSCachedAsset >::iterator it );
+
     KiamaFSCachedAsset* tryCache( const String& assetName,
                                   const Coordinates& coordinates,
                                   AssetLoaders::Factory& backingLoaderFactory );
@@ -75,6 +89,7 @@ private:
 
     String filenameForAsset( const String& assetName,
                              const Coordinates& coordinates );
+    String worldPartForCoordinates( const Coordinates& coordinates );
 
     int m_numAssets;
     int m_maxAssetSize;
@@ -1,8 +1,10 @@
 #include "AssetLoaders/Factories/AssetLoadersFactory.h"
+#include "AssetLoaders/AssetLoader.h"
 #include "Clocks/Clock.h"
 #include "Loggers/Logger.h"
 #include "Utils/LiteStream.h"
 #include "World/WorldCoordinates.h"
+#include "Collections.h"
 #include "RAMAssetCache.h"
 #include "String.h"
 
@@ -56,7 +58,7 @@ RAMAssetCache::RAMAssetCache( int numAssets,
 {
     m_assets = new _RAMCachedAsset[numAssets];
     m_slab = new char[numAssets * maxAssetSize];
-    ::memset( m_assets, '\0', sizeof( CachedAsset ) * numAssets );
+    ::memset( m_assets, '\0', sizeof( _RAMCachedAsset ) * numAssets );
 
     for( int i = 0; i < numAssets; ++i )
     {
@@ -154,6 +156,70 @@ void RAMAssetCache::invalidateAll()
 #endif
 }
 
+void RAMAssetCache::revalidateAll( const Coordinates& coordinates,
+                                   AssetLoaders::Factory& backingLoaderFactory )
+{
+    Vector< struct AssetLoader::Revalidation > revalidations;
+    Vector< int > indices;
+    for( int i = 0; i < m_numAssets; ++i )
+    {
+        _RAMCachedAsset& _cachedAsset( m_assets[i] );
+        if( _cachedAsset.m_name[0] == '\0' ) continue;
+
+        if( _cachedAsset.m_version[0] == '\0' )
+        {
+            // Unversioned - can't revalidate.
+            _cachedAsset.m_name[0] = '\0';
+            continue;
+        }
+
+        int nameLength( 0 );
+        while( ( nameLength < CACHE_NAME_MAX_LENGTH ) && _cachedAsset.m_name[nameLength] ) ++nameLength;
+
+        struct AssetLoader::Revalidation revalidation;
+        revalidation.m_name = String( _cachedAsset.m_name, nameLength );
+        revalidation.m_version = _cachedAsset.m_version;
+        revalidation.m_state = AssetLoader::Revalidation::unknown;
+        revalidations.push_back( revalidation );
+        indices.push_back( i );
+    }
+
+    if( revalidations.empty() )
+    {
+        return;
+    }
+
+    AssetLoader* assetBackingLoader( backingLoaderFactory.makeLoader( coordinates, String() ) );
+    bool success( assetBackingLoader->revalidate( revalidations ) );
+    delete( assetBackingLoader );
+
+    if( !success )
+    {
+#ifdef LOG_LOADERS
+        LOG_DEBUG( "RAMAssetCache: Backing loader unable to revalidate" );
+#endif
+        invalidateAll();
+        return;
+    }
+
+    int numInvalidated( 0 );
+    for( int i = 0; i < revalidations.size(); ++i )
+    {
+        if( revalidations[i].m_state != AssetLoader::Revalidation::current )
+        {
+            m_assets[indices[i]].m_name[0] = '\0';
+            ++numInvalidated;
+        }
+    }
+
+#ifdef LOG_LOADERS
+    LiteStream stream;
+    stream << "RAMAssetCache: Revalidated " << (int)revalidations.size()
+           << " assets, invalidated " << numInvalidated;
+    LOG_DEBUG( stream.str() );
+#endif
+}
+
 RAMCachedAsset* RAMAssetCache::tryCache( const String& assetName,
                                          const Coordinates& coordinates,
                                          AssetLoaders::Factory& backingLoaderFactory )
@@ -171,6 +237,15 @@ RAMCachedAsset* RAMAssetCache::tryCache( const String& assetName,
             LOG_DEBUG( "RAMAssetCache: Caching from backing loader" );
     #endif
             ::strncpy( _cachedAsset->m_name, assetName.c_str(), CACHE_NAME_MAX_LENGTH );
+            String version( assetBackingLoader->version() );
+            if( version.length() < CACHE_VERSION_MAX_LENGTH )
+            {
+                ::strncpy( _cachedAsset->m_version, version.c_str(), CACHE_VERSION_MAX_LENGTH );
+            }
+            else
+            {
+                _cachedAsset->m_version[0] = '\0';
+            }
             _cachedAsset->m_lastAccessed = m_clock.epochS();
             _cachedAsset->m_size = assetBackingLoader->size();
 
@@ -9,6 +9,8 @@
 #define CACHE_NAME_MAX_LENGTH 64 // Sufficient to hold hashes of assets on Stratus
 #endif
 
+#define CACHE_VERSION_MAX_LENGTH 48 // Sufficient to hold Base64 of SHA-256 digest
+
 namespace Agape
 {
 
@@ -60,10 +62,14 @@ public:
                              const Coordinates& coordinates );
     virtual void invalidateAll();
 
+    virtual void revalidateAll( const Coordinates& coordinates,
+                                AssetLoaders::Factory& backingLoaderFactory );
+
 private:
     struct _RAMCachedAsset
     {
         char m_name[CACHE_NAME_MAX_LENGTH];
+        char m_version[CACHE_VERSION_MAX_LENGTH];
         long long m_lastAccessed;
         int m_size;
         char* m_data;
@@ -10,6 +10,7 @@
 #include "World/WorldCoordinates.h"
 #include "World/WorldMetadata.h"
 #include "AssetLoader.h"
+#include "Collections.h"
 #include "EncryptedAssetLoader.h"
 #include "String.h"
 #include "StringConstants.h"
@@ -79,9 +80,7 @@ bool Encrypted::open( enum OpenMode openMode, const String& linkedItem )
 
     if( openMode == modeRead )
     {
-        if( ( m_name == _message ) ||
-            ( m_name == _World ) ||
-            ( m_name.rfind( _scene_, 0 ) == 0 ) )
+        if( worldOnly( m_name ) )
         {
             // World MOTD: Open in current world assets only.
             // Ditto world-wide program and scene-wide programs.
@@ -191,6 +190,108 @@ bool Encrypted::error()
     return( m_backingLoader->error() );
 }
 
+String Encrypted::version()
+{
+    if( m_backingLoader )
+    {
+        return( m_backingLoader->version() );
+    }
+
+    return String();
+}
+
+bool Encrypted::revalidate( Vector< struct Revalidation >& revalidations )
+{
+    // Mirror the lookup order of open(): current world first, then shared
+    // assets for anything not found in the current world.
+    Vector< int > worldIndices;
+    Vector< int > sharedIndices;
+    for( int i = 0; i < revalidations.size(); ++i )
+    {
+        revalidations[i].m_state = Revalidation::missing;
+        if( revalidations[i].m_name == _servermessage )
+        {
+            sharedIndices.push_back( i );
+        }
+        else
+        {
+            worldIndices.push_back( i );
+        }
+    }
+
+    if( !tryRevalidate( revalidations, worldIndices, m_worldMetadata.m_worldID, &m_worldMetadata.m_itemKey[0] ) )
+    {
+        return false;
+    }
+
+    if( !m_sharedAssetsWorldID.empty() &&
+        m_sharedAssetsItemKey )
+    {
+        Vector< int >::const_iterator it( worldIndices.begin() );
+        for( ; it != worldIndices.end(); ++it )
+        {
+            if( ( revalidations[*it].m_state == Revalidation::missing ) &&
+                !worldOnly( revalidations[*it].m_name ) )
+            {
+                sharedIndices.push_back( *it );
+            }
+        }
+
+        if( !tryRevalidate( revalidations, sharedIndices, m_sharedAssetsWorldID, m_sharedAssetsItemKey ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Encrypted::worldOnly( const String& assetNamePlain )
+{
+    // World MOTD, world-wide program and scene-wide programs are never
+    // loaded from shared assets.
+    return( ( assetNamePlain == _message ) ||
+            ( assetNamePlain == _World ) ||
+            ( assetNamePlain.rfind( _scene_, 0 ) == 0 ) );
+}
+
+bool Encrypted::tryRevalidate( Vector< struct Revalidation >& revalidations,
+                               const Vector< int >& indices,
+                               const String& worldID,
+                               const char* itemKey )
+{
+    if( indices.empty() )
+    {
+        return true;
+    }
+
+    Vector< struct Revalidation > backingRevalidations;
+    Vector< int >::const_iterator it( indices.begin() );
+    for( ; it != indices.end(); ++it )
+    {
+        struct Revalidation revalidation( revalidations[*it] );
+        if( m_encryptName && m_hash )
+        {
+            revalidation.m_name = encryptedAssetName( itemKey, revalidation.m_name );
+        }
+        backingRevalidations.push_back( revalidation );
+    }
+
+    AssetLoader* backingLoader( m_backingLoaderFactory.makeLoader( Coordinates( worldID ), String() ) );
+    bool success( backingLoader->revalidate( backingRevalidations ) );
+    delete( backingLoader );
+
+    if( success )
+    {
+        for( int i = 0; i < indices.size(); ++i )
+        {
+            revalidations[indices[i]].m_state = backingRevalidations[i].m_state;
+        }
+    }
+
+    return success;
+}
+
 String Encrypted::encryptedAssetName( const char* itemKey,
                                       const String& assetNamePlain )
 {
@@ -57,6 +57,9 @@ public:
 
     virtual bool error();
 
+    virtual String version();
+    virtual bool revalidate( Vector< struct Revalidation >& revalidations );
+
 private:
     Factory& m_backingLoaderFactory;
     Metadata& m_worldMetadata;
@@ -73,6 +76,13 @@ private:
     String encryptedAssetName( const char* itemKey,
                                const String& assetNamePlain );
 
+    bool worldOnly( const String& assetNamePlain );
+
+    bool tryRevalidate( Vector< struct Revalidation >& revalidations,
+                        const Vector< int >& indices,
+                        const String& worldID,
+                        const char* itemKey );
+
     bool tryOpen( enum OpenMode openMode,
                   const String& linkedItem,
                   const String& worldID,
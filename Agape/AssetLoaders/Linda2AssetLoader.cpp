@@ -5,7 +5,7 @@
 #include "World/WorldCoordinates.h"
 #include "AssetLoader.h"
 #include "Linda2AssetLoader.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
@@ -16,6 +16,8 @@
 namespace
 {
     const int maxBlockSize( 256 );
+    const int readAheadBlocks( 4 ); // Outstanding beyond the one being read.
+    const int loadRetries( 1 ); // Reads can safely be asked again.
 } // Anonymous namespace
 
 namespace Agape
@@ -32,21 +34,17 @@ Linda2::Linda2( const World::Coordinates& coordinates,
   AssetLoader( coordinates, name ),
   Native( "AssetLoader" ),
   m_tupleRouter( tupleRouter ),
-  m_timerFactory( timerFactory ),
-  m_isLoading( false ),
   m_collectionName( collectionName ),
+  m_requester( tupleRouter, timerFactory, this ),
   m_isOpen( false ),
   m_openMode( modeRead ),
   m_size( 0 ),
-  m_readData( nullptr ),
-  m_readDataLen( 0 )
+  m_readEnd( 0 )
 {
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2AssetLoader: Created" );
 #endif
     m_tupleRouter.registerActor( this );
-
-    m_readData = new char[maxBlockSize];
 }
 
 Linda2::~Linda2()
@@ -56,7 +54,6 @@ Linda2::~Linda2()
 #endif
     close(); // Ensure closed, so remote responder can close its asset loader.
     m_tupleRouter.deregisterActor( this );
-    delete[]( m_readData );
 }
 
 bool Linda2::open()
@@ -66,32 +63,28 @@ bool Linda2::open()
 
 bool Linda2::open( enum OpenMode openMode, const String& linkedItem )
 {
-    bool success( true );
-
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _AssetLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _AssetOpenRequest );
+    Tuple tuple( request( _AssetOpenRequest ) );
     tuple[_assetName] = m_name;
-    tuple[_collectionName] = m_collectionName;
     tuple[_openMode] = ( openMode == modeWrite ) ? _write : _read;
     tuple[_linkedItem] = linkedItem;
-    m_coordinates.toValue( tuple[_coordinates] );
 
     m_openMode = openMode;
 
-    m_isLoading = true;
-
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2AssetLoader: Sending AssetOpenRequest" );
 #endif
-    m_assetOpenResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    success = m_tupleRouter.route( tuple );
-    if( success ) success = m_assetOpenResponse.getFuture().get();
+    Tuple reply;
+    if( !m_requester.call( tuple, _AssetOpenResponse, reply ) )
+    {
+        return false;
+    }
 
-    m_isLoading = false;
+    m_isOpen = true;
+    m_size = reply[_size];
+    m_version = reply[_version];
+    m_readEnd = 0;
 
-    return success;
+    return true;
 }
 
 int Linda2::read( char* data, int offset, int len )
@@ -103,35 +96,57 @@ int Linda2::read( char* data, int offset, int len )
         stream << "Read " << m_name << " offset " << offset << " len " << len;
         LOG_DEBUG( stream.str() );
 #endif
-
-        Tuple tuple;
-        TupleRouter::setSourceActor( tuple, _AssetLoader );
-        TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-        TupleRouter::setTupleType( tuple, _AssetReadRequest );
-        tuple[_assetName] = m_name;
-        tuple[_collectionName] = m_collectionName;
-        tuple[_offset] = offset;
         int lenToRead( ( len > maxBlockSize ) ? maxBlockSize : len );
-        tuple[_length] = lenToRead;
-        m_coordinates.toValue( tuple[_coordinates] );
 
-        m_isLoading = true;
+        // Anything read ahead is only of use if this read carries on from
+        // the last.
+        if( !m_readAheads.empty() &&
+            ( ( m_readAheads.front().m_offset != offset ) || ( m_readAheads.front().m_length != lenToRead ) ) )
+        {
+            cancelReadAheads();
+        }
 
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2AssetLoader: Sending AssetReadRequest" );
-#endif
-        m_assetReadResponse = Promise( &m_tupleRouter, &m_timerFactory );
-        if( m_tupleRouter.route( tuple ) )
+        if( m_readAheads.empty() )
         {
-            if( m_assetReadResponse.getFuture().get() && ( m_readDataLen == lenToRead ) )
+            int handle( sendRead( offset, lenToRead ) );
+            if( handle == 0 )
             {
-                ::memcpy( data, m_readData, m_readDataLen );
-                m_isLoading = false;
-                return m_readDataLen;
+                return 0;
             }
+            m_readAheads.push_back( { offset, lenToRead, handle } );
         }
 
-        m_isLoading = false;
+        // Once reads are sequential, keep the next few blocks in flight so
+        // that we're not waiting a round trip for each.
+        if( ( offset == 0 ) || ( offset == m_readEnd ) )
+        {
+            int nextOffset( m_readAheads.back().m_offset + lenToRead );
+            while( ( (int)m_readAheads.size() <= readAheadBlocks ) && ( nextOffset < m_size ) )
+            {
+                int handle( sendRead( nextOffset, lenToRead ) );
+                if( handle == 0 )
+                {
+                    break;
+                }
+                m_readAheads.push_back( { nextOffset, lenToRead, handle } );
+                nextOffset += lenToRead;
+            }
+        }
+        m_readEnd = offset + lenToRead;
+
+        int handle( m_readAheads.front().m_handle );
+        m_readAheads.pop_front();
+
+        Tuple reply;
+        if( m_requester.get( handle, reply ) )
+        {
+            int lenRead( reply[_length] );
+            if( ( lenRead == lenToRead ) && ( lenRead == reply[_data].rawSize() ) )
+            {
+                ::memcpy( data, reply[_data].raw(), lenRead );
+                return lenRead;
+            }
+        }
     }
 
     return 0;
@@ -147,12 +162,8 @@ int Linda2::write( const char* data, int offset, int len )
         LOG_DEBUG( stream.str() );
 #endif
 
-        Tuple tuple;
-        TupleRouter::setSourceActor( tuple, _AssetLoader );
-        TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-        TupleRouter::setTupleType( tuple, _AssetWriteRequest );
+        Tuple tuple( request( _AssetWriteRequest ) );
         tuple[_assetName] = m_name;
-        tuple[_collectionName] = m_collectionName;
         tuple[_offset] = offset;
         int lenToWrite( ( len > maxBlockSize ) ? maxBlockSize : len );
         tuple[_length] = lenToWrite;
@@ -160,25 +171,15 @@ int Linda2::write( const char* data, int offset, int len )
         ::memcpy( &dataStr[0], data, lenToWrite );
         tuple[_data] = dataStr;
         tuple[_data].markBinary();
-        m_coordinates.toValue( tuple[_coordinates] );
-
-        m_isLoading = true;
 
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2AssetLoader: Sending AssetWriteRequest" );
 #endif
-        m_assetWriteResponse = Promise( &m_tupleRouter, &m_timerFactory );
-        if( m_tupleRouter.route( tuple ) )
+        Tuple reply;
+        if( m_requester.call( tuple, _AssetWriteResponse, reply ) )
         {
-            Value lenWritten;
-            if( m_assetWriteResponse.getFuture().get( lenWritten ) )
-            {
-                m_isLoading = false;
-                return lenWritten;
-            }
+            return reply[_length];
         }
-
-        m_isLoading = false;
     }
 
     return 0;
@@ -188,31 +189,21 @@ bool Linda2::close()
 {
     if( m_isOpen )
     {
-        Tuple tuple;
-        TupleRouter::setSourceActor( tuple, _AssetLoader );
-        TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-        TupleRouter::setTupleType( tuple, _AssetCloseRequest );
-        tuple[_assetName] = m_name;
-        tuple[_collectionName] = m_collectionName;
-        m_coordinates.toValue( tuple[_coordinates] );
+        // The responder's loader is closed under them.
+        cancelReadAheads();
 
-        m_isLoading = true;
+        Tuple tuple( request( _AssetCloseRequest ) );
+        tuple[_assetName] = m_name;
 
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2AssetLoader: Sending AssetCloseRequest" );
 #endif
-        m_assetCloseResponse = Promise( &m_tupleRouter, &m_timerFactory );
-        if( m_tupleRouter.route( tuple ) )
+        Tuple reply;
+        if( m_requester.call( tuple, _AssetCloseResponse, reply ) )
         {
-            if( m_assetCloseResponse.getFuture().get() )
-            {
-                m_isOpen = false;
-                m_isLoading = false;
-                return true;
-            }
+            m_isOpen = false;
+            return true;
         }
-
-        m_isLoading = false;
     }
 
     return false;
@@ -228,31 +219,15 @@ bool Linda2::move( const String& newName )
 {
     if( !m_isOpen )
     {
-        Tuple tuple;
-        TupleRouter::setSourceActor( tuple, _AssetLoader );
-        TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-        TupleRouter::setTupleType( tuple, _AssetMoveRequest );
+        Tuple tuple( request( _AssetMoveRequest ) );
         tuple[_assetName] = m_name;
-        tuple[_collectionName] = m_collectionName;
         tuple[_newName] = newName;
-        m_coordinates.toValue( tuple[_coordinates] );
-
-        m_isLoading = true;
 
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2AssetLoader: Sending AssetMoveRequest" );
 #endif
-        m_assetMoveResponse = Promise( &m_tupleRouter, &m_timerFactory );
-        if( m_tupleRouter.route( tuple ) )
-        {
-            if( m_assetMoveResponse.getFuture().get() )
-            {
-                m_isLoading = false;
-                return true;
-            }
-        }
-
-        m_isLoading = false;
+        Tuple reply;
+        return m_requester.call( tuple, _AssetMoveResponse, reply );
     }
 
     return false;
@@ -262,30 +237,14 @@ bool Linda2::erase()
 {
     if( !m_isOpen )
     {
-        Tuple tuple;
-        TupleRouter::setSourceActor( tuple, _AssetLoader );
-        TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-        TupleRouter::setTupleType( tuple, _AssetEraseRequest );
+        Tuple tuple( request( _AssetEraseRequest ) );
         tuple[_assetName] = m_name;
-        tuple[_collectionName] = m_collectionName;
-        m_coordinates.toValue( tuple[_coordinates] );
-
-        m_isLoading = true;
 
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2AssetLoader: Sending AssetEraseRequest" );
 #endif
-        m_assetEraseResponse = Promise( &m_tupleRouter, &m_timerFactory );
-        if( m_tupleRouter.route( tuple ) )
-        {
-            if( m_assetEraseResponse.getFuture().get() )
-            {
-                m_isLoading = false;
-                return true;
-            }
-        }
-
-        m_isLoading = false;
+        Tuple reply;
+        return m_requester.call( tuple, _AssetEraseResponse, reply );
     }
 
     return false;
@@ -296,69 +255,96 @@ bool Linda2::error()
     return m_tupleRouter.routeError();
 }
 
-bool Linda2::accept( Tuple& tuple )
+String Linda2::version()
 {
-    bool handled( false );
+    // Received during open.
+    return m_version;
+}
 
-    if( ( TupleRouter::tupleType( tuple ) == _AssetOpenResponse ) &&
-        ( tuple[_collectionName] == m_collectionName ) &&
-        m_isLoading )
+bool Linda2::revalidate( Vector< struct Revalidation >& revalidations )
+{
+    if( revalidations.empty() )
     {
-        m_assetOpenResponse.set( tuple[_success] );
-        m_isOpen = ( (int)tuple[_success] == 1 );
-        m_size = tuple[_size];
-
-        handled = true;
+        return true;
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _AssetReadResponse ) &&
-             ( tuple[_collectionName] == m_collectionName ) &&
-             m_isLoading )
-    {
-        if( m_assetReadResponse.set( tuple[_success] ) )
-        {
-            m_readDataLen = tuple[_length];
-            if( ( m_readDataLen == tuple[_data].rawSize() ) && ( m_readDataLen <= maxBlockSize ) )
-            {
-                ::memcpy( m_readData, tuple[_data].raw(), m_readDataLen );
-            }
-            else
-            {
-                m_readDataLen = 0; // Should never happen.
-            }
-        }
 
-        handled = true;
-    }
-    else if( ( TupleRouter::tupleType( tuple ) == _AssetWriteResponse ) &&
-             ( tuple[_collectionName] == m_collectionName ) &&
-             m_isLoading )
+    Tuple tuple( request( _AssetRevalidateRequest ) );
+
+    Value& assets( tuple[_assets] );
+    Vector< struct Revalidation >::const_iterator it( revalidations.begin() );
+    for( ; it != revalidations.end(); ++it )
     {
-        m_assetWriteResponse.set( tuple[_success], tuple[_length] );
-        handled = true;
+        Value* asset( new Value );
+        ( *asset )[_assetName] = it->m_name;
+        ( *asset )[_version] = it->m_version;
+        assets.push_back( asset );
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _AssetCloseResponse ) &&
-             ( tuple[_collectionName] == m_collectionName ) &&
-             m_isLoading )
+
+#ifdef LOG_LOADERS
+    LiteStream stream;
+    stream << "Linda2AssetLoader: Sending AssetRevalidateRequest for " << (int)revalidations.size() << " assets";
+    LOG_DEBUG( stream.str() );
+#endif
+    Tuple reply;
+    if( !m_requester.call( tuple, _AssetRevalidateResponse, reply, loadRetries ) )
     {
-        m_assetCloseResponse.set( tuple[_success] );
-        handled = true;
+        return false;
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _AssetMoveResponse ) &&
-             ( tuple[_collectionName] == m_collectionName ) &&
-             m_isLoading )
+
+    // States are returned in request order.
+    const Value& states( reply[_assets] );
+    if( ( (const Vector< Value* >&)states ).size() != revalidations.size() )
     {
-        m_assetMoveResponse.set( tuple[_success] );
-        handled = true;
+        return false;
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _AssetEraseResponse ) &&
-             ( tuple[_collectionName] == m_collectionName ) &&
-             m_isLoading )
+
+    ConstListIterator stateIt( states.listBegin() );
+    Vector< struct Revalidation >::iterator revalidationIt( revalidations.begin() );
+    for( ; revalidationIt != revalidations.end(); ++revalidationIt, ++stateIt )
     {
-        m_assetEraseResponse.set( tuple[_success] );
-        handled = true;
+        revalidationIt->m_state = (enum Revalidation::State)(int)**stateIt;
     }
 
-    return handled;
+    return true;
+}
+
+bool Linda2::accept( Tuple& tuple )
+{
+    // Only ever replies to our requests.
+    return m_requester.accept( tuple );
+}
+
+Tuple Linda2::request( const String& type )
+{
+    Tuple tuple;
+    TupleRouter::setSourceActor( tuple, _AssetLoader );
+    TupleRouter::setTupleType( tuple, type );
+    tuple[_collectionName] = m_collectionName;
+    m_coordinates.toValue( tuple[_coordinates] );
+    return tuple;
+}
+
+int Linda2::sendRead( int offset, int length )
+{
+    Tuple tuple( request( _AssetReadRequest ) );
+    tuple[_assetName] = m_name;
+    tuple[_offset] = offset;
+    tuple[_length] = length;
+
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "Linda2AssetLoader: Sending AssetReadRequest" );
+#endif
+    return m_requester.send( tuple, _AssetReadResponse, String(), loadRetries );
+}
+
+void Linda2::cancelReadAheads()
+{
+    Deque< struct ReadAhead >::const_iterator it( m_readAheads.begin() );
+    for( ; it != m_readAheads.end(); ++it )
+    {
+        m_requester.cancel( it->m_handle );
+    }
+    m_readAheads.clear();
 }
 
 } // namespace AssetLoaders
@@ -3,7 +3,8 @@
 
 #include "Actors/NativeActors/NativeActor.h"
 #include "AssetLoader.h"
-#include "Promise.h"
+#include "Collections.h"
+#include "Requester.h"
 #include "String.h"
 #include "TupleRoutingCriteria.h"
 
@@ -53,30 +54,37 @@ public:
 
     virtual bool error();
 
+    virtual String version();
+    virtual bool revalidate( Vector< struct Revalidation >& revalidations );
+
     virtual bool accept( Tuple& tuple );
 
 private:
+    // A read sent ahead of being asked for.
+    struct ReadAhead
+    {
+        int m_offset;
+        int m_length;
+        int m_handle;
+    };
+
+    Tuple request( const String& type );
+    int sendRead( int offset, int length );
+    void cancelReadAheads();
+
     TupleRouter& m_tupleRouter;
-    Timers::Factory& m_timerFactory;
     String m_collectionName;
 
-    bool m_isLoading;
-
-    TupleRoutingCriteria m_tupleRoutingCriteria;
-
-    Promise m_assetOpenResponse;
-    Promise m_assetReadResponse;
-    Promise m_assetWriteResponse;
-    Promise m_assetCloseResponse;
-    Promise m_assetMoveResponse;
-    Promise m_assetEraseResponse;
+    Requester m_requester;
 
     bool m_isOpen;
     enum OpenMode m_openMode;
     int m_size;
+    String m_version;
 
-    char* m_readData;
-    int m_readDataLen;
+    // Oldest first, and contiguous.
+    Deque< struct ReadAhead > m_readAheads;
+    int m_readEnd;
 };
 
 } // namespace AssetLoaders
@@ -6,6 +6,7 @@
 #include "World/WorldCoordinates.h"
 #include "Collections.h"
 #include "Linda2AssetLoaderResponder.h"
+#include "Reply.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
@@ -84,6 +85,12 @@ bool Linda2Responder::accept( Tuple& tuple )
         erase( tuple );
         handled = true;
     }
+    else if( ( TupleRouter::tupleType( tuple ) == _AssetRevalidateRequest ) &&
+             ( tuple[_collectionName] == m_collectionName ) )
+    {
+        revalidate( tuple );
+        handled = true;
+    }
 
     return handled;
 }
@@ -128,11 +135,8 @@ void Linda2Responder::open( const Tuple& tuple )
 {
     bool success( true );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _AssetLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _AssetOpenResponse );
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetOpenResponse ) );
     response[ _collectionName ] = m_collectionName;
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
@@ -170,6 +174,7 @@ void Linda2Responder::open( const Tuple& tuple )
 #endif
             
             response[_size] = assetLoader->size();
+            response[_version] = assetLoader->version();
         }
         else
         {
@@ -181,18 +186,15 @@ void Linda2Responder::open( const Tuple& tuple )
 
     response[_success] = success ? 1 : 0;
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::read( const Tuple& tuple )
 {
     bool success( true );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _AssetLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _AssetReadResponse );
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetReadResponse ) );
     response[ _collectionName ] = m_collectionName;
 
     String assetName = tuple[_assetName];
@@ -237,18 +239,15 @@ void Linda2Responder::read( const Tuple& tuple )
 
     response[_success] = success ? 1 : 0;
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::write( const Tuple& tuple )
 {
     bool success( true );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _AssetLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _AssetWriteResponse );
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetWriteResponse ) );
     response[ _collectionName ] = m_collectionName;
 
     String assetName = tuple[_assetName];
@@ -289,18 +288,15 @@ void Linda2Responder::write( const Tuple& tuple )
 
     response[_success] = success ? 1 : 0;
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::close( const Tuple& tuple )
 {
     bool success( true );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _AssetLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _AssetCloseResponse );
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetCloseResponse ) );
     response[ _collectionName ] = m_collectionName;
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
@@ -320,16 +316,13 @@ void Linda2Responder::close( const Tuple& tuple )
 
     response[_success] = success ? 1 : 0;
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::move( const Tuple& tuple )
 {
-    Tuple response;
-    TupleRouter::setSourceActor( response, _AssetLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _AssetMoveResponse );
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetMoveResponse ) );
     response[ _collectionName ] = m_collectionName;
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
@@ -341,16 +334,13 @@ void Linda2Responder::move( const Tuple& tuple )
 
     delete( assetLoader );
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::erase( const Tuple& tuple )
 {
-    Tuple response;
-    TupleRouter::setSourceActor( response, _AssetLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _AssetEraseResponse );
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetEraseResponse ) );
     response[ _collectionName ] = m_collectionName;
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
@@ -361,7 +351,53 @@ void Linda2Responder::erase( const Tuple& tuple )
 
     delete( assetLoader );
 
-    m_tupleRouter.route( response );
+    reply.send( response );
+}
+
+void Linda2Responder::revalidate( const Tuple& tuple )
+{
+    Reply reply( m_tupleRouter, tuple, _AssetLoaderResponder );
+    Tuple response( reply.tuple( _AssetRevalidateResponse ) );
+    response[ _collectionName ] = m_collectionName;
+
+    Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
+
+    Vector< struct AssetLoader::Revalidation > revalidations;
+    const Value& assets( tuple[_assets] );
+    ConstListIterator it( assets.listBegin() );
+    for( ; it != assets.listEnd(); ++it )
+    {
+        struct AssetLoader::Revalidation revalidation;
+        revalidation.m_name = ( **it )[_assetName];
+        revalidation.m_version = ( **it )[_version];
+        revalidation.m_state = AssetLoader::Revalidation::unknown;
+        revalidations.push_back( revalidation );
+    }
+
+#ifdef LOG_LOADERS
+    LiteStream stream;
+    stream << "Linda2AssetLoaderResponder: Received revalidate request for " << (int)revalidations.size() << " assets";
+    LOG_DEBUG( stream.str() );
+#endif
+
+    // Name is irrelevant - the batch carries its own names.
+    AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( coordinates, String() ) );
+    bool success( assetLoader->revalidate( revalidations ) );
+    delete( assetLoader );
+
+    if( success )
+    {
+        Value& states( response[_assets] );
+        Vector< struct AssetLoader::Revalidation >::const_iterator revalidationIt( revalidations.begin() );
+        for( ; revalidationIt != revalidations.end(); ++revalidationIt )
+        {
+            states.push_back( new Value( (int)revalidationIt->m_state ) );
+        }
+    }
+
+    response[_success] = success ? 1 : 0;
+
+    reply.send( response );
 }
 
 } // namespace AssetLoaders
@@ -45,6 +45,7 @@ private:
     void close( const Tuple& tuple );
     void move( const Tuple& tuple );
     void erase( const Tuple& tuple );
+    void revalidate( const Tuple& tuple );
 
     TupleRouter& m_tupleRouter;
     AssetLoaders::Factory& m_assetLoaderFactory;
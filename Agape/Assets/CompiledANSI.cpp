@@ -0,0 +1,274 @@
+#include "AssetLoaders/AssetLoader.h"
+#include "ANSIFile.h"
+#include "ANSITerminal.h"
+#include "Asset.h"
+#include "Collections.h"
+#include "CompiledANSI.h"
+#include "String.h"
+
+namespace
+{
+    // Positions are kept as shorts.
+    const int _maxPosition( 32767 );
+
+    // A world with more assets than this on the go just starts again.
+    const unsigned int _maxCompiled( 256 );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Assets
+{
+
+CompiledANSI::CompiledANSI() :
+  m_compiled( false ),
+  m_size( -1 ),
+  m_width( 0 ),
+  m_height( 0 ),
+  m_frameHeight( -1 ),
+  m_frames( 0 ),
+  m_cells( 0 )
+{
+}
+
+bool CompiledANSI::compile( const Asset& asset,
+                            int len,
+                            int width,
+                            int frameHeight,
+                            int numFrames )
+{
+    m_compiled = false;
+    m_version.clear();
+    m_size = len;
+    m_width = width;
+    m_height = 0;
+    m_frameHeight = frameHeight;
+    m_frames = numFrames;
+    m_cells = 0;
+    m_runs.clear();
+    m_frameStarts.clear();
+    m_endRows.clear();
+    m_endCols.clear();
+    m_state = ANSITerminal::SGRState();
+    m_state.m_charset = -1; // Whichever is current, until the asset chooses.
+
+    if( ( len < 0 ) || ( width <= 0 ) || ( width > _maxPosition ) || ( numFrames < 1 ) ) return false;
+
+    String data( len, '\0' );
+    if( ( len > 0 ) && ( asset.readAll( &data[0], 0, len ) != len ) ) return false;
+
+    bool consumingSequence( false );
+    String sequence;
+    int offset( 0 );
+
+    for( int frame( 0 ); frame < numFrames; ++frame )
+    {
+        // As ANSITerminal::consumeChar(), relative to the top left.
+        int row( 0 );
+        int col( 0 );
+        m_frameStarts.push_back( m_runs.size() );
+
+        for( ; ( offset < len ) && ( ( frameHeight == -1 ) || ( row < frameHeight ) ); ++offset )
+        {
+            char c( data[offset] );
+            if( consumingSequence )
+            {
+                sequence += c;
+                if( c == 'm' )
+                {
+                    consumingSequence = false;
+                    ANSITerminal::parseSGRSequence( sequence, m_state );
+                    sequence.clear();
+                }
+                else if( c == 'A' || c == 'B' || c == 'C' || c == 'D' )
+                {
+                    // Where the cursor ends up depends on where the asset is
+                    // drawn.
+                    return false;
+                }
+            }
+            else if( c == '\x1b' )
+            {
+                consumingSequence = true;
+                sequence += c;
+            }
+            else if( c == '\x0d' )
+            {
+                col = 0;
+            }
+            else if( c == '\x0a' )
+            {
+                ++row;
+            }
+            else
+            {
+                // What this looks like depends on whatever was drawn before.
+                if( !m_state.m_reset || ( row > _maxPosition ) ) return false;
+
+                addCell( row, col, c, m_state );
+
+                ++col;
+                if( col == width )
+                {
+                    col = 0;
+                    ++row;
+                }
+            }
+        }
+
+        m_endRows.push_back( row );
+        m_endCols.push_back( col );
+    }
+
+    // An unfinished sequence would carry on into whatever is drawn next.
+    if( consumingSequence ) return false;
+
+    m_frameStarts.push_back( m_runs.size() );
+    if( frameHeight != -1 ) m_height = frameHeight;
+    m_compiled = true;
+
+    return true;
+}
+
+bool CompiledANSI::compiled() const
+{
+    return m_compiled;
+}
+
+bool CompiledANSI::matches( const String& version,
+                            int size,
+                            int width,
+                            int frameHeight,
+                            int numFrames ) const
+{
+    // Loaders don't always know the version, e.g. when serving from a cache.
+    if( !version.empty() && !m_version.empty() && ( version != m_version ) ) return false;
+
+    return( ( size == m_size ) &&
+            ( width == m_width ) &&
+            ( frameHeight == m_frameHeight ) &&
+            ( numFrames == m_frames ) );
+}
+
+void CompiledANSI::setVersion( const String& version )
+{
+    if( !version.empty() ) m_version = version;
+}
+
+int CompiledANSI::width() const
+{
+    return m_width;
+}
+
+int CompiledANSI::height() const
+{
+    return m_height;
+}
+
+int CompiledANSI::frames() const
+{
+    return m_frames;
+}
+
+int CompiledANSI::cells() const
+{
+    return m_cells;
+}
+
+const CompiledANSI::Run* CompiledANSI::begin( int frame ) const
+{
+    return m_runs.empty() ? nullptr : &m_runs[0] + m_frameStarts[frame];
+}
+
+const CompiledANSI::Run* CompiledANSI::end( int frame ) const
+{
+    return m_runs.empty() ? nullptr : &m_runs[0] + m_frameStarts[frame + 1];
+}
+
+int CompiledANSI::endRow( int frame ) const
+{
+    return m_endRows[frame];
+}
+
+int CompiledANSI::endCol( int frame ) const
+{
+    return m_endCols[frame];
+}
+
+const ANSITerminal::SGRState& CompiledANSI::state() const
+{
+    return m_state;
+}
+
+void CompiledANSI::addCell( int row, int col, char character, const ANSITerminal::SGRState& state )
+{
+    ++m_cells;
+    if( ( m_frameHeight == -1 ) && ( row >= m_height ) ) m_height = row + 1;
+
+    // Extend the last run if this carries it on.
+    if( m_runs.size() > (unsigned int)m_frameStarts.back() )
+    {
+        Run& last( m_runs.back() );
+        if( ( last.m_row == row ) &&
+            ( ( last.m_col + last.m_length ) == col ) &&
+            ( last.m_character == character ) &&
+            ( last.m_attributes == (char)state.m_attributes ) &&
+            ( last.m_charset == (char)state.m_charset ) )
+        {
+            ++last.m_length;
+            return;
+        }
+    }
+
+    Run run;
+    run.m_row = row;
+    run.m_col = col;
+    run.m_length = 1;
+    run.m_character = character;
+    run.m_attributes = state.m_attributes;
+    run.m_charset = state.m_charset;
+    m_runs.push_back( run );
+}
+
+const CompiledANSI* CompiledANSIs::find( const String& key,
+                                         AssetLoader& loader,
+                                         ANSIFile& ansiFile,
+                                         int frameHeight,
+                                         int numFrames )
+{
+    String version( loader.version() );
+    int size( ansiFile.dataSize() );
+    int width( ansiFile.width() );
+
+    Map< String, CompiledANSI >::iterator it( m_compiled.find( key ) );
+    if( ( it == m_compiled.end() ) || !it->second.matches( version, size, width, frameHeight, numFrames ) )
+    {
+        if( ( it == m_compiled.end() ) && ( m_compiled.size() >= _maxCompiled ) )
+        {
+            m_compiled.clear();
+        }
+
+        CompiledANSI& compiled( m_compiled[key] );
+        compiled.compile( ansiFile, size, width, frameHeight, numFrames );
+        compiled.setVersion( version );
+        return compiled.compiled() ? &compiled : nullptr;
+    }
+
+    it->second.setVersion( version );
+    return it->second.compiled() ? &it->second : nullptr;
+}
+
+void CompiledANSIs::invalidate( const String& key )
+{
+    m_compiled.erase( key );
+}
+
+void CompiledANSIs::invalidateAll()
+{
+    m_compiled.clear();
+}
+
+} // namespace Assets
+
+} // namespace Agape
@@ -0,0 +1,120 @@
+#ifndef AGAPE_ASSETS_COMPILED_ANSI_H
+#define AGAPE_ASSETS_COMPILED_ANSI_H
+
+#include "ANSITerminal.h"
+#include "Collections.h"
+#include "String.h"
+
+namespace Agape
+{
+
+class Asset;
+class AssetLoader;
+
+namespace Assets
+{
+
+class ANSIFile;
+
+/// @brief An ANSI asset interpreted once, as ANSITerminal would draw it, into
+/// runs of identical cells, so that drawing it again is a matter of painting
+/// them rather than re-reading and re-parsing the asset a byte at a time.
+/// Positions are relative to where the asset is drawn. Only assets that draw
+/// the same wherever they are drawn can be compiled: those that move the
+/// cursor, or print before resetting colours, are drawn as they always were.
+class CompiledANSI
+{
+public:
+    struct Run
+    {
+        short m_row;
+        short m_col;
+        short m_length;
+        char m_character;
+        char m_attributes;
+        char m_charset; // -1 for whichever is current where it's drawn.
+    };
+
+    CompiledANSI();
+
+    /// @brief Interprets the first len bytes of asset, drawn with scroll lock
+    /// on in ANSI mode and wrapped at width. With a frame height, splits it
+    /// into numFrames frames of that many rows, as Terminal::createSprite()
+    /// does. Returns false if it can't be compiled.
+    bool compile( const Asset& asset,
+                  int len,
+                  int width,
+                  int frameHeight = -1,
+                  int numFrames = 1 );
+
+    bool compiled() const;
+
+    // Whether this was compiled from the same asset, drawn the same way.
+    bool matches( const String& version,
+                  int size,
+                  int width,
+                  int frameHeight,
+                  int numFrames ) const;
+    void setVersion( const String& version );
+
+    int width() const;
+    int height() const; // Rows drawn, or the frame height.
+    int frames() const;
+    int cells() const;
+
+    const Run* begin( int frame ) const;
+    const Run* end( int frame ) const;
+
+    // Where the cursor is left after drawing a frame.
+    int endRow( int frame ) const;
+    int endCol( int frame ) const;
+
+    // Colours as the asset leaves them, and its charset, or -1 if it never
+    // chose one.
+    const ANSITerminal::SGRState& state() const;
+
+private:
+    void addCell( int row, int col, char character, const ANSITerminal::SGRState& state );
+
+    bool m_compiled;
+    String m_version;
+    int m_size;
+    int m_width;
+    int m_height;
+    int m_frameHeight;
+    int m_frames;
+    int m_cells;
+
+    Vector< Run > m_runs;
+    Vector< int > m_frameStarts; // Index of each frame's first run, then the end.
+    Vector< int > m_endRows;
+    Vector< int > m_endCols;
+    ANSITerminal::SGRState m_state;
+};
+
+/// @brief Compiled assets by name, so that each is compiled once per version
+/// rather than once per draw. Entries are replaced when the asset changes
+/// size or version, and must be invalidated when it changes otherwise.
+class CompiledANSIs
+{
+public:
+    /// @brief Returns the asset ansiFile reads, as loader has it open,
+    /// compiled, compiling it if need be. Returns nullptr if it can't be.
+    const CompiledANSI* find( const String& key,
+                              AssetLoader& loader,
+                              ANSIFile& ansiFile,
+                              int frameHeight = -1,
+                              int numFrames = 1 );
+
+    void invalidate( const String& key );
+    void invalidateAll();
+
+private:
+    Map< String, CompiledANSI > m_compiled;
+};
+
+} // namespace Assets
+
+} // namespace Agape
+
+#endif // AGAPE_ASSETS_COMPILED_ANSI_H
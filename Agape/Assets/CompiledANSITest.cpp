@@ -0,0 +1,359 @@
+#ifdef COMPILED_ANSI_TEST
+
+#include "AssetLoaders/AssetLoader.h"
+#include "Assets/ANSIFile.h"
+#include "Assets/Asset.h"
+#include "Assets/CompiledANSI.h"
+#include "GraphicsDrivers/GraphicsDriver.h"
+#include "GraphicsDrivers/Headless.h"
+#include "Timers/Timer.h"
+#include "World/WorldCoordinates.h"
+#include "ANSITerminal.h"
+#include "Collections.h"
+#include "String.h"
+#include "Terminal.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <string.h>
+#include <time.h>
+
+using namespace Agape;
+using Agape::Assets::CompiledANSI;
+using Agape::Assets::CompiledANSIs;
+
+namespace
+{
+    const int _screenWidth( 80 );
+    const int _screenHeight( 25 );
+    const int _tileWidth( 8 );
+    const int _tileHeight( 4 );
+    const int _itemWidth( 20 );
+    const int _itemHeight( 6 );
+    const int _itemPositions[][2] = { { 2, 3 }, { 5, 30 }, { 12, 50 }, { 16, 70 }, { 21, 10 }, { 9, 0 } };
+    const int _numItems( sizeof( _itemPositions ) / sizeof( _itemPositions[0] ) );
+    const int _spriteFrames( 3 );
+    const int _redrawsPerTrial( 50 );
+    const int _numTrials( 10 );
+    const int _numAttempts( 5 );
+    const double _minSpeedup( 1.5 );
+
+    class MemoryLoader : public AssetLoader
+    {
+    public:
+        MemoryLoader( const std::string& data, const String& version ) :
+          AssetLoader( World::Coordinates(), "test" ),
+          m_data( data ),
+          m_version( version ),
+          m_reads( 0 )
+        {
+        }
+
+        virtual bool open() { return true; }
+
+        virtual int read( char* data, int offset, int len )
+        {
+            ++m_reads;
+            int available( (int)m_data.size() - offset );
+            int count( len < available ? len : available );
+            if( count <= 0 ) return 0;
+            m_data.copy( data, count, offset );
+            return count;
+        }
+
+        virtual int size() { return m_data.size(); }
+        virtual String version() { return m_version; }
+
+        std::string m_data;
+        String m_version;
+        int m_reads;
+    };
+
+    // What's on the screen, as painted.
+    class Recorder : public GraphicsDriver
+    {
+    public:
+        Recorder() : m_screen( _screenWidth * _screenHeight * 3, '\0' ) {}
+
+        virtual void clearScreen( const String& windowName ) { m_screen.assign( m_screen.size(), '\0' ); }
+        virtual void clearLines( const String& windowName, int from, int len ) {}
+        virtual void clearAll() {}
+
+        virtual void paintGlyph( const String& windowName, int row, int col, char* glyphAttr, bool transparency, char charset )
+        {
+            int offset( ( ( row * _screenWidth ) + col ) * 3 );
+            m_screen[offset] = glyphAttr[0];
+            m_screen[offset + 1] = glyphAttr[1];
+            m_screen[offset + 2] = charset;
+        }
+
+        virtual void paintBitmap( const String& windowName, int row, int col, int yOffset, int height, int width, char* rgbBuf ) {}
+
+        virtual int glyphHeight() { return 16; }
+        virtual int glyphWidth() { return 8; }
+
+        std::string m_screen;
+    };
+
+    // Every call is time for the next animation frame.
+    class FakeTimer : public Timer
+    {
+    public:
+        virtual long ms() { return 1000000; }
+        virtual void reset() {}
+    };
+
+    unsigned int next( unsigned int& seed )
+    {
+        seed = seed * 1103515245 + 12345;
+        return seed >> 16;
+    }
+
+    // Random art in the style of the real thing: a reset, then runs of
+    // block and text characters in assorted colours, with some rows ending
+    // early and the rest wrapping.
+    std::string makeArt( int width, int rows, unsigned int seed )
+    {
+        const char* sequences[] = { "\x1b[0m", "\x1b[1;33m", "\x1b[0;36;44m", "\x1b[5;41m", "\x1b[92m",
+                                    "\x1b[104;30m", "\x1b[0;1;5;37;40m", "\x1b[31m", "\x1b[11m", "\x1b[10m" };
+        const char glyphs[] = { ' ', ' ', ' ', '\xb0', '\xb1', '\xb2', '\xdb', '\xdc', '\xdf', 'o', '#', '\x08' };
+
+        std::string art( "\x1b[0m" );
+        for( int row( 0 ); row < rows; ++row )
+        {
+            int length( ( next( seed ) % 3 ) == 0 ? width : 1 + ( next( seed ) % width ) );
+            int col( 0 );
+            while( col < length )
+            {
+                if( ( next( seed ) % 4 ) == 0 )
+                {
+                    art += sequences[next( seed ) % ( sizeof( sequences ) / sizeof( sequences[0] ) )];
+                }
+
+                int run( 1 + ( next( seed ) % 6 ) );
+                char glyph( glyphs[next( seed ) % sizeof( glyphs )] );
+                for( ; ( run > 0 ) && ( col < length ); --run, ++col )
+                {
+                    art += glyph;
+                }
+            }
+
+            if( length < width )
+            {
+                art += "\r\n";
+            }
+        }
+
+        return art;
+    }
+
+    struct Art
+    {
+        Art( const std::string& data, int width, int frameHeight = -1, int numFrames = 1 ) :
+          m_loader( data, "v1" ),
+          m_asset( m_loader ),
+          m_width( width )
+        {
+            m_compiled.compile( m_asset, data.size(), width, frameHeight, numFrames );
+        }
+
+        MemoryLoader m_loader;
+        Asset m_asset;
+        int m_width;
+        CompiledANSI m_compiled;
+    };
+
+    // As Compositor::render(): tile the ground then draw each item.
+    void drawScene( Terminal& terminal, Art& ground, Vector< Art* >& items, char* collisionMap, bool compiled )
+    {
+        terminal.clearScreen();
+        ::memset( collisionMap, 0, _screenWidth * _screenHeight );
+
+        for( int row = 0; row < _screenHeight; row += _tileHeight )
+        {
+            for( int col = 0; col < _screenWidth; col += _tileWidth )
+            {
+                terminal.consumeNext( row, col );
+                if( compiled )
+                {
+                    terminal.consumeCompiled( ground.m_compiled, 0, Terminal::ANSI );
+                }
+                else
+                {
+                    terminal.consumeAsset( ground.m_asset, 0, ground.m_loader.m_data.size(), _tileWidth, col,
+                                           Terminal::noMaxRow, Terminal::scrollLock, Terminal::ANSI );
+                }
+            }
+        }
+
+        for( int i( 0 ); i < _numItems; ++i )
+        {
+            Art& item( *items[i] );
+            int charMode( Terminal::whitespaceTransparency | Terminal::ANSI );
+            terminal.consumeNext( _itemPositions[i][0], _itemPositions[i][1] );
+            if( compiled )
+            {
+                terminal.consumeCompiled( item.m_compiled, 0, charMode, collisionMap, i + 1 );
+            }
+            else
+            {
+                terminal.consumeAsset( item.m_asset, 0, item.m_loader.m_data.size(), item.m_width, _itemPositions[i][1],
+                                       Terminal::noMaxRow, Terminal::scrollLock, charMode, collisionMap, i + 1 );
+            }
+        }
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+
+    bool compiles( const std::string& data )
+    {
+        MemoryLoader loader( data, "" );
+        Asset asset( loader );
+        CompiledANSI compiled;
+        return compiled.compile( asset, data.size(), _screenWidth );
+    }
+
+    // CPU time in microseconds, so that time spent running anything else
+    // isn't counted.
+    long long cpuus()
+    {
+        struct timespec now;
+        ::clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &now );
+        return ( (long long)now.tv_sec * 1000000LL ) + ( now.tv_nsec / 1000 );
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    Art ground( makeArt( _tileWidth, _tileHeight, 1 ), _tileWidth );
+    Vector< Art* > items;
+    for( int i( 0 ); i < _numItems; ++i )
+    {
+        items.push_back( new Art( makeArt( _itemWidth, _itemHeight, 100 + i ), _itemWidth ) );
+    }
+
+    bool compiled( ground.m_compiled.compiled() );
+    for( int i( 0 ); i < _numItems; ++i )
+    {
+        compiled = compiled && items[i]->m_compiled.compiled();
+    }
+    success = check( "Compiled", compiled ) && success;
+
+    // A scene drawn either way looks the same, down to the collision map and
+    // where the cursor is left.
+    FakeTimer timer;
+    Recorder parsedRecorder;
+    Recorder compiledRecorder;
+    GraphicsDrivers::Headless headless;
+    ANSITerminal parsedDrawTerminal( _screenWidth, _screenHeight, "Draw", headless, timer );
+    ANSITerminal parsed( _screenWidth, _screenHeight, "Parsed", parsedRecorder, timer, &parsedDrawTerminal );
+    ANSITerminal compiledTerminal( _screenWidth, _screenHeight, "Compiled", compiledRecorder, timer );
+    Vector< char > parsedMap( _screenWidth * _screenHeight );
+    Vector< char > compiledMap( _screenWidth * _screenHeight );
+
+    drawScene( parsed, ground, items, &parsedMap[0], false );
+    drawScene( compiledTerminal, ground, items, &compiledMap[0], true );
+    success = check( "Scene", ( ::memcmp( parsed.buffer(), compiledTerminal.buffer(), _screenWidth * _screenHeight * 2 ) == 0 ) &&
+                              ( parsedRecorder.m_screen == compiledRecorder.m_screen ) &&
+                              ( parsedMap == compiledMap ) &&
+                              ( parsed.row() == compiledTerminal.row() ) &&
+                              ( parsed.col() == compiledTerminal.col() ) ) && success;
+
+    // As do the frames of an animated sprite.
+    std::string spriteData( makeArt( _itemWidth, _itemHeight * _spriteFrames, 7 ) );
+    Art sprite( spriteData, _itemWidth, _itemHeight, _spriteFrames );
+    parsed.createSprite( "sprite", "parsed", sprite.m_asset, spriteData.size(), 4, 66, _itemHeight, _itemWidth,
+                         Terminal::whitespaceTransparency | Terminal::ANSI, _spriteFrames );
+    compiledTerminal.createSprite( "sprite", "compiled", sprite.m_compiled, 4, 66, Terminal::whitespaceTransparency | Terminal::ANSI );
+    bool frames( sprite.m_compiled.frames() == _spriteFrames );
+    for( int frame( 0 ); frame <= _spriteFrames; ++frame )
+    {
+        frames = frames && ( parsedRecorder.m_screen == compiledRecorder.m_screen );
+        parsed.run();
+        compiledTerminal.run();
+    }
+    success = check( "Sprite frames", frames ) && success;
+
+    // Only what draws the same wherever it's drawn is compiled.
+    success = check( "Plain", compiles( "\x1b[0;1;31mab\r\ncd\x1b[0m" ) ) && success;
+    success = check( "Cursor movement", !compiles( "\x1b[0mab\x1b[2Ccd" ) ) && success;
+    success = check( "No reset", !compiles( "\x1b[31mab" ) ) && success;
+    success = check( "Unfinished sequence", !compiles( "\x1b[0mab\x1b[3" ) ) && success;
+
+    // Compiled once per version.
+    CompiledANSIs cache;
+    std::string itemData( makeArt( _screenWidth, _itemHeight, 3 ) );
+    MemoryLoader v1( itemData, "v1" );
+    Assets::ANSIFile v1File( v1 );
+    const CompiledANSI* first( cache.find( "world/item", v1, v1File ) );
+    int reads( v1.m_reads );
+    const CompiledANSI* again( cache.find( "world/item", v1, v1File ) );
+    bool cached( first && ( again == first ) && ( v1.m_reads == reads ) );
+
+    MemoryLoader unversioned( itemData, "" ); // As served from a cache.
+    Assets::ANSIFile unversionedFile( unversioned );
+    reads = unversioned.m_reads;
+    cached = cached && ( cache.find( "world/item", unversioned, unversionedFile ) == first ) && ( unversioned.m_reads == reads );
+    success = check( "Cached", cached ) && success;
+
+    MemoryLoader v2( itemData, "v2" );
+    Assets::ANSIFile v2File( v2 );
+    reads = v2.m_reads;
+    bool recompiled( cache.find( "world/item", v2, v2File ) && ( v2.m_reads > reads ) );
+    cache.invalidate( "world/item" );
+    reads = v2.m_reads;
+    recompiled = recompiled && cache.find( "world/item", v2, v2File ) && ( v2.m_reads > reads );
+    success = check( "Recompiled", recompiled ) && success;
+
+    // Redrawing the scene on the headless driver, parsing every time and
+    // painting what was compiled, interleaved so that both see the same
+    // conditions.
+    ANSITerminal terminal( _screenWidth, _screenHeight, "Terminal", headless, timer );
+    bool faster( false );
+    for( int attempt( 0 ); !faster && ( attempt < _numAttempts ); ++attempt )
+    {
+        long long parsedus( -1 );
+        long long compiledus( -1 );
+        for( int trial( 0 ); trial < _numTrials; ++trial )
+        {
+            for( int pass( 0 ); pass < 2; ++pass )
+            {
+                long long startus( cpuus() );
+                for( int redraw( 0 ); redraw < _redrawsPerTrial; ++redraw )
+                {
+                    drawScene( terminal, ground, items, &compiledMap[0], pass == 1 );
+                }
+                long long us( cpuus() - startus );
+                long long& bestus( pass == 1 ? compiledus : parsedus );
+                if( ( bestus < 0 ) || ( us < bestus ) ) bestus = us;
+            }
+        }
+
+        double speedup( (double)parsedus / ( compiledus > 0 ? compiledus : 1 ) );
+        faster = ( speedup >= _minSpeedup );
+        std::cout << _redrawsPerTrial << " redraws: " << parsedus << "us parsed, " << compiledus
+                  << "us compiled, " << speedup << "x" << ( faster ? " OK" : "" ) << std::endl;
+    }
+    success = check( "Faster", faster ) && success;
+
+    std::cout << "Ground " << ground.m_compiled.cells() << " cells, item " << items[0]->m_compiled.cells()
+              << " cells" << std::endl;
+
+    for( Vector< Art* >::iterator it( items.begin() ); it != items.end(); ++it )
+    {
+        delete( *it );
+    }
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // COMPILED_ANSI_TEST
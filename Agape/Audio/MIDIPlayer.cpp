@@ -15,6 +15,11 @@ MIDIPlayer::MIDIPlayer( AssetLoaders::Factory& assetLoaderFactory ) :
 {
 }
 
+bool MIDIPlayer::ready()
+{
+    return( m_state == playing );
+}
+
 } // namespace Audio
 
 } // namespace Agape
@@ -33,6 +33,7 @@ public:
     virtual void playNote( int channel, int pitch, int velocity ) = 0;
 
     virtual void run() = 0;
+    virtual bool ready();
 
 protected:
     enum State
@@ -3,9 +3,10 @@
 #include "EventClocks/EventClock.h"
 #include "InputDevices/InputDevice.h"
 #include "Lines/Line.h"
-#include "NativeActors/EventTimerActor.h"
 #include "Platforms/Platform.h"
+#include "Timers/TimerWheel.h"
 #include "UI/PlatformUI.h"
+#include "World/Preloader.h"
 #include "Client.h"
 #include "ConnectionMonitor.h"
 #include "Session.h"
@@ -22,8 +23,10 @@ Client::Client( Line& line,
                 EntropySource* keyEntropySource,
                 MIDIPlayer& midiPlayer,
                 EventClock& eventClock,
-                Linda2::Actors::NativeActors::EventTimer& eventTimer,
-                Session& session ) :
+                Timers::Wheel& timerWheel,
+                Session& session,
+                World::Preloader& preloader,
+                Timers::Factory& timerFactory ) :
   m_line( line ),
   m_connectionMonitor( connectionMonitor ),
   m_platform( platform ),
@@ -33,9 +36,24 @@ Client::Client( Line& line,
   m_keyEntropySource( keyEntropySource ),
   m_midiPlayer( midiPlayer ),
   m_eventClock( eventClock ),
-  m_eventTimer( eventTimer ),
-  m_session( session )
+  m_timerWheel( timerWheel ),
+  m_session( session ),
+  m_preloader( preloader ),
+  m_scheduler( timerFactory, timerWheel )
 {
+    // Within each priority, the order here is the order they run in.
+    m_scheduler.add( m_line, Scheduler::input );
+    m_scheduler.add( m_inputDevice, Scheduler::input );
+    m_scheduler.add( m_platformUI, Scheduler::input ); // Must be after InputDevice and before Session, so PlatformUI can peek keystrokes.
+    m_scheduler.add( m_midiPlayer, Scheduler::audio );
+    m_scheduler.add( m_timerWheel, Scheduler::redraw );
+    m_scheduler.add( m_session, Scheduler::redraw );
+    m_scheduler.add( m_connectionMonitor, Scheduler::background );
+    m_scheduler.add( m_platform, Scheduler::background );
+    m_scheduler.add( m_entropySource, Scheduler::background );
+    if( m_keyEntropySource ) m_scheduler.add( *m_keyEntropySource, Scheduler::background );
+    m_scheduler.add( m_eventClock, Scheduler::background );
+    m_scheduler.add( m_preloader, Scheduler::background );
 }
 
 void Client::showAssetModal( const String& assetName )
@@ -45,17 +63,17 @@ void Client::showAssetModal( const String& assetName )
 
 void Client::run()
 {
-    m_line.run();
-    m_connectionMonitor.run();
-    m_platform.run();
-    m_inputDevice.run();
-    m_platformUI.run(); // Must be after InputDevice and before Session, so PlatformUI can peek keystrokes.
-    m_entropySource.run();
-    if( m_keyEntropySource ) m_keyEntropySource->run();
-    m_midiPlayer.run();
-    m_eventClock.run();
-    m_eventTimer.run();
-    m_session.run();
+    m_scheduler.run();
+}
+
+long Client::msUntilReady()
+{
+    return m_scheduler.msUntilReady();
+}
+
+void Client::sleep()
+{
+    m_scheduler.sleep();
 }
 
 } // namespace Agape
@@ -1,6 +1,8 @@
 #ifndef AGAPE_CLIENT_H
 #define AGAPE_CLIENT_H
 
+#include "Scheduler.h"
+
 namespace Agape
 {
 
@@ -11,22 +13,22 @@ class MIDIPlayer;
 
 using namespace Audio;
 
-namespace Linda2
-{
-namespace Actors
+namespace Timers
 {
-namespace NativeActors
-{
-class EventTimer;
-} // namespace NativeActors
-} // namespace Actors
-} // namespace Linda2
+class Factory;
+class Wheel;
+} // namespace Timers
 
 namespace UI
 {
 class PlatformUI;
 } // namespace UI
 
+namespace World
+{
+class Preloader;
+} // namespace World
+
 class ConnectionMonitor;
 class EventClock;
 class InputDevice;
@@ -52,13 +54,20 @@ public:
             EntropySource* keyEntropySource,
             MIDIPlayer& midiPlayer,
             EventClock& eventClock,
-            Linda2::Actors::NativeActors::EventTimer& eventTimer,
-            Session& session );
+            Timers::Wheel& timerWheel,
+            Session& session,
+            World::Preloader& preloader,
+            Timers::Factory& timerFactory );
 
     void showAssetModal( const String& assetName );
 
     void run();
 
+    // How long the main loop can wait before calling run() again, and a wait
+    // for that long where the platform's timer can sleep.
+    long msUntilReady();
+    void sleep();
+
 private:
     Line& m_line;
     ConnectionMonitor& m_connectionMonitor;
@@ -69,8 +78,11 @@ private:
     EntropySource* m_keyEntropySource;
     MIDIPlayer& m_midiPlayer;
     EventClock& m_eventClock;
-    Linda2::Actors::NativeActors::EventTimer& m_eventTimer;
+    Timers::Wheel& m_timerWheel;
     Session& m_session;
+    World::Preloader& m_preloader;
+
+    Scheduler m_scheduler;
 };
 
 } // namespace Agape
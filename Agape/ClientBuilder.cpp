@@ -60,6 +60,7 @@
 #include "WorldLoaders/Factories/WorldLoadersFactory.h"
 #include "World/Compositor.h"
 #include "World/MiniMap.h"
+#include "World/Preloader.h"
 #include "World/User.h"
 #include "World/WorldCoordinates.h"
 #include "World/WorldMetadata.h"
@@ -345,6 +346,14 @@ Client* ClientBuilder::build( Chooser& chooser )
                                           *m_clock,
                                           *m_midiPlayer );
 
+    m_preloader = new World::Preloader( *m_sceneLoaderFactory,
+                                        *m_assetLoaderFactory,
+                                        *m_timerFactory,
+                                        m_compositor->height(),
+                                        m_compositor->width(),
+                                        20000 ); // Bytes of assets fetched ahead.
+    m_compositor->registerMoveListener( m_preloader );
+
     // Optionally use a separate entropy source for keys. This is so we can
     // use the slow reverse-biased transistor source on the MS1 for key
     // generation but use the inbuilt PIC32 thermal noise source for other
@@ -609,6 +618,7 @@ Client* ClientBuilder::build( Chooser& chooser )
 
     m_telegramStrategy = new UI::Strategies::Telegram( *m_inputDevice,
                                                        *m_telegramLoaderFactory,
+                                                       m_telegramIndexFS,
                                                        *m_worldUser,
                                                        *m_worldMetadata,
                                                        *m_worldbook,
@@ -662,11 +672,14 @@ Client* ClientBuilder::build( Chooser& chooser )
 
     m_miniMap = new MiniMap( *m_sceneLoaderFactory,
                              *m_assetLoaderFactory,
-                             *m_drawTerminal );
+                             *m_drawTerminal,
+                             100 );
+    m_compositor->registerListener( m_miniMap );
 
     buildMiniMapAssetLoaderFactory();
 
     m_miniMapStrategy = new UI::Strategies::MiniMap( *m_miniMapAssetLoaderFactory,
+                                                     *m_miniMap,
                                                      *m_coordinates,
                                                      *m_navigation,
                                                      *m_inputDevice,
@@ -726,7 +739,9 @@ Client* ClientBuilder::build( Chooser& chooser )
     m_entropyActor = new Agape::Linda2::Actors::NativeActors::Entropy( *m_functionDispatcher,
                                                                        *m_entropySource );
 
-    m_eventTimerActor = new Agape::Linda2::Actors::NativeActors::EventTimer( *m_timerFactory,
+    m_timerWheel = new Timers::Wheel( *m_timerFactory );
+    m_eventTimerActor = new Agape::Linda2::Actors::NativeActors::EventTimer( *m_timerWheel,
+                                                                             m_vrTime->clock(),
                                                                              *m_tupleRouter );
 
     buildUpdate();
@@ -795,8 +810,10 @@ Client* ClientBuilder::build( Chooser& chooser )
                            m_keyEntropySource,
                            *m_midiPlayer,
                            *m_eventClock,
-                           *m_eventTimerActor,
-                           *m_session );
+                           *m_timerWheel,
+                           *m_session,
+                           *m_preloader,
+                           *m_timerFactory );
 
     return m_client;
 }
@@ -818,6 +835,7 @@ void ClientBuilder::deleteMembers()
     delete( m_updateStrategy );
     delete( m_updateMemory );
     delete( m_eventTimerActor );
+    delete( m_timerWheel );
     delete( m_entropyActor );
     delete( m_platformActor );
     delete( m_userActor );
@@ -871,6 +889,7 @@ void ClientBuilder::deleteMembers()
     delete( m_worldLoaderFactory );
     delete( m_worldUtilities );
     delete( m_keyUtilities );
+    delete( m_preloader );
     delete( m_compositor );
     delete( m_worldbook );
     delete( m_phonebook );
@@ -903,6 +922,8 @@ void ClientBuilder::deleteMembers()
     delete( m_line );
     delete( m_lineDriver );
     delete( m_platform );
+    delete( m_rwCompressor );
+    delete( m_compressor );
     delete( m_rwBuffer );
     delete( m_dialogue );
     delete( m_linda2Terminal );
@@ -936,6 +957,8 @@ void ClientBuilder::setMembersNull()
     m_windowManager = nullptr;
     m_dialogue = nullptr;
     m_rwBuffer = nullptr;
+    m_compressor = nullptr;
+    m_rwCompressor = nullptr;
     m_platform = nullptr;
     m_lineDriver = nullptr;
     m_line = nullptr;
@@ -963,6 +986,7 @@ void ClientBuilder::setMembersNull()
     m_sceneLoaderFactory = nullptr;
     m_presenceLoaderFactory = nullptr;
     m_telegramLoaderFactory = nullptr;
+    m_telegramIndexFS = nullptr;
     m_midiPlayer = nullptr;
     m_worldUtilities = nullptr;
     m_worldLoaderFactory = nullptr;
@@ -987,6 +1011,7 @@ void ClientBuilder::setMembersNull()
     m_phonebook = nullptr;
     m_worldbook = nullptr;
     m_compositor = nullptr;
+    m_preloader = nullptr;
     m_keyUtilities = nullptr;
     m_highlighterFactory = nullptr;
     m_editorFactory = nullptr;
@@ -1036,6 +1061,7 @@ void ClientBuilder::setMembersNull()
     m_platformActor = nullptr;
     m_entropyActor = nullptr;
     m_eventTimerActor = nullptr;
+    m_timerWheel = nullptr;
     m_updateMemory = nullptr;
     m_updateStrategy = nullptr;
     m_session = nullptr;
@@ -4,6 +4,7 @@
 #include "AssetLoaders/Factories/AssetLoadersFactory.h"
 #include "Audio/MIDIPlayer.h"
 #include "Clocks/Clock.h"
+#include "Compressors/Compressor.h"
 #include "EditorFactory.h"
 #include "Encryptors/Factories/BlockEncryptorsFactory.h"
 #include "Encryptors/Factories/EncryptorsFactory.h"
@@ -31,6 +32,7 @@
 #include "TelegramLoaders/TelegramLoader.h"
 #include "Timers/Factories/TimerFactory.h"
 #include "Timers/NullTimer.h"
+#include "Timers/TimerWheel.h"
 #include "TupleRoutes/TupleRoute.h"
 #include "UI/Dialogue.h"
 #include "UI/Hotkeys.h"
@@ -44,6 +46,7 @@
 #include "Utils/Snowflake.h"
 #include "World/Compositor.h"
 #include "World/MiniMap.h"
+#include "World/Preloader.h"
 #include "World/User.h"
 #include "World/WorldMetadata.h"
 #include "World/WorldUtilities.h"
@@ -60,6 +63,7 @@
 #include "Phonebook.h"
 #include "ProgramManager.h"
 #include "RWBuffer.h"
+#include "RWCompressor.h"
 #include "Session.h"
 #include "String.h"
 #include "Terminal.h"
@@ -71,6 +75,8 @@
 namespace Agape
 {
 
+class KiamaFS;
+
 // Construction: Base c'tor calls base setMembersNull(),
 //               derived c'tor cals derived _setMembersNull()
 
@@ -126,6 +132,8 @@ protected:
     WindowManager* m_windowManager;
     UI::Dialogue* m_dialogue;
     RWBuffer* m_rwBuffer;
+    Compressor* m_compressor;
+    RWCompressor* m_rwCompressor;
     LineDriver* m_lineDriver;
     Line* m_line;
     InputDevice* m_inputDevice;
@@ -152,6 +160,7 @@ protected:
     SceneLoaders::Factory* m_sceneLoaderFactory;
     PresenceLoaders::Factory* m_presenceLoaderFactory;
     TelegramLoaders::Factory* m_telegramLoaderFactory;
+    KiamaFS* m_telegramIndexFS; // Not owned, and optional.
     Audio::MIDIPlayer* m_midiPlayer;
     Platform* m_platform;
     World::Utilities* m_worldUtilities;
@@ -184,6 +193,7 @@ private:
     Terminal* m_linda2Terminal;
     World::Coordinates* m_coordinates;
     World::Compositor* m_compositor;
+    World::Preloader* m_preloader;
     Phonebook* m_phonebook;
     Worldbook* m_worldbook;
     KeyUtilities* m_keyUtilities;
@@ -232,6 +242,7 @@ private:
     Agape::Linda2::Actors::NativeActors::User* m_userActor;
     Agape::Linda2::Actors::NativeActors::Platform* m_platformActor;
     Agape::Linda2::Actors::NativeActors::Entropy* m_entropyActor;
+    Timers::Wheel* m_timerWheel;
     Agape::Linda2::Actors::NativeActors::EventTimer* m_eventTimerActor;
 
     Session* m_session;
@@ -0,0 +1,137 @@
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "DisciplinedClock.h"
+#include "String.h"
+
+#include <string.h>
+
+namespace
+{
+    const double _stepMs( 2000 ); // Errors larger than this are stepped to, not slewed to.
+    const double _slewDivisor( 4 ); // Fraction of each error taken up per time.
+    const int _settleTimes( 16 ); // Times to slew over before measuring drift from our estimate.
+    const long _minDriftSpanMs( 300000 ); // Times are whole seconds, so measure drift over minutes.
+    const double _maxDrift( 0.01 );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Clocks
+{
+
+Disciplined::Disciplined( Timers::Factory& timerFactory ) :
+  m_timer( timerFactory.makeTimer() ),
+  m_synchronised( false ),
+  m_anchorLocalMs( 0 ),
+  m_anchorMS( 0 ),
+  m_rate( 1 ),
+  m_firstLocalMs( 0 ),
+  m_firstMS( 0 ),
+  m_times( 0 ),
+  m_lastMS( 0 )
+{
+}
+
+Disciplined::~Disciplined()
+{
+    delete( m_timer );
+}
+
+void Disciplined::discipline( unsigned long long epochMS )
+{
+    long localMs( m_timer->ms() );
+
+    if( !m_synchronised )
+    {
+        anchor( localMs, epochMS );
+        m_synchronised = true;
+        return;
+    }
+
+    double predictedMS( estimate( localMs ) );
+    double error( (double)epochMS - predictedMS );
+    if( ( error > _stepMs ) || ( error < -_stepMs ) )
+    {
+        // Our time was wrong, or has been changed, so start again from this
+        // one, even if that means going backwards.
+        anchor( localMs, epochMS );
+        m_lastMS = epochMS;
+        return;
+    }
+
+    // Slew towards the time we've been sent rather than jumping to it, which
+    // also smooths out it being in whole seconds.
+    m_anchorMS = predictedMS + ( error / _slewDivisor );
+    m_anchorLocalMs = localMs;
+
+    if( ++m_times == _settleTimes )
+    {
+        m_firstLocalMs = localMs;
+        m_firstMS = m_anchorMS;
+    }
+
+    long spanMs( localMs - m_firstLocalMs );
+    if( ( m_times > _settleTimes ) && ( spanMs >= _minDriftSpanMs ) )
+    {
+        m_rate = ( m_anchorMS - m_firstMS ) / spanMs;
+        if( m_rate > ( 1 + _maxDrift ) ) m_rate = 1 + _maxDrift;
+        if( m_rate < ( 1 - _maxDrift ) ) m_rate = 1 - _maxDrift;
+    }
+}
+
+bool Disciplined::synchronised()
+{
+    return m_synchronised;
+}
+
+String Disciplined::dateTime()
+{
+    String dateTime;
+    timestampToISO( epochS(), dateTime );
+    return dateTime;
+}
+
+void Disciplined::fillDateTime( char* fdateTime )
+{
+    ::strncpy( fdateTime, dateTime().c_str(), 14 );
+}
+
+unsigned long long Disciplined::epochMS()
+{
+    if( !m_synchronised ) return 0;
+
+    unsigned long long epochMS( estimate( m_timer->ms() ) );
+    if( epochMS < m_lastMS )
+    {
+        epochMS = m_lastMS; // Hold still while we're slewing back.
+    }
+    m_lastMS = epochMS;
+
+    return epochMS;
+}
+
+long Disciplined::driftPPM()
+{
+    // If the local timer is fast we have to slow it down.
+    return (long)( ( ( 1 / m_rate ) - 1 ) * 1000000 );
+}
+
+void Disciplined::anchor( long localMs, double epochMS )
+{
+    m_anchorLocalMs = localMs;
+    m_anchorMS = epochMS;
+    m_rate = 1;
+    m_firstLocalMs = localMs;
+    m_firstMS = epochMS;
+    m_times = 0;
+}
+
+double Disciplined::estimate( long localMs )
+{
+    return m_anchorMS + ( ( localMs - m_anchorLocalMs ) * m_rate );
+}
+
+} // namespace Clocks
+
+} // namespace Agape
@@ -0,0 +1,68 @@
+#ifndef AGAPE_CLOCKS_DISCIPLINED_H
+#define AGAPE_CLOCKS_DISCIPLINED_H
+
+#include "Clock.h"
+#include "String.h"
+
+namespace Agape
+{
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+class Timer;
+
+namespace Clocks
+{
+
+// A clock run from a local timer, disciplined by the times we're sent (e.g.
+// in Time tuples) so that it can be read at any moment without waiting for
+// the next one. Between times it follows the local timer, corrected for its
+// estimated drift, and it never goes backwards unless it has to step.
+class Disciplined : public Clock
+{
+public:
+    Disciplined( Timers::Factory& timerFactory );
+    virtual ~Disciplined();
+
+    // A time we've been sent, in ms since the epoch.
+    void discipline( unsigned long long epochMS );
+    bool synchronised();
+
+    virtual String dateTime();
+    virtual void fillDateTime( char* fdateTime );
+
+    virtual unsigned long long epochMS(); // 0 until synchronised.
+
+    // Estimated drift of the local timer, in parts per million fast.
+    long driftPPM();
+
+private:
+    void anchor( long localMs, double epochMS );
+    double estimate( long localMs );
+
+    Timer* m_timer;
+
+    bool m_synchronised;
+
+    // The estimate is m_anchorMS, plus ms since m_anchorLocalMs scaled by
+    // m_rate.
+    long m_anchorLocalMs;
+    double m_anchorMS;
+    double m_rate;
+
+    // Where drift is measured from.
+    long m_firstLocalMs;
+    double m_firstMS;
+    int m_times;
+
+    unsigned long long m_lastMS;
+};
+
+} // namespace Clocks
+
+} // namespace Agape
+
+#endif // AGAPE_CLOCKS_DISCIPLINED_H
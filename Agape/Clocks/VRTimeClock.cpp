@@ -18,9 +18,7 @@ VRTime::VRTime( UI::VRTime& vrTimeUI ) :
 
 String VRTime::dateTime()
 {
-    String dateTime;
-    timestampToISO( m_vrTimeUI.m_secsSinceEpoch, dateTime );
-    return dateTime;
+    return m_vrTimeUI.m_clock.dateTime();
 }
 
 void VRTime::fillDateTime( char* fdateTime )
@@ -32,7 +30,7 @@ unsigned long long VRTime::epochMS()
 {
     m_vrTimeUI.waitForTime();
 
-    return (unsigned long long)m_vrTimeUI.m_secsSinceEpoch * 1000ull;
+    return m_vrTimeUI.m_clock.epochMS();
 }
 
 } // namespace Clocks
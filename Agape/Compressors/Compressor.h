@@ -0,0 +1,29 @@
+#ifndef AGAPE_COMPRESSOR_H
+#define AGAPE_COMPRESSOR_H
+
+namespace Agape
+{
+
+class Compressor
+{
+public:
+    virtual ~Compressor() {}
+
+    /// Identifies the format on the wire, so peers can agree on it.
+    virtual char id() = 0;
+
+    /// Largest input accepted by compress(), and output by decompress().
+    virtual int maxBlockSize() = 0;
+
+    /// Each block is compressed independently. Returns the compressed
+    /// length, or -1 if the block would not compress to within outLen.
+    virtual int compress( const char* in, int inLen, char* out, int outLen ) = 0;
+
+    /// Returns the decompressed length, or -1 if the input is corrupt or
+    /// would not decompress to within outLen.
+    virtual int decompress( const char* in, int inLen, char* out, int outLen ) = 0;
+};
+
+} // namespace Agape
+
+#endif // AGAPE_COMPRESSOR_H
@@ -0,0 +1,197 @@
+#ifdef COMPRESSOR_TEST
+
+#include "Compressors/LZCompressor.h"
+#include "Collections.h"
+#include "ReadableWritable.h"
+#include "RWCompressor.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace Agape;
+
+namespace
+{
+    const int _chunkSize( 1024 ); // As read by the Linda2 asset loader.
+
+    // One direction of an in-process link.
+    class Pipe
+    {
+    public:
+        String m_data;
+        int m_offset;
+
+        Pipe() : m_offset( 0 ) {}
+    };
+
+    class LoopbackEnd : public ReadableWritable
+    {
+    public:
+        LoopbackEnd( Pipe& in, Pipe& out ) : m_in( in ), m_out( out ) {}
+
+        virtual int read( char* data, int len )
+        {
+            int available( m_in.m_data.length() - m_in.m_offset );
+            int count( len < available ? len : available );
+            m_in.m_data.copy( data, count, m_in.m_offset );
+            m_in.m_offset += count;
+            return count;
+        }
+
+        virtual int write( const char* data, int len )
+        {
+            m_out.m_data.append( data, len );
+            return len;
+        }
+
+        virtual bool error() { return false; }
+
+    private:
+        Pipe& m_in;
+        Pipe& m_out;
+    };
+
+    String randomString( int len, bool printable )
+    {
+        String s( len, '\0' );
+        for( int i( 0 ); i < len; ++i )
+        {
+            s[i] = printable ? ( 'A' + ( std::rand() % 26 ) ) : std::rand();
+        }
+        return s;
+    }
+
+    bool send( ReadableWritable& from, ReadableWritable& to, const Linda2::Tuple& tuple )
+    {
+        if( !tuple.toReadableWritable( from ) ) return false;
+        from.flushOutput();
+
+        Linda2::Tuple received;
+        return( Linda2::Tuple::fromReadableWritable( to, received ) &&
+                ( received.dump() == tuple.dump() ) );
+    }
+
+    // Replays an asset load: a request tuple, answered by a read response
+    // per chunk, as for a scene's ANSI art.
+    bool replayAsset( ReadableWritable& client, ReadableWritable& server, const String& asset )
+    {
+        String assetName( randomString( 64, true ) );
+        for( int offset( 0 ); offset < (int)asset.length(); offset += _chunkSize )
+        {
+            int length( ( asset.length() - offset ) < _chunkSize ? ( asset.length() - offset ) : _chunkSize );
+
+            Linda2::Tuple request;
+            request[_type] = _AssetReadRequest;
+            request[_sourceActor] = _AssetLoader;
+            request[_sourceID] = "Client0";
+            request[_collectionName] = "Assets";
+            request[_assetName] = assetName;
+            request[_offset] = offset;
+            request[_length] = length;
+            if( !send( client, server, request ) ) return false;
+
+            Linda2::Tuple response;
+            response[_type] = _AssetReadResponse;
+            response[_sourceActor] = _AssetLoaderResponder;
+            response[_destinationID] = "Client0";
+            response[_collectionName] = "Assets";
+            response[_success] = 1;
+            response[_length] = length;
+            response[_data] = asset.substr( offset, length );
+            response[_data].markBinary();
+            if( !send( server, client, response ) ) return false;
+        }
+
+        return true;
+    }
+
+    bool replay( const char* name, const Vector< String >& assets, bool compressed )
+    {
+        Pipe up;
+        Pipe down;
+        LoopbackEnd clientEnd( down, up );
+        LoopbackEnd serverEnd( up, down );
+        Compressors::LZ clientCompressor;
+        Compressors::LZ serverCompressor;
+        RWCompressor client( clientCompressor, clientEnd, compressed );
+        RWCompressor server( serverCompressor, serverEnd, compressed, true );
+
+        std::clock_t start( std::clock() );
+        bool success( true );
+        Vector< String >::const_iterator it( assets.begin() );
+        for( ; success && ( it != assets.end() ); ++it )
+        {
+            success = replayAsset( client, server, *it );
+        }
+        double seconds( double( std::clock() - start ) / CLOCKS_PER_SEC );
+
+        double rawBytes( client.bytesOut() + server.bytesOut() );
+        double wireBytes( up.m_data.length() + down.m_data.length() );
+        std::cout << name << ( compressed ? " compressed: " : " uncompressed: " )
+                  << rawBytes << " bytes -> " << wireBytes << " on the wire ("
+                  << ( 100.0 * ( rawBytes - wireBytes ) / rawBytes ) << "% saved), "
+                  << ( 1000.0 * seconds / ( rawBytes / ( 1024.0 * 1024.0 ) ) ) << " ms CPU/MB"
+                  << ( success ? "" : " FAILED" ) << std::endl;
+
+        return success;
+    }
+
+    bool legacyPeer()
+    {
+        // A peer without compression talks raw tuples to a detecting end.
+        Pipe up;
+        Pipe down;
+        LoopbackEnd clientEnd( down, up );
+        LoopbackEnd serverEnd( up, down );
+        Compressors::LZ serverCompressor;
+        RWCompressor server( serverCompressor, serverEnd, true, true );
+
+        Linda2::Tuple tuple;
+        tuple[_type] = _Time;
+        tuple[_data] = "legacy";
+        bool success( send( clientEnd, server, tuple ) && send( server, clientEnd, tuple ) );
+        std::cout << "Legacy peer pass-through: " << ( success ? "OK" : "FAILED" ) << std::endl;
+
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        std::cout << "Usage: " << argv[0] << " <asset.ans>..." << std::endl;
+        return 1;
+    }
+
+    Vector< String > plainAssets;
+    Vector< String > encryptedAssets;
+    for( int i( 1 ); i < argc; ++i )
+    {
+        std::ifstream file( argv[i], std::ios::binary );
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        plainAssets.push_back( String( contents.str().c_str(), contents.str().length() ) );
+
+        // Assets from worlds are AES-encrypted, so stand in with random bytes
+        // of the same length.
+        encryptedAssets.push_back( randomString( plainAssets.back().length(), false ) );
+    }
+
+    bool success( legacyPeer() );
+    success = replay( "Plain assets", plainAssets, false ) && success;
+    success = replay( "Plain assets", plainAssets, true ) && success;
+    success = replay( "Encrypted assets", encryptedAssets, false ) && success;
+    success = replay( "Encrypted assets", encryptedAssets, true ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return( success ? 0 : 1 );
+}
+
+#endif // COMPRESSOR_TEST
@@ -0,0 +1,230 @@
+#include "LZCompressor.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+    const int _maxBlockSize( 4096 );
+    const int _minMatch( 4 );
+    const int _maxMatch( _minMatch + 0x7F );
+    const int _maxLiterals( 0x80 );
+    const int _hashBits( 11 );
+    const int _hashSize( 1 << _hashBits );
+    const uint16_t _noPosition( 0xFFFF );
+
+    // Preset dictionary: ANSI escape sequences and block characters common
+    // in scenes and screens, then tuple types and keys as Tuple and Value
+    // serialise them. The most frequent material is at the end.
+    const char _dictionary[] =
+        "\015\012\033[0m\033[2J\033[H\033[s\033[u\033[K\033[0;1;37m\033[0;37m\033[1;30m\033[0;30m\033"
+        "[40m\033[44m\033[41m\033[1;31m\033[1;32m\033[1;33m\033[1;34m\033[1;35m\033[1;36m\033[0;31m\033"
+        "[0;32m\033[0;33m\033[0;34m\033[0;35m\033[0;36m\333\333\333\333\333\333\333\333\260\260\261\261"
+        "\262\262\334\334\334\334\337\337\337\337        \000\020\000\000\000AssetReadRequest\000\021"
+        "\000\000\000AssetReadResponse\000\020\000\000\000AssetOpenRequest\000\021\000\000\000AssetOp"
+        "enResponse\000\021\000\000\000AssetCloseRequest\000\022\000\000\000AssetCloseResponse\000\020"
+        "\000\000\000SceneLoadRequest\000\021\000\000\000SceneLoadResponse\000\014\000\000\000SceneRe"
+        "quest\000\015\000\000\000SceneResponse\000\017\000\000\000PresenceRequest\000\020\000\000\000"
+        "PresenceResponse\000\004\000\000\000Time\000\004\000\000\000Tick\006reason\000\010openMode\000"
+        "\006offset\000\006length\000\005items\000\004name\000\007version\000\011assetName\000\011sce"
+        "neItem\000\012sceneItems\000\011snowflake\000\004data\000\013coordinates\000\007worldID\000\001"
+        "x\000\001y\000\016collectionName\000\007success\000\015destinationID\000\020destinationActor"
+        "\000\010sourceID\000\013sourceActor\000\004type\000";
+    const int _dictionarySize( sizeof( _dictionary ) - 1 );
+
+    inline unsigned int hash( const char* p )
+    {
+        uint32_t v( (uint8_t)p[0] | ( (uint8_t)p[1] << 8 ) | ( (uint8_t)p[2] << 16 ) | ( (uint32_t)(uint8_t)p[3] << 24 ) );
+        return( ( v * 2654435761U ) >> ( 32 - _hashBits ) );
+    }
+
+    // Emits literals [start, end) of the window. Returns false if they
+    // don't fit.
+    bool emitLiterals( const char* window, int start, int end, char* out, int outLen, int& produced )
+    {
+        while( start < end )
+        {
+            int count( ( end - start ) < _maxLiterals ? ( end - start ) : _maxLiterals );
+            if( ( produced + 1 + count ) > outLen )
+            {
+                return false;
+            }
+
+            out[produced++] = (char)( count - 1 );
+            ::memcpy( out + produced, window + start, count );
+            produced += count;
+            start += count;
+        }
+
+        return true;
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Compressors
+{
+
+LZ::LZ() :
+  m_window( nullptr ),
+  m_hashTable( nullptr ),
+  m_dictionaryHashTable( nullptr )
+{
+}
+
+LZ::~LZ()
+{
+    delete[]( m_window );
+    delete[]( m_hashTable );
+    delete[]( m_dictionaryHashTable );
+}
+
+char LZ::id()
+{
+    return 'L';
+}
+
+int LZ::maxBlockSize()
+{
+    return _maxBlockSize;
+}
+
+int LZ::compress( const char* in, int inLen, char* out, int outLen )
+{
+    if( ( inLen < 0 ) || ( inLen > _maxBlockSize ) )
+    {
+        return -1;
+    }
+
+    if( !m_window )
+    {
+        // Window holds the dictionary followed by the block, so matches can
+        // reach back into the dictionary. Dictionary positions are hashed
+        // once and copied in for each block.
+        m_window = new char[_dictionarySize + _maxBlockSize];
+        m_hashTable = new uint16_t[_hashSize];
+        m_dictionaryHashTable = new uint16_t[_hashSize];
+
+        ::memcpy( m_window, _dictionary, _dictionarySize );
+        for( int i( 0 ); i < _hashSize; ++i )
+        {
+            m_dictionaryHashTable[i] = _noPosition;
+        }
+        for( int pos( 0 ); ( pos + _minMatch ) <= _dictionarySize; ++pos )
+        {
+            m_dictionaryHashTable[hash( m_window + pos )] = pos;
+        }
+    }
+
+    ::memcpy( m_window + _dictionarySize, in, inLen );
+    ::memcpy( m_hashTable, m_dictionaryHashTable, _hashSize * sizeof( uint16_t ) );
+
+    int produced( 0 );
+    int end( _dictionarySize + inLen );
+    int literalStart( _dictionarySize );
+    int pos( _dictionarySize );
+    while( ( pos + _minMatch ) <= end )
+    {
+        unsigned int h( hash( m_window + pos ) );
+        int candidate( m_hashTable[h] );
+        m_hashTable[h] = pos;
+
+        if( ( candidate == _noPosition ) ||
+            ( ::memcmp( m_window + candidate, m_window + pos, _minMatch ) != 0 ) )
+        {
+            ++pos;
+            continue;
+        }
+
+        int length( _minMatch );
+        while( ( ( pos + length ) < end ) &&
+               ( length < _maxMatch ) &&
+               ( m_window[candidate + length] == m_window[pos + length] ) )
+        {
+            ++length;
+        }
+
+        if( !emitLiterals( m_window, literalStart, pos, out, outLen, produced ) ||
+            ( ( produced + 3 ) > outLen ) )
+        {
+            return -1;
+        }
+
+        int distance( pos - candidate );
+        out[produced++] = (char)( 0x80 | ( length - _minMatch ) );
+        out[produced++] = (char)( distance >> 8 );
+        out[produced++] = (char)( distance & 0xFF );
+
+        // Index the positions within the match too, so later data can refer
+        // back into it.
+        for( int i( 1 ); ( i < length ) && ( ( pos + i + _minMatch ) <= end ); ++i )
+        {
+            m_hashTable[hash( m_window + pos + i )] = pos + i;
+        }
+
+        pos += length;
+        literalStart = pos;
+    }
+
+    if( !emitLiterals( m_window, literalStart, end, out, outLen, produced ) )
+    {
+        return -1;
+    }
+
+    return produced;
+}
+
+int LZ::decompress( const char* in, int inLen, char* out, int outLen )
+{
+    int consumed( 0 );
+    int produced( 0 );
+    while( consumed < inLen )
+    {
+        uint8_t token( in[consumed++] );
+        if( token < 0x80 )
+        {
+            int count( token + 1 );
+            if( ( ( consumed + count ) > inLen ) || ( ( produced + count ) > outLen ) )
+            {
+                return -1;
+            }
+
+            ::memcpy( out + produced, in + consumed, count );
+            consumed += count;
+            produced += count;
+        }
+        else
+        {
+            if( ( consumed + 2 ) > inLen )
+            {
+                return -1;
+            }
+
+            int length( ( token & 0x7F ) + _minMatch );
+            int distance( ( (uint8_t)in[consumed] << 8 ) | (uint8_t)in[consumed + 1] );
+            consumed += 2;
+
+            if( ( distance == 0 ) ||
+                ( distance > ( produced + _dictionarySize ) ) ||
+                ( ( produced + length ) > outLen ) )
+            {
+                return -1;
+            }
+
+            // Byte at a time, as source and destination may overlap, and
+            // the source may start in the dictionary.
+            for( int i( 0 ); i < length; ++i, ++produced )
+            {
+                int source( produced - distance );
+                out[produced] = ( source >= 0 ) ? out[source] : _dictionary[_dictionarySize + source];
+            }
+        }
+    }
+
+    return produced;
+}
+
+} // namespace Compressors
+
+} // namespace Agape
@@ -0,0 +1,50 @@
+#ifndef AGAPE_COMPRESSORS_LZ_H
+#define AGAPE_COMPRESSORS_LZ_H
+
+#include "Compressor.h"
+
+#include <stdint.h>
+
+namespace Agape
+{
+
+namespace Compressors
+{
+
+/// Byte-oriented LZ77 compressor in the style of LZ4, tuned for the small
+/// blocks (a tuple or two) sent over a link.
+///
+/// Every block is compressed as if preceded by a preset dictionary of
+/// common tuple keys and ANSI escape sequences, so even a lone tuple
+/// compresses well. The stream is a series of tokens:
+/// * 0x00-0x7F: (token + 1) literal bytes follow.
+/// * 0x80-0xFF: copy (token - 0x80 + 4) bytes from the distance given by
+///   the two following bytes (big-endian) back into the dictionary and
+///   output so far.
+///
+/// Decompression needs no memory beyond the output buffer. Compression
+/// allocates its window and hash table on first use, so decode-only users
+/// (e.g. small clients which send uncompressed) don't pay for them.
+class LZ : public Compressor
+{
+public:
+    LZ();
+    virtual ~LZ();
+
+    virtual char id();
+    virtual int maxBlockSize();
+
+    virtual int compress( const char* in, int inLen, char* out, int outLen );
+    virtual int decompress( const char* in, int inLen, char* out, int outLen );
+
+private:
+    char* m_window;
+    uint16_t* m_hashTable;
+    uint16_t* m_dictionaryHashTable;
+};
+
+} // namespace Compressors
+
+} // namespace Agape
+
+#endif // AGAPE_COMPRESSORS_LZ_H
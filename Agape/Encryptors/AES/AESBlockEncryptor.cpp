@@ -3,6 +3,7 @@
 #include "Utils/LiteStream.h"
 #include "Utils/StrToHex.h"
 #include "AESBlockEncryptor.h"
+#include "AESCTR.h"
 #include "RandomReadableWritable.h"
 #include "String.h"
 
@@ -31,6 +32,7 @@ AESBlock::AESBlock( EntropySource& entropySource ) :
     // If we stuff up and forget to setKey(), use some random
     // key, rather than encrypting with all zeroes or something!
     m_entropySource.generate( (char*)m_key, AES_KEYLEN );
+    AES_init_ctx( &m_context, m_key );
 
     m_writeBuffer = new char[bufferSize];
 }
@@ -45,7 +47,14 @@ void AESBlock::setKey( const char* key )
 #ifdef LOG_AESBLOCK
     LOG_DEBUG( "AESBlock: Key set" );
 #endif
+    // Only re-expand the key schedule if the key has changed.
+    if( ::memcmp( m_key, key, AES_KEYLEN ) == 0 )
+    {
+        return;
+    }
+
     ::memcpy( m_key, key, AES_KEYLEN );
+    AES_init_ctx( &m_context, m_key );
 }
 
 bool AESBlock::open( enum OpenMode openMode, RandomReadableWritable* backingDevice )
@@ -140,7 +149,7 @@ int AESBlock::read( char* data, int offset, int len )
         }
 #endif
 
-        AES_CTR_xcrypt_buffer( &context, (std::uint8_t*)readBuffer, bytesRead );
+        AESCTR::xcrypt( &context, (std::uint8_t*)readBuffer, bytesRead );
         ::memcpy( data, ( readBuffer + bytesFromBlockStart ), ( bytesRead - bytesFromBlockStart ) );
         return ( bytesRead - bytesFromBlockStart );
     }
@@ -282,7 +291,8 @@ void AESBlock::initForBlock( struct AES_ctx& context, int offset )
     std::uint8_t blockiv[AES_BLOCKLEN];
     calculateIV( offset, blockiv );
 
-    AES_init_ctx_iv( &context, m_key, blockiv );
+    context = m_context;
+    AES_ctx_set_iv( &context, blockiv );
 }
 
 void AESBlock::flushWriteBuffer()
@@ -293,7 +303,7 @@ void AESBlock::flushWriteBuffer()
 
     struct AES_ctx context;
     initForBlock( context, m_writeBufferOffset );
-    AES_CTR_xcrypt_buffer( &context, (std::uint8_t*)m_writeBuffer, m_writeBufferFill );
+    AESCTR::xcrypt( &context, (std::uint8_t*)m_writeBuffer, m_writeBufferFill );
 
 #ifdef LOG_AESBLOCK
     {
@@ -0,0 +1,189 @@
+#include "AESCTR.h"
+
+#include "Encryptors/AES/tiny-AES-c/aes.hpp"
+
+#include <cstdint>
+
+#include <string.h>
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ ) && !defined( __EMSCRIPTEN__ )
+#define AESCTR_AESNI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+#ifdef AESCTR_AESNI
+    const int _rounds( ( AES_keyExpSize / AES_BLOCKLEN ) - 1 );
+    const int _parallelBlocks( 4 ); // Keeps the AES unit's pipeline busy.
+
+    bool aesniSupported()
+    {
+        unsigned int eax( 0 ), ebx( 0 ), ecx( 0 ), edx( 0 );
+        if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+        {
+            return false;
+        }
+
+        return( ( ecx & bit_AES ) && ( ecx & bit_SSE4_1 ) );
+    }
+
+    inline void storeCounter( std::uint8_t* block, std::uint32_t counter )
+    {
+        block[12] = counter >> 24;
+        block[13] = counter >> 16;
+        block[14] = counter >> 8;
+        block[15] = counter;
+    }
+
+    __attribute__(( target( "aes,sse4.1" ) ))
+    void xcryptAESNI( struct AES_ctx* context, std::uint8_t* buffer, int length )
+    {
+        __m128i roundKeys[_rounds + 1];
+        for( int i( 0 ); i <= _rounds; ++i )
+        {
+            roundKeys[i] = _mm_loadu_si128( reinterpret_cast< const __m128i* >( context->RoundKey + ( i * AES_BLOCKLEN ) ) );
+        }
+
+        std::uint32_t counter( ( context->Iv[12] << 24 ) |
+                               ( context->Iv[13] << 16 ) |
+                               ( context->Iv[14] << 8 ) |
+                               context->Iv[15] );
+
+        std::uint8_t counterBlocks[_parallelBlocks * AES_BLOCKLEN];
+        for( int i( 0 ); i < _parallelBlocks; ++i )
+        {
+            ::memcpy( counterBlocks + ( i * AES_BLOCKLEN ), context->Iv, AES_BLOCKLEN );
+        }
+
+        while( length > 0 )
+        {
+            int blockCount( ( length + AES_BLOCKLEN - 1 ) / AES_BLOCKLEN );
+            if( blockCount > _parallelBlocks )
+            {
+                blockCount = _parallelBlocks;
+            }
+
+            __m128i keystream[_parallelBlocks];
+            for( int i( 0 ); i < blockCount; ++i )
+            {
+                storeCounter( counterBlocks + ( i * AES_BLOCKLEN ), counter++ );
+                keystream[i] = _mm_xor_si128( _mm_loadu_si128( reinterpret_cast< const __m128i* >( counterBlocks + ( i * AES_BLOCKLEN ) ) ),
+                                              roundKeys[0] );
+            }
+
+            for( int round( 1 ); round < _rounds; ++round )
+            {
+                for( int i( 0 ); i < blockCount; ++i )
+                {
+                    keystream[i] = _mm_aesenc_si128( keystream[i], roundKeys[round] );
+                }
+            }
+
+            for( int i( 0 ); i < blockCount; ++i )
+            {
+                keystream[i] = _mm_aesenclast_si128( keystream[i], roundKeys[_rounds] );
+
+                if( length >= AES_BLOCKLEN )
+                {
+                    __m128i* block( reinterpret_cast< __m128i* >( buffer ) );
+                    _mm_storeu_si128( block, _mm_xor_si128( _mm_loadu_si128( block ), keystream[i] ) );
+                    buffer += AES_BLOCKLEN;
+                    length -= AES_BLOCKLEN;
+                }
+                else
+                {
+                    std::uint8_t keystreamBytes[AES_BLOCKLEN];
+                    _mm_storeu_si128( reinterpret_cast< __m128i* >( keystreamBytes ), keystream[i] );
+                    for( int j( 0 ); j < length; ++j )
+                    {
+                        buffer[j] ^= keystreamBytes[j];
+                    }
+                    length = 0;
+                }
+            }
+        }
+
+        storeCounter( context->Iv, counter );
+    }
+#endif
+
+    enum Agape::Encryptors::AESCTR::Backend& selectedBackend()
+    {
+#ifdef AESCTR_AESNI
+        static enum Agape::Encryptors::AESCTR::Backend backend( aesniSupported() ? Agape::Encryptors::AESCTR::backendAESNI
+                                                                                 : Agape::Encryptors::AESCTR::backendSoftware );
+#else
+        static enum Agape::Encryptors::AESCTR::Backend backend( Agape::Encryptors::AESCTR::backendSoftware );
+#endif
+        return backend;
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Encryptors
+{
+
+void AESCTR::xcrypt( struct AES_ctx* context, std::uint8_t* buffer, int length )
+{
+#ifdef AESCTR_AESNI
+    if( selectedBackend() == backendAESNI )
+    {
+        xcryptAESNI( context, buffer, length );
+        return;
+    }
+#endif
+
+    AES_CTR_xcrypt_buffer( context, buffer, length );
+}
+
+enum AESCTR::Backend AESCTR::backend()
+{
+    return selectedBackend();
+}
+
+bool AESCTR::setBackend( enum Backend backend )
+{
+    if( !supported( backend ) )
+    {
+        return false;
+    }
+
+    selectedBackend() = backend;
+    return true;
+}
+
+bool AESCTR::supported( enum Backend backend )
+{
+    switch( backend )
+    {
+        case backendSoftware:
+            return true;
+#ifdef AESCTR_AESNI
+        case backendAESNI:
+            return aesniSupported();
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* AESCTR::backendName( enum Backend backend )
+{
+    switch( backend )
+    {
+        case backendSoftware:
+            return "tiny-AES-c";
+        case backendAESNI:
+            return "AES-NI";
+        default:
+            return "unknown";
+    }
+}
+
+} // namespace Encryptors
+
+} // namespace Agape
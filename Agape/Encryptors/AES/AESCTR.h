@@ -0,0 +1,49 @@
+#ifndef AGAPE_ENCRYPTORS_AES_CTR_H
+#define AGAPE_ENCRYPTORS_AES_CTR_H
+
+#include "Encryptors/AES/tiny-AES-c/aes.hpp"
+
+#include <cstdint>
+
+namespace Agape
+{
+
+namespace Encryptors
+{
+
+/// AES-CTR keystream application, dispatched at runtime to the fastest
+/// backend the CPU supports.
+///
+/// All backends share tiny-AES-c's context (the expanded key schedule is laid
+/// out identically for AES-NI) and its counter behaviour: the low 32 bits of
+/// the IV are a big-endian counter which wraps without carrying into the
+/// rest of the IV, and the IV is advanced once per block begun, including a
+/// trailing partial block. Ciphertext is therefore interchangeable between
+/// backends.
+class AESCTR
+{
+public:
+    enum Backend
+    {
+        backendSoftware, ///< tiny-AES-c; available everywhere.
+        backendAESNI     ///< x86 AES-NI; desktop and server builds only.
+    };
+
+    static void xcrypt( struct AES_ctx* context, std::uint8_t* buffer, int length );
+
+    /// Backend in use. Defaults to the fastest one supported.
+    static enum Backend backend();
+
+    /// Forces a backend, e.g. to cross-check or benchmark them. Returns false
+    /// (leaving the backend unchanged) if it isn't supported here.
+    static bool setBackend( enum Backend backend );
+
+    static bool supported( enum Backend backend );
+    static const char* backendName( enum Backend backend );
+};
+
+} // namespace Encryptors
+
+} // namespace Agape
+
+#endif // AGAPE_ENCRYPTORS_AES_CTR_H
@@ -1,4 +1,5 @@
 #include "EntropySources/EntropySource.h"
+#include "AESCTR.h"
 #include "AESEncryptor.h"
 #include "String.h"
 
@@ -21,11 +22,21 @@ AES::AES( EntropySource& entropySource ) :
     // If we stuff up and forget to setKey(), use some random
     // key, rather than encrypting with all zeroes or something!
     m_entropySource.generate( (char*)m_key, AES_KEYLEN );
+    AES_init_ctx( &m_context, m_key );
 }
 
 void AES::setKey( const char* key )
 {
+    // Expanding the key schedule costs more than CTR-crypting a scene item,
+    // and callers tend to set the same key over and over, so only expand it
+    // when the key actually changes.
+    if( ::memcmp( m_key, key, AES_KEYLEN ) == 0 )
+    {
+        return;
+    }
+
     ::memcpy( m_key, key, AES_KEYLEN );
+    AES_init_ctx( &m_context, m_key );
 }
 
 void AES::encrypt( const char* plainText,
@@ -46,9 +57,10 @@ void AES::encrypt( const char* plainText,
     std::uint8_t iv[AES_BLOCKLEN];
     m_entropySource.generate( reinterpret_cast< char* >( &iv ), AES_BLOCKLEN );
 
-    // Init AES.
-    struct AES_ctx context;
-    AES_init_ctx_iv( &context, m_key, iv );
+    // Init AES from the cached key schedule. The schedule is copied so that
+    // m_context is only ever read here, making concurrent decrypts safe.
+    struct AES_ctx context( m_context );
+    AES_ctx_set_iv( &context, iv );
 
     // Store IV.
     char* cipherPtr( cipherText );
@@ -60,7 +72,7 @@ void AES::encrypt( const char* plainText,
     // FIXME: We don't *have* to do padding in CTR mode, but we should!?
     // use PKCS#7?
     std::memcpy( cipherPtr, plainText, plainTextLen );
-    AES_CTR_xcrypt_buffer( &context, reinterpret_cast< std::uint8_t* >( cipherPtr ), plainTextLen );
+    AESCTR::xcrypt( &context, reinterpret_cast< std::uint8_t* >( cipherPtr ), plainTextLen );
 
     cipherTextProducedLen += plainTextLen;
     plainTextConsumedLen = plainTextLen;
@@ -88,13 +100,14 @@ void AES::decrypt( const char* cipherText,
     cipherPtr += AES_BLOCKLEN;
     cipherTextRemain -= AES_BLOCKLEN;
 
-    // Init AES.
-    struct AES_ctx context;
-    AES_init_ctx_iv( &context, m_key, iv );
+    // Init AES from the cached key schedule. The schedule is copied so that
+    // m_context is only ever read here, making concurrent decrypts safe.
+    struct AES_ctx context( m_context );
+    AES_ctx_set_iv( &context, iv );
 
     // Copy ciphertext to plaintext buffer and decrypt.
     std::memcpy( plainText, cipherPtr, cipherTextRemain );
-    AES_CTR_xcrypt_buffer( &context, reinterpret_cast< std::uint8_t* >( plainText ), cipherTextRemain );
+    AESCTR::xcrypt( &context, reinterpret_cast< std::uint8_t* >( plainText ), cipherTextRemain );
 
     cipherTextConsumedLen = cipherTextLen;
     plainTextProducedLen = cipherTextLen - AES_BLOCKLEN;
@@ -47,6 +47,7 @@ public:
 private:
     EntropySource& m_entropySource;
     std::uint8_t m_key[AES_KEYLEN];
+    struct AES_ctx m_context; // Key schedule expanded from m_key.
 };
 
 } // namespace Encryptors
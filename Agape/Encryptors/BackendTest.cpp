@@ -0,0 +1,213 @@
+#ifdef ENCRYPTORS_BACKEND_TEST
+
+#include "Encryptors/AES/AESCTR.h"
+#include "Encryptors/SHA256/SHA256Hash.h"
+#include "Utils/StrToHex.h"
+#include "String.h"
+
+#include "Encryptors/AES/tiny-AES-c/aes.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include <string.h>
+
+using namespace Agape;
+
+namespace
+{
+    const int _benchmarkSize( 64 * 1024 * 1024 );
+    const int _crossCheckRuns( 1000 );
+
+    bool sha256KnownAnswers()
+    {
+        struct KnownAnswer
+        {
+            String m_message;
+            int m_repeat;
+            const char* m_digest;
+        };
+
+        const KnownAnswer knownAnswers[] = {
+            { String( "" ), 1, "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855" },
+            { String( "abc" ), 1, "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD" },
+            { String( "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq" ), 1, "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1" },
+            { String( "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu" ), 1, "CF5B16A778AF8380036CE59E7B0492370B249B11E8F07A51AFAC45037AFEE9D1" },
+            { String( 1000, 'a' ), 1000, "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0" }
+        };
+
+        bool success( true );
+        for( unsigned int i( 0 ); i < ( sizeof( knownAnswers ) / sizeof( knownAnswers[0] ) ); ++i )
+        {
+            Hashes::SHA256 hash;
+            for( int j( 0 ); j < knownAnswers[i].m_repeat; ++j )
+            {
+                hash.update( knownAnswers[i].m_message.c_str(), knownAnswers[i].m_message.length() );
+            }
+
+            String digest( hash.digestSize(), '\0' );
+            hash.finalise( &digest[0] );
+            if( strToHex( digest ) != knownAnswers[i].m_digest )
+            {
+                std::cout << "  SHA-256 known answer " << i << " FAILED: " << strToHex( digest ) << std::endl;
+                success = false;
+            }
+        }
+
+        return success;
+    }
+
+    bool aesKnownAnswers()
+    {
+        // NIST SP 800-38A F.5.1, CTR-AES128.Encrypt.
+        const std::uint8_t key[16] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                       0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+        const std::uint8_t iv[16] = { 0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+                                      0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff };
+        const char* plainText = "6BC1BEE22E409F96E93D7E117393172AAE2D8A571E03AC9C9EB76FAC45AF8E51"
+                                "30C81C46A35CE411E5FBC1191A0A52EFF69F2445DF4F9B17AD2B417BE66C3710";
+        const char* cipherText = "874D6191B620E3261BEF6864990DB6CE9806F66B7970FDFF8617187BB9FFFDFF"
+                                 "5AE4DF3EDBD5D35E5B4F09020DB03EAB1E031DDA2FBE03D1792170A0F3009CEE";
+
+        String buffer;
+        for( int i( 0 ); plainText[i] != '\0'; i += 2 )
+        {
+            buffer.push_back( ( hexCharToNybble( plainText[i] ) << 4 ) | hexCharToNybble( plainText[i + 1] ) );
+        }
+
+        struct AES_ctx context;
+        AES_init_ctx_iv( &context, key, iv );
+
+        // Odd-sized pieces exercise partial blocks.
+        Encryptors::AESCTR::xcrypt( &context, (std::uint8_t*)&buffer[0], 16 );
+        Encryptors::AESCTR::xcrypt( &context, (std::uint8_t*)&buffer[16], 48 );
+
+        if( strToHex( buffer ) != cipherText )
+        {
+            std::cout << "  AES-CTR known answer FAILED: " << strToHex( buffer ) << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool crossCheck()
+    {
+        bool success( true );
+        for( int run( 0 ); run < _crossCheckRuns; ++run )
+        {
+            int length( std::rand() % 1000 );
+            std::uint8_t key[AES_KEYLEN];
+            std::uint8_t iv[AES_BLOCKLEN];
+            String data( length, '\0' );
+            for( int i( 0 ); i < AES_KEYLEN; ++i ) key[i] = std::rand();
+            for( int i( 0 ); i < AES_BLOCKLEN; ++i ) iv[i] = ( ( run % 2 ) && ( i >= 12 ) ) ? 0xFF : std::rand(); // Odd runs start at the counter wrap.
+            for( int i( 0 ); i < length; ++i ) data[i] = std::rand();
+
+            String software( data );
+            String hardware( data );
+            struct AES_ctx softwareContext;
+            struct AES_ctx hardwareContext;
+            AES_init_ctx_iv( &softwareContext, key, iv );
+            AES_init_ctx_iv( &hardwareContext, key, iv );
+
+            Encryptors::AESCTR::setBackend( Encryptors::AESCTR::backendSoftware );
+            Encryptors::AESCTR::xcrypt( &softwareContext, (std::uint8_t*)&software[0], length );
+            Encryptors::AESCTR::setBackend( Encryptors::AESCTR::backendAESNI );
+            Encryptors::AESCTR::xcrypt( &hardwareContext, (std::uint8_t*)&hardware[0], length );
+
+            if( ( software != hardware ) || ( ::memcmp( softwareContext.Iv, hardwareContext.Iv, AES_BLOCKLEN ) != 0 ) )
+            {
+                std::cout << "  AES-CTR cross-check FAILED for length " << length << std::endl;
+                success = false;
+            }
+
+            String digests[2];
+            Hashes::SHA256::Backend backends[2] = { Hashes::SHA256::backendSoftware, Hashes::SHA256::backendSHANI };
+            for( int i( 0 ); i < 2; ++i )
+            {
+                Hashes::SHA256::setBackend( backends[i] );
+                Hashes::SHA256 hash;
+                hash.update( data.c_str(), length / 3 );
+                hash.update( data.c_str() + ( length / 3 ), length - ( length / 3 ) );
+                digests[i] = String( hash.digestSize(), '\0' );
+                hash.finalise( &digests[i][0] );
+            }
+
+            if( digests[0] != digests[1] )
+            {
+                std::cout << "  SHA-256 cross-check FAILED for length " << length << std::endl;
+                success = false;
+            }
+        }
+
+        return success;
+    }
+
+    double megabytesPerSecond( std::chrono::steady_clock::time_point start )
+    {
+        std::chrono::duration< double > elapsed( std::chrono::steady_clock::now() - start );
+        return( ( _benchmarkSize / ( 1024.0 * 1024.0 ) ) / elapsed.count() );
+    }
+} // Anonymous namespace
+
+int main( int argc, char** argv )
+{
+    bool success( true );
+    String data( _benchmarkSize, 'x' );
+
+    Encryptors::AESCTR::Backend aesBackends[2] = { Encryptors::AESCTR::backendSoftware, Encryptors::AESCTR::backendAESNI };
+    for( int i( 0 ); i < 2; ++i )
+    {
+        if( !Encryptors::AESCTR::setBackend( aesBackends[i] ) )
+        {
+            std::cout << Encryptors::AESCTR::backendName( aesBackends[i] ) << ": not supported" << std::endl;
+            continue;
+        }
+
+        std::cout << Encryptors::AESCTR::backendName( aesBackends[i] ) << ":" << std::endl;
+        success = aesKnownAnswers() && success;
+
+        std::uint8_t key[AES_KEYLEN] = { 0 };
+        std::uint8_t iv[AES_BLOCKLEN] = { 0 };
+        struct AES_ctx context;
+        AES_init_ctx_iv( &context, key, iv );
+        std::chrono::steady_clock::time_point start( std::chrono::steady_clock::now() );
+        Encryptors::AESCTR::xcrypt( &context, (std::uint8_t*)&data[0], _benchmarkSize );
+        std::cout << "  AES-CTR " << megabytesPerSecond( start ) << " MB/s" << std::endl;
+    }
+
+    Hashes::SHA256::Backend shaBackends[2] = { Hashes::SHA256::backendSoftware, Hashes::SHA256::backendSHANI };
+    for( int i( 0 ); i < 2; ++i )
+    {
+        if( !Hashes::SHA256::setBackend( shaBackends[i] ) )
+        {
+            std::cout << Hashes::SHA256::backendName( shaBackends[i] ) << ": not supported" << std::endl;
+            continue;
+        }
+
+        std::cout << Hashes::SHA256::backendName( shaBackends[i] ) << ":" << std::endl;
+        success = sha256KnownAnswers() && success;
+
+        Hashes::SHA256 hash;
+        char digest[SHA256_BLOCK_SIZE];
+        std::chrono::steady_clock::time_point start( std::chrono::steady_clock::now() );
+        hash.update( data.c_str(), _benchmarkSize );
+        hash.finalise( digest );
+        std::cout << "  SHA-256 " << megabytesPerSecond( start ) << " MB/s" << std::endl;
+    }
+
+    if( Encryptors::AESCTR::supported( Encryptors::AESCTR::backendAESNI ) &&
+        Hashes::SHA256::supported( Hashes::SHA256::backendSHANI ) )
+    {
+        std::cout << "Cross-checking backends" << std::endl;
+        success = crossCheck() && success;
+    }
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return( success ? 0 : 1 );
+}
+
+#endif // ENCRYPTORS_BACKEND_TEST
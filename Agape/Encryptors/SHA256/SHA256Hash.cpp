@@ -1,5 +1,121 @@
 #include "SHA256Hash.h"
 
+#include <stdint.h>
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ ) && !defined( __EMSCRIPTEN__ )
+#define SHA256_SHANI
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    const int _blockSize( 64 );
+
+#ifdef SHA256_SHANI
+    const uint32_t _k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    bool shaniSupported()
+    {
+        unsigned int eax( 0 ), ebx( 0 ), ecx( 0 ), edx( 0 );
+        if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) ||
+            !( ecx & bit_SSSE3 ) ||
+            !( ecx & bit_SSE4_1 ) )
+        {
+            return false;
+        }
+
+        if( !__get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) )
+        {
+            return false;
+        }
+
+        return( ( ebx & bit_SHA ) != 0 );
+    }
+
+    // Compresses whole blocks into state using the SHA extensions. Each
+    // iteration of the inner loop performs four rounds, while scheduling the
+    // message words needed by later rounds.
+    __attribute__(( target( "sha,sse4.1,ssse3" ) ))
+    void transformSHANI( WORD* state, const BYTE* data, int blocks )
+    {
+        const __m128i byteSwap( _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL ) );
+
+        // Reorder state from ABCD EFGH into the ABEF CDGH the instructions use.
+        __m128i abcd( _mm_loadu_si128( reinterpret_cast< const __m128i* >( &state[0] ) ) );
+        __m128i efgh( _mm_loadu_si128( reinterpret_cast< const __m128i* >( &state[4] ) ) );
+        abcd = _mm_shuffle_epi32( abcd, 0xB1 );
+        efgh = _mm_shuffle_epi32( efgh, 0x1B );
+        __m128i abef( _mm_alignr_epi8( abcd, efgh, 8 ) );
+        __m128i cdgh( _mm_blend_epi16( efgh, abcd, 0xF0 ) );
+
+        for( ; blocks > 0; --blocks, data += _blockSize )
+        {
+            __m128i abefSave( abef );
+            __m128i cdghSave( cdgh );
+            __m128i message[4];
+
+            for( int i( 0 ); i < 16; ++i )
+            {
+                __m128i& current( message[i % 4] );
+                if( i < 4 )
+                {
+                    current = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + ( i * 16 ) ) ), byteSwap );
+                }
+
+                __m128i rounds( _mm_add_epi32( current, _mm_loadu_si128( reinterpret_cast< const __m128i* >( &_k[i * 4] ) ) ) );
+                cdgh = _mm_sha256rnds2_epu32( cdgh, abef, rounds );
+
+                if( ( i >= 3 ) && ( i <= 14 ) )
+                {
+                    __m128i& next( message[( i + 1 ) % 4] );
+                    next = _mm_add_epi32( next, _mm_alignr_epi8( current, message[( i + 3 ) % 4], 4 ) );
+                    next = _mm_sha256msg2_epu32( next, current );
+                }
+
+                rounds = _mm_shuffle_epi32( rounds, 0x0E );
+                abef = _mm_sha256rnds2_epu32( abef, cdgh, rounds );
+
+                if( ( i >= 1 ) && ( i <= 12 ) )
+                {
+                    __m128i& previous( message[( i + 3 ) % 4] );
+                    previous = _mm_sha256msg1_epu32( previous, current );
+                }
+            }
+
+            abef = _mm_add_epi32( abef, abefSave );
+            cdgh = _mm_add_epi32( cdgh, cdghSave );
+        }
+
+        // Back to ABCD EFGH.
+        __m128i feba( _mm_shuffle_epi32( abef, 0x1B ) );
+        __m128i dchg( _mm_shuffle_epi32( cdgh, 0xB1 ) );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( &state[0] ), _mm_blend_epi16( feba, dchg, 0xF0 ) );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( &state[4] ), _mm_alignr_epi8( dchg, feba, 8 ) );
+    }
+#endif
+
+    enum Agape::Hashes::SHA256::Backend& selectedBackend()
+    {
+#ifdef SHA256_SHANI
+        static enum Agape::Hashes::SHA256::Backend backend( shaniSupported() ? Agape::Hashes::SHA256::backendSHANI
+                                                                             : Agape::Hashes::SHA256::backendSoftware );
+#else
+        static enum Agape::Hashes::SHA256::Backend backend( Agape::Hashes::SHA256::backendSoftware );
+#endif
+        return backend;
+    }
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -13,7 +129,37 @@ SHA256::SHA256()
 
 void SHA256::update( const char* data, int len )
 {
-    sha256_update( &m_ctx, (const BYTE*)data, len );
+    const BYTE* bytes( reinterpret_cast< const BYTE* >( data ) );
+
+    // Top up any partially filled block first.
+    if( m_ctx.datalen != 0 )
+    {
+        int fill( _blockSize - m_ctx.datalen );
+        if( fill > len )
+        {
+            fill = len;
+        }
+
+        sha256_update( &m_ctx, bytes, fill );
+        bytes += fill;
+        len -= fill;
+    }
+
+    // Compress whole blocks straight from the caller's buffer, rather than
+    // copying them byte-by-byte into the context.
+    int blocks( len / _blockSize );
+    if( blocks > 0 )
+    {
+        transform( bytes, blocks );
+        m_ctx.bitlen += static_cast< unsigned long long >( blocks ) * _blockSize * 8;
+        bytes += blocks * _blockSize;
+        len -= blocks * _blockSize;
+    }
+
+    if( len > 0 )
+    {
+        sha256_update( &m_ctx, bytes, len );
+    }
 }
 
 int SHA256::digestSize()
@@ -31,6 +177,66 @@ void SHA256::reset()
     sha256_init( &m_ctx );
 }
 
+enum SHA256::Backend SHA256::backend()
+{
+    return selectedBackend();
+}
+
+bool SHA256::setBackend( enum Backend backend )
+{
+    if( !supported( backend ) )
+    {
+        return false;
+    }
+
+    selectedBackend() = backend;
+    return true;
+}
+
+bool SHA256::supported( enum Backend backend )
+{
+    switch( backend )
+    {
+        case backendSoftware:
+            return true;
+#ifdef SHA256_SHANI
+        case backendSHANI:
+            return shaniSupported();
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* SHA256::backendName( enum Backend backend )
+{
+    switch( backend )
+    {
+        case backendSoftware:
+            return "sha256.c";
+        case backendSHANI:
+            return "SHA-NI";
+        default:
+            return "unknown";
+    }
+}
+
+void SHA256::transform( const BYTE* data, int blocks )
+{
+#ifdef SHA256_SHANI
+    if( selectedBackend() == backendSHANI )
+    {
+        transformSHANI( m_ctx.state, data, blocks );
+        return;
+    }
+#endif
+
+    for( ; blocks > 0; --blocks, data += _blockSize )
+    {
+        sha256_transform( &m_ctx, data );
+    }
+}
+
 } // namespace Hashes
 
 } // namespace Agape
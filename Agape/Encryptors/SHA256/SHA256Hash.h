@@ -13,6 +13,12 @@ namespace Hashes
 class SHA256 : public Hash
 {
 public:
+    enum Backend
+    {
+        backendSoftware, ///< Bundled sha256.c; available everywhere.
+        backendSHANI     ///< x86 SHA extensions; desktop and server builds only.
+    };
+
     SHA256();
 
     virtual void update( const char* data, int len );
@@ -22,7 +28,20 @@ public:
 
     virtual void reset();
 
+    /// Backend used to compress whole blocks. Defaults to the fastest one
+    /// supported. Backends share the same state, so digests are identical.
+    static enum Backend backend();
+
+    /// Forces a backend, e.g. to cross-check or benchmark them. Returns false
+    /// (leaving the backend unchanged) if it isn't supported here.
+    static bool setBackend( enum Backend backend );
+
+    static bool supported( enum Backend backend );
+    static const char* backendName( enum Backend backend );
+
 private:
+    void transform( const BYTE* data, int blocks );
+
     SHA256_CTX_BC m_ctx;
 };
 
@@ -0,0 +1,109 @@
+#include "Encryptors/Encryptor.h"
+#include "BatchDecryptor.h"
+#include "Collections.h"
+#include "EncryptableDecryptable.h"
+
+#if defined( QT_CORE_LIB ) || defined( HYDRA )
+#define BATCH_DECRYPTOR_THREADS
+#include <thread>
+#endif
+
+namespace
+{
+    // Below this many items per thread, thread start-up costs more than
+    // the decryption it saves.
+    const int _minItemsPerThread( 16 );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Encryptors
+{
+
+namespace Utils
+{
+
+bool BatchDecryptor::decryptItems( const Vector< EncryptableDecryptable* >& items,
+                                   Encryptor& encryptor )
+{
+    int itemCount( items.size() );
+
+#ifdef BATCH_DECRYPTOR_THREADS
+    int threadCount( std::thread::hardware_concurrency() );
+    if( threadCount > ( itemCount / _minItemsPerThread ) )
+    {
+        threadCount = itemCount / _minItemsPerThread;
+    }
+
+    if( threadCount > 1 )
+    {
+        int sliceSize( ( itemCount + threadCount - 1 ) / threadCount );
+
+        // Results are stored as chars as Vector< bool > elements can't be
+        // written safely from separate threads.
+        Vector< char > results( threadCount, 1 );
+
+        // Vector's allocator copy-constructs, which threads don't allow.
+        std::thread* threads( new std::thread[threadCount - 1] );
+
+        // Hand all but the first slice to other threads and decrypt the first
+        // slice here.
+        for( int i( 1 ); i < threadCount; ++i )
+        {
+            int begin( i * sliceSize );
+            int end( ( begin + sliceSize ) < itemCount ? ( begin + sliceSize ) : itemCount );
+            char& result( results[i] );
+            threads[i - 1] = std::thread( [&items, begin, end, &encryptor, &result]()
+            {
+                result = decryptSlice( items, begin, end, encryptor ) ? 1 : 0;
+            } );
+        }
+
+        results[0] = decryptSlice( items, 0, sliceSize, encryptor ) ? 1 : 0;
+
+        bool success( true );
+        for( int i( 0 ); i < threadCount; ++i )
+        {
+            if( i > 0 )
+            {
+                threads[i - 1].join();
+            }
+
+            if( results[i] == 0 )
+            {
+                success = false;
+            }
+        }
+
+        delete[]( threads );
+
+        return success;
+    }
+#endif
+
+    return decryptSlice( items, 0, itemCount, encryptor );
+}
+
+bool BatchDecryptor::decryptSlice( const Vector< EncryptableDecryptable* >& items,
+                                   int begin,
+                                   int end,
+                                   Encryptor& encryptor )
+{
+    bool success( true );
+    for( int i( begin ); i < end; ++i )
+    {
+        if( !items[i]->decrypt( encryptor ) )
+        {
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+} // namespace Utils
+
+} // namespace Encryptors
+
+} // namespace Agape
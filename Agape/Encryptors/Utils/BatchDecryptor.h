@@ -0,0 +1,61 @@
+#ifndef AGAPE_ENCRYPTORS_UTILS_BATCH_DECRYPTOR_H
+#define AGAPE_ENCRYPTORS_UTILS_BATCH_DECRYPTOR_H
+
+#include "Collections.h"
+#include "EncryptableDecryptable.h"
+
+namespace Agape
+{
+
+class Encryptor;
+
+namespace Encryptors
+{
+
+namespace Utils
+{
+
+/// Decrypts a whole batch of items (e.g. the items of a scene) with a single
+/// key, rather than having each caller loop over the items itself.
+///
+/// The key must already have been set on the encryptor. Where threads are
+/// available (desktop and server builds) and the batch is large enough to be
+/// worth it, the batch is split into contiguous slices which are decrypted
+/// in parallel. This relies upon the encryptor's decrypt() being reentrant
+/// for a fixed key, which holds for the AES encryptors as they only read the
+/// cached key schedule. Elsewhere, items are decrypted serially.
+///
+/// Unlike a plain loop, every item is attempted even if an earlier one fails.
+class BatchDecryptor
+{
+public:
+    template< class T >
+    static bool decrypt( Vector< T >& items, Encryptor& encryptor )
+    {
+        Vector< EncryptableDecryptable* > pointers;
+        pointers.reserve( items.size() );
+        typename Vector< T >::iterator it( items.begin() );
+        for( ; it != items.end(); ++it )
+        {
+            pointers.push_back( &( *it ) );
+        }
+
+        return decryptItems( pointers, encryptor );
+    }
+
+private:
+    static bool decryptItems( const Vector< EncryptableDecryptable* >& items,
+                              Encryptor& encryptor );
+    static bool decryptSlice( const Vector< EncryptableDecryptable* >& items,
+                              int begin,
+                              int end,
+                              Encryptor& encryptor );
+};
+
+} // namespace Utils
+
+} // namespace Encryptors
+
+} // namespace Agape
+
+#endif // AGAPE_ENCRYPTORS_UTILS_BATCH_DECRYPTOR_H
@@ -1,9 +1,172 @@
+#include "Encryptors/AES/AESCTR.h"
 #include "DevRandom.h"
 
+#include "Encryptors/AES/tiny-AES-c/aes.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <mutex>
+
+#include <string.h>
+#ifdef __linux__
+#include <sys/random.h>
+#endif
 #include <sys/types.h>
 #include <fcntl.h>
 #include <unistd.h>
 
+namespace
+{
+    const int _poolSize( 4096 );
+    const int _reseedInterval( 1024 * 1024 ); // Bytes generated between reseeds.
+
+    // Fills buffer from the kernel, falling back to /dev/urandom where
+    // getrandom() isn't available (or isn't Linux).
+    bool kernelRandom( char* buffer, int len )
+    {
+        int got( 0 );
+#ifdef __linux__
+        while( got < len )
+        {
+            ssize_t result( ::getrandom( buffer + got, len - got, 0 ) );
+            if( result > 0 )
+            {
+                got += result;
+            }
+            else if( errno == ENOSYS )
+            {
+                break;
+            }
+            else if( errno != EINTR )
+            {
+                return false;
+            }
+        }
+#endif
+
+        if( got == len )
+        {
+            return true;
+        }
+
+        int fd( ::open( "/dev/urandom", O_RDONLY ) );
+        if( fd < 0 )
+        {
+            return false;
+        }
+
+        while( got < len )
+        {
+            ssize_t result( ::read( fd, buffer + got, len - got ) );
+            if( result <= 0 )
+            {
+                break;
+            }
+
+            got += result;
+        }
+
+        ::close( fd );
+
+        return( got == len );
+    }
+
+    bool ( *_kernelRandom )( char* buffer, int len )( kernelRandom );
+
+    // AES-CTR keystream generator shared by every DevRandom. Keystream is
+    // generated a pool at a time. After each refill the key is replaced with
+    // further keystream, and bytes are wiped from the pool as they are handed
+    // out, so captured state can't reproduce output already given out.
+    class SharedGenerator
+    {
+    public:
+        SharedGenerator() :
+          m_poolRemain( 0 ),
+          m_sinceReseed( _reseedInterval )
+        {
+        }
+
+        int generate( char* buffer, int len )
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+
+            int produced( 0 );
+            while( produced < len )
+            {
+                if( ( m_poolRemain == 0 ) && !refill() )
+                {
+                    break;
+                }
+
+                int chunk( ( len - produced ) < m_poolRemain ? ( len - produced ) : m_poolRemain );
+                std::uint8_t* source( m_pool + ( _poolSize - m_poolRemain ) );
+                ::memcpy( buffer + produced, source, chunk );
+                ::memset( source, 0, chunk );
+                m_poolRemain -= chunk;
+                produced += chunk;
+            }
+
+            return produced;
+        }
+
+        int poolRemain()
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            return m_poolRemain;
+        }
+
+    private:
+        bool reseed()
+        {
+            std::uint8_t seed[AES_KEYLEN + AES_BLOCKLEN];
+            if( !_kernelRandom( (char*)seed, sizeof( seed ) ) )
+            {
+                return false;
+            }
+
+            AES_init_ctx_iv( &m_context, seed, seed + AES_KEYLEN );
+            ::memset( seed, 0, sizeof( seed ) );
+            m_sinceReseed = 0;
+
+            return true;
+        }
+
+        bool refill()
+        {
+            if( ( m_sinceReseed >= _reseedInterval ) && !reseed() )
+            {
+                return false;
+            }
+
+            // Generate a pool's worth plus the next key.
+            ::memset( m_pool, 0, sizeof( m_pool ) );
+            Agape::Encryptors::AESCTR::xcrypt( &m_context, m_pool, sizeof( m_pool ) );
+
+            std::uint8_t iv[AES_BLOCKLEN];
+            ::memcpy( iv, m_context.Iv, AES_BLOCKLEN );
+            AES_init_ctx_iv( &m_context, m_pool + _poolSize, iv );
+            ::memset( m_pool + _poolSize, 0, AES_KEYLEN );
+
+            m_poolRemain = _poolSize;
+            m_sinceReseed += _poolSize;
+
+            return true;
+        }
+
+        std::mutex m_mutex;
+        struct AES_ctx m_context;
+        std::uint8_t m_pool[_poolSize + AES_KEYLEN];
+        int m_poolRemain;
+        int m_sinceReseed;
+    };
+
+    SharedGenerator& sharedGenerator()
+    {
+        static SharedGenerator generator;
+        return generator;
+    }
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -12,12 +175,26 @@ namespace EntropySources
 
 DevRandom::DevRandom()
 {
-    m_fd = ::open( "/dev/random", O_RDONLY );
 }
 
 int DevRandom::generate( char* buffer, int len )
 {
-    return ::read( m_fd, buffer, len );
+    return sharedGenerator().generate( buffer, len );
+}
+
+int DevRandom::poolSize()
+{
+    return _poolSize;
+}
+
+int DevRandom::poolRemain()
+{
+    return sharedGenerator().poolRemain();
+}
+
+void DevRandom::setKernelRandom( bool ( *kernelRandom )( char* buffer, int len ) )
+{
+    _kernelRandom = kernelRandom;
 }
 
 void DevRandom::run()
@@ -9,6 +9,9 @@ namespace Agape
 namespace EntropySources
 {
 
+/// Kernel-seeded entropy source. Rather than making a syscall per request,
+/// all instances draw from one shared, thread-safe AES-CTR generator which
+/// is seeded from getrandom() and reseeded periodically.
 class DevRandom : public EntropySource
 {
 public:
@@ -16,10 +19,14 @@ public:
 
     virtual int generate( char* buffer, int len );
 
+    virtual int poolSize();
+    virtual int poolRemain();
+
     virtual void run();
 
-private:
-    int m_fd;
+    // Replaces the kernel as the source of seeds, e.g. to count how often
+    // it's read. Call before any DevRandom is used.
+    static void setKernelRandom( bool ( *kernelRandom )( char* buffer, int len ) );
 };
 
 } // namespace EntropySources
@@ -0,0 +1,69 @@
+#ifdef DEV_RANDOM_TEST
+
+#include "EntropySources/DevRandom.h"
+
+#include <iostream>
+#include <set>
+#include <string>
+
+#include <string.h>
+
+using namespace Agape;
+
+namespace
+{
+    const int _requests( 100000 );
+    const int _requestSize( 16 ); // A key's worth, as KeyUtilities asks.
+    const int _reseedInterval( 1024 * 1024 ); // As DevRandom.
+
+    int _kernelReads( 0 );
+
+    // Counts reads rather than making them, with a different seed each time.
+    bool countingKernelRandom( char* buffer, int len )
+    {
+        ++_kernelReads;
+        ::memset( buffer, 0, len );
+        ::memcpy( buffer, &_kernelReads, sizeof( _kernelReads ) );
+        return true;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    EntropySources::DevRandom::setKernelRandom( countingKernelRandom );
+    EntropySources::DevRandom devRandom;
+
+    int refills( 0 );
+    int remain( 0 );
+    bool produced( true );
+    std::set< std::string > seen;
+    for( int i( 0 ); i < _requests; ++i )
+    {
+        char buffer[_requestSize];
+        produced = ( devRandom.generate( buffer, _requestSize ) == _requestSize ) && produced;
+        seen.insert( std::string( buffer, _requestSize ) );
+
+        // The pool only grows when it's refilled.
+        if( devRandom.poolRemain() > remain ) ++refills;
+        remain = devRandom.poolRemain();
+    }
+
+    long long total( (long long)_requests * _requestSize );
+    int expectedRefills( ( total + devRandom.poolSize() - 1 ) / devRandom.poolSize() );
+    int expectedReads( ( total + _reseedInterval - 1 ) / _reseedInterval );
+    std::cout << _requests << " requests of " << _requestSize << " bytes: " << refills << " refills, "
+              << _kernelReads << " kernel reads" << std::endl;
+
+    bool buffered( produced && ( refills == expectedRefills ) && ( _kernelReads == expectedReads ) );
+    std::cout << "Refilled once per pool: " << ( buffered ? "OK" : "FAILED" ) << std::endl;
+
+    bool distinct( (int)seen.size() == _requests );
+    std::cout << "No repeats: " << ( distinct ? "OK" : "FAILED" ) << std::endl;
+
+    bool success( buffered && distinct );
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+
+    return success ? 0 : 1;
+}
+
+#endif // DEV_RANDOM_TEST
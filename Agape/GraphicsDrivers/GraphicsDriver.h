@@ -45,6 +45,12 @@ public:
     virtual int glyphHeight() = 0;
     virtual int glyphWidth() = 0;
 
+    /// Moves what's painted in rows from to from + len - 1 of the window up
+    /// one row (or down one row if not down), leaving the row exposed as it
+    /// was for the caller to paint. Returns false if the driver can't, in
+    /// which case the caller must repaint the whole region itself.
+    virtual bool scrollRegion( const String& windowName, int from, int len, bool down ) { return false; };
+
     virtual const Window* createWindow( const Window& window );
     virtual void setWindowVisible( const String& windowName, bool visible );
     virtual bool findWindow( const String& windowName, const Window*& window ) const;
@@ -28,6 +28,11 @@ void Headless::paintBitmap( const String& windowName, int row, int col, int yOff
 {
 }
 
+bool Headless::scrollRegion( const String& windowName, int from, int len, bool down )
+{
+    return true;
+}
+
 int Headless::glyphHeight()
 {
     return 16;
@@ -20,6 +20,8 @@ public:
     virtual void paintGlyph( const String& windowName, int row, int col, char* glyphAttr, bool transparency = false, char charset = 0 );
     virtual void paintBitmap( const String& windowName, int row, int col, int yOffset, int height, int width, char* rgbBuf );
 
+    virtual bool scrollRegion( const String& windowName, int from, int len, bool down );
+
     virtual int glyphHeight();
     virtual int glyphWidth();
 };
@@ -322,6 +322,39 @@ void QtWind::paintGlyph( const String& windowName, int row, int col, char* glyph
     }
 }
 
+bool QtWind::scrollRegion( const String& windowName, int from, int len, bool down )
+{
+    const Window* thisWindow;
+    bool foundThis( findWindow( windowName, thisWindow ) );
+
+    if( !foundThis || !thisWindow->m_visible ) return false;
+
+    Rectangle scrollRect( thisWindow->m_rect.originX(),
+                          thisWindow->m_rect.originY() + ( _glyphHeight * from ),
+                          _glyphHeight * len,
+                          thisWindow->m_rect.width() );
+    Rectangle clipRect( scrollRect.clipTo( m_screenRect ) );
+
+    // Only move pixels that are all ours, or we'd drag along those of any
+    // window over this one, or leave rows off screen unpainted.
+    if( ( clipRect.height() != scrollRect.height() ) ||
+        ( clipRect.width() != scrollRect.width() ) ||
+        !isWindowTopmostVisible( scrollRect, windowName ) )
+    {
+        return false;
+    }
+
+    m_pixmap.scroll( 0,
+                     down ? -_glyphHeight : _glyphHeight,
+                     QRect( scrollRect.originX(),
+                            scrollRect.originY(),
+                            scrollRect.width(),
+                            scrollRect.height() ) );
+    this->update();
+
+    return true;
+}
+
 void QtWind::paintBitmap( const String& windowName, int row, int col, int yOffset, int height, int width, char* rgbBuf )
 {
     const Window* thisWindow;
@@ -18,4 +18,9 @@ void InputDevice::setPeekEnabled( bool enabled )
     m_peekEnabled = enabled;
 }
 
+bool InputDevice::ready()
+{
+    return !eof();
+}
+
 } // namespace Agape
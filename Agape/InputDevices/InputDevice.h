@@ -28,6 +28,8 @@ public:
     void setPeekEnabled( bool enabled );
     virtual char get() = 0;
 
+    virtual bool ready();
+
 protected:
     bool m_peekEnabled;
 };
@@ -40,6 +40,9 @@ public:
     virtual void dataTerminalReady( bool ready ) {};
 
     virtual void run() {};
+
+    // Whether bytes are waiting to be read.
+    virtual bool ready() { return false; };
 };
 
 } // namespace Agape
@@ -29,6 +29,11 @@ bool QtWebSockets::isSecure()
     return( QUrl( m_number.c_str() ).scheme() == "wss" );
 }
 
+bool QtWebSockets::ready()
+{
+    return( m_webSocketsConnection && m_webSocketsConnection->haveIncoming() );
+}
+
 int QtWebSockets::read( char* data, int len )
 {
     if( m_webSocketsConnection )
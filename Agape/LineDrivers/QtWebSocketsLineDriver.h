@@ -23,6 +23,7 @@ public:
     virtual int open();
     virtual bool isSecure();
 
+    virtual bool ready();
     virtual int read( char* data, int len );
     virtual int write( const char* data, int len );
     virtual bool error();
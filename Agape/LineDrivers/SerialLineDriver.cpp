@@ -6,6 +6,7 @@
 #include <fcntl.h>
 #include <termios.h>
 #include <iostream>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
 namespace Agape
@@ -73,6 +74,12 @@ int Serial::open()
     return 0;
 }
 
+bool Serial::ready()
+{
+    int waiting( 0 );
+    return( m_isOpen && ( ::ioctl( m_port, FIONREAD, &waiting ) == 0 ) && ( waiting > 0 ) );
+}
+
 int Serial::read( char* data, int len )
 {
     if( m_isOpen )
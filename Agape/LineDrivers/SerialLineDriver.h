@@ -17,6 +17,7 @@ public:
     Serial( const String& device, int baudRate );
 
     virtual int open();
+    virtual bool ready();
     virtual int read( char* data, int len );
     virtual int write( const char* data, int len );
 
@@ -20,6 +20,11 @@ void Line::run()
     m_lineDriver.run();
 }
 
+bool Line::ready()
+{
+    return m_lineDriver.ready();
+}
+
 int Line::read( char* data, int len )
 {
     return m_lineDriver.read( data, len );
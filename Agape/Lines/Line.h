@@ -73,6 +73,7 @@ public:
 
     virtual void open();
     virtual void run();
+    virtual bool ready();
     virtual int read( char* data, int len );
     virtual int write( const char* data, int len );
     virtual bool error();
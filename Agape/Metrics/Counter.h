@@ -0,0 +1,29 @@
+#ifndef AGAPE_METRICS_COUNTER_H
+#define AGAPE_METRICS_COUNTER_H
+
+#include <atomic>
+
+namespace Agape
+{
+
+namespace Metrics
+{
+
+/// @brief A count that only goes up, e.g. connections failed.
+class Counter
+{
+public:
+    Counter() : m_value( 0 ) {}
+
+    void increment( long n = 1 ) { m_value.fetch_add( n, std::memory_order_relaxed ); }
+    long value() const { return m_value.load( std::memory_order_relaxed ); }
+
+private:
+    std::atomic< long > m_value;
+};
+
+} // namespace Metrics
+
+} // namespace Agape
+
+#endif // AGAPE_METRICS_COUNTER_H
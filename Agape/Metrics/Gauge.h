@@ -0,0 +1,30 @@
+#ifndef AGAPE_METRICS_GAUGE_H
+#define AGAPE_METRICS_GAUGE_H
+
+#include <atomic>
+
+namespace Agape
+{
+
+namespace Metrics
+{
+
+/// @brief A level that goes up and down, e.g. connections open.
+class Gauge
+{
+public:
+    Gauge() : m_value( 0 ) {}
+
+    void set( long value ) { m_value.store( value, std::memory_order_relaxed ); }
+    void add( long n ) { m_value.fetch_add( n, std::memory_order_relaxed ); }
+    long value() const { return m_value.load( std::memory_order_relaxed ); }
+
+private:
+    std::atomic< long > m_value;
+};
+
+} // namespace Metrics
+
+} // namespace Agape
+
+#endif // AGAPE_METRICS_GAUGE_H
@@ -0,0 +1,125 @@
+#include "Histogram.h"
+
+#include <atomic>
+
+namespace
+{
+    const int _exactBuckets( 16 );
+    const int _subBuckets( 8 ); // Per power of two above _exactBuckets.
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Metrics
+{
+
+Histogram::Histogram() :
+  m_sum( 0 ),
+  m_max( 0 )
+{
+    for( int i( 0 ); i < numBuckets; ++i )
+    {
+        m_buckets[i].store( 0, std::memory_order_relaxed );
+    }
+}
+
+void Histogram::record( long us )
+{
+    if( us < 0 ) us = 0;
+
+    m_buckets[bucket( us )].fetch_add( 1, std::memory_order_relaxed );
+    m_sum.fetch_add( us, std::memory_order_relaxed );
+
+    long max( m_max.load( std::memory_order_relaxed ) );
+    while( ( us > max ) && !m_max.compare_exchange_weak( max, us, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+long Histogram::count() const
+{
+    // Kept only in the buckets, to save recording another atomic.
+    long count( 0 );
+    for( int i( 0 ); i < numBuckets; ++i )
+    {
+        count += m_buckets[i].load( std::memory_order_relaxed );
+    }
+    return count;
+}
+
+long Histogram::mean() const
+{
+    long count( this->count() );
+    return count ? ( m_sum.load( std::memory_order_relaxed ) / count ) : 0;
+}
+
+long Histogram::max() const
+{
+    return m_max.load( std::memory_order_relaxed );
+}
+
+long Histogram::percentile( double fraction ) const
+{
+    // Buckets are read one at a time while others may be recording, so work
+    // from this copy.
+    long counts[numBuckets];
+    long total( 0 );
+    for( int i( 0 ); i < numBuckets; ++i )
+    {
+        counts[i] = m_buckets[i].load( std::memory_order_relaxed );
+        total += counts[i];
+    }
+
+    if( total == 0 )
+    {
+        return 0;
+    }
+
+    long target( (long)( fraction * total + 0.5 ) );
+    if( target < 1 ) target = 1;
+
+    long seen( 0 );
+    for( int i( 0 ); i < numBuckets; ++i )
+    {
+        seen += counts[i];
+        if( seen >= target )
+        {
+            long top( bucketTop( i ) );
+            long max( m_max.load( std::memory_order_relaxed ) );
+            return ( top < max ) ? top : max;
+        }
+    }
+
+    return max();
+}
+
+int Histogram::bucket( long us )
+{
+    if( us < _exactBuckets )
+    {
+        return us;
+    }
+
+    int msb( 63 - __builtin_clzl( (unsigned long)us ) );
+    int shift( msb - 3 ); // Leaves us >> shift in [_subBuckets, 2 * _subBuckets).
+    int index( _exactBuckets + ( ( shift - 1 ) * _subBuckets ) + (int)( ( us >> shift ) - _subBuckets ) );
+
+    return ( index < numBuckets ) ? index : ( numBuckets - 1 );
+}
+
+long Histogram::bucketTop( int bucket )
+{
+    if( bucket < _exactBuckets )
+    {
+        return bucket;
+    }
+
+    int shift( ( ( bucket - _exactBuckets ) / _subBuckets ) + 1 );
+    long mantissa( ( ( bucket - _exactBuckets ) % _subBuckets ) + _subBuckets );
+    return ( ( mantissa + 1 ) << shift ) - 1;
+}
+
+} // namespace Metrics
+
+} // namespace Agape
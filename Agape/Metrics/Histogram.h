@@ -0,0 +1,46 @@
+#ifndef AGAPE_METRICS_HISTOGRAM_H
+#define AGAPE_METRICS_HISTOGRAM_H
+
+#include <atomic>
+
+namespace Agape
+{
+
+namespace Metrics
+{
+
+/// @brief Counts of durations in microseconds. As in HDR histograms, buckets
+/// are exact below 16us and an eighth of their value wide above that, so
+/// percentiles stay meaningful from microseconds to days in a fixed size.
+/// Recording takes no lock.
+class Histogram
+{
+public:
+    static const int numBuckets = 336;
+
+    Histogram();
+
+    void record( long us );
+
+    long count() const;
+    long mean() const;
+    long max() const;
+
+    // The value below which the given fraction (e.g. 0.99) of durations fall,
+    // to within the width of its bucket.
+    long percentile( double fraction ) const;
+
+private:
+    static int bucket( long us );
+    static long bucketTop( int bucket );
+
+    std::atomic< long > m_buckets[numBuckets];
+    std::atomic< long > m_sum;
+    std::atomic< long > m_max;
+};
+
+} // namespace Metrics
+
+} // namespace Agape
+
+#endif // AGAPE_METRICS_HISTOGRAM_H
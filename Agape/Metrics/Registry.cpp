@@ -0,0 +1,127 @@
+#include "Metrics/Counter.h"
+#include "Metrics/Gauge.h"
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+#include "Utils/LiteStream.h"
+#include "Collections.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Value.h"
+
+#include <mutex>
+
+namespace Agape
+{
+
+namespace Metrics
+{
+
+Registry::Registry()
+{
+}
+
+Registry& Registry::getInstance()
+{
+    static Registry s_instance;
+    return s_instance;
+}
+
+Counter& Registry::counter( const String& name )
+{
+    std::scoped_lock lock( m_mutex );
+
+    Counter*& counter( m_counters[name] );
+    if( !counter )
+    {
+        counter = new Counter;
+    }
+
+    return *counter;
+}
+
+Gauge& Registry::gauge( const String& name )
+{
+    std::scoped_lock lock( m_mutex );
+
+    Gauge*& gauge( m_gauges[name] );
+    if( !gauge )
+    {
+        gauge = new Gauge;
+    }
+
+    return *gauge;
+}
+
+Histogram& Registry::histogram( const String& name )
+{
+    std::scoped_lock lock( m_mutex );
+
+    Histogram*& histogram( m_histograms[name] );
+    if( !histogram )
+    {
+        histogram = new Histogram;
+    }
+
+    return *histogram;
+}
+
+void Registry::toValue( Value& value )
+{
+    std::scoped_lock lock( m_mutex );
+
+    for( Map< String, Counter* >::const_iterator it( m_counters.begin() ); it != m_counters.end(); ++it )
+    {
+        value[it->first] = (double)it->second->value();
+    }
+
+    for( Map< String, Gauge* >::const_iterator it( m_gauges.begin() ); it != m_gauges.end(); ++it )
+    {
+        value[it->first] = (double)it->second->value();
+    }
+
+    for( Map< String, Histogram* >::const_iterator it( m_histograms.begin() ); it != m_histograms.end(); ++it )
+    {
+        Value& histogramValue( value[it->first] );
+        histogramValue[_count] = (double)it->second->count();
+        histogramValue[_mean] = (double)it->second->mean();
+        histogramValue[_p50] = (double)it->second->percentile( 0.5 );
+        histogramValue[_p90] = (double)it->second->percentile( 0.9 );
+        histogramValue[_p99] = (double)it->second->percentile( 0.99 );
+        histogramValue[_max] = (double)it->second->max();
+    }
+}
+
+String Registry::dump()
+{
+    std::scoped_lock lock( m_mutex );
+
+    LiteStream stream;
+
+    for( Map< String, Counter* >::const_iterator it( m_counters.begin() ); it != m_counters.end(); ++it )
+    {
+        stream << it->first << " " << it->second->value() << "\n";
+    }
+
+    for( Map< String, Gauge* >::const_iterator it( m_gauges.begin() ); it != m_gauges.end(); ++it )
+    {
+        stream << it->first << " " << it->second->value() << "\n";
+    }
+
+    for( Map< String, Histogram* >::const_iterator it( m_histograms.begin() ); it != m_histograms.end(); ++it )
+    {
+        stream << it->first
+               << " count " << it->second->count()
+               << " mean " << it->second->mean()
+               << " p50 " << it->second->percentile( 0.5 )
+               << " p90 " << it->second->percentile( 0.9 )
+               << " p99 " << it->second->percentile( 0.99 )
+               << " max " << it->second->max()
+               << " us\n";
+    }
+
+    return stream.str();
+}
+
+} // namespace Metrics
+
+} // namespace Agape
@@ -0,0 +1,55 @@
+#ifndef AGAPE_METRICS_REGISTRY_H
+#define AGAPE_METRICS_REGISTRY_H
+
+#include "Collections.h"
+#include "String.h"
+
+#include <mutex>
+
+namespace Agape
+{
+
+class Value;
+
+namespace Metrics
+{
+
+class Counter;
+class Gauge;
+class Histogram;
+
+/// @brief The process's metrics, by name. Looking one up takes a lock, so
+/// callers keep the reference; updating it doesn't. Metrics live as long as
+/// the process.
+class Registry
+{
+public:
+    static Registry& getInstance();
+
+    Counter& counter( const String& name );
+    Gauge& gauge( const String& name );
+    Histogram& histogram( const String& name );
+
+    // Counters and gauges as numbers, histograms (in us) as maps of
+    // count, mean, p50, p90, p99 and max.
+    void toValue( Value& value );
+
+    // One metric per line: counters, gauges and then histograms, each sorted
+    // by name.
+    String dump();
+
+private:
+    Registry();
+
+    Map< String, Counter* > m_counters;
+    Map< String, Gauge* > m_gauges;
+    Map< String, Histogram* > m_histograms;
+
+    std::mutex m_mutex;
+};
+
+} // namespace Metrics
+
+} // namespace Agape
+
+#endif // AGAPE_METRICS_REGISTRY_H
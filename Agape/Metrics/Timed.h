@@ -0,0 +1,44 @@
+#ifndef AGAPE_METRICS_TIMED_H
+#define AGAPE_METRICS_TIMED_H
+
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+
+#include <chrono>
+
+// Records how long the rest of the enclosing scope takes in the named
+// histogram, which is looked up only the first time through.
+#define METRICS_TIMED( name ) \
+    static Agape::Metrics::Histogram& _metricsHistogram( Agape::Metrics::Registry::getInstance().histogram( name ) ); \
+    Agape::Metrics::Timed _metricsTimed( _metricsHistogram )
+
+namespace Agape
+{
+
+namespace Metrics
+{
+
+// Microseconds from a monotonic clock, for timing.
+inline long long nowus()
+{
+    return std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+/// @brief Records its own lifetime in a histogram.
+class Timed
+{
+public:
+    Timed( Histogram& histogram ) : m_histogram( histogram ), m_startus( nowus() ) {}
+    ~Timed() { m_histogram.record( nowus() - m_startus ); }
+
+private:
+    Histogram& m_histogram;
+    long long m_startus;
+};
+
+} // namespace Metrics
+
+} // namespace Agape
+
+#endif // AGAPE_METRICS_TIMED_H
@@ -1,5 +1,4 @@
-#include "Timers/Factories/TimerFactory.h"
-#include "Timers/Timer.h"
+#include "Clocks/DisciplinedClock.h"
 #include "EventTimerActor.h"
 #include "String.h"
 #include "StringConstants.h"
@@ -8,8 +7,7 @@
 
 namespace
 {
-    static int tickPeriod( 100 );
-    static int clockPeriod( 1000 );
+    const unsigned long long tickPeriod( 100 );
 } // Anonymous namespace
 
 namespace Agape
@@ -24,20 +22,21 @@ namespace Actors
 namespace NativeActors
 {
 
-EventTimer::EventTimer( Timers::Factory& timerFactory, TupleRouter& tupleRouter ) :
+EventTimer::EventTimer( Timers::Wheel& timerWheel, Clocks::Disciplined& clock, TupleRouter& tupleRouter ) :
   Native( _Timer ),
+  m_timerWheel( timerWheel ),
+  m_clock( clock ),
   m_tupleRouter( tupleRouter ),
-  m_timer( timerFactory.makeTimer() ),
-  m_lastS( 0 ),
-  m_lastMs( 0 )
+  m_ticking( false ),
+  m_lastTickMS( 0 )
 {
     m_tupleRouter.registerActor( this );
 }
 
 EventTimer::~EventTimer()
 {
+    m_timerWheel.cancel( this );
     m_tupleRouter.deregisterActor( this );
-    delete( m_timer );
 }
 
 bool EventTimer::accept( Tuple& tuple )
@@ -45,10 +44,12 @@ bool EventTimer::accept( Tuple& tuple )
     if( ( m_tupleRouter.sourceActor( tuple ) == _Clock ) &&
         ( m_tupleRouter.tupleType( tuple ) == _Time ) )
     {
-        m_timer->reset();
-        m_lastS = tuple[_now];
-        m_lastMs = 0;
-        sendTuple();
+        // The clock is set by VRTime, which sees the tuple first. We only
+        // need to start ticking.
+        if( !m_ticking )
+        {
+            due();
+        }
 
         return true;
     }
@@ -56,28 +57,37 @@ bool EventTimer::accept( Tuple& tuple )
     return false;
 }
 
-void EventTimer::run()
+void EventTimer::due()
 {
-    long currentMs( m_timer->ms() );
-
-    if( ( m_lastS != 0 ) &&
-        ( ( currentMs - m_lastMs ) >= tickPeriod ) &&
-        ( currentMs < clockPeriod ) &&
-        ( ( currentMs - m_lastMs ) <= ( clockPeriod - ( tickPeriod / 2 ) ) ) )
+    m_ticking = m_clock.synchronised();
+    if( !m_ticking ) return;
+
+    // Tick on the nearest tickPeriod, as the wheel's timer isn't corrected
+    // for drift and may run us a little early, skipping any we've already
+    // sent or missed (if the clock has stepped).
+    unsigned long long nowMS( m_clock.epochMS() );
+    unsigned long long tickMS( ( ( nowMS + ( tickPeriod / 2 ) ) / tickPeriod ) * tickPeriod );
+    if( ( tickMS + tickPeriod ) < m_lastTickMS )
+    {
+        m_lastTickMS = 0; // The clock has stepped back, so start again.
+    }
+    if( tickMS > m_lastTickMS )
     {
-        m_lastMs += tickPeriod;
-        sendTuple();
+        m_lastTickMS = tickMS;
+        sendTuple( tickMS );
     }
+
+    m_timerWheel.schedule( this, (long)( m_lastTickMS + tickPeriod - nowMS ) );
 }
 
-void EventTimer::sendTuple()
+void EventTimer::sendTuple( unsigned long long nowMS )
 {
     Tuple tuple;
     TupleRouter::setSourceActor( tuple, _Timer );
     TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
     TupleRouter::setDestinationID( tuple, m_tupleRouter.myID() );
     TupleRouter::setTupleType( tuple, _Tick );
-    tuple[_now] = ( m_lastS * 1000 ) + m_lastMs;
+    tuple[_now] = (double)nowMS;
 
     m_tupleRouter.route( tuple );
 }
@@ -2,17 +2,15 @@
 #define AGAPE_LINDA2_ACTORS_NATIVE_ACTORS_EVENT_TIMER_H
 
 #include "Actors/NativeActors/NativeActor.h"
-#include "Runnable.h"
+#include "Timers/TimerWheel.h"
 
 namespace Agape
 {
 
-namespace Timers
+namespace Clocks
 {
-class Factory;
-} // namespace Timers
-
-class Timer;
+class Disciplined;
+} // namespace Clocks
 
 namespace Linda2
 {
@@ -26,25 +24,27 @@ namespace Actors
 namespace NativeActors
 {
 
-class EventTimer : public Actors::Native, public Runnable
+// Sends a Tick every tickPeriod ms of our clock, once it has been set by a
+// Time tuple, scheduled on the timer wheel rather than polled for.
+class EventTimer : public Actors::Native, public Timers::Wheel::Task
 {
 public:
-    EventTimer( Timers::Factory& timerFactory, TupleRouter& tupleRouter );
+    EventTimer( Timers::Wheel& timerWheel, Clocks::Disciplined& clock, TupleRouter& tupleRouter );
     virtual ~EventTimer();
 
     virtual bool accept( Tuple& tuple );
 
-    virtual void run();
+    virtual void due();
 
 private:
-    void sendTuple();
+    void sendTuple( unsigned long long nowMS );
 
+    Timers::Wheel& m_timerWheel;
+    Clocks::Disciplined& m_clock;
     TupleRouter& m_tupleRouter;
 
-    Timer* m_timer;
-
-    double m_lastS;
-    double m_lastMs;
+    bool m_ticking;
+    unsigned long long m_lastTickMS;
 };
 
 } // namespace NativeActors
@@ -145,6 +145,13 @@ bool Thing::getPersistableValue( Value& value,
     return success;
 }
 
+void Thing::flushPersistableValues()
+{
+    // Writes to "this.x" are merged until the handler that made them is done,
+    // then saved in a single request.
+    m_compositor.flushSceneItemAttributes();
+}
+
 } // namespace NativeActors
 
 } // namespace Actors
@@ -50,6 +50,8 @@ public:
                                       const String& name,
                                       const String& caller );
 
+    virtual void flushPersistableValues();
+
 private:
     TupleRouter& m_tupleRouter;
     FunctionDispatcher& m_functionDispatcher;
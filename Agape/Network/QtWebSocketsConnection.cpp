@@ -115,6 +115,11 @@ bool QtWebSocketsConnection::isOpen()
     return m_isOpen;
 }
 
+bool QtWebSocketsConnection::haveIncoming() const
+{
+    return( !m_buffer.isEmpty() || !m_overflow.isEmpty() );
+}
+
 int QtWebSocketsConnection::read( char* data, int len )
 {
     if( !m_isOpen || m_error )
@@ -126,6 +131,8 @@ int QtWebSocketsConnection::read( char* data, int len )
         return 0;
     }
 
+    refill();
+
     int bufferSize( m_buffer.size() );
 
     if( bufferSize < len )
@@ -150,11 +157,8 @@ int QtWebSocketsConnection::read( char* data, int len )
         bufferSize = m_buffer.size();
     }
 
-    int numToRead( len > bufferSize ? bufferSize : len );
-    for( int i = 0; i < numToRead; ++i )
-    {
-        data[i] = m_buffer.pop();
-    }
+    int numToRead( m_buffer.pop( data, len ) );
+    refill();
 
     return numToRead;
 }
@@ -266,11 +270,18 @@ void QtWebSocketsConnection::onBinaryMessageReceived( const QByteArray& message
     }
 #endif
 
-    int bufferFree( m_buffer.free() );
-    int numToBuffer( bufferFree < message.length() ? bufferFree : message.length() );
-    for( int i = 0; i < numToBuffer; ++i )
+    if( m_overflow.isEmpty() )
     {
-        m_buffer.push( message[i] );
+        int numBuffered( m_buffer.push( message.constData(), message.length() ) );
+        if( numBuffered < message.length() )
+        {
+            LOG_DEBUG( "QtWebSocketsConnection: Buffer full. Holding until read." );
+            m_overflow = message.mid( numBuffered );
+        }
+    }
+    else
+    {
+        m_overflow.append( message );
     }
 
 #ifdef LOG_WS
@@ -278,11 +289,6 @@ void QtWebSocketsConnection::onBinaryMessageReceived( const QByteArray& message
     hexDump( message, message.length() );
 #endif
 
-    if( numToBuffer < message.length() )
-    {
-        LOG_DEBUG( "QtWebSocketsConnection: Buffer overflow. Bytes lost." );
-    }
-
 #ifdef __EMSCRIPTEN__
     if( ::strcmp( emscripten_run_script_string( "if(document.hidden) \"hidden\"" ), "hidden" ) == 0 )
     {
@@ -385,6 +391,15 @@ void QtWebSocketsConnection::sendPing()
     }
 }
 
+void QtWebSocketsConnection::refill()
+{
+    if( !m_overflow.isEmpty() )
+    {
+        int numBuffered( m_buffer.push( m_overflow.constData(), m_overflow.length() ) );
+        m_overflow.remove( 0, numBuffered );
+    }
+}
+
 void QtWebSocketsConnection::notifyConnected()
 {
     m_platform.cancelNotify( Platform::connectionError );
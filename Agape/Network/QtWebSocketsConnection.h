@@ -33,6 +33,7 @@ public:
     ~QtWebSocketsConnection();
 
     bool isOpen();
+    bool haveIncoming() const;
 
     virtual int read( char* data, int len );
     virtual int write( const char* data, int len );
@@ -56,6 +57,7 @@ public slots:
 private:
     void notifyConnected();
     void notifyDisconnected();
+    void refill();
 
     Platform& m_platform;
 
@@ -65,6 +67,7 @@ private:
     bool m_error;
 
     RingBuffer< char > m_buffer;
+    QByteArray m_overflow; // Waits here (in order) when m_buffer is full.
 
     QEventLoop m_eventLoop;
     QTimer m_timer;
@@ -10,7 +10,7 @@
 namespace Agape
 {
 
-class Platform
+class Platform : public Runnable
 {
 public:
     enum EventType
@@ -5,7 +5,7 @@
 #include "World/WorldCoordinates.h"
 #include "Linda2PresenceLoader.h"
 #include "PresenceRequest.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
@@ -18,6 +18,7 @@ using namespace Agape::World;
 namespace
 {
     const int maxUpdates( 8 );
+    const int loadRetries( 1 ); // Loads can safely be asked again.
 } // Anonymous namespace
 
 namespace Agape
@@ -34,11 +35,7 @@ Linda2::Linda2( const World::Coordinates& coordinates,
   Native( _PresenceLoader ),
   m_receiveRequests( receiveRequests ),
   m_tupleRouter( tupleRouter ),
-  m_timerFactory( timerFactory ),
-  m_isLoading( false ),
-  m_currentItem( 0 ),
-  m_totalItems( -1 ),
-  m_presences( nullptr ),
+  m_requester( tupleRouter, timerFactory, this ),
   m_overflowed( false )
 {
     LOG_DEBUG( "Linda2PresenceLoader: Created" );
@@ -68,60 +65,18 @@ Linda2::~Linda2()
 
 bool Linda2::load( Vector< World::ScenePresence >& scenePresences )
 {
-    bool success( true );
-
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _PresenceLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _PresenceLoadRequest );
-    m_coordinates.toValue( tuple[_coordinates] );
-
-    scenePresences.clear();
-    m_isLoading = true;
-    m_currentItem = 0;
-    m_totalItems = -1;
-
-    m_presences = &scenePresences;
-
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2PresenceLoader: Sending PresenceLoadRequest" );
 #endif
-    m_presenceLoadResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    success = m_tupleRouter.route( tuple );
-    if( success ) success = m_presenceLoadResponse.getFuture().get();
-    m_isLoading = false;
-    m_presences = nullptr;
-
-    return success;
+    return loadPresences( _PresenceLoadRequest, _PresenceLoadResponse, _PresenceSummary, scenePresences );
 }
 
 bool Linda2::loadWorld( Vector< ScenePresence >& worldPresences )
 {
-    bool success( true );
-
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _PresenceLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _PresenceLoadWorldRequest );
-    m_coordinates.toValue( tuple[_coordinates] );
-
-    worldPresences.clear();
-    m_isLoading = true;
-    m_currentItem = 0;
-    m_totalItems = -1;
-
-    m_presences = &worldPresences;
-
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2PresenceLoader: Sending PresenceLoadWorldRequest" );
 #endif
-    m_presenceLoadWorldResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    success = m_tupleRouter.route( tuple );
-    if( success ) success = m_presenceLoadWorldResponse.getFuture().get();
-    m_isLoading = false;
-    m_presences = nullptr;
-
-    return success;
+    return loadPresences( _PresenceLoadWorldRequest, _PresenceLoadWorldResponse, _PresenceLoadWorldSummary, worldPresences );
 }
 
 bool Linda2::request( const Vector< PresenceRequest >& requests )
@@ -167,85 +122,53 @@ bool Linda2::accept( Tuple& tuple )
 {
     bool handled( false );
 
-    if( ( TupleRouter::tupleType( tuple ) == _PresenceSummary ) && m_isLoading )
+    if( m_receiveRequests && ( TupleRouter::tupleType( tuple ) == _PresenceResponse ) )
     {
 #ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2PresenceLoader: Received presence summary" );
+        LOG_DEBUG( "Linda2PresenceLoader: Received presence response" );
 #endif
-        m_totalItems = tuple[_totalItems];
-
-        if( m_currentItem == m_totalItems )
+        if( m_updates.size() < maxUpdates )
         {
-            m_presenceLoadResponse.set();
+            PresenceRequest request( PresenceRequest::fromTuple( tuple ) );
+            m_updates.push_back( request );
         }
-
-        handled = true;
-    }
-    else if( ( TupleRouter::tupleType( tuple ) == _PresenceLoadResponse ) && m_isLoading && m_presences )
-    {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2PresenceLoader: Received presence item" );
-#endif
-        ScenePresence presence( ScenePresence::fromValue( tuple[_scenePresence] ) );
-        m_presences->push_back( presence );
-        ++m_currentItem;
-
-        if( m_currentItem == m_totalItems )
+        else
         {
-            m_presenceLoadResponse.set();
+            LOG_DEBUG( "Linda2PresenceLoader: Overflow." );
         }
 
         handled = true;
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _PresenceLoadWorldSummary ) && m_isLoading )
-    {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2PresenceLoader: Received presence load world summary" );
-#endif
-        m_totalItems = tuple[_totalItems];
 
-        if( m_currentItem == m_totalItems )
-        {
-            m_presenceLoadWorldResponse.set();
-        }
+    return( m_requester.accept( tuple ) || handled );
+}
 
-        handled = true;
-    }
-    else if( ( TupleRouter::tupleType( tuple ) == _PresenceLoadWorldResponse ) && m_isLoading && m_presences )
-    {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2PresenceLoader: Received presence load world item" );
-#endif
-        ScenePresence presence( ScenePresence::fromValue( tuple[_scenePresence] ) );
-        m_presences->push_back( presence );
-        ++m_currentItem;
+bool Linda2::loadPresences( const String& requestType,
+                            const String& responseType,
+                            const String& summaryType,
+                            Vector< ScenePresence >& presences )
+{
+    presences.clear();
 
-        if( m_currentItem == m_totalItems )
-        {
-            m_presenceLoadWorldResponse.set();
-        }
+    Tuple tuple;
+    TupleRouter::setSourceActor( tuple, _PresenceLoader );
+    TupleRouter::setTupleType( tuple, requestType );
+    m_coordinates.toValue( tuple[_coordinates] );
 
-        handled = true;
-    }
-    else if( m_receiveRequests && ( TupleRouter::tupleType( tuple ) == _PresenceResponse ) )
+    Tuple summary;
+    Vector< Tuple > items;
+    if( !m_requester.call( tuple, responseType, summaryType, summary, items, loadRetries ) )
     {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2PresenceLoader: Received presence response" );
-#endif
-        if( m_updates.size() < maxUpdates )
-        {
-            PresenceRequest request( PresenceRequest::fromTuple( tuple ) );
-            m_updates.push_back( request );
-        }
-        else
-        {
-            LOG_DEBUG( "Linda2PresenceLoader: Overflow." );
-        }
+        return false;
+    }
 
-        handled = true;
+    Vector< Tuple >::const_iterator it( items.begin() );
+    for( ; it != items.end(); ++it )
+    {
+        presences.push_back( ScenePresence::fromValue( (*it)[_scenePresence] ) );
     }
 
-    return handled;
+    return true;
 }
 
 } // namespace AssetLoaders
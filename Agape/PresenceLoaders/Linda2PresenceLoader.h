@@ -6,7 +6,7 @@
 #include "Collections.h"
 #include "PresenceLoader.h"
 #include "PresenceRequest.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "TupleRoutingCriteria.h"
 
 using namespace Agape::Linda2;
@@ -55,21 +55,18 @@ public:
     virtual bool accept( Tuple& tuple );
 
 private:
+    bool loadPresences( const String& requestType,
+                        const String& responseType,
+                        const String& summaryType,
+                        Vector< ScenePresence >& presences );
+
     bool m_receiveRequests;
     TupleRouter& m_tupleRouter;
-    Timers::Factory& m_timerFactory;
-
-    bool m_isLoading;
-    int m_currentItem;
-    int m_totalItems;
 
-    Promise m_presenceLoadResponse;
-    Promise m_presenceLoadWorldResponse;
+    Requester m_requester;
 
     TupleRoutingCriteria m_tupleRoutingCriteria;
 
-    Vector< ScenePresence >* m_presences;
-
     Vector< PresenceRequest > m_updates;
 
     bool m_overflowed;
@@ -9,6 +9,7 @@
 #include "Collections.h"
 #include "PresenceRequest.h"
 #include "Promise.h"
+#include "Reply.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
@@ -110,13 +111,8 @@ void Linda2Responder::loadPresences( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2PresenceLoaderResponder: Sending PresenceSummary" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _PresenceLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _PresenceSummary );
-    response[_totalItems] = (int)presences.size();
-    m_tupleRouter.route( response );
+    Reply reply( m_tupleRouter, tuple, _PresenceLoaderResponder );
+    reply.sendSummary( _PresenceSummary, (int)presences.size(), true );
 
     Vector< ScenePresence >::const_iterator it( presences.begin() );
     for( ; it != presences.end(); ++it )
@@ -124,13 +120,9 @@ void Linda2Responder::loadPresences( const Tuple& tuple )
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2PresenceLoaderResponder: Sending PresenceLoadResponse" );
 #endif
-        Tuple presenceTuple;
-        TupleRouter::setSourceActor( presenceTuple, _PresenceLoaderResponder );
-        TupleRouter::setSourceID( presenceTuple, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( presenceTuple, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( presenceTuple, _PresenceLoadResponse );
+        Tuple presenceTuple( reply.tuple( _PresenceLoadResponse ) );
         it->toValue( presenceTuple[_scenePresence] );
-        m_tupleRouter.route( presenceTuple );
+        reply.send( presenceTuple );
     }
 }
 
@@ -153,13 +145,8 @@ void Linda2Responder::loadWorldPresences( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2PresenceLoaderResponder: Sending PresenceLoadWorldSummary" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _PresenceLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _PresenceLoadWorldSummary );
-    response[_totalItems] = (int)presences.size();
-    m_tupleRouter.route( response );
+    Reply reply( m_tupleRouter, tuple, _PresenceLoaderResponder );
+    reply.sendSummary( _PresenceLoadWorldSummary, (int)presences.size(), true );
 
     Vector< ScenePresence >::const_iterator it( presences.begin() );
     for( ; it != presences.end(); ++it )
@@ -167,13 +154,9 @@ void Linda2Responder::loadWorldPresences( const Tuple& tuple )
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2PresenceLoaderResponder: Sending PresenceLoadWorldResponse" );
 #endif
-        Tuple presenceTuple;
-        TupleRouter::setSourceActor( presenceTuple, _PresenceLoaderResponder );
-        TupleRouter::setSourceID( presenceTuple, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( presenceTuple, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( presenceTuple, _PresenceLoadWorldResponse );
+        Tuple presenceTuple( reply.tuple( _PresenceLoadWorldResponse ) );
         it->toValue( presenceTuple[_scenePresence] );
-        m_tupleRouter.route( presenceTuple );
+        reply.send( presenceTuple );
     }
 }
 
@@ -199,15 +182,12 @@ void Linda2Responder::handleRequest( const Tuple& tuple )
     delete( presenceLoader );
 
     // FIXME: ACK/NAK?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _PresenceLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _PresenceResponse );
+    Reply reply( m_tupleRouter, tuple, _PresenceLoaderResponder );
+    Tuple response( reply.tuple( _PresenceResponse ) );
     request.m_originatorID = TupleRouter::sourceID( tuple );
     request.toTuple( response );
     request.m_coordinates.toValue( response[_coordinates] );
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 } // namespace PresenceLoaders
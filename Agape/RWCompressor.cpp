@@ -0,0 +1,307 @@
+#include "Compressors/Compressor.h"
+#include "Loggers/Logger.h"
+#include "RWCompressor.h"
+#include "String.h"
+
+#include <string.h>
+
+namespace
+{
+    const char _frameHello( (char)0xA5 );
+    const char _frameRaw( (char)0xA6 );
+    const char _frameCompressed( (char)0xA7 );
+    const int _headerSize( 3 );
+    const int _rawLengthSize( 2 ); // Compressed frames lead with the raw length.
+} // Anonymous namespace
+
+namespace Agape
+{
+
+RWCompressor::RWCompressor( Compressor& compressor,
+                            ReadableWritable& rw,
+                            bool compressOutput,
+                            bool detectPeer ) :
+  m_compressor( compressor ),
+  m_rw( rw ),
+  m_compressOutput( compressOutput ),
+  m_mode( detectPeer ? modeDetect : modeFramed ),
+  m_helloSent( false ),
+  m_peerDecodes( false ),
+  m_error( false ),
+  m_headerFill( 0 ),
+  m_payloadLength( 0 ),
+  m_payloadFill( 0 ),
+  m_readOffset( 0 ),
+  m_readLength( 0 ),
+  m_bytesIn( 0 ),
+  m_bytesInDecoded( 0 ),
+  m_bytesOut( 0 ),
+  m_bytesOutEncoded( 0 )
+{
+    int blockSize( m_compressor.maxBlockSize() );
+    m_frameBuffer = new char[_rawLengthSize + blockSize];
+    m_payload = new char[_rawLengthSize + blockSize];
+    m_readBuffer = new char[blockSize];
+}
+
+RWCompressor::~RWCompressor()
+{
+    delete[]( m_frameBuffer );
+    delete[]( m_payload );
+    delete[]( m_readBuffer );
+}
+
+int RWCompressor::read( char* data, int len )
+{
+    if( m_error )
+    {
+        return -1;
+    }
+
+    if( ( m_mode == modePassThrough ) && ( m_readOffset == m_readLength ) )
+    {
+        return m_rw.read( data, len );
+    }
+
+    while( m_readOffset == m_readLength )
+    {
+        int result( readFrame() );
+        if( result <= 0 )
+        {
+            return result;
+        }
+
+        if( m_mode == modePassThrough )
+        {
+            // First byte showed an older peer; it is waiting in the read
+            // buffer.
+            break;
+        }
+    }
+
+    int available( m_readLength - m_readOffset );
+    int count( len < available ? len : available );
+    ::memcpy( data, m_readBuffer + m_readOffset, count );
+    m_readOffset += count;
+
+    return count;
+}
+
+int RWCompressor::write( const char* data, int len )
+{
+    if( m_error )
+    {
+        return 0;
+    }
+
+    if( ( m_mode == modePassThrough ) && m_writeBuffer.empty() )
+    {
+        return m_rw.write( data, len );
+    }
+
+    m_writeBuffer.append( data, len );
+    return len;
+}
+
+bool RWCompressor::error()
+{
+    return( m_error || m_rw.error() );
+}
+
+void RWCompressor::flushOutput()
+{
+    if( m_mode == modeDetect )
+    {
+        // Hold output until we know how the peer talks.
+        return;
+    }
+
+    if( m_mode == modePassThrough )
+    {
+        // Release anything held while detecting, unframed.
+        if( !m_writeBuffer.empty() )
+        {
+            if( !writeAll( m_writeBuffer.c_str(), m_writeBuffer.length() ) )
+            {
+                m_error = true;
+            }
+            m_writeBuffer.clear();
+        }
+
+        m_rw.flushOutput();
+        return;
+    }
+
+    if( !m_helloSent )
+    {
+        char decodes( m_compressor.id() );
+        m_helloSent = true;
+        if( !writeFrame( _frameHello, &decodes, 1 ) )
+        {
+            return;
+        }
+    }
+
+    int blockSize( m_compressor.maxBlockSize() );
+    int offset( 0 );
+    int remain( m_writeBuffer.length() );
+    while( !m_error && ( remain > 0 ) )
+    {
+        int len( remain < blockSize ? remain : blockSize );
+        const char* block( m_writeBuffer.c_str() + offset );
+
+        int compressedLen( -1 );
+        if( m_compressOutput && m_peerDecodes )
+        {
+            // Only worth sending compressed if it saves more than the raw
+            // length field costs.
+            compressedLen = m_compressor.compress( block, len, m_frameBuffer + _rawLengthSize, len - _rawLengthSize - 1 );
+        }
+
+        if( compressedLen > 0 )
+        {
+            m_frameBuffer[0] = (char)( len >> 8 );
+            m_frameBuffer[1] = (char)( len & 0xFF );
+            writeFrame( _frameCompressed, m_frameBuffer, _rawLengthSize + compressedLen );
+        }
+        else
+        {
+            writeFrame( _frameRaw, block, len );
+        }
+
+        m_bytesOut += len;
+        offset += len;
+        remain -= len;
+    }
+
+    m_writeBuffer.clear();
+    m_rw.flushOutput();
+}
+
+int RWCompressor::readFrame()
+{
+    while( m_headerFill < _headerSize )
+    {
+        int got( m_rw.read( m_header + m_headerFill, _headerSize - m_headerFill ) );
+        if( got <= 0 )
+        {
+            if( got < 0 ) m_error = true;
+            return got;
+        }
+
+        if( ( m_mode == modeDetect ) && ( m_headerFill == 0 ) )
+        {
+            if( m_header[0] != _frameHello )
+            {
+                // Older peer. Hand back what we've read; held output goes
+                // out unframed on the next flush.
+                m_mode = modePassThrough;
+                ::memcpy( m_readBuffer, m_header, got );
+                m_readOffset = 0;
+                m_readLength = got;
+                return 1;
+            }
+
+            m_mode = modeFramed;
+        }
+
+        m_headerFill += got;
+    }
+
+    if( m_payloadFill == 0 )
+    {
+        m_payloadLength = ( (unsigned char)m_header[1] << 8 ) | (unsigned char)m_header[2];
+        if( m_payloadLength > ( _rawLengthSize + m_compressor.maxBlockSize() ) )
+        {
+            LOG_DEBUG( "RWCompressor: Frame too long" );
+            m_error = true;
+            return -1;
+        }
+    }
+
+    while( m_payloadFill < m_payloadLength )
+    {
+        int got( m_rw.read( m_payload + m_payloadFill, m_payloadLength - m_payloadFill ) );
+        if( got <= 0 )
+        {
+            if( got < 0 ) m_error = true;
+            return got;
+        }
+
+        m_payloadFill += got;
+    }
+
+    m_headerFill = 0;
+    m_payloadFill = 0;
+    m_readOffset = 0;
+    m_readLength = 0;
+    m_bytesIn += _headerSize + m_payloadLength;
+
+    if( m_header[0] == _frameHello )
+    {
+        m_peerDecodes = ( ::memchr( m_payload, m_compressor.id(), m_payloadLength ) != nullptr );
+    }
+    else if( m_header[0] == _frameRaw )
+    {
+        ::memcpy( m_readBuffer, m_payload, m_payloadLength );
+        m_readLength = m_payloadLength;
+    }
+    else if( ( m_header[0] == _frameCompressed ) && ( m_payloadLength >= _rawLengthSize ) )
+    {
+        int rawLength( ( (unsigned char)m_payload[0] << 8 ) | (unsigned char)m_payload[1] );
+        int decoded( m_compressor.decompress( m_payload + _rawLengthSize,
+                                              m_payloadLength - _rawLengthSize,
+                                              m_readBuffer,
+                                              m_compressor.maxBlockSize() ) );
+        if( decoded != rawLength )
+        {
+            LOG_DEBUG( "RWCompressor: Corrupt compressed frame" );
+            m_error = true;
+            return -1;
+        }
+
+        m_readLength = decoded;
+    }
+    else
+    {
+        LOG_DEBUG( "RWCompressor: Unknown frame type" );
+        m_error = true;
+        return -1;
+    }
+
+    m_bytesInDecoded += m_readLength;
+
+    return 1;
+}
+
+bool RWCompressor::writeFrame( char type, const char* payload, int len )
+{
+    char header[_headerSize] = { type, (char)( len >> 8 ), (char)( len & 0xFF ) };
+    if( !writeAll( header, _headerSize ) || !writeAll( payload, len ) )
+    {
+        m_error = true;
+        return false;
+    }
+
+    m_bytesOutEncoded += _headerSize + len;
+    return true;
+}
+
+bool RWCompressor::writeAll( const char* data, int len )
+{
+    int written( 0 );
+    while( written < len )
+    {
+        int thisWrite( m_rw.write( data + written, len - written ) );
+        if( ( thisWrite <= 0 ) || m_rw.error() )
+        {
+            return false;
+        }
+
+        written += thisWrite;
+    }
+
+    return true;
+}
+
+} // namespace Agape
@@ -0,0 +1,93 @@
+#ifndef AGAPE_RW_COMPRESSOR_H
+#define AGAPE_RW_COMPRESSOR_H
+
+#include "ReadableWritable.h"
+#include "String.h"
+
+#include <atomic>
+
+namespace Agape
+{
+
+class Compressor;
+
+/// Compresses a link, e.g. beneath a TupleRoute. Writes are buffered until
+/// flushOutput(), then sent as one or more frames, each a type byte, a
+/// 16-bit big-endian payload length and the payload. Reads are
+/// non-blocking and return whatever has been decoded so far.
+///
+/// Before any data, each side sends a hello frame naming the format it can
+/// decode, and only compresses once the peer's hello names its own format.
+/// Peers which can't spare the CPU to compress (compressOutput false) still
+/// say hello, so they get compressed data in return.
+///
+/// Frame type bytes have the top bit set, which a serialised Tuple never
+/// starts with. With detectPeer, a link whose first byte received is not a
+/// frame is passed through untouched in both directions, so an older peer
+/// without compression still works. Output is held (until the first flush
+/// after that byte arrives), so this is for the side which speaks second,
+/// i.e. the server.
+///
+/// Reads and writes may happen on separate threads (as in Stratus
+/// handlers); the read side only ever changes the mode and the peer's
+/// capability, and only the write side writes.
+class RWCompressor : public ReadableWritable
+{
+public:
+    RWCompressor( Compressor& compressor,
+                  ReadableWritable& rw,
+                  bool compressOutput = true,
+                  bool detectPeer = false );
+    virtual ~RWCompressor();
+
+    virtual int read( char* data, int len );
+    virtual int write( const char* data, int len );
+    virtual bool error();
+    virtual void flushOutput();
+
+    int bytesIn() const { return m_bytesIn; }
+    int bytesInDecoded() const { return m_bytesInDecoded; }
+    int bytesOut() const { return m_bytesOut; }
+    int bytesOutEncoded() const { return m_bytesOutEncoded; }
+
+private:
+    enum Mode
+    {
+        modeDetect,
+        modeFramed,
+        modePassThrough
+    };
+
+    int readFrame();
+    bool writeFrame( char type, const char* payload, int len );
+    bool writeAll( const char* data, int len );
+
+    Compressor& m_compressor;
+    ReadableWritable& m_rw;
+    bool m_compressOutput;
+    std::atomic< enum Mode > m_mode; // Set by the read side, seen by the write side.
+    bool m_helloSent;
+    std::atomic< bool > m_peerDecodes; // Likewise.
+    std::atomic< bool > m_error; // Set on either side, seen by both.
+
+    String m_writeBuffer;
+    char* m_frameBuffer;
+
+    char m_header[3];
+    int m_headerFill;
+    char* m_payload;
+    int m_payloadLength;
+    int m_payloadFill;
+    char* m_readBuffer;
+    int m_readOffset;
+    int m_readLength;
+
+    int m_bytesIn;
+    int m_bytesInDecoded;
+    int m_bytesOut;
+    int m_bytesOutEncoded;
+};
+
+} // namespace Agape
+
+#endif // AGAPE_RW_COMPRESSOR_H
@@ -10,6 +10,13 @@ public:
     virtual void run()
     {
     }
+
+    // Whether run() has work to do now, rather than at the Scheduler's next
+    // idle pass.
+    virtual bool ready()
+    {
+        return false;
+    }
 };
 
 } // namespace Agape
@@ -0,0 +1,368 @@
+#include "Loggers/Logger.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "World/Scene.h"
+#include "World/SceneItem.h"
+#include "World/WorldCoordinates.h"
+#include "CacheSceneLoader.h"
+#include "Collections.h"
+#include "SceneLoader.h"
+#include "SceneRequest.h"
+#include "String.h"
+#include "StringSerialiser.h"
+#include "Value.h"
+
+#include <algorithm>
+
+using namespace Agape::World;
+
+namespace
+{
+    const long _saveIntervalms( 5000 ); // Between saves of a changing replica.
+
+    bool sameItem( const Agape::World::SceneItem& sceneItem, const Agape::World::SceneItem& otherSceneItem )
+    {
+        if( sceneItem.modificationSnowflake() != otherSceneItem.modificationSnowflake() )
+        {
+            return false;
+        }
+
+        // Not every writer stamps a new modification snowflake.
+        Agape::Value value;
+        Agape::Value otherValue;
+        sceneItem.toValue( value );
+        otherSceneItem.toValue( otherValue );
+        Agape::StringSerialiser serialiser;
+        Agape::StringSerialiser otherSerialiser;
+        value.toReadableWritable( serialiser );
+        otherValue.toReadableWritable( otherSerialiser );
+        return( serialiser.m_data == otherSerialiser.m_data );
+    }
+
+    Agape::Vector< Agape::World::SceneItem >::iterator findItem( Agape::World::Scene& scene, const Agape::World::SceneItem& sceneItem )
+    {
+        return std::find( scene.m_sceneItems.begin(), scene.m_sceneItems.end(), sceneItem );
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace SceneLoaders
+{
+
+Cache::Cache( const World::Coordinates& coordinates,
+              bool receiveRequests,
+              Factory& backingLoaderFactory,
+              Factory& replicaLoaderFactory,
+              Timers::Factory& timerFactory ) :
+  SceneLoader( coordinates ),
+  m_backingLoader( backingLoaderFactory.makeLoader( coordinates, receiveRequests ) ),
+  m_replicaLoader( replicaLoaderFactory.makeLoader( coordinates, false ) ),
+  m_hasReplica( false ),
+  m_replicaDirty( false ),
+  m_saveTimer( timerFactory.makeTimer() ),
+  m_overflowed( false ),
+  m_prefetching( false )
+{
+}
+
+Cache::~Cache()
+{
+    // On leaving the scene.
+    if( m_replicaDirty )
+    {
+        saveReplica();
+    }
+
+    delete( m_saveTimer );
+    delete( m_backingLoader );
+    delete( m_replicaLoader );
+}
+
+bool Cache::load( World::Scene& scene )
+{
+    if( m_replicaDirty )
+    {
+        saveReplica();
+    }
+
+    if( m_replicaLoader->load( m_replica ) )
+    {
+        m_hasReplica = true;
+        scene = m_replica;
+
+        // If we can't ask (e.g. we're offline), the replica is all we have,
+        // and we'll ask again next load.
+        if( !m_backingLoader->requestRevalidation( m_replica.version() ) )
+        {
+            LOG_DEBUG( "CacheSceneLoader: Unable to request revalidation, serving replica" );
+        }
+
+        return true;
+    }
+
+    m_hasReplica = false;
+    if( m_backingLoader->load( scene ) )
+    {
+        m_replica = scene;
+        m_hasReplica = true;
+        saveReplica();
+        return true;
+    }
+
+    return false;
+}
+
+bool Cache::request( const Vector< SceneRequest >& requests )
+{
+    // The replica is updated as the backing loader echoes these back.
+    return( m_backingLoader->request( requests ) );
+}
+
+Vector< SceneRequest > Cache::getUpdates()
+{
+    Vector< SceneRequest > updates( m_backingLoader->getUpdates() );
+    if( !m_hasReplica )
+    {
+        return updates;
+    }
+
+    if( !updates.empty() )
+    {
+        // In the order Compositor applies them.
+        Vector< SceneRequest > sortedUpdates( updates );
+        std::sort( sortedUpdates.begin(), sortedUpdates.end() );
+        Vector< SceneRequest >::const_iterator it( sortedUpdates.begin() );
+        for( ; it != sortedUpdates.end(); ++it )
+        {
+            apply( *it, m_replica );
+        }
+        m_replicaDirty = true;
+
+        // Any revalidation is collected next time, so that its changes aren't
+        // sorted in among these.
+    }
+    else
+    {
+        bool current( true );
+        World::Scene scene;
+        if( m_backingLoader->getRevalidation( current, scene ) && !current )
+        {
+            revalidated( scene, updates );
+        }
+    }
+
+    if( m_replicaDirty && ( m_saveTimer->ms() >= _saveIntervalms ) )
+    {
+        saveReplica();
+    }
+
+    return updates;
+}
+
+bool Cache::overflowed()
+{
+    bool overflowed( m_backingLoader->overflowed() || m_overflowed );
+    m_overflowed = false;
+    return overflowed;
+}
+
+bool Cache::prefetch()
+{
+    if( m_replicaDirty )
+    {
+        saveReplica();
+    }
+
+    // With no replica, the empty version is never current, so the whole
+    // scene comes back.
+    m_hasReplica = m_replicaLoader->load( m_replica );
+    m_prefetching = m_backingLoader->requestRevalidation( m_hasReplica ? m_replica.version() : String() );
+    return m_prefetching;
+}
+
+bool Cache::getPrefetched( World::Scene& scene )
+{
+    bool current( true );
+    World::Scene fetched;
+    if( !m_prefetching || !m_backingLoader->getRevalidation( current, fetched ) )
+    {
+        return false;
+    }
+
+    m_prefetching = false;
+    if( !current )
+    {
+        m_replica = fetched;
+        m_hasReplica = true;
+        saveReplica();
+    }
+
+    if( m_hasReplica )
+    {
+        scene = m_replica;
+    }
+    return m_hasReplica;
+}
+
+bool Cache::hasSceneItemAttribute( const String& snowflake,
+                                   const String& name )
+{
+    return( m_backingLoader->hasSceneItemAttribute( snowflake, name ) );
+}
+
+bool Cache::createSceneItemAttribute( const String& snowflake,
+                                      const String& name )
+{
+    return( m_backingLoader->createSceneItemAttribute( snowflake, name ) );
+}
+
+bool Cache::loadSceneItemAttribute( const String& snowflake,
+                                    const String& name,
+                                    Value& value )
+{
+    return( m_backingLoader->loadSceneItemAttribute( snowflake, name, value ) );
+}
+
+bool Cache::saveSceneItemAttribute( const String& snowflake,
+                                    const String& name,
+                                    const Value& value )
+{
+    return( m_backingLoader->saveSceneItemAttribute( snowflake, name, value ) );
+}
+
+bool Cache::deleteSceneItemAttributes( const String& snowflake )
+{
+    return( m_backingLoader->deleteSceneItemAttributes( snowflake ) );
+}
+
+bool Cache::writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes )
+{
+    return( m_backingLoader->writeSceneItemAttributes( writes ) );
+}
+
+bool Cache::flushSceneItemAttributes()
+{
+    return( m_backingLoader->flushSceneItemAttributes() );
+}
+
+void Cache::invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset )
+{
+    m_backingLoader->invalidateCachedAsset( invalidatedAsset );
+}
+
+Vector< struct SceneLoader::InvalidatedAsset > Cache::getInvalidatedAssets()
+{
+    return( m_backingLoader->getInvalidatedAssets() );
+}
+
+// As Compositor::updateScene().
+void Cache::apply( const SceneRequest& request, World::Scene& scene )
+{
+    if( ( request.m_coordinates != m_coordinates ) && ( request.m_newCoordinates != m_coordinates ) )
+    {
+        return;
+    }
+
+    Vector< SceneItem >::iterator it( findItem( scene, request.m_sceneItem ) );
+    switch( request.m_sceneOperation )
+    {
+    case SceneRequest::create:
+        scene.m_sceneItems.push_back( request.m_sceneItem );
+        break;
+    case SceneRequest::update:
+        if( it != scene.m_sceneItems.end() ) *it = request.m_sceneItem;
+        break;
+    case SceneRequest::remove:
+        if( it != scene.m_sceneItems.end() ) scene.m_sceneItems.erase( it );
+        break;
+    case SceneRequest::transport:
+        if( ( request.m_coordinates == m_coordinates ) && ( it != scene.m_sceneItems.end() ) )
+        {
+            scene.m_sceneItems.erase( it );
+        }
+        else if( request.m_newCoordinates == m_coordinates )
+        {
+            scene.m_sceneItems.push_back( request.m_sceneItem );
+        }
+        break;
+    case SceneRequest::raise:
+    case SceneRequest::lower:
+        if( it != scene.m_sceneItems.end() )
+        {
+            SceneItem movedItem( *it );
+            scene.m_sceneItems.erase( it );
+            scene.m_sceneItems.insert( ( request.m_sceneOperation == SceneRequest::raise ) ? scene.m_sceneItems.end() :
+                                                                                               scene.m_sceneItems.begin(),
+                                       movedItem );
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+// Turns the difference between the replica and the scene as it is now into
+// requests, and makes the replica the scene as it is now.
+void Cache::revalidated( const World::Scene& scene, Vector< SceneRequest >& updates )
+{
+    LOG_DEBUG( "CacheSceneLoader: Replica is stale, updating" );
+
+    Vector< SceneItem >::const_iterator it( m_replica.m_sceneItems.begin() );
+    for( ; it != m_replica.m_sceneItems.end(); ++it )
+    {
+        if( std::find( scene.m_sceneItems.begin(), scene.m_sceneItems.end(), *it ) == scene.m_sceneItems.end() )
+        {
+            updates.push_back( SceneRequest( SceneRequest::remove, *it, m_coordinates ) );
+        }
+    }
+
+    for( it = scene.m_sceneItems.begin(); it != scene.m_sceneItems.end(); ++it )
+    {
+        Vector< SceneItem >::iterator replicaIt( findItem( m_replica, *it ) );
+        if( replicaIt == m_replica.m_sceneItems.end() )
+        {
+            updates.push_back( SceneRequest( SceneRequest::create, *it, m_coordinates ) );
+        }
+        else if( !sameItem( *replicaIt, *it ) )
+        {
+            updates.push_back( SceneRequest( SceneRequest::update, *it, m_coordinates ) );
+        }
+    }
+
+    // Requests can't say where a new item goes, so if applying them doesn't
+    // give the same order, the whole scene is reloaded (from the replica).
+    Vector< SceneRequest > sortedUpdates( updates );
+    std::sort( sortedUpdates.begin(), sortedUpdates.end() );
+    Vector< SceneRequest >::const_iterator updateIt( sortedUpdates.begin() );
+    for( ; updateIt != sortedUpdates.end(); ++updateIt )
+    {
+        apply( *updateIt, m_replica );
+    }
+
+    bool sameOrder( m_replica.m_sceneItems.size() == scene.m_sceneItems.size() );
+    for( unsigned int i( 0 ); sameOrder && ( i < scene.m_sceneItems.size() ); ++i )
+    {
+        sameOrder = ( m_replica.m_sceneItems[i] == scene.m_sceneItems[i] );
+    }
+    if( !sameOrder )
+    {
+        m_overflowed = true;
+    }
+
+    m_replica = scene;
+    saveReplica();
+}
+
+void Cache::saveReplica()
+{
+    m_replicaLoader->save( m_replica );
+    m_replicaDirty = false;
+    m_saveTimer->reset();
+}
+
+} // namespace SceneLoaders
+
+} // namespace Agape
@@ -0,0 +1,101 @@
+#ifndef AGAPE_SCENE_LOADERS_CACHE_H
+#define AGAPE_SCENE_LOADERS_CACHE_H
+
+#include "World/Scene.h"
+#include "Collections.h"
+#include "SceneLoader.h"
+#include "SceneRequest.h"
+#include "String.h"
+#include "Value.h"
+
+namespace Agape
+{
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+namespace World
+{
+class Coordinates;
+} // namespace World
+
+class Timer;
+
+namespace SceneLoaders
+{
+
+class Factory;
+
+// Serves scenes from a local replica (e.g. on flash) where there is one, so
+// that walking into a scene doesn't wait on the server, then asks the backing
+// loader in the background whether the replica is still current. Changes
+// found that way come back from getUpdates() as scene requests, as do the
+// backing loader's own updates, which are also applied to the replica.
+// Requests and attributes pass through to the backing loader.
+//
+// A scene can also be fetched into the replica ahead of being walked into,
+// with prefetch(), which asks in the same way whether any replica is current.
+//
+// Updates are saved to the replica at most every few seconds, and on leaving
+// the scene, rather than rewriting it to flash for every batch.
+class Cache : public SceneLoader
+{
+public:
+    Cache( const World::Coordinates& coordinates,
+           bool receiveRequests,
+           Factory& backingLoaderFactory,
+           Factory& replicaLoaderFactory,
+           Timers::Factory& timerFactory );
+    ~Cache();
+
+    virtual bool load( World::Scene& scene );
+    virtual bool request( const Vector< SceneRequest >& requests );
+    virtual Vector< SceneRequest > getUpdates();
+
+    virtual bool overflowed();
+
+    virtual bool prefetch();
+    virtual bool getPrefetched( World::Scene& scene );
+
+    virtual bool hasSceneItemAttribute( const String& snowflake,
+                                        const String& name );
+    virtual bool createSceneItemAttribute( const String& snowflake,
+                                           const String& name );
+    virtual bool loadSceneItemAttribute( const String& snowflake,
+                                         const String& name,
+                                         Value& value );
+    virtual bool saveSceneItemAttribute( const String& snowflake,
+                                         const String& name,
+                                         const Value& value );
+    virtual bool deleteSceneItemAttributes( const String& snowflake );
+    virtual bool writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes );
+    virtual bool flushSceneItemAttributes();
+
+    virtual void invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset );
+    virtual Vector< struct InvalidatedAsset > getInvalidatedAssets();
+
+private:
+    void apply( const SceneRequest& request, World::Scene& scene );
+    void revalidated( const World::Scene& scene, Vector< SceneRequest >& updates );
+    void saveReplica();
+
+    SceneLoader* m_backingLoader;
+    SceneLoader* m_replicaLoader;
+
+    // As last loaded or revalidated, with updates since applied.
+    World::Scene m_replica;
+    bool m_hasReplica;
+    bool m_replicaDirty; // Updated since last saved.
+    Timer* m_saveTimer; // Since last saved.
+
+    bool m_overflowed;
+    bool m_prefetching;
+};
+
+} // namespace SceneLoaders
+
+} // namespace Agape
+
+#endif // AGAPE_SCENE_LOADERS_CACHE_H
@@ -0,0 +1,382 @@
+#ifdef CACHE_SCENE_LOADER_TEST
+
+#include "Clocks/CClock.h"
+#include "Memories/RAMMemory.h"
+#include "SceneLoaders/Factories/CacheSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/FileSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/KiamaFSSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/Linda2SceneLoaderFactory.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "SceneLoaders/FileSceneLoader.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Utils/Snowflake.h"
+#include "World/Scene.h"
+#include "World/SceneItem.h"
+#include "World/WorldCoordinates.h"
+#include "Collections.h"
+#include "KiamaFS.h"
+#include "Linda2SceneLoaderResponder.h"
+#include "SceneLoader.h"
+#include "SceneRequest.h"
+#include "String.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+
+#include <iostream>
+
+#include <stdlib.h>
+
+using namespace Agape;
+using Agape::Linda2::TupleDispatcher;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const int _maxPumps( 100 );
+    const int _burst( 10 );
+    const long _saveIntervalms( 5000 ); // As CacheSceneLoader.
+
+    long _nowms( 0 );
+
+    // Time only moves when the test says, for the replica's saves.
+    class FakeTimer : public Timer
+    {
+    public:
+        FakeTimer() : m_startms( _nowms ) {}
+        virtual long ms() { return _nowms - m_startms; }
+        virtual void reset() { m_startms = _nowms; }
+
+    private:
+        long m_startms;
+    };
+
+    class FakeTimerFactory : public Timers::Factory
+    {
+    public:
+        virtual Timer* makeTimer() { return new FakeTimer; }
+    };
+
+    // Counts what's asked of the server, from the client's side, or of the
+    // replica.
+    class Counted : public SceneLoader
+    {
+    public:
+        Counted( const World::Coordinates& coordinates, SceneLoader* loader, int& loads, int& revalidations, int& saves ) :
+          SceneLoader( coordinates ),
+          m_loader( loader ),
+          m_loads( loads ),
+          m_revalidations( revalidations ),
+          m_saves( saves )
+        {
+        }
+
+        virtual ~Counted() { delete( m_loader ); }
+
+        virtual bool load( World::Scene& scene ) { ++m_loads; return m_loader->load( scene ); }
+        virtual void save( const World::Scene& scene ) { ++m_saves; m_loader->save( scene ); }
+        virtual bool request( const Vector< SceneRequest >& requests ) { return m_loader->request( requests ); }
+        virtual Vector< SceneRequest > getUpdates() { return m_loader->getUpdates(); }
+        virtual bool overflowed() { return m_loader->overflowed(); }
+
+        virtual bool requestRevalidation( const String& version )
+        {
+            ++m_revalidations;
+            return m_loader->requestRevalidation( version );
+        }
+
+        virtual bool getRevalidation( bool& current, World::Scene& scene ) { return m_loader->getRevalidation( current, scene ); }
+
+        SceneLoader* m_loader;
+        int& m_loads;
+        int& m_revalidations;
+        int& m_saves;
+    };
+
+    class Counting : public SceneLoaders::Factory
+    {
+    public:
+        Counting( SceneLoaders::Factory& factory ) :
+          m_factory( factory ),
+          m_loads( 0 ),
+          m_revalidations( 0 ),
+          m_saves( 0 )
+        {
+        }
+
+        virtual SceneLoader* makeLoader( const World::Coordinates& coordinates, bool receiveRequests )
+        {
+            return new Counted( coordinates, m_factory.makeLoader( coordinates, receiveRequests ), m_loads, m_revalidations, m_saves );
+        }
+
+        SceneLoaders::Factory& m_factory;
+        int m_loads;
+        int m_revalidations;
+        int m_saves;
+    };
+
+    // No server at all.
+    class Offline : public SceneLoader
+    {
+    public:
+        Offline( const World::Coordinates& coordinates ) : SceneLoader( coordinates ) {}
+
+        virtual bool load( World::Scene& scene ) { return false; }
+        virtual bool request( const Vector< SceneRequest >& requests ) { return false; }
+        virtual Vector< SceneRequest > getUpdates() { return Vector< SceneRequest >(); }
+    };
+
+    class OfflineFactory : public SceneLoaders::Factory
+    {
+    public:
+        virtual SceneLoader* makeLoader( const World::Coordinates& coordinates, bool receiveRequests )
+        {
+            return new Offline( coordinates );
+        }
+    };
+
+    String makeScenesPath()
+    {
+        char path[] = "/tmp/CacheSceneLoaderTestXXXXXX";
+        if( ::mkdtemp( path ) == nullptr ) return String();
+        return path;
+    }
+
+    World::SceneItem makeItem( const String& assetName, int row, int col )
+    {
+        World::SceneItem sceneItem;
+        sceneItem.setAssetName( assetName );
+        sceneItem.setRow( row );
+        sceneItem.setCol( col );
+        sceneItem.setDimensions( 3, 5 );
+        sceneItem.touch();
+        return sceneItem;
+    }
+
+    // As the server has it, bypassing the responder.
+    World::Scene serverScene( SceneLoaders::Factories::File& fileFactory, const World::Coordinates& coordinates )
+    {
+        World::Scene scene;
+        SceneLoader* sceneLoader( fileFactory.makeLoader( coordinates, false ) );
+        sceneLoader->load( scene );
+        delete( sceneLoader );
+        return scene;
+    }
+
+    void saveServerScene( SceneLoaders::Factories::File& fileFactory, const World::Scene& scene )
+    {
+        SceneLoader* sceneLoader( fileFactory.makeLoader( scene.m_coordinates, false ) );
+        sceneLoader->save( scene );
+        delete( sceneLoader );
+    }
+
+    World::Scene replicaScene( SceneLoaders::Factories::KiamaFS& replicaFactory, const World::Coordinates& coordinates )
+    {
+        World::Scene scene;
+        SceneLoader* sceneLoader( replicaFactory.makeLoader( coordinates, false ) );
+        sceneLoader->load( scene );
+        delete( sceneLoader );
+        return scene;
+    }
+
+    // Pumps until the revalidation (or anything else) comes back.
+    Vector< SceneRequest > getUpdates( SceneLoader& sceneLoader, bool& overflowed )
+    {
+        Vector< SceneRequest > updates;
+        overflowed = false;
+        for( int pump( 0 ); updates.empty() && !overflowed && ( pump < _maxPumps ); ++pump )
+        {
+            updates = sceneLoader.getUpdates();
+            overflowed = sceneLoader.overflowed();
+        }
+        return updates;
+    }
+
+    int count( const Vector< SceneRequest >& requests, enum SceneRequest::SceneOperation sceneOperation )
+    {
+        int n( 0 );
+        Vector< SceneRequest >::const_iterator it( requests.begin() );
+        for( ; it != requests.end(); ++it )
+        {
+            if( it->m_sceneOperation == sceneOperation ) ++n;
+        }
+        return n;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    Clocks::C clock;
+    Snowflake snowflake( clock, 1 );
+
+    String scenesPath( makeScenesPath() );
+    World::Coordinates coordinates;
+    coordinates.m_worldID = "world";
+    coordinates.m_x = 3;
+    coordinates.m_y = 4;
+
+    Timers::Factories::HighRes timerFactory;
+    TupleDispatcher tupleDispatcher;
+    TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+    tupleRouter.setMyID( "test" );
+
+    // The server, as File loaders behind the responder.
+    SceneLoaders::Factories::File fileFactory( scenesPath, "scn", scenesPath, "sia" );
+    SceneLoaders::Linda2Responder responder( tupleRouter, fileFactory );
+    SceneLoaders::Factories::Linda2 linda2Factory( tupleRouter, timerFactory );
+    Counting countingFactory( linda2Factory );
+
+    // The client's flash.
+    Memories::RAM memory( 0x40000, 0x100, 0x1000, Memory::flash );
+    KiamaFS fs( memory );
+    SceneLoaders::Factories::KiamaFS replicaFactory( fs );
+    Counting replicaCountingFactory( replicaFactory );
+    FakeTimerFactory fakeTimerFactory;
+    SceneLoaders::Factories::Cache cacheFactory( countingFactory, replicaCountingFactory, fakeTimerFactory );
+
+    World::Scene scene;
+    scene.m_coordinates = coordinates;
+    scene.m_sceneItems.push_back( makeItem( "tree", 2, 10 ) );
+    scene.m_sceneItems.push_back( makeItem( "lamp", 5, 20 ) );
+    scene.m_sceneItems.push_back( makeItem( "door", 8, 30 ) );
+    saveServerScene( fileFactory, scene );
+
+    // The first visit waits on the server and fills the replica.
+    {
+    SceneLoader* sceneLoader( cacheFactory.makeLoader( coordinates, true ) );
+    World::Scene loaded;
+    bool loadedOK( sceneLoader->load( loaded ) );
+    success = check( "Cold", loadedOK && ( loaded.version() == scene.version() ) &&
+                             ( countingFactory.m_loads == 1 ) && ( countingFactory.m_revalidations == 0 ) ) && success;
+    success = check( "Replica filled", replicaScene( replicaFactory, coordinates ).version() == scene.version() ) && success;
+    delete( sceneLoader );
+    }
+
+    // The next is served from the replica, with a revalidation in the
+    // background that finds it current.
+    {
+    SceneLoader* sceneLoader( cacheFactory.makeLoader( coordinates, true ) );
+    World::Scene loaded;
+    bool loadedOK( sceneLoader->load( loaded ) );
+    success = check( "Warm", loadedOK && ( loaded.version() == scene.version() ) &&
+                             ( countingFactory.m_loads == 1 ) && ( countingFactory.m_revalidations == 1 ) ) && success;
+    bool overflowed( false );
+    Vector< SceneRequest > updates( getUpdates( *sceneLoader, overflowed ) );
+    success = check( "Current", updates.empty() && !overflowed ) && success;
+    delete( sceneLoader );
+    }
+
+    // Changes made while we were away come back as requests, once.
+    World::Scene changed( scene );
+    changed.m_sceneItems.erase( changed.m_sceneItems.begin() ); // Tree removed.
+    changed.m_sceneItems[0].setRow( 6 ); // Lamp moved.
+    changed.m_sceneItems[0].touch();
+    changed.m_sceneItems.push_back( makeItem( "well", 12, 40 ) ); // Well created.
+    saveServerScene( fileFactory, changed );
+    {
+    SceneLoader* sceneLoader( cacheFactory.makeLoader( coordinates, true ) );
+    World::Scene loaded;
+    bool loadedOK( sceneLoader->load( loaded ) );
+    success = check( "Stale served", loadedOK && ( loaded.version() == scene.version() ) &&
+                                     ( countingFactory.m_loads == 1 ) ) && success;
+    bool overflowed( false );
+    Vector< SceneRequest > updates( getUpdates( *sceneLoader, overflowed ) );
+    success = check( "Stale updates", ( updates.size() == 3 ) && !overflowed &&
+                                      ( count( updates, SceneRequest::remove ) == 1 ) &&
+                                      ( count( updates, SceneRequest::update ) == 1 ) &&
+                                      ( count( updates, SceneRequest::create ) == 1 ) ) && success;
+    success = check( "Replica refreshed", replicaScene( replicaFactory, coordinates ).version() == changed.version() ) && success;
+    updates = getUpdates( *sceneLoader, overflowed );
+    success = check( "Once", updates.empty() && !overflowed ) && success;
+
+    // Our own requests, as echoed by the server, are applied too, but a
+    // burst of them isn't written to flash one at a time.
+    World::SceneItem moved( changed.m_sceneItems[1] );
+    int saves( replicaCountingFactory.m_saves );
+    bool echoed( true );
+    for( int i( 0 ); i < _burst; ++i )
+    {
+        moved.setCol( 41 + i );
+        moved.touch();
+        Vector< SceneRequest > requests;
+        requests.push_back( SceneRequest( SceneRequest::update, moved, coordinates ) );
+        sceneLoader->request( requests );
+        updates = getUpdates( *sceneLoader, overflowed );
+        echoed = echoed && ( updates.size() == 1 );
+    }
+    success = check( "Echo", echoed && ( replicaCountingFactory.m_saves == saves ) ) && success;
+
+    // Once the burst has gone quiet for long enough, it's saved once.
+    _nowms += _saveIntervalms;
+    sceneLoader->getUpdates();
+    World::Scene replica( replicaScene( replicaFactory, coordinates ) );
+    success = check( "Echo saved", ( replicaCountingFactory.m_saves == saves + 1 ) &&
+                                   ( replica.version() == serverScene( fileFactory, coordinates ).version() ) &&
+                                   ( replica.m_sceneItems[1].col() == 40 + _burst ) ) && success;
+
+    // And anything since is saved on leaving the scene.
+    moved.setCol( 30 );
+    moved.touch();
+    Vector< SceneRequest > requests;
+    requests.push_back( SceneRequest( SceneRequest::update, moved, coordinates ) );
+    sceneLoader->request( requests );
+    getUpdates( *sceneLoader, overflowed );
+    delete( sceneLoader );
+    replica = replicaScene( replicaFactory, coordinates );
+    success = check( "Saved on leaving", ( replicaCountingFactory.m_saves == saves + 2 ) &&
+                                         ( replica.m_sceneItems[1].col() == 30 ) ) && success;
+    }
+
+    // A new order can't be given as requests, so the scene is reloaded.
+    World::Scene reordered( serverScene( fileFactory, coordinates ) );
+    World::SceneItem first( reordered.m_sceneItems[0] );
+    reordered.m_sceneItems[0] = reordered.m_sceneItems[1];
+    reordered.m_sceneItems[1] = first;
+    reordered.m_coordinates = coordinates;
+    saveServerScene( fileFactory, reordered );
+    {
+    SceneLoader* sceneLoader( cacheFactory.makeLoader( coordinates, true ) );
+    World::Scene loaded;
+    sceneLoader->load( loaded );
+    bool overflowed( false );
+    getUpdates( *sceneLoader, overflowed );
+    sceneLoader->load( loaded );
+    success = check( "Reordered", overflowed && ( loaded.version() == reordered.version() ) &&
+                                  ( countingFactory.m_loads == 1 ) ) && success;
+    delete( sceneLoader );
+    }
+
+    // Offline, scenes we've visited are still there, and those we haven't
+    // aren't.
+    {
+    OfflineFactory offlineFactory;
+    SceneLoaders::Factories::Cache offlineCacheFactory( offlineFactory, replicaFactory, fakeTimerFactory );
+    SceneLoader* sceneLoader( offlineCacheFactory.makeLoader( coordinates, true ) );
+    World::Scene loaded;
+    bool visited( sceneLoader->load( loaded ) && ( loaded.version() == reordered.version() ) );
+    bool overflowed( false );
+    bool quiet( getUpdates( *sceneLoader, overflowed ).empty() && !overflowed );
+    delete( sceneLoader );
+
+    World::Coordinates elsewhere( coordinates );
+    elsewhere.m_x = 4;
+    sceneLoader = offlineCacheFactory.makeLoader( elsewhere, true );
+    bool notVisited( !sceneLoader->load( loaded ) );
+    delete( sceneLoader );
+    success = check( "Offline", visited && quiet && notVisited ) && success;
+    }
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // CACHE_SCENE_LOADER_TEST
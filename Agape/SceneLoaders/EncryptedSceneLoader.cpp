@@ -1,4 +1,5 @@
 #include "Encryptors/Factories/EncryptorsFactory.h"
+#include "Encryptors/Utils/BatchDecryptor.h"
 #include "Encryptors/Utils/SecureIdentifier.h"
 #include "Encryptors/Encryptor.h"
 #include "Encryptors/Hash.h"
@@ -20,6 +21,7 @@ namespace SceneLoaders
 {
 
 Encrypted::Encrypted( const World::Coordinates& coordinates,
+                      bool receiveRequests,
                       Factory& backingLoaderFactory,
                       Metadata& worldMetadata,
                       Encryptors::Factory& encryptorFactory,
@@ -27,7 +29,7 @@ Encrypted::Encrypted( const World::Coordinates& coordinates,
   SceneLoader( coordinates ),
   m_worldMetadata( worldMetadata ),
   m_hash( hash ),
-  m_backingLoader( backingLoaderFactory.makeLoader( coordinates ) ),
+  m_backingLoader( backingLoaderFactory.makeLoader( coordinates, receiveRequests ) ),
   m_encryptor( encryptorFactory.makeEncryptor() )
 {
 }
@@ -69,16 +71,30 @@ Vector< SceneRequest > Encrypted::getUpdates()
 {
     m_encryptor->setKey( &m_worldMetadata.m_itemKey[0] );
     Vector< SceneRequest > encryptedRequests( m_backingLoader->getUpdates() );
-    Vector< SceneRequest >::iterator it( encryptedRequests.begin() );
-    for( ; it != encryptedRequests.end(); ++it )
+    Encryptors::Utils::BatchDecryptor::decrypt( encryptedRequests, *m_encryptor );
+
+    return encryptedRequests;
+}
+
+bool Encrypted::overflowed()
+{
+    return( m_backingLoader->overflowed() );
+}
+
+bool Encrypted::prefetch()
+{
+    return( m_backingLoader->prefetch() );
+}
+
+bool Encrypted::getPrefetched( World::Scene& scene )
+{
+    if( m_backingLoader->getPrefetched( scene ) )
     {
-        if( !it->decrypt( *m_encryptor ) )
-        {
-            break;
-        }
+        m_encryptor->setKey( &m_worldMetadata.m_itemKey[0] );
+        return( scene.decrypt( *m_encryptor ) );
     }
 
-    return encryptedRequests;
+    return false;
 }
 
 bool Encrypted::hasSceneItemAttribute( const String& snowflake,
@@ -140,6 +156,28 @@ bool Encrypted::deleteSceneItemAttributes( const String& snowflake )
     return( m_backingLoader->deleteSceneItemAttributes( snowflake ) );
 }
 
+bool Encrypted::writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes )
+{
+    m_encryptor->setKey( &m_worldMetadata.m_itemKey[0] );
+    Vector< struct AttributeWrite > encryptedWrites( writes );
+    Vector< struct AttributeWrite >::iterator it( encryptedWrites.begin() );
+    for( ; it != encryptedWrites.end(); ++it )
+    {
+        it->m_name = encryptedAttributeName( &m_worldMetadata.m_itemKey[0], it->m_name );
+        if( !it->m_value.encrypt( *m_encryptor ) )
+        {
+            return false;
+        }
+    }
+
+    return( m_backingLoader->writeSceneItemAttributes( encryptedWrites ) );
+}
+
+bool Encrypted::flushSceneItemAttributes()
+{
+    return( m_backingLoader->flushSceneItemAttributes() );
+}
+
 void Encrypted::invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset )
 {
     m_backingLoader->invalidateCachedAsset( invalidatedAsset );
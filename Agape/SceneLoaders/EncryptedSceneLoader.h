@@ -33,6 +33,7 @@ class Encrypted : public SceneLoader
 {
 public:
     Encrypted( const World::Coordinates& coordinates,
+               bool receiveRequests,
                Factory& backingLoaderFactory,
                Metadata& worldMetadata,
                Encryptors::Factory& encryptorFactory,
@@ -43,6 +44,11 @@ public:
     virtual bool request( const Vector< SceneRequest >& requests );
     virtual Vector< SceneRequest > getUpdates();
 
+    virtual bool overflowed();
+
+    virtual bool prefetch();
+    virtual bool getPrefetched( World::Scene& scene );
+
     virtual bool hasSceneItemAttribute( const String& snowflake,
                                         const String& name );
     virtual bool createSceneItemAttribute( const String& snowflake,
@@ -54,6 +60,8 @@ public:
                                          const String& name,
                                          const Value& value );
     virtual bool deleteSceneItemAttributes( const String& snowflake );
+    virtual bool writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes );
+    virtual bool flushSceneItemAttributes();
 
     virtual void invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset );
     virtual Vector< struct InvalidatedAsset > getInvalidatedAssets();
@@ -0,0 +1,37 @@
+#include "SceneLoaders/CacheSceneLoader.h"
+#include "SceneLoaders/SceneLoader.h"
+#include "World/WorldCoordinates.h"
+#include "CacheSceneLoaderFactory.h"
+
+namespace Agape
+{
+
+namespace SceneLoaders
+{
+
+namespace Factories
+{
+
+Cache::Cache( Factory& backingLoaderFactory,
+              Factory& replicaLoaderFactory,
+              Timers::Factory& timerFactory ) :
+  m_backingLoaderFactory( backingLoaderFactory ),
+  m_replicaLoaderFactory( replicaLoaderFactory ),
+  m_timerFactory( timerFactory )
+{
+}
+
+SceneLoader* Cache::makeLoader( const World::Coordinates& coordinates, bool receiveRequests )
+{
+    return new SceneLoaders::Cache( coordinates,
+                                    receiveRequests,
+                                    m_backingLoaderFactory,
+                                    m_replicaLoaderFactory,
+                                    m_timerFactory );
+}
+
+} // namespace Factories
+
+} // namespace SceneLoaders
+
+} // namespace Agape
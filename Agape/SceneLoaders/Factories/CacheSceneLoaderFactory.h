@@ -0,0 +1,48 @@
+#ifndef AGAPE_SCENE_LOADERS_FACTORIES_CACHE_H
+#define AGAPE_SCENE_LOADERS_FACTORIES_CACHE_H
+
+#include "SceneLoadersFactory.h"
+
+namespace Agape
+{
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+namespace World
+{
+class Coordinates;
+} // namespace World
+
+class SceneLoader;
+
+namespace SceneLoaders
+{
+
+namespace Factories
+{
+
+class Cache : public Factory
+{
+public:
+    Cache( Factory& backingLoaderFactory,
+           Factory& replicaLoaderFactory,
+           Timers::Factory& timerFactory );
+
+    virtual SceneLoader* makeLoader( const World::Coordinates& coordinates, bool receiveRequests );
+
+private:
+    Factory& m_backingLoaderFactory;
+    Factory& m_replicaLoaderFactory;
+    Timers::Factory& m_timerFactory;
+};
+
+} // namespace Factories
+
+} // namespace SceneLoaders
+
+} // namespace Agape
+
+#endif // AGAPE_SCENE_LOADERS_FACTORIES_CACHE_H
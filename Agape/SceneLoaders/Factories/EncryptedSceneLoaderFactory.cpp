@@ -32,6 +32,7 @@ Encrypted::Encrypted( Factory& backingLoaderFactory,
 SceneLoader* Encrypted::makeLoader( const Coordinates& coordinates, bool receiveRequests )
 {
     return new SceneLoaders::Encrypted( coordinates,
+                                        receiveRequests,
                                         m_backingLoaderFactory,
                                         m_worldMetadata,
                                         m_encryptorFactory,
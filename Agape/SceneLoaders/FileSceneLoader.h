@@ -31,6 +31,8 @@ public:
     virtual bool request( const Vector< SceneRequest >& requests );
     virtual Vector< SceneRequest > getUpdates();
 
+    virtual void save( const World::Scene& scene );
+
     virtual bool hasSceneItemAttribute( const String& snowflake,
                                         const String& name );
     virtual bool createSceneItemAttribute( const String& snowflake,
@@ -44,8 +46,6 @@ public:
     virtual bool deleteSceneItemAttributes( const String& snowflake );
 
 private:
-    void save( const World::Scene& scene );
-
     bool loadSceneItemAttributesFile( const String& snowflake, Value& attributes );
     bool saveSceneItemAttributesFile( const String& snowflake, const Value& attributes );
 
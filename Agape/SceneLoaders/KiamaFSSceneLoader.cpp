@@ -30,19 +30,18 @@ bool KiamaFS::load( World::Scene& scene )
 {
     scene.m_sceneItems.clear();
 
-    LiteStream filenameStream;
-    filenameStream << escapeBase64( m_coordinates.m_worldID ).substr( 0, 8 ) << "_" << m_coordinates.m_x << "_" << m_coordinates.m_y << ".scn";
+    String filename( sceneFilename() );
 
-    LOG_DEBUG( "Attempting to load " + filenameStream.str() + " with KiamaFS" );
+    LOG_DEBUG( "Attempting to load " + filename + " with KiamaFS" );
 
     /*
-    if( m_index.find( filenameStream.str() ) != m_index.end() )
+    if( m_index.find( filename ) != m_index.end() )
     {
         m_inIndex = true;
 
         LOG_DEBUG( "Found in filesystem index" );
 
-        Agape::KiamaFS::File file( m_fs.file( filenameStream.str() ) );
+        Agape::KiamaFS::File file( m_fs.file( filename ) );
         if( file.open( Agape::KiamaFS::File::OpenMode::readMode ) )
         {
             Value sceneValue( Value::fromReadableWritable( file ) );
@@ -59,18 +58,22 @@ bool KiamaFS::load( World::Scene& scene )
     }
     */
 
-    Agape::KiamaFS::File* file( m_fs.file( filenameStream.str() ) );
+    bool success( false );
+
+    Agape::KiamaFS::File* file( m_fs.file( filename ) );
     if( file->open( Agape::KiamaFS::File::OpenMode::readMode ) )
     {
         Value sceneValue;
-        Value::fromReadableWritable( *file, sceneValue );
-        //LOG_DEBUG( sceneValue.dump() );
-        scene = Scene::fromValue( sceneValue );
-
-        return true;
+        if( Value::fromReadableWritable( *file, sceneValue ) )
+        {
+            //LOG_DEBUG( sceneValue.dump() );
+            scene = Scene::fromValue( sceneValue );
+            success = true;
+        }
     }
+    delete( file );
 
-    return false;
+    return success;
 }
 
 bool KiamaFS::request( const Vector< SceneRequest >& requests )
@@ -129,30 +132,42 @@ void KiamaFS::handleRequest( const SceneRequest& request )
         }
     }
 
-    LiteStream filenameStream;
-    filenameStream << escapeBase64( m_coordinates.m_worldID ).substr( 0, 8 ) << "_" << m_coordinates.m_x << "_" << m_coordinates.m_y << ".scn";
+    save( currentScene );
+}
+
+void KiamaFS::save( const World::Scene& scene )
+{
+    String filename( sceneFilename() );
 
-    LOG_DEBUG( "Attempting to save " + filenameStream.str() + " with KiamaFS" );
+    LOG_DEBUG( "Attempting to save " + filename + " with KiamaFS" );
 
-    Agape::KiamaFS::File* file( m_fs.file( filenameStream.str() ) );
+    Agape::KiamaFS::File* file( m_fs.file( filename ) );
     if( file->open( Agape::KiamaFS::File::OpenMode::writeMode ) )
     {
         Value sceneValue;
-        currentScene.toValue( sceneValue );
+        scene.toValue( sceneValue );
         sceneValue.toReadableWritable( *file );
         file->commit();
     }
+    delete( file );
 
     /*
     if( !m_inIndex )
     {
         // Add to our copy of the index.
-        m_index[filenameStream.str()] = 0;
+        m_index[filename] = 0;
         m_inIndex = true;
     }
     */
 }
 
+String KiamaFS::sceneFilename()
+{
+    LiteStream filenameStream;
+    filenameStream << escapeBase64( m_coordinates.m_worldID ).substr( 0, 8 ) << "_" << m_coordinates.m_x << "_" << m_coordinates.m_y << ".scn";
+    return filenameStream.str();
+}
+
 } // namespace SceneLoaders
 
 } // namespace Agape
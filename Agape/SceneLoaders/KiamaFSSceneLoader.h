@@ -27,8 +27,11 @@ public:
     virtual bool request( const Vector< SceneRequest >& requests );
     virtual Vector< SceneRequest > getUpdates();
 
+    virtual void save( const World::Scene& scene );
+
 private:
     void handleRequest( const SceneRequest& request );
+    String sceneFilename();
 
     Agape::KiamaFS& m_fs;
     Map< String, int>& m_index;
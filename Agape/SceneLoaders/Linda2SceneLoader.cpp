@@ -2,12 +2,13 @@
 #include "Encryptors/Utils/SecureIdentifier.h"
 #include "Loggers/Logger.h"
 #include "Timers/Factories/TimerFactory.h"
+#include "Utils/LiteStream.h"
 #include "World/Scene.h"
 #include "World/SceneItem.h"
 #include "World/WorldCoordinates.h"
 #include "Collections.h"
 #include "Linda2SceneLoader.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "SceneLoader.h"
 #include "SceneRequest.h"
 #include "String.h"
@@ -25,6 +26,7 @@ namespace
     const int maxUpdates( 8 );
     //const int cacheTimeout( 5000 ); // ms
     const int cacheTimeout( 0 ); // ms
+    const int loadRetries( 1 ); // Loads can safely be asked again.
 } // Anonymous namespace
 
 namespace Agape
@@ -48,14 +50,9 @@ Linda2::Linda2( const Coordinates& coordinates,
   Native( _SceneLoader ),
   m_receiveRequests( receiveRequests ),
   m_tupleRouter( tupleRouter ),
-  m_timerFactory( timerFactory ),
   m_encrypted( encrypted ),
-  m_isLoading( false ),
-  m_currentItem( 0 ),
-  m_totalItems( -1 ),
-  m_currentScene( nullptr ),
-  m_isSavingAttribute( false ),
-  m_isDeletingAttributes( false ),
+  m_requester( tupleRouter, timerFactory, this ),
+  m_revalidation( 0 ),
   m_overflowed( false )
 {
     LOG_DEBUG( "Linda2SceneLoader: Created" );
@@ -77,6 +74,10 @@ Linda2::Linda2( const Coordinates& coordinates,
         m_coordinates.toRoutingCriteria( m_sceneItemSaveAttributeRoutingCriteria );
         m_tupleRouter.sendAddRoutingCriteriaRequest( m_sceneItemSaveAttributeRoutingCriteria );
 
+        m_sceneItemSaveAttributesRoutingCriteria.m_types.push_back( new Value( _SceneItemSaveAttributesResponse ) );
+        m_coordinates.toRoutingCriteria( m_sceneItemSaveAttributesRoutingCriteria );
+        m_tupleRouter.sendAddRoutingCriteriaRequest( m_sceneItemSaveAttributesRoutingCriteria );
+
         m_sceneItemDeleteAttributesRoutingCriteria.m_types.push_back( new Value( _SceneItemDeleteAttributesResponse ) );
         m_coordinates.toRoutingCriteria( m_sceneItemDeleteAttributesRoutingCriteria );
         m_tupleRouter.sendAddRoutingCriteriaRequest( m_sceneItemDeleteAttributesRoutingCriteria );
@@ -100,6 +101,7 @@ Linda2::~Linda2()
         m_tupleRouter.sendRemoveRoutingCriteriaRequest( m_sceneLoadResponseRoutingCriteria );
         m_tupleRouter.sendRemoveRoutingCriteriaRequest( m_sceneLoadResponseTransportRoutingCriteria );
         m_tupleRouter.sendRemoveRoutingCriteriaRequest( m_sceneItemSaveAttributeRoutingCriteria );
+        m_tupleRouter.sendRemoveRoutingCriteriaRequest( m_sceneItemSaveAttributesRoutingCriteria );
         m_tupleRouter.sendRemoveRoutingCriteriaRequest( m_sceneItemDeleteAttributesRoutingCriteria );
         m_tupleRouter.sendRemoveRoutingCriteriaRequest( m_invalidateCachedAssetRoutingCriteria );
     }
@@ -111,43 +113,38 @@ Linda2::~Linda2()
 
 bool Linda2::load( Scene& scene )
 {
-    bool success( true );
-
     scene.m_sceneItems.clear();
 
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _SceneLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _SceneLoadRequest );
+    Tuple tuple( request( _SceneLoadRequest ) );
     m_coordinates.toValue( tuple[_coordinates] );
 
-    m_isLoading = true;
-    m_currentItem = 0;
-    m_totalItems = -1;
-
-    m_currentScene = &scene;
-
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoader: Sending sceneLoadRequest" );
 #endif
-    m_sceneLoadResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    success = m_tupleRouter.route( tuple );
-    if( success ) success = m_sceneLoadResponse.getFuture().get();
+    // Each load has its own request ID, so several can be in flight at once,
+    // e.g. to create MiniMap or preload neighbouring scenes.
+    Tuple summary;
+    Vector< Tuple > items;
+    if( !m_requester.call( tuple, _SceneLoadResponse, _SceneSummary, summary, items, loadRetries ) )
+    {
+        return false;
+    }
 
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoader: All scene items received" );
 #endif
-    // Ignore any new incoming load responses, to allow other loaders to
-    // operate in parallel, e.g. to create MiniMap.
-    // FIXME: This is now used in SceneLoader, AssetLoader and PresenceLoader
-    // and feels nasty, as it requires loaders to be blocking to work properly.
-    // We should use a request ID system instead to distinguish
-    // request/response pairs from each other.
-    m_isLoading = false;
-    m_currentScene = nullptr;
-    // Scene now loaded.
+    Vector< Tuple >::const_iterator it( items.begin() );
+    for( ; it != items.end(); ++it )
+    {
+        if( scene.m_sceneItems.size() >= scene.maxItems() )
+        {
+            LOG_DEBUG( "Linda2SceneLoader: Warning: Scene too large. Items dropped." );
+            break;
+        }
+        scene.m_sceneItems.push_back( World::SceneItem::fromValue( (*it)[_sceneItem] ) );
+    }
 
-    return success;
+    return true;
 }
 
 void Linda2::save( const Scene& scene )
@@ -196,6 +193,60 @@ bool Linda2::overflowed()
     return false;
 }
 
+bool Linda2::requestRevalidation( const String& version )
+{
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "Linda2SceneLoader: Sending scene revalidate request" );
+#endif
+    Tuple tuple( request( _SceneRevalidateRequest ) );
+    m_coordinates.toValue( tuple[_coordinates] );
+    tuple[_version] = version;
+
+    // Unlike the other requests, we don't wait on the reply here. It's
+    // collected as the router is pumped, by getUpdates() for instance.
+    m_requester.cancel( m_revalidation );
+    m_revalidationVersion = version;
+    m_revalidation = m_requester.send( tuple, _SceneRevalidateResponse, String(), loadRetries );
+    return( m_revalidation != 0 );
+}
+
+bool Linda2::getRevalidation( bool& current, Scene& scene )
+{
+    if( ( m_revalidation == 0 ) || !m_requester.ready( m_revalidation ) )
+    {
+        return false;
+    }
+
+    Tuple reply;
+    bool success( m_requester.get( m_revalidation, reply ) );
+    m_revalidation = 0;
+    if( !success )
+    {
+        LOG_DEBUG( "Linda2SceneLoader: Unable to revalidate scene" );
+        return false;
+    }
+
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "Linda2SceneLoader: Received scene revalidate response" );
+#endif
+    // Only the version, unless the scene has changed.
+    Value response;
+    response[_version] = reply[_version];
+    if( reply.hasValue( _sceneItems ) )
+    {
+        response[_sceneItems] = reply[_sceneItems];
+    }
+
+    current = ( response[_version] == m_revalidationVersion );
+    if( !current )
+    {
+        scene = Scene::fromValue( response );
+        scene.m_coordinates = m_coordinates;
+    }
+
+    return true;
+}
+
 bool Linda2::hasSceneItemAttribute( const String& snowflake,
                                     const String& name )
 {
@@ -221,17 +272,13 @@ bool Linda2::createSceneItemAttribute( const String& snowflake,
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoader: Sending scene item create attribute request" );
 #endif
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _SceneLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _SceneItemCreateAttributeRequest );
+    Tuple tuple( request( _SceneItemCreateAttributeRequest ) );
     m_coordinates.toValue( tuple[_coordinates] );
     tuple[_snowflake] = snowflake;
     tuple[_name] = name;
     
-    m_sceneItemCreateAttributeResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_sceneItemCreateAttributeResponse.getFuture().get();
-    return false;
+    Tuple reply;
+    return m_requester.call( tuple, _SceneItemCreateAttributeResponse, reply );
 }
 
 bool Linda2::loadSceneItemAttribute( const String& snowflake,
@@ -246,17 +293,19 @@ bool Linda2::loadSceneItemAttribute( const String& snowflake,
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoader: Sending scene item load attribute request" );
 #endif
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _SceneLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _SceneItemLoadAttributeRequest );
+    Tuple tuple( request( _SceneItemLoadAttributeRequest ) );
     m_coordinates.toValue( tuple[_coordinates] );
     tuple[_snowflake] = snowflake;
     tuple[_name] = name;
 
-    m_sceneItemLoadAttributeResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_sceneItemLoadAttributeResponse.getFuture().get( value );
-    return false;
+    Tuple reply;
+    if( !m_requester.call( tuple, _SceneItemLoadAttributeResponse, reply, loadRetries ) )
+    {
+        return false;
+    }
+
+    value = reply[_attribute];
+    return true;
 }
 
 bool Linda2::saveSceneItemAttribute( const String& snowflake,
@@ -270,21 +319,14 @@ bool Linda2::saveSceneItemAttribute( const String& snowflake,
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoader: Sending scene item save attribute request" );
 #endif
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _SceneLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _SceneItemSaveAttributeRequest );
+    Tuple tuple( request( _SceneItemSaveAttributeRequest ) );
     m_coordinates.toValue( tuple[_coordinates] );
     tuple[_snowflake] = snowflake;
     tuple[_name] = name;
     tuple[_attribute] = value;
 
-    m_isSavingAttribute = true;
-    m_saveDeleteSnowflake = snowflake;
-    m_saveAttributeName = name;
-    m_sceneItemSaveAttributeResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_sceneItemSaveAttributeResponse.getFuture().get();
-    return false;
+    Tuple reply;
+    return m_requester.call( tuple, _SceneItemSaveAttributeResponse, reply );
 }
 
 bool Linda2::deleteSceneItemAttributes( const String& snowflake )
@@ -296,18 +338,58 @@ bool Linda2::deleteSceneItemAttributes( const String& snowflake )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoader: Sending scene item delete attribute request" );
 #endif
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _SceneLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _SceneItemDeleteAttributesRequest );
+    Tuple tuple( request( _SceneItemDeleteAttributesRequest ) );
     m_coordinates.toValue( tuple[_coordinates] );
     tuple[_snowflake] = snowflake;
     
-    m_isDeletingAttributes = true;
-    m_saveDeleteSnowflake = snowflake;
-    m_sceneItemDeleteAttributesResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_sceneItemDeleteAttributesResponse.getFuture().get();
-    return false;
+    Tuple reply;
+    return m_requester.call( tuple, _SceneItemDeleteAttributesResponse, reply );
+}
+
+bool Linda2::writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes )
+{
+    if( writes.empty() )
+    {
+        return true;
+    }
+
+    Tuple tuple( request( _SceneItemSaveAttributesRequest ) );
+    m_coordinates.toValue( tuple[_coordinates] );
+
+    // As for single creates and saves, cache locally even if the remote
+    // request eventually fails.
+    Value& attributes( tuple[_attributes] );
+    Vector< struct AttributeWrite >::const_iterator it( writes.begin() );
+    for( ; it != writes.end(); ++it )
+    {
+        Value* attribute( new Value );
+        ( *attribute )[_snowflake] = it->m_snowflake;
+        ( *attribute )[_name] = it->m_name;
+        ( *attribute )[_createIfAbsent] = it->m_create ? 1 : 0;
+        if( it->m_save )
+        {
+            // Attributes that are only created carry no value.
+            ( *attribute )[_attribute] = it->m_value;
+            saveToCache( it->m_snowflake, it->m_name, it->m_value );
+        }
+        else
+        {
+            Value cached;
+            if( !loadFromCache( it->m_snowflake, it->m_name, cached ) )
+            {
+                saveToCache( it->m_snowflake, it->m_name, Value() );
+            }
+        }
+        attributes.push_back( attribute );
+    }
+
+#ifdef LOG_LOADERS
+    LiteStream stream;
+    stream << "Linda2SceneLoader: Sending scene item save attributes request for " << (int)writes.size() << " attributes";
+    LOG_DEBUG( stream.str() );
+#endif
+    Tuple reply;
+    return m_requester.call( tuple, _SceneItemSaveAttributesResponse, reply );
 }
 
 void Linda2::invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset )
@@ -341,42 +423,34 @@ bool Linda2::accept( Agape::Linda2::Tuple& tuple )
 {
     bool handled( false );
 
-    if( ( TupleRouter::tupleType( tuple ) == _SceneSummary ) && m_isLoading )
+    // Attribute changes are cached whoever made them, as we're also snooping
+    // others' changes. Ours will already have been cached when requested.
+    if( ( TupleRouter::tupleType( tuple ) == _SceneItemLoadAttributeResponse ) ||
+        ( TupleRouter::tupleType( tuple ) == _SceneItemSaveAttributeResponse ) )
     {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2SceneLoader: Received scene summary" );
-#endif
-        m_totalItems = tuple[_totalItems];
-
-        if( m_currentItem == m_totalItems ) // Needed where totalItems == 0!
+        if( (int)tuple[_success] == 1 )
         {
-            m_sceneLoadResponse.set();
+            saveToCache( tuple[_snowflake], tuple[_name], tuple[_attribute] );
         }
-
-        handled = true;
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _SceneLoadResponse ) && m_isLoading && m_currentScene )
+    else if( TupleRouter::tupleType( tuple ) == _SceneItemSaveAttributesResponse )
     {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2SceneLoader: Received scene item" );
-#endif
-        if( m_currentScene->m_sceneItems.size() < m_currentScene->maxItems() )
+        const Value& attributes( tuple[_attributes] );
+        ConstListIterator it( attributes.listBegin() );
+        for( ; it != attributes.listEnd(); ++it )
         {
-            SceneItem sceneItem( World::SceneItem::fromValue( tuple[_sceneItem] ) );
-            m_currentScene->m_sceneItems.push_back( sceneItem );
+            if( ( (int)( **it )[_success] == 1 ) && ( **it ).hasValue( _attribute ) )
+            {
+                saveToCache( ( **it )[_snowflake], ( **it )[_name], ( **it )[_attribute] );
+            }
         }
-        else
-        {
-            LOG_DEBUG( "Linda2SceneLoader: Warning: Scene too large. Items dropped." );
-        }
-        ++m_currentItem;
-
-        if( m_currentItem == m_totalItems )
+    }
+    else if( TupleRouter::tupleType( tuple ) == _SceneItemDeleteAttributesResponse )
+    {
+        if( (int)tuple[_success] == 1 )
         {
-            m_sceneLoadResponse.set();
+            deleteFromCache( tuple[_snowflake] );
         }
-
-        handled = true;
     }
     else if( m_receiveRequests && ( TupleRouter::tupleType( tuple ) == _SceneResponse ) )
     {
@@ -396,68 +470,6 @@ bool Linda2::accept( Agape::Linda2::Tuple& tuple )
 
         handled = true;
     }
-    else if( TupleRouter::tupleType( tuple ) == _SceneItemCreateAttributeResponse )
-    {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2SceneLoader: Received scene item create attribute response" );
-#endif
-        m_sceneItemCreateAttributeResponse.set( tuple[_success] );
-        handled = true;
-    }
-    else if( TupleRouter::tupleType( tuple ) == _SceneItemLoadAttributeResponse )
-    {
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2SceneLoader: Received scene item load attribute response" );
-#endif
-        m_sceneItemLoadAttributeResponse.set( tuple[_success], tuple[_attribute] );
-        handled = true;
-
-        // Here (and below) we will have already saved the value to the cache
-        // if we initiated the action, however we're also snooping others'
-        // attribute changes, so we still need to do this here to cache
-        // those changes.
-        if( (int)tuple[_success] == 1 )
-        {
-            saveToCache( tuple[_snowflake], tuple[_name], tuple[_attribute] );
-        }
-    }
-    else if( TupleRouter::tupleType( tuple ) == _SceneItemSaveAttributeResponse )
-    {
-        if( m_isSavingAttribute &&
-            ( tuple[_snowflake] == m_saveDeleteSnowflake ) &&
-            ( tuple[_name] == m_saveAttributeName ) ) // Item and attribute match what we're waiting for.
-        {
-#ifdef LOG_LOADERS
-            LOG_DEBUG( "Linda2SceneLoader: Received scene item save attribute response" );
-#endif
-            m_sceneItemSaveAttributeResponse.set( tuple[_success] );
-            m_isSavingAttribute = false;
-            handled = true;
-        }
-
-        if( (int)tuple[_success] == 1 )
-        {
-            saveToCache( tuple[_snowflake], tuple[_name], tuple[_attribute] );
-        }
-    }
-    else if( TupleRouter::tupleType( tuple ) == _SceneItemDeleteAttributesResponse )
-    {
-        if( m_isDeletingAttributes &&
-            ( tuple[_snowflake] == m_saveDeleteSnowflake ) ) // Item and attribute match what we're waiting for.
-        {
-#ifdef LOG_LOADERS
-            LOG_DEBUG( "Linda2SceneLoader: Received scene item delete attributes response" );
-#endif
-            m_sceneItemDeleteAttributesResponse.set( tuple[_success] );
-            m_isDeletingAttributes = false;
-            handled = true;
-        }
-
-        if( (int)tuple[_success] == 1 )
-        {
-            deleteFromCache( tuple[_snowflake] );
-        }
-    }
     else if( m_receiveRequests && ( TupleRouter::tupleType( tuple ) == _InvalidateCachedAsset ) )
     {
 #ifdef LOG_LOADERS
@@ -479,7 +491,16 @@ bool Linda2::accept( Agape::Linda2::Tuple& tuple )
         handled = true;
     }
 
-    return handled;
+    // Replies to our own requests, including attribute changes cached above.
+    return( m_requester.accept( tuple ) || handled );
+}
+
+Tuple Linda2::request( const String& type )
+{
+    Tuple tuple;
+    TupleRouter::setSourceActor( tuple, _SceneLoader );
+    TupleRouter::setTupleType( tuple, type );
+    return tuple;
 }
 
 void Linda2::saveToCache( const String& snowflake, const String& name, const Value& value )
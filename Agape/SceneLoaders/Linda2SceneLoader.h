@@ -3,7 +3,7 @@
 
 #include "Actors/NativeActors/NativeActor.h"
 #include "Collections.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "SceneLoader.h"
 #include "SceneRequest.h"
 #include "TupleRoutingCriteria.h"
@@ -53,6 +53,9 @@ public:
 
     virtual bool overflowed();
 
+    virtual bool requestRevalidation( const String& version );
+    virtual bool getRevalidation( bool& current, Scene& scene );
+
     virtual bool hasSceneItemAttribute( const String& snowflake,
                                         const String& name );
     virtual bool createSceneItemAttribute( const String& snowflake,
@@ -64,6 +67,7 @@ public:
                                          const String& name,
                                          const Value& value );
     virtual bool deleteSceneItemAttributes( const String& snowflake );
+    virtual bool writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes );
 
     virtual void invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset );
     virtual Vector< struct InvalidatedAsset > getInvalidatedAssets();
@@ -76,34 +80,25 @@ private:
     void deleteFromCache( const String& snowflake );
     void purgeCache();
 
+    Tuple request( const String& type );
+
     bool m_receiveRequests;
     TupleRouter& m_tupleRouter;
-    Timers::Factory& m_timerFactory;
     bool m_encrypted;
 
-    bool m_isLoading;
-    int m_currentItem;
-    int m_totalItems;
+    Requester m_requester;
 
     TupleRoutingCriteria m_sceneLoadResponseRoutingCriteria;
     TupleRoutingCriteria m_sceneLoadResponseTransportRoutingCriteria;
     TupleRoutingCriteria m_sceneItemSaveAttributeRoutingCriteria;
+    TupleRoutingCriteria m_sceneItemSaveAttributesRoutingCriteria;
     TupleRoutingCriteria m_sceneItemDeleteAttributesRoutingCriteria;
 
-    Scene* m_currentScene;
-
     Vector< SceneRequest > m_updates;
 
-    bool m_isSavingAttribute;
-    bool m_isDeletingAttributes;
-    String m_saveDeleteSnowflake;
-    String m_saveAttributeName;
-
-    Promise m_sceneLoadResponse;
-    Promise m_sceneItemCreateAttributeResponse;
-    Promise m_sceneItemLoadAttributeResponse;
-    Promise m_sceneItemSaveAttributeResponse;
-    Promise m_sceneItemDeleteAttributesResponse;
+    // Revalidation is answered without blocking, and collected later.
+    int m_revalidation; // A Requester handle, or 0.
+    String m_revalidationVersion;
 
     bool m_overflowed;
 
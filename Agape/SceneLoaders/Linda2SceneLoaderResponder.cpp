@@ -4,6 +4,7 @@
 #include "World/SceneItem.h"
 #include "World/WorldCoordinates.h"
 #include "Linda2SceneLoaderResponder.h"
+#include "Reply.h"
 #include "SceneLoader.h"
 #include "SceneRequest.h"
 #include "String.h"
@@ -50,6 +51,11 @@ bool Linda2Responder::accept( Tuple& tuple )
         handleRequest( tuple );
         handled = true;
     }
+    else if( TupleRouter::tupleType( tuple ) == _SceneRevalidateRequest )
+    {
+        handleRevalidateRequest( tuple );
+        handled = true;
+    }
     else if( TupleRouter::tupleType( tuple ) == _SceneItemCreateAttributeRequest )
     {
         handleCreateAttributeRequest( tuple );
@@ -65,6 +71,11 @@ bool Linda2Responder::accept( Tuple& tuple )
         handleSaveAttributeRequest( tuple );
         handled = true;
     }
+    else if( TupleRouter::tupleType( tuple ) == _SceneItemSaveAttributesRequest )
+    {
+        handleSaveAttributesRequest( tuple );
+        handled = true;
+    }
     else if( TupleRouter::tupleType( tuple ) == _SceneItemDeleteAttributesRequest )
     {
         handleDeleteAttributesRequest( tuple );
@@ -97,13 +108,8 @@ void Linda2Responder::loadScene( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2SceneLoaderResponder: Sending SceneSummary" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _SceneLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _SceneSummary );
-    response[_totalItems] = (int)scene.m_sceneItems.size();
-    m_tupleRouter.route( response );
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    reply.sendSummary( _SceneSummary, (int)scene.m_sceneItems.size(), true );
 
     Vector< SceneItem >::const_iterator it( scene.m_sceneItems.begin() );
     for( ; it != scene.m_sceneItems.end(); ++it )
@@ -111,13 +117,9 @@ void Linda2Responder::loadScene( const Tuple& tuple )
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2SceneLoaderResponder: Sending SceneLoadResponse" );
 #endif
-        Tuple sceneItemTuple;
-        TupleRouter::setSourceActor( sceneItemTuple, _SceneLoaderResponder );
-        TupleRouter::setSourceID( sceneItemTuple, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( sceneItemTuple, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( sceneItemTuple, _SceneLoadResponse );
+        Tuple sceneItemTuple( reply.tuple( _SceneLoadResponse ) );
         it->toValue( sceneItemTuple[_sceneItem] );
-        m_tupleRouter.route( sceneItemTuple );
+        reply.send( sceneItemTuple );
     }
 
     delete( sceneLoader );
@@ -138,24 +140,52 @@ void Linda2Responder::handleRequest( const Tuple& tuple )
     delete( sceneLoader );
 
     // FIXME: ACK/NAK?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _SceneLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _SceneResponse );
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneResponse ) );
     request.m_originatorID = TupleRouter::sourceID( tuple );
     request.toTuple( response );
     request.m_coordinates.toValue( response[_coordinates] );
-    m_tupleRouter.route( response );
+    reply.send( response );
+}
+
+void Linda2Responder::handleRevalidateRequest( const Tuple& tuple )
+{
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "Linda2SceneLoaderResponder: Handling SceneRevalidateRequest" );
+#endif
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneRevalidateResponse ) );
+
+    Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
+    SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates ) );
+
+    Scene scene;
+    bool success( sceneLoader->load( scene ) );
+    delete( sceneLoader );
+
+    // The scene's items are sent back, in one tuple, only if they've changed
+    // since the requester's copy.
+    response[_success] = success ? 1 : 0;
+    if( success )
+    {
+        String version( scene.version() );
+        response[_version] = version;
+        if( version != (const String&)tuple[_version] )
+        {
+            Value sceneValue;
+            scene.toValue( sceneValue );
+            response[_sceneItems] = sceneValue[_sceneItems];
+        }
+    }
+    coordinates.toValue( response[_coordinates] );
+
+    reply.send( response );
 }
 
 void Linda2Responder::handleCreateAttributeRequest( const Tuple& tuple )
 {
-    Tuple response;
-    TupleRouter::setSourceActor( response, _SceneLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _SceneItemCreateAttributeResponse );
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneItemCreateAttributeResponse ) );
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
     SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates ) );
@@ -167,16 +197,13 @@ void Linda2Responder::handleCreateAttributeRequest( const Tuple& tuple )
     
     delete( sceneLoader );
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::handleLoadAttributeRequest( const Tuple& tuple )
 {
-    Tuple response;
-    TupleRouter::setSourceActor( response, _SceneLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _SceneItemLoadAttributeResponse );
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneItemLoadAttributeResponse ) );
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
     SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates ) );
@@ -190,16 +217,13 @@ void Linda2Responder::handleLoadAttributeRequest( const Tuple& tuple )
     
     delete( sceneLoader );
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::handleSaveAttributeRequest( const Tuple& tuple )
 {
-    Tuple response;
-    TupleRouter::setSourceActor( response, _SceneLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _SceneItemSaveAttributeResponse );
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneItemSaveAttributeResponse ) );
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
     SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates ) );
@@ -212,16 +236,64 @@ void Linda2Responder::handleSaveAttributeRequest( const Tuple& tuple )
     
     delete( sceneLoader );
 
-    m_tupleRouter.route( response );
+    reply.send( response );
+}
+
+void Linda2Responder::handleSaveAttributesRequest( const Tuple& tuple )
+{
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneItemSaveAttributesResponse ) );
+
+    Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
+    SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates ) );
+
+    coordinates.toValue( response[_coordinates] );
+
+    // Each attribute is created if asked and absent, and saved if it carries
+    // a value, in turn. Saved values are echoed with their own success so that
+    // snooping clients only cache those that were saved.
+    bool success( true );
+    Value& attributes( response[_attributes] );
+    const Value& requested( tuple[_attributes] );
+    ConstListIterator it( requested.listBegin() );
+    for( ; it != requested.listEnd(); ++it )
+    {
+        const Value& attribute( **it );
+        const String& snowflake( attribute[_snowflake] );
+        const String& name( attribute[_name] );
+
+        bool saved( true );
+        if( ( (int)attribute[_createIfAbsent] == 1 ) && !sceneLoader->hasSceneItemAttribute( snowflake, name ) )
+        {
+            saved = sceneLoader->createSceneItemAttribute( snowflake, name );
+        }
+        if( saved && attribute.hasValue( _attribute ) )
+        {
+            saved = sceneLoader->saveSceneItemAttribute( snowflake, name, attribute[_attribute] );
+        }
+        success = success && saved;
+
+        Value* savedAttribute( new Value );
+        ( *savedAttribute )[_snowflake] = attribute[_snowflake];
+        ( *savedAttribute )[_name] = attribute[_name];
+        if( attribute.hasValue( _attribute ) )
+        {
+            ( *savedAttribute )[_attribute] = attribute[_attribute];
+        }
+        ( *savedAttribute )[_success] = saved ? 1 : 0;
+        attributes.push_back( savedAttribute );
+    }
+    response[_success] = success ? 1 : 0;
+
+    delete( sceneLoader );
+
+    reply.send( response );
 }
 
 void Linda2Responder::handleDeleteAttributesRequest( const Tuple& tuple )
 {
-    Tuple response;
-    TupleRouter::setSourceActor( response, _SceneLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _SceneItemDeleteAttributesResponse );
+    Reply reply( m_tupleRouter, tuple, _SceneLoaderResponder );
+    Tuple response( reply.tuple( _SceneItemDeleteAttributesResponse ) );
 
     Coordinates coordinates( Coordinates::fromValue( tuple[_coordinates] ) );
     SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates ) );
@@ -233,7 +305,7 @@ void Linda2Responder::handleDeleteAttributesRequest( const Tuple& tuple )
     
     delete( sceneLoader );
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 } // namespace SceneLoaders
@@ -43,10 +43,12 @@ private:
     void loadScene( const Tuple& tuple );
     
     void handleRequest( const Tuple& tuple );
+    void handleRevalidateRequest( const Tuple& tuple );
 
     void handleCreateAttributeRequest( const Tuple& tuple );
     void handleLoadAttributeRequest( const Tuple& tuple );
     void handleSaveAttributeRequest( const Tuple& tuple );
+    void handleSaveAttributesRequest( const Tuple& tuple );
     void handleDeleteAttributesRequest( const Tuple& tuple );
 
     TupleRouter& m_tupleRouter;
@@ -1,6 +1,8 @@
 #include "World/WorldCoordinates.h"
 #include "Collections.h"
 #include "SceneLoader.h"
+#include "String.h"
+#include "Value.h"
 
 using namespace Agape::World;
 
@@ -18,6 +20,30 @@ SceneLoader::~SceneLoader()
 {
 }
 
+bool SceneLoader::writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes )
+{
+    bool success( true );
+
+    Vector< struct AttributeWrite >::const_iterator it( writes.begin() );
+    for( ; it != writes.end(); ++it )
+    {
+        bool written( true );
+        if( it->m_create && !hasSceneItemAttribute( it->m_snowflake, it->m_name ) )
+        {
+            written = createSceneItemAttribute( it->m_snowflake, it->m_name );
+        }
+
+        if( written && it->m_save )
+        {
+            written = saveSceneItemAttribute( it->m_snowflake, it->m_name, it->m_value );
+        }
+
+        success = success && written;
+    }
+
+    return success;
+}
+
 Vector< struct SceneLoader::InvalidatedAsset > SceneLoader::getInvalidatedAssets()
 {
     return Vector< struct InvalidatedAsset >();
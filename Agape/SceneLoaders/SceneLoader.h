@@ -4,6 +4,8 @@
 #include "World/WorldCoordinates.h"
 #include "Collections.h"
 #include "SceneRequest.h"
+#include "String.h"
+#include "Value.h"
 
 using namespace Agape::World;
 
@@ -25,6 +27,16 @@ public:
         String m_originatorID;
     };
 
+    // Creates an attribute if it doesn't exist, and/or saves its value.
+    struct AttributeWrite
+    {
+        String m_snowflake;
+        String m_name;
+        Value m_value;
+        bool m_create;
+        bool m_save;
+    };
+
     static bool noReceiveRequests;
 
     SceneLoader( const Coordinates& coordinates );
@@ -36,6 +48,26 @@ public:
     
     virtual bool overflowed() { return false; }; // If implemented, should clear flag on retrieve if set.
 
+    // Replaces the stored scene, for loaders that keep one locally.
+    virtual void save( const Scene& scene ) {};
+
+    // Asks, without waiting, whether the scene is still at "version" (see
+    // Scene::version()). Returns false if the loader can't ask.
+    virtual bool requestRevalidation( const String& version ) { return false; };
+
+    // Once the answer has arrived, returns true and sets "current", and if
+    // the scene has changed, "scene" to what it is now.
+    virtual bool getRevalidation( bool& current, Scene& scene ) { return false; };
+
+    // Starts fetching the scene into the loader's local copy, without
+    // waiting, so that a later load() needn't wait on the server. Returns
+    // false if the loader keeps no copy, or can't ask.
+    virtual bool prefetch() { return false; };
+
+    // Once the fetch has arrived and been kept, returns true and sets "scene"
+    // to it, e.g. so that its assets can be fetched too.
+    virtual bool getPrefetched( Scene& scene ) { return false; };
+
     virtual bool hasSceneItemAttribute( const String& snowflake,
                                         const String& name ) { return false; };
     virtual bool createSceneItemAttribute( const String& snowflake,
@@ -48,6 +80,13 @@ public:
                                          const Value& value ) { return false; };
     virtual bool deleteSceneItemAttributes( const String& snowflake ) { return false; };
 
+    // Performs a batch of attribute writes. Loaders that can should do so in
+    // a single request.
+    virtual bool writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes );
+
+    // Performs any attribute writes held back by the loader.
+    virtual bool flushSceneItemAttributes() { return true; };
+
     virtual void invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset ) {};
     virtual Vector< struct InvalidatedAsset > getInvalidatedAssets();
 
@@ -0,0 +1,217 @@
+#include "Loggers/Logger.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "World/Scene.h"
+#include "World/WorldCoordinates.h"
+#include "Collections.h"
+#include "SceneLoader.h"
+#include "SceneRequest.h"
+#include "String.h"
+#include "Value.h"
+#include "WriteBehindSceneLoader.h"
+
+namespace
+{
+    // Keeps a runaway program's batch to a sensible size.
+    const int _maxPending( 64 );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace SceneLoaders
+{
+
+WriteBehind::WriteBehind( const World::Coordinates& coordinates,
+                          Factory& backingLoaderFactory ) :
+  SceneLoader( coordinates ),
+  m_backingLoader( backingLoaderFactory.makeLoader( coordinates ) ),
+  m_numPending( 0 )
+{
+}
+
+WriteBehind::~WriteBehind()
+{
+    flushSceneItemAttributes();
+    delete( m_backingLoader );
+}
+
+bool WriteBehind::load( World::Scene& scene )
+{
+    return( m_backingLoader->load( scene ) );
+}
+
+bool WriteBehind::request( const Vector< SceneRequest >& requests )
+{
+    return( m_backingLoader->request( requests ) );
+}
+
+Vector< SceneRequest > WriteBehind::getUpdates()
+{
+    return( m_backingLoader->getUpdates() );
+}
+
+bool WriteBehind::overflowed()
+{
+    return( m_backingLoader->overflowed() );
+}
+
+bool WriteBehind::hasSceneItemAttribute( const String& snowflake,
+                                         const String& name )
+{
+    Map< String, Map< String, struct AttributeWrite > >::const_iterator it( m_pending.find( snowflake ) );
+    if( ( it != m_pending.end() ) && ( it->second.find( name ) != it->second.end() ) )
+    {
+        return true;
+    }
+
+    return( m_backingLoader->hasSceneItemAttribute( snowflake, name ) );
+}
+
+bool WriteBehind::createSceneItemAttribute( const String& snowflake,
+                                            const String& name )
+{
+    // Folded into the first save, or performed on its own if there's none
+    // before the flush.
+    pending( snowflake, name ).m_create = true;
+
+    if( m_numPending >= _maxPending )
+    {
+        return flushSceneItemAttributes();
+    }
+
+    return true;
+}
+
+bool WriteBehind::loadSceneItemAttribute( const String& snowflake,
+                                          const String& name,
+                                          Value& value )
+{
+    Map< String, Map< String, struct AttributeWrite > >::const_iterator it( m_pending.find( snowflake ) );
+    if( it != m_pending.end() )
+    {
+        Map< String, struct AttributeWrite >::const_iterator writeIt( it->second.find( name ) );
+        if( writeIt != it->second.end() )
+        {
+            value = writeIt->second.m_value;
+            return true;
+        }
+    }
+
+    return( m_backingLoader->loadSceneItemAttribute( snowflake, name, value ) );
+}
+
+bool WriteBehind::saveSceneItemAttribute( const String& snowflake,
+                                          const String& name,
+                                          const Value& value )
+{
+    struct AttributeWrite& write( pending( snowflake, name ) );
+    write.m_value = value;
+    write.m_save = true;
+
+    if( m_numPending >= _maxPending )
+    {
+        return flushSceneItemAttributes();
+    }
+
+    return true;
+}
+
+bool WriteBehind::deleteSceneItemAttributes( const String& snowflake )
+{
+    Map< String, Map< String, struct AttributeWrite > >::iterator it( m_pending.find( snowflake ) );
+    if( it != m_pending.end() )
+    {
+        m_numPending -= it->second.size();
+        m_pending.erase( it );
+    }
+
+    return( m_backingLoader->deleteSceneItemAttributes( snowflake ) );
+}
+
+bool WriteBehind::writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes )
+{
+    Vector< struct AttributeWrite >::const_iterator it( writes.begin() );
+    for( ; it != writes.end(); ++it )
+    {
+        struct AttributeWrite& write( pending( it->m_snowflake, it->m_name ) );
+        write.m_create = write.m_create || it->m_create;
+        if( it->m_save )
+        {
+            write.m_value = it->m_value;
+            write.m_save = true;
+        }
+    }
+
+    if( m_numPending >= _maxPending )
+    {
+        return flushSceneItemAttributes();
+    }
+
+    return true;
+}
+
+bool WriteBehind::flushSceneItemAttributes()
+{
+    if( m_pending.empty() )
+    {
+        return true;
+    }
+
+    Vector< struct AttributeWrite > writes;
+    writes.reserve( m_numPending );
+    Map< String, Map< String, struct AttributeWrite > >::const_iterator it( m_pending.begin() );
+    for( ; it != m_pending.end(); ++it )
+    {
+        Map< String, struct AttributeWrite >::const_iterator writeIt( it->second.begin() );
+        for( ; writeIt != it->second.end(); ++writeIt )
+        {
+            writes.push_back( writeIt->second );
+        }
+    }
+
+    // Reads are served by the backing loader from here on. As for its own
+    // writes, it keeps the values locally even if they can't be written.
+    m_pending.clear();
+    m_numPending = 0;
+
+    if( !m_backingLoader->writeSceneItemAttributes( writes ) )
+    {
+        LOG_DEBUG( "WriteBehindSceneLoader: Unable to write scene item attributes" );
+        return false;
+    }
+
+    return true;
+}
+
+void WriteBehind::invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset )
+{
+    m_backingLoader->invalidateCachedAsset( invalidatedAsset );
+}
+
+Vector< struct SceneLoader::InvalidatedAsset > WriteBehind::getInvalidatedAssets()
+{
+    return( m_backingLoader->getInvalidatedAssets() );
+}
+
+struct SceneLoader::AttributeWrite& WriteBehind::pending( const String& snowflake, const String& name )
+{
+    Map< String, struct AttributeWrite >& writes( m_pending[snowflake] );
+    Map< String, struct AttributeWrite >::iterator it( writes.find( name ) );
+    if( it != writes.end() )
+    {
+        return it->second;
+    }
+
+    struct AttributeWrite& write( writes[name] );
+    write.m_snowflake = snowflake;
+    write.m_name = name;
+    write.m_create = false;
+    write.m_save = false;
+    ++m_numPending;
+
+    return write;
+}
+
+} // namespace SceneLoaders
+
+} // namespace Agape
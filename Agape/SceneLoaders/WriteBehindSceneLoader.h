@@ -0,0 +1,72 @@
+#ifndef AGAPE_SCENE_LOADERS_WRITE_BEHIND_H
+#define AGAPE_SCENE_LOADERS_WRITE_BEHIND_H
+
+#include "Collections.h"
+#include "SceneLoader.h"
+#include "SceneRequest.h"
+#include "String.h"
+#include "Value.h"
+
+namespace Agape
+{
+
+namespace World
+{
+class Coordinates;
+class Scene;
+} // namespace World
+
+namespace SceneLoaders
+{
+
+class Factory;
+
+// Holds back scene item attribute creates and saves, so that repeated writes
+// to an attribute (e.g. a Carlo loop incrementing "this.x") are merged, and
+// performs them in a single batch when flushed. Reads see writes not yet
+// performed. Everything else passes through to the backing loader.
+class WriteBehind : public SceneLoader
+{
+public:
+    WriteBehind( const World::Coordinates& coordinates,
+                 Factory& backingLoaderFactory );
+    ~WriteBehind(); // Flushes.
+
+    virtual bool load( World::Scene& scene );
+    virtual bool request( const Vector< SceneRequest >& requests );
+    virtual Vector< SceneRequest > getUpdates();
+
+    virtual bool overflowed();
+
+    virtual bool hasSceneItemAttribute( const String& snowflake,
+                                        const String& name );
+    virtual bool createSceneItemAttribute( const String& snowflake,
+                                           const String& name );
+    virtual bool loadSceneItemAttribute( const String& snowflake,
+                                         const String& name,
+                                         Value& value );
+    virtual bool saveSceneItemAttribute( const String& snowflake,
+                                         const String& name,
+                                         const Value& value );
+    virtual bool deleteSceneItemAttributes( const String& snowflake );
+    virtual bool writeSceneItemAttributes( const Vector< struct AttributeWrite >& writes );
+    virtual bool flushSceneItemAttributes();
+
+    virtual void invalidateCachedAsset( const struct InvalidatedAsset& invalidatedAsset );
+    virtual Vector< struct InvalidatedAsset > getInvalidatedAssets();
+
+private:
+    struct AttributeWrite& pending( const String& snowflake, const String& name );
+
+    SceneLoader* m_backingLoader;
+
+    // Writes not yet performed, by item snowflake then attribute name.
+    Map< String, Map< String, struct AttributeWrite > > m_pending;
+    int m_numPending;
+};
+
+} // namespace SceneLoaders
+
+} // namespace Agape
+
+#endif // AGAPE_SCENE_LOADERS_WRITE_BEHIND_H
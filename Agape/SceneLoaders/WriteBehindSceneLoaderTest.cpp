@@ -0,0 +1,290 @@
+#ifdef WRITE_BEHIND_SCENE_LOADER_TEST
+
+#include "Actors/NativeActors/NativeActor.h"
+#include "AssetLoaders/Factories/AssetLoadersFactory.h"
+#include "AssetLoaders/AssetLoader.h"
+#include "SceneLoaders/Factories/FileSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/Linda2SceneLoaderFactory.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "ValueLoaders/ValueLoader.h"
+#include "World/WorldCoordinates.h"
+#include "Collections.h"
+#include "FileWriter.h"
+#include "FunctionDispatcher.h"
+#include "Linda2SceneLoaderResponder.h"
+#include "ProgramManager.h"
+#include "SceneLoader.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+#include "Value.h"
+#include "WriteBehindSceneLoader.h"
+
+#include <iostream>
+#include <string>
+
+#include <stdlib.h>
+
+using namespace Agape;
+using Agape::Carlo::FunctionDispatcher;
+using Agape::Carlo::ProgramManager;
+using Agape::Linda2::Tuple;
+using Agape::Linda2::TupleDispatcher;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const int _iterations( 100 );
+    const int _runs( 3 );
+
+    // A scene item's program that counts in a loop, as a "this.x" value.
+    const char* _program( "actor Lamp\n"
+                          "receives Load\n"
+                          "creates value i\n"
+                          "makes i 0\n"
+                          "while i less than 100\n"
+                          "makes this.counter this.counter + 1\n"
+                          "makes i i + 1\n"
+                          "end\n"
+                          "end\n"
+                          "end\n" );
+
+    const char* _snowflake( "lamp" );
+
+    class MemoryLoader : public AssetLoader
+    {
+    public:
+        MemoryLoader( const World::Coordinates& coordinates, const String& name, const std::string& data ) :
+          AssetLoader( coordinates, name ),
+          m_data( data )
+        {
+        }
+
+        virtual bool open() { return true; }
+
+        virtual int read( char* data, int offset, int len )
+        {
+            int available( (int)m_data.size() - offset );
+            int count( len < available ? len : available );
+            if( count <= 0 ) return 0;
+            m_data.copy( data, count, offset );
+            return count;
+        }
+
+        virtual int size() { return m_data.size(); }
+
+        std::string m_data;
+    };
+
+    class ProgramFactory : public AssetLoaders::Factory
+    {
+    public:
+        virtual AssetLoader* makeLoader( const World::Coordinates& coordinates, const String& name )
+        {
+            return new MemoryLoader( coordinates, name, _program );
+        }
+    };
+
+    // The responder makes a loader for each request it handles, so counting
+    // those counts round-trips.
+    class Counting : public SceneLoaders::Factory
+    {
+    public:
+        Counting( SceneLoaders::Factory& factory ) :
+          m_factory( factory ),
+          m_roundTrips( 0 )
+        {
+        }
+
+        virtual SceneLoader* makeLoader( const World::Coordinates& coordinates, bool receiveRequests )
+        {
+            ++m_roundTrips;
+            return m_factory.makeLoader( coordinates, receiveRequests );
+        }
+
+        SceneLoaders::Factory& m_factory;
+        int m_roundTrips;
+    };
+
+    class Attribute : public ValueLoader
+    {
+    public:
+        Attribute( SceneLoader& sceneLoader, const String& snowflake, const String& name ) :
+          m_sceneLoader( sceneLoader ),
+          m_snowflake( snowflake ),
+          m_name( name )
+        {
+        }
+
+        virtual bool load( Value& value ) { return m_sceneLoader.loadSceneItemAttribute( m_snowflake, m_name, value ); }
+        virtual bool save( const Value& value ) { return m_sceneLoader.saveSceneItemAttribute( m_snowflake, m_name, value ); }
+
+        SceneLoader& m_sceneLoader;
+        String m_snowflake;
+        String m_name;
+    };
+
+    // As NativeActors::Thing, with the scene loader in place of Compositor.
+    class This : public Linda2::Actors::Native
+    {
+    public:
+        This( FunctionDispatcher& functionDispatcher, SceneLoader& sceneLoader ) :
+          Native( _this ),
+          m_functionDispatcher( functionDispatcher ),
+          m_sceneLoader( sceneLoader )
+        {
+            m_functionDispatcher.registerActor( this );
+        }
+
+        virtual ~This()
+        {
+            m_functionDispatcher.deregisterActor( this );
+        }
+
+        virtual bool getPersistableValue( Value& value, const String& name, const String& caller )
+        {
+            bool success( true );
+            if( !m_sceneLoader.hasSceneItemAttribute( caller, name ) )
+            {
+                success = m_sceneLoader.createSceneItemAttribute( caller, name );
+            }
+
+            if( success )
+            {
+                value.setValueLoader( new Attribute( m_sceneLoader, caller, name ) );
+                success = value.load();
+            }
+
+            return success;
+        }
+
+        virtual void flushPersistableValues()
+        {
+            m_sceneLoader.flushSceneItemAttributes();
+        }
+
+        FunctionDispatcher& m_functionDispatcher;
+        SceneLoader& m_sceneLoader;
+    };
+
+    String makeAttributesPath()
+    {
+        char path[] = "/tmp/WriteBehindSceneLoaderTestXXXXXX";
+        if( ::mkdtemp( path ) == nullptr ) return String();
+        return path;
+    }
+
+    // As the File loader expects of an existing item.
+    void makeItem( const String& attributesPath, const String& snowflake )
+    {
+        Value attributes;
+        attributes[_name] = snowflake;
+        FileWriter fileWriter( attributesPath + "/" + snowflake + ".sia", FileWriter::modeWrite );
+        attributes.toReadableWritable( fileWriter );
+    }
+
+    // Runs the program's handler a few times against a fresh store, with or
+    // without write-behind, returning the round-trips taken and the count
+    // stored.
+    int run( bool writeBehind, int& stored )
+    {
+        String attributesPath( makeAttributesPath() );
+        World::Coordinates coordinates;
+        makeItem( attributesPath, _snowflake );
+
+        Timers::Factories::HighRes timerFactory;
+        TupleDispatcher tupleDispatcher;
+        TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+        tupleRouter.setMyID( "test" );
+
+        SceneLoaders::Factories::File fileFactory( attributesPath, "scn", attributesPath, "sia" );
+        Counting countingFactory( fileFactory );
+        SceneLoaders::Linda2Responder responder( tupleRouter, countingFactory );
+        SceneLoaders::Factories::Linda2 linda2Factory( tupleRouter, timerFactory );
+
+        // As Compositor::render().
+        SceneLoader* sceneLoader( writeBehind ? new SceneLoaders::WriteBehind( coordinates, linda2Factory ) :
+                                                linda2Factory.makeLoader( coordinates, true ) );
+
+        FunctionDispatcher functionDispatcher;
+        This thisActor( functionDispatcher, *sceneLoader );
+        ProgramFactory programFactory;
+        ProgramManager programManager( tupleRouter, functionDispatcher );
+
+        programManager.load( programFactory, coordinates, _snowflake ); // Runs once.
+        for( int run( 1 ); run < _runs; ++run )
+        {
+            Tuple tuple;
+            TupleRouter::setTupleType( tuple, _Load );
+            tupleRouter.route( tuple );
+        }
+
+        int roundTrips( countingFactory.m_roundTrips );
+
+        // What the backing store has, bypassing the Linda2 loader's cache.
+        SceneLoader* fileLoader( fileFactory.makeLoader( coordinates, true ) );
+        Value value;
+        stored = fileLoader->loadSceneItemAttribute( _snowflake, "counter", value ) ? (int)value : -1;
+        delete( fileLoader );
+
+        programManager.unload( _snowflake );
+        delete( sceneLoader );
+
+        return roundTrips;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    int storedDirect( 0 );
+    int storedWriteBehind( 0 );
+    int direct( run( false, storedDirect ) );
+    int writeBehind( run( true, storedWriteBehind ) );
+    std::cout << _runs << " runs of " << _iterations << " increments: " << direct << " round-trips direct, "
+              << writeBehind << " with write-behind" << std::endl;
+
+    success = check( "Direct", storedDirect == ( _runs * _iterations ) ) && success;
+    success = check( "Write-behind", storedWriteBehind == ( _runs * _iterations ) ) && success;
+
+    // A lookup for the new attribute, then one batch per run, its first
+    // creating the attribute.
+    success = check( "Round-trips", writeBehind == ( _runs + 1 ) ) && success;
+
+    // Deleting an item drops its pending writes rather than resurrecting its
+    // attributes on the next flush.
+    {
+    String attributesPath( makeAttributesPath() );
+    World::Coordinates coordinates;
+    SceneLoaders::Factories::File fileFactory( attributesPath, "scn", attributesPath, "sia" );
+    makeItem( attributesPath, "door" );
+    SceneLoaders::WriteBehind sceneLoader( coordinates, fileFactory );
+    sceneLoader.createSceneItemAttribute( "door", "open" );
+    sceneLoader.saveSceneItemAttribute( "door", "open", 1 );
+    Value value;
+    bool pending( sceneLoader.loadSceneItemAttribute( "door", "open", value ) && ( (int)value == 1 ) );
+    SceneLoader* fileLoader( fileFactory.makeLoader( coordinates, true ) );
+    bool notWritten( !fileLoader->hasSceneItemAttribute( "door", "open" ) );
+    sceneLoader.deleteSceneItemAttributes( "door" );
+    makeItem( attributesPath, "door" );
+    sceneLoader.flushSceneItemAttributes();
+    bool notResurrected( !fileLoader->hasSceneItemAttribute( "door", "open" ) );
+    delete( fileLoader );
+    success = check( "Delete", pending && notWritten && notResurrected ) && success;
+    }
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // WRITE_BEHIND_SCENE_LOADER_TEST
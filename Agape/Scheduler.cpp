@@ -0,0 +1,122 @@
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Timers/TimerWheel.h"
+#include "Runnable.h"
+#include "Scheduler.h"
+
+namespace
+{
+    const long _idleIntervalMs( 10 ); // As often as TerminalSimulator used to run the client.
+    const long _busyPassUs( 500 ); // A pass that took this long has probably left work for the next.
+} // Anonymous namespace
+
+namespace Agape
+{
+
+Scheduler::Scheduler( Timers::Factory& timerFactory, Timers::Wheel& timerWheel ) :
+  m_timerWheel( timerWheel ),
+  m_idleTimer( timerFactory.makeTimer() ),
+  m_passTimer( timerFactory.makeTimer() ),
+  m_busy( false )
+{
+}
+
+Scheduler::~Scheduler()
+{
+    delete( m_passTimer );
+    delete( m_idleTimer );
+}
+
+void Scheduler::add( Runnable& runnable, enum Priority priority )
+{
+    Entry entry;
+    entry.m_runnable = &runnable;
+    entry.m_priority = priority;
+
+    Vector< Entry >::iterator it( m_entries.begin() );
+    while( ( it != m_entries.end() ) && ( it->m_priority <= priority ) )
+    {
+        ++it;
+    }
+    m_entries.insert( it, entry );
+}
+
+bool Scheduler::run()
+{
+    long startUs( m_passTimer->us() );
+
+    Vector< Entry >::iterator it( m_entries.begin() );
+    for( ; ( it != m_entries.end() ) && ( it->m_priority <= audio ); ++it )
+    {
+        it->m_runnable->run();
+    }
+
+    bool ready( m_busy );
+    bool urgent( false );
+    Vector< Entry >::const_iterator readyIt( m_entries.begin() );
+    for( ; readyIt != m_entries.end(); ++readyIt )
+    {
+        if( readyIt->m_runnable->ready() )
+        {
+            ready = true;
+            urgent = urgent || ( readyIt->m_priority <= audio );
+        }
+    }
+
+    bool idleDue( m_idleTimer->ms() >= _idleIntervalMs );
+    if( !ready && !idleDue )
+    {
+        m_busy = false;
+        return false;
+    }
+
+    // Background work waits for input and audio, but only for so long.
+    bool runBackground( !urgent || idleDue );
+    for( ; it != m_entries.end(); ++it )
+    {
+        if( runBackground || ( it->m_priority != background ) )
+        {
+            it->m_runnable->run();
+        }
+    }
+
+    if( runBackground )
+    {
+        m_idleTimer->reset();
+    }
+
+    m_busy = ( ( m_passTimer->us() - startUs ) >= _busyPassUs );
+
+    return true;
+}
+
+long Scheduler::msUntilReady()
+{
+    if( m_busy ) return 0;
+
+    Vector< Entry >::const_iterator it( m_entries.begin() );
+    for( ; it != m_entries.end(); ++it )
+    {
+        if( it->m_runnable->ready() ) return 0;
+    }
+
+    long untilMs( _idleIntervalMs - m_idleTimer->ms() );
+    long wheelMs( m_timerWheel.msUntilNext() );
+    if( ( wheelMs >= 0 ) && ( wheelMs < untilMs ) )
+    {
+        untilMs = wheelMs;
+    }
+
+    return( untilMs > 0 ? untilMs : 0 );
+}
+
+void Scheduler::sleep()
+{
+    long sleepMs( msUntilReady() );
+    if( sleepMs > 0 )
+    {
+        m_passTimer->usleep( sleepMs * 1000 );
+    }
+}
+
+} // namespace Agape
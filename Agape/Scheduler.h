@@ -0,0 +1,62 @@
+#ifndef AGAPE_SCHEDULER_H
+#define AGAPE_SCHEDULER_H
+
+#include "Collections.h"
+
+namespace Agape
+{
+
+namespace Timers
+{
+class Factory;
+class Wheel;
+} // namespace Timers
+
+class Runnable;
+class Timer;
+
+// Runs the client's runnables in priority order, but only when there's
+// something for them to do: one of them is ready, the last pass was busy, or
+// the idle interval has passed for those that can't tell us. In between the
+// main loop can sleep for msUntilReady().
+class Scheduler
+{
+public:
+    enum Priority // Highest first.
+    {
+        input, // Run on every pass, as that may be how input arrives.
+        audio, // Also run on every pass.
+        redraw,
+        background // Held back while input or audio is ready.
+    };
+
+    Scheduler( Timers::Factory& timerFactory, Timers::Wheel& timerWheel );
+    ~Scheduler();
+
+    // Runnables of the same priority run in the order they're added.
+    void add( Runnable& runnable, enum Priority priority );
+
+    bool run(); // Whether the pass did anything beyond polling.
+
+    long msUntilReady();
+    void sleep(); // For msUntilReady(), if supported by the timer.
+
+private:
+    struct Entry
+    {
+        Runnable* m_runnable;
+        enum Priority m_priority;
+    };
+
+    Vector< Entry > m_entries;
+
+    Timers::Wheel& m_timerWheel;
+    Timer* m_idleTimer;
+    Timer* m_passTimer;
+
+    bool m_busy;
+};
+
+} // namespace Agape
+
+#endif // AGAPE_SCHEDULER_H
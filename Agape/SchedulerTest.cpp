@@ -0,0 +1,414 @@
+#ifdef SCHEDULER_TEST
+
+#include "GraphicsDrivers/Headless.h"
+#include "InputDevices/InputDevice.h"
+#include "LineDrivers/LineDriver.h"
+#include "Lines/DirectLine.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Timers/TimerWheel.h"
+#include "ANSITerminal.h"
+#include "Collections.h"
+#include "Runnable.h"
+#include "Scheduler.h"
+#include "String.h"
+
+#include <iostream>
+
+using namespace Agape;
+
+namespace
+{
+    // Simulated costs, in us.
+    const long _passCostUs( 2 );
+    const long _pollCostUs( 5 );
+    const long _paintCostUs( 300 );
+    const long _loadCostUs( 5000 );
+
+    const int _loads( 400 );
+    const long _keyIntervalUs( 97000 ); // So keys arrive at every point in a load.
+    const long _idleUs( 10000000 );
+    const double _maxIdleCPU( 0.05 );
+    const long _maxIdleLatencyUs( 12000 ); // An idle interval, plus a poll and a paint.
+    const long _byteIntervalUs( 3001 ); // So bytes arrive at every point in an idle interval.
+    const long _lineUs( 1000000 );
+    const long _maxLineLatencyUs( 100 ); // A few passes, well inside an idle interval.
+
+    long long s_nowUs( 0 ); // Simulated time.
+    long long s_busyUs( 0 ); // Simulated time spent running rather than sleeping.
+
+    void work( long us )
+    {
+        s_nowUs += us;
+        s_busyUs += us;
+    }
+
+    class SimulatedTimer : public Timer
+    {
+    public:
+        SimulatedTimer() : m_startUs( s_nowUs ) {}
+        virtual long ms() { return (long)( ( s_nowUs - m_startUs ) / 1000 ); }
+        virtual long us() { return (long)( s_nowUs - m_startUs ); }
+        virtual void reset() { m_startUs = s_nowUs; }
+        virtual void usleep( long us ) { s_nowUs += us; }
+
+    private:
+        long long m_startUs;
+    };
+
+    class SimulatedTimerFactory : public Timers::Factory
+    {
+    public:
+        virtual Timer* makeTimer() { return new SimulatedTimer; }
+    };
+
+    // Keys typed at set times, picked up when polled.
+    class ScriptedInput : public InputDevice
+    {
+    public:
+        ScriptedInput() : m_next( 0 ) {}
+
+        void type( long long atUs ) { m_script.push_back( atUs ); }
+
+        virtual bool eof() const { return m_buffer.empty(); }
+        virtual char peek() { return m_buffer.empty() ? 0 : 'k'; }
+        virtual char get()
+        {
+            m_typedUs = m_buffer.front();
+            m_buffer.pop_front();
+            return 'k';
+        }
+
+        virtual void run()
+        {
+            work( _pollCostUs );
+            while( ( m_next < m_script.size() ) && ( m_script[m_next] <= s_nowUs ) )
+            {
+                m_buffer.push_back( m_script[m_next++] );
+            }
+        }
+
+        Vector< long long > m_script;
+        unsigned int m_next;
+        Deque< long long > m_buffer;
+        long long m_typedUs;
+    };
+
+    // Notes when the screen is painted.
+    class Screen : public GraphicsDrivers::Headless
+    {
+    public:
+        Screen() : m_paintedUs( 0 ) {}
+
+        virtual void paintGlyph( const String& windowName, int row, int col, char* glyphAttr, bool transparency = false, char charset = 0 )
+        {
+            m_paintedUs = s_nowUs;
+        }
+
+        long long m_paintedUs;
+    };
+
+    // Bytes arriving at set times, as a UART or socket buffers them.
+    class ScriptedLineDriver : public LineDriver
+    {
+    public:
+        ScriptedLineDriver() : m_next( 0 ) {}
+
+        void arrive( long long atUs ) { m_script.push_back( atUs ); }
+
+        virtual int open() { return 0; }
+        virtual bool ready() { return( ( m_next < m_script.size() ) && ( m_script[m_next] <= s_nowUs ) ); }
+        virtual int read( char* data, int len )
+        {
+            int lenRead( 0 );
+            while( ( lenRead < len ) && ready() )
+            {
+                m_arrivedUs = m_script[m_next++];
+                data[lenRead++] = 't';
+            }
+            return lenRead;
+        }
+        virtual int write( const char* data, int len ) { return len; }
+
+        Vector< long long > m_script;
+        unsigned int m_next;
+        long long m_arrivedUs;
+    };
+
+    // Reads tuples off the line, as the session's router would.
+    class Receiver : public Runnable
+    {
+    public:
+        Receiver( Line& line, ScriptedLineDriver& lineDriver ) :
+          m_line( line ),
+          m_lineDriver( lineDriver ),
+          m_bytes( 0 ),
+          m_maxLatencyUs( 0 )
+        {
+        }
+
+        virtual void run()
+        {
+            work( _pollCostUs );
+            char c;
+            while( m_line.read( &c, 1 ) == 1 )
+            {
+                long long latencyUs( s_nowUs - m_lineDriver.m_arrivedUs );
+                if( latencyUs > m_maxLatencyUs ) m_maxLatencyUs = latencyUs;
+                ++m_bytes;
+            }
+        }
+
+        Line& m_line;
+        ScriptedLineDriver& m_lineDriver;
+        int m_bytes;
+        long long m_maxLatencyUs;
+    };
+
+    // Echoes keys, as the session's strategy would.
+    class Echo : public Runnable
+    {
+    public:
+        Echo( ScriptedInput& input, Screen& screen, Timer& timer ) :
+          m_input( input ),
+          m_screen( screen ),
+          m_terminal( 80, 25, "test", screen, timer ),
+          m_keys( 0 ),
+          m_totalLatencyUs( 0 ),
+          m_maxLatencyUs( 0 )
+        {
+        }
+
+        virtual void run()
+        {
+            work( _pollCostUs );
+            while( !m_input.eof() )
+            {
+                char c( m_input.get() );
+                work( _paintCostUs );
+                m_terminal.consumeChar( c );
+
+                long long latencyUs( m_screen.m_paintedUs - m_input.m_typedUs );
+                m_totalLatencyUs += latencyUs;
+                if( latencyUs > m_maxLatencyUs ) m_maxLatencyUs = latencyUs;
+                ++m_keys;
+            }
+        }
+
+        void clear()
+        {
+            m_keys = 0;
+            m_totalLatencyUs = 0;
+            m_maxLatencyUs = 0;
+        }
+
+        long long meanLatencyUs() { return m_keys > 0 ? ( m_totalLatencyUs / m_keys ) : 0; }
+
+        ScriptedInput& m_input;
+        Screen& m_screen;
+        ANSITerminal m_terminal;
+        int m_keys;
+        long long m_totalLatencyUs;
+        long long m_maxLatencyUs;
+    };
+
+    // Loads scenes, or the like, a piece at a time.
+    class Loader : public Runnable
+    {
+    public:
+        Loader() : m_remaining( _loads ), m_doneUs( 0 ) {}
+
+        virtual void run()
+        {
+            if( m_remaining > 0 )
+            {
+                work( _loadCostUs );
+                if( --m_remaining == 0 ) m_doneUs = s_nowUs;
+            }
+        }
+
+        virtual bool ready() { return( m_remaining > 0 ); }
+
+        int m_remaining;
+        long long m_doneUs;
+    };
+
+    // Polls something, as ConnectionMonitor and the entropy sources do.
+    class Poller : public Runnable
+    {
+    public:
+        Poller() : m_runs( 0 ) {}
+
+        virtual void run()
+        {
+            work( _pollCostUs );
+            ++m_runs;
+        }
+
+        int m_runs;
+    };
+
+    struct Result
+    {
+        long long m_loadedUs;
+        long long m_loadingMeanUs;
+        long long m_loadingMaxUs;
+        long long m_idleMeanUs;
+        long long m_idleMaxUs;
+        double m_idleCPU;
+        int m_idlePolls;
+    };
+
+    // Loading with keys being typed, then idle with the odd key, either as
+    // Client::run() was or with the Scheduler.
+    Result simulate( bool scheduled )
+    {
+        s_nowUs = 0;
+        s_busyUs = 0;
+
+        SimulatedTimerFactory timerFactory;
+        SimulatedTimer timer;
+        Screen screen;
+        ScriptedInput input;
+        Echo echo( input, screen, timer );
+        Loader loader;
+        Poller poller;
+        Timers::Wheel timerWheel( timerFactory );
+
+        Scheduler scheduler( timerFactory, timerWheel );
+        scheduler.add( input, Scheduler::input );
+        scheduler.add( timerWheel, Scheduler::redraw );
+        scheduler.add( echo, Scheduler::redraw );
+        scheduler.add( loader, Scheduler::background );
+        scheduler.add( poller, Scheduler::background );
+
+        long long loadingUs( (long long)_loads * _loadCostUs );
+        for( long long atUs( 1000 ); atUs < loadingUs; atUs += _keyIntervalUs )
+        {
+            input.type( atUs );
+        }
+        long long idleStartUs( loadingUs * 2 );
+        for( long long atUs( idleStartUs + 500000 ); atUs < ( idleStartUs + _idleUs ); atUs += 1000003 )
+        {
+            input.type( atUs );
+        }
+
+        Result result;
+        bool idle( false );
+        while( s_nowUs < ( idleStartUs + _idleUs ) )
+        {
+            if( !idle && ( s_nowUs >= idleStartUs ) )
+            {
+                result.m_loadedUs = loader.m_doneUs;
+                result.m_loadingMeanUs = echo.meanLatencyUs();
+                result.m_loadingMaxUs = echo.m_maxLatencyUs;
+                echo.clear();
+                poller.m_runs = 0;
+                s_busyUs = 0;
+                idle = true;
+            }
+
+            work( _passCostUs );
+            if( scheduled )
+            {
+                scheduler.run();
+                scheduler.sleep();
+            }
+            else
+            {
+                // In the order Client::run() ran them, with background work
+                // between input and drawing.
+                input.run();
+                loader.run();
+                poller.run();
+                timerWheel.run();
+                echo.run();
+            }
+        }
+
+        result.m_idleMeanUs = echo.meanLatencyUs();
+        result.m_idleMaxUs = echo.m_maxLatencyUs;
+        result.m_idleCPU = (double)s_busyUs / _idleUs;
+        result.m_idlePolls = poller.m_runs;
+
+        std::cout << ( scheduled ? "Scheduled:   " : "Round robin: " )
+                  << "loaded in " << ( result.m_loadedUs / 1000 ) << "ms, "
+                  << "key to paint " << result.m_loadingMeanUs << "us mean " << result.m_loadingMaxUs << "us max loading, "
+                  << result.m_idleMeanUs << "us mean " << result.m_idleMaxUs << "us max idle, "
+                  << ( result.m_idleCPU * 100 ) << "% CPU idle, "
+                  << result.m_idlePolls << " background polls" << std::endl;
+
+        return result;
+    }
+
+    // Bytes arriving on an otherwise idle line, with the loop run flat out
+    // as the device runs it. Returns the longest wait for a byte to be read.
+    long long receive()
+    {
+        s_nowUs = 0;
+
+        SimulatedTimerFactory timerFactory;
+        ScriptedLineDriver lineDriver;
+        Lines::Direct line( lineDriver );
+        Receiver receiver( line, lineDriver );
+        Poller poller;
+        Timers::Wheel timerWheel( timerFactory );
+
+        Scheduler scheduler( timerFactory, timerWheel );
+        scheduler.add( line, Scheduler::input );
+        scheduler.add( timerWheel, Scheduler::redraw );
+        scheduler.add( receiver, Scheduler::redraw );
+        scheduler.add( poller, Scheduler::background );
+
+        for( long long atUs( 1000 ); atUs < _lineUs; atUs += _byteIntervalUs )
+        {
+            lineDriver.arrive( atUs );
+        }
+
+        while( s_nowUs < _lineUs )
+        {
+            work( _passCostUs );
+            scheduler.run();
+        }
+
+        std::cout << "Line: " << receiver.m_bytes << " bytes, "
+                  << receiver.m_maxLatencyUs << "us max to read" << std::endl;
+
+        return( receiver.m_bytes == (int)lineDriver.m_script.size() ) ? receiver.m_maxLatencyUs : _lineUs;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    Result roundRobin( simulate( false ) );
+    Result scheduled( simulate( true ) );
+
+    // Input is drawn before background work while loading, and loading isn't
+    // held up much for it.
+    success = check( "Loading", ( scheduled.m_loadingMeanUs * 2 < roundRobin.m_loadingMeanUs ) &&
+                                ( scheduled.m_loadingMaxUs <= roundRobin.m_loadingMaxUs ) &&
+                                ( scheduled.m_loadedUs * 10 <= roundRobin.m_loadedUs * 11 ) ) && success;
+
+    // Idle, the loop mostly sleeps, but still answers keys and polls those
+    // that can't say they're ready.
+    success = check( "Idle", ( scheduled.m_idleCPU < _maxIdleCPU ) &&
+                             ( scheduled.m_idleMaxUs <= _maxIdleLatencyUs ) &&
+                             ( scheduled.m_idlePolls >= ( _idleUs / 10000 ) * 9 / 10 ) ) && success;
+
+    // What arrives on the line is read on the next pass, not the next idle
+    // one.
+    success = check( "Line", receive() <= _maxLineLatencyUs ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // SCHEDULER_TEST
@@ -53,6 +53,7 @@ namespace Agape
     const char* _PushNotifier( "PushNotifier" );
     const char* _SceneLoader( "SceneLoader" );
     const char* _SceneLoaderResponder( "SceneLoaderResponder" );
+    const char* _StatsServer( "StatsServer" );
     const char* _TelegramLoader( "TelegramLoader" );
     const char* _TelegramLoaderResponder( "TelegramLoaderResponder" );
     const char* _Timer( "Timer" );
@@ -77,6 +78,8 @@ namespace Agape
     const char* _AssetOpenResponse( "AssetOpenResponse" );
     const char* _AssetReadRequest( "AssetReadRequest" );
     const char* _AssetReadResponse( "AssetReadResponse" );
+    const char* _AssetRevalidateRequest( "AssetRevalidateRequest" );
+    const char* _AssetRevalidateResponse( "AssetRevalidateResponse" );
     const char* _AssetWriteRequest( "AssetWriteRequest" );
     const char* _AssetWriteResponse( "AssetWriteResponse" );
     const char* _Assets( "Assets" );
@@ -115,14 +118,21 @@ namespace Agape
     const char* _SceneItemLoadAttributeResponse( "SceneItemLoadAttributeResponse" );
     const char* _SceneItemSaveAttributeRequest( "SceneItemSaveAttributeRequest" );
     const char* _SceneItemSaveAttributeResponse( "SceneItemSaveAttributeResponse" );
+    const char* _SceneItemSaveAttributesRequest( "SceneItemSaveAttributesRequest" );
+    const char* _SceneItemSaveAttributesResponse( "SceneItemSaveAttributesResponse" );
     const char* _SceneLoadRequest( "SceneLoadRequest" );
     const char* _SceneLoadResponse( "SceneLoadResponse" );
     const char* _SceneRequest( "SceneRequest" );
     const char* _SceneResponse( "SceneResponse" );
+    const char* _SceneRevalidateRequest( "SceneRevalidateRequest" );
+    const char* _SceneRevalidateResponse( "SceneRevalidateResponse" );
     const char* _Scenes( "Scenes" );
     const char* _SceneSummary( "SceneSummary" );
+    const char* _StatsRequest( "StatsRequest" );
+    const char* _StatsResponse( "StatsResponse" );
     const char* _TelegramEraseRequest( "TelegramEraseRequest" );
     const char* _TelegramEraseResponse( "TelegramEraseResponse" );
+    const char* _TelegramLoadPageRequest( "TelegramLoadPageRequest" );
     const char* _TelegramLoadRequest( "TelegramLoadRequest" );
     const char* _TelegramLoadResponse( "TelegramLoadResponse" );
     const char* _TelegramLoadSentRequest( "TelegramLoadSentRequest" );
@@ -172,25 +182,32 @@ namespace Agape
     // Tuple value keys
     const char* _action( "action" );
     const char* _add( "add" );
+    const char* _afterSnowflake( "afterSnowflake" );
     const char* _allDevices( "allDevices" );
     const char* _antiLoopback( "antiLoopback" );
     const char* _assetName( "assetName" );
     const char* _assetType( "assetType" );
+    const char* _assets( "assets" );
     const char* _attribute( "attrib" );
     const char* _attributes( "attribs" ); // Mongoid barfs on "attributes", so best to avoid it everywhere!
     const char* _authKeyHash( "authKeyHash" );
     const char* _author( "author" );
+    const char* _baseSize( "baseSize" );
     const char* _bit( "bit" );
     const char* _bottom( "bottom" );
+    const char* _checksum( "checksum" );
     const char* _collectionName( "collectionName" );
     const char* _colour( "colour" );
     const char* _column( "column" );
     const char* _completed( "completed" );
     const char* _computerid( "computerid" );
+    const char* _count( "count" );
     const char* _coordinates( "coordinates" );
+    const char* _createIfAbsent( "createIfAbsent" );
     const char* _data( "data" );
     const char* _dateTime( "dateTime" );
     const char* _default( "default" );
+    const char* _delta( "delta" );
     const char* _destinationActor( "destinationActor" );
     const char* _destinationActors( "destinationActors" );
     const char* _destinationID( "destinationID" );
@@ -223,7 +240,10 @@ namespace Agape
     const char* _keyType( "keyType" );
     const char* _lastSeen( "lastSeen" );
     const char* _length( "length" );
+    const char* _limit( "limit" );
     const char* _linkedItem( "linkedItem" );
+    const char* _max( "max" );
+    const char* _mean( "mean" );
     const char* _message( "message" );
     const char* _metadata( "metadata" );
     const char* _mode( "mode" );
@@ -245,6 +265,9 @@ namespace Agape
     const char* _originatorID( "originatorID" );
     const char* _overlap( "overlap" );
     const char* _owner( "owner" );
+    const char* _p50( "p50" );
+    const char* _p90( "p90" );
+    const char* _p99( "p99" );
     const char* _platform( "platform" );
     const char* _presenceOperation( "presenceOperation" );
     const char* _present( "present" );
@@ -253,6 +276,7 @@ namespace Agape
     const char* _read( "read" );
     const char* _recipientSnowflake( "recipientSnowflake" );
     const char* _reenter( "reenter" );
+    const char* _requestID( "requestID" );
     const char* _row( "row" );
     const char* _sceneItem( "sceneItem" );
     const char* _sceneItems( "sceneItems" );
@@ -261,6 +285,7 @@ namespace Agape
     const char* _screenBrightness( "screenBrightness" );
     const char* _sealedWorldKey( "sealedWorldKey" );
     const char* _sealingKey( "sealingKey" );
+    const char* _segments( "segments" );
     const char* _senderSnowflake( "senderSnowflake" );
     const char* _setHeight( "setHeight" );
     const char* _size( "size" );
@@ -268,6 +293,7 @@ namespace Agape
     const char* _sourceActor( "sourceActor" );
     const char* _sourceID( "sourceID" );
     const char* _state( "state" );
+    const char* _stats( "stats" );
     const char* _subject( "subject" );
     const char* _success( "success" );
     const char* _telegram( "telegram" );
@@ -367,6 +393,7 @@ namespace Agape
     const char* _deviceAuthKey( "deviceAuthKey" );
     const char* _telaDeviceAuthKeyHash( "telaDeviceAuthKeyHash" );
     const char* _updateStream( "updateStream" );
+    const char* _operator( "operator" );
 
     const char* _authenticate( "authenticate" );
 
@@ -55,6 +55,7 @@ namespace Agape
     extern const char* _PushNotifier;
     extern const char* _SceneLoader;
     extern const char* _SceneLoaderResponder;
+    extern const char* _StatsServer;
     extern const char* _TelegramLoader;
     extern const char* _TelegramLoaderResponder;
     extern const char* _Timer;
@@ -79,6 +80,8 @@ namespace Agape
     extern const char* _AssetOpenResponse;
     extern const char* _AssetReadRequest;
     extern const char* _AssetReadResponse;
+    extern const char* _AssetRevalidateRequest;
+    extern const char* _AssetRevalidateResponse;
     extern const char* _AssetWriteRequest;
     extern const char* _AssetWriteResponse;
     extern const char* _Assets;
@@ -117,14 +120,21 @@ namespace Agape
     extern const char* _SceneItemLoadAttributeResponse;
     extern const char* _SceneItemSaveAttributeRequest;
     extern const char* _SceneItemSaveAttributeResponse;
+    extern const char* _SceneItemSaveAttributesRequest;
+    extern const char* _SceneItemSaveAttributesResponse;
     extern const char* _SceneLoadRequest;
     extern const char* _SceneLoadResponse;
     extern const char* _SceneRequest;
     extern const char* _SceneResponse;
+    extern const char* _SceneRevalidateRequest;
+    extern const char* _SceneRevalidateResponse;
     extern const char* _Scenes;
     extern const char* _SceneSummary;
+    extern const char* _StatsRequest;
+    extern const char* _StatsResponse;
     extern const char* _TelegramEraseRequest;
     extern const char* _TelegramEraseResponse;
+    extern const char* _TelegramLoadPageRequest;
     extern const char* _TelegramLoadRequest;
     extern const char* _TelegramLoadResponse;
     extern const char* _TelegramLoadSentRequest;
@@ -174,25 +184,32 @@ namespace Agape
     // Tuple value keys
     extern const char* _action;
     extern const char* _add;
+    extern const char* _afterSnowflake;
     extern const char* _allDevices;
     extern const char* _antiLoopback;
     extern const char* _assetName;
     extern const char* _assetType;
+    extern const char* _assets;
     extern const char* _attribute;
     extern const char* _attributes;
     extern const char* _authKeyHash;
     extern const char* _author;
+    extern const char* _baseSize;
     extern const char* _bit;
     extern const char* _bottom;
+    extern const char* _checksum;
     extern const char* _collectionName;
     extern const char* _colour;
     extern const char* _column;
     extern const char* _completed;
     extern const char* _computerid;
+    extern const char* _count;
     extern const char* _coordinates;
+    extern const char* _createIfAbsent;
     extern const char* _data;
     extern const char* _dateTime;
     extern const char* _default;
+    extern const char* _delta;
     extern const char* _destinationActor;
     extern const char* _destinationActors;
     extern const char* _destinationID;
@@ -225,7 +242,10 @@ namespace Agape
     extern const char* _keyType;
     extern const char* _lastSeen;
     extern const char* _length;
+    extern const char* _limit;
     extern const char* _linkedItem;
+    extern const char* _max;
+    extern const char* _mean;
     extern const char* _message;
     extern const char* _metadata;
     extern const char* _mode;
@@ -247,6 +267,9 @@ namespace Agape
     extern const char* _originatorID;
     extern const char* _overlap;
     extern const char* _owner;
+    extern const char* _p50;
+    extern const char* _p90;
+    extern const char* _p99;
     extern const char* _platform;
     extern const char* _presenceOperation;
     extern const char* _present;
@@ -255,6 +278,7 @@ namespace Agape
     extern const char* _read;
     extern const char* _recipientSnowflake;
     extern const char* _reenter;
+    extern const char* _requestID;
     extern const char* _row;
     extern const char* _sceneItem;
     extern const char* _sceneItems;
@@ -263,6 +287,7 @@ namespace Agape
     extern const char* _screenBrightness;
     extern const char* _sealedWorldKey;
     extern const char* _sealingKey;
+    extern const char* _segments;
     extern const char* _senderSnowflake;
     extern const char* _setHeight;
     extern const char* _size;
@@ -270,6 +295,7 @@ namespace Agape
     extern const char* _sourceActor;
     extern const char* _sourceID;
     extern const char* _state;
+    extern const char* _stats;
     extern const char* _subject;
     extern const char* _success;
     extern const char* _telegram;
@@ -369,6 +395,7 @@ namespace Agape
     extern const char* _deviceAuthKey;
     extern const char* _telaDeviceAuthKeyHash;
     extern const char* _updateStream;
+    extern const char* _operator;
 
     extern const char* _authenticate;
 
@@ -6,6 +6,8 @@
 #include "StringConstants.h"
 #include "Value.h"
 
+#include <algorithm>
+
 using namespace Agape::World;
 
 namespace Agape
@@ -25,25 +27,60 @@ File::File( const String& recipientSnowflake,
 
 bool File::load( Vector< Telegram >& telegrams )
 {
-    FileWriter fileWriter( m_filename, FileWriter::modeRead );
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
+    {
+        ConstListIterator it( telegramsValue.listBegin() );
+        for( ; it != telegramsValue.listEnd(); ++it )
+        {
+            Telegram thisTelegram( Telegram::fromValue( **it ) );
+            if( thisTelegram.m_recipientSnowflake == m_recipientSnowflake )
+            {
+                telegrams.push_back( thisTelegram );
+            }
+        }
 
-    if( fileWriter.isOpen() )
+        return true;
+    }
+
+    return false;
+}
+
+bool File::loadPage( Vector< Telegram >& telegrams,
+                     const String& afterSnowflake,
+                     int limit )
+{
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
     {
-        Value telegramsValue;
-        if( Value::fromReadableWritable( fileWriter, telegramsValue ) )
+        Vector< Telegram > after;
+        ConstListIterator it( telegramsValue.listBegin() );
+        for( ; it != telegramsValue.listEnd(); ++it )
         {
-            ConstListIterator it( telegramsValue.listBegin() );
-            for( ; it != telegramsValue.listEnd(); ++it )
+            // Only unpack those we might return.
+            const Value& telegramValue( **it );
+            if( ( (const String&)telegramValue[_recipientSnowflake] == m_recipientSnowflake ) &&
+                ( afterSnowflake < (const String&)telegramValue[_telegramSnowflake] ) )
             {
-                Telegram thisTelegram( Telegram::fromValue( **it ) );
-                if( thisTelegram.m_recipientSnowflake == m_recipientSnowflake )
-                {
-                    telegrams.push_back( thisTelegram );
-                }
+                after.push_back( Telegram::fromValue( telegramValue ) );
             }
+        }
 
-            return true;
+        // The file is in the order telegrams were sent, which needn't be
+        // snowflake order.
+        if( (int)after.size() > limit )
+        {
+            std::partial_sort( after.begin(), after.begin() + limit, after.end(), Telegram::snowflakeBefore );
+            after.resize( limit );
+        }
+        else
+        {
+            std::sort( after.begin(), after.end(), Telegram::snowflakeBefore );
         }
+
+        telegrams.insert( telegrams.end(), after.begin(), after.end() );
+
+        return true;
     }
 
     return false;
@@ -51,25 +88,20 @@ bool File::load( Vector< Telegram >& telegrams )
 
 bool File::loadSent( Vector< Telegram >& telegrams )
 {
-    FileWriter fileWriter( m_filename, FileWriter::modeRead );
-
-    if( fileWriter.isOpen() )
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
     {
-        Value telegramsValue;
-        if( Value::fromReadableWritable( fileWriter, telegramsValue ) )
+        ConstListIterator it( telegramsValue.listBegin() );
+        for( ; it != telegramsValue.listEnd(); ++it )
         {
-            ConstListIterator it( telegramsValue.listBegin() );
-            for( ; it != telegramsValue.listEnd(); ++it )
+            Telegram thisTelegram( Telegram::fromValue( **it ) );
+            if( thisTelegram.m_senderSnowflake == m_recipientSnowflake )
             {
-                Telegram thisTelegram( Telegram::fromValue( **it ) );
-                if( thisTelegram.m_senderSnowflake == m_recipientSnowflake )
-                {
-                    telegrams.push_back( thisTelegram );
-                }
+                telegrams.push_back( thisTelegram );
             }
-
-            return true;
         }
+
+        return true;
     }
 
     return false;
@@ -77,19 +109,14 @@ bool File::loadSent( Vector< Telegram >& telegrams )
 
 bool File::send( const Telegram& telegram )
 {
-    FileWriter fileWriter( m_filename, FileWriter::modeRead );
-
-    if( fileWriter.isOpen() )
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
     {
-        Value telegramsValue;
-        if( Value::fromReadableWritable( fileWriter, telegramsValue ) )
-        {
-            Value* telegramValue = new Value;
-            telegram.toValue( *telegramValue );
-            telegramsValue.push_back( telegramValue );
+        Value* telegramValue = new Value;
+        telegram.toValue( *telegramValue );
+        telegramsValue.push_back( telegramValue );
 
-            return true;
-        }
+        return writeTelegrams( telegramsValue );
     }
 
     return false;
@@ -97,37 +124,24 @@ bool File::send( const Telegram& telegram )
 
 bool File::markRead( const Telegram& telegram )
 {
-    FileWriter readFileWriter( m_filename, FileWriter::modeRead );
-
-    if( readFileWriter.isOpen() )
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
     {
-        Value telegramsValue;
-        if( Value::fromReadableWritable( readFileWriter, telegramsValue ) )
+        ListIterator it( telegramsValue.listBegin() );
+        for( ; it != telegramsValue.listEnd(); ++it )
         {
-            readFileWriter.close();
-
-            ListIterator it( telegramsValue.listBegin() );
-            for( ; it != telegramsValue.listEnd(); ++it )
+            Telegram thisTelegram( Telegram::fromValue( **it ) );
+            if( thisTelegram == telegram )
             {
-                Telegram thisTelegram( Telegram::fromValue( **it ) );
-                if( thisTelegram == telegram )
-                {
-                    thisTelegram.m_unread = false;
-                    thisTelegram.toValue( **it );
-                    break;
-                }
+                thisTelegram.m_unread = false;
+                thisTelegram.toValue( **it );
+                break;
             }
+        }
 
-            if( it != telegramsValue.listEnd() )
-            {
-                FileWriter writeFileWriter( m_filename, FileWriter::modeWrite );
-
-                if( writeFileWriter.isOpen() )
-                {
-                    telegramsValue.toReadableWritable( writeFileWriter );
-                    return true;
-                }
-            }
+        if( it != telegramsValue.listEnd() )
+        {
+            return writeTelegrams( telegramsValue );
         }
     }
 
@@ -136,35 +150,17 @@ bool File::markRead( const Telegram& telegram )
 
 bool File::erase( const Telegram& telegram )
 {
-    FileWriter readFileWriter( m_filename, FileWriter::modeRead );
-
-    if( readFileWriter.isOpen() )
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
     {
-        Value telegramsValue;
-        if( Value::fromReadableWritable( readFileWriter, telegramsValue ) )
+        ListIterator it( telegramsValue.listBegin() );
+        for( ; it != telegramsValue.listEnd(); ++it )
         {
-            readFileWriter.close();
-
-            ListIterator it( telegramsValue.listBegin() );
-            for( ; it != telegramsValue.listEnd(); ++it )
-            {
-                Telegram thisTelegram( Telegram::fromValue( **it ) );
-                if( thisTelegram == telegram )
-                {
-                    telegramsValue.erase( it );
-                    break;
-                }
-            }
-
-            if( it != telegramsValue.listEnd() )
+            Telegram thisTelegram( Telegram::fromValue( **it ) );
+            if( thisTelegram == telegram )
             {
-                FileWriter writeFileWriter( m_filename, FileWriter::modeWrite );
-
-                if( writeFileWriter.isOpen() )
-                {
-                    telegramsValue.toReadableWritable( writeFileWriter );
-                    return true;
-                }
+                telegramsValue.erase( it );
+                return writeTelegrams( telegramsValue );
             }
         }
     }
@@ -177,25 +173,83 @@ bool File::unread( Map< String, int >& numUnread, bool allDevices )
     numUnread.clear();
     numUnread[m_worldID] = 0;
 
+    Value telegramsValue;
+    if( readTelegrams( telegramsValue ) )
+    {
+        ConstListIterator it( telegramsValue.listBegin() );
+        for( ; it != telegramsValue.listEnd(); ++it )
+        {
+            Telegram thisTelegram( Telegram::fromValue( **it ) );
+            if( ( thisTelegram.m_recipientSnowflake == m_recipientSnowflake ) &&
+                thisTelegram.m_unread )
+            {
+                ++numUnread[m_worldID];
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// A list value can only hold so many items when read back, so the file is a
+// count followed by that many telegrams. A file that's a single list of
+// telegrams, as they used to be, is still read.
+bool File::readTelegrams( Value& telegramsValue )
+{
     FileWriter fileWriter( m_filename, FileWriter::modeRead );
 
     if( fileWriter.isOpen() )
     {
-        Value telegramsValue;
-        if( Value::fromReadableWritable( fileWriter, telegramsValue ) )
+        Value countValue;
+        if( Value::fromReadableWritable( fileWriter, countValue ) )
         {
-            ConstListIterator it( telegramsValue.listBegin() );
-            for( ; it != telegramsValue.listEnd(); ++it )
+            if( countValue.type() == Value::list )
+            {
+                telegramsValue = countValue;
+                return true;
+            }
+
+            int count( countValue );
+            bool success( true );
+            for( int i( 0 ); success && ( i < count ); ++i )
             {
-                Telegram thisTelegram( Telegram::fromValue( **it ) );
-                if( ( thisTelegram.m_recipientSnowflake == m_recipientSnowflake ) &&
-                    thisTelegram.m_unread )
+                Value* telegramValue( new Value );
+                success = Value::fromReadableWritable( fileWriter, *telegramValue );
+                if( success )
                 {
-                    ++numUnread[m_worldID];
+                    telegramsValue.push_back( telegramValue );
+                }
+                else
+                {
+                    delete( telegramValue );
                 }
             }
+
+            return success;
         }
-        return true;
+    }
+
+    return false;
+}
+
+bool File::writeTelegrams( const Value& telegramsValue )
+{
+    FileWriter fileWriter( m_filename, FileWriter::modeWrite );
+
+    if( fileWriter.isOpen() )
+    {
+        int count( telegramsValue.listEnd() - telegramsValue.listBegin() );
+        bool success( Value( count ).toReadableWritable( fileWriter ) );
+
+        ConstListIterator it( telegramsValue.listBegin() );
+        for( ; success && ( it != telegramsValue.listEnd() ); ++it )
+        {
+            success = ( *it )->toReadableWritable( fileWriter );
+        }
+
+        return success;
     }
 
     return false;
@@ -5,6 +5,7 @@
 #include "Collections.h"
 #include "String.h"
 #include "TelegramLoader.h"
+#include "Value.h"
 
 using namespace Agape::World;
 
@@ -22,6 +23,9 @@ public:
           const String& worldID );
 
     virtual bool load( Vector< Telegram >& telegrams );
+    virtual bool loadPage( Vector< Telegram >& telegrams,
+                           const String& afterSnowflake,
+                           int limit );
     virtual bool loadSent( Vector< Telegram >& telegrams );
     virtual bool send( const Telegram& telegram );
     virtual bool markRead( const Telegram& telegram );
@@ -29,6 +33,9 @@ public:
     virtual bool unread( Map< String, int >& numUnread, bool allDevices );
 
 private:
+    bool readTelegrams( Value& telegramsValue );
+    bool writeTelegrams( const Value& telegramsValue );
+
     String m_filename;
     String m_worldID;
 };
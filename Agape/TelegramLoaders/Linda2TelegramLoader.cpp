@@ -4,7 +4,7 @@
 #include "World/Telegram.h"
 #include "Collections.h"
 #include "Linda2TelegramLoader.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "TupleRouter.h"
@@ -13,26 +13,24 @@
 using namespace Agape::Linda2;
 using namespace Agape::World;
 
+namespace
+{
+    const int _retries( 1 ); // For loads, which can safely be asked again.
+} // Anonymous namespace
+
 namespace Agape
 {
 
 namespace TelegramLoaders
 {
 
-// FIXME: There's a lot of repetition with the Linda2 loaders - sending a
-// request and receiving one or more items (which are deserialised from tuples)
-// is a common pattern and can probably be broken out to a separate class,
-// perhaps templated on the desired sent/received object type.
 Linda2::Linda2( const String& recipientSnowflake,
                 TupleRouter& tupleRouter,
                 Timers::Factory& timerFactory ) :
   TelegramLoader( recipientSnowflake ),
   Native( "TelegramLoader" ),
   m_tupleRouter( tupleRouter ),
-  m_timerFactory( timerFactory ),
-  m_currentItem( 0 ),
-  m_totalItems( -1 ),
-  m_telegrams( nullptr )
+  m_requester( tupleRouter, timerFactory, this )
 {
     LOG_DEBUG( "Linda2TelegramLoader: Created" );
     m_tupleRouter.registerActor( this );
@@ -46,209 +44,121 @@ Linda2::~Linda2()
 
 bool Linda2::load( Vector< Telegram >& telegrams )
 {
-    bool success( false );
-
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _TelegramLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _TelegramLoadRequest );
-    tuple[_recipientSnowflake] = m_recipientSnowflake;
-
-    m_telegrams = &telegrams;
-    m_currentItem = 0;
-    m_totalItems = -1;
+    Tuple tuple( request( _TelegramLoadRequest ) );
 
     LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramLoadRequest" );
-    m_telegramLoadResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    success = m_tupleRouter.route( tuple );
-    if( success ) success = m_telegramLoadResponse.getFuture().get();
+    return loadTelegrams( tuple, _TelegramLoadResponse, _TelegramLoadSummary, telegrams );
+}
 
-    m_telegrams = nullptr;
+bool Linda2::loadPage( Vector< Telegram >& telegrams,
+                       const String& afterSnowflake,
+                       int limit )
+{
+    Tuple tuple( request( _TelegramLoadPageRequest ) );
+    tuple[_afterSnowflake] = afterSnowflake;
+    tuple[_limit] = limit;
 
-    return success;
+    // Answered as a load is.
+    LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramLoadPageRequest" );
+    return loadTelegrams( tuple, _TelegramLoadResponse, _TelegramLoadSummary, telegrams );
 }
 
 bool Linda2::loadSent( Vector< Telegram >& telegrams )
 {
-    bool success( false );
-
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _TelegramLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _TelegramLoadSentRequest );
-    tuple[_recipientSnowflake] = m_recipientSnowflake;
-
-    m_telegrams = &telegrams;
-    m_currentItem = 0;
-    m_totalItems = -1;
+    Tuple tuple( request( _TelegramLoadSentRequest ) );
 
     LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramLoadSentRequest" );
-    m_telegramLoadSentResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    success = m_tupleRouter.route( tuple );
-    if( success ) success = m_telegramLoadSentResponse.getFuture().get();
-
-    m_telegrams = nullptr;
-
-    return success;
+    return loadTelegrams( tuple, _TelegramLoadSentResponse, _TelegramLoadSentSummary, telegrams );
 }
 
 bool Linda2::send( const Telegram& telegram )
 {
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _TelegramLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _TelegramSendRequest );
-    tuple[_recipientSnowflake] = m_recipientSnowflake;
+    Tuple tuple( request( _TelegramSendRequest ) );
     telegram.toValue( tuple[_telegram] );
 
     LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramSendRequest" );
-    m_telegramSendResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_telegramSendResponse.getFuture().get();
-    return false;
+    Tuple response;
+    return m_requester.call( tuple, _TelegramSendResponse, response );
 }
 
 bool Linda2::markRead( const Telegram& telegram )
 {
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _TelegramLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _TelegramMarkReadRequest );
-    tuple[_recipientSnowflake] = m_recipientSnowflake;
+    Tuple tuple( request( _TelegramMarkReadRequest ) );
     telegram.toValue( tuple[_telegram] );
 
     LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramMarkReadRequest" );
-    m_telegramMarkReadResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_telegramMarkReadResponse.getFuture().get();
-    return false;
+    Tuple response;
+    return m_requester.call( tuple, _TelegramMarkReadResponse, response );
 }
 
 bool Linda2::erase( const Telegram& telegram )
 {
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _TelegramLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _TelegramEraseRequest );
-    tuple[_recipientSnowflake] = m_recipientSnowflake;
+    Tuple tuple( request( _TelegramEraseRequest ) );
     telegram.toValue( tuple[_telegram] );
 
     LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramEraseRequest" );
-    m_telegramEraseResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) ) return m_telegramEraseResponse.getFuture().get();
-    return false;
+    Tuple response;
+    return m_requester.call( tuple, _TelegramEraseResponse, response );
 }
 
 bool Linda2::unread( Map< String, int >& numUnread, bool allDevices )
 {
     numUnread.clear();
 
-    Tuple tuple;
-    TupleRouter::setSourceActor( tuple, _TelegramLoader );
-    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
-    TupleRouter::setTupleType( tuple, _TelegramUnreadRequest );
-    tuple[_recipientSnowflake] = m_recipientSnowflake;
+    Tuple tuple( request( _TelegramUnreadRequest ) );
     tuple[_allDevices] = allDevices ? 1 : 0;
 
     LOG_DEBUG( "Linda2TelegramLoader: Sending TelegramUnreadRequest" );
-    m_telegramUnreadResponse = Promise( &m_tupleRouter, &m_timerFactory );
-    if( m_tupleRouter.route( tuple ) )
+    Tuple response;
+    if( !m_requester.call( tuple, _TelegramUnreadResponse, response, _retries ) )
     {
-        Value numUnreadValue;
-        if( m_telegramUnreadResponse.getFuture().get( numUnreadValue ) )
-        {
-            ConstMapIterator it( numUnreadValue.mapBegin() );
-            for( ; it != numUnreadValue.mapEnd(); ++it )
-            {
-                numUnread[it->first] = (int)*( it->second );
-            }
-            return true;
-        }
+        return false;
     }
 
-    return false;
+    const Value& numUnreadValue( response[_numUnread] );
+    ConstMapIterator it( numUnreadValue.mapBegin() );
+    for( ; it != numUnreadValue.mapEnd(); ++it )
+    {
+        numUnread[it->first] = (int)*( it->second );
+    }
+
+    return true;
 }
 
 bool Linda2::accept( Tuple& tuple )
 {
-    bool handled( false );
-
-    if( TupleRouter::tupleType( tuple ) == _TelegramLoadSummary )
-    {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram load summary" );
-        m_totalItems = tuple[_totalItems];
-
-        if( m_currentItem == m_totalItems )
-        {
-            m_telegramLoadResponse.set( tuple[_success] );
-        }
-
-        handled = true;
-    }
-    else if( ( TupleRouter::tupleType( tuple ) == _TelegramLoadResponse ) && m_telegrams )
-    {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram metadata" );
-        Telegram telegram( Telegram::fromValue( tuple[_telegram] ) );
-        m_telegrams->push_back( telegram );
-        ++m_currentItem;
+    // Only ever replies to our requests.
+    return m_requester.accept( tuple );
+}
 
-        if( m_currentItem == m_totalItems )
-        {
-            m_telegramLoadResponse.set();
-        }
+Tuple Linda2::request( const String& type )
+{
+    Tuple tuple;
+    TupleRouter::setSourceActor( tuple, _TelegramLoader );
+    TupleRouter::setTupleType( tuple, type );
+    tuple[_recipientSnowflake] = m_recipientSnowflake;
+    return tuple;
+}
 
-        handled = true;
-    }
-    if( TupleRouter::tupleType( tuple ) == _TelegramLoadSentSummary )
+bool Linda2::loadTelegrams( Tuple& tuple,
+                            const String& responseType,
+                            const String& summaryType,
+                            Vector< Telegram >& telegrams )
+{
+    Tuple summary;
+    Vector< Tuple > items;
+    if( !m_requester.call( tuple, responseType, summaryType, summary, items, _retries ) )
     {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram load sent summary" );
-        m_totalItems = tuple[_totalItems];
-
-        if( m_currentItem == m_totalItems )
-        {
-            m_telegramLoadSentResponse.set( tuple[_success] );
-        }
-
-        handled = true;
+        return false;
     }
-    else if( ( TupleRouter::tupleType( tuple ) == _TelegramLoadSentResponse ) && m_telegrams )
-    {
-        LOG_DEBUG( "Linda2TelegramLoader: Received sent telegram metadata" );
-        Telegram telegram( Telegram::fromValue( tuple[_telegram] ) );
-        m_telegrams->push_back( telegram );
-        ++m_currentItem;
-
-        if( m_currentItem == m_totalItems )
-        {
-            m_telegramLoadSentResponse.set();
-        }
 
-        handled = true;
-    }
-    else if( TupleRouter::tupleType( tuple ) == _TelegramSendResponse )
-    {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram send response" );
-        m_telegramSendResponse.set( tuple[_success] );
-        handled = true;
-    }
-    else if( TupleRouter::tupleType( tuple ) == _TelegramMarkReadResponse )
-    {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram mark read response" );
-        m_telegramMarkReadResponse.set( tuple[_success] );
-        handled = true;
-    }
-    else if( TupleRouter::tupleType( tuple ) == _TelegramEraseResponse )
-    {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram erase response" );
-        m_telegramEraseResponse.set( tuple[_success] );
-        handled = true;
-    }
-    else if( TupleRouter::tupleType( tuple ) == _TelegramUnreadResponse )
+    Vector< Tuple >::const_iterator it( items.begin() );
+    for( ; it != items.end(); ++it )
     {
-        LOG_DEBUG( "Linda2TelegramLoader: Received telegram unread response" );
-        m_telegramUnreadResponse.set( tuple[_success], tuple[_numUnread] );
-        handled = true;
+        telegrams.push_back( Telegram::fromValue( ( *it )[_telegram] ) );
     }
 
-    return handled;
+    return true;
 }
 
 } // namespace TelegramLoaders
@@ -4,7 +4,7 @@
 #include "Actors/NativeActors/NativeActor.h"
 #include "World/Telegram.h"
 #include "Collections.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "TelegramLoader.h"
 
 using namespace Agape::Linda2;
@@ -38,6 +38,9 @@ public:
     ~Linda2();
 
     virtual bool load( Vector< Telegram >& telegrams );
+    virtual bool loadPage( Vector< Telegram >& telegrams,
+                           const String& afterSnowflake,
+                           int limit );
     virtual bool loadSent( Vector< Telegram >& telegrams );
     virtual bool send( const Telegram& telegram );
     virtual bool markRead( const Telegram& telegram );
@@ -47,20 +50,14 @@ public:
     virtual bool accept( Tuple& tuple );
 
 private:
-    TupleRouter& m_tupleRouter;
-    Timers::Factory& m_timerFactory;
-
-    int m_currentItem;
-    int m_totalItems;
+    Tuple request( const String& type );
+    bool loadTelegrams( Tuple& tuple,
+                        const String& responseType,
+                        const String& summaryType,
+                        Vector< Telegram >& telegrams );
 
-    Promise m_telegramLoadResponse;
-    Promise m_telegramLoadSentResponse;
-    Promise m_telegramSendResponse;
-    Promise m_telegramMarkReadResponse;
-    Promise m_telegramEraseResponse;
-    Promise m_telegramUnreadResponse;
-
-    Vector< Telegram >* m_telegrams;
+    TupleRouter& m_tupleRouter;
+    Requester m_requester;
 };
 
 } // namespace TelegramLoaders
@@ -4,6 +4,7 @@
 #include "World/Telegram.h"
 #include "Collections.h"
 #include "Linda2TelegramLoaderResponder.h"
+#include "Reply.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "TupleRouter.h"
@@ -11,6 +12,11 @@
 
 using namespace Agape::Linda2;
 
+namespace
+{
+    const int _maxLimit( 500 ); // Telegrams in a page, whatever the client asks for.
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -39,6 +45,11 @@ bool Linda2Responder::accept( Tuple& tuple )
         load( tuple );
         handled = true;
     }
+    else if( TupleRouter::tupleType( tuple ) == _TelegramLoadPageRequest )
+    {
+        loadPage( tuple );
+        handled = true;
+    }
     else if( TupleRouter::tupleType( tuple ) == _TelegramLoadSentRequest )
     {
         loadSent( tuple );
@@ -87,32 +98,30 @@ void Linda2Responder::load( const Tuple& tuple )
     Vector< Telegram > telegrams;
     bool success( telegramLoader->load( telegrams ) );
 
-#ifdef LOG_LOADERS
-    LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramLoadSummary" );
-#endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _TelegramLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _TelegramLoadSummary );
-    response[_totalItems] = success ? (int)telegrams.size() : 0;
-    response[_success] = success;
-    m_tupleRouter.route( response );
+    sendTelegrams( tuple, telegrams, success );
+
+    delete( telegramLoader );
+}
+
+void Linda2Responder::loadPage( const Tuple& tuple )
+{
+    String recipientSnowflake = tuple[_recipientSnowflake];
+    String afterSnowflake = tuple[_afterSnowflake];
+    int limit = tuple[_limit];
+    if( ( limit <= 0 ) || ( limit > _maxLimit ) ) limit = _maxLimit;
+    TelegramLoader* telegramLoader( m_telegramLoaderFactory.makeLoader( recipientSnowflake ) );
 
-    Vector< Telegram >::const_iterator it( telegrams.begin() );
-    for( ; success && ( it != telegrams.end() ); ++it )
-    {
 #ifdef LOG_LOADERS
-        LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramLoadResponse" );
+    LiteStream stream;
+    stream << "Linda2TelegramLoaderResponder: Received TelegramLoadPageRequest for "
+           << recipientSnowflake << " after " << afterSnowflake;
+    LOG_DEBUG( stream.str() );
 #endif
-        Tuple telegramTuple;
-        TupleRouter::setSourceActor( telegramTuple, _TelegramLoaderResponder );
-        TupleRouter::setSourceID( telegramTuple, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( telegramTuple, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( telegramTuple, _TelegramLoadResponse );
-        it->toValue( telegramTuple[_telegram] );
-        m_tupleRouter.route( telegramTuple );
-    }
+
+    Vector< Telegram > telegrams;
+    bool success( telegramLoader->loadPage( telegrams, afterSnowflake, limit ) );
+
+    sendTelegrams( tuple, telegrams, success );
 
     delete( telegramLoader );
 }
@@ -135,14 +144,8 @@ void Linda2Responder::loadSent( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramLoadSentSummary" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _TelegramLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _TelegramLoadSentSummary );
-    response[_totalItems] = success ? (int)telegrams.size() : 0;
-    response[_success] = success;
-    m_tupleRouter.route( response );
+    Reply reply( m_tupleRouter, tuple, _TelegramLoaderResponder );
+    reply.sendSummary( _TelegramLoadSentSummary, success ? (int)telegrams.size() : 0, success );
 
     Vector< Telegram >::const_iterator it( telegrams.begin() );
     for( ; success && ( it != telegrams.end() ); ++it )
@@ -150,13 +153,9 @@ void Linda2Responder::loadSent( const Tuple& tuple )
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramLoadSentResponse" );
 #endif
-        Tuple telegramTuple;
-        TupleRouter::setSourceActor( telegramTuple, _TelegramLoaderResponder );
-        TupleRouter::setSourceID( telegramTuple, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( telegramTuple, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( telegramTuple, _TelegramLoadSentResponse );
+        Tuple telegramTuple( reply.tuple( _TelegramLoadSentResponse ) );
         it->toValue( telegramTuple[_telegram] );
-        m_tupleRouter.route( telegramTuple );
+        reply.send( telegramTuple );
     }
 
     delete( telegramLoader );
@@ -181,13 +180,10 @@ void Linda2Responder::send( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramSendResponse" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _TelegramLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _TelegramSendResponse );
+    Reply reply( m_tupleRouter, tuple, _TelegramLoaderResponder );
+    Tuple response( reply.tuple( _TelegramSendResponse ) );
     response[_success] = success;
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::markRead( const Tuple& tuple )
@@ -209,13 +205,10 @@ void Linda2Responder::markRead( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramMakReadResponse" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _TelegramLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _TelegramMarkReadResponse );
+    Reply reply( m_tupleRouter, tuple, _TelegramLoaderResponder );
+    Tuple response( reply.tuple( _TelegramMarkReadResponse ) );
     response[_success] = success;
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::erase( const Tuple& tuple )
@@ -237,13 +230,10 @@ void Linda2Responder::erase( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramEraseResponse" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _TelegramLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _TelegramEraseResponse );
+    Reply reply( m_tupleRouter, tuple, _TelegramLoaderResponder );
+    Tuple response( reply.tuple( _TelegramEraseResponse ) );
     response[_success] = success;
-    m_tupleRouter.route( response );
+    reply.send( response );
 }
 
 void Linda2Responder::unread( const Tuple& tuple )
@@ -272,14 +262,33 @@ void Linda2Responder::unread( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramUnreadResponse" );
 #endif
-    Tuple response;
-    TupleRouter::setSourceActor( response, _TelegramLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _TelegramUnreadResponse );
+    Reply reply( m_tupleRouter, tuple, _TelegramLoaderResponder );
+    Tuple response( reply.tuple( _TelegramUnreadResponse ) );
     response[_success] = success;
     response[_numUnread] = numUnreadValue;
-    m_tupleRouter.route( response );
+    reply.send( response );
+}
+
+void Linda2Responder::sendTelegrams( const Tuple& tuple,
+                                     const Vector< Telegram >& telegrams,
+                                     bool success )
+{
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramLoadSummary" );
+#endif
+    Reply reply( m_tupleRouter, tuple, _TelegramLoaderResponder );
+    reply.sendSummary( _TelegramLoadSummary, success ? (int)telegrams.size() : 0, success );
+
+    Vector< Telegram >::const_iterator it( telegrams.begin() );
+    for( ; success && ( it != telegrams.end() ); ++it )
+    {
+#ifdef LOG_LOADERS
+        LOG_DEBUG( "Linda2TelegramLoaderResponder: Sending TelegramLoadResponse" );
+#endif
+        Tuple telegramTuple( reply.tuple( _TelegramLoadResponse ) );
+        it->toValue( telegramTuple[_telegram] );
+        reply.send( telegramTuple );
+    }
 }
 
 } // namespace TelegramLoaders
@@ -2,8 +2,11 @@
 #define AGAPE_TELEGRAM_LOADERS_LINDA2_RESPONDER_H
 
 #include "Actors/NativeActors/NativeActor.h"
+#include "World/Telegram.h"
+#include "Collections.h"
 
 using namespace Agape::Linda2;
+using namespace Agape::World;
 
 namespace Agape
 {
@@ -31,12 +34,17 @@ public:
 
 private:
     void load( const Tuple& tuple );
+    void loadPage( const Tuple& tuple );
     void loadSent( const Tuple& tuple );
     void send( const Tuple& tuple );
     void markRead( const Tuple& tuple );
     void erase( const Tuple& tuple );
     void unread( const Tuple& tuple );
 
+    void sendTelegrams( const Tuple& tuple,
+                        const Vector< Telegram >& telegrams,
+                        bool success );
+
     TupleRouter& m_tupleRouter;
     TelegramLoaders::Factory& m_telegramLoaderFactory;
 };
@@ -24,6 +24,13 @@ bool Null::load( Vector< Telegram >& telegrams )
     return true;
 }
 
+bool Null::loadPage( Vector< Telegram >& telegrams,
+                     const String& afterSnowflake,
+                     int limit )
+{
+    return true;
+}
+
 bool Null::loadSent( Vector< Telegram >& telegrams )
 {
     return true;
@@ -20,6 +20,9 @@ public:
     Null( const String& recipientSnowflake );
 
     virtual bool load( Vector< Telegram >& telegrams );
+    virtual bool loadPage( Vector< Telegram >& telegrams,
+                           const String& afterSnowflake,
+                           int limit );
     virtual bool loadSent( Vector< Telegram >& telegrams );
     virtual bool send( const Telegram& telegram );
     virtual bool markRead( const Telegram& telegram );
@@ -0,0 +1,566 @@
+#include "Loggers/Logger.h"
+#include "Utils/LiteStream.h"
+#include "Utils/StrToHex.h"
+#include "World/Telegram.h"
+#include "Collections.h"
+#include "KiamaFS.h"
+#include "ReadableWritable.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "TelegramIndex.h"
+#include "TelegramLoader.h"
+#include "Value.h"
+
+using namespace Agape::World;
+
+namespace
+{
+    const int _pageSize( 500 ); // Asked of the loader at a time when syncing.
+    const int _segmentSize( 256 ); // Headers per file.
+    const int _manifestVersion( 2 ); // Any other is rebuilt.
+
+    // Per segment in the manifest: size, first snowflake and unread count.
+    const int _segmentEntrySize( 2 + 8 + 2 );
+
+    // Snowflakes come from the sender's clock, so one can arrive after
+    // others with higher snowflakes. Each sync looks this far back again.
+    const unsigned long long _overlapms( 60 * 60 * 1000 );
+    const int _snowflakeTimeShift( 22 );
+
+    // Snowflake, sender snowflake, date and flags.
+    const int _headerSize( 8 + 8 + 4 + 1 );
+    const char _unreadFlag( 0x01 );
+
+    void packNumber( unsigned long long number, int bytes, char* data )
+    {
+        for( int i( 0 ); i < bytes; ++i )
+        {
+            data[i] = (char)( ( number >> ( ( bytes - i - 1 ) * 8 ) ) & 0xFF );
+        }
+    }
+
+    unsigned long long unpackNumber( const char* data, int bytes )
+    {
+        unsigned long long number( 0 );
+        for( int i( 0 ); i < bytes; ++i )
+        {
+            number = ( number << 8 ) | (unsigned char)data[i];
+        }
+
+        return number;
+    }
+
+    // Snowflakes are 16 hex digits, so fit in 8 bytes.
+    bool packable( const Agape::String& snowflake )
+    {
+        return( Agape::ullToHex( Agape::hexToUll( snowflake ) ) == snowflake );
+    }
+
+    void packHeader( const Telegram& header, char* headerData )
+    {
+        packNumber( Agape::hexToUll( header.m_telegramSnowflake ), 8, headerData );
+        packNumber( Agape::hexToUll( header.m_senderSnowflake ), 8, headerData + 8 );
+        packNumber( (unsigned int)header.m_dateTime, 4, headerData + 16 );
+        headerData[20] = header.m_unread ? _unreadFlag : 0;
+    }
+
+    unsigned long long snowflakeAt( const Agape::Vector< char >& data, int offset )
+    {
+        return unpackNumber( &data[offset * _headerSize], 8 );
+    }
+
+    bool unreadAt( const Agape::Vector< char >& data, int offset )
+    {
+        return( ( data[offset * _headerSize + 20] & _unreadFlag ) != 0 );
+    }
+
+    // The first header in data not before snowflake.
+    int lowerBound( const Agape::Vector< char >& data, int size, unsigned long long snowflake )
+    {
+        int low( 0 );
+        int high( size );
+        while( low < high )
+        {
+            int mid( ( low + high ) / 2 );
+            if( snowflakeAt( data, mid ) < snowflake )
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        return low;
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace TelegramLoaders
+{
+
+Index::Index( TelegramLoader& telegramLoader,
+              Agape::KiamaFS& fs,
+              const String& recipientSnowflake ) :
+  m_telegramLoader( telegramLoader ),
+  m_fs( fs ),
+  m_recipientSnowflake( recipientSnowflake ),
+  m_read( false ),
+  m_size( 0 ),
+  m_loadedSegment( -1 ),
+  m_segmentChanged( false )
+{
+}
+
+bool Index::sync()
+{
+    if( !m_read )
+    {
+        if( !read() )
+        {
+            LOG_DEBUG( "TelegramIndex: Unable to read index, rebuilding" );
+            clear();
+        }
+        m_read = true;
+    }
+
+    bool changed( false );
+    bool written( true );
+    bool success( true );
+
+    String from;
+    if( !m_afterSnowflake.empty() )
+    {
+        unsigned long long after( hexToUll( m_afterSnowflake ) );
+        unsigned long long overlap( _overlapms << _snowflakeTimeShift );
+        from = ullToHex( ( after > overlap ) ? after - overlap : 0 );
+    }
+
+    Vector< Telegram > page;
+    do
+    {
+        page.clear();
+        success = m_telegramLoader.loadPage( page, from, _pageSize );
+
+        Vector< Telegram >::const_iterator it( page.begin() );
+        for( ; success && written && ( it != page.end() ); ++it )
+        {
+            bool newer( m_afterSnowflake < it->m_telegramSnowflake );
+            int segment( 0 );
+            int offset( 0 );
+            if( !newer && ( find( it->m_telegramSnowflake, segment, offset ) >= 0 ) ) continue; // Already have it.
+
+            if( !packable( it->m_telegramSnowflake ) || !packable( it->m_senderSnowflake ) )
+            {
+                LOG_DEBUG( "TelegramIndex: Unable to index telegram " + it->m_telegramSnowflake );
+                success = false;
+                break;
+            }
+
+            if( newer )
+            {
+                written = append( *it );
+                m_afterSnowflake = it->m_telegramSnowflake;
+            }
+            else
+            {
+                // Arrived late.
+                written = ( insert( *it ) >= 0 );
+            }
+            changed = true;
+        }
+
+        if( !page.empty() ) from = page.back().m_telegramSnowflake;
+    }
+    while( success && written && ( page.size() == _pageSize ) );
+
+    // Keep what we did get, even if we didn't get everything. The manifest
+    // goes last, so that the segments as they were are still good if it
+    // isn't written.
+    if( changed )
+    {
+        written = written && flush() && writeManifest();
+        if( !written )
+        {
+            LOG_DEBUG( "TelegramIndex: Unable to write index" );
+
+            // Start again from flash next time.
+            m_read = false;
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+int Index::size() const
+{
+    return m_size;
+}
+
+Telegram Index::header( int idx ) const
+{
+    Telegram header;
+
+    int offset( 0 );
+    int segment( locate( idx, offset ) );
+    if( ( segment >= 0 ) && loadSegment( segment ) )
+    {
+        const char* headerData( &m_segmentData[offset * _headerSize] );
+        header.m_telegramSnowflake = ullToHex( unpackNumber( headerData, 8 ) );
+        header.m_senderSnowflake = ullToHex( unpackNumber( headerData + 8, 8 ) );
+        header.m_recipientSnowflake = m_recipientSnowflake;
+        header.m_dateTime = (int)unpackNumber( headerData + 16, 4 );
+        header.m_unread = ( ( headerData[20] & _unreadFlag ) != 0 );
+    }
+
+    return header;
+}
+
+String Index::after( int idx ) const
+{
+    if( idx <= 0 ) return String();
+
+    int offset( 0 );
+    int segment( locate( idx - 1, offset ) );
+    if( ( segment < 0 ) || !loadSegment( segment ) ) return String();
+
+    return ullToHex( snowflakeAt( m_segmentData, offset ) );
+}
+
+int Index::newestUnread() const
+{
+    int first( m_size );
+    for( int segment( m_segments.size() - 1 ); segment >= 0; --segment )
+    {
+        first -= m_segments[segment].m_size;
+        if( ( m_segments[segment].m_unread > 0 ) && loadSegment( segment ) )
+        {
+            for( int offset( m_segments[segment].m_size - 1 ); offset >= 0; --offset )
+            {
+                if( unreadAt( m_segmentData, offset ) ) return first + offset;
+            }
+        }
+    }
+
+    return -1;
+}
+
+bool Index::markRead( const Telegram& telegram )
+{
+    int segment( 0 );
+    int offset( 0 );
+    if( find( telegram.m_telegramSnowflake, segment, offset ) < 0 ) return false;
+
+    if( !unreadAt( m_segmentData, offset ) ) return true;
+
+    m_segmentData[offset * _headerSize + 20] &= ~_unreadFlag;
+    --m_segments[segment].m_unread;
+    m_segmentChanged = true;
+
+    return( flush() && writeManifest() );
+}
+
+bool Index::erase( const Telegram& telegram )
+{
+    int segment( 0 );
+    int offset( 0 );
+    if( find( telegram.m_telegramSnowflake, segment, offset ) < 0 ) return false;
+
+    Segment& entry( m_segments[segment] );
+    if( unreadAt( m_segmentData, offset ) ) --entry.m_unread;
+    m_segmentData.erase( m_segmentData.begin() + offset * _headerSize,
+                         m_segmentData.begin() + ( offset + 1 ) * _headerSize );
+    --entry.m_size;
+    --m_size;
+    if( ( offset == 0 ) && ( entry.m_size > 0 ) )
+    {
+        entry.m_firstSnowflake = snowflakeAt( m_segmentData, 0 );
+    }
+    m_segmentChanged = true;
+
+    return( flush() && writeManifest() );
+}
+
+bool Index::read()
+{
+    clear();
+
+    Value manifestValue;
+    Agape::KiamaFS::File* manifestFile( m_fs.file( manifestFilename() ) );
+    bool success( manifestFile->open( Agape::KiamaFS::File::OpenMode::readMode ) );
+    if( success )
+    {
+        success = Value::fromReadableWritable( *manifestFile, manifestValue );
+    }
+    else
+    {
+        // No index yet.
+        delete( manifestFile );
+        return true;
+    }
+    delete( manifestFile );
+
+    if( !success || !manifestValue.hasValue( _version ) || ( (int)manifestValue[_version] != _manifestVersion ) )
+    {
+        return false;
+    }
+
+    m_afterSnowflake = manifestValue[_afterSnowflake];
+
+    const String& segmentsData( manifestValue[_segments] );
+    if( segmentsData.size() % _segmentEntrySize != 0 ) return false;
+
+    int segments( segmentsData.size() / _segmentEntrySize );
+    m_segments.reserve( segments );
+    for( int segment( 0 ); segment < segments; ++segment )
+    {
+        const char* entryData( segmentsData.c_str() + segment * _segmentEntrySize );
+
+        Segment entry;
+        entry.m_size = (int)unpackNumber( entryData, 2 );
+        entry.m_firstSnowflake = unpackNumber( entryData + 2, 8 );
+        entry.m_unread = (int)unpackNumber( entryData + 10, 2 );
+        m_segments.push_back( entry );
+        m_size += entry.m_size;
+    }
+
+    return true;
+}
+
+void Index::clear()
+{
+    m_size = 0;
+    m_segments.clear();
+    m_afterSnowflake.clear();
+    m_loadedSegment = -1;
+    m_segmentData.clear();
+    m_segmentChanged = false;
+}
+
+int Index::find( const String& telegramSnowflake, int& segment, int& offset )
+{
+    unsigned long long snowflake( hexToUll( telegramSnowflake ) );
+    segment = segmentFor( snowflake );
+    if( ( segment < 0 ) || ( m_segments[segment].m_size == 0 ) || !useSegment( segment ) ) return -1;
+
+    offset = lowerBound( m_segmentData, m_segments[segment].m_size, snowflake );
+    if( ( offset == m_segments[segment].m_size ) || ( snowflakeAt( m_segmentData, offset ) != snowflake ) )
+    {
+        return -1;
+    }
+
+    return firstInSegment( segment ) + offset;
+}
+
+int Index::segmentFor( unsigned long long snowflake ) const
+{
+    // The last that starts at or before it, else the first with any.
+    int found( -1 );
+    for( int segment( 0 ); segment < (int)m_segments.size(); ++segment )
+    {
+        if( m_segments[segment].m_size == 0 ) continue;
+        if( ( found >= 0 ) && ( m_segments[segment].m_firstSnowflake > snowflake ) ) break;
+        found = segment;
+    }
+
+    return found;
+}
+
+int Index::locate( int idx, int& offset ) const
+{
+    if( ( idx < 0 ) || ( idx >= m_size ) ) return -1;
+
+    offset = idx;
+    int segment( 0 );
+    while( offset >= m_segments[segment].m_size )
+    {
+        offset -= m_segments[segment].m_size;
+        ++segment;
+    }
+
+    return segment;
+}
+
+int Index::firstInSegment( int segment ) const
+{
+    int first( 0 );
+    for( int i( 0 ); i < segment; ++i )
+    {
+        first += m_segments[i].m_size;
+    }
+
+    return first;
+}
+
+bool Index::append( const Telegram& header )
+{
+    if( m_segments.empty() || ( m_segments.back().m_size >= _segmentSize ) )
+    {
+        Segment entry;
+        entry.m_size = 0;
+        entry.m_firstSnowflake = 0;
+        entry.m_unread = 0;
+        m_segments.push_back( entry );
+    }
+
+    int segment( m_segments.size() - 1 );
+    if( !useSegment( segment ) ) return false;
+
+    Segment& entry( m_segments[segment] );
+    m_segmentData.resize( ( entry.m_size + 1 ) * _headerSize );
+    packHeader( header, &m_segmentData[entry.m_size * _headerSize] );
+    if( entry.m_size == 0 ) entry.m_firstSnowflake = hexToUll( header.m_telegramSnowflake );
+    if( header.m_unread ) ++entry.m_unread;
+    ++entry.m_size;
+    ++m_size;
+    m_segmentChanged = true;
+
+    return true;
+}
+
+int Index::insert( const Telegram& header )
+{
+    if( m_segments.empty() ) return( append( header ) ? 0 : -1 );
+
+    // Into the segment it falls in, which may grow past _segmentSize; later
+    // segments keep their contents.
+    unsigned long long snowflake( hexToUll( header.m_telegramSnowflake ) );
+    int segment( segmentFor( snowflake ) );
+    if( segment < 0 ) segment = 0;
+    if( !useSegment( segment ) ) return -1;
+
+    Segment& entry( m_segments[segment] );
+    int offset( lowerBound( m_segmentData, entry.m_size, snowflake ) );
+    char headerData[_headerSize];
+    packHeader( header, headerData );
+    m_segmentData.insert( m_segmentData.begin() + offset * _headerSize, headerData, headerData + _headerSize );
+    if( offset == 0 ) entry.m_firstSnowflake = snowflake;
+    if( header.m_unread ) ++entry.m_unread;
+    ++entry.m_size;
+    ++m_size;
+    m_segmentChanged = true;
+
+    return segment;
+}
+
+bool Index::loadSegment( int segment ) const
+{
+    if( m_loadedSegment == segment ) return true;
+
+    m_loadedSegment = -1;
+    int segmentSize( m_segments[segment].m_size );
+    m_segmentData.resize( segmentSize * _headerSize );
+    if( segmentSize == 0 )
+    {
+        m_loadedSegment = segment;
+        return true;
+    }
+
+    // Only as many as the manifest says, in case we were interrupted after
+    // writing the segment but before the manifest.
+    Agape::KiamaFS::File* file( m_fs.file( segmentFilename( segment ) ) );
+    bool success( file->open( Agape::KiamaFS::File::OpenMode::readMode ) &&
+                  ( file->size() >= (int)m_segmentData.size() ) );
+    if( success )
+    {
+        ReadableWritable& rw( *file ); // For the blocking read.
+        success = ( rw.read( &m_segmentData[0], m_segmentData.size(), ReadableWritable::rwBlock ) == (int)m_segmentData.size() );
+    }
+    delete( file );
+
+    if( success )
+    {
+        m_loadedSegment = segment;
+    }
+    else
+    {
+        LOG_DEBUG( "TelegramIndex: Unable to read segment " + segmentFilename( segment ) );
+    }
+
+    return success;
+}
+
+bool Index::useSegment( int segment )
+{
+    if( m_loadedSegment == segment ) return true;
+
+    return( flush() && loadSegment( segment ) );
+}
+
+bool Index::flush()
+{
+    if( !m_segmentChanged ) return true;
+
+    bool success( false );
+    Agape::KiamaFS::File* file( m_fs.file( segmentFilename( m_loadedSegment ) ) );
+    if( file->open( Agape::KiamaFS::File::OpenMode::writeMode ) )
+    {
+        success = m_segmentData.empty() || ( file->write( &m_segmentData[0], m_segmentData.size() ) == (int)m_segmentData.size() );
+        file->commit();
+        success = success && !file->error();
+    }
+    delete( file );
+
+    m_segmentChanged = false;
+    if( !success )
+    {
+        // What's in memory no longer matches flash, so start again from it.
+        LOG_DEBUG( "TelegramIndex: Unable to write segment " + segmentFilename( m_loadedSegment ) );
+        m_read = false;
+        m_loadedSegment = -1;
+    }
+
+    return success;
+}
+
+bool Index::writeManifest()
+{
+    Value manifestValue;
+    manifestValue[_version] = _manifestVersion;
+    manifestValue[_afterSnowflake] = m_afterSnowflake;
+
+    // As bytes rather than a list, which could only hold so many.
+    String segmentsData( m_segments.size() * _segmentEntrySize, '\0' );
+    for( int segment( 0 ); segment < (int)m_segments.size(); ++segment )
+    {
+        char* entryData( &segmentsData[segment * _segmentEntrySize] );
+        packNumber( m_segments[segment].m_size, 2, entryData );
+        packNumber( m_segments[segment].m_firstSnowflake, 8, entryData + 2 );
+        packNumber( m_segments[segment].m_unread, 2, entryData + 10 );
+    }
+    manifestValue[_segments] = segmentsData;
+    manifestValue[_segments].markBinary();
+
+    bool success( false );
+    Agape::KiamaFS::File* file( m_fs.file( manifestFilename() ) );
+    if( file->open( Agape::KiamaFS::File::OpenMode::writeMode ) )
+    {
+        success = manifestValue.toReadableWritable( *file );
+        file->commit();
+        success = success && !file->error();
+    }
+    delete( file );
+
+    return success;
+}
+
+// KiamaFS names are at most 24 characters.
+String Index::manifestFilename() const
+{
+    return( "ti" + m_recipientSnowflake.substr( 0, 16 ) );
+}
+
+String Index::segmentFilename( int segment ) const
+{
+    LiteStream filenameStream;
+    filenameStream << "ts" << m_recipientSnowflake.substr( 0, 16 ) << segment;
+    return filenameStream.str();
+}
+
+} // namespace TelegramLoaders
+
+} // namespace Agape
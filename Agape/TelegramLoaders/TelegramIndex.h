@@ -0,0 +1,89 @@
+#ifndef AGAPE_TELEGRAM_LOADERS_INDEX_H
+#define AGAPE_TELEGRAM_LOADERS_INDEX_H
+
+#include "World/Telegram.h"
+#include "Collections.h"
+#include "String.h"
+
+using namespace Agape::World;
+
+namespace Agape
+{
+
+class KiamaFS;
+class TelegramLoader;
+
+namespace TelegramLoaders
+{
+
+// The headers (sender, date and whether read) of the telegrams we've
+// received, kept on flash so that opening the inbox only asks the loader for
+// those after the highest snowflake we've seen (less an overlap, for any that
+// arrived late), and so that a page of the inbox can be asked for by where it
+// starts. Headers are written in segments, so that a sync only rewrites the
+// last few of them. Only the manifest (each segment's size, first snowflake
+// and unread count) is kept in memory, and one segment at a time is read
+// from flash as headers are asked for.
+//
+// Reads and deletes made elsewhere (e.g. on another device) aren't seen
+// here, so the flags are a guide to which page to show, not what to show.
+class Index
+{
+public:
+    Index( TelegramLoader& telegramLoader,
+           Agape::KiamaFS& fs,
+           const String& recipientSnowflake );
+
+    bool sync(); // Reads the index from flash if need be, then adds newer.
+
+    int size() const;
+    Telegram header( int idx ) const; // Oldest first, no subject.
+    String after( int idx ) const; // For loadPage(), to load from idx.
+    int newestUnread() const; // -1 if none.
+
+    bool markRead( const Telegram& telegram );
+    bool erase( const Telegram& telegram );
+
+private:
+    struct Segment
+    {
+        int m_size;
+        unsigned long long m_firstSnowflake; // Packed, as on flash.
+        int m_unread;
+    };
+
+    bool read();
+    void clear();
+    int find( const String& telegramSnowflake, int& segment, int& offset ); // -1 if not found.
+    int segmentFor( unsigned long long snowflake ) const;
+    int locate( int idx, int& offset ) const; // Returns the segment.
+    int firstInSegment( int segment ) const;
+    bool append( const Telegram& header );
+    int insert( const Telegram& header ); // Returns the segment, or -1.
+    bool loadSegment( int segment ) const;
+    bool useSegment( int segment ); // Writes the loaded segment first if changed.
+    bool flush();
+    bool writeManifest();
+    String manifestFilename() const;
+    String segmentFilename( int segment ) const;
+
+    TelegramLoader& m_telegramLoader;
+    Agape::KiamaFS& m_fs;
+    String m_recipientSnowflake;
+
+    bool m_read;
+    int m_size;
+    Vector< Segment > m_segments;
+    String m_afterSnowflake; // The highest seen, even if since erased.
+
+    // The one segment in memory, packed as on flash.
+    mutable int m_loadedSegment; // -1 if none.
+    mutable Vector< char > m_segmentData;
+    bool m_segmentChanged; // Since loaded, so to be written.
+};
+
+} // namespace TelegramLoaders
+
+} // namespace Agape
+
+#endif // AGAPE_TELEGRAM_LOADERS_INDEX_H
@@ -0,0 +1,456 @@
+#ifdef TELEGRAM_INDEX_TEST
+
+#include "Memories/RAMMemory.h"
+#include "TelegramLoaders/Factories/TelegramLoadersFactory.h"
+#include "TelegramLoaders/FileTelegramLoader.h"
+#include "TelegramLoaders/Linda2TelegramLoader.h"
+#include "TelegramLoaders/Linda2TelegramLoaderResponder.h"
+#include "TelegramLoaders/TelegramIndex.h"
+#include "TelegramLoaders/TelegramLoader.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "Timers/Timer.h"
+#include "Utils/StrToHex.h"
+#include "World/Telegram.h"
+#include "Collections.h"
+#include "FileWriter.h"
+#include "KiamaFS.h"
+#include "String.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Agape;
+using namespace Agape::World;
+using Agape::Linda2::TupleDispatcher;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const char* _filename( "TelegramIndexTest.dat" );
+    const char* _worldID( "test" );
+    const int _telegrams( 50000 );
+    const int _newTelegrams( 25 );
+    const int _listPageSize( 50 ); // As the inbox shows.
+
+    const unsigned long long _firstSnowflake( 0x1900000000000000ull );
+    const unsigned long long _minute( 60000ull << 22 ); // In snowflake terms.
+    const int _overlapTelegrams( 60 ); // Sent a minute apart, so the index's hour.
+    const long _maxHeapBytes( 32 * 1024 ); // Of the client's 256KB.
+
+    const String _recipient( ullToHex( 0x1800000000000001ull ) );
+    const String _other( ullToHex( 0x1800000000000002ull ) );
+
+    // Heap in use by the index, as opposed to the loader standing in for the
+    // server.
+    const size_t _blockHeaderSize( 16 );
+    bool s_countHeap( false );
+    long s_heapBytes( 0 );
+    long s_heapPeak( 0 );
+
+    void resetHeapPeak()
+    {
+        s_heapPeak = s_heapBytes;
+    }
+
+    // Allocations in here aren't the index's.
+    class Uncounted
+    {
+    public:
+        Uncounted() : m_counting( s_countHeap ) { s_countHeap = false; }
+        ~Uncounted() { s_countHeap = m_counting; }
+
+    private:
+        bool m_counting;
+    };
+
+    unsigned int s_seed( 1 );
+    unsigned int nextRandom( unsigned int range )
+    {
+        s_seed = s_seed * 1103515245 + 12345;
+        return ( ( s_seed >> 8 ) % range );
+    }
+
+    Telegram makeTelegram( int n )
+    {
+        Telegram telegram;
+        telegram.m_telegramSnowflake = ullToHex( _firstSnowflake + n * _minute );
+        telegram.m_senderSnowflake = ullToHex( 0x1800000000000100ull + nextRandom( 50 ) );
+        telegram.m_recipientSnowflake = ( n % 10 == 9 ) ? _other : _recipient; // Some for someone else.
+        telegram.m_dateTime = 1700000000 + n * 60;
+        telegram.m_unread = ( nextRandom( 100 ) < 5 );
+        telegram.m_subject = "Synthetic telegram";
+        return telegram;
+    }
+
+    // Stands in for the server's store, with telegrams in roughly, but not
+    // quite, the order they were sent. Written as File reads it, a count
+    // and then the telegrams.
+    Value s_store;
+    void writeStore()
+    {
+        FileWriter fileWriter( _filename, FileWriter::modeWrite );
+        Value( (int)( s_store.listEnd() - s_store.listBegin() ) ).toReadableWritable( fileWriter );
+        ConstListIterator it( s_store.listBegin() );
+        for( ; it != s_store.listEnd(); ++it )
+        {
+            ( *it )->toReadableWritable( fileWriter );
+        }
+    }
+
+    void writeTelegrams( int from, int to )
+    {
+        for( int n( from ); n < to; ++n )
+        {
+            int swapped( ( ( n % 7 ) == 0 ) && ( n + 1 < to ) ? n + 1 : ( ( n % 7 ) == 1 ) && ( n > from ) ? n - 1 : n );
+            Value* telegramValue( new Value );
+            makeTelegram( swapped ).toValue( *telegramValue );
+            s_store.push_back( telegramValue );
+        }
+
+        writeStore();
+    }
+
+    // Counts what's asked of the server, from the client's side.
+    class Counted : public TelegramLoader
+    {
+    public:
+        Counted( TelegramLoader& loader ) :
+          TelegramLoader( _recipient ),
+          m_loader( loader ),
+          m_loads( 0 ),
+          m_pages( 0 ),
+          m_transferred( 0 )
+        {
+        }
+
+        virtual bool load( Vector< Telegram >& telegrams )
+        {
+            ++m_loads;
+            int before( telegrams.size() );
+            bool success( m_loader.load( telegrams ) );
+            m_transferred += telegrams.size() - before;
+            return success;
+        }
+
+        virtual bool loadPage( Vector< Telegram >& telegrams, const String& afterSnowflake, int limit )
+        {
+            ++m_pages;
+            int before( telegrams.size() );
+            Uncounted uncounted;
+            bool success( m_loader.loadPage( telegrams, afterSnowflake, limit ) );
+            m_transferred += telegrams.size() - before;
+            return success;
+        }
+
+        virtual bool loadSent( Vector< Telegram >& telegrams ) { return m_loader.loadSent( telegrams ); }
+        virtual bool send( const Telegram& telegram ) { return m_loader.send( telegram ); }
+        virtual bool markRead( const Telegram& telegram ) { return m_loader.markRead( telegram ); }
+        virtual bool erase( const Telegram& telegram ) { return m_loader.erase( telegram ); }
+        virtual bool unread( Map< String, int >& numUnread, bool allDevices ) { return m_loader.unread( numUnread, allDevices ); }
+
+        void clear()
+        {
+            m_loads = 0;
+            m_pages = 0;
+            m_transferred = 0;
+        }
+
+        TelegramLoader& m_loader;
+        int m_loads;
+        int m_pages;
+        int m_transferred;
+    };
+
+    class FileFactory : public TelegramLoaders::Factory
+    {
+    public:
+        virtual TelegramLoader* makeLoader( const String& recipientSnowflake )
+        {
+            return new TelegramLoaders::File( recipientSnowflake, _filename, _worldID );
+        }
+    };
+
+    bool sameHeaders( const TelegramLoaders::Index& index, const Vector< Telegram >& telegrams )
+    {
+        if( index.size() != (int)telegrams.size() ) return false;
+
+        for( int idx( 0 ); idx < index.size(); ++idx )
+        {
+            const Telegram& header( index.header( idx ) );
+            const Telegram& telegram( telegrams[idx] );
+            if( !( header.m_telegramSnowflake == telegram.m_telegramSnowflake ) ||
+                !( header.m_senderSnowflake == telegram.m_senderSnowflake ) ||
+                ( header.m_dateTime != telegram.m_dateTime ) ||
+                ( header.m_unread != telegram.m_unread ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+// Collections allocate with malloc() rather than new, so it's malloc() that's
+// counted. Each block is preceded by its size, with whether it's counted in
+// the top bit, and where it was really allocated.
+extern "C"
+{
+void* __libc_malloc( size_t size );
+void* __libc_memalign( size_t alignment, size_t size );
+void __libc_free( void* p );
+
+namespace
+{
+    const size_t _countedBit( (size_t)1 << ( sizeof( size_t ) * 8 - 1 ) );
+
+    void* noteBlock( void* base, size_t offset, size_t size )
+    {
+        if( !base ) return nullptr;
+
+        char* p( (char*)base + offset );
+        ( (size_t*)p )[-2] = size | ( s_countHeap ? _countedBit : 0 );
+        ( (void**)p )[-1] = base;
+        if( s_countHeap )
+        {
+            s_heapBytes += size;
+            if( s_heapBytes > s_heapPeak ) s_heapPeak = s_heapBytes;
+        }
+
+        return p;
+    }
+
+    size_t blockSize( void* p )
+    {
+        return( ( (size_t*)p )[-2] & ~_countedBit );
+    }
+} // Anonymous namespace
+
+void* malloc( size_t size )
+{
+    return noteBlock( __libc_malloc( size + _blockHeaderSize ), _blockHeaderSize, size );
+}
+
+void free( void* p )
+{
+    if( !p ) return;
+
+    if( ( (size_t*)p )[-2] & _countedBit ) s_heapBytes -= blockSize( p );
+    __libc_free( ( (void**)p )[-1] );
+}
+
+void* calloc( size_t count, size_t size )
+{
+    void* p( malloc( count * size ) );
+    if( p ) ::memset( p, 0, count * size );
+    return p;
+}
+
+void* realloc( void* p, size_t size )
+{
+    void* moved( malloc( size ) );
+    if( moved && p )
+    {
+        ::memcpy( moved, p, std::min( size, blockSize( p ) ) );
+        free( p );
+    }
+    return moved;
+}
+
+void* memalign( size_t alignment, size_t size )
+{
+    size_t offset( alignment > _blockHeaderSize ? alignment : _blockHeaderSize );
+    return noteBlock( __libc_memalign( alignment, size + offset ), offset, size );
+}
+
+void* aligned_alloc( size_t alignment, size_t size )
+{
+    return memalign( alignment, size );
+}
+
+int posix_memalign( void** p, size_t alignment, size_t size )
+{
+    *p = memalign( alignment, size );
+    return *p ? 0 : ENOMEM;
+}
+} // extern "C"
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    remove( _filename );
+    writeTelegrams( 0, _telegrams );
+
+    Timers::Factories::HighRes timerFactory;
+    Timer* timer( timerFactory.makeTimer() );
+
+    TelegramLoaders::File fileLoader( _recipient, _filename, _worldID );
+    Counted countedLoader( fileLoader );
+
+    // Everything, as the inbox used to load on every open.
+    Vector< Telegram > all;
+    timer->reset();
+    fileLoader.load( all );
+    long loadMs( timer->ms() );
+    std::sort( all.begin(), all.end(), Telegram::snowflakeBefore );
+
+    // Walking the pages gives each telegram once, in snowflake order.
+    {
+    Vector< Telegram > paged;
+    Vector< Telegram > page;
+    do
+    {
+        page.clear();
+        fileLoader.loadPage( page, paged.empty() ? String() : paged.back().m_telegramSnowflake, 1000 );
+        paged.insert( paged.end(), page.begin(), page.end() );
+    }
+    while( page.size() == 1000 );
+
+    bool same( paged.size() == all.size() );
+    for( unsigned int idx( 0 ); same && ( idx < paged.size() ); ++idx )
+    {
+        same = ( paged[idx] == all[idx] );
+    }
+    success = check( "Paging", same && ( all.size() == ( _telegrams * 9 / 10 ) ) ) && success;
+    }
+
+    // The client's flash.
+    Memories::RAM memory( 0x400000, 0x100, 0x1000, Memory::flash );
+    KiamaFS fs( memory );
+
+    // The first open fetches every header, a page at a time.
+    {
+    TelegramLoaders::Index index( countedLoader, fs, _recipient );
+    timer->reset();
+    bool synced( index.sync() );
+    long syncMs( timer->ms() );
+    std::cout << "Cold: " << countedLoader.m_transferred << " telegrams in " << countedLoader.m_pages
+              << " pages, " << syncMs << "ms" << std::endl;
+    success = check( "Cold", synced && sameHeaders( index, all ) &&
+                             ( countedLoader.m_transferred == (int)all.size() ) &&
+                             ( countedLoader.m_loads == 0 ) ) && success;
+    }
+
+    // Later opens read the manifest from flash and only ask for anything
+    // newer, and the last hour again. Headers are read as they're asked for,
+    // so the index's heap doesn't grow with the inbox.
+    {
+    countedLoader.clear();
+    long heapBefore( s_heapBytes );
+    resetHeapPeak();
+    s_countHeap = true;
+    TelegramLoaders::Index index( countedLoader, fs, _recipient );
+    timer->reset();
+    bool synced( index.sync() );
+    long syncMs( timer->ms() );
+    bool walked( sameHeaders( index, all ) && ( index.newestUnread() >= 0 ) );
+    s_countHeap = false;
+    long heapPeak( s_heapPeak - heapBefore );
+    std::cout << "Heap: " << heapPeak << " bytes at most for " << index.size() << " headers" << std::endl;
+    success = check( "Heap", walked && ( heapPeak <= _maxHeapBytes ) ) && success;
+    std::cout << "Warm: " << countedLoader.m_transferred << " telegrams in " << countedLoader.m_pages
+              << " pages, " << syncMs << "ms, against " << all.size() << " telegrams in "
+              << loadMs << "ms to load all" << std::endl;
+    success = check( "Warm", synced && sameHeaders( index, all ) &&
+                             ( countedLoader.m_transferred <= _overlapTelegrams ) && ( countedLoader.m_pages == 1 ) ) && success;
+
+    writeTelegrams( _telegrams, _telegrams + _newTelegrams );
+    int before( all.size() );
+    all.clear();
+    fileLoader.load( all );
+    std::sort( all.begin(), all.end(), Telegram::snowflakeBefore );
+
+    countedLoader.clear();
+    synced = index.sync();
+    success = check( "Incremental", synced && sameHeaders( index, all ) &&
+                                    ( countedLoader.m_transferred <= (int)all.size() - before + _overlapTelegrams ) &&
+                                    ( countedLoader.m_pages == 1 ) ) && success;
+
+    // One sent from a clock running behind arrives after those with higher
+    // snowflakes, and is still indexed, in its place.
+    Telegram late( makeTelegram( _telegrams + _newTelegrams - 10 ) );
+    late.m_telegramSnowflake = ullToHex( hexToUll( late.m_telegramSnowflake ) + 1 );
+    late.m_recipientSnowflake = _recipient;
+    Value* lateValue( new Value );
+    late.toValue( *lateValue );
+    s_store.push_back( lateValue );
+    writeStore();
+    all.clear();
+    fileLoader.load( all );
+    std::sort( all.begin(), all.end(), Telegram::snowflakeBefore );
+
+    synced = index.sync();
+    TelegramLoaders::Index lateReopened( countedLoader, fs, _recipient );
+    success = check( "Late", synced && sameHeaders( index, all ) &&
+                             lateReopened.sync() && sameHeaders( lateReopened, all ) ) && success;
+
+    // A page of the inbox can be asked for from anywhere in it.
+    Vector< Telegram > page;
+    int first( index.size() - _listPageSize * 3 );
+    bool loaded( countedLoader.loadPage( page, index.after( first ), _listPageSize ) );
+    bool same( loaded && ( page.size() == _listPageSize ) );
+    for( int idx( 0 ); same && ( idx < _listPageSize ); ++idx )
+    {
+        same = ( page[idx] == all[first + idx] );
+    }
+    page.clear();
+    loaded = countedLoader.loadPage( page, index.after( 0 ), _listPageSize );
+    same = same && loaded && ( page.size() == _listPageSize ) && ( page.front() == all.front() );
+    success = check( "Pages", same ) && success;
+
+    // Reads and deletes are kept.
+    int newestUnread( index.newestUnread() );
+    Telegram read( index.header( newestUnread ) );
+    Telegram erased( index.header( 1234 ) );
+    bool changed( ( newestUnread >= 0 ) && index.markRead( read ) && index.erase( erased ) );
+
+    TelegramLoaders::Index reopened( countedLoader, fs, _recipient );
+    bool reopenedOK( reopened.sync() && ( reopened.size() == (int)all.size() - 1 ) &&
+                     ( reopened.newestUnread() < newestUnread - 1 ) &&
+                     ( reopened.header( 1234 ) == all[1235] ) );
+    success = check( "Changes kept", changed && reopenedOK ) && success;
+    }
+
+    // Pages are served through Linda2 as loads are.
+    {
+    TupleDispatcher tupleDispatcher;
+    TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+    tupleRouter.setMyID( "Test" );
+    FileFactory fileFactory;
+    TelegramLoaders::Linda2Responder responder( tupleRouter, fileFactory );
+    TelegramLoaders::Linda2 linda2Loader( _recipient, tupleRouter, timerFactory );
+
+    Vector< Telegram > page;
+    bool loaded( linda2Loader.loadPage( page, all[99].m_telegramSnowflake, 100 ) );
+    bool same( loaded && ( page.size() == 100 ) );
+    for( int idx( 0 ); same && ( idx < 100 ); ++idx )
+    {
+        same = ( page[idx] == all[100 + idx] );
+    }
+    success = check( "Linda2", same ) && success;
+    }
+
+    delete( timer );
+    remove( _filename );
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // TELEGRAM_INDEX_TEST
@@ -17,6 +17,12 @@ public:
     virtual ~TelegramLoader();
 
     virtual bool load( Vector< Telegram >& telegrams ) = 0;
+    // Up to limit received telegrams with snowflakes after afterSnowflake
+    // (or from the first if empty), oldest first. Snowflakes are fixed width
+    // hex, so they order as strings.
+    virtual bool loadPage( Vector< Telegram >& telegrams,
+                           const String& afterSnowflake,
+                           int limit ) = 0;
     virtual bool loadSent( Vector< Telegram >& telegrams ) = 0;
     virtual bool send( const Telegram& telegram ) = 0;
     virtual bool markRead( const Telegram& telegram ) = 0;
@@ -1,5 +1,6 @@
 #include "Allocator.h"
 #include "Assets/Asset.h"
+#include "Assets/CompiledANSI.h"
 #include "Timers/Timer.h"
 #include "Utils/Cartesian.h"
 #include "Utils/Tokeniser.h"
@@ -155,6 +156,7 @@ Terminal::Terminal( int width,
   m_drawTerminal( drawTerminal ),
   m_haveBuffer( haveBuffer ),
   m_buffer( nullptr ),
+  m_firstRow( 0 ),
   m_clipHeight( 0 ),
   m_clipWidth( 0 ),
   m_cursorVariant( 0 )
@@ -168,6 +170,11 @@ Terminal::Terminal( int width,
             *( m_buffer + ( ( i * 2 ) + 1 ) ) = 0; // rand();
         }
 
+        for( int row = 0; row < height; ++row )
+        {
+            m_rows.push_back( m_buffer + ( row * width * 2 ) );
+        }
+
         //repaint();
     }
 }
@@ -209,11 +216,12 @@ void Terminal::repaint( int row, int col, int height, int width )
     if( !m_haveBuffer ) return;
 
     // Draw static characters.
-    for( int curRow = row; ( curRow < ( row + height ) ) && ( curRow < m_height ); ++curRow )
+    int fromRow( ( row < 0 ) ? 0 : row );
+    int fromCol( ( col < 0 ) ? 0 : col );
+    for( int curRow = fromRow; ( curRow < ( row + height ) ) && ( curRow < m_height ); ++curRow )
     {
-        int offset( ( ( curRow * m_width ) + col ) * 2 );
-        char* glyphsAttrs( m_buffer + offset );
-        for( int curCol = col; ( curCol < ( col + width ) ) && ( curCol < m_width ); ++curCol )
+        char* glyphsAttrs( cell( curRow, fromCol ) );
+        for( int curCol = fromCol; ( curCol < ( col + width ) ) && ( curCol < m_width ); ++curCol )
         {
             m_graphicsDriver.paintGlyph( m_windowName, curRow, curCol, glyphsAttrs );
             glyphsAttrs += 2;
@@ -288,7 +296,13 @@ void Terminal::clearLines( int from, int len, bool resetAttributes )
         m_graphicsDriver.clearLines( m_windowName, from, len );
         m_row = from;
         m_col = 0;
-        if( m_haveBuffer ) ::memset( m_buffer + ( m_width * from * 2 ), 0, m_width * len * 2 );
+        if( m_haveBuffer )
+        {
+            for( int row = from; row < ( from + len ); ++row )
+            {
+                ::memset( cell( row, 0 ), 0, m_width * 2 );
+            }
+        }
 
         // FIXME: Clear sprites overlapping? Haven't done this yet as this is only
         // used where sprites aren't used or relevant (e.g. chat window).
@@ -302,11 +316,9 @@ void Terminal::clearLines( int from, int len, bool resetAttributes )
 
 void Terminal::fillScreen( char c, char attributes, int from, int len, int charMode )
 {
-    char* glyphsAttrs( m_buffer );
-    glyphsAttrs += from * m_width * 2;
-
     for( m_row = from; m_row < ( len == -1 ? m_height : from + len ); ++m_row )
     {
+        char* glyphsAttrs( m_haveBuffer ? cell( m_row, 0 ) : nullptr );
         for( m_col = 0; m_col < m_width; ++m_col )
         {
             if( m_haveBuffer && !( charMode & transient ) )
@@ -339,39 +351,122 @@ void Terminal::scrollScreen( bool down, int from, int len )
 {
     if( len == -1 ) len = m_height;
 
-    // FIXME: Use hardware scroll, if supported by graphics driver.
     if( !m_haveBuffer ) return;
+    if( ( from < 0 ) || ( len < 1 ) || ( ( from + len ) > m_height ) ) return;
 
-    //std::cerr << "Scroll screen" << std::endl;
-    char* base( m_buffer );
-    if( down )
+    int end( from + len );
+    int step( down ? -1 : 1 );
+    int exposedRow( down ? ( end - 1 ) : from );
+
+    if( len == m_height )
+    {
+        // The whole screen just starts a row later (or earlier).
+        m_firstRow = ( m_firstRow + ( down ? 1 : ( m_height - 1 ) ) ) % m_height;
+    }
+    else
     {
-        for( int i = m_width * ( from + 1 ) * 2; i < m_width * ( from + len ) * 2; ++i )
+        // Rotate the region's rows, the one scrolled out becoming the one
+        // exposed.
+        char* scrolledOut( rowBuffer( down ? from : ( end - 1 ) ) );
+        if( down )
         {
-            *( base + i - ( m_width * 1 * 2 ) ) = *( base + i );
+            for( int row = from; row < ( end - 1 ); ++row )
+            {
+                rowBuffer( row ) = rowBuffer( row + 1 );
+            }
         }
-
-        for( int i = m_width * ( from + len - 1 ) * 2; i < m_width * ( from + len ) * 2; ++i )
+        else
         {
-            *( base + i ) = '\0';
+            for( int row = end - 1; row > from; --row )
+            {
+                rowBuffer( row ) = rowBuffer( row - 1 );
+            }
         }
+        rowBuffer( exposedRow ) = scrolledOut;
     }
-    else
+    ::memset( cell( exposedRow, 0 ), 0, m_width * 2 );
+
+    bool scrolled( m_graphicsDriver.scrollRegion( m_windowName, from, len, down ) );
+
+    // Sprites in the region scroll with the characters under them, and off
+    // the region with them too. Those straddling its edge stay put, but if
+    // the driver has moved the part inside, that needs painting again.
+    Vector< Rectangle > repaints;
+    Vector< Sprite* >::iterator spriteIt( m_sprites.begin() );
+    while( spriteIt != m_sprites.end() )
     {
-        for( int i = ( m_width * ( from + len - 1 ) * 2 ) - 1; i >= ( m_width * from * 2 ); --i )
+        Sprite& sprite( **spriteIt );
+        int top( sprite.m_row );
+        int bottom( sprite.m_row + sprite.m_height );
+        int repaintTop( top + step );
+        int repaintBottom( bottom + step );
+
+        if( ( top >= from ) && ( bottom <= end ) )
         {
-            *( base + i + ( m_width * 2 ) ) = *( base + i );
+            if( ( repaintTop >= from ) && ( repaintBottom <= end ) )
+            {
+                sprite.m_row += step;
+                ++spriteIt;
+                continue;
+            }
+
+            delete( *spriteIt );
+            spriteIt = m_sprites.erase( spriteIt );
+        }
+        else
+        {
+            if( ( top >= end ) || ( bottom <= from ) )
+            {
+                ++spriteIt;
+                continue;
+            }
+
+            // Both where it is and where the driver moved it to.
+            if( down ) repaintBottom = bottom;
+            else repaintTop = top;
+            ++spriteIt;
         }
 
-        for( int i = ( m_width * from * 2 ); i < m_width * ( from + 1 ) * 2; ++i )
+        if( scrolled )
         {
-            *( base + i ) = '\0';
+            if( repaintTop < from ) repaintTop = from;
+            if( repaintBottom > end ) repaintBottom = end;
+            if( repaintTop < repaintBottom )
+            {
+                repaints.push_back( Rectangle( sprite.m_col, repaintTop, repaintBottom - repaintTop, sprite.m_width ) );
+            }
+        }
+    }
+
+    if( !scrolled )
+    {
+        repaint( from, 0, len, m_width );
+        return;
+    }
+
+    repaint( exposedRow, 0, 1, m_width );
+
+    Vector< Rectangle >::const_iterator repaintIt( repaints.begin() );
+    for( ; repaintIt != repaints.end(); ++repaintIt )
+    {
+        repaint( repaintIt->originY(), repaintIt->originX(), repaintIt->height(), repaintIt->width() );
+    }
+
+    // Cursors don't scroll, so put back what the driver moved over where
+    // each was moved to, and redraw it where it is.
+    Vector< Cursor >::const_iterator cursorIt;
+    for( cursorIt = m_cursors.begin(); cursorIt != m_cursors.end(); ++cursorIt )
+    {
+        if( cursorIt->m_visible && ( cursorIt->m_row >= from ) && ( cursorIt->m_row < end ) )
+        {
+            int movedRow( cursorIt->m_row + step );
+            if( ( movedRow >= from ) && ( movedRow < end ) )
+            {
+                repaint( movedRow, cursorIt->m_col, 1, 1 );
+            }
+            repaint( cursorIt->m_row, cursorIt->m_col, 1, 1 );
         }
     }
-    repaint();
-    
-    // FIXME: Hardware scroll?
-    // FIXME: Scroll sprite characters?
 }
 
 void Terminal::transientBlank()
@@ -458,16 +553,17 @@ void Terminal::insertAtCursor( char c,
     {
         // Shuffle all characters and attributes along one position to end of
         // line. Character at end of line, if any, will be overwritten.
-        int startOffset( ( ( m_width * 2 ) * row ) + ( col * 2 ) );
-        int endOffset( ( ( m_width * 2 ) * row ) + ( ( fieldStart + fieldWidth ) * 2 ) - 2 );
-        for( int i = endOffset; i >= startOffset; --i )
+        char* line( cell( row, 0 ) );
+        int startOffset( col * 2 );
+        int endOffset( ( ( fieldStart + fieldWidth ) * 2 ) - 2 );
+        for( int i = endOffset - 1; i >= startOffset; --i )
         {
-            m_buffer[i+2] = m_buffer[i];
+            line[i+2] = line[i];
         }
 
         // Insert new. Preserve background attributes.
-        m_buffer[startOffset] = c;
-        m_buffer[startOffset + 1] = ( m_buffer[startOffset + 1] & 0xF0 ) + m_characterAttributes;
+        line[startOffset] = c;
+        line[startOffset + 1] = ( line[startOffset + 1] & 0xF0 ) + m_characterAttributes;
 
         if( cursorName == "Terminal" )
         {
@@ -502,15 +598,16 @@ void Terminal::backspaceAtCursor( const String& cursorName,
     {
         // Shuffle all characters and attributes back one position from end
         // of line.
-        int startOffset( ( ( m_width * 2 ) * row ) + ( col * 2 ) );
-        int endOffset( ( ( m_width * 2 ) * row ) + ( ( fieldStart + fieldWidth ) * 2 ) );
-        for( int i = startOffset; i <= endOffset; ++i )
+        char* line( cell( row, 0 ) );
+        int startOffset( col * 2 );
+        int endOffset( ( fieldStart + fieldWidth ) * 2 );
+        for( int i = startOffset; i < endOffset; ++i )
         {
-            m_buffer[i-2] = m_buffer[i];
+            line[i-2] = line[i];
         }
 
         // Remove trailing character at end of line.
-        m_buffer[endOffset - 2] = '\0';
+        line[endOffset - 2] = '\0';
 
         if( cursorName == "Terminal" )
         {
@@ -581,6 +678,68 @@ int Terminal::consumeAsset( const Asset& asset,
     return lenRead;
 }
 
+void Terminal::consumeCompiled( const Assets::CompiledANSI& compiled,
+                                int frame,
+                                int charMode,
+                                char* drawMap,
+                                int mapValue,
+                                char charset )
+{
+    if( charset == -1 ) charset = 0; // Only ANSITerminal keeps a current one.
+
+    int startRow( m_row );
+    int startCol( m_col );
+
+    Character cx;
+    const Assets::CompiledANSI::Run* run( compiled.begin( frame ) );
+    const Assets::CompiledANSI::Run* end( compiled.end( frame ) );
+    for( ; run != end; ++run )
+    {
+        int row( startRow + run->m_row );
+        if( ( row < 0 ) || ( row >= m_height ) ||
+            isTransparentWhitespace( run->m_character, run->m_attributes, charMode ) )
+        {
+            continue;
+        }
+
+        // Drop whatever falls off the screen, as consumeChar() would.
+        int fromCol( startCol + run->m_col );
+        int toCol( fromCol + run->m_length );
+        if( fromCol < 0 ) fromCol = 0;
+        if( toCol > m_width ) toCol = m_width;
+
+        cx.m_row = row;
+        cx.m_character = run->m_character;
+        cx.m_attributes = run->m_attributes;
+        cx.m_charset = ( run->m_charset == -1 ) ? charset : run->m_charset;
+        for( int col( fromCol ); col < toCol; ++col )
+        {
+            cx.m_col = col;
+            putCharacter( cx, charMode );
+        }
+
+        if( ( drawMap != nullptr ) && ( fromCol < toCol ) )
+        {
+            ::memset( drawMap + ( row * m_width ) + fromCol, mapValue, toCol - fromCol );
+        }
+    }
+
+    m_row = startRow + compiled.endRow( frame );
+    m_col = startCol + compiled.endCol( frame );
+
+    if( m_terminalCursorEnabled )
+    {
+        int cursorRow = m_row;
+        int cursorCol = m_col;
+        if( cursorRow < 0 ) cursorRow = 0;
+        if( cursorRow >= m_height ) cursorRow = m_height - 1;
+        if( cursorCol < 0 ) cursorCol = 0;
+        if( cursorCol >= m_width ) cursorCol = m_width - 1;
+
+        moveCursor( "Terminal", cursorRow, cursorCol );
+    }
+}
+
 void Terminal::createSprite( const String& name,
                              const String& assetName,
                              const Asset& asset,
@@ -604,7 +763,6 @@ void Terminal::createSprite( const String& name,
                                  numFrames );
 
     int frameSize( height * width * 2 );
-    int srcRowSize( m_drawTerminal->width() * 2 );
     int destRowSize( width * 2 );
     int assetOffset( 0 );
 
@@ -627,7 +785,7 @@ void Terminal::createSprite( const String& name,
         for( int y = 0; y < height; ++y )
         {
             ::memcpy( sprite->m_buffer + destStartOffset + ( y * destRowSize ),
-                      m_drawTerminal->m_buffer + ( y * srcRowSize ),
+                      m_drawTerminal->cell( y, 0 ),
                       destRowSize );
         }
     }
@@ -637,6 +795,61 @@ void Terminal::createSprite( const String& name,
     m_sprites.push_back( sprite );
 }
 
+void Terminal::createSprite( const String& name,
+                             const String& assetName,
+                             const Assets::CompiledANSI& compiled,
+                             int row,
+                             int col,
+                             int charMode )
+{
+    if( !m_haveBuffer ) return;
+
+    int height( compiled.height() );
+    int width( compiled.width() );
+    int numFrames( compiled.frames() );
+
+    Sprite* sprite = new Sprite( name,
+                                 assetName,
+                                 row,
+                                 col,
+                                 height,
+                                 width,
+                                 charMode,
+                                 numFrames );
+
+    // Fill the frames straight from the runs, rather than drawing each on
+    // the draw terminal and copying it out.
+    int frameSize( height * width * 2 );
+    ::memset( sprite->m_buffer, 0, frameSize * numFrames );
+
+    for( int frameNum = 0; frameNum < numFrames; ++frameNum )
+    {
+        char* frame( sprite->m_buffer + ( frameNum * frameSize ) );
+
+        const Assets::CompiledANSI::Run* run( compiled.begin( frameNum ) );
+        const Assets::CompiledANSI::Run* end( compiled.end( frameNum ) );
+        for( ; run != end; ++run )
+        {
+            if( ( run->m_row >= height ) ||
+                isTransparentWhitespace( run->m_character, run->m_attributes, charMode ) )
+            {
+                continue;
+            }
+
+            char* cell( frame + ( ( ( run->m_row * width ) + run->m_col ) * 2 ) );
+            for( int x = 0; x < run->m_length; ++x )
+            {
+                *cell++ = run->m_character;
+                *cell++ = run->m_attributes;
+            }
+        }
+    }
+
+    drawSprite( *sprite );
+
+    m_sprites.push_back( sprite );
+}
+
 bool Terminal::isSprite( const String& name ) const
 {
     Vector< Sprite* >::const_iterator it( m_sprites.begin() );
@@ -820,9 +1033,9 @@ void Terminal::getBaseCharAt( int row, int col, char& character, char& attribute
     // FIXME: Return sprite characters here? Haven't done this yet as it's
     // only relevant for the map and it's probably not a big deal if sprites
     // don't show up on the map.
-    int offset( ( ( row * m_width ) + col ) * 2 );
-    character = *( m_buffer + offset );
-    attributes = *( m_buffer + offset + 1 );
+    const char* glyphAttr( cell( row, col ) );
+    character = *glyphAttr;
+    attributes = *( glyphAttr + 1 );
 }
 
 int Terminal::countPrinting( const String& string ) const
@@ -1139,19 +1352,11 @@ void Terminal::clipCopy( int row, int col, int height, int width )
     if( ( row < 0 ) || ( ( row + height ) > m_height ) || ( ( row + height ) > m_drawTerminal->m_height ) ||
         ( col < 0 ) || ( ( col + width ) > m_width ) || ( ( col + width ) > m_drawTerminal->m_width ) ) return;
 
-    int sourceRowWidthBytes( m_width * 2 );
-    int destRowWidthBytes( m_drawTerminal->m_width * 2 );
-
-    int sourceStartOffset( ( row * sourceRowWidthBytes ) + ( col * 2 ) );
     int copyWidthBytes( width * 2 );
 
-    char* sourcePtr( m_buffer + sourceStartOffset );
-    char* destPtr( m_drawTerminal->m_buffer );
     for( int copyRow = row; copyRow < ( row + height ); ++copyRow )
     {
-        ::memcpy( destPtr, sourcePtr, copyWidthBytes );
-        sourcePtr += sourceRowWidthBytes;
-        destPtr += destRowWidthBytes;
+        ::memcpy( m_drawTerminal->cell( copyRow - row, 0 ), cell( copyRow, col ), copyWidthBytes );
     }
 
     m_clipHeight = height;
@@ -1167,14 +1372,10 @@ void Terminal::clipCut( int row, int col, int height, int width )
 
     clipCopy( row, col, height, width );
 
-    int rowWidthBytes( m_width * 2 );
-    int startOffset( ( row * rowWidthBytes ) + ( col * 2 ) );
     int eraseWidthBytes( width * 2 );
-    char* destPtr( m_buffer + startOffset );
     for( int eraseRow = row; eraseRow < ( row + height ); ++eraseRow )
     {
-        ::memset( destPtr, '\0', eraseWidthBytes );
-        destPtr += rowWidthBytes;
+        ::memset( cell( eraseRow, col ), '\0', eraseWidthBytes );
     }
 
     repaint( row, col, height, width );
@@ -1187,23 +1388,15 @@ void Terminal::clipPaste( int row, int col, int cropRow, int cropCol )
     if( ( cropRow == -1 ) || ( cropRow > m_height ) ) cropRow = m_height;
     if( ( cropCol == -1 ) || ( cropCol > m_width ) ) cropCol = m_width;
 
-    int sourceRowWidthBytes( m_drawTerminal->m_width * 2 );
-    int destRowWidthBytes( m_width * 2 );
-
-    int destStartOffset( ( row * destRowWidthBytes ) + ( col * 2 ) );
     int destMaxWidth( cropCol - col );
     int copyWidthBytes = ( m_clipWidth > destMaxWidth ) ? ( destMaxWidth * 2 ) : ( m_clipWidth * 2 );
 
     int destMaxHeight( cropRow - row );
     int copyHeight = ( m_clipHeight > destMaxHeight ) ? destMaxHeight : m_clipHeight;
 
-    char* sourcePtr( m_drawTerminal->m_buffer );
-    char* destPtr( m_buffer + destStartOffset );
     for( int copyRow = row; copyRow < ( row + copyHeight ); ++copyRow )
     {
-        ::memcpy( destPtr, sourcePtr, copyWidthBytes );
-        sourcePtr += sourceRowWidthBytes;
-        destPtr += destRowWidthBytes;
+        ::memcpy( cell( copyRow, col ), m_drawTerminal->cell( copyRow - row, 0 ), copyWidthBytes );
     }
 
     repaint( row, col, m_clipHeight, m_clipWidth );
@@ -1289,7 +1482,17 @@ char Terminal::attributes( int bgColour, int fgColour )
 
 const char* Terminal::buffer() const
 {
-    return m_buffer;
+    if( !m_haveBuffer ) return m_buffer;
+
+    // Rows are only in order in m_buffer until the screen first scrolls.
+    int rowSize( m_width * 2 );
+    m_linearBuffer.resize( rowSize * m_height );
+    for( int row = 0; row < m_height; ++row )
+    {
+        ::memcpy( &m_linearBuffer[row * rowSize], cell( row, 0 ), rowSize );
+    }
+
+    return &m_linearBuffer[0];
 }
 
 void Terminal::flush()
@@ -1334,10 +1537,9 @@ void Terminal::run()
                 for( int rowOffset = 0; rowOffset < sprite.m_height; ++rowOffset )
                 {
                     int spriteOffset( ( rowOffset * sprite.m_width ) * 2 );
-                    int offset( ( ( ( sprite.m_row + rowOffset ) * m_width ) + sprite.m_col ) * 2 );
 
                     char* spriteGlyphsAttrs( sprite.m_buffer + spriteOffset );
-                    char* glyphsAttrs( m_buffer + offset );
+                    char* glyphsAttrs( cell( sprite.m_row + rowOffset, sprite.m_col ) );
 
                     for( int colOffset = 0; colOffset < sprite.m_width; ++colOffset )
                     {
@@ -1369,9 +1571,8 @@ void Terminal::run()
 
 void Terminal::putCharacter( Character c, int charMode )
 {
-    int offset( ( ( c.m_row * m_width ) + c.m_col ) * 2 );
-    char* charPtr( m_buffer + offset );
-    char* attributePtr( m_buffer + offset + 1 );
+    char* charPtr( m_haveBuffer ? cell( c.m_row, c.m_col ) : nullptr );
+    char* attributePtr( m_haveBuffer ? charPtr + 1 : nullptr );
 
     if( m_haveBuffer &&
         ( *charPtr == c.m_character ) &&
@@ -1419,13 +1620,13 @@ void Terminal::eraseCharacter( int charMode )
 {
     if( !m_haveBuffer ) return;
 
-    int offset( ( ( m_row * m_width ) + m_col ) * 2 );
-    *( m_buffer + offset ) = '\0';
+    char* glyphAttr( cell( m_row, m_col ) );
+    *glyphAttr = '\0';
     if( !( charMode & preserveBackground ) )
     {
-        *( m_buffer + offset + 1 ) = 0;
+        *( glyphAttr + 1 ) = 0;
     }
-    m_graphicsDriver.paintGlyph( m_windowName, m_row, m_col, m_buffer + offset );
+    m_graphicsDriver.paintGlyph( m_windowName, m_row, m_col, glyphAttr );
 
     // This is probably only relevant for text fields, so cursors and/or sprite
     // characters are not erased here.
@@ -1441,6 +1642,20 @@ bool Terminal::isTransparentWhitespace( char character, char attributes, int cha
     return( ( charMode & whitespaceTransparency ) && ( character == '\x00' || character == ' ' ) && ( ( *((unsigned char*)&attributes) & 0xF0 ) == 0 ) );
 }
 
+char* Terminal::cell( int row, int col ) const
+{
+    int physicalRow( m_firstRow + row );
+    if( physicalRow >= m_height ) physicalRow -= m_height;
+    return m_rows[physicalRow] + ( col * 2 );
+}
+
+char*& Terminal::rowBuffer( int row )
+{
+    int physicalRow( m_firstRow + row );
+    if( physicalRow >= m_height ) physicalRow -= m_height;
+    return m_rows[physicalRow];
+}
+
 void Terminal::drawCursor( const Cursor& cursor )
 {
     Character cx;
@@ -13,6 +13,11 @@ class Asset;
 class GraphicsDriver;
 class Timer;
 
+namespace Assets
+{
+class CompiledANSI;
+} // namespace Assets
+
 class Terminal : public Runnable
 {
 public:
@@ -162,6 +167,17 @@ public:
                       int charMode = 0,
                       char* drawMap = nullptr,
                       int mapValue = 0 );
+
+    // Draws a frame of an asset already interpreted by Assets::CompiledANSI,
+    // as consumeAsset() would with scroll lock on, from the current position
+    // as its left edge. Runs the asset didn't choose a charset for are drawn
+    // in charset, or the current one.
+    virtual void consumeCompiled( const Assets::CompiledANSI& compiled,
+                                  int frame = 0,
+                                  int charMode = 0,
+                                  char* drawMap = nullptr,
+                                  int mapValue = 0,
+                                  char charset = -1 );
     
     void createSprite( const String& name,
                        const String& assetName,
@@ -173,6 +189,12 @@ public:
                        int width,
                        int charMode = 0,
                        int numFrames = 1 );
+    void createSprite( const String& name,
+                       const String& assetName,
+                       const Assets::CompiledANSI& compiled,
+                       int row,
+                       int col,
+                       int charMode = 0 );
     bool isSprite( const String& name ) const;
     bool spriteData( const String& name,
                      String& assetName,
@@ -229,6 +251,8 @@ public:
     static char attributes( const String& colour );
     static char attributes( int bgColour, int fgColour );
 
+    // Characters and attributes of each row in turn. Only valid until the
+    // screen next changes.
     const char* buffer() const;
 
     void flush();
@@ -315,6 +339,9 @@ private:
         Sprite& operator=( const Sprite& other ) { return *this; };
     };
 
+    char* cell( int row, int col ) const;
+    char*& rowBuffer( int row );
+
     void drawCursor( const Cursor& cursor );
 
     void drawSprite( const Sprite& sprite,
@@ -330,6 +357,13 @@ private:
     bool m_haveBuffer;
     char* m_buffer;
 
+    // The rows of m_buffer in the order they're on screen, starting from
+    // m_firstRow and wrapping, so that scrolling moves row pointers rather
+    // than characters.
+    Vector< char* > m_rows;
+    int m_firstRow;
+    mutable Vector< char > m_linearBuffer;
+
     Vector< Cursor > m_cursors;
     Vector< Sprite* > m_sprites;
 
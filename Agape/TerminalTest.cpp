@@ -0,0 +1,283 @@
+#ifdef TERMINAL_TEST
+
+#include "AssetLoaders/AssetLoader.h"
+#include "Assets/Asset.h"
+#include "Assets/CompiledANSI.h"
+#include "GraphicsDrivers/GraphicsDriver.h"
+#include "GraphicsDrivers/Headless.h"
+#include "Timers/Timer.h"
+#include "World/WorldCoordinates.h"
+#include "ANSITerminal.h"
+#include "Collections.h"
+#include "String.h"
+#include "Terminal.h"
+
+#include <iostream>
+#include <string>
+
+#include <string.h>
+#include <time.h>
+
+using namespace Agape;
+using Agape::Assets::CompiledANSI;
+
+namespace
+{
+    const int _screenWidth( 80 );
+    const int _screenHeight( 25 );
+    const int _chatLines( 10000 );
+    const int _numTrials( 5 );
+    const int _numAttempts( 5 );
+    const double _minSpeedup( 3.0 );
+
+    class MemoryLoader : public AssetLoader
+    {
+    public:
+        MemoryLoader( const std::string& data ) :
+          AssetLoader( World::Coordinates(), "test" ),
+          m_data( data )
+        {
+        }
+
+        virtual bool open() { return true; }
+
+        virtual int read( char* data, int offset, int len )
+        {
+            int available( (int)m_data.size() - offset );
+            int count( len < available ? len : available );
+            if( count <= 0 ) return 0;
+            m_data.copy( data, count, offset );
+            return count;
+        }
+
+        virtual int size() { return m_data.size(); }
+
+        std::string m_data;
+    };
+
+    // What's on the screen, as painted, and as moved if it can scroll.
+    class Recorder : public GraphicsDriver
+    {
+    public:
+        Recorder( bool canScroll ) :
+          m_screen( _screenWidth * _screenHeight * 3, '\0' ),
+          m_canScroll( canScroll ),
+          m_paints( 0 )
+        {
+        }
+
+        virtual void clearScreen( const String& windowName ) { m_screen.assign( m_screen.size(), '\0' ); }
+        virtual void clearLines( const String& windowName, int from, int len ) {}
+        virtual void clearAll() {}
+
+        virtual void paintGlyph( const String& windowName, int row, int col, char* glyphAttr, bool transparency, char charset )
+        {
+            int offset( ( ( row * _screenWidth ) + col ) * 3 );
+            m_screen[offset] = glyphAttr[0];
+            m_screen[offset + 1] = glyphAttr[1];
+            m_screen[offset + 2] = charset;
+            ++m_paints;
+        }
+
+        virtual void paintBitmap( const String& windowName, int row, int col, int yOffset, int height, int width, char* rgbBuf ) {}
+
+        virtual bool scrollRegion( const String& windowName, int from, int len, bool down )
+        {
+            if( !m_canScroll ) return false;
+
+            int rowSize( _screenWidth * 3 );
+            if( down )
+            {
+                m_screen.replace( from * rowSize, ( len - 1 ) * rowSize, m_screen, ( from + 1 ) * rowSize, ( len - 1 ) * rowSize );
+            }
+            else
+            {
+                m_screen.replace( ( from + 1 ) * rowSize, ( len - 1 ) * rowSize, m_screen.substr( from * rowSize, ( len - 1 ) * rowSize ) );
+            }
+            return true;
+        }
+
+        virtual int glyphHeight() { return 16; }
+        virtual int glyphWidth() { return 8; }
+
+        std::string m_screen;
+        bool m_canScroll;
+        long m_paints;
+    };
+
+    // As the headless driver, but as drivers without scrollRegion().
+    class Repainting : public GraphicsDrivers::Headless
+    {
+    public:
+        virtual bool scrollRegion( const String& windowName, int from, int len, bool down ) { return false; }
+    };
+
+    class FakeTimer : public Timer
+    {
+    public:
+        virtual long ms() { return 0; }
+        virtual void reset() {}
+    };
+
+    // As Chat::receiveMessage(): scroll, then the sender and their message
+    // on the bottom row.
+    void chatLine( Terminal& terminal, int line )
+    {
+        static const char* senders[] = { "alice", "bob", "carol" };
+        static const char* messages[] = { "hello", "anyone seen the lighthouse?",
+                                          "meet by the old well after the storm passes, bring a lamp" };
+
+        const char* sender( senders[line % 3] );
+        terminal.scrollScreen( Terminal::scrollDown );
+        terminal.consumeNext( terminal.height() - 1, 0, 0x10 + ( line % 7 ) );
+        terminal.consumeString( sender );
+        terminal.consumeNext( terminal.height() - 1, ::strlen( sender ) + 1, 0x07 );
+        terminal.consumeString( messages[( line / 3 ) % 3], Terminal::scrollLock );
+    }
+
+    void fillLines( Terminal& terminal )
+    {
+        for( int row( 0 ); row < terminal.height(); ++row )
+        {
+            terminal.consumeNext( row, 0, 0x07 + ( row % 4 ) * 0x10 );
+            terminal.consumeString( ( "Line " + std::to_string( row ) + " of the document" ).c_str(), Terminal::scrollLock );
+        }
+    }
+
+    bool spriteAt( Terminal& terminal, const String& name, int expectedRow )
+    {
+        String assetName;
+        int row( -1 );
+        int col( -1 );
+        int height( -1 );
+        int width( -1 );
+        return terminal.spriteData( name, assetName, row, col, height, width ) && ( row == expectedRow );
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+
+    // CPU time in microseconds, so that time spent running anything else
+    // isn't counted.
+    long long cpuus()
+    {
+        struct timespec now;
+        ::clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &now );
+        return ( (long long)now.tv_sec * 1000000LL ) + ( now.tv_nsec / 1000 );
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+    FakeTimer timer;
+
+    // A burst of chat looks the same whether the driver scrolls or the
+    // terminal repaints, with far fewer glyphs painted.
+    Recorder scrollingRecorder( true );
+    Recorder repaintingRecorder( false );
+    ANSITerminal scrolling( _screenWidth, _screenHeight, "Chat", scrollingRecorder, timer );
+    ANSITerminal repainting( _screenWidth, _screenHeight, "Chat", repaintingRecorder, timer );
+    scrolling.createCursor( "Form", _screenHeight - 1, 40, '_', 0x0F );
+    repainting.createCursor( "Form", _screenHeight - 1, 40, '_', 0x0F );
+    scrolling.createCursor( "Typing", 10, 3, '*', 0x0E );
+    repainting.createCursor( "Typing", 10, 3, '*', 0x0E );
+    for( int line( 0 ); line < _chatLines; ++line )
+    {
+        chatLine( scrolling, line );
+        chatLine( repainting, line );
+    }
+    success = check( "Chat", ( ::memcmp( scrolling.buffer(), repainting.buffer(), _screenWidth * _screenHeight * 2 ) == 0 ) &&
+                             ( scrollingRecorder.m_screen == repaintingRecorder.m_screen ) ) && success;
+    std::cout << "Glyphs painted: " << scrollingRecorder.m_paints << " scrolling, "
+              << repaintingRecorder.m_paints << " repainting" << std::endl;
+    success = check( "Painted", ( scrollingRecorder.m_paints * 5 ) < repaintingRecorder.m_paints ) && success;
+
+    // As the editor, scrolling all but the status line either way, with
+    // sprites in the region scrolling with it, off it, and over its edge.
+    MemoryLoader loader( "\x1b[0;1;33;44mAB\r\nCD" );
+    Asset asset( loader );
+    CompiledANSI compiled;
+    compiled.compile( asset, loader.m_data.size(), 2 );
+
+    Recorder scrollingEditorRecorder( true );
+    Recorder repaintingEditorRecorder( false );
+    ANSITerminal scrollingEditor( _screenWidth, _screenHeight, "Editor", scrollingEditorRecorder, timer );
+    ANSITerminal repaintingEditor( _screenWidth, _screenHeight, "Editor", repaintingEditorRecorder, timer );
+    Terminal* editors[] = { &scrollingEditor, &repaintingEditor };
+    for( int i( 0 ); i < 2; ++i )
+    {
+        Terminal& editor( *editors[i] );
+        fillLines( editor );
+        editor.createSprite( "inside", "sprite", compiled, 10, 20 );
+        editor.createSprite( "top", "sprite", compiled, 1, 30 );
+        editor.createSprite( "edge", "sprite", compiled, _screenHeight - 2, 40, Terminal::whitespaceTransparency );
+        editor.createCursor( "Editor", 12, 21, '_', 0x0F );
+    }
+
+    bool sprites( true );
+    for( int i( 0 ); i < 2; ++i )
+    {
+        Terminal& editor( *editors[i] );
+        editor.scrollScreen( Terminal::scrollDown, 0, editor.height() - 1 );
+        editor.scrollScreen( Terminal::scrollDown, 0, editor.height() - 1 );
+        sprites = sprites && spriteAt( editor, "inside", 8 ) && !editor.isSprite( "top" ) &&
+                  spriteAt( editor, "edge", _screenHeight - 2 );
+        editor.scrollScreen( Terminal::scrollUp, 0, editor.height() - 1 );
+        editor.scrollScreen( Terminal::scrollUp, 0, editor.height() - 1 );
+        editor.scrollScreen( Terminal::scrollUp, 0, editor.height() - 1 );
+        sprites = sprites && spriteAt( editor, "inside", 11 ) && spriteAt( editor, "edge", _screenHeight - 2 );
+    }
+    success = check( "Editor", ( ::memcmp( scrollingEditor.buffer(), repaintingEditor.buffer(), _screenWidth * _screenHeight * 2 ) == 0 ) &&
+                               ( scrollingEditorRecorder.m_screen == repaintingEditorRecorder.m_screen ) ) && success;
+    success = check( "Sprites", sprites ) && success;
+
+    // What's painted is what a repaint would paint.
+    std::string painted( scrollingEditorRecorder.m_screen );
+    scrollingEditor.repaint();
+    success = check( "Repaint", painted == scrollingEditorRecorder.m_screen ) && success;
+
+    // The burst on the headless driver, scrolling and as drivers that can't,
+    // interleaved so that both see the same conditions.
+    GraphicsDrivers::Headless headless;
+    Repainting headlessRepainting;
+    ANSITerminal fast( _screenWidth, _screenHeight, "Chat", headless, timer );
+    ANSITerminal slow( _screenWidth, _screenHeight, "Chat", headlessRepainting, timer );
+    fast.createCursor( "Form", _screenHeight - 1, 40, '_', 0x0F );
+    slow.createCursor( "Form", _screenHeight - 1, 40, '_', 0x0F );
+    bool faster( false );
+    for( int attempt( 0 ); !faster && ( attempt < _numAttempts ); ++attempt )
+    {
+        long long fastus( -1 );
+        long long slowus( -1 );
+        for( int trial( 0 ); trial < _numTrials; ++trial )
+        {
+            for( int pass( 0 ); pass < 2; ++pass )
+            {
+                Terminal& terminal( ( pass == 0 ) ? (Terminal&)slow : (Terminal&)fast );
+                long long& bestus( ( pass == 0 ) ? slowus : fastus );
+                long long startus( cpuus() );
+                for( int line( 0 ); line < _chatLines; ++line )
+                {
+                    chatLine( terminal, line );
+                }
+                long long us( cpuus() - startus );
+                if( ( bestus < 0 ) || ( us < bestus ) ) bestus = us;
+            }
+        }
+
+        double speedup( (double)slowus / ( fastus > 0 ? fastus : 1 ) );
+        faster = ( speedup >= _minSpeedup );
+        std::cout << _chatLines << " chat lines: " << slowus << "us repainting, " << fastus << "us scrolling, "
+                  << speedup << "x" << ( faster ? " OK" : "" ) << std::endl;
+    }
+    success = check( "Faster", faster ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // TERMINAL_TEST
@@ -0,0 +1,155 @@
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "TimerWheel.h"
+
+namespace
+{
+    const int _numSlots( 64 );
+    const long _slotMs( 10 );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Timers
+{
+
+Wheel::Wheel( Factory& timerFactory ) :
+  m_timer( timerFactory.makeTimer() ),
+  m_slots( _numSlots ),
+  m_slotTick( 0 ),
+  m_nextDueMs( 0 )
+{
+}
+
+Wheel::~Wheel()
+{
+    delete( m_timer );
+}
+
+void Wheel::schedule( Task* task, long delayMs )
+{
+    cancel( task );
+
+    if( delayMs < 0 ) delayMs = 0;
+    long dueMs( m_timer->ms() + delayMs );
+
+    Entry entry;
+    entry.m_task = task;
+    entry.m_dueMs = dueMs;
+    slot( dueMs ).push_back( entry );
+    m_dueMs[task] = dueMs;
+
+    if( ( m_dueMs.size() == 1 ) || ( dueMs < m_nextDueMs ) )
+    {
+        m_nextDueMs = dueMs;
+    }
+}
+
+void Wheel::cancel( Task* task )
+{
+    Map< Task*, long >::iterator dueIt( m_dueMs.find( task ) );
+    if( dueIt == m_dueMs.end() ) return;
+
+    Vector< Entry >& entries( slot( dueIt->second ) );
+    for( Vector< Entry >::iterator it( entries.begin() ); it != entries.end(); ++it )
+    {
+        if( it->m_task == task )
+        {
+            entries.erase( it );
+            break;
+        }
+    }
+    m_dueMs.erase( dueIt );
+
+    // If it was next we'll just wake a little early and find the real next.
+}
+
+void Wheel::run()
+{
+    if( m_dueMs.empty() ) return;
+
+    long nowMs( m_timer->ms() );
+    if( nowMs < m_nextDueMs ) return;
+
+    // Take everything that's due from the slots we've passed since we last
+    // ran, then run them, as they may well schedule themselves again.
+    long nowTick( nowMs / _slotMs );
+    long tick( m_slotTick );
+    if( ( nowTick - tick ) >= _numSlots )
+    {
+        tick = nowTick - _numSlots + 1;
+    }
+
+    Vector< Task* > dueTasks;
+    for( ; tick <= nowTick; ++tick )
+    {
+        Vector< Entry >& entries( m_slots[tick % _numSlots] );
+        Vector< Entry >::iterator it( entries.begin() );
+        while( it != entries.end() )
+        {
+            if( it->m_dueMs <= nowMs )
+            {
+                dueTasks.push_back( it->m_task );
+                m_dueMs.erase( it->m_task );
+                it = entries.erase( it );
+            }
+            else
+            {
+                ++it; // Due on a later turn of the wheel.
+            }
+        }
+    }
+    m_slotTick = nowTick;
+
+    findNext();
+
+    Vector< Task* >::iterator taskIt( dueTasks.begin() );
+    for( ; taskIt != dueTasks.end(); ++taskIt )
+    {
+        ( *taskIt )->due();
+    }
+}
+
+bool Wheel::ready()
+{
+    return( msUntilNext() == 0 );
+}
+
+long Wheel::msUntilNext()
+{
+    if( m_dueMs.empty() ) return -1;
+
+    long untilMs( m_nextDueMs - m_timer->ms() );
+    return( untilMs > 0 ? untilMs : 0 );
+}
+
+void Wheel::sleep( long maxMs )
+{
+    long sleepMs( msUntilNext() );
+    if( ( sleepMs < 0 ) || ( sleepMs > maxMs ) ) sleepMs = maxMs;
+
+    if( sleepMs > 0 )
+    {
+        m_timer->usleep( sleepMs * 1000 );
+    }
+}
+
+Vector< Wheel::Entry >& Wheel::slot( long dueMs )
+{
+    return m_slots[( dueMs / _slotMs ) % _numSlots];
+}
+
+void Wheel::findNext()
+{
+    Map< Task*, long >::const_iterator it( m_dueMs.begin() );
+    if( it != m_dueMs.end() ) m_nextDueMs = it->second;
+    for( ; it != m_dueMs.end(); ++it )
+    {
+        if( it->second < m_nextDueMs ) m_nextDueMs = it->second;
+    }
+}
+
+} // namespace Timers
+
+} // namespace Agape
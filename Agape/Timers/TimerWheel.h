@@ -0,0 +1,66 @@
+#ifndef AGAPE_TIMERS_WHEEL_H
+#define AGAPE_TIMERS_WHEEL_H
+
+#include "Collections.h"
+#include "Runnable.h"
+
+namespace Agape
+{
+
+class Timer;
+
+namespace Timers
+{
+
+class Factory;
+
+// Runs tasks when they fall due. Tasks are hashed into slots by when they're
+// due, so that a pass of the main loop only has to compare the time with the
+// next deadline, and can sleep until then if it has nothing else to do.
+class Wheel : public Runnable
+{
+public:
+    class Task
+    {
+    public:
+        virtual ~Task() {}
+
+        virtual void due() = 0;
+    };
+
+    Wheel( Factory& timerFactory );
+    virtual ~Wheel();
+
+    // Replaces any time the task was already scheduled for.
+    void schedule( Task* task, long delayMs );
+    void cancel( Task* task );
+
+    virtual void run();
+    virtual bool ready(); // Something is due.
+
+    long msUntilNext(); // -1 if nothing is scheduled.
+    void sleep( long maxMs ); // Until the next task is due, or for maxMs.
+
+private:
+    struct Entry
+    {
+        Task* m_task;
+        long m_dueMs;
+    };
+
+    Vector< Entry >& slot( long dueMs );
+    void findNext();
+
+    Timer* m_timer;
+
+    Vector< Vector< Entry > > m_slots;
+    Map< Task*, long > m_dueMs;
+    long m_slotTick; // Where the last run got to.
+    long m_nextDueMs;
+};
+
+} // namespace Timers
+
+} // namespace Agape
+
+#endif // AGAPE_TIMERS_WHEEL_H
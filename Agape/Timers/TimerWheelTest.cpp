@@ -0,0 +1,266 @@
+#ifdef TIMER_WHEEL_TEST
+
+#include "Actors/NativeActors/NativeActor.h"
+#include "Clocks/DisciplinedClock.h"
+#include "NativeActors/EventTimerActor.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Timers/TimerWheel.h"
+#include "Collections.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+
+#include <iostream>
+
+using namespace Agape;
+using namespace Agape::Linda2;
+
+namespace
+{
+    const unsigned long long _epochMS( 1760000000000ull ); // Server time when the test starts.
+    const double _localRate( 1.002 ); // Our timer runs 2000ppm fast.
+    const long _maxDelayMs( 20 ); // Times reach us up to this late.
+    const long _tickPeriod( 100 );
+    const long _maxJitterMs( 10 ); // Slewing to a time can move the clock a few ms at once.
+
+    long long s_nowUs( 0 ); // Simulated true time.
+    int s_sleeps( 0 );
+
+    // Deterministic, so that a failure can be reproduced.
+    unsigned int _seed( 1 );
+    unsigned int nextRandom( unsigned int range )
+    {
+        _seed = _seed * 1103515245 + 12345;
+        return ( ( _seed >> 8 ) % range );
+    }
+
+    class SimulatedTimer : public Timer
+    {
+    public:
+        SimulatedTimer() : m_startUs( s_nowUs ) {}
+        virtual long ms() { return (long)( ( s_nowUs - m_startUs ) * _localRate / 1000 ); }
+        virtual void reset() { m_startUs = s_nowUs; }
+        virtual void usleep( long us )
+        {
+            s_nowUs += (long long)( us / _localRate ) + 1;
+            ++s_sleeps;
+        }
+
+    private:
+        long long m_startUs;
+    };
+
+    class SimulatedTimerFactory : public Timers::Factory
+    {
+    public:
+        virtual Timer* makeTimer() { return new SimulatedTimer; }
+    };
+
+    long long trueMS()
+    {
+        return (long long)_epochMS + ( s_nowUs / 1000 );
+    }
+
+    // Stands in for the server, sending the time each second.
+    class Server
+    {
+    public:
+        Server() : m_nextSendUs( 0 ), m_arrivalUs( -1 ), m_sentS( 0 ) {}
+
+        // The time if one has reached us.
+        bool receive( unsigned long long& epochMS )
+        {
+            if( ( m_arrivalUs < 0 ) && ( s_nowUs >= m_nextSendUs ) )
+            {
+                m_sentS = ( _epochMS / 1000 ) + ( m_nextSendUs / 1000000 );
+                m_arrivalUs = m_nextSendUs + ( nextRandom( _maxDelayMs ) * 1000 );
+                m_nextSendUs += 1000000;
+            }
+
+            if( ( m_arrivalUs >= 0 ) && ( s_nowUs >= m_arrivalUs ) )
+            {
+                m_arrivalUs = -1;
+                epochMS = m_sentS * 1000;
+                return true;
+            }
+
+            return false;
+        }
+
+        void skip()
+        {
+            m_nextSendUs = ( ( s_nowUs / 1000000 ) + 1 ) * 1000000;
+            m_arrivalUs = -1;
+        }
+
+    private:
+        long long m_nextSendUs;
+        long long m_arrivalUs;
+        unsigned long long m_sentS;
+    };
+
+    class Recorder : public Actors::Native
+    {
+    public:
+        Recorder( TupleRouter& tupleRouter, Clocks::Disciplined& clock ) :
+          Native( "Recorder" ),
+          m_tupleRouter( tupleRouter ),
+          m_clock( clock ),
+          m_ticks( 0 ),
+          m_lastTickMS( 0 ),
+          m_gaps( 0 ),
+          m_maxJitterMs( 0 )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        ~Recorder()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            if( TupleRouter::tupleType( tuple ) != _Tick ) return false;
+
+            unsigned long long tickMS( (double)tuple[_now] );
+            if( ( m_lastTickMS != 0 ) && ( tickMS != ( m_lastTickMS + _tickPeriod ) ) ) ++m_gaps;
+            m_lastTickMS = tickMS;
+
+            long long jitterMs( (long long)m_clock.epochMS() - (long long)tickMS );
+            if( jitterMs < 0 ) jitterMs = -jitterMs;
+            if( jitterMs > m_maxJitterMs ) m_maxJitterMs = jitterMs;
+
+            ++m_ticks;
+            return true;
+        }
+
+        void clear()
+        {
+            m_gaps = 0;
+            m_maxJitterMs = 0;
+        }
+
+        TupleRouter& m_tupleRouter;
+        Clocks::Disciplined& m_clock;
+        int m_ticks;
+        unsigned long long m_lastTickMS;
+        int m_gaps;
+        long long m_maxJitterMs;
+    };
+
+    long long errorMs( Clocks::Disciplined& clock )
+    {
+        long long error( (long long)clock.epochMS() - trueMS() );
+        return( error < 0 ? -error : error );
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    SimulatedTimerFactory timerFactory;
+
+    // The clock follows the server's whole seconds to within their lateness,
+    // learns how fast our timer runs, and never goes backwards.
+    {
+        Clocks::Disciplined clock( timerFactory );
+        Server server;
+        bool monotonic( true );
+        unsigned long long lastMS( 0 );
+        long long maxErrorMs( 0 );
+        for( ; s_nowUs < 1200000000; s_nowUs += 1000 )
+        {
+            unsigned long long epochMS( 0 );
+            if( server.receive( epochMS ) ) clock.discipline( epochMS );
+
+            unsigned long long nowMS( clock.epochMS() );
+            monotonic = monotonic && ( nowMS >= lastMS );
+            lastMS = nowMS;
+            if( ( s_nowUs > 60000000 ) && ( errorMs( clock ) > maxErrorMs ) ) maxErrorMs = errorMs( clock );
+        }
+        std::cout << "Clock: " << maxErrorMs << "ms from true, " << clock.driftPPM() << "ppm drift" << std::endl;
+        success = check( "Disciplined", monotonic && ( maxErrorMs <= _maxDelayMs + 5 ) &&
+                                        ( clock.driftPPM() > 1800 ) && ( clock.driftPPM() < 2200 ) ) && success;
+
+        // Without times for five minutes it keeps to the drift it has learnt,
+        // where on our timer alone it would be 600ms out.
+        s_nowUs += 300000000;
+        std::cout << "Holdover: " << errorMs( clock ) << "ms from true" << std::endl;
+        success = check( "Holdover", errorMs( clock ) < 100 ) && success;
+
+        // A time far from ours is stepped to, even backwards.
+        clock.discipline( trueMS() - 3600000 );
+        success = check( "Step", ( errorMs( clock ) >= 3599999 ) && ( errorMs( clock ) <= 3600001 ) ) && success;
+    }
+
+    // Ticks from the timer wheel, while idle and while busy.
+    {
+        s_nowUs = 0;
+        TupleDispatcher tupleDispatcher;
+        TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+        tupleRouter.setMyID( "Test" );
+        Clocks::Disciplined clock( timerFactory );
+        Timers::Wheel timerWheel( timerFactory );
+        Actors::NativeActors::EventTimer eventTimer( timerWheel, clock, tupleRouter );
+        Recorder recorder( tupleRouter, clock );
+        Server server;
+
+        // As VRTime and the Clock actor would.
+        unsigned long long epochMS( 0 );
+        while( !server.receive( epochMS ) ) s_nowUs += 1000;
+        clock.discipline( epochMS );
+        Tuple time;
+        TupleRouter::setSourceActor( time, _Clock );
+        TupleRouter::setSourceID( time, "Server" );
+        TupleRouter::setTupleType( time, _Time );
+        time[_now] = (double)( epochMS / 1000 );
+        tupleRouter.route( time );
+
+        // Idle, the loop only wakes when a tick is due.
+        int passes( 0 );
+        int busyPasses( 0 );
+        int sleeps( s_sleeps );
+        for( ; s_nowUs < 10000000; ++passes )
+        {
+            int ticks( recorder.m_ticks );
+            timerWheel.run();
+            if( ( passes > 0 ) && ( recorder.m_ticks == ticks ) ) ++busyPasses;
+            timerWheel.sleep( 1000 );
+        }
+        std::cout << "Idle: " << passes << " passes, " << ( s_sleeps - sleeps ) << " sleeps, "
+                  << recorder.m_ticks << " ticks, " << busyPasses << " busy passes, "
+                  << recorder.m_maxJitterMs << "ms jitter" << std::endl;
+        success = check( "Idle", ( busyPasses == 0 ) && ( recorder.m_gaps == 0 ) &&
+                                 ( recorder.m_ticks >= 99 ) && ( recorder.m_maxJitterMs <= _maxJitterMs ) ) && success;
+
+        // Busy, run every ms, with times arriving.
+        server.skip();
+        recorder.clear();
+        int ticks( recorder.m_ticks );
+        for( ; s_nowUs < 70000000; s_nowUs += 1000 )
+        {
+            if( server.receive( epochMS ) ) clock.discipline( epochMS );
+            timerWheel.run();
+        }
+        std::cout << "Busy: " << ( recorder.m_ticks - ticks ) << " ticks, " << recorder.m_gaps << " gaps, "
+                  << recorder.m_maxJitterMs << "ms jitter" << std::endl;
+        success = check( "Busy", ( recorder.m_gaps == 0 ) && ( recorder.m_ticks - ticks >= 598 ) &&
+                                 ( recorder.m_maxJitterMs <= _maxJitterMs ) ) && success;
+    }
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // TIMER_WHEEL_TEST
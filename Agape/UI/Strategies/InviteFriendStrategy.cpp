@@ -439,6 +439,7 @@ bool InviteFriend::doInvite()
     if( success )
     {
         m_inviteFriendResponse = Promise( &m_tupleRouter, &m_timerFactory );
+        m_tupleRouter.expect( tuple, m_inviteFriendResponse, this );
         success = m_tupleRouter.route( tuple );
         if( success ) success = m_inviteFriendResponse.getFuture().get();
     }
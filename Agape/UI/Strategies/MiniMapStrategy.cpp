@@ -6,7 +6,9 @@
 #include "UI/Hotkeys.h"
 #include "UI/Navigation.h"
 #include "Utils/LiteStream.h"
+#include "World/MiniMap.h"
 #include "World/WorldCoordinates.h"
+#include "Collections.h"
 #include "MiniMapStrategy.h"
 #include "String.h"
 #include "StringConstants.h"
@@ -37,6 +39,7 @@ namespace Strategies
 {
 
 MiniMap::MiniMap( AssetLoaders::Factory& assetLoaderFactory,
+                  World::MiniMap& miniMap,
                   Coordinates& coordinates,
                   Navigation& navigation,
                   InputDevice& inputDevice,
@@ -45,6 +48,7 @@ MiniMap::MiniMap( AssetLoaders::Factory& assetLoaderFactory,
                   const String& windowName,
                   Dialogue& dialogue ) :
   m_assetLoaderFactory( assetLoaderFactory ),
+  m_miniMap( miniMap ),
   m_coordinates( coordinates ),
   m_navigation( navigation ),
   m_inputDevice( inputDevice ),
@@ -80,7 +84,6 @@ void MiniMap::enter( const Value& parameters )
         m_cursorx = 1;
         m_cursory = 1;
         m_centreCoordinates = m_coordinates;
-        purgeCache();
         drawMaps();
         drawGrid( m_cursorx, m_cursory, true );
         m_navigation.draw( m_centreCoordinates );
@@ -229,26 +232,41 @@ void MiniMap::run()
     }
 }
 
-void MiniMap::purgeCache()
+// Builds every tile not already built in one go, so that they can be drawn in
+// parallel, rather than one at a time as each is asked for.
+void MiniMap::prepareTiles()
 {
-    if( m_cacheCoordinates.m_worldID != m_coordinates.m_worldID )
+    Vector< World::Coordinates > coordinates;
+    for( int x = 0; x < m_xtiles; ++x )
+    {
+        for( int y = 0; y < m_ytiles; ++y )
+        {
+            coordinates.push_back( coordsAtOffset( x, y ) );
+        }
+    }
+
+    // Tiles are only kept for one world, so a new world starts from nothing.
+    bool cold( m_cacheCoordinates.m_worldID != m_centreCoordinates.m_worldID );
+    if( cold )
     {
         m_dialogue.show( Dialogue::normal );
         m_dialogue.drawTitle( "Please wait" );
-        m_dialogue.drawMessage( "Resetting tile cache" );
+        m_dialogue.drawMessage( "Drawing map" );
+    }
 
-        AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( m_coordinates, String() ) );
-        assetLoader->invalidateCached( true ); // true = invalidate all.
-        delete( assetLoader );
+    m_miniMap.prepare( coordinates, m_xtiles, m_ytiles );
 
+    if( cold )
+    {
         m_dialogue.hide();
-
-        m_cacheCoordinates = m_coordinates;
+        m_cacheCoordinates = m_centreCoordinates;
     }
 }
 
 void MiniMap::drawMaps()
 {
+    prepareTiles();
+
     m_xwidth = ::floor( m_terminal->width() / m_xtiles );
     m_yheight = ::floor( m_terminal->height() / m_ytiles );
 
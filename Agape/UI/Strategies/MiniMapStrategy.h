@@ -14,6 +14,11 @@ namespace AssetLoaders
 class Factory;
 } // namespace AssetLoaders
 
+namespace World
+{
+class MiniMap;
+} // namespace World
+
 using namespace World;
 
 class InputDevice;
@@ -34,6 +39,7 @@ class MiniMap : public Strategy
 {
 public:
     MiniMap( AssetLoaders::Factory& assetLoaderFactory,
+             World::MiniMap& miniMap,
              Coordinates& coordinates,
              Navigation& navigation,
              InputDevice& inputDevice,
@@ -52,7 +58,7 @@ public:
     virtual void run();
 
 private:
-    void purgeCache();
+    void prepareTiles();
     void drawMaps();
     void drawGrid( int gridx, int gridy, bool selected );
 
@@ -61,6 +67,7 @@ private:
     void drawHotkeys();
 
     AssetLoaders::Factory& m_assetLoaderFactory;
+    World::MiniMap& m_miniMap;
     Coordinates& m_coordinates;
     Navigation& m_navigation;
     InputDevice& m_inputDevice;
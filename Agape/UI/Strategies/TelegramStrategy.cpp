@@ -8,6 +8,7 @@
 #include "Encryptors/Encryptor.h"
 #include "InputDevices/InputDevice.h"
 #include "TelegramLoaders/Factories/TelegramLoadersFactory.h"
+#include "TelegramLoaders/TelegramIndex.h"
 #include "TelegramLoaders/TelegramLoader.h"
 #include "Timers/Factories/TimerFactory.h"
 #include "Timers/Timer.h"
@@ -74,6 +75,8 @@ namespace
     const int timeSinceMaxWidth( 4 );
     // Subtract 8 - glyph, space, name, space, (subject), space, time[4 chars].
     const int listSubjectMaxWidth( selectWidth - listNameMaxWidth - 8 );
+
+    const int listPageSize( 50 ); // Telegrams loaded at a time, with an index.
 } // Anonymous namespace
 
 namespace Agape
@@ -87,6 +90,7 @@ namespace Strategies
 
 Telegram::Telegram( InputDevice& inputDevice,
                     TelegramLoaders::Factory& telegramLoaderFactory,
+                    KiamaFS* telegramIndexFS,
                     const World::User& worldUser,
                     const Metadata& worldMetadata,
                     const Worldbook& worldbook,
@@ -101,6 +105,7 @@ Telegram::Telegram( InputDevice& inputDevice,
                     Snowflake& snowflake ) :
   m_inputDevice( inputDevice ),
   m_telegramLoaderFactory( telegramLoaderFactory ),
+  m_telegramIndexFS( telegramIndexFS ),
   m_worldUser( worldUser ),
   m_worldMetadata( worldMetadata ),
   m_worldBook( worldbook ),
@@ -119,7 +124,9 @@ Telegram::Telegram( InputDevice& inputDevice,
   m_terminal( nullptr ),
   m_currentForm( nullptr ),
   m_editor( nullptr ),
-  m_telegramLoader( nullptr )
+  m_telegramLoader( nullptr ),
+  m_telegramIndex( nullptr ),
+  m_page( -1 )
 {
 }
 
@@ -129,6 +136,7 @@ Telegram::~Telegram()
     delete( m_encryptor );
     delete( m_timer );
     delete( m_editor );
+    delete( m_telegramIndex );
     delete( m_telegramLoader );
 }
 
@@ -137,6 +145,13 @@ void Telegram::enter( const Value& parameters )
     m_completed = false;
 
     m_telegramLoader = m_telegramLoaderFactory.makeLoader( m_worldUser.m_snowflake );
+    if( m_telegramIndexFS )
+    {
+        m_telegramIndex = new TelegramLoaders::Index( *m_telegramLoader,
+                                                      *m_telegramIndexFS,
+                                                      m_worldUser.m_snowflake );
+    }
+    m_page = -1;
     
     WindowManager::TerminalWindow terminalWindow;
     if( m_windowManager.getTerminalWindow( m_windowName, terminalWindow ) )
@@ -176,6 +191,8 @@ bool Telegram::returning( String& nextStrategy, Value& parameters )
     {
         closeForm();
         m_windowManager.setTerminalWindowVisible( m_windowName, false );
+        delete( m_telegramIndex );
+        m_telegramIndex = nullptr;
         delete( m_telegramLoader );
         m_telegramLoader = nullptr;
         m_inputDevice.setPeekEnabled( true );
@@ -247,6 +264,17 @@ void Telegram::run()
                 drawList( true ); // true = show sent.
                 m_state = listSent;
             }
+            else if( ( c == '<' ) && m_telegramIndex &&
+                     ( ( m_page + 1 ) * listPageSize < m_telegramIndex->size() ) )
+            {
+                ++m_page; // Older.
+                drawList( false ); // false = show inbox.
+            }
+            else if( ( c == '>' ) && m_telegramIndex && ( m_page > 0 ) )
+            {
+                --m_page; // Newer.
+                drawList( false ); // false = show inbox.
+            }
             else if( c == Key::escape )
             {
                 m_completed = true;
@@ -467,7 +495,7 @@ bool Telegram::drawList( bool sent )
     bool loaded( false );
     if( !sent )
     {
-        loaded = m_telegramLoader->load( m_telegrams );
+        loaded = loadInbox();
     }
     else
     {
@@ -589,6 +617,10 @@ bool Telegram::drawList( bool sent )
             m_terminal->consumeString( "\x1b[0;97;100m\x18/\x19\x1b[37m Sel\x1b[0m  \x1b[97;100mRet\x1b[37m Read\x1b[0m  \x1b[97;100mC\x1b[37m Compose\x1b[0m  \x1b[97;100mR\x1b[37m Reply\x1b[0m", false, Terminal::preserveBackground );
             m_terminal->consumeNext( guideRow + 1, contentCol );
             m_terminal->consumeString( "\x1b[97;100mX\x1b[37m Del\x1b[0m    \x1b[97;100mS\x1b[37m Sent\x1b[0m    \x1b[97;100mEsc\x1b[37m Exit\x1b[0m", false, Terminal::preserveBackground );
+            if( m_telegramIndex )
+            {
+                m_terminal->consumeString( "    \x1b[97;100m<>\x1b[37m Page\x1b[0m", false, Terminal::preserveBackground );
+            }
         }
         else
         {
@@ -678,6 +710,33 @@ bool Telegram::drawList( bool sent )
     return false;
 }
 
+// With an index, only the page being shown is loaded, and only telegrams
+// received since the index was last synced are asked for to update it.
+bool Telegram::loadInbox()
+{
+    if( m_telegramIndex && m_telegramIndex->sync() )
+    {
+        int size( m_telegramIndex->size() );
+        if( m_page < 0 )
+        {
+            int newestUnread( m_telegramIndex->newestUnread() );
+            m_page = ( newestUnread >= 0 ) ? ( size - 1 - newestUnread ) / listPageSize : 0;
+        }
+        m_page = std::max( 0, std::min( m_page, ( size - 1 ) / listPageSize ) );
+
+        int last( size - m_page * listPageSize );
+        int first( std::max( 0, last - listPageSize ) );
+        if( last <= first )
+        {
+            return true; // Nothing received.
+        }
+
+        return m_telegramLoader->loadPage( m_telegrams, m_telegramIndex->after( first ), last - first );
+    }
+
+    return m_telegramLoader->load( m_telegrams );
+}
+
 void Telegram::drawListError()
 {
     m_dialogue.show( Dialogue::error );
@@ -713,6 +772,10 @@ bool Telegram::drawRead()
                 if( m_state == list ) // not listSent - don't attempt to mark sent telegrams as read!
                 {
                     m_telegramLoader->markRead( currentTelegram );
+                    if( m_telegramIndex )
+                    {
+                        m_telegramIndex->markRead( currentTelegram );
+                    }
                 }
 
                 return true;
@@ -1038,6 +1101,10 @@ bool Telegram::deleteTelegram()
 
             success = ( assetLoader->erase() &&
                         m_telegramLoader->erase( currentTelegram ) );
+            if( success && m_telegramIndex )
+            {
+                m_telegramIndex->erase( currentTelegram );
+            }
 
             delete( assetLoader );
         }
@@ -29,6 +29,7 @@ class Factory;
 namespace TelegramLoaders
 {
 class Factory;
+class Index;
 } // namespace TelegramLoaders
 
 namespace Timers
@@ -47,6 +48,7 @@ using namespace World;
 class Clock;
 class Encryptor;
 class InputDevice;
+class KiamaFS;
 class Snowflake;
 class TelegramLoader;
 class Terminal;
@@ -72,6 +74,7 @@ class Telegram : public Strategy
 public:
     Telegram( InputDevice& inputDevice,
               TelegramLoaders::Factory& telegramLoaderFactory,
+              KiamaFS* telegramIndexFS, // Optional - loads the inbox whole without.
               const User& worldUser,
               const Metadata& worldMetadata,
               const Worldbook& worldbook,
@@ -117,6 +120,7 @@ private:
     void drawBackground();
     void drawLoadPending();
     bool drawList( bool sent );
+    bool loadInbox();
     void drawListError();
     bool drawRead();
     void drawReadError();
@@ -145,6 +149,7 @@ private:
 
     InputDevice& m_inputDevice;
     TelegramLoaders::Factory& m_telegramLoaderFactory;
+    KiamaFS* m_telegramIndexFS;
     const User& m_worldUser;
     const Metadata& m_worldMetadata;
     const Worldbook& m_worldBook;
@@ -168,6 +173,8 @@ private:
     Agape::Editor::Editor* m_editor;
 
     TelegramLoader* m_telegramLoader;
+    TelegramLoaders::Index* m_telegramIndex;
+    int m_page; // Of the inbox, newest first. -1 for that with the newest unread.
     Vector< World::Telegram > m_telegrams;
 
     World::Telegram m_newTelegram;
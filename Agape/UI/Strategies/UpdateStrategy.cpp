@@ -8,7 +8,9 @@
 #include "Timers/Factories/TimerFactory.h"
 #include "UI/Dialogue.h"
 #include "UI/Strategy.h"
+#include "Utils/CRC32.h"
 #include "Utils/LiteStream.h"
+#include "Utils/StrToHex.h"
 #include "World/WorldCoordinates.h"
 #include "Collections.h"
 #include "String.h"
@@ -78,7 +80,11 @@ Update::Update( InputDevice& inputDevice,
   m_currentBar( 0 ),
   m_blockOffset( 0 ),
   m_blockLength( 0 ),
-  m_blockEmpty( false )
+  m_blockEmpty( false ),
+  m_deltaIndex( 0 ),
+  m_deltaUnit( 0 ),
+  m_unitErased( false ),
+  m_baseSize( 0 )
 {
     m_tupleRouter.registerActor( this );
 }
@@ -104,6 +110,12 @@ void Update::enter( const Value& parameters )
     m_blockOffset = 0;
     m_blockLength = 0;
     m_blockEmpty = false;
+    m_delta.clear();
+    m_deltaIndex = 0;
+    m_deltaUnit = 0;
+    m_unitErased = false;
+    m_baseSize = 0;
+    m_baseChecksum.clear();
 
     drawCheck();
 
@@ -172,8 +184,10 @@ void Update::run()
 
                 if( openFile() )
                 {
+                    // Patch only what changed if we can, otherwise rewrite
+                    // the whole update memory.
+                    m_state = m_delta.empty() ? erasing : patching;
                     updateProgress();
-                    m_state = erasing;
                 }
                 else
                 {
@@ -225,6 +239,25 @@ void Update::run()
             m_timer->reset();
         }
     }
+    else if( m_state == patching )
+    {
+        if( patchBlock() ) // Erase one unit or read one block
+        {
+            updateProgress();
+            if( m_deltaIndex == (int)m_delta.size() ) // If all units are patched...
+            {
+                drawSuccess();
+                m_state = success;
+                m_timer->reset();
+            }
+        }
+        else
+        {
+            drawError();
+            m_state = error;
+            m_timer->reset();
+        }
+    }
     else if( m_state == success )
     {
         if( m_timer->ms() >= 3000 )
@@ -262,6 +295,18 @@ bool Update::accept( Tuple& tuple )
         if( m_updateOpenResponse.set( tuple[_success] ) )
         {
             m_size = tuple[_size];
+
+            m_delta.clear();
+            if( tuple.hasValue( _delta ) )
+            {
+                const Value& delta( tuple[_delta] );
+                for( ConstListIterator it( delta.listBegin() ); it != delta.listEnd(); ++it )
+                {
+                    m_delta.push_back( (int)**it );
+                }
+                m_baseSize = tuple[_baseSize];
+                m_baseChecksum = (const String&)tuple[_checksum];
+            }
         }
 
         handled = true;
@@ -311,6 +356,7 @@ bool Update::needUpdate()
 
     LOG_DEBUG( "Update: Sending UpdateMetadataRequest" );
     m_updateMetadataResponse = Promise( &m_tupleRouter, &m_timerFactory );
+    m_tupleRouter.expect( tuple, m_updateMetadataResponse, this );
     success = m_tupleRouter.route( tuple );
     if( success ) success = m_updateMetadataResponse.getFuture().get();
     if( success )
@@ -337,8 +383,15 @@ bool Update::openFile()
     TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
     TupleRouter::setTupleType( tuple, _UpdateOpenRequest );
 
+    // Offer to be patched from the version we run, in units we can erase.
+    m_deltaUnit = m_updateMemory.eraseBlockSize();
+    if( m_deltaUnit < blockSize ) m_deltaUnit = blockSize;
+    tuple[_version] = m_currentVersion;
+    tuple[_length] = m_deltaUnit;
+
     LOG_DEBUG( "Update: Sending UpdateOpenRequest" );
     m_updateOpenResponse = Promise( &m_tupleRouter, &m_timerFactory );
+    m_tupleRouter.expect( tuple, m_updateOpenResponse, this );
     success = m_tupleRouter.route( tuple );
     if( success ) success = m_updateOpenResponse.getFuture().get();
     if( success )
@@ -347,6 +400,13 @@ bool Update::openFile()
         stream << "Update: Opened file. Size: " << m_size;
         LOG_DEBUG( stream.str() );
 
+        if( !m_delta.empty() && !baseMatches( m_baseSize, m_baseChecksum ) )
+        {
+            // Not what the server would patch; fetch everything.
+            LOG_DEBUG( "Update: Update memory does not hold current version. Not patching." );
+            m_delta.clear();
+        }
+
         m_eraseBytesPerBar = (double)m_updateMemory.size() / ( contentMaxWidth / 2 );
         m_bytesPerBar = (double)m_size / ( contentMaxWidth / 2 );
     }
@@ -380,6 +440,7 @@ bool Update::readBlock()
 
     LOG_DEBUG( "Update: Sending UpdateReadRequest" );
     m_updateReadResponse = Promise( &m_tupleRouter, &m_timerFactory );
+    m_tupleRouter.expect( tuple, m_updateReadResponse, this );
     success = m_tupleRouter.route( tuple );
     if( success ) success = m_updateReadResponse.getFuture().get();
     if( success )
@@ -418,6 +479,64 @@ bool Update::readBlock()
     return success;
 }
 
+bool Update::patchBlock()
+{
+    int unitOffset( m_delta[m_deltaIndex] );
+    int unitEnd( unitOffset + m_deltaUnit );
+    if( unitEnd > m_size ) unitEnd = m_size;
+
+    if( !m_unitErased )
+    {
+        if( !m_updateMemory.erase( unitOffset, m_deltaUnit ) )
+        {
+            LiteStream stream;
+            stream << "Update: Failed to erase unit. Offset: " << unitOffset;
+            LOG_DEBUG( stream.str() );
+            return false;
+        }
+
+        m_unitErased = true;
+        m_currentOffset = unitOffset;
+    }
+    else if( !readBlock() )
+    {
+        return false;
+    }
+
+    if( m_currentOffset >= unitEnd )
+    {
+        ++m_deltaIndex;
+        m_unitErased = false;
+    }
+
+    return true;
+}
+
+bool Update::baseMatches( int baseSize, const String& checksum )
+{
+    if( ( baseSize <= 0 ) || ( baseSize > m_updateMemory.size() ) )
+    {
+        return false;
+    }
+
+    char buffer[256];
+    unsigned int crc( 0 );
+    for( int offset( 0 ); offset < baseSize; )
+    {
+        int len( baseSize - offset );
+        if( len > (int)sizeof( buffer ) ) len = sizeof( buffer );
+        if( m_updateMemory.read( offset, buffer, len ) != len )
+        {
+            return false;
+        }
+
+        crc = crc32( buffer, len, crc );
+        offset += len;
+    }
+
+    return( uintToHex( crc ) == checksum );
+}
+
 void Update::drawCheck()
 {
     m_dialogue.show( Dialogue::normal );
@@ -537,6 +656,16 @@ void Update::updateProgress()
             ++m_currentBar;
         }
     }
+    else if( m_state == patching )
+    {
+        int thisBar( ( m_deltaIndex * contentMaxWidth ) / m_delta.size() );
+        while( ( thisBar > m_currentBar ) && ( m_currentBar < contentMaxWidth ) )
+        {
+            m_terminal->consumeNext( contentFirstRow + 2, contentCol + m_currentBar, 0x0F );
+            m_terminal->consumeChar( '\xdb', Terminal::scrollLock, Terminal::preserveBackground );
+            ++m_currentBar;
+        }
+    }
     else if( m_state == updating )
     {
         int thisBar( ( contentMaxWidth / 2 ) + ( m_currentOffset / m_bytesPerBar ) );
@@ -73,6 +73,7 @@ private:
         notification,
         erasing,
         updating,
+        patching,
         error,
         success
     };
@@ -81,6 +82,8 @@ private:
     bool openFile();
     bool eraseBlock();
     bool readBlock();
+    bool patchBlock();
+    bool baseMatches( int baseSize, const String& checksum );
 
     void drawCheck();
     void hideDialogue();
@@ -124,6 +127,15 @@ private:
     int m_blockLength;
     bool m_blockEmpty;
     Value m_blockData;
+
+    // Offsets of the units that differ from the version we already hold, if
+    // the server can patch it.
+    Vector< int > m_delta;
+    int m_deltaIndex;
+    int m_deltaUnit;
+    bool m_unitErased;
+    int m_baseSize;
+    String m_baseChecksum;
 };
 
 } // namespace Strategies
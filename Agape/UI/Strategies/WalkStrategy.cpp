@@ -148,7 +148,7 @@ void Walk::enter( const Value& parameters )
         }
     }
     m_compositor.setUser( m_worldUser );
-    m_compositor.invalidateAllCached(); // Delete cached assets and programs, in case new world has different assets/programs with same names as old world.
+    m_compositor.revalidateAllCached( m_coordinates ); // Drop cached assets and programs that have changed on the server, or that differ in the new world.
     m_compositor.render( m_coordinates );
     if( parameters.hasValue( _row ) && parameters.hasValue( _column ) )
     {
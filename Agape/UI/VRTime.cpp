@@ -17,6 +17,7 @@ using namespace Agape::Linda2;
 namespace
 {
     const int waitTimeout( 10000 ); // ms to wait for a Time tuple to produce a valid time for VRTimeClock.
+    const int waitPollInterval( 1 ); // ms to sleep between looking for one.
 } // Anonymous namespace
 
 namespace Agape
@@ -36,9 +37,8 @@ VRTime::VRTime( WindowManager& windowManager,
   m_terminal( nullptr ),
   m_timer( timerFactory.makeTimer() ),
   m_registered( false ),
-  m_haveTime( false ),
   m_running( false ),
-  m_secsSinceEpoch( 0 )
+  m_clock( timerFactory )
 {
     WindowManager::TerminalWindow terminalWindow;
     if( windowManager.getTerminalWindow( windowName, terminalWindow ) )
@@ -76,7 +76,7 @@ void VRTime::draw()
     int day = 0, month = 0, year = 0;
     int hour = 0, minute = 0, second = 0;
     int dayOfWeek = 0;
-    Clock::timestampToParts( m_secsSinceEpoch,
+    Clock::timestampToParts( m_clock.epochS(),
                              day,
                              month,
                              year,
@@ -121,27 +121,40 @@ void VRTime::stop()
 
 bool VRTime::haveTime()
 {
-    return m_haveTime;
+    return m_clock.synchronised();
 }
 
 void VRTime::waitForTime()
 {
+    // Once we've had a time our clock keeps it, so this only waits before
+    // the first.
     m_timer->reset();
     while( m_registered &&
-           !m_haveTime &&
+           !m_clock.synchronised() &&
            ( m_timer->ms() < waitTimeout ) )
     {
-        m_tupleRouter.run(); // Run to receive time tuple. FIXME: Timeout?
+        m_tupleRouter.run(); // Run to receive time tuple.
+
+        if( !m_clock.synchronised() )
+        {
+            m_timer->usleep( waitPollInterval * 1000 );
+        }
     }
 }
 
+Clocks::Disciplined& VRTime::clock()
+{
+    return m_clock;
+}
+
 bool VRTime::accept( Tuple& tuple )
 {
     if( TupleRouter::tupleType( tuple ) == _Time )
     {
         if( tuple.hasValue( _now ) )
         {
-            m_secsSinceEpoch = tuple[_now];
+            long long secsSinceEpoch( tuple[_now] );
+            m_clock.discipline( (unsigned long long)secsSinceEpoch * 1000ull );
 
             // FIXME: Do we want the drawing to be driven by events here,
             // or should WalkStrategy be calling draw()?
@@ -151,8 +164,6 @@ bool VRTime::accept( Tuple& tuple )
             }
             // If not m_running we don't draw but still process incoming time
             // tuples, for the benefit of Clocks::VRTime.
-
-            m_haveTime = true;
         }
     }
 
@@ -167,7 +178,7 @@ bool VRTime::perform( Value& returnValue,
     if( name == _now )
     {
         waitForTime();
-        returnValue = (double)m_secsSinceEpoch;
+        returnValue = (double)m_clock.epochS();
         return true;
     }
 
@@ -2,6 +2,7 @@
 #define AGAPE_UI_VR_TIME_H
 
 #include "Actors/NativeActors/NativeActor.h"
+#include "Clocks/DisciplinedClock.h"
 
 namespace Agape
 {
@@ -58,6 +59,8 @@ public:
     bool haveTime();
     void waitForTime();
 
+    Clocks::Disciplined& clock();
+
     virtual bool accept( Tuple& tuple );
     virtual bool perform( Value& returnValue,
                           const String& name,
@@ -72,11 +75,10 @@ private:
     Timer* m_timer;
 
     bool m_registered;
-    bool m_haveTime;
 
     bool m_running;
 
-    long long m_secsSinceEpoch;
+    Clocks::Disciplined m_clock;
 };
 
 } // namespace UI
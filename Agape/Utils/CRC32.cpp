@@ -0,0 +1,27 @@
+#include "CRC32.h"
+
+namespace
+{
+    const unsigned int _polynomial( 0xEDB88320 ); // Reversed.
+} // Anonymous namespace
+
+namespace Agape
+{
+
+unsigned int crc32( const char* data, int len, unsigned int crc )
+{
+    // Bitwise rather than table-driven to spare the client's RAM.
+    crc = ~crc;
+    for( int i( 0 ); i < len; ++i )
+    {
+        crc ^= (unsigned char)data[i];
+        for( int bit( 0 ); bit < 8; ++bit )
+        {
+            crc = ( crc >> 1 ) ^ ( _polynomial & ( 0 - ( crc & 1 ) ) );
+        }
+    }
+
+    return ~crc;
+}
+
+} // namespace Agape
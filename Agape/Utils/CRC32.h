@@ -0,0 +1,13 @@
+#ifndef AGAPE_UTILS_CRC32_H
+#define AGAPE_UTILS_CRC32_H
+
+namespace Agape
+{
+
+// Standard (IEEE 802.3) CRC-32. Pass the previous result as crc to continue
+// over further data.
+unsigned int crc32( const char* data, int len, unsigned int crc = 0 );
+
+} // namespace Agape
+
+#endif // AGAPE_UTILS_CRC32_H
@@ -1,5 +1,22 @@
 #include "RingBuffer.h"
 
+#include <string.h>
+
+// The items themselves aren't volatile, so make sure they're written before
+// the push offset says so (and read before the pop offset frees them).
+// Older compilers (e.g. for PIC32, where the other side is an interrupt on
+// the same core) only need a compiler barrier.
+#if defined( __ATOMIC_RELEASE )
+#define RING_BUFFER_PUBLISH() __atomic_thread_fence( __ATOMIC_RELEASE )
+#define RING_BUFFER_OBSERVE() __atomic_thread_fence( __ATOMIC_ACQUIRE )
+#elif defined( __GNUC__ )
+#define RING_BUFFER_PUBLISH() __asm__ __volatile__( "" ::: "memory" )
+#define RING_BUFFER_OBSERVE() __asm__ __volatile__( "" ::: "memory" )
+#else
+#define RING_BUFFER_PUBLISH()
+#define RING_BUFFER_OBSERVE()
+#endif
+
 namespace Agape
 {
 
@@ -22,30 +39,24 @@ template< class T >
 void RingBuffer< T >::push( const T& val )
 {
     m_values[ m_pushOffset ] = val;
-    int nextPushOffset( m_pushOffset + 1 );
-    if( nextPushOffset == m_capacity )
-    {
-        nextPushOffset = 0;
-    }
-    m_pushOffset = nextPushOffset;
+    RING_BUFFER_PUBLISH();
+    m_pushOffset = advance( m_pushOffset, 1 );
 }
 
 template< class T >
 T RingBuffer< T >::pop()
 {
+    RING_BUFFER_OBSERVE();
     T value( m_values[ m_popOffset ] );
-    int nextPopOffset( m_popOffset + 1 );
-    if( nextPopOffset == m_capacity )
-    {
-        nextPopOffset = 0;
-    }
-    m_popOffset = nextPopOffset;
+    RING_BUFFER_PUBLISH();
+    m_popOffset = advance( m_popOffset, 1 );
     return value;
 }
 
 template< class T >
 T RingBuffer< T >::front()
 {
+    RING_BUFFER_OBSERVE();
     T value( m_values[ m_popOffset ] );
     return value;
 }
@@ -57,14 +68,116 @@ void RingBuffer< T >::clear()
 }
 
 template< class T >
-bool RingBuffer< T >::isFull() const
+int RingBuffer< T >::push( const T* values, int count )
+{
+    int pushed( 0 );
+
+    // At most two spans: up to the end of storage, then from the start.
+    for( int i = 0; ( i < 2 ) && ( pushed < count ); ++i )
+    {
+        T* span;
+        int spanLength( reserve( span ) );
+        if( spanLength == 0 )
+        {
+            break;
+        }
+
+        int num( count - pushed < spanLength ? count - pushed : spanLength );
+        ::memcpy( span, values + pushed, num * sizeof( T ) );
+        commit( num );
+        pushed += num;
+    }
+
+    return pushed;
+}
+
+template< class T >
+int RingBuffer< T >::pop( T* values, int count )
+{
+    int popped( 0 );
+
+    for( int i = 0; ( i < 2 ) && ( popped < count ); ++i )
+    {
+        const T* span;
+        int spanLength( acquire( span ) );
+        if( spanLength == 0 )
+        {
+            break;
+        }
+
+        int num( count - popped < spanLength ? count - popped : spanLength );
+        ::memcpy( values + popped, span, num * sizeof( T ) );
+        release( num );
+        popped += num;
+    }
+
+    return popped;
+}
+
+template< class T >
+int RingBuffer< T >::reserve( T*& span )
+{
+    int pushOffset( m_pushOffset );
+    int popOffset( m_popOffset );
+
+    // One slot is always left empty, so full and empty differ.
+    int spanLength;
+    if( pushOffset < popOffset )
+    {
+        spanLength = popOffset - pushOffset - 1;
+    }
+    else
+    {
+        spanLength = m_capacity - pushOffset;
+        if( popOffset == 0 )
+        {
+            --spanLength;
+        }
+    }
+
+    span = m_values + pushOffset;
+    return spanLength;
+}
+
+template< class T >
+void RingBuffer< T >::commit( int count )
+{
+    RING_BUFFER_PUBLISH();
+    m_pushOffset = advance( m_pushOffset, count );
+}
+
+template< class T >
+int RingBuffer< T >::acquire( const T*& span )
 {
-    int nextOffset = m_pushOffset + 1;
-    if( nextOffset == m_capacity )
+    int pushOffset( m_pushOffset );
+    int popOffset( m_popOffset );
+    RING_BUFFER_OBSERVE();
+
+    int spanLength;
+    if( popOffset <= pushOffset )
     {
-        nextOffset = 0;
+        spanLength = pushOffset - popOffset;
     }
-    return( nextOffset == m_popOffset );
+    else
+    {
+        spanLength = m_capacity - popOffset;
+    }
+
+    span = m_values + popOffset;
+    return spanLength;
+}
+
+template< class T >
+void RingBuffer< T >::release( int count )
+{
+    RING_BUFFER_PUBLISH();
+    m_popOffset = advance( m_popOffset, count );
+}
+
+template< class T >
+bool RingBuffer< T >::isFull() const
+{
+    return( advance( m_pushOffset, 1 ) == m_popOffset );
 }
 
 template< class T >
@@ -105,6 +218,17 @@ int RingBuffer< T >::size() const
     return m_capacity - free() - 1;
 }
 
+template< class T >
+int RingBuffer< T >::advance( int offset, int count ) const
+{
+    offset += count;
+    if( offset >= m_capacity )
+    {
+        offset -= m_capacity;
+    }
+    return offset;
+}
+
 template class RingBuffer< char >;
 
 } // namespace Agape
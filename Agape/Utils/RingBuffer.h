@@ -4,6 +4,13 @@
 namespace Agape
 {
 
+/// Single producer, single consumer ring buffer. The producer and consumer
+/// may be different threads, or one may be an interrupt handler; only the
+/// offsets are shared, and each is only written by one side.
+///
+/// Besides single items, whole runs can be pushed and popped (T must be
+/// trivially copyable, as these use memcpy), or the contiguous span at the
+/// push or pop offset reserved and committed, to avoid a copy.
 template< class T >
 class RingBuffer
 {
@@ -16,6 +23,21 @@ public:
     T front();
     void clear();
 
+    // Bulk variants. Return how many items were pushed/popped, which is
+    // fewer than count if the buffer fills/empties.
+    int push( const T* values, int count );
+    int pop( T* values, int count );
+
+    // Producer: reserve() returns the contiguous free span at the push
+    // offset (and its length); write up to that many, then commit().
+    int reserve( T*& span );
+    void commit( int count );
+
+    // Consumer: acquire() returns the contiguous filled span at the pop
+    // offset (and its length); read up to that many, then release().
+    int acquire( const T*& span );
+    void release( int count );
+
     bool isFull() const;
     bool isEmpty() const;
 
@@ -26,11 +48,13 @@ public:
     int size() const;
 
 private:
+    int advance( int offset, int count ) const;
+
     const int m_capacity;
     volatile int m_pushOffset;
     volatile int m_popOffset;
 
-    volatile T* m_values;
+    T* m_values;
 };
 
 } // namespace Agape
@@ -0,0 +1,221 @@
+#ifdef RING_BUFFER_TEST
+
+#include "RingBuffer.h"
+#include "ReadableWritable.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace Agape;
+
+namespace
+{
+    const int _capacity( 32768 ); // As WebSocketsConnection.
+    const int _numStreamBytes( 16 * 1024 * 1024 );
+    const int _numTuples( 200000 );
+
+    // Producer/consumer across threads, random run lengths, so every wrap
+    // case gets hit.
+    bool streamTest( bool bulk )
+    {
+        RingBuffer< char > buffer( _capacity );
+        bool success( true );
+
+        std::thread producer( [&buffer, bulk]()
+        {
+            char chunk[4096];
+            int sent( 0 );
+            while( sent < _numStreamBytes )
+            {
+                int len( 1 + std::rand() % sizeof( chunk ) );
+                if( len > _numStreamBytes - sent ) len = _numStreamBytes - sent;
+                for( int i( 0 ); i < len; ++i ) chunk[i] = (char)( ( sent + i ) % 251 );
+
+                int pushed( 0 );
+                while( pushed < len )
+                {
+                    if( buffer.isFull() )
+                    {
+                        std::this_thread::yield();
+                    }
+                    else if( bulk )
+                    {
+                        pushed += buffer.push( chunk + pushed, len - pushed );
+                    }
+                    else
+                    {
+                        buffer.push( chunk[pushed++] );
+                    }
+                }
+                sent += len;
+            }
+        } );
+
+        char chunk[4096];
+        int received( 0 );
+        while( success && ( received < _numStreamBytes ) )
+        {
+            if( buffer.isEmpty() )
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            int len( bulk ? buffer.pop( chunk, 1 + ( received % sizeof( chunk ) ) ) : 0 );
+            if( !bulk )
+            {
+                chunk[len++] = buffer.pop();
+            }
+
+            for( int i( 0 ); success && ( i < len ); ++i )
+            {
+                success = ( chunk[i] == (char)( ( received + i ) % 251 ) );
+            }
+            received += len;
+        }
+
+        producer.join();
+        return success;
+    }
+
+    // One end of a loopback pair, as WebSocketsConnection: each write is a
+    // "message" pushed whole into the peer's ring (waiting while full).
+    class RingEnd : public ReadableWritable
+    {
+    public:
+        RingEnd( RingBuffer< char >& in, RingBuffer< char >& out, bool bulk ) :
+          m_in( in ),
+          m_out( out ),
+          m_bulk( bulk )
+        {
+        }
+
+        virtual int read( char* data, int len )
+        {
+            if( m_in.isEmpty() )
+            {
+                // Give the other end a go (this may be a single core).
+                std::this_thread::yield();
+                return 0;
+            }
+
+            if( m_bulk )
+            {
+                return m_in.pop( data, len );
+            }
+
+            // As before: a byte at a time.
+            int bufferSize( m_in.size() );
+            int numToRead( len > bufferSize ? bufferSize : len );
+            for( int i = 0; i < numToRead; ++i )
+            {
+                data[i] = m_in.pop();
+            }
+            return numToRead;
+        }
+
+        virtual int write( const char* data, int len )
+        {
+            int pushed( 0 );
+            while( pushed < len )
+            {
+                if( m_out.isFull() )
+                {
+                    std::this_thread::yield();
+                }
+                else if( m_bulk )
+                {
+                    pushed += m_out.push( data + pushed, len - pushed );
+                }
+                else
+                {
+                    m_out.push( data[pushed++] );
+                }
+            }
+            return len;
+        }
+
+        virtual bool error() { return false; }
+
+    private:
+        RingBuffer< char >& m_in;
+        RingBuffer< char >& m_out;
+        bool m_bulk;
+    };
+
+    bool loopback( bool bulk )
+    {
+        RingBuffer< char > up( _capacity );
+        RingBuffer< char > down( _capacity );
+        RingEnd client( down, up, bulk );
+        RingEnd server( up, down, bulk );
+
+        // Echo server.
+        std::thread serverThread( [&server]()
+        {
+            for( int i( 0 ); i < _numTuples; ++i )
+            {
+                Linda2::Tuple tuple;
+                while( !Linda2::Tuple::fromReadableWritable( server, tuple ) ) {}
+                tuple.toReadableWritable( server );
+            }
+        } );
+
+        String data( 200, 'x' );
+        bool success( true );
+        std::chrono::steady_clock::time_point start( std::chrono::steady_clock::now() );
+
+        // Keep a window of tuples in flight, as a busy client would.
+        const int window( 16 );
+        int sent( 0 );
+        for( int received( 0 ); success && ( received < _numTuples ); ++received )
+        {
+            while( ( sent < _numTuples ) && ( sent - received < window ) )
+            {
+                Linda2::Tuple tuple;
+                tuple[_type] = _Time;
+                tuple[_sourceID] = "Client0";
+                tuple[_offset] = sent;
+                tuple[_data] = data;
+                tuple.toReadableWritable( client );
+                ++sent;
+            }
+
+            Linda2::Tuple echo;
+            while( !Linda2::Tuple::fromReadableWritable( client, echo ) ) {}
+            success = ( (int)echo[_offset] == received );
+        }
+
+        double seconds( std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count() );
+        serverThread.join();
+
+        std::cout << "Loopback " << ( bulk ? "bulk" : "bytewise" ) << ": "
+                  << (int)( 2 * _numTuples / seconds ) << " tuples/s"
+                  << ( success ? "" : " FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    bool bytewise( streamTest( false ) );
+    std::cout << "Stream bytewise: " << ( bytewise ? "OK" : "FAILED" ) << std::endl;
+    bool bulk( streamTest( true ) );
+    std::cout << "Stream bulk: " << ( bulk ? "OK" : "FAILED" ) << std::endl;
+    success = bytewise && bulk;
+
+    success = loopback( false ) && success;
+    success = loopback( true ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // RING_BUFFER_TEST
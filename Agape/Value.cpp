@@ -19,6 +19,40 @@ namespace
     // prevent us seeing corrupt/partial data.
     const int maxElements( 256 );
     const int maxStringLength( 4096 );
+
+    // Lists this short are compared element by element; longer ones by hash.
+    const unsigned int _shortList( 8 );
+
+    // Distinguishes kinds of value with the same bits, e.g. an empty word from
+    // an empty list.
+    const unsigned long long _wordSeed( 0x9e3779b97f4a7c15ULL );
+    const unsigned long long _numberSeed( 0xc2b2ae3d27d4eb4fULL );
+    const unsigned long long _listSeed( 0x165667b19e3779f9ULL );
+    const unsigned long long _mapSeed( 0x27d4eb2f165667c5ULL );
+    const unsigned long long _unknownSeed( 0x85ebca77c2b2ae63ULL );
+
+    // splitmix64's finaliser, so that the low bits can index a table.
+    unsigned long long mix( unsigned long long h )
+    {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    // FNV-1a.
+    unsigned long long hashBytes( const char* data, int len )
+    {
+        unsigned long long h( 0xcbf29ce484222325ULL );
+        for( int i( 0 ); i < len; ++i )
+        {
+            h ^= (unsigned char)data[i];
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
 } // Anonymous namespace
 
 namespace Agape
@@ -36,7 +70,9 @@ Value::Value() :
   m_listValue( nullptr ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -47,7 +83,9 @@ Value::Value( const String& stringValue ) :
   m_listValue( nullptr ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -58,7 +96,9 @@ Value::Value( const char* cStringValue ) :
   m_listValue( nullptr ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -69,7 +109,9 @@ Value::Value( int intValue ) :
   m_listValue( nullptr ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -80,7 +122,9 @@ Value::Value( double doubleValue ) :
   m_listValue( nullptr ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -91,7 +135,9 @@ Value::Value( Vector< Value* > listValue ) :
   m_listValue( new Vector< Value* >( listValue ) ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -102,7 +148,9 @@ Value::Value( Map< String, Value* > mapValue ) :
   m_listValue( nullptr ),
   m_mapValue( new Map< String, Value* >( mapValue ) ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
 }
 
@@ -113,7 +161,9 @@ Value::Value( const Value& other ) :
   m_listValue( nullptr ),
   m_mapValue( nullptr ),
   m_parent( nullptr ),
-  m_valueLoader( nullptr )
+  m_valueLoader( nullptr ),
+  m_hash( 0 ),
+  m_hashed( false )
 {
     *this = other;
 }
@@ -725,6 +775,7 @@ enum Value::ValueType Value::type() const
 void Value::markBinary()
 {
     m_valueType = binary;
+    m_hashed = false;
 }
 
 bool Value::isNull() const
@@ -732,6 +783,56 @@ bool Value::isNull() const
     return( m_valueType == unknown );
 }
 
+unsigned long long Value::hash() const
+{
+    if( m_hashed )
+    {
+        return m_hash;
+    }
+
+    unsigned long long h( 0 );
+    switch( m_valueType )
+    {
+    case word:
+    case binary:
+        m_hash = mix( _wordSeed ^ hashBytes( m_wordValue->c_str(), m_wordValue->length() ) );
+        m_hashed = true;
+        return m_hash;
+    case number:
+        {
+            // 0.0 == -0.0, so they must hash alike.
+            double number( ( m_numberValue == 0.0 ) ? 0.0 : m_numberValue );
+            unsigned long long bits( 0 );
+            ::memcpy( &bits, &number, sizeof( bits ) );
+            return mix( _numberSeed ^ bits );
+        }
+    case list:
+        {
+            // Summed, as lists are equal in any order.
+            Vector< Value* >::const_iterator it( m_listValue->begin() );
+            for( ; it != m_listValue->end(); ++it )
+            {
+                h += mix( ( *it )->hash() );
+            }
+            return mix( _listSeed ^ h ^ m_listValue->size() );
+        }
+    case map:
+        {
+            // Maps are ordered by key, so can be combined in order.
+            h = _mapSeed;
+            Map< String, Value* >::const_iterator it( m_mapValue->begin() );
+            for( ; it != m_mapValue->end(); ++it )
+            {
+                h = mix( h ^ hashBytes( it->first.c_str(), it->first.length() ) );
+                h = mix( h ^ it->second->hash() );
+            }
+            return h;
+        }
+    default:
+        return _unknownSeed;
+    }
+}
+
 void Value::setValueLoader( ValueLoader* valueLoader )
 {
     m_valueLoader = valueLoader;
@@ -974,6 +1075,7 @@ void Value::reset()
         break;
     }
     m_valueType = unknown;
+    m_hashed = false;
 }
 
 void Value::deleteString()
@@ -1045,26 +1147,80 @@ bool operator==( const Value& lhs, const String& rhs )
 }
 #endif
 
+// Lists are equal if they have the same elements, in any order, repeated the
+// same number of times.
 bool listsEqual( const Vector< Value* >& lhs, const Vector< Value* >& rhs )
 {
-    // FIXME: Lists could have different numbers of repeated values?
-    // FIXME: On^2 complexity!!
-    Vector< Value* >::const_iterator lhsIt( lhs.begin() );
-    for( ; lhsIt != lhs.end(); ++lhsIt )
+    if( lhs.size() != rhs.size() )
+    {
+        return false;
+    }
+
+    unsigned int size( lhs.size() );
+    if( size <= _shortList )
+    {
+        bool matched[_shortList] = { false };
+        for( unsigned int i( 0 ); i < size; ++i )
+        {
+            unsigned int j( 0 );
+            while( ( j < size ) && ( matched[j] || ( *( rhs[j] ) != *( lhs[i] ) ) ) )
+            {
+                ++j;
+            }
+
+            if( j == size )
+            {
+                return false;
+            }
+
+            matched[j] = true;
+        }
+
+        return true;
+    }
+
+    // Put rhs in an open-addressed table by hash, then find each lhs element
+    // there, matching each rhs element at most once.
+    unsigned int slotCount( 1 );
+    while( slotCount < ( size * 2 ) )
+    {
+        slotCount <<= 1;
+    }
+    unsigned int mask( slotCount - 1 );
+
+    Vector< int > slots( slotCount, -1 );
+    Vector< unsigned long long > rhsHashes( size );
+    Vector< bool > matched( size, false );
+    for( unsigned int j( 0 ); j < size; ++j )
+    {
+        rhsHashes[j] = rhs[j]->hash();
+        unsigned int slot( rhsHashes[j] & mask );
+        while( slots[slot] != -1 )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+        slots[slot] = j;
+    }
+
+    for( unsigned int i( 0 ); i < size; ++i )
     {
-        Vector< Value* >::const_iterator rhsIt( rhs.begin() );
-        for( ; rhsIt != rhs.end(); ++rhsIt )
+        unsigned long long lhsHash( lhs[i]->hash() );
+        unsigned int slot( lhsHash & mask );
+        for( ; slots[slot] != -1; slot = ( slot + 1 ) & mask )
         {
-            if( **rhsIt == **lhsIt )
+            int j( slots[slot] );
+            if( !matched[j] && ( rhsHashes[j] == lhsHash ) && ( *( rhs[j] ) == *( lhs[i] ) ) )
             {
                 break;
             }
         }
 
-        if( rhsIt == rhs.end() )
+        if( slots[slot] == -1 )
         {
             return false;
         }
+
+        matched[slots[slot]] = true;
     }
 
     return true;
@@ -1072,12 +1228,17 @@ bool listsEqual( const Vector< Value* >& lhs, const Vector< Value* >& rhs )
 
 bool mapsEqual( const Map< String, Value* >& lhs, const Map< String, Value* >& rhs )
 {
-    // FIXME: rhs could have spurious values?
+    if( lhs.size() != rhs.size() )
+    {
+        return false;
+    }
+
+    // Both are ordered by key, so can be walked together.
     Map< String, Value* >::const_iterator lhsIt( lhs.begin() );
-    for( ; lhsIt != lhs.end(); ++lhsIt )
+    Map< String, Value* >::const_iterator rhsIt( rhs.begin() );
+    for( ; lhsIt != lhs.end(); ++lhsIt, ++rhsIt )
     {
-        Map< String, Value* >::const_iterator rhsIt( rhs.find( lhsIt->first ) );
-        if( ( rhsIt == rhs.end() ) || ( *( rhsIt->second ) != *( lhsIt->second ) ) )
+        if( ( lhsIt->first != rhsIt->first ) || ( *( rhsIt->second ) != *( lhsIt->second ) ) )
         {
             return false;
         }
@@ -106,6 +106,13 @@ public:
 
     bool isNull() const;
 
+    // Structural hash, consistent with operator==: words and binaries with the
+    // same bytes hash alike, and lists hash the same in any order. A word's
+    // hash is kept until it's changed; lists and maps combine their elements'
+    // hashes each time, as the elements can be changed through the references
+    // we hand out.
+    unsigned long long hash() const;
+
     void setValueLoader( ValueLoader* valueLoader );
     bool load();
     bool save();
@@ -148,6 +155,9 @@ private:
 
     ValueLoader* m_valueLoader;
 
+    mutable unsigned long long m_hash;
+    mutable bool m_hashed;
+
     static String m_emptyString;
     static Vector< Value* > m_emptyList;
     static Map< String, Value* > m_emptyMap;
@@ -166,4 +176,20 @@ bool mapsEqual( const Map< String, Value* >& lhs, const Map< String, Value* >& r
 
 } // namespace Agape
 
+#ifndef __WATCOMC__
+namespace std
+{
+
+template<>
+struct hash< Agape::Value >
+{
+    size_t operator()( const Agape::Value& value ) const
+    {
+        return (size_t)value.hash();
+    }
+};
+
+} // namespace std
+#endif
+
 #endif // AGAPE_VALUE_H
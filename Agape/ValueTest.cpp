@@ -0,0 +1,257 @@
+#ifdef VALUE_TEST
+
+#include "Collections.h"
+#include "String.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+
+#include <time.h>
+
+using namespace Agape;
+
+namespace
+{
+    const int _properties( 1000 );
+    const int _listSize( 256 );
+    const int _comparisons( 200 );
+    const int _numTrials( 5 );
+    const int _numAttempts( 5 );
+    const double _minSpeedup( 4.0 );
+
+    // Deterministic, so that a failure can be reproduced.
+    unsigned int _seed( 1 );
+    unsigned int nextRandom( unsigned int range )
+    {
+        _seed = _seed * 1103515245 + 12345;
+        return ( ( _seed >> 8 ) % range );
+    }
+
+    String numbered( const char* prefix, int number )
+    {
+        return( ( prefix + std::to_string( number ) ).c_str() );
+    }
+
+    // A random value, words and numbers from a small set so that lists have
+    // repeats.
+    void makeValue( Value& value, int depth )
+    {
+        unsigned int kind( nextRandom( depth > 0 ? 6 : 4 ) );
+        switch( kind )
+        {
+        case 0:
+            value = numbered( "word", nextRandom( 5 ) );
+            break;
+        case 1:
+            value = numbered( "word", nextRandom( 5 ) );
+            value.markBinary();
+            break;
+        case 2:
+            value = (int)nextRandom( 5 );
+            break;
+        case 3:
+            break; // Unknown.
+        case 4:
+            {
+                unsigned int size( nextRandom( 12 ) );
+                value = Vector< Value* >();
+                for( unsigned int i( 0 ); i < size; ++i )
+                {
+                    makeValue( *value.push_back( new Value ), depth - 1 );
+                }
+            }
+            break;
+        default:
+            {
+                unsigned int size( nextRandom( 5 ) );
+                value = Map< String, Value* >();
+                for( unsigned int i( 0 ); i < size; ++i )
+                {
+                    makeValue( value[numbered( "key", nextRandom( 8 ) )], depth - 1 );
+                }
+            }
+            break;
+        }
+    }
+
+    // A deep copy with every list shuffled, which should be equal.
+    void shuffle( Value& value )
+    {
+        if( value.type() == Value::list )
+        {
+            Vector< Value* > elements( value.listBegin(), value.listEnd() );
+            for( int i( (int)elements.size() - 1 ); i > 0; --i )
+            {
+                std::swap( elements[i], elements[nextRandom( i + 1 )] );
+            }
+            std::copy( elements.begin(), elements.end(), value.listBegin() );
+        }
+
+        ListIterator listIt( value.listBegin() );
+        for( ; listIt != value.listEnd(); ++listIt )
+        {
+            shuffle( **listIt );
+        }
+
+        MapIterator mapIt( value.mapBegin() );
+        for( ; mapIt != value.mapEnd(); ++mapIt )
+        {
+            shuffle( *( mapIt->second ) );
+        }
+    }
+
+    Value makeList( std::initializer_list< const char* > elements )
+    {
+        Value value;
+        value = Vector< Value* >();
+        for( const char* element : elements )
+        {
+            value.push_back( new Value( element ) );
+        }
+        return value;
+    }
+
+    // As listsEqual was, one way round.
+    bool quadraticEqual( const Value& lhs, const Value& rhs )
+    {
+        ConstListIterator lhsIt( lhs.listBegin() );
+        for( ; lhsIt != lhs.listEnd(); ++lhsIt )
+        {
+            ConstListIterator rhsIt( rhs.listBegin() );
+            for( ; rhsIt != rhs.listEnd(); ++rhsIt )
+            {
+                if( **rhsIt == **lhsIt ) break;
+            }
+            if( rhsIt == rhs.listEnd() ) return false;
+        }
+        return true;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+
+    // CPU time in microseconds, so that time spent running anything else
+    // isn't counted.
+    long long cpuus()
+    {
+        struct timespec now;
+        ::clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &now );
+        return ( (long long)now.tv_sec * 1000000LL ) + ( now.tv_nsec / 1000 );
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    // Equal values hash alike, whatever order their lists are in, and equality
+    // is symmetric.
+    bool equalHashes( true );
+    bool symmetric( true );
+    int collisions( 0 );
+    for( int i( 0 ); i < _properties; ++i )
+    {
+        Value value;
+        makeValue( value, 3 );
+        Value copy( value );
+        shuffle( copy );
+        equalHashes = equalHashes && ( copy == value ) && ( value == copy ) && ( copy.hash() == value.hash() );
+
+        Value other;
+        makeValue( other, 3 );
+        symmetric = symmetric && ( ( other == value ) == ( value == other ) );
+        if( ( other != value ) && ( other.hash() == value.hash() ) ) ++collisions;
+    }
+    success = check( "Equal hashes", equalHashes ) && success;
+    success = check( "Symmetric", symmetric ) && success;
+    success = check( "Collisions", collisions == 0 ) && success;
+
+    Value word( "bytes" );
+    Value binary( "bytes" );
+    binary.markBinary();
+    Value zero( 0.0 );
+    Value negativeZero( -0.0 );
+    success = check( "Kinds", ( word == binary ) && ( word.hash() == binary.hash() ) &&
+                              ( zero.hash() == negativeZero.hash() ) &&
+                              ( Value( "" ).hash() != Value().hash() ) &&
+                              ( Value( "1" ).hash() != Value( 1 ).hash() ) ) && success;
+
+    // Lists are multisets: the same elements as often, in any order.
+    success = check( "Multisets", ( makeList( { "a", "b", "a" } ) == makeList( { "a", "a", "b" } ) ) &&
+                                  ( makeList( { "a", "a", "b" } ) != makeList( { "a", "b", "b" } ) ) &&
+                                  ( makeList( { "a" } ) != makeList( { "a", "b" } ) ) &&
+                                  ( makeList( { "a", "b" } ) != makeList( { "a" } ) ) ) && success;
+
+    Value map;
+    map["a"] = 1;
+    Value biggerMap( map );
+    biggerMap["b"] = 2;
+    success = check( "Maps", ( map != biggerMap ) && ( biggerMap != map ) &&
+                             ( map.hash() != biggerMap.hash() ) ) && success;
+
+    // Hashes follow changes, including to elements.
+    Value changing( makeList( { "a", "b" } ) );
+    unsigned long long before( changing.hash() );
+    **changing.listBegin() = "c";
+    unsigned long long after( changing.hash() );
+    word = "other";
+    success = check( "Mutation", ( before != after ) && ( after == makeList( { "c", "b" } ).hash() ) &&
+                                 ( word.hash() == Value( "other" ).hash() ) ) && success;
+
+    std::unordered_set< Value > set;
+    set.insert( makeList( { "x", "y" } ) );
+    set.insert( makeList( { "y", "x" } ) );
+    set.insert( map );
+    success = check( "std::hash", ( set.size() == 2 ) && ( set.count( biggerMap ) == 0 ) ) && success;
+
+    // Shuffled lists of distinct words, as the old comparison's worst case.
+    Value list;
+    list = Vector< Value* >();
+    for( int i( 0 ); i < _listSize; ++i )
+    {
+        list.push_back( new Value( numbered( "element", i ) ) );
+    }
+    Value shuffled( list );
+    shuffle( shuffled );
+
+    bool faster( false );
+    for( int attempt( 0 ); !faster && ( attempt < _numAttempts ); ++attempt )
+    {
+        long long slowus( -1 );
+        long long fastus( -1 );
+        bool agree( true );
+        for( int trial( 0 ); trial < _numTrials; ++trial )
+        {
+            for( int pass( 0 ); pass < 2; ++pass )
+            {
+                long long& bestus( ( pass == 0 ) ? slowus : fastus );
+                long long startus( cpuus() );
+                for( int comparison( 0 ); comparison < _comparisons; ++comparison )
+                {
+                    bool equal( ( pass == 0 ) ? ( quadraticEqual( list, shuffled ) && quadraticEqual( shuffled, list ) ) :
+                                                ( list == shuffled ) );
+                    agree = agree && equal;
+                }
+                long long us( cpuus() - startus );
+                if( ( bestus < 0 ) || ( us < bestus ) ) bestus = us;
+            }
+        }
+
+        double speedup( (double)slowus / ( fastus > 0 ? fastus : 1 ) );
+        faster = agree && ( speedup >= _minSpeedup );
+        std::cout << _comparisons << " comparisons of " << _listSize << " elements: " << slowus << "us quadratic, "
+                  << fastus << "us hashed, " << speedup << "x" << ( faster ? " OK" : "" ) << std::endl;
+    }
+    success = check( "Faster", faster ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // VALUE_TEST
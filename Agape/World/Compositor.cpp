@@ -4,6 +4,7 @@
 #include "SceneLoaders/Factories/SceneLoadersFactory.h"
 #include "SceneLoaders/SceneLoader.h"
 #include "SceneLoaders/SceneRequest.h"
+#include "SceneLoaders/WriteBehindSceneLoader.h"
 #include "AssetLoaders/Factories/AssetLoadersFactory.h"
 #include "AssetLoaders/AssetLoader.h"
 #include "Assets/Asset.h"
@@ -150,6 +151,16 @@ Compositor::~Compositor()
     delete( m_cursorTimer );
 }
 
+void Compositor::registerListener( UpdateListener* listener )
+{
+    m_updateListeners.push_back( listener );
+}
+
+void Compositor::registerMoveListener( MoveListener* listener )
+{
+    m_moveListeners.push_back( listener );
+}
+
 int Compositor::height() const
 {
     return m_terminal.height();
@@ -179,7 +190,7 @@ void Compositor::render( const Coordinates& newCoordinates )
     w2.report();
 
     Warp w3( "Load scene" );
-    m_currentSceneLoader = m_sceneLoaderFactory.makeLoader( newCoordinates );
+    m_currentSceneLoader = new SceneLoaders::WriteBehind( newCoordinates, m_sceneLoaderFactory );
     m_currentSceneLoader->load( m_currentScene ); // Continue on failure.
     w3.report();
 
@@ -213,6 +224,8 @@ void Compositor::render( const Coordinates& newCoordinates )
     m_teleportRow = -1;
     m_teleportCol = -1;
 
+    notifyMoved( Direction::none );
+
     Warp w5( "Paint scene" );
     render();
     w5.report();
@@ -258,11 +271,13 @@ void Compositor::render()
         Warp w1( "Open asset" );
 
         AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( m_coordinates, thisSceneItem.assetName() ) );
+        bool unknown( false );
         if( !assetLoader->open() )
         {
             delete( assetLoader );
             assetLoader = m_unknownAssetLoaderFactory.makeLoader( Coordinates(), "unknown" );
             assetLoader->open();
+            unknown = true;
         }
 
         w1.report();
@@ -301,17 +316,32 @@ void Compositor::render()
             }
             else
             {
+                const Assets::CompiledANSI* compiled( m_compiledANSIs.find( compiledKey( thisSceneItem.assetName(), unknown ),
+                                                                            *assetLoader,
+                                                                            ansiFile ) );
+
                 m_terminal.consumeNext( thisSceneItem.row(), thisSceneItem.col() );
-                m_terminal.consumeAsset( ansiFile,
-                                         0, // Offset zero
-                                         ansiFile.dataSize(),
-                                         ansiFile.width(),
-                                         thisSceneItem.col(),
-                                         Terminal::noMaxRow,
-                                         Terminal::scrollLock,
-                                         Terminal::whitespaceTransparency | Terminal::ANSI,
-                                         m_collisionMap,
-                                         itemIdx );
+                if( compiled )
+                {
+                    m_terminal.consumeCompiled( *compiled,
+                                                0, // Only frame
+                                                Terminal::whitespaceTransparency | Terminal::ANSI,
+                                                m_collisionMap,
+                                                itemIdx );
+                }
+                else
+                {
+                    m_terminal.consumeAsset( ansiFile,
+                                             0, // Offset zero
+                                             ansiFile.dataSize(),
+                                             ansiFile.width(),
+                                             thisSceneItem.col(),
+                                             Terminal::noMaxRow,
+                                             Terminal::scrollLock,
+                                             Terminal::whitespaceTransparency | Terminal::ANSI,
+                                             m_collisionMap,
+                                             itemIdx );
+                }
                 if( ansiFile.hasSAUCE() )
                 {
                     ansiFile.getHeights( m_heightMap,
@@ -403,7 +433,7 @@ void Compositor::depart()
 
     if( m_currentSceneLoader != nullptr )
     {
-        delete( m_currentSceneLoader ); // If Linda2, unsubscribes from scene updates at these coordinates.
+        delete( m_currentSceneLoader ); // Flushes attribute writes. If Linda2, unsubscribes from scene updates at these coordinates.
         m_currentSceneLoader = nullptr;
         
         m_pendingLocalSceneRequests.clear();
@@ -543,11 +573,13 @@ void Compositor::walk( enum Direction::_Direction direction, bool& atEdge )
 void Compositor::createSprite( const String& name, const String& assetName, int row, int col )
 {
     AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( m_coordinates, assetName ) );
+    bool unknown( false );
     if( !assetLoader->open() )
     {
         delete( assetLoader );
         assetLoader = m_unknownAssetLoaderFactory.makeLoader( Coordinates(), "unknown" );
         assetLoader->open();
+        unknown = true;
     }
 
     Assets::ANSIFile ansiFile( *assetLoader );
@@ -564,16 +596,37 @@ void Compositor::createSprite( const String& name, const String& assetName, int
 
     if( animate && ( ( frames < 2 ) || ( ( ansiFile.height() % frames ) != 0 ) ) ) return;
 
-    m_terminal.createSprite( name,
-                             assetName,
-                             ansiFile,
-                             ansiFile.dataSize(),
-                             row,
-                             col,
-                             animate ? ansiFile.height() / frames : ansiFile.height(),
-                             ansiFile.width(),
-                             Terminal::whitespaceTransparency | ( blit ? Terminal::blit : 0 ) | Terminal::ANSI,
-                             animate ? frames : 1 );
+    int frameHeight( animate ? ansiFile.height() / frames : ansiFile.height() );
+    int numFrames( animate ? frames : 1 );
+    int charMode( Terminal::whitespaceTransparency | ( blit ? Terminal::blit : 0 ) | Terminal::ANSI );
+
+    const Assets::CompiledANSI* compiled( m_compiledANSIs.find( compiledKey( assetName, unknown ),
+                                                                *assetLoader,
+                                                                ansiFile,
+                                                                frameHeight,
+                                                                numFrames ) );
+    if( compiled )
+    {
+        m_terminal.createSprite( name,
+                                 assetName,
+                                 *compiled,
+                                 row,
+                                 col,
+                                 charMode );
+    }
+    else
+    {
+        m_terminal.createSprite( name,
+                                 assetName,
+                                 ansiFile,
+                                 ansiFile.dataSize(),
+                                 row,
+                                 col,
+                                 frameHeight,
+                                 ansiFile.width(),
+                                 charMode,
+                                 numFrames );
+    }
 
     if( ansiFile.hasSAUCE() )
     {
@@ -1861,9 +1914,20 @@ bool Compositor::deleteSceneItemAttributes( const String& snowflake )
     return false;
 }
 
+bool Compositor::flushSceneItemAttributes()
+{
+    if( m_currentSceneLoader )
+    {
+        return m_currentSceneLoader->flushSceneItemAttributes();
+    }
+
+    return true;
+}
+
 void Compositor::invalidateAllCached()
 {
     LOG_DEBUG( "Compositor: Invalidating all cached assets" );
+    m_compiledANSIs.invalidateAll();
     AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( m_coordinates, String() ) );
     AssetLoader* programAssetLoader( m_programAssetLoaderFactory.makeLoader( m_coordinates, String() ) );
     assetLoader->invalidateCached( true ); // true = all.
@@ -1872,6 +1936,18 @@ void Compositor::invalidateAllCached()
     delete( programAssetLoader );
 }
 
+void Compositor::revalidateAllCached( const Coordinates& coordinates )
+{
+    LOG_DEBUG( "Compositor: Revalidating all cached assets" );
+    m_compiledANSIs.invalidateAll(); // Quicker to recompile than to check.
+    AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( coordinates, String() ) );
+    AssetLoader* programAssetLoader( m_programAssetLoaderFactory.makeLoader( coordinates, String() ) );
+    assetLoader->revalidateCached();
+    programAssetLoader->revalidateCached();
+    delete( assetLoader );
+    delete( programAssetLoader );
+}
+
 void Compositor::invalidateCached( const Vector< struct SceneLoader::InvalidatedAsset >& invalidatedAssets,
                                    bool& didRender )
 {
@@ -1880,6 +1956,12 @@ void Compositor::invalidateCached( const Vector< struct SceneLoader::Invalidated
     Vector< struct SceneLoader::InvalidatedAsset >::const_iterator invalidatedIt( invalidatedAssets.begin() );
     for( ; invalidatedIt != invalidatedAssets.end(); ++invalidatedIt )
     {
+        if( invalidatedIt->m_type == _asset )
+        {
+            // Including our own changes, which won't have been compiled yet.
+            m_compiledANSIs.invalidate( compiledKey( invalidatedIt->m_name, false ) );
+        }
+
         if( invalidatedIt->m_originatorID == m_tupleRouter.myID() )
         {
             // We will have already handled our own requests.
@@ -2056,6 +2138,9 @@ void Compositor::run()
             // updates when out of editing mode (editor unlocks scene).
             if( m_currentSceneLoader )
             {
+                // Catch any attribute writes made outside of Carlo handlers.
+                m_currentSceneLoader->flushSceneItemAttributes();
+
                 if( !m_currentSceneLoader->overflowed() )
                 {
                     Vector< SceneRequest > requests( m_currentSceneLoader->getUpdates() );
@@ -2069,6 +2154,14 @@ void Compositor::run()
                     // Reload whole scene.
                     LOG_DEBUG( "Compositor: Reloading scene due to request overflow" );
                     m_currentSceneLoader->load( m_currentScene );
+                    notifyUpdated( m_coordinates );
+
+                    m_currentItem = m_currentScene.m_sceneItems.end();
+                    if( !m_currentScene.m_sceneItems.empty() )
+                    {
+                        m_currentItem--; // Select last item.
+                    }
+                    render();
                 }
 
                 Vector< struct SceneLoader::InvalidatedAsset > invalidatedAssets( m_currentSceneLoader->getInvalidatedAssets() );
@@ -2107,15 +2200,22 @@ void Compositor::run()
 void Compositor::tileBackground()
 {
     AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( m_coordinates, _ground ) );
+    bool unknown( false );
     if( !assetLoader->open() )
     {
         delete( assetLoader );
         assetLoader = m_unknownAssetLoaderFactory.makeLoader( Coordinates(), _unknown );
         assetLoader->open();
+        unknown = true;
     }
 
     Assets::ANSIFile ansiFile( *assetLoader );
 
+    // Parsed once, then painted into every tile.
+    const Assets::CompiledANSI* compiled( m_compiledANSIs.find( compiledKey( _ground, unknown ),
+                                                                *assetLoader,
+                                                                ansiFile ) );
+
     int tileWidth = ansiFile.width();
     int tileHeight = ansiFile.height();
     for( int row = 0; row < height(); row += tileHeight )
@@ -2123,14 +2223,21 @@ void Compositor::tileBackground()
         for( int col = 0; col < width(); col += tileWidth )
         {
             m_terminal.consumeNext( row, col );
-            m_terminal.consumeAsset( ansiFile,
-                                     0,
-                                     ansiFile.dataSize(),
-                                     tileWidth,
-                                     col,
-                                     Terminal::noMaxRow,
-                                     Terminal::scrollLock,
-                                     Terminal::ANSI );
+            if( compiled )
+            {
+                m_terminal.consumeCompiled( *compiled, 0, Terminal::ANSI );
+            }
+            else
+            {
+                m_terminal.consumeAsset( ansiFile,
+                                         0,
+                                         ansiFile.dataSize(),
+                                         tileWidth,
+                                         col,
+                                         Terminal::noMaxRow,
+                                         Terminal::scrollLock,
+                                         Terminal::ANSI );
+            }
         }
     }
 
@@ -2207,6 +2314,13 @@ void Compositor::getAssetDimensions( const String& assetName, int& height, int&
     delete( assetLoader );
 }
 
+String Compositor::compiledKey( const String& assetName, bool unknown ) const
+{
+    // Whatever couldn't be opened, the unknown asset is drawn instead, and
+    // it's the same in every world.
+    return( unknown ? ( String( "/" ) + _unknown ) : ( m_coordinates.m_worldID + "/" + assetName ) );
+}
+
 void Compositor::loadTemplateProgram( const String& itemSnowflake, const String& templateName )
 {
     if( !templateName.empty() )
@@ -2303,6 +2417,11 @@ void Compositor::tryWalk( enum Direction::_Direction direction, int newRow, int
     }
     // else if ground (collision), don't move at all.
 
+    if( maxHeight != ground )
+    {
+        notifyMoved( direction );
+    }
+
     if( hiding || unhiding || !m_positionHidden )
     {
         ScenePresence scenePresence;
@@ -2380,6 +2499,12 @@ void Compositor::updateScene( Vector< SceneRequest >& requests )
             LOG_DEBUG( "Received bogus scene update!" );
             continue;
         }
+
+        notifyUpdated( requestIt->m_coordinates );
+        if( requestIt->m_sceneOperation == SceneRequest::transport )
+        {
+            notifyUpdated( requestIt->m_newCoordinates );
+        }
         
         if( requestIt->m_originatorID == m_tupleRouter.myID() )
         {
@@ -2591,6 +2716,24 @@ void Compositor::updateScene( Vector< SceneRequest >& requests )
     }
 }
 
+void Compositor::notifyUpdated( const Coordinates& coordinates )
+{
+    Vector< UpdateListener* >::const_iterator it( m_updateListeners.begin() );
+    for( ; it != m_updateListeners.end(); ++it )
+    {
+        ( *it )->sceneUpdated( coordinates );
+    }
+}
+
+void Compositor::notifyMoved( enum Direction::_Direction direction )
+{
+    Vector< MoveListener* >::const_iterator it( m_moveListeners.begin() );
+    for( ; it != m_moveListeners.end(); ++it )
+    {
+        ( *it )->moved( m_coordinates, m_positionRow, m_positionCol, direction );
+    }
+}
+
 void Compositor::updatePresences( Vector< PresenceRequest >& requests )
 {
     Vector< PresenceRequest >::const_iterator requestIt( requests.begin() );
@@ -3,6 +3,7 @@
 
 #include "Allocator.h"
 #include "AssetLoaders/Factories/BakedAssetLoaderFactory.h"
+#include "Assets/CompiledANSI.h"
 #include "Collections.h"
 #include "Direction.h"
 #include "PresenceLoaders/PresenceLoader.h"
@@ -65,6 +66,26 @@ namespace World
 class Compositor : public Runnable
 {
 public:
+    // Told of every change to a scene that passes through us, local or
+    // remote, e.g. so that a cached rendering of it can be rebuilt.
+    class UpdateListener
+    {
+    public:
+        virtual void sceneUpdated( const Coordinates& coordinates ) = 0;
+    };
+
+    // Told of each step the user takes, and of their arriving in a scene
+    // (with no direction), e.g. so that the scene they're heading for can be
+    // fetched before they reach the edge.
+    class MoveListener
+    {
+    public:
+        virtual void moved( const Coordinates& coordinates,
+                            int row,
+                            int col,
+                            enum Direction::_Direction direction ) = 0;
+    };
+
     Compositor( Terminal& terminal,
                 SceneLoaders::Factory& sceneLoaderFactory,
                 AssetLoaders::Factory& assetLoaderFactory,
@@ -78,6 +99,9 @@ public:
                 Audio::MIDIPlayer& midiPlayer );
     virtual ~Compositor();
 
+    void registerListener( UpdateListener* listener );
+    void registerMoveListener( MoveListener* listener );
+
     int height() const;
     int width() const;
 
@@ -167,8 +191,11 @@ public:
                                  const String& name,
                                  const Value& value );
     bool deleteSceneItemAttributes( const String& snowflake );
+    // Attribute writes are held back until flushed, here or periodically.
+    bool flushSceneItemAttributes();
 
     void invalidateAllCached();
+    void revalidateAllCached( const Coordinates& coordinates );
     void invalidateCached( const Vector< struct SceneLoader::InvalidatedAsset >& invalidatedAssets,
                            bool& didRender );
     void notifyInvalidated( const String& name,
@@ -196,12 +223,16 @@ private:
 
     void getAssetDimensions( const String& assetName, int& height, int& width );
     
+    String compiledKey( const String& assetName, bool unknown ) const;
+
     void loadTemplateProgram( const String& itemSnowflake, const String& templateName );
     void loadLinkedProgram( const String& itemSnowflake );
 
     void tryWalk( enum Direction::_Direction direction, int newRow, int newCol, int glyphOffset1, int glyphOffset2 );
 
     void updateScene( Vector< SceneRequest >& requests );
+    void notifyUpdated( const Coordinates& coordinates );
+    void notifyMoved( enum Direction::_Direction direction );
     void updatePresences( Vector< PresenceRequest >& requests );
 
     void collideBaseAndSprites( int row,
@@ -237,6 +268,9 @@ private:
 
     AssetLoaders::Factories::Baked m_unknownAssetLoaderFactory;
 
+    // Scene assets as drawn, so that re-rendering needn't re-parse them.
+    Assets::CompiledANSIs m_compiledANSIs;
+
     World::Scene m_currentScene;
     SceneLoader* m_currentSceneLoader;
     Vector< SceneRequest > m_pendingLocalSceneRequests;
@@ -281,6 +315,9 @@ private:
     bool m_itemCursorEnabled;
 
     Vector< String > m_programs;
+
+    Vector< UpdateListener* > m_updateListeners;
+    Vector< MoveListener* > m_moveListeners;
 };
 
 } // namespace World
@@ -6,21 +6,33 @@
 #include "GraphicsDrivers/Headless.h"
 #include "SceneLoaders/Factories/SceneLoadersFactory.h"
 #include "SceneLoaders/SceneLoader.h"
+#include "Timers/NullTimer.h"
+#include "Utils/LiteStream.h"
 #include "Utils/Tokeniser.h"
 #include "World/Scene.h"
 #include "World/SceneItem.h"
 #include "World/WorldCoordinates.h"
 #include "ANSITerminal.h"
+#include "Collections.h"
 #include "MiniMap.h"
 #include "String.h"
 #include "StringConstants.h"
 
+#if defined( QT_CORE_LIB ) || defined( HYDRA )
+#define MINI_MAP_THREADS
+#include <thread>
+#endif
+
 #include <math.h>
 #include <string.h>
 
 namespace
 {
     const int bufferSize = 512;
+
+    // Below this many tiles per thread, thread start-up costs more than the
+    // drawing it saves.
+    const int _minJobsPerThread( 4 );
 } // Anonymous namespace
 
 namespace Agape
@@ -31,30 +43,223 @@ namespace World
 
 MiniMap::MiniMap( SceneLoaders::Factory& sceneLoaderFactory,
                   AssetLoaders::Factory& assetLoaderFactory,
-                  ANSITerminal& renderTerminal ) :
+                  ANSITerminal& renderTerminal,
+                  unsigned int maxTiles ) :
   m_sceneLoaderFactory( sceneLoaderFactory ),
   m_assetLoaderFactory( assetLoaderFactory ),
   m_renderTerminal( renderTerminal ),
-  m_renderSize( 0 ),
+  m_maxTiles( maxTiles ),
+  m_uses( 0 ),
   m_fastMode( true )
 {
-    m_buffer = new char[bufferSize];
 }
 
 MiniMap::~MiniMap()
 {
-    delete[]( m_buffer );
+}
+
+void MiniMap::prepare( const Vector< Coordinates >& coordinates, int xtiles, int ytiles )
+{
+    Vector< Job > jobs;
+    Vector< Coordinates >::const_iterator it( coordinates.begin() );
+    for( ; it != coordinates.end(); ++it )
+    {
+        if( it->m_worldID != m_worldID )
+        {
+            // Tiles are only kept for one world at a time.
+            m_tiles.clear();
+            m_worldID = it->m_worldID;
+        }
+
+        String name( tileName( *it, xtiles, ytiles ) );
+        Map< String, Tile >::iterator tileIt( m_tiles.find( name ) );
+        if( ( tileIt != m_tiles.end() ) && !tileIt->second.m_stale )
+        {
+            tileIt->second.m_lastUsed = ++m_uses;
+            continue;
+        }
+
+        Job job;
+        job.m_name = name;
+        job.m_coordinates = *it;
+        SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( *it, SceneLoader::noReceiveRequests ) );
+        bool loaded( sceneLoader->load( job.m_scene ) );
+        delete( sceneLoader );
+        if( !loaded )
+        {
+            // Drawn, but not kept, by render().
+            continue;
+        }
+
+        // Changed, but perhaps changed back.
+        job.m_version = job.m_scene.version();
+        if( ( tileIt != m_tiles.end() ) && ( tileIt->second.m_version == job.m_version ) )
+        {
+            tileIt->second.m_stale = false;
+            tileIt->second.m_lastUsed = ++m_uses;
+            continue;
+        }
+
+        jobs.push_back( job );
+    }
+
+    renderJobs( jobs, xtiles, ytiles );
+
+    Vector< Job >::const_iterator jobIt( jobs.begin() );
+    for( ; jobIt != jobs.end(); ++jobIt )
+    {
+        Tile& tile( m_tiles[jobIt->m_name] );
+        tile.m_version = jobIt->m_version;
+        tile.m_data = jobIt->m_data;
+        tile.m_stale = false;
+        tile.m_lastUsed = ++m_uses;
+    }
+
+    evict();
 }
 
 void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int ytiles )
 {
-    m_renderTerminal.clearScreen();
+    prepare( Vector< Coordinates >( 1, coordinates ), xtiles, ytiles );
 
-    SceneLoader* sceneLoader( m_sceneLoaderFactory.makeLoader( coordinates, SceneLoader::noReceiveRequests ) );
-    Scene scene;
-    sceneLoader->load( scene );
-    delete( sceneLoader );
-    tileBackground( coordinates );
+    Map< String, Tile >::const_iterator it( m_tiles.find( tileName( coordinates, xtiles, ytiles ) ) );
+    if( it != m_tiles.end() )
+    {
+        m_rendered = it->second.m_data;
+    }
+    else
+    {
+        // The scene couldn't be loaded, so draw just its background.
+        renderTile( Scene(), coordinates, xtiles, ytiles, m_renderTerminal, m_rendered );
+    }
+}
+
+int MiniMap::renderedSize()
+{
+    return m_rendered.size();
+}
+
+int MiniMap::read( char* data, int offset, int len )
+{
+    int lenToRead( len > ( renderedSize() - offset ) ? ( renderedSize() - offset ) : len );
+    ::memcpy( data, m_rendered.data() + offset, lenToRead );
+    return lenToRead;
+}
+
+void MiniMap::sceneUpdated( const Coordinates& coordinates )
+{
+    if( coordinates.m_worldID != m_worldID )
+    {
+        return;
+    }
+
+    // Every tiling of the scene.
+    LiteStream stream;
+    stream << coordinates.m_x << "_"
+           << coordinates.m_y << "T";
+    String prefix( stream.str() );
+    Map< String, Tile >::iterator it( m_tiles.lower_bound( prefix ) );
+    for( ; ( it != m_tiles.end() ) && ( it->first.compare( 0, prefix.size(), prefix ) == 0 ); ++it )
+    {
+        it->second.m_stale = true;
+    }
+}
+
+// As the asset names MiniMap strategy asks for.
+String MiniMap::tileName( const Coordinates& coordinates, int xtiles, int ytiles )
+{
+    LiteStream stream;
+    stream << coordinates.m_x << "_"
+           << coordinates.m_y << "T"
+           << xtiles << "_"
+           << ytiles;
+    return stream.str();
+}
+
+// Drops the least recently used tiles once there are too many.
+void MiniMap::evict()
+{
+    while( m_tiles.size() > m_maxTiles )
+    {
+        Map< String, Tile >::iterator oldest( m_tiles.begin() );
+        Map< String, Tile >::iterator it( m_tiles.begin() );
+        for( ; it != m_tiles.end(); ++it )
+        {
+            if( it->second.m_lastUsed < oldest->second.m_lastUsed )
+            {
+                oldest = it;
+            }
+        }
+
+        m_tiles.erase( oldest );
+    }
+}
+
+void MiniMap::renderJobs( Vector< Job >& jobs, int xtiles, int ytiles )
+{
+#ifdef MINI_MAP_THREADS
+    // Slow mode opens assets through loaders that can't be shared between
+    // threads, so only fast mode is drawn in parallel.
+    int jobCount( jobs.size() );
+    int threadCount( m_fastMode ? std::thread::hardware_concurrency() : 1 );
+    if( threadCount > ( jobCount / _minJobsPerThread ) )
+    {
+        threadCount = jobCount / _minJobsPerThread;
+    }
+
+    if( threadCount > 1 )
+    {
+        // Vector's allocator copy-constructs, which threads don't allow.
+        std::thread* threads( new std::thread[threadCount - 1] );
+
+        // Each other thread draws into a terminal of its own, and this one
+        // into the render terminal.
+        for( int i( 1 ); i < threadCount; ++i )
+        {
+            threads[i - 1] = std::thread( [this, &jobs, i, threadCount, xtiles, ytiles]()
+            {
+                GraphicsDrivers::Headless headless;
+                Timers::Null timer;
+                ANSITerminal terminal( m_renderTerminal.width(), m_renderTerminal.height(), String(), headless, timer );
+                renderSlice( jobs, i, threadCount, xtiles, ytiles, terminal );
+            } );
+        }
+
+        renderSlice( jobs, 0, threadCount, xtiles, ytiles, m_renderTerminal );
+
+        for( int i( 1 ); i < threadCount; ++i )
+        {
+            threads[i - 1].join();
+        }
+
+        delete[]( threads );
+
+        return;
+    }
+#endif
+
+    renderSlice( jobs, 0, 1, xtiles, ytiles, m_renderTerminal );
+}
+
+// Every stride'th job from first, so that slices of a map (e.g. a corner full
+// of busy scenes) are shared out evenly.
+void MiniMap::renderSlice( Vector< Job >& jobs, int first, int stride, int xtiles, int ytiles, ANSITerminal& terminal )
+{
+    for( int i( first ); i < (int)jobs.size(); i += stride )
+    {
+        renderTile( jobs[i].m_scene, jobs[i].m_coordinates, xtiles, ytiles, terminal, jobs[i].m_data );
+    }
+}
+
+void MiniMap::renderTile( const Scene& scene,
+                          const Coordinates& coordinates,
+                          int xtiles,
+                          int ytiles,
+                          ANSITerminal& terminal,
+                          String& data )
+{
+    terminal.clearScreen();
+    tileBackground( coordinates, terminal );
 
     Vector< SceneItem >::const_iterator iter;
     for( iter = scene.m_sceneItems.begin(); iter != scene.m_sceneItems.end(); ++iter )
@@ -87,28 +292,28 @@ void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int yti
             if( blit || sprite ||
                 ( animate && ( frames > 0 ) && ( ( ansiFile.height() % frames ) == 0 ) ) )
             {
-                m_renderTerminal.createSprite( thisSceneItem.snowflake(),
-                                            String(),
-                                            ansiFile,
-                                            ansiFile.dataSize(),
-                                            thisSceneItem.row(),
-                                            thisSceneItem.col(),
-                                            ansiFile.height(),
-                                            ansiFile.width(),
-                                            Terminal::whitespaceTransparency | ( blit ? Terminal::blit : 0 ),
-                                            animate ? frames : 1 );
+                terminal.createSprite( thisSceneItem.snowflake(),
+                                       String(),
+                                       ansiFile,
+                                       ansiFile.dataSize(),
+                                       thisSceneItem.row(),
+                                       thisSceneItem.col(),
+                                       ansiFile.height(),
+                                       ansiFile.width(),
+                                       Terminal::whitespaceTransparency | ( blit ? Terminal::blit : 0 ),
+                                       animate ? frames : 1 );
             }
             else
             {
-                m_renderTerminal.consumeNext( thisSceneItem.row(), thisSceneItem.col() );
-                m_renderTerminal.consumeAsset( ansiFile,
-                                            0, // Offset zero
-                                            ansiFile.dataSize(),
-                                            ansiFile.width(),
-                                            thisSceneItem.col(),
-                                            Terminal::noMaxRow,
-                                            Terminal::scrollLock,
-                                            Terminal::whitespaceTransparency );
+                terminal.consumeNext( thisSceneItem.row(), thisSceneItem.col() );
+                terminal.consumeAsset( ansiFile,
+                                       0, // Offset zero
+                                       ansiFile.dataSize(),
+                                       ansiFile.width(),
+                                       thisSceneItem.col(),
+                                       Terminal::noMaxRow,
+                                       Terminal::scrollLock,
+                                       Terminal::whitespaceTransparency );
             }
 
             delete( assetLoader );
@@ -121,8 +326,8 @@ void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int yti
             {
                 for( int x = thisSceneItem.col(); x < thisSceneItem.col() + thisSceneItem.width(); ++x )
                 {
-                    m_renderTerminal.consumeNext( y, x, 0x07 );
-                    m_renderTerminal.consumeChar( '\xdb', Terminal::scrollLock );
+                    terminal.consumeNext( y, x, 0x07 );
+                    terminal.consumeChar( '\xdb', Terminal::scrollLock );
                 }
             }
         }
@@ -130,10 +335,11 @@ void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int yti
 
     // Shrink down rendered scene and create ANSI output.
     int currentTileAtt( 0 );
-    char* buffPtr( m_buffer );
-    for( int startRow = 0; startRow <= ( m_renderTerminal.height() - ytiles ); startRow += ytiles )
+    char buffer[bufferSize];
+    char* buffPtr( buffer );
+    for( int startRow = 0; startRow <= ( terminal.height() - ytiles ); startRow += ytiles )
     {
-        for( int startCol = 0; startCol <= ( m_renderTerminal.width() - xtiles ); startCol += xtiles )
+        for( int startCol = 0; startCol <= ( terminal.width() - xtiles ); startCol += xtiles )
         {
             char character;
             char attribute;
@@ -144,7 +350,7 @@ void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int yti
             {
                 for( int tileCol = 0; tileCol < xtiles; ++tileCol )
                 {
-                    m_renderTerminal.getBaseCharAt( startRow + tileRow, startCol + tileCol, character, attribute );
+                    terminal.getBaseCharAt( startRow + tileRow, startCol + tileCol, character, attribute );
                     unsigned char uattr( *( (unsigned char*)&attribute ) );
                     unsigned char bg( uattr >> 4 );
                     unsigned char fg( uattr & 0x0F );
@@ -240,7 +446,7 @@ void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int yti
             if( tileAtt != currentTileAtt )
             {
                 String colourEscape( ANSITerminal::colour( tileAtt ) );
-                if( ( ( buffPtr - m_buffer ) + colourEscape.length() ) <= bufferSize ) // Check overflow.
+                if( ( ( buffPtr - buffer ) + colourEscape.length() ) <= bufferSize ) // Check overflow.
                 {
                     ::memcpy( buffPtr, colourEscape.c_str(), colourEscape.length() );
                     buffPtr += colourEscape.length();
@@ -249,35 +455,23 @@ void MiniMap::render( const World::Coordinates& coordinates, int xtiles, int yti
                 currentTileAtt = tileAtt;
             }
 
-            if( ( ( buffPtr - m_buffer ) + 1 ) <= bufferSize ) // Check overflow.
+            if( ( ( buffPtr - buffer ) + 1 ) <= bufferSize ) // Check overflow.
             {
                 *buffPtr++ = c;
             }
         }
 
-        if( ( ( buffPtr - m_buffer ) + 2 ) <= bufferSize ) // Check overflow.
+        if( ( ( buffPtr - buffer ) + 2 ) <= bufferSize ) // Check overflow.
         {
             *buffPtr++ = '\r';
             *buffPtr++ = '\n';
         }
     }
 
-    m_renderSize = buffPtr - m_buffer;
-}
-
-int MiniMap::renderedSize()
-{
-    return m_renderSize;
-}
-
-int MiniMap::read( char* data, int offset, int len )
-{
-    int lenToRead( len > ( m_renderSize - offset ) ? ( m_renderSize - offset ) : len );
-    ::memcpy( data, m_buffer + offset, lenToRead );
-    return lenToRead;
+    data = String( buffer, buffPtr - buffer );
 }
 
-void MiniMap::tileBackground( const World::Coordinates& coordinates )
+void MiniMap::tileBackground( const World::Coordinates& coordinates, ANSITerminal& terminal )
 {
     if( !m_fastMode )
     {
@@ -294,12 +488,12 @@ void MiniMap::tileBackground( const World::Coordinates& coordinates )
 
         int tileWidth = ansiFile.width();
         int tileHeight = ansiFile.height();
-        for( int row = 0; row < m_renderTerminal.height(); row += tileHeight )
+        for( int row = 0; row < terminal.height(); row += tileHeight )
         {
-            for( int col = 0; col < m_renderTerminal.width(); col += tileWidth )
+            for( int col = 0; col < terminal.width(); col += tileWidth )
             {
-                m_renderTerminal.consumeNext( row, col );
-                m_renderTerminal.consumeAsset( ansiFile, 0, ansiFile.dataSize(), tileWidth, col, Terminal::noMaxRow, Terminal::scrollLock );
+                terminal.consumeNext( row, col );
+                terminal.consumeAsset( ansiFile, 0, ansiFile.dataSize(), tileWidth, col, Terminal::noMaxRow, Terminal::scrollLock );
             }
         }
 
@@ -308,12 +502,12 @@ void MiniMap::tileBackground( const World::Coordinates& coordinates )
     else
     {
         // Fast mode: Draw background as solid green.
-        for( int y = 0; y < m_renderTerminal.height(); ++y )
+        for( int y = 0; y < terminal.height(); ++y )
         {
-            for( int x = 0; x < m_renderTerminal.width(); ++x )
+            for( int x = 0; x < terminal.width(); ++x )
             {
-                m_renderTerminal.consumeNext( y, x, 0x02 );
-                m_renderTerminal.consumeChar( '\xb1', Terminal::scrollLock );
+                terminal.consumeNext( y, x, 0x02 );
+                terminal.consumeChar( '\xb1', Terminal::scrollLock );
             }
         }
     }
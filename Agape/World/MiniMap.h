@@ -4,7 +4,11 @@
 #include "AssetLoaders/Factories/BakedAssetLoaderFactory.h"
 #include "GraphicsDrivers/Headless.h"
 #include "Timers/NullTimer.h"
+#include "World/Compositor.h"
+#include "World/Scene.h"
+#include "World/WorldCoordinates.h"
 #include "ANSITerminal.h"
+#include "Collections.h"
 #include "String.h"
 
 namespace Agape
@@ -23,31 +27,70 @@ class Factory;
 namespace World
 {
 
-class Coordinates;
-
-class MiniMap
+// Renders scenes shrunk down to map tiles, keeping the tiles of the current
+// world so that a scene is only loaded again once the Compositor tells us it
+// has changed, and only redrawn if its version has.
+class MiniMap : public Compositor::UpdateListener
 {
 public:
     MiniMap( SceneLoaders::Factory& sceneLoaderFactory,
              AssetLoaders::Factory& assetLoaderFactory,
-             ANSITerminal& renderTerminal );
+             ANSITerminal& renderTerminal,
+             unsigned int maxTiles );
     ~MiniMap();
 
+    // Builds any of these tiles not already built, drawing them in parallel
+    // where we can.
+    void prepare( const Vector< Coordinates >& coordinates, int xtiles, int ytiles );
+
     void render( const World::Coordinates& coordinates, int xtiles, int ytiles );
 
     int renderedSize();
     int read( char* data, int offset, int len );
 
+    virtual void sceneUpdated( const Coordinates& coordinates );
+
 private:
-    void tileBackground( const World::Coordinates& coordinates );
-    void getAssetFlags( const String& commentBlock, bool& blit, bool& animate, int& frames );
+    struct Tile
+    {
+        String m_version;
+        String m_data;
+        bool m_stale;
+        unsigned int m_lastUsed;
+    };
+
+    struct Job
+    {
+        String m_name;
+        Coordinates m_coordinates;
+        Scene m_scene;
+        String m_version;
+        String m_data;
+    };
+
+    static String tileName( const Coordinates& coordinates, int xtiles, int ytiles );
+
+    void renderTile( const Scene& scene,
+                     const Coordinates& coordinates,
+                     int xtiles,
+                     int ytiles,
+                     ANSITerminal& terminal,
+                     String& data );
+    void renderJobs( Vector< Job >& jobs, int xtiles, int ytiles );
+    void renderSlice( Vector< Job >& jobs, int first, int stride, int xtiles, int ytiles, ANSITerminal& terminal );
+    void tileBackground( const World::Coordinates& coordinates, ANSITerminal& terminal );
+    void evict();
 
     SceneLoaders::Factory& m_sceneLoaderFactory;
     AssetLoaders::Factory& m_assetLoaderFactory;
     ANSITerminal& m_renderTerminal;
 
-    int m_renderSize;
-    char* m_buffer;
+    String m_rendered;
+
+    unsigned int m_maxTiles;
+    String m_worldID;
+    Map< String, Tile > m_tiles; // By tile name, i.e. coordinates and tiling.
+    unsigned int m_uses;
 
     AssetLoaders::Factories::Baked m_unknownAssetLoaderFactory;
 
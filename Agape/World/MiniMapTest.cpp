@@ -0,0 +1,230 @@
+#ifdef MINI_MAP_TEST
+
+#include "AssetLoaders/Factories/BakedAssetLoaderFactory.h"
+#include "Clocks/CClock.h"
+#include "GraphicsDrivers/Headless.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "SceneLoaders/SceneLoader.h"
+#include "Timers/NullTimer.h"
+#include "Utils/Snowflake.h"
+#include "World/MiniMap.h"
+#include "World/Scene.h"
+#include "World/SceneItem.h"
+#include "World/WorldCoordinates.h"
+#include "ANSITerminal.h"
+#include "Collections.h"
+#include "String.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace Agape;
+
+namespace
+{
+    const int _mapSize( 16 ); // Scenes across and down.
+    const int _itemsPerScene( 12 );
+    const int _xtiles( 3 );
+    const int _ytiles( 3 );
+    const double _minSpeedup( 10.0 );
+
+    // Deterministic, so that a failure can be reproduced.
+    unsigned int _seed( 1 );
+    unsigned int nextRandom( unsigned int range )
+    {
+        _seed = _seed * 1103515245 + 12345;
+        return ( ( _seed >> 8 ) % range );
+    }
+
+    String sceneKey( const World::Coordinates& coordinates )
+    {
+        return( ( std::to_string( coordinates.m_x ) + "_" + std::to_string( coordinates.m_y ) ).c_str() );
+    }
+
+    // Scenes held in memory, counting loads.
+    class Scenes : public SceneLoaders::Factory
+    {
+    public:
+        class Loader : public SceneLoader
+        {
+        public:
+            Loader( const World::Coordinates& coordinates, Scenes& scenes ) :
+              SceneLoader( coordinates ),
+              m_scenes( scenes )
+            {
+            }
+
+            virtual bool load( World::Scene& scene )
+            {
+                ++m_scenes.m_loads;
+                Map< String, World::Scene >::const_iterator it( m_scenes.m_scenes.find( sceneKey( m_coordinates ) ) );
+                if( ( m_coordinates.m_worldID != m_scenes.m_worldID ) || ( it == m_scenes.m_scenes.end() ) )
+                {
+                    return false;
+                }
+
+                scene = it->second;
+                return true;
+            }
+
+            virtual bool request( const Vector< SceneRequest >& requests ) { return false; }
+            virtual Vector< SceneRequest > getUpdates() { return Vector< SceneRequest >(); }
+
+            Scenes& m_scenes;
+        };
+
+        Scenes( const String& worldID, Clock& clock ) :
+          m_worldID( worldID ),
+          m_loads( 0 )
+        {
+            for( int x( 0 ); x < _mapSize; ++x )
+            {
+                for( int y( 0 ); y < _mapSize; ++y )
+                {
+                    World::Scene& scene( m_scenes[sceneKey( World::Coordinates( worldID, x, y ) )] );
+                    for( int i( 0 ); i < _itemsPerScene; ++i )
+                    {
+                        scene.m_sceneItems.push_back( World::SceneItem( "box",
+                                                                        nextRandom( 20 ),
+                                                                        nextRandom( 70 ),
+                                                                        1 + nextRandom( 5 ),
+                                                                        1 + nextRandom( 10 ),
+                                                                        "owner",
+                                                                        String(),
+                                                                        clock ) );
+                    }
+                }
+            }
+        }
+
+        virtual SceneLoader* makeLoader( const World::Coordinates& coordinates, bool receiveRequests )
+        {
+            return new Loader( coordinates, *this );
+        }
+
+        String m_worldID;
+        Map< String, World::Scene > m_scenes;
+        int m_loads;
+    };
+
+    class Drawing
+    {
+    public:
+        Drawing( Scenes& scenes ) :
+          m_terminal( 80, 25, String(), m_headless, m_timer ),
+          m_miniMap( scenes, m_unknownAssetLoaderFactory, m_terminal, _mapSize * _mapSize )
+        {
+        }
+
+        String tile( const World::Coordinates& coordinates )
+        {
+            m_miniMap.render( coordinates, _xtiles, _ytiles );
+            std::string data( m_miniMap.renderedSize(), '\0' );
+            m_miniMap.read( &data[0], 0, data.size() );
+            return String( data.data(), data.size() );
+        }
+
+        GraphicsDrivers::Headless m_headless;
+        Timers::Null m_timer;
+        ANSITerminal m_terminal;
+        AssetLoaders::Factories::Baked m_unknownAssetLoaderFactory;
+        World::MiniMap m_miniMap;
+    };
+
+    Vector< World::Coordinates > wholeMap( const String& worldID )
+    {
+        Vector< World::Coordinates > coordinates;
+        for( int x( 0 ); x < _mapSize; ++x )
+        {
+            for( int y( 0 ); y < _mapSize; ++y )
+            {
+                coordinates.push_back( World::Coordinates( worldID, x, y ) );
+            }
+        }
+        return coordinates;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+
+    long long nowus()
+    {
+        return std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    Clocks::C clock;
+    Snowflake snowflake( clock, 1 );
+
+    Scenes scenes( "world", clock );
+    Drawing drawing( scenes );
+    Vector< World::Coordinates > map( wholeMap( "world" ) );
+
+    // The whole map cold, drawn in parallel, then warm.
+    long long startus( nowus() );
+    drawing.m_miniMap.prepare( map, _xtiles, _ytiles );
+    long long coldus( nowus() - startus );
+    int coldLoads( scenes.m_loads );
+
+    startus = nowus();
+    drawing.m_miniMap.prepare( map, _xtiles, _ytiles );
+    long long warmus( nowus() - startus );
+    int warmLoads( scenes.m_loads - coldLoads );
+
+    double speedup( (double)coldus / ( warmus > 0 ? warmus : 1 ) );
+    std::cout << _mapSize << "x" << _mapSize << " scenes on " << std::thread::hardware_concurrency() << " threads: "
+              << coldus << "us cold, " << warmus << "us warm, " << speedup << "x" << std::endl;
+    success = check( "Cold", coldLoads == ( _mapSize * _mapSize ) ) && success;
+    success = check( "Warm", ( warmLoads == 0 ) && ( speedup >= _minSpeedup ) ) && success;
+
+    // Tiles drawn in parallel are as drawn one at a time.
+    Drawing serial( scenes );
+    bool same( true );
+    Vector< World::Coordinates >::const_iterator it( map.begin() );
+    for( ; it != map.end(); ++it )
+    {
+        same = same && ( drawing.tile( *it ) == serial.tile( *it ) );
+    }
+    success = check( "Parallel", same && ( drawing.tile( map[0] ).size() > 0 ) ) && success;
+
+    // A change is only picked up once we're told of it, and only that scene
+    // is loaded again.
+    World::Coordinates changed( "world", 5, 5 );
+    String before( drawing.tile( changed ) );
+    World::Scene& scene( scenes.m_scenes[sceneKey( changed )] );
+    scene.m_sceneItems.push_back( World::SceneItem( "box", 0, 0, 25, 80, "owner", String(), clock ) );
+    bool untold( drawing.tile( changed ) == before );
+    int loads( scenes.m_loads );
+    drawing.m_miniMap.sceneUpdated( changed );
+    drawing.m_miniMap.prepare( map, _xtiles, _ytiles );
+    success = check( "Updated", untold && ( scenes.m_loads == loads + 1 ) && ( drawing.tile( changed ) != before ) ) && success;
+
+    // Told of a change that changed nothing, the tile is kept.
+    World::Coordinates unchanged( "world", 6, 6 );
+    before = drawing.tile( unchanged );
+    loads = scenes.m_loads;
+    drawing.m_miniMap.sceneUpdated( unchanged );
+    drawing.m_miniMap.sceneUpdated( World::Coordinates( "elsewhere", 7, 7 ) );
+    drawing.m_miniMap.prepare( map, _xtiles, _ytiles );
+    success = check( "Unchanged", ( scenes.m_loads == loads + 1 ) && ( drawing.tile( unchanged ) == before ) ) && success;
+
+    // Another world starts from nothing.
+    loads = scenes.m_loads;
+    drawing.m_miniMap.prepare( wholeMap( "other" ), _xtiles, _ytiles );
+    drawing.m_miniMap.prepare( map, _xtiles, _ytiles );
+    success = check( "World", scenes.m_loads == loads + 2 * ( _mapSize * _mapSize ) ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // MINI_MAP_TEST
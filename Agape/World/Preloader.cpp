@@ -0,0 +1,208 @@
+#include "AssetLoaders/Factories/AssetLoadersFactory.h"
+#include "AssetLoaders/AssetLoader.h"
+#include "Loggers/Logger.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "SceneLoaders/SceneLoader.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "World/Scene.h"
+#include "World/SceneItem.h"
+#include "World/WorldCoordinates.h"
+#include "Collections.h"
+#include "Preloader.h"
+#include "String.h"
+#include "StringConstants.h"
+
+#include <algorithm>
+
+namespace
+{
+    const int _fetchTimeout( 10000 ); // ms, before we give up on the scene.
+    const int _settleTime( 250 ); // ms without a step before opening assets.
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace World
+{
+
+Preloader::Preloader( SceneLoaders::Factory& sceneLoaderFactory,
+                      AssetLoaders::Factory& assetLoaderFactory,
+                      Timers::Factory& timerFactory,
+                      int height,
+                      int width,
+                      int budget ) :
+  m_sceneLoaderFactory( sceneLoaderFactory ),
+  m_assetLoaderFactory( assetLoaderFactory ),
+  m_height( height ),
+  m_width( width ),
+  m_budget( budget ),
+  m_state( idle ),
+  m_hasTarget( false ),
+  m_sceneLoader( nullptr ),
+  m_nextAsset( 0 ),
+  m_fetchedSize( 0 ),
+  m_fetchTimer( timerFactory.makeTimer() ),
+  m_settleTimer( timerFactory.makeTimer() )
+{
+}
+
+Preloader::~Preloader()
+{
+    delete( m_sceneLoader );
+    delete( m_fetchTimer );
+    delete( m_settleTimer );
+}
+
+void Preloader::moved( const Coordinates& coordinates,
+                       int row,
+                       int col,
+                       enum Direction::_Direction direction )
+{
+    m_settleTimer->reset();
+
+    // Only once we're nearer the edge we're heading for than the one we came
+    // from.
+    Coordinates target( coordinates );
+    bool heading( false );
+    switch( direction )
+    {
+    case Direction::up:
+        heading = ( row < m_height / 2 );
+        ++target.m_y;
+        break;
+    case Direction::down:
+        heading = ( row >= m_height / 2 );
+        --target.m_y;
+        break;
+    case Direction::left:
+        heading = ( col < m_width / 2 );
+        --target.m_x;
+        break;
+    case Direction::right:
+        heading = ( col >= m_width / 2 );
+        ++target.m_x;
+        break;
+    default:
+        break; // Arrived.
+    }
+
+    if( !heading )
+    {
+        cancel();
+    }
+    else if( !m_hasTarget || ( target != m_target ) )
+    {
+        start( target );
+    }
+}
+
+void Preloader::run()
+{
+    if( m_state == fetchingScene )
+    {
+        // The reply arrives as the router is pumped, e.g. by the Compositor's
+        // scene loader.
+        Scene scene;
+        if( m_sceneLoader->getPrefetched( scene ) )
+        {
+            prefetched( scene );
+        }
+        else if( m_fetchTimer->ms() >= _fetchTimeout )
+        {
+            LOG_DEBUG( "Preloader: Timed out fetching scene" );
+            delete( m_sceneLoader );
+            m_sceneLoader = nullptr;
+            m_state = idle;
+        }
+    }
+    else if( ready() )
+    {
+        fetchAsset();
+    }
+}
+
+bool Preloader::ready()
+{
+    return( ( m_state == fetchingAssets ) && ( m_settleTimer->ms() >= _settleTime ) );
+}
+
+void Preloader::start( const Coordinates& target )
+{
+    cancel();
+
+    m_target = target;
+    m_hasTarget = true;
+    m_sceneLoader = m_sceneLoaderFactory.makeLoader( m_target, SceneLoader::noReceiveRequests );
+    if( m_sceneLoader->prefetch() )
+    {
+        m_state = fetchingScene;
+        m_fetchTimer->reset();
+    }
+    else
+    {
+        // Nowhere to keep it, so it would only be fetched again on arrival.
+        delete( m_sceneLoader );
+        m_sceneLoader = nullptr;
+    }
+}
+
+void Preloader::cancel()
+{
+    // Any reply to the scene loader is dropped with it.
+    delete( m_sceneLoader );
+    m_sceneLoader = nullptr;
+    m_state = idle;
+    m_hasTarget = false;
+    m_assetNames.clear();
+    m_nextAsset = 0;
+    m_fetchedSize = 0;
+}
+
+// In the order the Compositor opens them when rendering.
+void Preloader::prefetched( const Scene& scene )
+{
+    delete( m_sceneLoader );
+    m_sceneLoader = nullptr;
+
+    m_assetNames.push_back( _ground );
+
+    Vector< SceneItem >::const_iterator it( scene.m_sceneItems.begin() );
+    for( ; it != scene.m_sceneItems.end(); ++it )
+    {
+        String assetName( it->assetName() );
+        if( std::find( m_assetNames.begin(), m_assetNames.end(), assetName ) == m_assetNames.end() )
+        {
+            m_assetNames.push_back( assetName );
+        }
+
+        if( it->flags() & SceneItem::linkedText )
+        {
+            m_assetNames.push_back( it->snowflake() + "_txt" );
+        }
+    }
+
+    m_state = fetchingAssets;
+}
+
+void Preloader::fetchAsset()
+{
+    if( ( m_nextAsset >= m_assetNames.size() ) || ( m_fetchedSize >= m_budget ) )
+    {
+        m_state = idle;
+        return;
+    }
+
+    AssetLoader* assetLoader( m_assetLoaderFactory.makeLoader( m_target, m_assetNames[m_nextAsset++] ) );
+    if( assetLoader->open() )
+    {
+        m_fetchedSize += assetLoader->size();
+        assetLoader->close();
+    }
+    delete( assetLoader );
+}
+
+} // namespace World
+
+} // namespace Agape
@@ -0,0 +1,105 @@
+#ifndef AGAPE_WORLD_PRELOADER_H
+#define AGAPE_WORLD_PRELOADER_H
+
+#include "World/Compositor.h"
+#include "World/Direction.h"
+#include "World/WorldCoordinates.h"
+#include "Collections.h"
+#include "Runnable.h"
+#include "String.h"
+
+namespace Agape
+{
+
+namespace AssetLoaders
+{
+class Factory;
+} // namespace AssetLoaders
+
+namespace SceneLoaders
+{
+class Factory;
+} // namespace SceneLoaders
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+class SceneLoader;
+class Timer;
+
+namespace World
+{
+
+class Scene;
+
+// Fetches the scene the user is walking towards, once they're past the middle
+// of this one heading for its edge, so that crossing into it is served from
+// the scene loader's replica rather than waiting on the server. The fetch
+// doesn't block, and is dropped if the user turns or arrives somewhere else.
+//
+// Its assets are then opened through the asset loader factory, so that they
+// land in its cache. Opening an asset does block, so they're only opened one
+// per run(), once the user has stopped walking for a moment, and only until
+// "budget" bytes of them have been fetched, so that we don't push the assets
+// of the scene we're in out of the cache.
+//
+// Presences aren't fetched, as they'd be stale by the time we arrived.
+class Preloader : public Runnable, public Compositor::MoveListener
+{
+public:
+    Preloader( SceneLoaders::Factory& sceneLoaderFactory,
+               AssetLoaders::Factory& assetLoaderFactory,
+               Timers::Factory& timerFactory,
+               int height,
+               int width,
+               int budget );
+    ~Preloader();
+
+    virtual void moved( const Coordinates& coordinates,
+                        int row,
+                        int col,
+                        enum Direction::_Direction direction );
+
+    virtual void run();
+    virtual bool ready();
+
+private:
+    enum State
+    {
+        idle,
+        fetchingScene,
+        fetchingAssets
+    };
+
+    void start( const Coordinates& target );
+    void cancel();
+    void prefetched( const Scene& scene );
+    void fetchAsset();
+
+    SceneLoaders::Factory& m_sceneLoaderFactory;
+    AssetLoaders::Factory& m_assetLoaderFactory;
+
+    int m_height;
+    int m_width;
+    int m_budget;
+
+    enum State m_state;
+    bool m_hasTarget; // Even once we're done with it.
+    Coordinates m_target;
+    SceneLoader* m_sceneLoader;
+
+    Vector< String > m_assetNames;
+    unsigned int m_nextAsset;
+    int m_fetchedSize;
+
+    Timer* m_fetchTimer; // Since the scene was asked for.
+    Timer* m_settleTimer; // Since the user last moved.
+};
+
+} // namespace World
+
+} // namespace Agape
+
+#endif // AGAPE_WORLD_PRELOADER_H
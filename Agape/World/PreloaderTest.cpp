@@ -0,0 +1,380 @@
+#ifdef PRELOADER_TEST
+
+#include "AssetLoaders/Caches/RAMAssetCache.h"
+#include "AssetLoaders/Factories/AssetLoadersFactory.h"
+#include "AssetLoaders/Factories/CacheAssetLoaderFactory.h"
+#include "AssetLoaders/AssetLoader.h"
+#include "Clocks/CClock.h"
+#include "Memories/RAMMemory.h"
+#include "SceneLoaders/Factories/CacheSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/FileSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/KiamaFSSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/Linda2SceneLoaderFactory.h"
+#include "SceneLoaders/Factories/SceneLoadersFactory.h"
+#include "SceneLoaders/Linda2SceneLoaderResponder.h"
+#include "SceneLoaders/SceneLoader.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "Utils/Snowflake.h"
+#include "World/Direction.h"
+#include "World/Preloader.h"
+#include "World/Scene.h"
+#include "World/SceneItem.h"
+#include "World/WorldCoordinates.h"
+#include "Collections.h"
+#include "KiamaFS.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Agape;
+using Agape::Linda2::TupleDispatcher;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const int _latencyMs( 40 ); // Each way and back, per request.
+    const int _sceneHeight( 24 );
+    const int _sceneWidth( 80 );
+    const int _itemsPerScene( 8 );
+    const int _assetSize( 1000 );
+    const int _budget( 50000 ); // Bytes of assets per scene ahead.
+
+    // The walk: a step every so often, with a pause part way across each
+    // scene as a user would make.
+    const int _stepMs( 10 );
+    const int _pauseCol( 60 );
+    const int _pauseMs( 600 );
+
+    long long nowus()
+    {
+        return std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    void sleepMs( int ms )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+    }
+
+    // Stands in for the network between the client and the responder: what
+    // the client waits on takes the latency, and what it doesn't arrives
+    // after it.
+    class Delayed : public SceneLoader
+    {
+    public:
+        Delayed( const World::Coordinates& coordinates, SceneLoader* loader, int& cancelled ) :
+          SceneLoader( coordinates ),
+          m_loader( loader ),
+          m_cancelled( cancelled ),
+          m_revalidationus( 0 )
+        {
+        }
+
+        virtual ~Delayed()
+        {
+            if( m_revalidationus != 0 ) ++m_cancelled;
+            delete( m_loader );
+        }
+
+        virtual bool load( World::Scene& scene ) { sleepMs( _latencyMs ); return m_loader->load( scene ); }
+        virtual bool request( const Vector< SceneRequest >& requests ) { return m_loader->request( requests ); }
+        virtual Vector< SceneRequest > getUpdates() { return m_loader->getUpdates(); }
+
+        virtual bool requestRevalidation( const String& version )
+        {
+            m_revalidationus = nowus();
+            return m_loader->requestRevalidation( version );
+        }
+
+        virtual bool getRevalidation( bool& current, World::Scene& scene )
+        {
+            if( ( m_revalidationus == 0 ) || ( nowus() - m_revalidationus < _latencyMs * 1000 ) )
+            {
+                return false;
+            }
+
+            bool revalidated( m_loader->getRevalidation( current, scene ) );
+            if( revalidated ) m_revalidationus = 0;
+            return revalidated;
+        }
+
+        SceneLoader* m_loader;
+        int& m_cancelled;
+        long long m_revalidationus; // While waiting on one.
+    };
+
+    class DelayedFactory : public SceneLoaders::Factory
+    {
+    public:
+        DelayedFactory( SceneLoaders::Factory& factory ) :
+          m_factory( factory ),
+          m_cancelled( 0 )
+        {
+        }
+
+        virtual SceneLoader* makeLoader( const World::Coordinates& coordinates, bool receiveRequests )
+        {
+            return new Delayed( coordinates, m_factory.makeLoader( coordinates, receiveRequests ), m_cancelled );
+        }
+
+        SceneLoaders::Factory& m_factory;
+        int m_cancelled; // Revalidations not waited for.
+    };
+
+    // The server's assets, all the same size, each taking the latency to
+    // open, and counted by scene.
+    class ServerAssets : public AssetLoaders::Factory
+    {
+    public:
+        class Loader : public AssetLoader
+        {
+        public:
+            Loader( const World::Coordinates& coordinates, const String& name, ServerAssets& assets ) :
+              AssetLoader( coordinates, name ),
+              m_assets( assets )
+            {
+            }
+
+            virtual bool open()
+            {
+                sleepMs( _latencyMs );
+                ++m_assets.m_opens[m_coordinates.m_x];
+                return true;
+            }
+
+            virtual int read( char* data, int offset, int len )
+            {
+                int n( ( offset + len > _assetSize ) ? _assetSize - offset : len );
+                ::memset( data, 'x', n );
+                return n;
+            }
+
+            virtual int size() { return _assetSize; }
+
+            ServerAssets& m_assets;
+        };
+
+        virtual AssetLoader* makeLoader( const World::Coordinates& coordinates, const String& name )
+        {
+            return new Loader( coordinates, name, *this );
+        }
+
+        Map< int, int > m_opens; // By x.
+    };
+
+    // A client's replica and asset cache, empty to start with.
+    class Client
+    {
+    public:
+        Client( SceneLoaders::Factory& backingFactory, AssetLoaders::Factory& assetBackingFactory, Timers::Factory& timerFactory, Clock& clock ) :
+          m_memory( 0x40000, 0x100, 0x1000, Memory::flash ),
+          m_fs( m_memory ),
+          m_replicaFactory( m_fs ),
+          m_sceneLoaderFactory( backingFactory, m_replicaFactory, timerFactory ),
+          m_assetCache( 64, _assetSize, clock ),
+          m_assetLoaderFactory( assetBackingFactory, m_assetCache, false )
+        {
+        }
+
+        bool hasReplica( const World::Coordinates& coordinates )
+        {
+            World::Scene scene;
+            SceneLoader* sceneLoader( m_replicaFactory.makeLoader( coordinates, false ) );
+            bool loaded( sceneLoader->load( scene ) );
+            delete( sceneLoader );
+            return loaded;
+        }
+
+        Memories::RAM m_memory;
+        KiamaFS m_fs;
+        SceneLoaders::Factories::KiamaFS m_replicaFactory;
+        SceneLoaders::Factories::Cache m_sceneLoaderFactory;
+        AssetLoaders::Caches::RAMAssetCache m_assetCache;
+        AssetLoaders::Factories::Cache m_assetLoaderFactory;
+    };
+
+    String makeScenesPath()
+    {
+        char path[] = "/tmp/PreloaderTestXXXXXX";
+        if( ::mkdtemp( path ) == nullptr ) return String();
+        return path;
+    }
+
+    void saveServerScene( SceneLoaders::Factories::File& fileFactory, const World::Coordinates& coordinates )
+    {
+        World::Scene scene;
+        scene.m_coordinates = coordinates;
+        for( int i( 0 ); i < _itemsPerScene; ++i )
+        {
+            World::SceneItem sceneItem;
+            sceneItem.setAssetName( ( "s" + std::to_string( coordinates.m_x ) + std::to_string( coordinates.m_y + 1 ) +
+                                      "a" + std::to_string( i ) ).c_str() );
+            sceneItem.setRow( 2 + i * 2 );
+            sceneItem.setCol( 5 + i * 8 );
+            sceneItem.setDimensions( 1, 1 );
+            sceneItem.touch();
+            scene.m_sceneItems.push_back( sceneItem );
+        }
+
+        SceneLoader* sceneLoader( fileFactory.makeLoader( coordinates, false ) );
+        sceneLoader->save( scene );
+        delete( sceneLoader );
+    }
+
+    // Keeps the router pumped and the preloader run, as the client's main
+    // loop would, for "ms".
+    void idle( TupleRouter& tupleRouter, World::Preloader* preloader, int ms )
+    {
+        long long untilus( nowus() + ms * 1000 );
+        do
+        {
+            tupleRouter.run();
+            if( preloader ) preloader->run();
+            sleepMs( 1 );
+        }
+        while( nowus() < untilus );
+    }
+
+    // As the Compositor renders a scene it's walked into, loading the scene
+    // and then opening each of its assets, but drawing nothing.
+    long long arrive( Client& client, const World::Coordinates& coordinates, World::Preloader* preloader )
+    {
+        long long startus( nowus() );
+
+        SceneLoader* sceneLoader( client.m_sceneLoaderFactory.makeLoader( coordinates, true ) );
+        World::Scene scene;
+        sceneLoader->load( scene );
+
+        Vector< String > assetNames;
+        assetNames.push_back( _ground );
+        Vector< World::SceneItem >::const_iterator it( scene.m_sceneItems.begin() );
+        for( ; it != scene.m_sceneItems.end(); ++it )
+        {
+            assetNames.push_back( it->assetName() );
+        }
+
+        Vector< String >::const_iterator nameIt( assetNames.begin() );
+        for( ; nameIt != assetNames.end(); ++nameIt )
+        {
+            AssetLoader* assetLoader( client.m_assetLoaderFactory.makeLoader( coordinates, *nameIt ) );
+            assetLoader->open();
+            delete( assetLoader );
+        }
+        delete( sceneLoader );
+
+        long long stallus( nowus() - startus );
+        if( preloader ) preloader->moved( coordinates, _sceneHeight / 2, 0, World::Direction::none );
+        return stallus;
+    }
+
+    // Walks right from the first scene across "scenes" of them, and gives
+    // the longest wait on crossing into one.
+    long long walk( Client& client, TupleRouter& tupleRouter, World::Preloader* preloader, int scenes )
+    {
+        long long worstus( 0 );
+        for( int x( 0 ); x < scenes; ++x )
+        {
+            long long stallus( arrive( client, World::Coordinates( "world", x, 0 ), preloader ) );
+            if( ( x > 0 ) && ( stallus > worstus ) ) worstus = stallus;
+
+            for( int col( 0 ); col < _sceneWidth; ++col )
+            {
+                if( preloader ) preloader->moved( World::Coordinates( "world", x, 0 ), _sceneHeight / 2, col, World::Direction::right );
+                idle( tupleRouter, preloader, ( col == _pauseCol ) ? _pauseMs : _stepMs );
+            }
+        }
+
+        return worstus;
+    }
+
+    bool check( const char* name, bool success )
+    {
+        std::cout << name << ": " << ( success ? "OK" : "FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    Clocks::C clock;
+    Snowflake snowflake( clock, 1 );
+
+    Timers::Factories::HighRes timerFactory;
+    TupleDispatcher tupleDispatcher;
+    TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+    tupleRouter.setMyID( "test" );
+
+    // The server, as File loaders behind the responder.
+    String scenesPath( makeScenesPath() );
+    SceneLoaders::Factories::File fileFactory( scenesPath, "scn", scenesPath, "sia" );
+    for( int x( 0 ); x < 4; ++x )
+    {
+        saveServerScene( fileFactory, World::Coordinates( "world", x, 0 ) );
+        saveServerScene( fileFactory, World::Coordinates( "world", x, -1 ) );
+    }
+    SceneLoaders::Linda2Responder responder( tupleRouter, fileFactory );
+    SceneLoaders::Factories::Linda2 linda2Factory( tupleRouter, timerFactory );
+    DelayedFactory delayedFactory( linda2Factory );
+    ServerAssets assets;
+
+    // Crossing into a scene waits on it and each of its assets in turn.
+    long long withoutus( 0 );
+    {
+    Client client( delayedFactory, assets, timerFactory, clock );
+    withoutus = walk( client, tupleRouter, nullptr, 3 );
+    }
+
+    // Unless they were fetched while we walked towards it.
+    long long withus( 0 );
+    {
+    Client client( delayedFactory, assets, timerFactory, clock );
+    World::Preloader preloader( client.m_sceneLoaderFactory, client.m_assetLoaderFactory, timerFactory, _sceneHeight, _sceneWidth, _budget );
+    assets.m_opens.clear();
+    withus = walk( client, tupleRouter, &preloader, 3 );
+    std::cout << "Crossing with " << _latencyMs << "ms latency: " << withoutus / 1000 << "ms without preloading, "
+              << withus / 1000 << "ms with" << std::endl;
+    success = check( "Stall", withus * 5 < withoutus ) && success;
+    success = check( "Ahead", client.hasReplica( World::Coordinates( "world", 3, 0 ) ) &&
+                              ( assets.m_opens[3] == _itemsPerScene ) ) && success;
+    }
+
+    // Turning drops the scene we were heading for.
+    {
+    Client client( delayedFactory, assets, timerFactory, clock );
+    World::Preloader preloader( client.m_sceneLoaderFactory, client.m_assetLoaderFactory, timerFactory, _sceneHeight, _sceneWidth, _budget );
+    arrive( client, World::Coordinates( "world", 1, 0 ), &preloader );
+    int cancelled( delayedFactory.m_cancelled );
+    preloader.moved( World::Coordinates( "world", 1, 0 ), _sceneHeight / 2, _sceneWidth / 2, World::Direction::right );
+    preloader.moved( World::Coordinates( "world", 1, 0 ), _sceneHeight / 2 + 1, _sceneWidth / 2, World::Direction::down );
+    idle( tupleRouter, &preloader, _latencyMs * 5 );
+    success = check( "Turn", ( delayedFactory.m_cancelled == cancelled + 1 ) &&
+                             !client.hasReplica( World::Coordinates( "world", 2, 0 ) ) &&
+                             client.hasReplica( World::Coordinates( "world", 1, -1 ) ) ) && success;
+    }
+
+    // Only so much of the scene ahead's assets are fetched.
+    {
+    Client client( delayedFactory, assets, timerFactory, clock );
+    World::Preloader preloader( client.m_sceneLoaderFactory, client.m_assetLoaderFactory, timerFactory, _sceneHeight, _sceneWidth, _assetSize * 3 );
+    arrive( client, World::Coordinates( "world", 0, 0 ), &preloader );
+    assets.m_opens.clear();
+    preloader.moved( World::Coordinates( "world", 0, 0 ), _sceneHeight / 2, _sceneWidth - 1, World::Direction::right );
+    idle( tupleRouter, &preloader, _pauseMs * 2 );
+    success = check( "Budget", assets.m_opens[1] == 2 ) && success; // And the ground, already cached.
+    }
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // PRELOADER_TEST
@@ -1,8 +1,12 @@
+#include "Encryptors/SHA256/SHA256Hash.h"
+#include "Encryptors/Utils/BatchDecryptor.h"
+#include "Utils/base64/base64.h"
 #include "Collections.h"
 #include "Scene.h"
 #include "SceneItem.h"
 #include "String.h"
 #include "StringConstants.h"
+#include "StringSerialiser.h"
 #include "Value.h"
 #include "WorldCoordinates.h"
 
@@ -56,28 +60,46 @@ int Scene::maxItems() const
     return _maxItems;
 }
 
-bool Scene::encrypt( Encryptor& encryptor )
+String Scene::version() const
 {
-    Vector< SceneItem >::iterator it( m_sceneItems.begin() );
+    // Coordinates aren't included, as not every loader sets them.
+    Hashes::SHA256 hash;
+    Vector< SceneItem >::const_iterator it( m_sceneItems.begin() );
     for( ; it != m_sceneItems.end(); ++it )
     {
-        if( !it->encrypt( encryptor ) ) return false;
+        Value sceneItem;
+        it->toValue( sceneItem );
+        StringSerialiser serialiser;
+        sceneItem.toReadableWritable( serialiser );
+        hash.update( serialiser.m_data.c_str(), serialiser.m_data.length() );
     }
 
-    return true;
+    char digest[hash.digestSize()];
+    hash.finalise( digest );
+
+    String encodedDigest( Base64encode_len( hash.digestSize() ), '\0' );
+    Base64encode( &encodedDigest[0], &digest[0], hash.digestSize() );
+    encodedDigest.resize( encodedDigest.length() - 1 );
+
+    return encodedDigest;
 }
 
-bool Scene::decrypt( Encryptor& encryptor )
+bool Scene::encrypt( Encryptor& encryptor )
 {
     Vector< SceneItem >::iterator it( m_sceneItems.begin() );
     for( ; it != m_sceneItems.end(); ++it )
     {
-        if( !it->decrypt( encryptor ) ) return false;
+        if( !it->encrypt( encryptor ) ) return false;
     }
 
     return true;
 }
 
+bool Scene::decrypt( Encryptor& encryptor )
+{
+    return Encryptors::Utils::BatchDecryptor::decrypt( m_sceneItems, encryptor );
+}
+
 } // namespace World
 
 } // namespace Agape
@@ -4,6 +4,7 @@
 #include "Collections.h"
 #include "EncryptableDecryptable.h"
 #include "SceneItem.h"
+#include "String.h"
 #include "WorldCoordinates.h"
 
 namespace Agape
@@ -24,6 +25,10 @@ public:
 
     int maxItems() const;
 
+    // Opaque content version (hash) of the items, in order. Scenes with the
+    // same items have the same version wherever it's computed.
+    String version() const;
+
     virtual bool encrypt( Encryptor& encryptor );
     virtual bool decrypt( Encryptor& encryptor );
 
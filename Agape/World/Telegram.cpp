@@ -63,6 +63,11 @@ bool Telegram::newer( const Telegram& a, const Telegram& b )
     return( a.m_dateTime > b.m_dateTime );
 }
 
+bool Telegram::snowflakeBefore( const Telegram& a, const Telegram& b )
+{
+    return( a.m_telegramSnowflake < b.m_telegramSnowflake );
+}
+
 } // namespace World
 
 } // namespace Agape
@@ -27,6 +27,7 @@ public:
     bool operator==( const Telegram& other ) const;
 
     static bool newer( const Telegram& a, const Telegram& b );
+    static bool snowflakeBefore( const Telegram& a, const Telegram& b );
 
     String m_telegramSnowflake;
     String m_senderSnowflake;
@@ -6,7 +6,7 @@
 #include "World/WorldMetadata.h"
 #include "World/WorldSummary.h"
 #include "Collections.h"
-#include "Promise.h"
+#include "Requester.h"
 #include "WorldLoader.h"
 #include "String.h"
 
@@ -53,34 +53,11 @@ public:
     virtual bool accept( Tuple& tuple );
 
 private:
-    TupleRouter& m_tupleRouter;
-    Timers::Factory& m_timerFactory;
-
-    Promise m_worldCreateResponse;
-    Promise m_worldJoinResponse;
-    Promise m_worldLoadResponse;
-    Promise m_worldLoadJoinedResponse;
-    Promise m_worldLoadTeleportsResponse;
-    Promise m_worldCreateTeleportResponse;
-    Promise m_worldDeleteTeleportResponse;
-    Promise m_worldLoadWorldSummariesResponse;
-    Promise m_worldLoadUniverseStatsResponse;
-    
-    bool m_isLoading;
-
-    World::Metadata m_metadata;
+    Tuple request( const String& type );
 
-    int m_currentJoinedWorld;
-    int m_totalJoinedWorlds;
-    Vector< World::Metadata >* m_joinedWorlds;
-
-    int m_currentTeleport;
-    int m_totalTeleports;
-    Vector< World::Teleport >* m_teleports;
-
-    Vector< World::Summary >* m_worldSummaries;
+    TupleRouter& m_tupleRouter;
 
-    World::UniverseStats* m_universeStats;
+    Requester m_requester;
 };
 
 } // namespace WorldLoaders
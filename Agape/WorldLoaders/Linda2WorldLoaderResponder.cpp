@@ -5,6 +5,7 @@
 #include "World/WorldSummary.h"
 #include "WorldLoaders/Factories/WorldLoadersFactory.h"
 #include "Linda2WorldLoaderResponder.h"
+#include "Reply.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
@@ -95,11 +96,8 @@ void Linda2Responder::_create( const Tuple& tuple )
     String reason;
     
     // FIXME: Send reason?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldCreateResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldCreateResponse ) );
     if( worldLoader->create( metadata, reason ) )
     {
         response[_success] = 1;
@@ -112,7 +110,7 @@ void Linda2Responder::_create( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldCreateResponse" );
 #endif
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
@@ -127,11 +125,8 @@ void Linda2Responder::_join( const Tuple& tuple )
     String reason;
     
     // FIXME: Send reason?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldJoinResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldJoinResponse ) );
 
     // Note: Writability of world checked/handled in WorldLoaders::Mongo.
     if( worldLoader->join( metadata, reason ) )
@@ -147,7 +142,7 @@ void Linda2Responder::_join( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldJoinResponse" );
 #endif
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
@@ -162,11 +157,8 @@ void Linda2Responder::_load( const Tuple& tuple )
     String reason;
     
     // FIXME: Send reason?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldLoadResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldLoadResponse ) );
     if( worldLoader->load( metadata, reason ) )
     {
         response[_success] = 1;
@@ -180,7 +172,7 @@ void Linda2Responder::_load( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldLoadResponse" );
 #endif
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
@@ -196,19 +188,13 @@ void Linda2Responder::_loadJoined( const Tuple& tuple )
     String reason;
     bool allDevices( (int)tuple[_allDevices] == 1 );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldLoadJoinedSummary );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
     if( worldLoader->loadJoinedWorlds( joinedWorlds, allDevices, reason ) )
     {
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldLoadJoinedSummary" );
 #endif
-        response[_totalItems] = (int)joinedWorlds.size();
-        response[_success] = 1;
-        m_tupleRouter.route( response );
+        reply.sendSummary( _WorldLoadJoinedSummary, (int)joinedWorlds.size(), true );
 
         Vector< Metadata >::const_iterator it( joinedWorlds.begin() );
         for( ; it != joinedWorlds.end(); ++it )
@@ -216,21 +202,15 @@ void Linda2Responder::_loadJoined( const Tuple& tuple )
 #ifdef LOG_LOADERS
             LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldLoadJoinedResponse" );
 #endif
-            Tuple worldTuple;
-            TupleRouter::setSourceActor( worldTuple, _WorldLoaderResponder );
-            TupleRouter::setSourceID( worldTuple, m_tupleRouter.myID() );
-            TupleRouter::setDestinationID( worldTuple, TupleRouter::sourceID( tuple ) );
-            TupleRouter::setTupleType( worldTuple, _WorldLoadJoinedResponse );
+            Tuple worldTuple( reply.tuple( _WorldLoadJoinedResponse ) );
             it->toValue( worldTuple[_world] );
-            m_tupleRouter.route( worldTuple );
+            reply.send( worldTuple );
         }
     }
     else
     {
         // FIXME: Send failure reason?
-        response[_totalItems] = 0;
-        response[_success] = 0;
-        m_tupleRouter.route( response );
+        reply.sendSummary( _WorldLoadJoinedSummary, 0, false );
     }
 
     delete( worldLoader );
@@ -247,19 +227,13 @@ void Linda2Responder::_loadTeleports( const Tuple& tuple )
     String reason;
     bool allDevices( (int)tuple[_allDevices] == 1 );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldLoadTeleportsSummary );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
     if( worldLoader->loadTeleports( teleports, allDevices, reason ) )
     {
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldLoadTeleportsSummary" );
 #endif
-        response[_totalItems] = (int)teleports.size();
-        response[_success] = 1;
-        m_tupleRouter.route( response );
+        reply.sendSummary( _WorldLoadTeleportsSummary, (int)teleports.size(), true );
 
         Vector< Teleport >::const_iterator it( teleports.begin() );
         for( ; it != teleports.end(); ++it )
@@ -267,21 +241,15 @@ void Linda2Responder::_loadTeleports( const Tuple& tuple )
 #ifdef LOG_LOADERS
             LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldLoadTeleportsResponse" );
 #endif
-            Tuple worldTuple;
-            TupleRouter::setSourceActor( worldTuple, _WorldLoaderResponder );
-            TupleRouter::setSourceID( worldTuple, m_tupleRouter.myID() );
-            TupleRouter::setDestinationID( worldTuple, TupleRouter::sourceID( tuple ) );
-            TupleRouter::setTupleType( worldTuple, _WorldLoadTeleportsResponse );
+            Tuple worldTuple( reply.tuple( _WorldLoadTeleportsResponse ) );
             it->toValue( worldTuple[_teleport] );
-            m_tupleRouter.route( worldTuple );
+            reply.send( worldTuple );
         }
     }
     else
     {
         // FIXME: Send failure reason?
-        response[_totalItems] = 0;
-        response[_success] = 0;
-        m_tupleRouter.route( response );
+        reply.sendSummary( _WorldLoadTeleportsSummary, 0, false );
     }
 
     delete( worldLoader );
@@ -297,11 +265,8 @@ void Linda2Responder::_createTeleport( const Tuple& tuple )
     String reason;
     
     // FIXME: Send reason?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldCreateTeleportResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldCreateTeleportResponse ) );
     if( worldLoader->createTeleport( teleport, reason ) )
     {
         response[_success] = 1;
@@ -314,7 +279,7 @@ void Linda2Responder::_createTeleport( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldCreateTeleportResponse" );
 #endif
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
@@ -329,11 +294,8 @@ void Linda2Responder::_deleteTeleport( const Tuple& tuple )
     String reason;
     
     // FIXME: Send reason?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldDeleteTeleportResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldDeleteTeleportResponse ) );
     if( worldLoader->deleteTeleport( teleport, reason ) )
     {
         response[_success] = 1;
@@ -346,7 +308,7 @@ void Linda2Responder::_deleteTeleport( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldDeleteTeleportResponse" );
 #endif
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
@@ -363,11 +325,8 @@ void Linda2Responder::_loadWorldSummaries( const Tuple& tuple )
     int from( tuple[_from] );
     int size( tuple[_size] );
 
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldLoadWorldSummariesResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldLoadWorldSummariesResponse ) );
     if( worldLoader->loadWorldSummaries( worldSummaries, from, size, reason ) )
     {
         // FIXME: Send success/failure and reason in summary?
@@ -389,7 +348,7 @@ void Linda2Responder::_loadWorldSummaries( const Tuple& tuple )
         response[_success] = 0;
     }
 
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
@@ -404,11 +363,8 @@ void Linda2Responder::_loadUniverseStats( const Tuple& tuple )
     String reason;
     
     // FIXME: Send reason?
-    Tuple response;
-    TupleRouter::setSourceActor( response, _WorldLoaderResponder );
-    TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-    TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-    TupleRouter::setTupleType( response, _WorldLoadUniverseStatsResponse );
+    Reply reply( m_tupleRouter, tuple, _WorldLoaderResponder );
+    Tuple response( reply.tuple( _WorldLoadUniverseStatsResponse ) );
     if( worldLoader->loadUniverseStats( universeStats, reason ) )
     {
         response[_success] = 1;
@@ -422,7 +378,7 @@ void Linda2Responder::_loadUniverseStats( const Tuple& tuple )
 #ifdef LOG_LOADERS
     LOG_DEBUG( "Linda2WorldLoaderResponder: Sending WorldLoadUniverseStatsResponse" );
 #endif
-    m_tupleRouter.route( response );
+    reply.send( response );
 
     delete( worldLoader );
 }
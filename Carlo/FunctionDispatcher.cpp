@@ -63,6 +63,15 @@ bool FunctionDispatcher::getPersistableValue( Value& value,
     return false;
 }
 
+void FunctionDispatcher::flushPersistableValues()
+{
+    Map< String, Actor* >::iterator it( m_actors.begin() );
+    for( ; it != m_actors.end(); ++it )
+    {
+        it->second->flushPersistableValues();
+    }
+}
+
 } // namespace Linda2
 
 } // namespace Agape
@@ -41,6 +41,9 @@ public:
                                       const String& valueName,
                                       const String& caller );
 
+    // Has all actors save changes to persistable values they're holding back.
+    void flushPersistableValues();
+
 private:
     Map< String, Actor* > m_actors;
 
@@ -279,7 +279,7 @@ bool Parser::actor( Actors::Linda2Actor*& _actor, bool firstActor )
     // Tuple handlers (0..N).
     if( m_buildTree )
     {
-        _actor = new Actors::Linda2Actor( name, m_tupleRouter );
+        _actor = new Actors::Linda2Actor( name, m_tupleRouter, m_functionDispatcher );
     }
 
     while( !isNextCode( Lexer::l_none ) )
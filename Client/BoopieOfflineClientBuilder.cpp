@@ -1,5 +1,3 @@
-#include "AssetLoaders/Caches/KiamaFSAssetCache.h"
-#include "AssetLoaders/Factories/CacheAssetLoaderFactory.h"
 #include "AssetLoaders/Factories/KiamaFSAssetLoaderFactory.h"
 #include "AssetLoaders/Factories/MiniMapAssetLoaderFactory.h"
 #include "Audio/MIDIPlayers/SAM2695MIDIPlayer.h"
@@ -67,8 +65,6 @@ void BoopieOffline::_unbuild()
 
 void BoopieOffline::_deleteMembers()
 {
-    delete( m_miniMapAssetCache );
-    delete( m_miniMapAssetLoaderBackingFactory );
     delete( m_midiSerial );
     delete( m_offlinePresenceStore );
     delete( m_sceneLoaderResponder );
@@ -100,8 +96,6 @@ void BoopieOffline::_setMembersNull()
     m_sceneLoaderResponder = nullptr;
     m_offlinePresenceStore = nullptr;
     m_midiSerial = nullptr;
-    m_miniMapAssetLoaderBackingFactory = nullptr;
-    m_miniMapAssetCache = nullptr;
 }
 
 void BoopieOffline::getMachineID()
@@ -269,16 +263,7 @@ void BoopieOffline::buildSplash()
 
 void BoopieOffline::buildMiniMapAssetLoaderFactory()
 {
-    m_miniMapAssetLoaderBackingFactory = new AssetLoaders::Factories::MiniMap( *m_miniMap );
-    m_miniMapAssetCache = new AssetLoaders::Caches::KiamaFSAssetCache( 50,
-                                                                       512,
-                                                                       *m_fs,
-                                                                       "map",
-                                                                       *m_hash,
-                                                                       *m_clock );
-    m_miniMapAssetLoaderFactory = new AssetLoaders::Factories::Cache( *m_miniMapAssetLoaderBackingFactory,
-                                                                      *m_miniMapAssetCache,
-                                                                      false );
+    m_miniMapAssetLoaderFactory = new AssetLoaders::Factories::MiniMap( *m_miniMap );
 }
 
 void BoopieOffline::buildUpdate()
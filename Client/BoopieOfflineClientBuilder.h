@@ -9,7 +9,6 @@ namespace Agape
 
 namespace AssetLoaders
 {
-class AssetCache;
 class Factory;
 } // namespace AssetLoaders
 
@@ -96,9 +95,6 @@ private:
     PresenceLoaders::OfflinePresenceStore* m_offlinePresenceStore;
 
     PICSerial* m_midiSerial;
-
-    AssetLoaders::Factory* m_miniMapAssetLoaderBackingFactory;
-    AssetLoaders::AssetCache* m_miniMapAssetCache;
 };
 
 } // namespace ClientBuilders
@@ -18,7 +18,9 @@
 #include "Platforms/BoopiePlatform.h"
 #include "PresenceLoaders/Factories/EncryptedPresenceLoaderFactory.h"
 #include "PresenceLoaders/Factories/Linda2PresenceLoaderFactory.h"
+#include "SceneLoaders/Factories/CacheSceneLoaderFactory.h"
 #include "SceneLoaders/Factories/EncryptedSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/KiamaFSSceneLoaderFactory.h"
 #include "SceneLoaders/Factories/Linda2SceneLoaderFactory.h"
 #include "TelegramLoaders/Factories/Linda2TelegramLoaderFactory.h"
 #include "Timers/Factories/PIC32PrecisionTimerFactory.h"
@@ -67,10 +69,10 @@ void BoopieOnline::_unbuild()
 
 void BoopieOnline::_deleteMembers()
 {
-    delete( m_miniMapAssetCache );
-    delete( m_miniMapAssetLoaderBackingFactory );
     delete( m_midiSerial );
     delete( m_presenceLoaderBackingFactory );
+    delete( m_sceneLoaderCacheFactory );
+    delete( m_sceneLoaderReplicaFactory );
     delete( m_sceneLoaderBackingFactory );
     delete( m_telegramAssetLoaderBackingFactory );
     delete( m_programAssetCache );
@@ -110,10 +112,10 @@ void BoopieOnline::_setMembersNull()
     m_programAssetCache = nullptr;
     m_telegramAssetLoaderBackingFactory = nullptr;
     m_sceneLoaderBackingFactory = nullptr;
+    m_sceneLoaderReplicaFactory = nullptr;
+    m_sceneLoaderCacheFactory = nullptr;
     m_presenceLoaderBackingFactory = nullptr;
     m_midiSerial = nullptr;
-    m_miniMapAssetLoaderBackingFactory = nullptr;
-    m_miniMapAssetCache = nullptr;
 }
 
 void BoopieOnline::getMachineID()
@@ -283,7 +285,12 @@ void BoopieOnline::buildSceneLoaderFactory()
     m_sceneLoaderBackingFactory = new SceneLoaders::Factories::Linda2( *m_tupleRouter,
                                                                        *m_timerFactory,
                                                                        true ); // true = attributes have encrypted names.
-    m_sceneLoaderFactory = new SceneLoaders::Factories::Encrypted( *m_sceneLoaderBackingFactory,
+    // Scenes are kept on flash as they come from the server, i.e. encrypted.
+    m_sceneLoaderReplicaFactory = new SceneLoaders::Factories::KiamaFS( *m_fs );
+    m_sceneLoaderCacheFactory = new SceneLoaders::Factories::Cache( *m_sceneLoaderBackingFactory,
+                                                                    *m_sceneLoaderReplicaFactory,
+                                                                    *m_timerFactory );
+    m_sceneLoaderFactory = new SceneLoaders::Factories::Encrypted( *m_sceneLoaderCacheFactory,
                                                                    *m_worldMetadata,
                                                                    *m_encryptorFactory,
                                                                    *m_hash );
@@ -300,6 +307,7 @@ void BoopieOnline::buildPresenceLoaderFactory()
 void BoopieOnline::buildTelegramLoaderFactory()
 {
     m_telegramLoaderFactory = new TelegramLoaders::Factories::Linda2( *m_tupleRouter, *m_timerFactory );
+    m_telegramIndexFS = m_fs;
 }
 
 void BoopieOnline::buildMIDIPlayer()
@@ -333,16 +341,7 @@ void BoopieOnline::buildSplash()
 
 void BoopieOnline::buildMiniMapAssetLoaderFactory()
 {
-    m_miniMapAssetLoaderBackingFactory = new AssetLoaders::Factories::MiniMap( *m_miniMap );
-    m_miniMapAssetCache = new AssetLoaders::Caches::KiamaFSAssetCache( 50,
-                                                                       512,
-                                                                       *m_fs,
-                                                                       "map",
-                                                                       *m_hash,
-                                                                       *m_clock );
-    m_miniMapAssetLoaderFactory = new AssetLoaders::Factories::Cache( *m_miniMapAssetLoaderBackingFactory,
-                                                                      *m_miniMapAssetCache,
-                                                                      false );
+    m_miniMapAssetLoaderFactory = new AssetLoaders::Factories::MiniMap( *m_miniMap );
 }
 
 void BoopieOnline::buildUpdate()
@@ -108,13 +108,12 @@ private:
     AssetLoaders::Factory* m_telegramAssetLoaderBackingFactory;
 
     SceneLoaders::Factory* m_sceneLoaderBackingFactory;
+    SceneLoaders::Factory* m_sceneLoaderReplicaFactory;
+    SceneLoaders::Factory* m_sceneLoaderCacheFactory;
 
     PresenceLoaders::Factory* m_presenceLoaderBackingFactory;
 
     PICSerial* m_midiSerial;
-
-    AssetLoaders::Factory* m_miniMapAssetLoaderBackingFactory;
-    AssetLoaders::AssetCache* m_miniMapAssetCache;
 };
 
 } // namespace ClientBuilders
@@ -28,6 +28,11 @@ int PICSerial::open()
     return 0;
 }
 
+bool PICSerial::ready()
+{
+    return !m_picSerial.eof();
+}
+
 int PICSerial::read( char* data, int len )
 {
     return( m_picSerial.read( data, len ) );
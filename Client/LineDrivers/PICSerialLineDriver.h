@@ -16,6 +16,7 @@ public:
     PICSerial( Agape::PICSerial& picSerial );
 
     virtual int open();
+    virtual bool ready();
     virtual int read( char* data, int len );
     virtual int write( const char* data, int len );
     virtual bool error();
@@ -46,6 +46,10 @@ public:
                                       const String& name,
                                       const String& caller ) { return false; };
 
+    // Saves any changes to persistable values that are being held back.
+    // Called when a handler finishes with them.
+    virtual void flushPersistableValues() {};
+
     virtual String actorName() const = 0;
     virtual void rename( const String& name ) {};
 };
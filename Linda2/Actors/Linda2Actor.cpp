@@ -2,6 +2,7 @@
 #include "Utils/LiteStream.h"
 #include "Collections.h"
 #include "ExecutionContext.h"
+#include "FunctionDispatcher.h"
 #include "Linda2Actor.h"
 #include "String.h"
 #include "Tuple.h"
@@ -22,9 +23,10 @@ namespace Linda2
 namespace Actors
 {
 
-Linda2Actor::Linda2Actor( const String& name, TupleRouter& tupleRouter ) :
+Linda2Actor::Linda2Actor( const String& name, TupleRouter& tupleRouter, FunctionDispatcher& functionDispatcher ) :
   m_name( name ),
-  m_tupleRouter( tupleRouter )
+  m_tupleRouter( tupleRouter ),
+  m_functionDispatcher( functionDispatcher )
 {
 }
 
@@ -113,6 +115,13 @@ bool Linda2Actor::accept( Tuple& tuple )
         }
     }
 
+    // Save whatever the handler did to persistable values in one go, rather
+    // than as each was changed.
+    if( handled )
+    {
+        m_functionDispatcher.flushPersistableValues();
+    }
+
     return handled;
 }
 
@@ -13,6 +13,7 @@ namespace Agape
 
 namespace Carlo
 {
+class FunctionDispatcher;
 class Parser;
 class ProgramManager;
 } // namespace Carlo
@@ -37,7 +38,7 @@ class Linda2Actor : public Actor
     friend ProgramManager;
 
 public:
-    Linda2Actor( const String& name, TupleRouter& tupleRouter );
+    Linda2Actor( const String& name, TupleRouter& tupleRouter, FunctionDispatcher& functionDispatcher );
     virtual ~Linda2Actor();
 
     void doRegister();
@@ -66,6 +67,7 @@ public:
 private:
     String m_name;
     TupleRouter& m_tupleRouter;
+    FunctionDispatcher& m_functionDispatcher;
 
     Vector< TupleHandler* > m_tupleHandlers;
 };
@@ -5,10 +5,37 @@
 #include "TupleRouter.h"
 #include "Value.h"
 
+#if defined( QT_CORE_LIB ) || defined( HYDRA )
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#define PROMISE_THREADS
+#endif
+
 namespace
 {
     long pollIntervalms( 10 );
     long timeoutms( 10000 );
+
+#ifdef PROMISE_THREADS
+    // Each promise hashes by address to one of a fixed set of stripes, so
+    // Promise stays cheap to copy, and setting one only locks and wakes the
+    // few promises that share its stripe.
+    struct Stripe
+    {
+        std::mutex m_mutex;
+        std::condition_variable m_resolved;
+    };
+
+    const int _numStripes( 64 );
+    Stripe _stripes[_numStripes];
+
+    Stripe& stripe( const Agape::Linda2::Promise* promise )
+    {
+        return _stripes[( reinterpret_cast< std::uintptr_t >( promise ) / sizeof( *promise ) ) % _numStripes];
+    }
+#endif
 } // Anonymous namespace
 
 namespace Agape
@@ -33,7 +60,12 @@ bool Promise::Future::get( Value& value )
 
             if( !m_promise.m_set )
             {
+#ifdef PROMISE_THREADS
+                // Wakes early if another thread sets the promise.
+                m_promise.waitFor( pollIntervalms );
+#else
                 timer->usleep( pollIntervalms * 1000 );
+#endif
             }
         }
 
@@ -45,6 +77,8 @@ bool Promise::Future::get( Value& value )
         delete( timer );
     }
 
+    finish();
+
     value = m_promise.m_value;
 
     return m_promise.m_success;
@@ -56,11 +90,49 @@ bool Promise::Future::get()
     return( get( value ) );
 }
 
+bool Promise::Future::wait( Value& value, long timeoutms )
+{
+#ifdef PROMISE_THREADS
+    if( !m_promise.waitFor( timeoutms ) )
+    {
+        LOG_DEBUG( "Future timed out" );
+    }
+
+    finish();
+
+    std::lock_guard< std::mutex > lock( stripe( &m_promise ).m_mutex );
+    value = m_promise.m_value;
+
+    return m_promise.m_success;
+#else
+    return get( value );
+#endif
+}
+
+bool Promise::Future::ready() const
+{
+    return m_promise.isSet();
+}
+
+void Promise::Future::then( Continuation* continuation )
+{
+    m_promise.then( continuation );
+}
+
+void Promise::Future::finish()
+{
+    if( m_promise.m_tupleRouter && !m_promise.m_requestID.empty() )
+    {
+        m_promise.m_tupleRouter->forget( m_promise );
+    }
+}
+
 Promise::Promise() :
   m_tupleRouter( nullptr ),
   m_timerFactory( nullptr ),
   m_set( false ),
-  m_success( false )
+  m_success( false ),
+  m_continuation( nullptr )
 {
 }
 
@@ -68,8 +140,49 @@ Promise::Promise( TupleRouter* tupleRouter, Timers::Factory* timerFactory ) :
   m_tupleRouter( tupleRouter ),
   m_timerFactory( timerFactory ),
   m_set( false ),
-  m_success( false )
+  m_success( false ),
+  m_continuation( nullptr )
+{
+}
+
+Promise::Promise( const Promise& other ) :
+  m_tupleRouter( other.m_tupleRouter ),
+  m_timerFactory( other.m_timerFactory ),
+  m_set( other.m_set ),
+  m_success( other.m_success ),
+  m_value( other.m_value ),
+  m_continuation( other.m_continuation )
 {
+    // The request registration stays with the original.
+}
+
+Promise::~Promise()
+{
+    if( m_tupleRouter && !m_requestID.empty() )
+    {
+        m_tupleRouter->forget( *this );
+    }
+}
+
+Promise& Promise::operator=( const Promise& other )
+{
+    if( this != &other )
+    {
+        // Reusing a promise for a new request; stop expecting the old reply.
+        if( m_tupleRouter && !m_requestID.empty() )
+        {
+            m_tupleRouter->forget( *this );
+        }
+
+        m_tupleRouter = other.m_tupleRouter;
+        m_timerFactory = other.m_timerFactory;
+        m_set = other.m_set;
+        m_success = other.m_success;
+        m_value = other.m_value;
+        m_continuation = other.m_continuation;
+    }
+
+    return *this;
 }
 
 Promise::Future Promise::getFuture()
@@ -79,21 +192,109 @@ Promise::Future Promise::getFuture()
 
 bool Promise::set( const Value& successValue, const Value& returnValue )
 {
-    m_value = returnValue;
-    m_set = true;
-    return( m_success = ( (int)successValue == 1 ) );
+    bool success( (int)successValue == 1 );
+    {
+#ifdef PROMISE_THREADS
+        std::lock_guard< std::mutex > lock( stripe( this ).m_mutex );
+#endif
+        m_value = returnValue;
+        m_success = success;
+    }
+    resolve();
+    return success;
 }
 
 bool Promise::set( const Value& successValue )
 {
-    m_set = true;
-    return( m_success = ( (int)successValue == 1 ) );
+    bool success( (int)successValue == 1 );
+    {
+#ifdef PROMISE_THREADS
+        std::lock_guard< std::mutex > lock( stripe( this ).m_mutex );
+#endif
+        m_success = success;
+    }
+    resolve();
+    return success;
 }
 
 void Promise::set()
 {
-    m_set = true;
-    m_success = true;
+    {
+#ifdef PROMISE_THREADS
+        std::lock_guard< std::mutex > lock( stripe( this ).m_mutex );
+#endif
+        m_success = true;
+    }
+    resolve();
+}
+
+bool Promise::isSet() const
+{
+    return m_set;
+}
+
+void Promise::then( Continuation* continuation )
+{
+    {
+#ifdef PROMISE_THREADS
+        std::lock_guard< std::mutex > lock( stripe( this ).m_mutex );
+#endif
+        if( !m_set )
+        {
+            m_continuation = continuation;
+            return;
+        }
+    }
+
+    continuation->resolved( m_success, m_value );
+}
+
+const String& Promise::requestID() const
+{
+    return m_requestID;
+}
+
+void Promise::setRequestID( const String& requestID )
+{
+    m_requestID = requestID;
+}
+
+void Promise::resolve()
+{
+    Continuation* continuation( nullptr );
+    {
+#ifdef PROMISE_THREADS
+        std::lock_guard< std::mutex > lock( stripe( this ).m_mutex );
+#endif
+        // Each response may set the promise again; only the first call
+        // continues.
+        if( !m_set )
+        {
+            continuation = m_continuation;
+            m_continuation = nullptr;
+        }
+        m_set = true;
+    }
+
+#ifdef PROMISE_THREADS
+    stripe( this ).m_resolved.notify_all();
+#endif
+
+    if( continuation )
+    {
+        continuation->resolved( m_success, m_value );
+    }
+}
+
+bool Promise::waitFor( long ms )
+{
+#ifdef PROMISE_THREADS
+    Stripe& waitStripe( stripe( this ) );
+    std::unique_lock< std::mutex > lock( waitStripe.m_mutex );
+    return waitStripe.m_resolved.wait_for( lock, std::chrono::milliseconds( ms ), [this]{ return m_set; } );
+#else
+    return m_set;
+#endif
 }
 
 } // namespace Linda2
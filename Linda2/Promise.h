@@ -1,6 +1,7 @@
 #ifndef AGAPE_LINDA2_PROMISE_H
 #define AGAPE_LINDA2_PROMISE_H
 
+#include "String.h"
 #include "Value.h"
 
 namespace Agape
@@ -24,38 +25,79 @@ class TupleRouter;
 /// is received, the caller's accept() handler (inherited from Actor) will
 /// set the promise, allowing the future to return a success indication and,
 /// optionally, an arbitrary value.
+///
+/// If the request is passed to TupleRouter::expect() before routing, the
+/// response is delivered straight to the waiting actor rather than offered to
+/// every registered actor in turn. Callers that would rather not block can
+/// attach a Continuation, which is called as soon as the promise is set.
 class Promise
 {
 public:
+    /// Called once, from whichever thread sets the promise.
+    class Continuation
+    {
+    public:
+        virtual ~Continuation() {}
+
+        virtual void resolved( bool success, const Value& value ) = 0;
+    };
+
     class Future
     {
     public:
         Future( Promise& promise );
 
+        // Runs the router until the promise is set or times out.
         bool get( Value& value );
         bool get();
-    
+
+        // Waits for another thread to set the promise, without running the
+        // router. Falls back to get() in single-threaded builds.
+        bool wait( Value& value, long timeoutms );
+
+        bool ready() const;
+        void then( Continuation* continuation );
+
     private:
+        void finish();
+
         Promise& m_promise;
     };
 
     Promise();
     Promise( TupleRouter* tupleRouter,
              Timers::Factory* timerFactory );
-    
+    Promise( const Promise& other );
+    ~Promise();
+
+    Promise& operator=( const Promise& other );
+
     Future getFuture();
 
     bool set( const Value& successValue, const Value& returnValue );
     bool set( const Value& successValue );
     void set();
 
+    bool isSet() const;
+    void then( Continuation* continuation );
+
+    // Maintained by TupleRouter::expect() and TupleRouter::forget().
+    const String& requestID() const;
+    void setRequestID( const String& requestID );
+
 private:
+    void resolve();
+    bool waitFor( long ms );
+
     TupleRouter* m_tupleRouter;
     Timers::Factory* m_timerFactory;
 
-    bool m_set;
+    volatile bool m_set;
     bool m_success;
     Value m_value;
+
+    Continuation* m_continuation;
+    String m_requestID;
 };
 
 } // namespace Linda2
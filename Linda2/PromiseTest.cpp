@@ -0,0 +1,306 @@
+#ifdef PROMISE_TEST
+
+#include "Actors/Actor.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "Promise.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace Agape;
+using Agape::Linda2::Promise;
+using Agape::Linda2::Tuple;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const int _numWaiters[] = { 100, 1000, 5000 };
+
+    class Counter : public Promise::Continuation
+    {
+    public:
+        Counter() : m_count( 0 ) {}
+        virtual void resolved( bool success, const Value& value ) { if( success ) ++m_count; }
+
+        int m_count;
+    };
+
+    // Stands in for a loader: sends one request and accepts the reply that
+    // matches its key, as the loaders' accept() handlers do.
+    class Waiter : public Linda2::Actor
+    {
+    public:
+        Waiter( TupleRouter& tupleRouter, Timers::Factory& timerFactory, int key ) :
+          m_tupleRouter( tupleRouter ),
+          m_timerFactory( timerFactory ),
+          m_key( key ),
+          m_accepted( 0 )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        virtual ~Waiter()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        void request( Counter& counter, bool expect )
+        {
+            Tuple tuple;
+            TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
+            TupleRouter::setTupleType( tuple, _AssetReadRequest );
+            tuple[_offset] = m_key;
+
+            m_promise = Promise( &m_tupleRouter, &m_timerFactory );
+            m_promise.then( &counter );
+            if( expect )
+            {
+                m_tupleRouter.expect( tuple, m_promise, this );
+            }
+            m_tupleRouter.route( tuple );
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            if( ( TupleRouter::tupleType( tuple ) == _AssetReadResponse ) &&
+                ( (int)tuple[_offset] == m_key ) )
+            {
+                ++m_accepted;
+                m_promise.set( tuple[_success] );
+                return true;
+            }
+
+            return false;
+        }
+
+        virtual bool perform( Value& returnValue, const String& name, Map< String, Value* > arguments, const String& caller ) { return false; }
+        virtual String actorName() const { return "Waiter"; }
+        virtual void str( LiteStream& stream, int indent ) {}
+
+        Promise m_promise;
+
+        TupleRouter& m_tupleRouter;
+        Timers::Factory& m_timerFactory;
+        int m_key;
+        int m_accepted;
+    };
+
+    // Replies to requests, either while handling them or later, as Stratus
+    // does when a request waits on storage.
+    class Responder : public Linda2::Actor
+    {
+    public:
+        Responder( TupleRouter& tupleRouter, bool deferred ) :
+          m_tupleRouter( tupleRouter ),
+          m_deferred( deferred )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        virtual ~Responder()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            if( TupleRouter::tupleType( tuple ) != _AssetReadRequest )
+            {
+                return false;
+            }
+
+            if( m_deferred )
+            {
+                m_pending.push_back( tuple );
+            }
+            else
+            {
+                reply( tuple );
+            }
+
+            return true;
+        }
+
+        void replyAll()
+        {
+            for( Vector< Tuple >::iterator it( m_pending.begin() ); it != m_pending.end(); ++it )
+            {
+                reply( *it );
+            }
+            m_pending.clear();
+        }
+
+        virtual bool perform( Value& returnValue, const String& name, Map< String, Value* > arguments, const String& caller ) { return false; }
+        virtual String actorName() const { return "Responder"; }
+        virtual void str( LiteStream& stream, int indent ) {}
+
+    private:
+        void reply( const Tuple& request )
+        {
+            Tuple response;
+            TupleRouter::setDestinationID( response, TupleRouter::sourceID( request ) );
+            TupleRouter::setTupleType( response, _AssetReadResponse );
+            response[_offset] = request[_offset];
+            response[_success] = 1;
+            if( request.hasValue( _requestID ) )
+            {
+                response[_requestID] = request[_requestID];
+            }
+            m_tupleRouter.route( response );
+        }
+
+        TupleRouter& m_tupleRouter;
+        bool m_deferred;
+        Vector< Tuple > m_pending;
+    };
+
+    // Many requests outstanding at once, all answered together.
+    bool benchmark( int numWaiters, bool expect )
+    {
+        Timers::Factories::HighRes timerFactory;
+        Linda2::TupleDispatcher tupleDispatcher;
+        TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+        tupleRouter.setMyID( "Client" );
+
+        Vector< Waiter* > waiters;
+        for( int i( 0 ); i < numWaiters; ++i )
+        {
+            waiters.push_back( new Waiter( tupleRouter, timerFactory, i ) );
+        }
+        Responder responder( tupleRouter, true );
+
+        Counter counter;
+        for( Vector< Waiter* >::iterator it( waiters.begin() ); it != waiters.end(); ++it )
+        {
+            ( *it )->request( counter, expect );
+        }
+
+        auto start( std::chrono::steady_clock::now() );
+        responder.replyAll();
+        auto end( std::chrono::steady_clock::now() );
+
+        for( Vector< Waiter* >::iterator it( waiters.begin() ); it != waiters.end(); ++it )
+        {
+            delete( *it );
+        }
+
+        long us( std::chrono::duration_cast< std::chrono::microseconds >( end - start ).count() );
+        std::cout << numWaiters << " outstanding, "
+                  << ( expect ? "registry" : "scan" ) << ": "
+                  << counter.m_count << " resolved in " << us << "us" << std::endl;
+
+        return( counter.m_count == numWaiters );
+    }
+
+    // A reply carrying the request's ID goes only to the actor that
+    // expected it.
+    bool echo()
+    {
+        Timers::Factories::HighRes timerFactory;
+        Linda2::TupleDispatcher tupleDispatcher;
+        TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+        tupleRouter.setMyID( "Client" );
+
+        Waiter expecting( tupleRouter, timerFactory, 1 );
+        Waiter bystander( tupleRouter, timerFactory, 1 );
+        Responder responder( tupleRouter, false );
+
+        Counter counter;
+        expecting.request( counter, true );
+        bool success( expecting.m_promise.getFuture().get() );
+
+        return( success &&
+                ( expecting.m_accepted == 1 ) &&
+                ( bystander.m_accepted == 0 ) &&
+                expecting.m_promise.requestID().empty() );
+    }
+
+    // A waiter on one thread wakes as soon as another sets the promise.
+    bool wake()
+    {
+        Promise promise;
+        auto start( std::chrono::steady_clock::now() );
+        std::thread setter( [&promise]()
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+            promise.set( 1, 42 );
+        } );
+
+        Value value;
+        bool success( promise.getFuture().wait( value, 5000 ) );
+        auto end( std::chrono::steady_clock::now() );
+        setter.join();
+
+        long ms( std::chrono::duration_cast< std::chrono::milliseconds >( end - start ).count() );
+        std::cout << "Woken after " << ms << "ms" << std::endl;
+
+        return( success && ( (int)value == 42 ) && ( ms < 1000 ) );
+    }
+
+    // Many waiters on their own threads each wake to their own promise's
+    // value, whichever stripe it shares.
+    bool wakeEach()
+    {
+        const int numPromises( 256 );
+        Vector< Promise > promises( numPromises );
+        Vector< int > values( numPromises, 0 );
+        Vector< std::thread* > waiters;
+        for( int i( 0 ); i < numPromises; ++i )
+        {
+            waiters.push_back( new std::thread( [&promises, &values, i]()
+            {
+                Value value;
+                if( promises[i].getFuture().wait( value, 5000 ) )
+                {
+                    values[i] = value;
+                }
+            } ) );
+        }
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        for( int i( 0 ); i < numPromises; ++i )
+        {
+            promises[i].set( 1, i + 1 );
+        }
+
+        bool success( true );
+        for( int i( 0 ); i < numPromises; ++i )
+        {
+            waiters[i]->join();
+            delete( waiters[i] );
+            success = success && ( values[i] == i + 1 );
+        }
+
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    for( unsigned int i( 0 ); i < sizeof( _numWaiters ) / sizeof( _numWaiters[0] ); ++i )
+    {
+        success = benchmark( _numWaiters[i], false ) && success;
+        success = benchmark( _numWaiters[i], true ) && success;
+    }
+
+    bool echoed( echo() );
+    std::cout << "Echo: " << ( echoed ? "OK" : "FAILED" ) << std::endl;
+
+    bool woken( wake() );
+    std::cout << "Wake: " << ( woken ? "OK" : "FAILED" ) << std::endl;
+
+    bool eachWoken( wakeEach() );
+    std::cout << "Wake each: " << ( eachWoken ? "OK" : "FAILED" ) << std::endl;
+
+    return( ( success && echoed && woken && eachWoken ) ? 0 : 1 );
+}
+
+#endif // PROMISE_TEST
@@ -0,0 +1,56 @@
+#include "Reply.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleRouter.h"
+
+namespace Agape
+{
+
+namespace Linda2
+{
+
+Reply::Reply( TupleRouter& tupleRouter,
+              const Tuple& request,
+              const String& sourceActor ) :
+  m_tupleRouter( &tupleRouter ),
+  m_sourceActor( sourceActor ),
+  m_destinationID( TupleRouter::sourceID( request ) )
+{
+    // Requests that weren't expected carry none.
+    if( request.hasValue( _requestID ) )
+    {
+        m_requestID = (const String&)request[_requestID];
+    }
+}
+
+Tuple Reply::tuple( const String& type ) const
+{
+    Tuple tuple;
+    TupleRouter::setSourceActor( tuple, m_sourceActor );
+    TupleRouter::setSourceID( tuple, m_tupleRouter->myID() );
+    TupleRouter::setDestinationID( tuple, m_destinationID );
+    TupleRouter::setTupleType( tuple, type );
+    if( !m_requestID.empty() )
+    {
+        tuple[_requestID] = m_requestID;
+    }
+    return tuple;
+}
+
+bool Reply::send( Tuple& tuple )
+{
+    return m_tupleRouter->route( tuple );
+}
+
+bool Reply::sendSummary( const String& type, int totalItems, bool success )
+{
+    Tuple summary( tuple( type ) );
+    summary[_totalItems] = totalItems;
+    summary[_success] = success ? 1 : 0;
+    return send( summary );
+}
+
+} // namespace Linda2
+
+} // namespace Agape
@@ -0,0 +1,44 @@
+#ifndef AGAPE_LINDA2_REPLY_H
+#define AGAPE_LINDA2_REPLY_H
+
+#include "String.h"
+
+namespace Agape
+{
+
+namespace Linda2
+{
+
+class Tuple;
+class TupleRouter;
+
+/// @brief The responder's side of a Requester. Taken from a request, it
+/// addresses tuples back to the requester with the request's ID, so that
+/// replies, streamed items and summaries find their request whether they're
+/// sent while the request is being handled or later, and in any order.
+class Reply
+{
+public:
+    Reply( TupleRouter& tupleRouter,
+           const Tuple& request,
+           const String& sourceActor );
+
+    // A tuple of the given type, for the caller to fill in and send().
+    Tuple tuple( const String& type ) const;
+    bool send( Tuple& tuple );
+
+    // Ends a streamed reply, whether sent before or after its items.
+    bool sendSummary( const String& type, int totalItems, bool success );
+
+private:
+    TupleRouter* m_tupleRouter;
+    String m_sourceActor;
+    String m_destinationID;
+    String m_requestID;
+};
+
+} // namespace Linda2
+
+} // namespace Agape
+
+#endif // AGAPE_LINDA2_REPLY_H
@@ -0,0 +1,333 @@
+#include "Actors/Actor.h"
+#include "Loggers/Logger.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Collections.h"
+#include "Promise.h"
+#include "Requester.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleRouter.h"
+
+namespace
+{
+    const long _pollInterval( 10 ); // ms
+    const long _timeout( 10000 ); // ms, as for a Promise.
+
+    // Summaries from older responders don't say.
+    bool succeeded( const Agape::Linda2::Tuple& reply )
+    {
+        return( !reply.hasValue( Agape::_success ) || ( (int)reply[Agape::_success] == 1 ) );
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Linda2
+{
+
+struct Requester::Pending
+{
+    Pending( TupleRouter& tupleRouter, Timers::Factory& timerFactory ) :
+      m_handle( 0 ),
+      m_attempts( 0 ),
+      m_attemptms( 0 ),
+      m_timer( timerFactory.makeTimer() ),
+      m_promise( &tupleRouter, &timerFactory ),
+      m_totalItems( -1 )
+    {
+    }
+
+    ~Pending()
+    {
+        delete( m_timer );
+    }
+
+    int m_handle;
+    Tuple m_request;
+    String m_responseType;
+    String m_summaryType;
+
+    int m_attempts; // Left.
+    long m_attemptms;
+    Timer* m_timer; // Since the last attempt.
+
+    Promise m_promise; // Holds the latest request ID for the router.
+    Vector< String > m_requestIDs; // Every attempt's, any of which may answer.
+    String m_answeringID; // The attempt whose reply is being taken.
+    Tuple m_reply;
+    Vector< Tuple > m_items;
+    int m_totalItems; // -1 until the summary arrives.
+};
+
+Requester::Requester( TupleRouter& tupleRouter,
+                      Timers::Factory& timerFactory,
+                      Actor* actor ) :
+  m_tupleRouter( tupleRouter ),
+  m_timerFactory( timerFactory ),
+  m_actor( actor ),
+  m_timeoutms( _timeout ),
+  m_lastHandle( 0 )
+{
+}
+
+Requester::~Requester()
+{
+    cancel();
+}
+
+void Requester::setTimeout( long timeoutms )
+{
+    m_timeoutms = timeoutms;
+}
+
+int Requester::send( Tuple& request,
+                     const String& responseType,
+                     const String& summaryType,
+                     int retries )
+{
+    TupleRouter::setSourceID( request, m_tupleRouter.myID() );
+
+    if( ++m_lastHandle <= 0 )
+    {
+        m_lastHandle = 1;
+    }
+
+    Pending* pending( new Pending( m_tupleRouter, m_timerFactory ) );
+    pending->m_handle = m_lastHandle;
+    pending->m_request = request;
+    pending->m_responseType = responseType;
+    pending->m_summaryType = summaryType;
+    pending->m_attempts = retries + 1;
+    pending->m_attemptms = m_timeoutms / ( retries + 1 );
+    m_pending[pending->m_handle] = pending;
+
+    if( !route( *pending ) )
+    {
+        erase( pending->m_handle );
+        return 0;
+    }
+
+    return m_lastHandle;
+}
+
+bool Requester::ready( int handle )
+{
+    Map< int, Pending* >::const_iterator it( m_pending.find( handle ) );
+    if( it == m_pending.end() )
+    {
+        return true;
+    }
+
+    return poll( *( it->second ) );
+}
+
+bool Requester::get( int handle, Tuple& reply, Vector< Tuple >& items )
+{
+    Map< int, Pending* >::const_iterator it( m_pending.find( handle ) );
+    if( it == m_pending.end() )
+    {
+        return false;
+    }
+
+    Pending& pending( *( it->second ) );
+    while( !poll( pending ) )
+    {
+        m_tupleRouter.run(); // May call accept(), through our actor.
+
+        if( !pending.m_promise.isSet() )
+        {
+            pending.m_timer->usleep( _pollInterval * 1000 );
+        }
+    }
+
+    bool success( pending.m_promise.getFuture().get() ); // Already set.
+    reply = pending.m_reply;
+    items.swap( pending.m_items );
+    erase( handle );
+
+    return success;
+}
+
+bool Requester::get( int handle, Tuple& reply )
+{
+    Vector< Tuple > items;
+    return get( handle, reply, items );
+}
+
+bool Requester::get( int handle )
+{
+    Tuple reply;
+    return get( handle, reply );
+}
+
+void Requester::cancel( int handle )
+{
+    erase( handle );
+}
+
+void Requester::cancel()
+{
+    while( !m_pending.empty() )
+    {
+        erase( m_pending.begin()->first );
+    }
+}
+
+bool Requester::call( Tuple& request,
+                      const String& responseType,
+                      Tuple& reply,
+                      int retries )
+{
+    return get( send( request, responseType, String(), retries ), reply );
+}
+
+bool Requester::call( Tuple& request,
+                      const String& responseType,
+                      const String& summaryType,
+                      Tuple& summary,
+                      Vector< Tuple >& items,
+                      int retries )
+{
+    return get( send( request, responseType, summaryType, retries ), summary, items );
+}
+
+int Requester::outstanding() const
+{
+    return m_pending.size();
+}
+
+bool Requester::accept( Tuple& tuple )
+{
+    if( !tuple.hasValue( _requestID ) ||
+        ( TupleRouter::destinationID( tuple ) != m_tupleRouter.myID() ) )
+    {
+        return false;
+    }
+
+    Map< String, int >::const_iterator handleIt( m_handles.find( (const String&)tuple[_requestID] ) );
+    if( handleIt == m_handles.end() )
+    {
+        return false;
+    }
+
+    // The first attempt to answer is the one taken, so that items from
+    // different attempts aren't mixed.
+    Pending& pending( *m_pending[handleIt->second] );
+    const String& requestID( (const String&)tuple[_requestID] );
+    if( pending.m_answeringID.empty() )
+    {
+        pending.m_answeringID = requestID;
+    }
+    else if( pending.m_answeringID != requestID )
+    {
+        return true;
+    }
+
+    const String& type( TupleRouter::tupleType( tuple ) );
+    if( ( type == pending.m_responseType ) && pending.m_summaryType.empty() )
+    {
+        pending.m_reply = tuple;
+        complete( pending, succeeded( tuple ) );
+        return true;
+    }
+    else if( type == pending.m_responseType )
+    {
+        pending.m_items.push_back( tuple );
+    }
+    else if( !pending.m_summaryType.empty() && ( type == pending.m_summaryType ) )
+    {
+        pending.m_reply = tuple;
+        pending.m_totalItems = tuple[_totalItems];
+    }
+    else
+    {
+        return false;
+    }
+
+    // The summary may come before or after the items.
+    if( ( pending.m_totalItems >= 0 ) && ( (int)pending.m_items.size() >= pending.m_totalItems ) )
+    {
+        complete( pending, succeeded( pending.m_reply ) );
+    }
+
+    return true;
+}
+
+bool Requester::route( Pending& pending )
+{
+    // A new request ID for each attempt. Earlier attempts may still answer,
+    // through the usual dispatch once the router has forgotten them, as a
+    // slow reply is as good as the retry's.
+    m_tupleRouter.expect( pending.m_request, pending.m_promise, m_actor );
+    pending.m_requestIDs.push_back( pending.m_promise.requestID() );
+    m_handles[pending.m_promise.requestID()] = pending.m_handle;
+
+    pending.m_timer->reset();
+    --pending.m_attempts;
+
+    // The reply may arrive while routing.
+    Tuple request( pending.m_request );
+    return m_tupleRouter.route( request );
+}
+
+bool Requester::poll( Pending& pending )
+{
+    if( pending.m_promise.isSet() )
+    {
+        return true;
+    }
+
+    if( pending.m_timer->ms() < pending.m_attemptms )
+    {
+        return false;
+    }
+
+    if( pending.m_attempts > 0 )
+    {
+        LOG_DEBUG( "Requester: Retrying for " + pending.m_responseType );
+        if( route( pending ) )
+        {
+            return pending.m_promise.isSet();
+        }
+    }
+
+    LOG_DEBUG( "Requester: Timed out waiting for " + pending.m_responseType );
+    complete( pending, false );
+    return true;
+}
+
+void Requester::complete( Pending& pending, bool success )
+{
+    // Anything else sent in reply, to any attempt, is ignored.
+    forget( pending );
+    m_tupleRouter.forget( pending.m_promise );
+    pending.m_promise.set( success ? 1 : 0 );
+}
+
+void Requester::forget( Pending& pending )
+{
+    Vector< String >::const_iterator it( pending.m_requestIDs.begin() );
+    for( ; it != pending.m_requestIDs.end(); ++it )
+    {
+        m_handles.erase( *it );
+    }
+    pending.m_requestIDs.clear();
+}
+
+void Requester::erase( int handle )
+{
+    Map< int, Pending* >::iterator it( m_pending.find( handle ) );
+    if( it != m_pending.end() )
+    {
+        forget( *( it->second ) );
+        delete( it->second ); // Its promise forgets the request ID.
+        m_pending.erase( it );
+    }
+}
+
+} // namespace Linda2
+
+} // namespace Agape
@@ -0,0 +1,113 @@
+#ifndef AGAPE_LINDA2_REQUESTER_H
+#define AGAPE_LINDA2_REQUESTER_H
+
+#include "Collections.h"
+#include "String.h"
+
+namespace Agape
+{
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+namespace Linda2
+{
+
+class Actor;
+class Tuple;
+class TupleRouter;
+
+/// @brief Sends requests on behalf of an actor and collects their replies,
+/// matched up by the request ID that TupleRouter::expect() stamps on each
+/// request, so that any number can be outstanding at once and their replies
+/// can arrive in any order.
+///
+/// A reply is either one tuple of the response type or, if a summary type is
+/// given, any number of response "items" plus one summary tuple carrying
+/// _totalItems and _success, sent before or after them. A request that isn't
+/// answered in time is sent again under a new request ID, as many times as
+/// it's allowed retries, and otherwise fails. Earlier attempts may still
+/// answer, and the first of them to do so is taken. Other attempts' replies,
+/// and replies to requests that have failed or were cancelled, are ignored.
+///
+/// The owning actor passes the tuples it's offered to accept(). Responders
+/// answer through a Linda2::Reply, so that replies carry the request ID back
+/// however late they're sent.
+class Requester
+{
+public:
+    Requester( TupleRouter& tupleRouter,
+               Timers::Factory& timerFactory,
+               Actor* actor );
+    ~Requester();
+
+    // Shared between a request's attempts, so that retries don't wait any
+    // longer in all.
+    void setTimeout( long timeoutms );
+
+    // Stamps the request with our ID and routes it without waiting. Returns
+    // a handle for the reply, or 0 if the request couldn't be routed.
+    int send( Tuple& request,
+              const String& responseType,
+              const String& summaryType = String(),
+              int retries = 0 );
+
+    // True once the request has been answered, or has failed. Doesn't run
+    // the router, so doesn't block.
+    bool ready( int handle );
+
+    // Runs the router until the request has been answered or has failed, and
+    // hands over the reply (the summary, if streamed) and any items. The
+    // handle is done with either way.
+    bool get( int handle, Tuple& reply, Vector< Tuple >& items );
+    bool get( int handle, Tuple& reply );
+    bool get( int handle );
+
+    // Any reply that arrives later is ignored.
+    void cancel( int handle );
+    void cancel();
+
+    // send() and get() together.
+    bool call( Tuple& request,
+               const String& responseType,
+               Tuple& reply,
+               int retries = 0 );
+    bool call( Tuple& request,
+               const String& responseType,
+               const String& summaryType,
+               Tuple& summary,
+               Vector< Tuple >& items,
+               int retries = 0 );
+
+    int outstanding() const;
+
+    // True if the tuple answers one of our outstanding requests.
+    bool accept( Tuple& tuple );
+
+private:
+    struct Pending;
+
+    bool route( Pending& pending );
+    bool poll( Pending& pending );
+    void complete( Pending& pending, bool success );
+    void forget( Pending& pending );
+    void erase( int handle );
+
+    TupleRouter& m_tupleRouter;
+    Timers::Factory& m_timerFactory;
+    Actor* m_actor;
+
+    long m_timeoutms;
+    int m_lastHandle;
+
+    Map< int, Pending* > m_pending;
+    Map< String, int > m_handles; // By every attempt's request ID.
+};
+
+} // namespace Linda2
+
+} // namespace Agape
+
+#endif // AGAPE_LINDA2_REQUESTER_H
@@ -0,0 +1,531 @@
+#ifdef REQUESTER_TEST
+
+#include "Actors/Actor.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "TupleRoutes/QueueingTupleRoute.h"
+#include "Collections.h"
+#include "Reply.h"
+#include "Requester.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace Agape;
+using Agape::Linda2::Reply;
+using Agape::Linda2::Requester;
+using Agape::Linda2::Tuple;
+using Agape::Linda2::TupleRouter;
+using Agape::Linda2::TupleRoutes::Queueing;
+
+namespace
+{
+    const int _numConcurrent( 64 );
+    const int _numStreams( 8 );
+    const int _numTimed( 16 );
+    const long _latencyms( 20 );
+
+    long long nowms()
+    {
+        return std::chrono::duration_cast< std::chrono::milliseconds >(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    // How the server answers. Requests are keyed by _offset, and streamed
+    // requests ask for _length items.
+    struct Policy
+    {
+        Policy() :
+          m_batch( 1 ),
+          m_latencyms( 0 ),
+          m_firstDelayms( 0 ),
+          m_drop( false ),
+          m_dropRetries( false )
+        {
+        }
+
+        int m_batch; // Held until this many are in, then answered last first.
+        long m_latencyms;
+        long m_firstDelayms; // Extra, for the first attempt at each key.
+        bool m_drop; // Never answers.
+        bool m_dropRetries; // Answers only the first attempt at each key.
+    };
+
+    // Answers _AssetReadRequests with one _AssetReadResponse, and
+    // _SceneLoadRequests with a stream of _SceneLoadResponses and a
+    // _SceneSummary, through Reply as the loader responders do.
+    class Responder : public Linda2::Actor
+    {
+    public:
+        Responder( TupleRouter& tupleRouter, const Policy& policy ) :
+          m_tupleRouter( tupleRouter ),
+          m_policy( policy )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        virtual ~Responder()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            const String& type( TupleRouter::tupleType( tuple ) );
+            if( ( type != _AssetReadRequest ) && ( type != _SceneLoadRequest ) )
+            {
+                return false;
+            }
+
+            int key( tuple[_offset] );
+            int attempt( ++m_attempts[key] );
+            if( !m_policy.m_drop && !( m_policy.m_dropRetries && ( attempt > 1 ) ) )
+            {
+                long delayms( m_policy.m_latencyms + ( ( attempt == 1 ) ? m_policy.m_firstDelayms : 0 ) );
+                m_pending.push_back( Pending( m_tupleRouter, tuple, attempt, nowms() + delayms ) );
+            }
+
+            return true;
+        }
+
+        void tick()
+        {
+            if( m_policy.m_batch > 1 )
+            {
+                if( (int)m_pending.size() >= m_policy.m_batch )
+                {
+                    answer( Vector< Pending >( m_pending.rbegin(), m_pending.rend() ) );
+                    m_pending.clear();
+                }
+                return;
+            }
+
+            Vector< Pending > due;
+            Vector< Pending >::iterator it( m_pending.begin() );
+            while( it != m_pending.end() )
+            {
+                if( it->m_duems <= nowms() )
+                {
+                    due.push_back( *it );
+                    it = m_pending.erase( it );
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            answer( due );
+        }
+
+        virtual bool perform( Value& returnValue, const String& name, Map< String, Value* > arguments, const String& caller ) { return false; }
+        virtual String actorName() const { return "Responder"; }
+        virtual void str( LiteStream& stream, int indent ) {}
+
+    private:
+        struct Pending
+        {
+            Pending( TupleRouter& tupleRouter, const Tuple& request, int attempt, long long duems ) :
+              m_reply( tupleRouter, request, "Responder" ),
+              m_streamed( TupleRouter::tupleType( request ) == _SceneLoadRequest ),
+              m_key( request[_offset] ),
+              m_items( request[_length] ),
+              m_attempt( attempt ),
+              m_duems( duems )
+            {
+            }
+
+            Reply m_reply;
+            bool m_streamed;
+            int m_key;
+            int m_items;
+            int m_attempt;
+            long long m_duems;
+        };
+
+        // Streams are interleaved, item by item, with even keys' summaries
+        // sent first and odd keys' last.
+        void answer( Vector< Pending > pending )
+        {
+            int maxItems( 0 );
+            for( Vector< Pending >::iterator it( pending.begin() ); it != pending.end(); ++it )
+            {
+                if( !it->m_streamed )
+                {
+                    Tuple response( it->m_reply.tuple( _AssetReadResponse ) );
+                    response[_offset] = it->m_key;
+                    response[_size] = it->m_attempt;
+                    response[_success] = 1;
+                    it->m_reply.send( response );
+                }
+                else if( ( it->m_key % 2 ) == 0 )
+                {
+                    it->m_reply.sendSummary( _SceneSummary, it->m_items, true );
+                }
+                maxItems = std::max( maxItems, it->m_items );
+            }
+
+            for( int i( 0 ); i < maxItems; ++i )
+            {
+                for( Vector< Pending >::iterator it( pending.begin() ); it != pending.end(); ++it )
+                {
+                    if( it->m_streamed && ( i < it->m_items ) )
+                    {
+                        Tuple item( it->m_reply.tuple( _SceneLoadResponse ) );
+                        item[_offset] = it->m_key;
+                        it->m_reply.send( item );
+                    }
+                }
+            }
+
+            for( Vector< Pending >::iterator it( pending.begin() ); it != pending.end(); ++it )
+            {
+                if( it->m_streamed && ( ( it->m_key % 2 ) == 1 ) )
+                {
+                    it->m_reply.sendSummary( _SceneSummary, it->m_items, true );
+                }
+            }
+        }
+
+        TupleRouter& m_tupleRouter;
+        Policy m_policy;
+        Vector< Pending > m_pending;
+        Map< int, int > m_attempts;
+    };
+
+    // Stands in for a loader, counting replies that its requester didn't
+    // take, i.e. those to requests that were retried or cancelled.
+    class Client : public Linda2::Actor
+    {
+    public:
+        Client( TupleRouter& tupleRouter, Timers::Factory& timerFactory ) :
+          m_tupleRouter( tupleRouter ),
+          m_requester( tupleRouter, timerFactory, this ),
+          m_strays( 0 )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        virtual ~Client()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        Tuple request( int key, int items = -1 )
+        {
+            Tuple tuple;
+            TupleRouter::setSourceActor( tuple, "Client" );
+            TupleRouter::setTupleType( tuple, ( items < 0 ) ? _AssetReadRequest : _SceneLoadRequest );
+            tuple[_offset] = key;
+            tuple[_length] = items;
+            return tuple;
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            if( m_requester.accept( tuple ) )
+            {
+                return true;
+            }
+
+            const String& type( TupleRouter::tupleType( tuple ) );
+            if( ( type == _AssetReadResponse ) || ( type == _SceneLoadResponse ) || ( type == _SceneSummary ) )
+            {
+                ++m_strays;
+                return true;
+            }
+
+            return false;
+        }
+
+        virtual bool perform( Value& returnValue, const String& name, Map< String, Value* > arguments, const String& caller ) { return false; }
+        virtual String actorName() const { return "Client"; }
+        virtual void str( LiteStream& stream, int indent ) {}
+
+        TupleRouter& m_tupleRouter;
+        Requester m_requester;
+        int m_strays;
+    };
+
+    // A client and a server router joined by a pair of Queueing routes, with
+    // the server on its own thread, as for a client and Hydra.
+    class Loopback
+    {
+    public:
+        Loopback( const Policy& policy ) :
+          m_clientRouter( m_clientDispatcher, "Client", m_timerFactory ),
+          m_serverRouter( m_serverDispatcher, "Server", m_timerFactory ),
+          m_clientRoute( "Server" ),
+          m_serverRoute( "Client" ),
+          m_client( m_clientRouter, m_timerFactory ),
+          m_responder( m_serverRouter, policy ),
+          m_stop( false )
+        {
+            m_clientRouter.setMyID( "Client" );
+            m_serverRouter.setMyID( "Server" );
+
+            m_clientRoute.setPartner( &m_serverRoute );
+            m_serverRoute.setPartner( &m_clientRoute );
+            m_clientRouter.addRoute( &m_clientRoute );
+            m_serverRouter.addRoute( &m_serverRoute );
+
+            m_server = std::thread( [this]()
+            {
+                while( !m_stop )
+                {
+                    m_serverRoute.waitIncoming( 1 );
+                    m_serverRouter.run();
+                    m_responder.tick();
+                }
+            } );
+        }
+
+        ~Loopback()
+        {
+            m_stop = true;
+            m_server.join();
+            m_clientRouter.removeRoute( &m_clientRoute );
+            m_serverRouter.removeRoute( &m_serverRoute );
+        }
+
+        // Lets anything still in flight arrive.
+        void settle( long ms )
+        {
+            long long endms( nowms() + ms );
+            while( nowms() < endms )
+            {
+                m_clientRoute.waitIncoming( 1 );
+                m_clientRouter.run();
+            }
+        }
+
+        Timers::Factories::HighRes m_timerFactory;
+        Linda2::TupleDispatcher m_clientDispatcher;
+        Linda2::TupleDispatcher m_serverDispatcher;
+        TupleRouter m_clientRouter;
+        TupleRouter m_serverRouter;
+        Queueing m_clientRoute;
+        Queueing m_serverRoute;
+        Client m_client;
+        Responder m_responder;
+
+        std::atomic< bool > m_stop;
+        std::thread m_server;
+    };
+
+    // Many requests in flight at once, answered last first.
+    bool outOfOrder()
+    {
+        Policy policy;
+        policy.m_batch = _numConcurrent;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+
+        Vector< int > handles;
+        for( int key( 0 ); key < _numConcurrent; ++key )
+        {
+            Tuple tuple( client.request( key ) );
+            handles.push_back( client.m_requester.send( tuple, _AssetReadResponse ) );
+        }
+
+        bool success( client.m_requester.outstanding() == _numConcurrent );
+        for( int key( 0 ); key < _numConcurrent; ++key )
+        {
+            Tuple reply;
+            success = client.m_requester.get( handles[key], reply ) && ( (int)reply[_offset] == key ) && success;
+        }
+
+        return( success && ( client.m_requester.outstanding() == 0 ) && ( client.m_strays == 0 ) );
+    }
+
+    // Interleaved streams, with summaries before and after their items.
+    bool streamed()
+    {
+        Policy policy;
+        policy.m_batch = _numStreams;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+
+        Vector< int > handles;
+        for( int key( 0 ); key < _numStreams; ++key )
+        {
+            Tuple tuple( client.request( key, key * 3 ) ); // Including an empty stream.
+            handles.push_back( client.m_requester.send( tuple, _SceneLoadResponse, _SceneSummary ) );
+        }
+
+        bool success( true );
+        for( int key( _numStreams - 1 ); key >= 0; --key )
+        {
+            Tuple summary;
+            Vector< Tuple > items;
+            success = client.m_requester.get( handles[key], summary, items ) && success;
+            success = success && ( (int)summary[_totalItems] == key * 3 ) && ( (int)items.size() == key * 3 );
+            for( Vector< Tuple >::iterator it( items.begin() ); it != items.end(); ++it )
+            {
+                success = success && ( (int)( *it )[_offset] == key );
+            }
+        }
+
+        return( success && ( client.m_strays == 0 ) );
+    }
+
+    // With each reply a round trip away, requests in flight together take
+    // about as long as one.
+    bool concurrent()
+    {
+        Policy policy;
+        policy.m_latencyms = _latencyms;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+
+        bool success( true );
+        long long startms( nowms() );
+        for( int key( 0 ); key < _numTimed; ++key )
+        {
+            Tuple tuple( client.request( key ) );
+            Tuple reply;
+            success = client.m_requester.call( tuple, _AssetReadResponse, reply ) && success;
+        }
+        long long serialms( nowms() - startms );
+
+        startms = nowms();
+        Vector< int > handles;
+        for( int key( 0 ); key < _numTimed; ++key )
+        {
+            Tuple tuple( client.request( key ) );
+            handles.push_back( client.m_requester.send( tuple, _AssetReadResponse ) );
+        }
+        for( int key( 0 ); key < _numTimed; ++key )
+        {
+            Tuple reply;
+            success = client.m_requester.get( handles[key], reply ) && ( (int)reply[_offset] == key ) && success;
+        }
+        long long concurrentms( nowms() - startms );
+
+        std::cout << _numTimed << " requests at " << _latencyms << "ms: "
+                  << serialms << "ms serially, " << concurrentms << "ms concurrently" << std::endl;
+
+        return( success && ( concurrentms * 4 < serialms ) );
+    }
+
+    // A cancelled request's reply is ignored, and the others are unaffected.
+    bool cancel()
+    {
+        Policy policy;
+        policy.m_batch = 2;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+
+        Tuple first( client.request( 1 ) );
+        Tuple second( client.request( 2 ) );
+        int cancelled( client.m_requester.send( first, _AssetReadResponse ) );
+        int kept( client.m_requester.send( second, _AssetReadResponse ) );
+        client.m_requester.cancel( cancelled );
+
+        Tuple reply;
+        bool success( client.m_requester.get( kept, reply ) && ( (int)reply[_offset] == 2 ) );
+        loopback.settle( 50 );
+
+        return( success &&
+                !client.m_requester.get( cancelled ) &&
+                ( client.m_requester.outstanding() == 0 ) &&
+                ( client.m_strays == 1 ) );
+    }
+
+    // An attempt that goes unanswered for too long is retried under a new
+    // request ID, and its late reply is ignored.
+    bool retry()
+    {
+        Policy policy;
+        policy.m_firstDelayms = 300;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+        client.m_requester.setTimeout( 400 ); // 200ms an attempt.
+
+        Tuple tuple( client.request( 1 ) );
+        Tuple reply;
+        bool success( client.m_requester.call( tuple, _AssetReadResponse, reply, 1 ) );
+        loopback.settle( 250 );
+
+        return( success && ( (int)reply[_size] == 2 ) && ( client.m_strays == 1 ) );
+    }
+
+    // A reply to the first attempt that comes after the retry was sent, but
+    // within the request's time, still answers it.
+    bool lateReply()
+    {
+        Policy policy;
+        policy.m_firstDelayms = 300;
+        policy.m_dropRetries = true;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+        client.m_requester.setTimeout( 400 ); // 200ms an attempt.
+
+        Tuple tuple( client.request( 1 ) );
+        Tuple reply;
+        bool success( client.m_requester.call( tuple, _AssetReadResponse, reply, 1 ) );
+
+        return( success && ( (int)reply[_size] == 1 ) && ( client.m_strays == 0 ) );
+    }
+
+    // With no reply at all, a request fails once its time is up.
+    bool timeout()
+    {
+        Policy policy;
+        policy.m_drop = true;
+        Loopback loopback( policy );
+        Client& client( loopback.m_client );
+        client.m_requester.setTimeout( 100 );
+
+        Tuple tuple( client.request( 1 ) );
+        Tuple reply;
+        long long startms( nowms() );
+        bool success( client.m_requester.call( tuple, _AssetReadResponse, reply ) );
+        long long elapsedms( nowms() - startms );
+
+        return( !success && ( elapsedms >= 100 ) && ( elapsedms < 1000 ) );
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    bool ordered( outOfOrder() );
+    std::cout << "Out of order: " << ( ordered ? "OK" : "FAILED" ) << std::endl;
+    success = ordered && success;
+
+    bool streams( streamed() );
+    std::cout << "Streamed: " << ( streams ? "OK" : "FAILED" ) << std::endl;
+    success = streams && success;
+
+    bool overlapped( concurrent() );
+    std::cout << "Concurrent: " << ( overlapped ? "OK" : "FAILED" ) << std::endl;
+    success = overlapped && success;
+
+    bool cancelled( cancel() );
+    std::cout << "Cancel: " << ( cancelled ? "OK" : "FAILED" ) << std::endl;
+    success = cancelled && success;
+
+    bool retried( retry() );
+    std::cout << "Retry: " << ( retried ? "OK" : "FAILED" ) << std::endl;
+    success = retried && success;
+
+    bool late( lateReply() );
+    std::cout << "Late reply: " << ( late ? "OK" : "FAILED" ) << std::endl;
+    success = late && success;
+
+    bool timedOut( timeout() );
+    std::cout << "Timeout: " << ( timedOut ? "OK" : "FAILED" ) << std::endl;
+    success = timedOut && success;
+
+    return( success ? 0 : 1 );
+}
+
+#endif // REQUESTER_TEST
@@ -93,6 +93,23 @@ bool TupleDispatcher::dispatch( Tuple& tuple )
     return handled;
 }
 
+bool TupleDispatcher::dispatchTo( Tuple& tuple, Actor* actor )
+{
+    // Monitor only once handled, as the caller falls back to dispatch()
+    // otherwise.
+    if( !actor->accept( tuple ) )
+    {
+        return false;
+    }
+
+    if( m_monitor )
+    {
+        m_monitor->accept( tuple );
+    }
+
+    return true;
+}
+
 } // namespace Linda2
 
 } // namespace Agape
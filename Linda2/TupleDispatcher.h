@@ -27,6 +27,7 @@ public:
     void deregisterMonitor( Actor* actor );
 
     bool dispatch( Tuple& tuple );
+    bool dispatchTo( Tuple& tuple, Actor* actor );
 
 private:
     List< Actor* > m_actors;
@@ -2,6 +2,7 @@
 #include "Timers/Factories/TimerFactory.h"
 #include "TupleFilters/TupleFilter.h"
 #include "TupleRoutes/TupleRoute.h"
+#include "Promise.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Terminal.h"
@@ -28,7 +29,8 @@ TupleRouter::TupleRouter( TupleDispatcher& tupleDispatcher,
   m_timerFactory( timerFactory ),
   m_defaultRoute( nullptr ),
   m_tupleFilter( nullptr ),
-  m_routeError( false )
+  m_routeError( false ),
+  m_requestCount( 0 )
 {
 }
 
@@ -83,9 +85,8 @@ bool TupleRouter::route( Tuple& tuple )
     }
 
     // Dispatch to any local recipients. Note that the sending
-    // actor may receive its own tuple back. Ignore return value as this just
-    // indicates if any actor handled the tuple, and we don't care.
-    m_tupleDispatcher.dispatch( tuple );
+    // actor may receive its own tuple back.
+    dispatch( tuple );
 
     return success;
 }
@@ -211,7 +212,7 @@ void TupleRouter::run()
                         }
 
                         // Dispatch to any local recipients
-                        m_tupleDispatcher.dispatch( tuple );
+                        dispatch( tuple );
                     }
                 }
             }
@@ -319,6 +320,37 @@ void TupleRouter::sendRemoveRoutingCriteriaRequest( const TupleRoutingCriteria&
     }
 }
 
+void TupleRouter::expect( Tuple& request, Promise& promise, Actor* actor )
+{
+    forget( promise );
+
+    String requestID;
+    {
+        std::lock_guard< std::mutex > lock( m_expectationsMutex );
+
+        LiteStream stream;
+        stream << m_myID << ":" << ++m_requestCount;
+        requestID = stream.str();
+
+        m_expectations[requestID] = actor;
+    }
+
+    request[_requestID] = requestID;
+    promise.setRequestID( requestID );
+}
+
+void TupleRouter::forget( Promise& promise )
+{
+    if( !promise.requestID().empty() )
+    {
+        {
+            std::lock_guard< std::mutex > lock( m_expectationsMutex );
+            m_expectations.erase( promise.requestID() );
+        }
+        promise.setRequestID( String() );
+    }
+}
+
 void TupleRouter::setTupleFilter( TupleFilter* tupleFilter )
 {
     m_tupleFilter = tupleFilter;
@@ -392,6 +424,33 @@ String TupleRouter::transferDump( Tuple& tuple )
     return stream.str();
 }
 
+void TupleRouter::dispatch( Tuple& tuple )
+{
+    // Ignore return values as these just indicate if any actor handled the
+    // tuple, and we don't care.
+    if( tuple.hasValue( _requestID ) &&
+        !m_myID.empty() && ( destinationID( tuple ) == m_myID ) )
+    {
+        // A reply to one of our requests goes straight to its waiter. Fall
+        // back to the usual dispatch if it has been forgotten or is not
+        // wanted.
+        Actor* actor( nullptr );
+        {
+            std::lock_guard< std::mutex > lock( m_expectationsMutex );
+            Map< String, Actor* >::const_iterator it( m_expectations.find( tuple[_requestID] ) );
+            if( it != m_expectations.end() ) actor = it->second;
+        }
+
+        // Not under the lock, as the actor may send another request.
+        if( actor && m_tupleDispatcher.dispatchTo( tuple, actor ) )
+        {
+            return;
+        }
+    }
+
+    m_tupleDispatcher.dispatch( tuple );
+}
+
 void TupleRouter::handleRoutingRequest( const Tuple& tuple, TupleRoute* route )
 {
     TupleRoutingCriteria routingCriteria( TupleRoutingCriteria::fromTuple( tuple ) );
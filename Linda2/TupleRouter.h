@@ -5,6 +5,8 @@
 #include "Runnable.h"
 #include "String.h"
 
+#include <mutex>
+
 namespace Agape
 {
 
@@ -17,6 +19,7 @@ namespace Linda2
 {
 
 class Actor;
+class Promise;
 class Tuple;
 class TupleDispatcher;
 class TupleFilter;
@@ -69,6 +72,14 @@ public:
     void sendAddRoutingCriteriaRequest( const TupleRoutingCriteria& routingCriteria );
     void sendRemoveRoutingCriteriaRequest( const TupleRoutingCriteria& routingCriteria );
 
+    // Request/response correlation. expect() stamps the request with a fresh
+    // request ID, which responders copy onto their replies (see
+    // Linda2::Reply). Replies are then handed straight to the waiting actor
+    // rather than offered to every registered actor. Called before route(),
+    // and safe to call from threads other than the router's.
+    void expect( Tuple& request, Promise& promise, Actor* actor );
+    void forget( Promise& promise );
+
     void setTupleFilter( TupleFilter* tupleFilter );
 
     bool routeError();
@@ -79,6 +90,7 @@ public:
     String transferDump( Tuple& tuple );
 
 private:
+    void dispatch( Tuple& tuple );
     void handleRoutingRequest( const Tuple& tuple, TupleRoute* route );
 
     bool permitIn( const Tuple& tuple );
@@ -100,6 +112,12 @@ private:
     String m_myID;
 
     bool m_routeError;
+
+    // Filled and emptied by whichever thread is waiting on a reply, read
+    // when dispatching on this router's.
+    std::mutex m_expectationsMutex;
+    Map< String, Actor* > m_expectations;
+    int m_requestCount;
 };
 
 } // namespace Linda2
@@ -0,0 +1,157 @@
+#ifdef COALESCING_TEST
+
+#include "Compressors/LZCompressor.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "TupleRoutes/ReadableWritableTupleRoute.h"
+#include "ReadableWritable.h"
+#include "RWBuffer.h"
+#include "RWCompressor.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+
+#include <iostream>
+#include <string>
+
+using namespace Agape;
+
+namespace
+{
+    const int _numUsers( 100 );
+    const int _numRounds( 50 );
+    const int _tuplesPerMs( 20 ); // Storm arrival rate.
+    const int _flushDeadline( 5 ); // ms, as Stratus.
+    const int _flushSize( 4096 );
+
+    long s_now( 0 ); // Simulated ms.
+
+    class SimulatedTimer : public Timer
+    {
+    public:
+        SimulatedTimer() : m_start( s_now ) {}
+        virtual long ms() { return s_now - m_start; }
+        virtual void reset() { m_start = s_now; }
+
+    private:
+        long m_start;
+    };
+
+    class SimulatedTimerFactory : public Timers::Factory
+    {
+    public:
+        virtual Timer* makeTimer() { return new SimulatedTimer; }
+    };
+
+    // Stands in for a WebSocket: each flush (after RWBuffer has gathered
+    // writes) is one message, each write() one send syscall.
+    class Loopback : public ReadableWritable
+    {
+    public:
+        Loopback() : m_offset( 0 ), m_writes( 0 ), m_messages( 0 ) {}
+
+        virtual int read( char* data, int len )
+        {
+            int available( m_data.length() - m_offset );
+            int count( len < available ? len : available );
+            m_data.copy( data, count, m_offset );
+            m_offset += count;
+            return count;
+        }
+
+        virtual int write( const char* data, int len )
+        {
+            m_data.append( data, len );
+            ++m_writes;
+            ++m_messages; // Stratus/Qt send each write as a message.
+            return len;
+        }
+
+        virtual bool error() { return false; }
+
+        String m_data;
+        int m_offset;
+        int m_writes;
+        int m_messages;
+    };
+
+    bool storm( bool coalesce )
+    {
+        s_now = 0;
+        SimulatedTimerFactory timerFactory;
+
+        Loopback wire;
+        RWBuffer rwBuffer( 8192, wire );
+        Compressors::LZ serverCompressor;
+        RWCompressor server( serverCompressor, rwBuffer, false ); // Measure framing alone.
+        Linda2::TupleRoutes::ReadableWritable serverRoute( "Client0", server );
+        if( coalesce )
+        {
+            serverRoute.setCoalescing( timerFactory, _flushDeadline, _flushSize );
+        }
+
+        Compressors::LZ clientCompressor;
+        RWCompressor client( clientCompressor, wire, false );
+        Linda2::TupleRoutes::ReadableWritable clientRoute( "Stratus", client );
+
+        // Every user moves each round; the world clock ticks between.
+        int sent( 0 );
+        for( int round( 0 ); round < _numRounds; ++round )
+        {
+            Linda2::Tuple time;
+            time[_type] = _Time;
+            time[_Time] = round;
+            serverRoute.sendTuple( time, true );
+            ++sent;
+
+            for( int user( 0 ); user < _numUsers; ++user )
+            {
+                Linda2::Tuple presence;
+                presence[_type] = _Presence;
+                presence[_sourceID] = String( ( "Client" + std::to_string( user ) ).c_str() );
+                presence[_worldID] = "0123456789abcdef";
+                presence[_x] = ( user * 7 + round ) % 80;
+                presence[_y] = ( user * 3 + round ) % 24;
+                serverRoute.sendTuple( presence, true );
+                ++sent;
+
+                if( ( sent % _tuplesPerMs ) == 0 )
+                {
+                    ++s_now;
+                    serverRoute.run(); // As TupleRouter::run().
+                }
+            }
+        }
+
+        // Let the last batch fall due.
+        s_now += _flushDeadline;
+        serverRoute.run();
+
+        int received( 0 );
+        Linda2::Tuple tuple;
+        while( clientRoute.receiveTuple( tuple ) )
+        {
+            ++received;
+        }
+
+        std::cout << ( coalesce ? "Coalesced: " : "Per tuple: " )
+                  << sent << " tuples, " << wire.m_data.length() << " bytes, "
+                  << wire.m_messages << " messages, "
+                  << wire.m_writes << " send calls, "
+                  << serverRoute.batchesSent() << " batches"
+                  << ( received == sent ? "" : " FAILED" ) << std::endl;
+
+        return( received == sent );
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( storm( false ) );
+    success = storm( true ) && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // COALESCING_TEST
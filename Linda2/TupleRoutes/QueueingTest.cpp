@@ -0,0 +1,224 @@
+#ifdef QUEUEING_TEST
+
+#include "TupleRoutes/QueueingTupleRoute.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace Agape;
+using Agape::Linda2::TupleRoutes::Queueing;
+
+namespace
+{
+    const int _numTuples( 50000 );
+    const int _capacity( 256 );
+    const int _numUsers( 10 );
+
+    // Every 10th tuple is a clock tick, the rest are users' moves.
+    Linda2::Tuple makeTuple( int sequence )
+    {
+        Linda2::Tuple tuple;
+        if( ( sequence % 10 ) == 0 )
+        {
+            tuple[_type] = _Time;
+        }
+        else
+        {
+            tuple[_type] = _Moved;
+            tuple[_sourceID] = String( ( "Client" + std::to_string( sequence % _numUsers ) ).c_str() );
+        }
+        tuple[_offset] = sequence;
+        return tuple;
+    }
+
+    // Floods the queue from one thread while draining it slowly from this one.
+    bool flood( const char* name, Queueing::OverflowPolicy policy )
+    {
+        Queueing queue( "Test" );
+        queue.setCapacity( _capacity, policy );
+        queue.addCoalescingKey( _Time );
+        queue.addCoalescingKey( _Moved, _sourceID );
+
+        std::atomic< bool > produced( false );
+        std::thread producer( [&queue, &produced]()
+        {
+            for( int i( 0 ); i < _numTuples; ++i )
+            {
+                queue.enqueue( makeTuple( i ) );
+            }
+            produced = true;
+        } );
+
+        // Sequence numbers must only ever increase, and each user's last
+        // move must arrive.
+        bool success( true );
+        int received( 0 );
+        int last( -1 );
+        int lastMove[_numUsers] = { 0 };
+        while( !produced || queue.haveIncoming() )
+        {
+            Linda2::Tuple tuple;
+            if( !queue.receiveTuple( tuple ) )
+            {
+                queue.waitIncoming( 1 );
+                continue;
+            }
+
+            int sequence( tuple[_offset] );
+            success = success && ( sequence > last );
+            last = sequence;
+            ++received;
+            if( tuple[_type] == String( _Moved ) )
+            {
+                lastMove[sequence % _numUsers] = sequence;
+            }
+
+            if( ( received % 16 ) == 0 )
+            {
+                std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+            }
+        }
+
+        producer.join();
+
+        // User 0's sequence numbers are all clock ticks.
+        for( int user( 1 ); user < _numUsers; ++user )
+        {
+            int expected( _numTuples - _numUsers + user );
+            success = success && ( lastMove[user] == expected );
+        }
+
+        success = success &&
+                  ( queue.maxDepth() <= _capacity ) &&
+                  ( received + queue.dropped() + queue.coalesced() == _numTuples ) &&
+                  ( ( policy != Queueing::overflowBlock ) || ( received == _numTuples ) );
+
+        std::cout << name << ": received " << received
+                  << ", dropped " << queue.dropped()
+                  << ", coalesced " << queue.coalesced()
+                  << ", max depth " << queue.maxDepth()
+                  << ( success ? "" : " FAILED" ) << std::endl;
+        return success;
+    }
+
+    // Empty tuples are ordinary tuples, not superseded ones: each is
+    // delivered, and a full queue still drops exactly one per overflow.
+    bool emptyTuples()
+    {
+        Queueing queue( "Test" );
+        queue.setCapacity( _capacity, Queueing::overflowCoalesce );
+        queue.addCoalescingKey( _Time );
+
+        for( int i( 0 ); i < _capacity * 2; ++i )
+        {
+            queue.enqueue( ( ( i % 2 ) == 0 ) ? Linda2::Tuple() : makeTuple( 0 ) );
+        }
+
+        int received( 0 );
+        Linda2::Tuple tuple;
+        while( queue.receiveTuple( tuple ) )
+        {
+            ++received;
+        }
+
+        bool success( ( queue.depth() == 0 ) &&
+                      ( received + queue.dropped() + queue.coalesced() == _capacity * 2 ) &&
+                      ( received == _capacity ) );
+
+        std::cout << "Empty tuples: received " << received
+                  << ", dropped " << queue.dropped()
+                  << ", coalesced " << queue.coalesced()
+                  << ( success ? "" : " FAILED" ) << std::endl;
+        return success;
+    }
+
+    // Only tuples with a coalescing key are shed; chat always arrives, and
+    // a queue of nothing but chat overflows rather than dropping any.
+    bool dropKeyed()
+    {
+        Queueing queue( "Test" );
+        queue.setCapacity( _capacity, Queueing::overflowDropKeyed );
+        queue.addCoalescingKey( _Moved, _sourceID );
+
+        const int numTuples( _capacity * 4 );
+        for( int i( 0 ); i < numTuples; ++i )
+        {
+            Linda2::Tuple tuple;
+            if( ( i % 8 ) == 0 )
+            {
+                tuple[_type] = _Chat;
+            }
+            else
+            {
+                // Each move from a different user, so none coalesce.
+                tuple[_type] = _Moved;
+                tuple[_sourceID] = String( ( "Client" + std::to_string( i ) ).c_str() );
+            }
+            tuple[_offset] = i;
+            queue.enqueue( tuple );
+        }
+
+        bool success( !queue.overflowed() && ( queue.depth() == _capacity ) );
+        int received( 0 );
+        int chats( 0 );
+        int last( -1 );
+        Linda2::Tuple tuple;
+        while( queue.receiveTuple( tuple ) )
+        {
+            int sequence( tuple[_offset] );
+            success = success && ( sequence > last );
+            last = sequence;
+            ++received;
+            if( tuple[_type] == String( _Chat ) )
+            {
+                ++chats;
+            }
+        }
+
+        success = success &&
+                  ( chats == numTuples / 8 ) &&
+                  ( received + queue.dropped() == numTuples );
+
+        Queueing chatQueue( "Test" );
+        chatQueue.setCapacity( _capacity, Queueing::overflowDropKeyed );
+        chatQueue.addCoalescingKey( _Moved, _sourceID );
+        for( int i( 0 ); i <= _capacity; ++i )
+        {
+            Linda2::Tuple chat;
+            chat[_type] = _Chat;
+            chatQueue.enqueue( chat );
+        }
+
+        success = success &&
+                  chatQueue.overflowed() &&
+                  ( chatQueue.depth() == _capacity + 1 ) &&
+                  ( chatQueue.dropped() == 0 );
+
+        std::cout << "Drop keyed: received " << received
+                  << ", chats " << chats
+                  << ", dropped " << queue.dropped()
+                  << ", chat only overflowed at " << chatQueue.depth()
+                  << ( success ? "" : " FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( flood( "Block", Queueing::overflowBlock ) );
+    success = flood( "Drop oldest", Queueing::overflowDropOldest ) && success;
+    success = flood( "Coalesce", Queueing::overflowCoalesce ) && success;
+    success = emptyTuples() && success;
+    success = dropKeyed() && success;
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // QUEUEING_TEST
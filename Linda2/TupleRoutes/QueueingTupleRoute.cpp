@@ -1,4 +1,6 @@
 #include "Loggers/Logger.h"
+#include "Metrics/Histogram.h"
+#include "Metrics/Timed.h"
 #include "Collections.h"
 #include "QueueingTupleRoute.h"
 #include "Runnable.h"
@@ -8,9 +10,17 @@
 #include "TupleRouter.h"
 #include "TupleRoutingCriteria.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 
+namespace
+{
+    // Only every so many tuples' waits are timed, as reading the clock
+    // twice a tuple costs more than routing is worth slowing by.
+    const int _waitSampleEvery( 8 );
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -22,6 +32,15 @@ namespace TupleRoutes
 
 Queueing::Queueing( const String& routeName ) :
   TupleRoute( routeName ),
+  m_capacity( 0 ),
+  m_overflowPolicy( overflowDropOldest ),
+  m_popped( 0 ),
+  m_superseded( 0 ),
+  m_maxDepth( 0 ),
+  m_dropped( 0 ),
+  m_coalesced( 0 ),
+  m_overflowed( false ),
+  m_waitHistogram( nullptr ),
   m_partner( nullptr ),
   m_stop( false )
 {
@@ -45,7 +64,12 @@ bool Queueing::receiveTuple( Tuple& tuple )
     {
         //LOG_DEBUG( "QueueingTupleRoute: Receiving" );
         tuple = m_incomingQueue.front();
-        m_incomingQueue.pop_front();
+        if( m_waitHistogram && m_queuedus.front() )
+        {
+            m_waitHistogram->record( Metrics::nowus() - m_queuedus.front() );
+        }
+        popFront();
+        m_spacePending.notify_all();
         return true;
     }
 
@@ -58,7 +82,10 @@ void Queueing::run()
 
 void Queueing::stop()
 {
+    std::scoped_lock lock( m_mutex );
+    m_stop = true;
     m_incomingPending.notify_all();
+    m_spacePending.notify_all();
 }
 
 bool Queueing::error() const
@@ -83,14 +110,137 @@ void Queueing::waitIncoming()
     }
 }
 
+void Queueing::waitIncoming( int timeout )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    if( m_incomingQueue.empty() )
+    {
+        m_incomingPending.wait_for( lock, std::chrono::milliseconds( timeout ) );
+    }
+}
+
 void Queueing::enqueue( const Tuple& tuple )
 {
     //LOG_DEBUG( "QueueingTupleRoute: Enqueueing" );
-    std::scoped_lock lock( m_mutex );
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    bool coalescing( ( m_overflowPolicy == overflowCoalesce ) ||
+                     ( m_overflowPolicy == overflowDropKeyed ) );
+    if( coalescing && coalesce( tuple ) )
+    {
+        ++m_coalesced;
+    }
+
+    if( m_capacity > 0 )
+    {
+        if( m_overflowPolicy == overflowBlock )
+        {
+            while( !m_stop && ( (int)( m_incomingQueue.size() - m_superseded ) >= m_capacity ) )
+            {
+                m_spacePending.wait( lock );
+            }
+
+            if( m_stop )
+            {
+                return;
+            }
+        }
+        else if( m_overflowPolicy == overflowDropKeyed )
+        {
+            while( !m_overflowed &&
+                   ( (int)( m_incomingQueue.size() - m_superseded ) >= m_capacity ) )
+            {
+                if( !dropOldestKeyed() )
+                {
+                    // Nothing is safe to shed, so queue it anyway.
+                    m_overflowed = true;
+                }
+            }
+        }
+        else
+        {
+            while( !m_incomingQueue.empty() &&
+                   ( (int)( m_incomingQueue.size() - m_superseded ) >= m_capacity ) )
+            {
+                dropOldest();
+            }
+        }
+    }
+
+    String key;
+    if( coalescing && coalescingKey( tuple, key ) )
+    {
+        m_coalescingIndex[key] = m_popped + m_incomingQueue.size();
+    }
+
+    if( m_waitHistogram )
+    {
+        bool sampled( ( ( m_popped + m_incomingQueue.size() ) % _waitSampleEvery ) == 0 );
+        m_queuedus.push_back( sampled ? Metrics::nowus() : 0 );
+    }
     m_incomingQueue.push_back( tuple );
+    m_supersededSlots.push_back( false );
+    if( (int)( m_incomingQueue.size() - m_superseded ) > m_maxDepth )
+    {
+        m_maxDepth = m_incomingQueue.size() - m_superseded;
+    }
+
     m_incomingPending.notify_all();
 }
 
+void Queueing::setCapacity( int capacity, OverflowPolicy overflowPolicy )
+{
+    std::scoped_lock lock( m_mutex );
+    m_capacity = capacity;
+    m_overflowPolicy = overflowPolicy;
+    m_spacePending.notify_all();
+}
+
+void Queueing::addCoalescingKey( const String& type, const String& key )
+{
+    std::scoped_lock lock( m_mutex );
+    m_coalescingKeys[type] = key;
+}
+
+int Queueing::depth()
+{
+    std::scoped_lock lock( m_mutex );
+    return m_incomingQueue.size() - m_superseded;
+}
+
+int Queueing::maxDepth()
+{
+    std::scoped_lock lock( m_mutex );
+    return m_maxDepth;
+}
+
+int Queueing::dropped()
+{
+    std::scoped_lock lock( m_mutex );
+    return m_dropped;
+}
+
+int Queueing::coalesced()
+{
+    std::scoped_lock lock( m_mutex );
+    return m_coalesced;
+}
+
+bool Queueing::overflowed()
+{
+    std::scoped_lock lock( m_mutex );
+    return m_overflowed;
+}
+
+void Queueing::setWaitHistogram( Metrics::Histogram* waitHistogram )
+{
+    std::scoped_lock lock( m_mutex );
+    m_waitHistogram = waitHistogram;
+
+    // Anything already queued is timed from now.
+    m_queuedus.assign( m_waitHistogram ? m_incomingQueue.size() : 0, Metrics::nowus() );
+}
+
 bool Queueing::_sendTuple( const Tuple& tuple )
 {
     // FIXME: Hack to prevent Hydra from routing authentication keys!
@@ -107,6 +257,125 @@ bool Queueing::_sendTuple( const Tuple& tuple )
     return false;
 }
 
+bool Queueing::coalescingKey( const Tuple& tuple, String& key ) const
+{
+    const String& type( TupleRouter::tupleType( tuple ) );
+    Map< String, String >::const_iterator it( m_coalescingKeys.find( type ) );
+    if( it == m_coalescingKeys.end() )
+    {
+        return false;
+    }
+
+    key = type;
+    if( !it->second.empty() )
+    {
+        if( !tuple.hasValue( it->second ) )
+        {
+            return false;
+        }
+
+        key += '\0';
+        key += tuple[it->second].toString();
+    }
+
+    return true;
+}
+
+bool Queueing::coalesce( const Tuple& tuple )
+{
+    String key;
+    if( !coalescingKey( tuple, key ) )
+    {
+        return false;
+    }
+
+    Map< String, long long >::iterator it( m_coalescingIndex.find( key ) );
+    if( ( it == m_coalescingIndex.end() ) || ( it->second < m_popped ) )
+    {
+        return false;
+    }
+
+    // Mark its slot to be skipped when reached, so the new one is queued
+    // behind everything that was sent before it.
+    m_incomingQueue[it->second - m_popped] = Tuple();
+    m_supersededSlots[it->second - m_popped] = true;
+    m_coalescingIndex.erase( it );
+    ++m_superseded;
+    skipSuperseded();
+    return true;
+}
+
+void Queueing::dropOldest()
+{
+    if( m_incomingQueue.empty() )
+    {
+        return;
+    }
+
+    popFront();
+    ++m_dropped;
+}
+
+bool Queueing::dropOldestKeyed()
+{
+    // Only reached when full, so a scan past the unkeyed tuples is rare.
+    String key;
+    for( size_t i( 0 ); i < m_incomingQueue.size(); ++i )
+    {
+        if( !m_supersededSlots[i] && coalescingKey( m_incomingQueue[i], key ) )
+        {
+            Map< String, long long >::iterator it( m_coalescingIndex.find( key ) );
+            if( ( it != m_coalescingIndex.end() ) && ( it->second == (long long)( m_popped + i ) ) )
+            {
+                m_coalescingIndex.erase( it );
+            }
+
+            m_incomingQueue[i] = Tuple();
+            m_supersededSlots[i] = true;
+            ++m_superseded;
+            ++m_dropped;
+            skipSuperseded();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Queueing::skipSuperseded()
+{
+    while( !m_incomingQueue.empty() && m_supersededSlots.front() )
+    {
+        m_incomingQueue.pop_front();
+        m_supersededSlots.pop_front();
+        if( m_waitHistogram ) m_queuedus.pop_front();
+        ++m_popped;
+        --m_superseded;
+    }
+}
+
+void Queueing::popFront()
+{
+    if( !m_coalescingIndex.empty() )
+    {
+        String key;
+        if( coalescingKey( m_incomingQueue.front(), key ) )
+        {
+            Map< String, long long >::iterator it( m_coalescingIndex.find( key ) );
+            if( ( it != m_coalescingIndex.end() ) && ( it->second == m_popped ) )
+            {
+                m_coalescingIndex.erase( it );
+            }
+        }
+    }
+
+    m_incomingQueue.pop_front();
+    m_supersededSlots.pop_front();
+    if( m_waitHistogram ) m_queuedus.pop_front();
+    ++m_popped;
+    skipSuperseded();
+}
+
 } // namespace TupleRoutes
 
 } // namespace Linda2
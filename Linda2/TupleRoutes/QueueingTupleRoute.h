@@ -13,6 +13,11 @@
 namespace Agape
 {
 
+namespace Metrics
+{
+class Histogram;
+} // namespace Metrics
+
 namespace Linda2
 {
 
@@ -21,9 +26,29 @@ class Tuple;
 namespace TupleRoutes
 {
 
+/// Hands tuples to a partner Queueing route, typically on another thread.
+///
+/// By default the queue is unbounded. With a capacity set, what happens when
+/// it's full depends on the overflow policy: the sender blocks until
+/// there's room, or the oldest queued tuple is dropped. With the coalesce
+/// policy, a tuple also supersedes any still-queued one with the same
+/// coalescing key, which is then skipped (and the oldest is still dropped if
+/// full). The drop keyed policy coalesces too, but when full only drops the
+/// oldest tuple that has a coalescing key; if there's none, nothing is lost:
+/// the tuple is queued regardless and the route reports overflowed(), for
+/// its owner to disconnect. Coalescing keys are set per tuple type, e.g.
+/// _Time alone, or _Moved by _sourceID.
 class Queueing : public TupleRoute
 {
 public:
+    enum OverflowPolicy
+    {
+        overflowBlock,
+        overflowDropOldest,
+        overflowCoalesce,
+        overflowDropKeyed
+    };
+
     Queueing( const String& routeName );
     ~Queueing();
 
@@ -38,14 +63,59 @@ public:
     void setPartner( Queueing* partner );
 
     void waitIncoming();
+    void waitIncoming( int timeout ); // ms
     void enqueue( const Tuple& tuple );
 
+    // Applies to this route's own (incoming) queue. 0 = unbounded.
+    void setCapacity( int capacity, OverflowPolicy overflowPolicy );
+
+    // Tuples of this type coalesce by the value of "key" (or by type alone
+    // if key is empty).
+    void addCoalescingKey( const String& type, const String& key = "" );
+
+    int depth();
+    int maxDepth();
+    int dropped();
+    int coalesced();
+    bool overflowed(); // Stays set once the drop keyed policy couldn't make room.
+
+    // Records how long tuples wait in this route's queue, sampling one in
+    // eight.
+    void setWaitHistogram( Metrics::Histogram* waitHistogram );
+
 private:
     virtual bool _sendTuple( const Tuple& tuple );
 
+    bool coalescingKey( const Tuple& tuple, String& key ) const;
+    bool coalesce( const Tuple& tuple );
+    void dropOldest();
+    bool dropOldestKeyed();
+    void popFront();
+    void skipSuperseded();
+
     Deque< Tuple > m_incomingQueue;
+    Deque< bool > m_supersededSlots; // In step with m_incomingQueue. true = skipped when reached.
+    Deque< long long > m_queuedus; // In step with m_incomingQueue, if measuring. 0 = not sampled.
     std::mutex m_mutex;
     std::condition_variable m_incomingPending;
+    std::condition_variable m_spacePending;
+
+    int m_capacity;
+    OverflowPolicy m_overflowPolicy;
+
+    // Coalescing key -> sequence number of the queued tuple. A tuple's
+    // sequence number less m_popped is its index in m_incomingQueue.
+    Map< String, String > m_coalescingKeys; // Tuple type -> key value name.
+    Map< String, long long > m_coalescingIndex;
+    long long m_popped;
+    int m_superseded; // Slots marked in m_supersededSlots.
+
+    int m_maxDepth;
+    int m_dropped;
+    int m_coalesced;
+    bool m_overflowed;
+
+    Metrics::Histogram* m_waitHistogram;
 
     Queueing* m_partner;
 
@@ -1,7 +1,10 @@
 #include "Loggers/Logger.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
 #include "ReadableWritableTupleRoute.h"
 #include "ReadableWritable.h"
 #include "String.h"
+#include "Tuple.h"
 
 namespace Agape
 {
@@ -14,10 +17,20 @@ namespace TupleRoutes
 
 ReadableWritable::ReadableWritable( const String& routeName, Agape::ReadableWritable& rw ) :
   TupleRoute( routeName ),
-  m_rw( rw )
+  m_rw( rw ),
+  m_flushTimer( nullptr ),
+  m_flushDeadline( 0 ),
+  m_flushSize( 0 ),
+  m_tuplesSent( 0 ),
+  m_batchesSent( 0 )
 {
 }
 
+ReadableWritable::~ReadableWritable()
+{
+    delete( m_flushTimer );
+}
+
 bool ReadableWritable::haveIncoming()
 {
     return true;
@@ -32,6 +45,10 @@ bool ReadableWritable::receiveTuple( Tuple& tuple )
 
 void ReadableWritable::run()
 {
+    if( flushDue() == 0 )
+    {
+        flushOutgoing();
+    }
 }
 
 bool ReadableWritable::error() const
@@ -39,17 +56,100 @@ bool ReadableWritable::error() const
     return m_rw.error();
 }
 
+void ReadableWritable::setCoalescing( Timers::Factory& timerFactory, int deadline, int maxSize )
+{
+    delete( m_flushTimer );
+    m_flushTimer = timerFactory.makeTimer();
+    m_flushDeadline = deadline;
+    m_flushSize = maxSize;
+}
+
+int ReadableWritable::flushDue() const
+{
+    if( m_batch.m_data.empty() )
+    {
+        return -1;
+    }
+
+    long waited( m_flushTimer->ms() );
+    return( waited >= m_flushDeadline ? 0 : m_flushDeadline - waited );
+}
+
+void ReadableWritable::flushOutgoing()
+{
+    if( m_batch.m_data.empty() )
+    {
+        return;
+    }
+
+    int numWritten( 0 );
+    int numThisWrite( -1 );
+    while( !m_rw.error() &&
+           ( numThisWrite != 0 ) &&
+           ( numWritten < m_batch.m_data.length() ) )
+    {
+        numThisWrite = m_rw.write( m_batch.m_data.c_str() + numWritten, m_batch.m_data.length() - numWritten );
+        numWritten += numThisWrite;
+    }
+    m_rw.flushOutput();
+    ++m_batchesSent;
+
+    m_batch.m_data.clear();
+    m_batch.m_offset = 0;
+}
+
+int ReadableWritable::tuplesSent() const
+{
+    return m_tuplesSent;
+}
+
+int ReadableWritable::batchesSent() const
+{
+    return m_batchesSent;
+}
+
 bool ReadableWritable::_sendTuple( const Tuple& tuple )
 {
     //LOG_DEBUG( "ReadableWritableTupleRoute: Sending" );
-    if( !m_rw.error() )
+    if( m_rw.error() )
+    {
+        return false;
+    }
+
+    if( m_flushTimer == nullptr )
     {
         bool retval( tuple.toReadableWritable( m_rw ) );
-        if( retval ) m_rw.flushOutput(); // If buffering, write/send now.
+        if( retval )
+        {
+            m_rw.flushOutput(); // If buffering, write/send now.
+            ++m_tuplesSent;
+            ++m_batchesSent;
+        }
         return retval;
     }
 
-    return false;
+    if( m_batch.m_data.empty() )
+    {
+        m_flushTimer->reset();
+    }
+
+    int batchLength( m_batch.m_data.length() );
+    bool retval( tuple.toReadableWritable( m_batch ) );
+    if( !retval )
+    {
+        // Drop anything written of a tuple that failed to serialise.
+        m_batch.m_data.resize( batchLength );
+        m_batch.m_offset = batchLength;
+        return false;
+    }
+
+    ++m_tuplesSent;
+    if( m_batch.m_data.length() >= m_flushSize )
+    {
+        flushOutgoing();
+    }
+
+    return true;
 }
 
 }
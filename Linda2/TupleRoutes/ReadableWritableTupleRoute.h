@@ -3,11 +3,19 @@
 
 #include "ReadableWritable.h"
 #include "String.h"
+#include "StringSerialiser.h"
 #include "TupleRoute.h"
 
 namespace Agape
 {
 
+class Timer;
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
 namespace Linda2
 {
 
@@ -20,6 +28,7 @@ class ReadableWritable : public TupleRoute
 {
 public:
     ReadableWritable( const String& routeName, Agape::ReadableWritable& rw );
+    ~ReadableWritable();
 
     // Returns true always, as ReadableWritable objects don't
     // indicate if any bytes are waiting.
@@ -31,14 +40,37 @@ public:
     // is received.
     virtual bool receiveTuple( Tuple& tuple );
 
+    // Flushes coalesced tuples if their deadline has passed.
     virtual void run();
 
     virtual bool error() const;
 
+    // By default each tuple sent is flushed to the ReadableWritable
+    // straight away. With coalescing, tuples are batched and flushed
+    // together once the first has waited "deadline" ms, or the batch
+    // reaches "maxSize" bytes, or on flushOutgoing(). The receiver reads
+    // batches just like single tuples.
+    void setCoalescing( Timers::Factory& timerFactory, int deadline, int maxSize );
+
+    // -1 if nothing is waiting, else ms until the batch is due (0 if now).
+    int flushDue() const;
+    void flushOutgoing();
+
+    int tuplesSent() const;
+    int batchesSent() const;
+
 private:
     virtual bool _sendTuple( const Tuple& tuple );
 
     Agape::ReadableWritable& m_rw;
+
+    Timer* m_flushTimer;
+    int m_flushDeadline;
+    int m_flushSize;
+    StringSerialiser m_batch;
+
+    int m_tuplesSent;
+    int m_batchesSent;
 };
 
 }
@@ -0,0 +1,40 @@
+#ifndef AGAPE_STRATUS_ACCOUNT_STORE_H
+#define AGAPE_STRATUS_ACCOUNT_STORE_H
+
+#include "Collections.h"
+#include "String.h"
+
+namespace Agape
+{
+
+class Value;
+
+namespace Stratus
+{
+
+// The account and world lookups the Authenticator makes. Each returns false
+// if the store could not be read; found says whether the document exists.
+class AccountStore
+{
+public:
+    virtual ~AccountStore() {};
+
+    // An empty deviceAuthKeyHash matches the account on any device.
+    virtual bool findAccount( const String& accountAuthKeyHash,
+                              const String& deviceAuthKeyHash,
+                              Value& account,
+                              bool& found ) = 0;
+    virtual bool findWorld( const String& worldID, Value& world, bool& found ) = 0;
+
+    // The users this account has in its joined worlds, on one device or on
+    // all of them if deviceAuthKeyHash is empty.
+    virtual bool findUserSnowflakes( const String& accountAuthKeyHash,
+                                     const String& deviceAuthKeyHash,
+                                     Vector< String >& snowflakes ) = 0;
+};
+
+} // namespace Stratus
+
+} // namespace Agape
+
+#endif // AGAPE_STRATUS_ACCOUNT_STORE_H
@@ -0,0 +1,156 @@
+#include "AccountStores/MongoAccountStore.h"
+#include "Databases/MongoDB/MongoDB.h"
+#include "Databases/MongoDB/MongoDocumentBuilder.h"
+#include "Loggers/Logger.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Value.h"
+
+#include <bsoncxx/builder/stream/document.hpp>
+#include <bsoncxx/json.hpp>
+
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/exception/exception.hpp>
+
+using namespace Agape::Databases::MongoDB;
+
+using namespace bsoncxx::builder::stream;
+using namespace mongocxx;
+
+namespace Agape
+{
+
+namespace Stratus
+{
+
+namespace AccountStores
+{
+
+bool Mongo::findAccount( const String& accountAuthKeyHash,
+                         const String& deviceAuthKeyHash,
+                         Value& account,
+                         bool& found )
+{
+    found = false;
+
+    try
+    {
+        auto client( MongoDB::pool().acquire() );
+        auto collection( ( *client )[_Agape][_Accounts] );
+
+        bsoncxx::document::value query( deviceAuthKeyHash.empty() ?
+            document() << "authKeyHash" << accountAuthKeyHash << finalize :
+            document() << "authKeyHash" << accountAuthKeyHash
+                       << "devices.authKeyHash" << deviceAuthKeyHash << finalize );
+
+        bsoncxx::stdx::optional< bsoncxx::document::value > result( collection.find_one( query.view() ) );
+        if( result )
+        {
+            account = DocumentBuilder::unbuild( *result );
+            found = true;
+        }
+    }
+    catch( mongocxx::exception& e )
+    {
+#ifdef LOG_STRATUS
+        LOG_DEBUG( "MongoAccountStore: Exception finding account with ID " + accountAuthKeyHash + ": " + String( e.what() ) );
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+bool Mongo::findWorld( const String& worldID, Value& world, bool& found )
+{
+    found = false;
+
+    try
+    {
+        auto client( MongoDB::pool().acquire() );
+        auto collection( ( *client )[_Agape][_Worlds] );
+
+        bsoncxx::stdx::optional< bsoncxx::document::value > result(
+            collection.find_one(
+                document() << "worldID" << worldID << finalize
+            )
+        );
+
+        if( result )
+        {
+            world = DocumentBuilder::unbuild( *result );
+            found = true;
+        }
+    }
+    catch( mongocxx::exception& e )
+    {
+#ifdef LOG_STRATUS
+        LOG_DEBUG( "MongoAccountStore: Exception finding world with ID " + worldID + ": " + String( e.what() ) );
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+bool Mongo::findUserSnowflakes( const String& accountAuthKeyHash,
+                                const String& deviceAuthKeyHash,
+                                Vector< String >& snowflakes )
+{
+    try
+    {
+        auto client( MongoDB::pool().acquire() );
+        auto collection( ( *client )[_Agape][_Accounts] );
+
+        mongocxx::pipeline pipeline;
+        pipeline.match( document() << "authKeyHash" << accountAuthKeyHash
+                                   << finalize );
+        pipeline.unwind( "$devices" );
+        if( !deviceAuthKeyHash.empty() )
+        {
+            pipeline.match( document() << "devices.authKeyHash" << deviceAuthKeyHash
+                                       << finalize );
+        }
+        pipeline.unwind( "$devices.joinedWorlds" );
+        pipeline.group( document() << "_id" << int(0)
+                                   << "snowflake" << open_document
+                                       << "$addToSet" << "$devices.joinedWorlds.user.snowflake"
+                                   << close_document
+                                   << finalize );
+
+        mongocxx::cursor aggregateCursor(
+            collection.aggregate( pipeline )
+        );
+
+        snowflakes.clear();
+        mongocxx::cursor::iterator resultIt( aggregateCursor.begin() );
+        if( resultIt != aggregateCursor.end() )
+        {
+            Value resultValue( DocumentBuilder::unbuild( *resultIt ) );
+            Value& snowflakesValue( resultValue[_snowflake] );
+            ConstListIterator it( snowflakesValue.listBegin() );
+            for( ; it != snowflakesValue.listEnd(); ++it )
+            {
+                snowflakes.push_back( **it );
+            }
+        }
+    }
+    catch( mongocxx::exception& e )
+    {
+#ifdef LOG_STRATUS
+        LOG_DEBUG( "MongoAccountStore: Exception finding user snowflakes: " + String( e.what() ) );
+#endif
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace AccountStores
+
+} // namespace Stratus
+
+} // namespace Agape
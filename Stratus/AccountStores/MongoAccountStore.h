@@ -0,0 +1,37 @@
+#ifndef AGAPE_STRATUS_ACCOUNT_STORES_MONGO_H
+#define AGAPE_STRATUS_ACCOUNT_STORES_MONGO_H
+
+#include "AccountStores/AccountStore.h"
+#include "Collections.h"
+#include "String.h"
+
+namespace Agape
+{
+
+namespace Stratus
+{
+
+namespace AccountStores
+{
+
+class Mongo : public AccountStore
+{
+public:
+    virtual bool findAccount( const String& accountAuthKeyHash,
+                              const String& deviceAuthKeyHash,
+                              Value& account,
+                              bool& found );
+    virtual bool findWorld( const String& worldID, Value& world, bool& found );
+
+    virtual bool findUserSnowflakes( const String& accountAuthKeyHash,
+                                     const String& deviceAuthKeyHash,
+                                     Vector< String >& snowflakes );
+};
+
+} // namespace AccountStores
+
+} // namespace Stratus
+
+} // namespace Agape
+
+#endif // AGAPE_STRATUS_ACCOUNT_STORES_MONGO_H
@@ -1,10 +1,13 @@
 #include "Databases/MongoDB/MongoDB.h"
 #include "Databases/MongoDB/MongoDocumentBuilder.h"
+#include "Encryptors/SHA256/SHA256Hash.h"
 #include "Encryptors/Utils/SecureIdentifier.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "Utils/base64/base64.h"
 #include "World/WorldCoordinates.h"
 #include "Authenticator.h"
+#include "Collections.h"
 #include "MongoAssetLoader.h"
 #include "String.h"
 #include "StringConstants.h"
@@ -16,6 +19,7 @@
 #include <mongocxx/exception/exception.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
 
 
 using namespace Agape::Databases::MongoDB;
@@ -52,6 +56,8 @@ bool Mongo::open()
 
 bool Mongo::open( enum OpenMode openMode, const String& linkedItem )
 {
+    METRICS_TIMED( "mongo.asset.open" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoAssetLoader: Attempting to open asset " + m_name );
 #endif
@@ -104,6 +110,17 @@ bool Mongo::open( enum OpenMode openMode, const String& linkedItem )
                 Value assetValue( DocumentBuilder::unbuild( *assetDocument ) );
 
                 m_readBuffer = assetValue[_data];
+                m_version = assetValue[_version];
+                if( m_version.empty() )
+                {
+                    // Asset stored before versioning. Compute and save now
+                    // so that future revalidations don't need the data.
+                    m_version = contentVersion( m_readBuffer );
+                    collection.update_one(
+                        document() << "_id" << assetDocument->view()["_id"].get_oid() << finalize,
+                        document() << "$set" << open_document << "version" << m_version << close_document << finalize
+                    );
+                }
             }
             else
             {
@@ -173,6 +190,8 @@ int Mongo::write( const char* data, int offset, int len )
 
 bool Mongo::close()
 {
+    METRICS_TIMED( "mongo.asset.close" );
+
     bool success( true );
 
     if( m_isOpen && ( m_openMode == modeWrite ) )
@@ -205,6 +224,7 @@ bool Mongo::close()
             }
             assetValue[_data] = m_writeBuffer;
             assetValue[_data].markBinary();
+            assetValue[_version] = contentVersion( m_writeBuffer );
             assetValue[_author] = m_authenticator.accountAuthKeyHash();
             assetValue[_linkedItem] = m_linkedItem;
             m_coordinates.toValue( assetValue[_coordinates] );
@@ -227,6 +247,8 @@ int Mongo::size()
 
 bool Mongo::move( const String& newName )
 {
+    METRICS_TIMED( "mongo.asset.move" );
+
     if( !m_authenticator.writableWorld( m_coordinates.m_worldID ) )
     {
         LOG_DEBUG( "MongoAssetLoader: Attempted to move but world not writable for this user" );
@@ -339,6 +361,8 @@ bool Mongo::move( const String& newName )
 
 bool Mongo::erase()
 {
+    METRICS_TIMED( "mongo.asset.erase" );
+
     if( !m_authenticator.writableWorld( m_coordinates.m_worldID ) )
     {
         LOG_DEBUG( "MongoAssetLoader: Attempted to erase but world not writable for this user" );
@@ -396,6 +420,108 @@ bool Mongo::erase()
     return success;
 }
 
+String Mongo::version()
+{
+    return m_version;
+}
+
+bool Mongo::revalidate( Vector< struct Revalidation >& revalidations )
+{
+    METRICS_TIMED( "mongo.asset.revalidate" );
+
+    if( revalidations.empty() )
+    {
+        return true;
+    }
+
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "MongoAssetLoader: Revalidating assets" );
+#endif
+
+    bool success( true );
+
+    const char* nameField( m_encryptedNames ? "hash" : "name" );
+
+    // Fetch current versions of all requested assets in one query.
+    Value query;
+    query["coordinates.worldID"] = m_coordinates.m_worldID;
+    Value& names( query[nameField]["$in"] );
+    Vector< struct Revalidation >::iterator it( revalidations.begin() );
+    for( ; it != revalidations.end(); ++it )
+    {
+        names.push_back( new Value( lookupName( it->m_name ) ) );
+        it->m_state = Revalidation::missing;
+    }
+
+    try
+    {
+        auto client( MongoDB::pool().acquire() );
+        auto collection( ( *client )[_Agape][m_collectionName.c_str()] );
+
+        options::find options;
+        options.projection( document() << nameField << 1 << "version" << 1 << finalize );
+
+        mongocxx::cursor assetCursor(
+            collection.find( DocumentBuilder::build( query ), options )
+        );
+
+        Map< String, String > currentVersions;
+        mongocxx::cursor::iterator cursorIt( assetCursor.begin() );
+        for( ; cursorIt != assetCursor.end(); ++cursorIt )
+        {
+            Value assetValue( DocumentBuilder::unbuild( *cursorIt ) );
+            currentVersions[assetValue[nameField]] = assetValue[_version];
+        }
+
+        for( it = revalidations.begin(); it != revalidations.end(); ++it )
+        {
+            Map< String, String >::const_iterator versionIt( currentVersions.find( lookupName( it->m_name ) ) );
+            if( versionIt != currentVersions.end() )
+            {
+                // Unversioned assets are treated as stale; they gain a
+                // version when next opened.
+                it->m_state = ( !versionIt->second.empty() && ( versionIt->second == it->m_version ) ) ?
+                                  Revalidation::current :
+                                  Revalidation::stale;
+            }
+        }
+    }
+    catch( mongocxx::exception& e )
+    {
+        LOG_DEBUG( "MongoAssetLoader: Exception revalidating assets: " + String( e.what() ) );
+        success = false;
+    }
+
+    return success;
+}
+
+String Mongo::lookupName( const String& name )
+{
+    if( m_encryptedNames )
+    {
+        String hashedAssetName;
+        String encryptedAssetName;
+        Encryptors::Utils::SecureIdentifier::splitIdentifier( name, hashedAssetName, encryptedAssetName );
+        return hashedAssetName;
+    }
+
+    return name;
+}
+
+String Mongo::contentVersion( const String& data )
+{
+    Hashes::SHA256 hash;
+    hash.update( data.c_str(), data.length() );
+    char digest[hash.digestSize()];
+    hash.finalise( digest );
+
+    String encodedDigest( Base64encode_len( hash.digestSize() ), '\0' );
+    Base64encode( &encodedDigest[0], &digest[0], hash.digestSize() );
+    encodedDigest.resize( encodedDigest.length() - 1 );
+
+    return encodedDigest;
+}
+
 } // namespace AssetLoaders
 
 } // namespace Agape
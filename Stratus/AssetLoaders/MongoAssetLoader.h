@@ -41,7 +41,13 @@ public:
     virtual bool move( const String& newName );
     virtual bool erase();
 
+    virtual String version();
+    virtual bool revalidate( Vector< struct Revalidation >& revalidations );
+
 private:
+    String lookupName( const String& name );
+    static String contentVersion( const String& data );
+
     String m_collectionName;
     bool m_encryptedNames;
     Authenticator& m_authenticator;
@@ -50,6 +56,7 @@ private:
     enum OpenMode m_openMode;
 
     String m_linkedItem;
+    String m_version;
 
     String m_readBuffer;
     String m_writeBuffer;
@@ -1,6 +1,6 @@
-#include "Databases/MongoDB/MongoDB.h"
-#include "Databases/MongoDB/MongoDocumentBuilder.h"
+#include "AccountStores/AccountStore.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "Utils/base64/base64.h"
 #include "World/User.h"
 #include "World/WorldCoordinates.h"
@@ -14,31 +14,22 @@
 #include "TupleRouter.h"
 #include "Value.h"
 
-#include <bsoncxx/builder/stream/document.hpp>
-#include <bsoncxx/json.hpp>
-
-#include <mongocxx/client.hpp>
-#include <mongocxx/collection.hpp>
-#include <mongocxx/exception/exception.hpp>
-
 using namespace Agape::Linda2;
 
-using namespace Agape::Databases::MongoDB;
-
-using namespace bsoncxx::builder::stream;
-using namespace mongocxx;
-
 namespace Agape
 {
 
 namespace Stratus
 {
 
-Authenticator::Authenticator( TupleRouter& tupleRouter, KeyUtilities& keyUtilities ) :
+Authenticator::Authenticator( TupleRouter& tupleRouter, KeyUtilities& keyUtilities, AccountStore& accountStore, Authorisations& authorisations ) :
   m_tupleRouter( tupleRouter ),
   m_keyUtilities( keyUtilities ),
+  m_accountStore( accountStore ),
   m_credentialsValid( false ),
   m_isTela( false ),
+  m_isOperator( false ),
+  m_authorisationCache( authorisations, *this ),
   Native( "Authenticator" )
 {
     m_tupleRouter.registerActor( this );
@@ -114,6 +105,7 @@ bool Authenticator::accept( Tuple& tuple )
             {
                 validateCredentials();
                 cacheUserSnowflakes();
+                m_authorisationCache.setAccount( m_accountAuthKeyHash );
             }
         }
         else
@@ -129,6 +121,12 @@ bool Authenticator::accept( Tuple& tuple )
              ( tupleType == _WorldJoinResponse ) )
     {
         cacheUserSnowflakes();
+
+        // This account's memberships have changed, on all its connections.
+        if( !tuple.hasValue( _success ) || ( (int)tuple[_success] == 1 ) )
+        {
+            m_authorisationCache.invalidate();
+        }
     }
 
     return handled;
@@ -148,6 +146,11 @@ bool Authenticator::isTela() const
     return m_isTela;
 }
 
+bool Authenticator::isOperator() const
+{
+    return m_isOperator;
+}
+
 const String& Authenticator::updateStream() const
 {
     return m_updateStream;
@@ -169,50 +172,16 @@ bool Authenticator::joinedWorld( const String& worldID )
     return true;
 #endif // LOCUST
 
-    for( auto joinedWorldID : m_joinedWorldIDs )
-    {
-        if( joinedWorldID == worldID ) return true;
-    }
-
-    bool joined( false );
-    bool writable( false );
-    hasJoinedWorld( worldID, joined, writable );
-    if( joined )
-    {
-        m_joinedWorldIDs.push_back( worldID );
-    }
-    if( writable )
-    {
-        m_writableWorldIDs.push_back( worldID );
-    }
-
-    return joined;
+    return m_authorisationCache.decide( worldID ).m_joined;
 }
- 
+
 bool Authenticator::writableWorld( const String& worldID )
 {
 #ifdef LOCUST
     return true;
 #endif // LOCUST
 
-    for( auto writableWorldID : m_writableWorldIDs )
-    {
-        if( writableWorldID == worldID ) return true;
-    }
-
-    bool joined( false );
-    bool writable( false );
-    hasJoinedWorld( worldID, joined, writable );
-    if( joined )
-    {
-        m_joinedWorldIDs.push_back( worldID );
-    }
-    if( writable )
-    {
-        m_writableWorldIDs.push_back( worldID );
-    }
-
-    return writable;
+    return m_authorisationCache.decide( worldID ).m_writable;
 }
 
 bool Authenticator::isOurUser( const String& snowflake ) const
@@ -232,51 +201,44 @@ bool Authenticator::isOurUser( const String& snowflake ) const
 void Authenticator::validateCredentials()
 {
     bool validated( false );
-
-    try
-    {
-        auto client( MongoDB::pool().acquire() );
-        auto collection( ( *client )[_Agape][_Accounts] );
+    bool isOperator( false );
 
 #ifdef LOG_STRATUS
-        LOG_DEBUG( "Authenticator: Validating credentials: Account ID: " + m_accountAuthKeyHash + " Device ID: " + m_deviceAuthKeyHash );
+    LOG_DEBUG( "Authenticator: Validating credentials: Account ID: " + m_accountAuthKeyHash + " Device ID: " + m_deviceAuthKeyHash );
 #endif
 
-        // Try to find an account with the currently claimed
-        // accountAuthKeyHash and deviceAuthKeyHash.
-        bsoncxx::stdx::optional< bsoncxx::document::value > account(
-            collection.find_one(
-                document() << "authKeyHash" << m_accountAuthKeyHash
-                           << "devices.authKeyHash" << m_deviceAuthKeyHash << finalize
-            )
-        );
-
-        if( account )
-        {
+    // Try to find an account with the currently claimed
+    // accountAuthKeyHash and deviceAuthKeyHash.
+    Value accountValue;
+    bool found( false );
+    if( m_accountStore.findAccount( m_accountAuthKeyHash, m_deviceAuthKeyHash, accountValue, found ) && found )
+    {
 #ifdef LOG_STRATUS
-            LOG_DEBUG( "Authenticator: Authenticated successfully" );
+        LOG_DEBUG( "Authenticator: Authenticated successfully" );
 #endif
-            validated = true;
+        validated = true;
 
-            Value accountValue( DocumentBuilder::unbuild( *account ) );
-            m_isTela = ( accountValue[_telaDeviceAuthKeyHash] == m_deviceAuthKeyHash );
-            m_updateStream = accountValue[_updateStream];
-        }
-        else
-        {
-#ifdef LOG_STRATUS
-            LOG_DEBUG( "Authenticator: Account with ID " + m_accountAuthKeyHash + " and device with ID " + m_deviceAuthKeyHash + " not found." );
-#endif
-        }
+        m_isTela = ( accountValue[_telaDeviceAuthKeyHash] == m_deviceAuthKeyHash );
+        m_updateStream = accountValue[_updateStream];
+        isOperator = accountValue.hasValue( _operator ) && ( (int)accountValue[_operator] == 1 );
     }
-    catch( mongocxx::exception& e )
+    else
     {
 #ifdef LOG_STRATUS
-        LOG_DEBUG( "Authenticator: Exception attempting to find account with ID " + m_accountAuthKeyHash + " and device with ID " + m_deviceAuthKeyHash + ": " + String( e.what() ) );
+        LOG_DEBUG( "Authenticator: Account with ID " + m_accountAuthKeyHash + " and device with ID " + m_deviceAuthKeyHash + " not found." );
 #endif
     }
 
     m_credentialsValid = validated;
+    m_isOperator = isOperator;
+}
+
+bool Authenticator::lookup( const String& worldID, Authorisations::Decision& decision )
+{
+    METRICS_TIMED( "mongo.accounts.authorise" );
+
+    decision = Authorisations::Decision();
+    return hasJoinedWorld( worldID, decision.m_joined, decision.m_writable );
 }
 
 void Authenticator::cacheUserSnowflakes()
@@ -285,104 +247,56 @@ void Authenticator::cacheUserSnowflakes()
     LOG_DEBUG( "Authenticator: Caching user snowflakes" );
 #endif
 
-    try
+    // Tela sees the users on all of the account's devices.
+    Vector< String > snowflakes;
+    if( m_accountStore.findUserSnowflakes( accountAuthKeyHash(), isTela() ? String() : deviceAuthKeyHash(), snowflakes ) )
     {
-        auto client( MongoDB::pool().acquire() );
-        auto collection( ( *client )[_Agape][_Accounts] );
-
-        mongocxx::pipeline pipeline;
-        pipeline.match( document() << "authKeyHash" << accountAuthKeyHash()
-                                   << finalize );
-        pipeline.unwind( "$devices" );
-        if( !isTela() )
-        {
-            pipeline.match( document() << "devices.authKeyHash" << deviceAuthKeyHash()
-                                       << finalize );
-        }
-        pipeline.unwind( "$devices.joinedWorlds" );
-        pipeline.group( document() << "_id" << int(0)
-                                   << "snowflake" << open_document
-                                       << "$addToSet" << "$devices.joinedWorlds.user.snowflake"
-                                   << close_document
-                                   << finalize );
-
-        mongocxx::cursor aggregateCursor(
-            collection.aggregate( pipeline )
-        );
-
-        bsoncxx::document::view resultView( *aggregateCursor.begin() );
-        Value resultValue( DocumentBuilder::unbuild( resultView ) );
-        Value& snowflakes( resultValue[_snowflake] );
-        m_userSnowflakes.clear();
-        ConstListIterator it( snowflakes.listBegin() );
-        for( ; it != snowflakes.listEnd(); ++it )
-        {
-            m_userSnowflakes.push_back( **it );
-        }
-    }
-    catch( mongocxx::exception& e )
-    {
-#ifdef LOG_STRATUS
-        LOG_DEBUG( "Authenticator: Exception caching user snowflakes: " + String( e.what() ) );
-#endif
+        m_userSnowflakes.swap( snowflakes );
     }
 }
 
-void Authenticator::hasJoinedWorld( const String& worldID, bool& joined, bool& writable )
+bool Authenticator::hasJoinedWorld( const String& worldID, bool& joined, bool& writable )
 {
     // FIXME: There is a lot of commonality with MongoWorldLoader - we
     // perhaps need some sort of generic accounts collection code that
     // both can share.
 
-    try
-    {
-        auto client( MongoDB::pool().acquire() );
-        auto collection( ( *client )[_Agape][_Accounts] );
-
 #ifdef LOG_STRATUS
-        LOG_DEBUG( "Authenticator: Looking for joined world " + worldID );
+    LOG_DEBUG( "Authenticator: Looking for joined world " + worldID );
 #endif
 
-        // Look for account for current accountAuthKeyHash.
-        bsoncxx::stdx::optional< bsoncxx::document::value > account(
-            collection.find_one(
-                document() << "authKeyHash" << m_accountAuthKeyHash << finalize
-            )
-        );
-
-        if( account )
-        {
-            Value accountValue( DocumentBuilder::unbuild( *account ) );
+    // Look for account for current accountAuthKeyHash.
+    Value accountValue;
+    bool found( false );
+    bool success( m_accountStore.findAccount( m_accountAuthKeyHash, String(), accountValue, found ) );
 
-            // Look for device for current deviceAuthKeyHash.
-            Value& devicesValue( accountValue[_devices] );
-            Vector< Value* >::const_iterator devicesIt( devicesValue.listBegin() );
-            for( ; devicesIt != devicesValue.listEnd(); ++devicesIt )
-            {
-                // Try to find this worldID in the list of joined worlds for this device.
-                hasJoinedWorldWithDevice( *devicesIt, worldID, joined, writable );
-                if( joined ) break;
-            }
-        }
-        else
+    if( found )
+    {
+        // Look for device for current deviceAuthKeyHash.
+        Value& devicesValue( accountValue[_devices] );
+        Vector< Value* >::const_iterator devicesIt( devicesValue.listBegin() );
+        for( ; devicesIt != devicesValue.listEnd(); ++devicesIt )
         {
-#ifdef LOG_STRATUS
-            LOG_DEBUG( "Authenticator: Account with ID " + m_accountAuthKeyHash + " not found." );
-#endif
+            // Try to find this worldID in the list of joined worlds for this
+            // device. If a device's lookup fails another may still answer,
+            // but the answer is then unsure and mustn't be cached.
+            success = hasJoinedWorldWithDevice( *devicesIt, worldID, joined, writable ) && success;
+            if( joined && success ) break;
         }
     }
-    catch( mongocxx::exception& e )
+    else if( success )
     {
 #ifdef LOG_STRATUS
-        LOG_DEBUG( "Authenticator: Exception loading account: " + String( e.what() ) );
+        LOG_DEBUG( "Authenticator: Account with ID " + m_accountAuthKeyHash + " not found." );
 #endif
     }
+
+    return success;
 }
 
-void Authenticator::hasJoinedWorldWithDevice( const Value* deviceValue, const String& worldID, bool& joined, bool& writable )
+bool Authenticator::hasJoinedWorldWithDevice( const Value* deviceValue, const String& worldID, bool& joined, bool& writable )
 {
-    auto client( MongoDB::pool().acquire() );
-    auto worldsCollection( ( *client )[_Agape][_Worlds] );
+    bool success( true );
 
     // Iterate joined worlds list for device.
     const Value& joinedWorldsValue( ( *deviceValue )[_joinedWorlds] );
@@ -400,49 +314,38 @@ void Authenticator::hasJoinedWorldWithDevice( const Value* deviceValue, const St
 #endif
             joined = true;
 
-            try
+            // Load world and check if user is in the world's user list -
+            // if so, this world is writable for this account.
+            Value metadataValue;
+            bool found( false );
+            success = m_accountStore.findWorld( joinedWorldID, metadataValue, found );
+            if( found )
             {
-                // Load world and check if user is in the world's user list -
-                // if so, this world is writable for this account.
-                bsoncxx::stdx::optional< bsoncxx::document::value > world(
-                    worldsCollection.find_one(
-                        document() << "worldID" << joinedWorldID << finalize
-                    )
-                );
-
-                if( world )
+                World::Metadata metadata( World::Metadata::fromValue( metadataValue ) );
+                for( auto worldUser : metadata.m_users )
                 {
-                    Value metadataValue( DocumentBuilder::unbuild( *world ) );
-                    World::Metadata metadata( World::Metadata::fromValue( metadataValue ) );
-                    for( auto worldUser : metadata.m_users )
+                    if( worldUser.m_snowflake == accountUserSnowflake )
                     {
-                        if( worldUser.m_snowflake == accountUserSnowflake )
-                        {
-                            writable = true;
+                        writable = true;
 #ifdef LOG_STRATUS
-                            LOG_DEBUG( "Authenticator: World is writable." );
+                        LOG_DEBUG( "Authenticator: World is writable." );
 #endif
-                            break;
-                        }
+                        break;
                     }
                 }
-                else
-                {
-#ifdef LOG_STRATUS
-                    LOG_DEBUG( "Authenticator: Unable to find world for joined world ID " + joinedWorldID );
-#endif
-                }
             }
-            catch( mongocxx::exception& e )
+            else if( success )
             {
 #ifdef LOG_STRATUS
-                LOG_DEBUG( "Authenticator: Exception loading world with ID " + joinedWorldID + ": " + String( e.what() ) );
+                LOG_DEBUG( "Authenticator: Unable to find world for joined world ID " + joinedWorldID );
 #endif
             }
 
             break;
         }
     }
+
+    return success;
 }
 
 } // namespace Stratus
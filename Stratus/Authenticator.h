@@ -2,6 +2,7 @@
 #define AGAPE_STRATUS_AUTHENTICATOR_H
 
 #include "Actors/NativeActors/NativeActor.h"
+#include "Authorisations.h"
 #include "Collections.h"
 #include "String.h"
 
@@ -22,16 +23,19 @@ using namespace Linda2;
 namespace Stratus
 {
 
-class Authenticator : public Actors::Native
+class AccountStore;
+
+class Authenticator : public Actors::Native, public Authorisations::Store
 {
 public:
-    Authenticator( TupleRouter& tupleRouter, KeyUtilities& keyUtilities );
+    Authenticator( TupleRouter& tupleRouter, KeyUtilities& keyUtilities, AccountStore& accountStore, Authorisations& authorisations );
     virtual ~Authenticator();
 
     virtual bool accept( Tuple& tuple );
 
     bool credentialsValid() const;
     bool isTela() const;
+    bool isOperator() const; // Runs this service, e.g. may read its metrics.
 
     const String& updateStream() const;
 
@@ -43,25 +47,28 @@ public:
 
     bool isOurUser( const String& snowflake ) const;
 
+    virtual bool lookup( const String& worldID, Authorisations::Decision& decision );
+
 private:
     void validateCredentials();
     void cacheUserSnowflakes();
-    void hasJoinedWorld( const String& worldID, bool& joined, bool& writable );
-    void hasJoinedWorldWithDevice( const Value* deviceValue, const String& worldID, bool& joined, bool& writable );
+    bool hasJoinedWorld( const String& worldID, bool& joined, bool& writable );
+    bool hasJoinedWorldWithDevice( const Value* deviceValue, const String& worldID, bool& joined, bool& writable );
 
     TupleRouter& m_tupleRouter;
     KeyUtilities& m_keyUtilities;
+    AccountStore& m_accountStore;
 
     String m_accountAuthKeyHash;
     String m_deviceAuthKeyHash;
 
     bool m_credentialsValid;
     bool m_isTela;
+    bool m_isOperator;
 
     String m_updateStream;
 
-    Vector< String > m_joinedWorldIDs;
-    Vector< String > m_writableWorldIDs;
+    AuthorisationCache m_authorisationCache;
 
     Vector< String > m_userSnowflakes;
 };
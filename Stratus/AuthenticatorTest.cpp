@@ -0,0 +1,248 @@
+#ifdef AUTHENTICATOR_TEST
+
+#include "AccountStores/AccountStore.h"
+#include "Actors/NativeActors/NativeActor.h"
+#include "Encryptors/Factories/AESEncryptorFactory.h"
+#include "Encryptors/SHA256/SHA256Hash.h"
+#include "EntropySources/DummyEntropySource.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "TupleFilters/StratusTupleFilter.h"
+#include "TupleRoutes/QueueingTupleRoute.h"
+#include "Utils/base64/base64.h"
+#include "World/User.h"
+#include "World/WorldMetadata.h"
+#include "Authenticator.h"
+#include "Authorisations.h"
+#include "KeyUtilities.h"
+#include "StatsServer.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+#include "Value.h"
+
+#include <iostream>
+
+using namespace Agape;
+using Agape::Linda2::Tuple;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const char* _sharedWorldID( "WorldA" );
+
+    // Stands in for the accounts and worlds collections: one account on a
+    // phone and a tablet, each with its own user in the same world, of which
+    // only the phone's may build.
+    class FakeAccountStore : public Stratus::AccountStore
+    {
+    public:
+        FakeAccountStore() :
+          m_operator( false ),
+          m_failWorlds( 0 ),
+          m_worldQueries( 0 )
+        {
+        }
+
+        virtual bool findAccount( const String& accountAuthKeyHash,
+                                  const String& deviceAuthKeyHash,
+                                  Value& account,
+                                  bool& found )
+        {
+            account = Value();
+            account[_devices] = Vector< Value* >();
+            account[_devices].push_back( device( "phone", "PhoneUser" ) );
+            account[_devices].push_back( device( "tablet", "TabletUser" ) );
+            account[_updateStream] = "stable";
+            account[_operator] = m_operator ? 1 : 0;
+            found = true;
+            return true;
+        }
+
+        virtual bool findWorld( const String& worldID, Value& world, bool& found )
+        {
+            ++m_worldQueries;
+            found = false;
+            if( m_failWorlds > 0 )
+            {
+                --m_failWorlds;
+                return false;
+            }
+
+            World::Metadata metadata;
+            metadata.m_worldID = worldID;
+            World::User user;
+            user.m_snowflake = "PhoneUser";
+            metadata.m_users.push_back( user );
+            world = Value();
+            metadata.toValue( world );
+            found = true;
+            return true;
+        }
+
+        virtual bool findUserSnowflakes( const String& accountAuthKeyHash,
+                                         const String& deviceAuthKeyHash,
+                                         Vector< String >& snowflakes )
+        {
+            snowflakes.clear();
+            snowflakes.push_back( "PhoneUser" );
+            snowflakes.push_back( "TabletUser" );
+            return true;
+        }
+
+        bool m_operator;
+        int m_failWorlds; // How many world lookups fail before they recover.
+        int m_worldQueries;
+
+    private:
+        static Value* device( const char* authKeyHash, const char* snowflake )
+        {
+            Value* joinedWorld( new Value );
+            ( *joinedWorld )[_worldID] = _sharedWorldID;
+            ( *joinedWorld )[_user] = Value();
+            ( *joinedWorld )[_user][_snowflake] = snowflake;
+
+            Value* device( new Value );
+            ( *device )[_authKeyHash] = authKeyHash;
+            ( *device )[_joinedWorlds] = Vector< Value* >();
+            ( *device )[_joinedWorlds].push_back( joinedWorld );
+            return device;
+        }
+    };
+
+    String encoded( int size )
+    {
+        String key( size, 'k' );
+        String encodedKey( Base64encode_len( size ), '\0' );
+        Base64encode( &encodedKey[0], key.c_str(), size );
+        encodedKey.resize( encodedKey.length() - 1 );
+        return encodedKey;
+    }
+
+    void authenticate( Stratus::Authenticator& authenticator, KeyUtilities& keyUtilities )
+    {
+        Tuple authenticate;
+        TupleRouter::setTupleType( authenticate, _Authenticate );
+        authenticate[_accountAuthKey] = encoded( keyUtilities.accountSubKeySize() );
+        authenticate[_deviceAuthKey] = encoded( keyUtilities.deviceAuthKeySize() );
+        authenticator.accept( authenticate );
+    }
+
+    // The operator's dashboard, on the client side of a handler.
+    class StatsClient : public Linda2::Actors::Native
+    {
+    public:
+        StatsClient( TupleRouter& tupleRouter ) :
+          Native( "StatsClient" ),
+          m_tupleRouter( tupleRouter ),
+          m_responses( 0 ),
+          m_success( false )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        ~StatsClient()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            if( TupleRouter::tupleType( tuple ) == _StatsResponse )
+            {
+                ++m_responses;
+                m_success = ( (int)tuple[_success] == 1 ) && tuple.hasValue( _stats );
+                return true;
+            }
+
+            return false;
+        }
+
+        int m_responses;
+        bool m_success;
+
+    private:
+        TupleRouter& m_tupleRouter;
+    };
+
+    // Sends a StatsRequest in from the client, through the Stratus tuple
+    // filter, and returns what came back: 1 for stats, 0 for a refusal or -1
+    // if the request never reached the StatsServer.
+    int requestStats( bool isOperator )
+    {
+        Timers::Factories::HighRes timerFactory;
+        Linda2::TupleDispatcher tupleDispatcher;
+        TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+        EntropySources::Dummy entropySource;
+        Encryptors::Factories::AES encryptorFactory( entropySource );
+        Hashes::SHA256 hash;
+        KeyUtilities keyUtilities( entropySource, encryptorFactory, hash );
+        FakeAccountStore accountStore;
+        accountStore.m_operator = isOperator;
+        Stratus::Authorisations authorisations( timerFactory );
+        Stratus::Authenticator authenticator( tupleRouter, keyUtilities, accountStore, authorisations );
+        Stratus::StatsServer statsServer( tupleRouter, authenticator );
+        StatsClient statsClient( tupleRouter );
+        Linda2::TupleFilters::Stratus tupleFilter( authenticator );
+        Linda2::TupleRoutes::Queueing clientRoute( "Client" );
+        tupleRouter.addRoute( &clientRoute, false );
+        tupleRouter.setTupleFilter( &tupleFilter );
+
+        authenticate( authenticator, keyUtilities );
+
+        Tuple request;
+        TupleRouter::setTupleType( request, _StatsRequest );
+        TupleRouter::setSourceActor( request, "StatsClient" );
+        TupleRouter::setSourceID( request, "Client" );
+        clientRoute.enqueue( request );
+        tupleRouter.run();
+
+        tupleRouter.removeRoute( &clientRoute );
+        tupleRouter.setTupleFilter( nullptr );
+
+        if( statsClient.m_responses != 1 ) return -1;
+        return statsClient.m_success ? 1 : 0;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    Timers::Factories::HighRes timerFactory;
+    Linda2::TupleDispatcher tupleDispatcher;
+    TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+    EntropySources::Dummy entropySource;
+    Encryptors::Factories::AES encryptorFactory( entropySource );
+    Hashes::SHA256 hash;
+    KeyUtilities keyUtilities( entropySource, encryptorFactory, hash );
+    FakeAccountStore accountStore;
+    Stratus::Authorisations authorisations( timerFactory );
+    Stratus::Authenticator authenticator( tupleRouter, keyUtilities, accountStore, authorisations );
+
+    authenticate( authenticator, keyUtilities );
+
+    bool authenticated( authenticator.credentialsValid() && authenticator.isOurUser( "TabletUser" ) );
+    std::cout << "Authenticated: " << ( authenticated ? "OK" : "FAILED" ) << std::endl;
+
+    // The phone's world lookup fails and the tablet's answers read-only. That
+    // mustn't stick: the next decision asks again and finds the phone may
+    // build, and only then is it cached.
+    accountStore.m_failWorlds = 1;
+    bool unsure( !authenticator.writableWorld( _sharedWorldID ) && ( accountStore.m_worldQueries == 2 ) );
+    bool recovered( authenticator.writableWorld( _sharedWorldID ) && ( accountStore.m_worldQueries == 3 ) );
+    bool cached( authenticator.writableWorld( _sharedWorldID ) && ( accountStore.m_worldQueries == 3 ) );
+    bool failed( unsure && recovered && cached );
+    std::cout << "One device's lookup fails: " << ( failed ? "OK" : "FAILED" ) << std::endl;
+
+    // Stats requests carry no world, so the filter lets them through on
+    // their type and leaves StatsServer to refuse anyone but an operator.
+    bool stats( ( requestStats( true ) == 1 ) && ( requestStats( false ) == 0 ) );
+    std::cout << "Stats for operators only: " << ( stats ? "OK" : "FAILED" ) << std::endl;
+
+    bool success( authenticated && failed && stats );
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+
+    return success ? 0 : 1;
+}
+
+#endif // AUTHENTICATOR_TEST
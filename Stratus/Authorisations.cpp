@@ -0,0 +1,288 @@
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Authorisations.h"
+#include "Collections.h"
+#include "String.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+    const long _defaultGrantedms( 60000 );
+    const long _defaultRefusedms( 10000 );
+
+    // Expired entries are only swept out this often, as most are replaced
+    // before they are found again anyway.
+    const int _storesPerSweep( 1024 );
+
+    // A connection that wanders through more worlds than this just starts
+    // again.
+    const unsigned int _maxLocalEntries( 256 );
+
+    const Agape::String _separator( "\n" );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Stratus
+{
+
+Authorisations::Authorisations( Timers::Factory& timerFactory ) :
+  m_timer( timerFactory.makeTimer() ),
+  m_grantedms( _defaultGrantedms ),
+  m_refusedms( _defaultRefusedms ),
+  m_storesSinceSweep( 0 ),
+  m_generation( 0 ),
+  m_localHits( 0 ),
+  m_sharedHits( 0 ),
+  m_refusalHits( 0 ),
+  m_misses( 0 ),
+  m_expired( 0 ),
+  m_invalidations( 0 )
+{
+}
+
+Authorisations::~Authorisations()
+{
+    delete( m_timer );
+}
+
+void Authorisations::setTTLs( long grantedms, long refusedms )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    m_grantedms = grantedms;
+    m_refusedms = refusedms;
+}
+
+bool Authorisations::find( const String& account, const String& worldID, Decision& decision, long& expiresms )
+{
+    long nowms( ms() );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    Map< String, Entry >::iterator it( m_entries.find( account + _separator + worldID ) );
+    if( it == m_entries.end() )
+    {
+        ++m_misses;
+        return false;
+    }
+
+    if( it->second.m_expiresms <= nowms )
+    {
+        m_entries.erase( it );
+        ++m_expired;
+        ++m_misses;
+        return false;
+    }
+
+    decision = it->second.m_decision;
+    expiresms = it->second.m_expiresms;
+
+    ++m_sharedHits;
+    if( !decision.m_joined ) ++m_refusalHits;
+
+    return true;
+}
+
+bool Authorisations::store( const String& account, const String& worldID, const Decision& decision, long generation, long accountGeneration, long& expiresms )
+{
+    long nowms( ms() );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    // Memberships changed while the caller was asking, so what it was told
+    // may be stale.
+    Map< String, std::atomic< long > >::const_iterator it( m_accountGenerations.find( account ) );
+    if( ( generation != m_generation ) ||
+        ( accountGeneration != ( ( it != m_accountGenerations.end() ) ? it->second.load() : 0 ) ) )
+    {
+        return false;
+    }
+
+    if( ++m_storesSinceSweep >= _storesPerSweep )
+    {
+        sweep( nowms );
+    }
+
+    Entry& entry( m_entries[account + _separator + worldID] );
+    entry.m_decision = decision;
+    entry.m_expiresms = nowms + ( decision.m_joined ? m_grantedms : m_refusedms );
+    expiresms = entry.m_expiresms;
+
+    return true;
+}
+
+void Authorisations::invalidate( const String& account )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    String prefix( account + _separator );
+    Map< String, Entry >::iterator it( m_entries.lower_bound( prefix ) );
+    while( ( it != m_entries.end() ) && ( it->first.compare( 0, prefix.length(), prefix ) == 0 ) )
+    {
+        it = m_entries.erase( it );
+    }
+
+    ++m_accountGenerations[account];
+    ++m_invalidations;
+}
+
+void Authorisations::revoke( const String& worldID )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    String suffix( _separator + worldID );
+    Map< String, Entry >::iterator it( m_entries.begin() );
+    while( it != m_entries.end() )
+    {
+        if( ( it->first.length() >= suffix.length() ) &&
+            ( it->first.compare( it->first.length() - suffix.length(), suffix.length(), suffix ) == 0 ) )
+        {
+            it = m_entries.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    ++m_generation;
+    ++m_invalidations;
+}
+
+long Authorisations::ms()
+{
+    return m_timer->ms();
+}
+
+long Authorisations::generation() const
+{
+    return m_generation;
+}
+
+const std::atomic< long >& Authorisations::accountGeneration( const String& account )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_accountGenerations[account];
+}
+
+Authorisations::Counters Authorisations::counters() const
+{
+    Counters counters;
+    counters.m_localHits = m_localHits;
+    counters.m_sharedHits = m_sharedHits;
+    counters.m_refusalHits = m_refusalHits;
+    counters.m_misses = m_misses;
+    counters.m_expired = m_expired;
+    counters.m_invalidations = m_invalidations;
+    return counters;
+}
+
+void Authorisations::sweep( long nowms )
+{
+    m_storesSinceSweep = 0;
+
+    Map< String, Entry >::iterator it( m_entries.begin() );
+    while( it != m_entries.end() )
+    {
+        if( it->second.m_expiresms <= nowms )
+        {
+            it = m_entries.erase( it );
+            ++m_expired;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+AuthorisationCache::AuthorisationCache( Authorisations& authorisations, Authorisations::Store& store ) :
+  m_authorisations( authorisations ),
+  m_store( store ),
+  m_generation( authorisations.generation() ),
+  m_accountGenerationSource( nullptr ),
+  m_accountGeneration( 0 )
+{
+}
+
+void AuthorisationCache::setAccount( const String& account )
+{
+    if( account != m_account )
+    {
+        m_account = account;
+        m_entries.clear();
+
+        m_accountGenerationSource = account.empty() ? nullptr : &m_authorisations.accountGeneration( account );
+        m_accountGeneration = m_accountGenerationSource ? m_accountGenerationSource->load() : 0;
+    }
+}
+
+Authorisations::Decision AuthorisationCache::decide( const String& worldID )
+{
+    // Nothing to ask about.
+    if( m_account.empty() || worldID.empty() )
+    {
+        return Authorisations::Decision();
+    }
+
+    long generation( m_authorisations.generation() );
+    long accountGeneration( *m_accountGenerationSource );
+    if( ( generation != m_generation ) || ( accountGeneration != m_accountGeneration ) )
+    {
+        m_entries.clear();
+        m_generation = generation;
+        m_accountGeneration = accountGeneration;
+    }
+
+    long nowms( m_authorisations.ms() );
+
+    Map< String, Entry >::iterator it( m_entries.find( worldID ) );
+    if( it != m_entries.end() )
+    {
+        if( it->second.m_expiresms > nowms )
+        {
+            ++m_authorisations.m_localHits;
+            if( !it->second.m_decision.m_joined ) ++m_authorisations.m_refusalHits;
+            return it->second.m_decision;
+        }
+
+        m_entries.erase( it );
+        ++m_authorisations.m_expired;
+    }
+
+    Entry entry;
+    if( !m_authorisations.find( m_account, worldID, entry.m_decision, entry.m_expiresms ) )
+    {
+        if( !m_store.lookup( worldID, entry.m_decision ) ||
+            !m_authorisations.store( m_account, worldID, entry.m_decision, generation, accountGeneration, entry.m_expiresms ) )
+        {
+            return entry.m_decision; // Use it just this once.
+        }
+    }
+
+    if( m_entries.size() >= _maxLocalEntries )
+    {
+        m_entries.clear();
+    }
+    m_entries[worldID] = entry;
+
+    return entry.m_decision;
+}
+
+void AuthorisationCache::invalidate()
+{
+    m_entries.clear();
+    if( !m_account.empty() )
+    {
+        m_authorisations.invalidate( m_account );
+        m_accountGeneration = *m_accountGenerationSource;
+    }
+}
+
+} // namespace Stratus
+
+} // namespace Agape
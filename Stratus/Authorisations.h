@@ -0,0 +1,160 @@
+#ifndef AGAPE_STRATUS_AUTHORISATIONS_H
+#define AGAPE_STRATUS_AUTHORISATIONS_H
+
+#include "Collections.h"
+#include "String.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Agape
+{
+
+class Timer;
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+namespace Stratus
+{
+
+/// @brief Which worlds each account has joined, and which it may write to, as
+/// last read from the database, shared by all connections so that a user's
+/// devices, and every tuple broadcast to a busy world, don't each go back to
+/// the database. Refusals are cached too, for less time, as tuples for worlds
+/// a user hasn't joined tend to arrive in floods. Decisions expire, and are
+/// dropped as soon as an account's memberships change, by that account's
+/// connections alone, or by everyone's when a world revokes membership.
+class Authorisations
+{
+public:
+    struct Decision
+    {
+        Decision() : m_joined( false ), m_writable( false ) {}
+
+        bool m_joined;
+        bool m_writable;
+    };
+
+    /// @brief Where decisions come from when they aren't cached, for the
+    /// account of the connection asking. Returns false if it couldn't tell,
+    /// in which case the decision is used but not cached.
+    class Store
+    {
+    public:
+        virtual ~Store() {}
+
+        virtual bool lookup( const String& worldID, Decision& decision ) = 0;
+    };
+
+    struct Counters
+    {
+        long m_localHits;
+        long m_sharedHits;
+        long m_refusalHits; // Hits of either kind that refused.
+        long m_misses;
+        long m_expired;
+        long m_invalidations;
+    };
+
+    Authorisations( Timers::Factory& timerFactory );
+    ~Authorisations();
+
+    void setTTLs( long grantedms, long refusedms );
+
+    bool find( const String& account, const String& worldID, Decision& decision, long& expiresms );
+
+    // Fails, storing nothing, if there has been a revocation since
+    // generation, or the account has been invalidated since
+    // accountGeneration.
+    bool store( const String& account, const String& worldID, const Decision& decision, long generation, long accountGeneration, long& expiresms );
+
+    // When an account joins, creates or leaves worlds.
+    void invalidate( const String& account );
+
+    // When a world's membership changes for everyone, e.g. on a ban.
+    void revoke( const String& worldID );
+
+    long ms();
+    long generation() const;
+
+    // Lives as long as this does, so that connections can check it without
+    // taking the lock.
+    const std::atomic< long >& accountGeneration( const String& account );
+
+    Counters counters() const;
+
+private:
+    friend class AuthorisationCache;
+
+    struct Entry
+    {
+        Decision m_decision;
+        long m_expiresms;
+    };
+
+    void sweep( long nowms );
+
+    Timer* m_timer;
+    long m_grantedms;
+    long m_refusedms;
+
+    // Keyed by account then world ID, so that an account's entries are
+    // adjacent.
+    Map< String, Entry > m_entries;
+    int m_storesSinceSweep;
+    mutable std::mutex m_mutex;
+
+    // Bumped on every revocation, so that all connections know to drop their
+    // own copies, and per account on its invalidation, for its connections
+    // alone. Accounts are never erased, so references stay valid.
+    std::atomic< long > m_generation;
+    Map< String, std::atomic< long > > m_accountGenerations;
+
+    std::atomic< long > m_localHits;
+    std::atomic< long > m_sharedHits;
+    std::atomic< long > m_refusalHits;
+    std::atomic< long > m_misses;
+    std::atomic< long > m_expired;
+    std::atomic< long > m_invalidations;
+};
+
+/// @brief One connection's view of Authorisations, for its account. Keeps its
+/// own copy of recent decisions, so that filtering a tuple normally takes no
+/// lock and makes no query.
+class AuthorisationCache
+{
+public:
+    AuthorisationCache( Authorisations& authorisations, Authorisations::Store& store );
+
+    void setAccount( const String& account );
+
+    Authorisations::Decision decide( const String& worldID );
+
+    // This account's memberships have changed, everywhere.
+    void invalidate();
+
+private:
+    struct Entry
+    {
+        Authorisations::Decision m_decision;
+        long m_expiresms;
+    };
+
+    Authorisations& m_authorisations;
+    Authorisations::Store& m_store;
+
+    String m_account;
+    Map< String, Entry > m_entries;
+    long m_generation;
+    const std::atomic< long >* m_accountGenerationSource; // Null if no account.
+    long m_accountGeneration;
+};
+
+} // namespace Stratus
+
+} // namespace Agape
+
+#endif // AGAPE_STRATUS_AUTHORISATIONS_H
@@ -0,0 +1,230 @@
+#ifdef AUTHORISATIONS_TEST
+
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Authorisations.h"
+#include "Collections.h"
+#include "String.h"
+
+#include <iostream>
+#include <set>
+#include <string>
+
+using namespace Agape;
+using Agape::Stratus::AuthorisationCache;
+using Agape::Stratus::Authorisations;
+
+namespace
+{
+    const int _sessionTuples( 20000 );
+    const int _msPerTuple( 2 ); // So the session outlasts both TTLs.
+    const char* _worldIDs[] = { "WorldA", "WorldB", "WorldC", "WorldD", "WorldE", "WorldF" };
+    const int _numWorlds( sizeof( _worldIDs ) / sizeof( _worldIDs[0] ) );
+
+    long _nowms( 0 );
+
+    class FakeTimer : public Timer
+    {
+    public:
+        virtual long ms() { return _nowms; }
+        virtual void reset() {}
+    };
+
+    class FakeTimerFactory : public Timers::Factory
+    {
+    public:
+        virtual Timer* makeTimer() { return new FakeTimer; }
+    };
+
+    // Stands in for the accounts and worlds collections.
+    class Worlds
+    {
+    public:
+        Worlds() : m_queries( 0 ) {}
+
+        void join( const String& account, const String& worldID, bool writable )
+        {
+            m_joined.insert( key( account, worldID ) );
+            if( writable ) m_writable.insert( key( account, worldID ) );
+        }
+
+        void leave( const String& account, const String& worldID )
+        {
+            m_joined.erase( key( account, worldID ) );
+            m_writable.erase( key( account, worldID ) );
+        }
+
+        Authorisations::Decision truth( const String& account, const String& worldID ) const
+        {
+            Authorisations::Decision decision;
+            decision.m_joined = ( m_joined.count( key( account, worldID ) ) != 0 );
+            decision.m_writable = ( m_writable.count( key( account, worldID ) ) != 0 );
+            return decision;
+        }
+
+        int m_queries;
+
+    private:
+        static std::string key( const String& account, const String& worldID )
+        {
+            return std::string( account.c_str() ) + "/" + worldID.c_str();
+        }
+
+        std::set< std::string > m_joined;
+        std::set< std::string > m_writable;
+    };
+
+    // A client connection: what its Authenticator asks of the database.
+    class Connection : public Authorisations::Store
+    {
+    public:
+        Connection( Worlds& worlds, Authorisations& authorisations, const String& account ) :
+          m_worlds( worlds ),
+          m_account( account ),
+          m_cache( authorisations, *this ),
+          m_meanwhile( nullptr )
+        {
+            m_cache.setAccount( account );
+        }
+
+        virtual bool lookup( const String& worldID, Authorisations::Decision& decision )
+        {
+            ++m_worlds.m_queries;
+            if( m_meanwhile )
+            {
+                // Another connection's memberships change mid-query.
+                m_meanwhile->m_cache.invalidate();
+                m_meanwhile = nullptr;
+            }
+            decision = m_worlds.truth( m_account, worldID );
+            return true;
+        }
+
+        // As StratusTupleFilter, for a tuple from the given world.
+        bool filter( const String& worldID, bool forward )
+        {
+            Authorisations::Decision decision( m_cache.decide( worldID ) );
+            Authorisations::Decision truth( m_worlds.truth( m_account, worldID ) );
+            return forward ? ( decision.m_writable == truth.m_writable ) : ( decision.m_joined == truth.m_joined );
+        }
+
+        Worlds& m_worlds;
+        String m_account;
+        AuthorisationCache m_cache;
+        Connection* m_meanwhile;
+    };
+
+    // A day in the life of a server: two accounts, one on two devices,
+    // receiving broadcasts from worlds some have joined and some haven't,
+    // occasionally moving or building, joining a world part way through and
+    // being banned from another. Returns the number of wrong decisions.
+    int replay( Worlds& worlds, Authorisations& authorisations, Vector< Connection* >& connections, int& decisions )
+    {
+        int wrong( 0 );
+        unsigned int seed( 1 );
+
+        for( int i( 0 ); i < _sessionTuples; ++i )
+        {
+            _nowms += _msPerTuple;
+
+            if( i == ( _sessionTuples / 3 ) )
+            {
+                // The phone joins world C, through a WorldJoinResponse.
+                worlds.join( "alice", _worldIDs[2], true );
+                connections[0]->m_cache.invalidate();
+            }
+            else if( i == ( 2 * _sessionTuples / 3 ) )
+            {
+                // Bob is banned from world A.
+                worlds.leave( "bob", _worldIDs[0] );
+                authorisations.revoke( _worldIDs[0] );
+            }
+
+            seed = seed * 1103515245 + 12345;
+            Connection* connection( connections[( seed >> 16 ) % connections.size()] );
+            seed = seed * 1103515245 + 12345;
+            int world( ( seed >> 16 ) % _numWorlds );
+            bool forward( ( ( seed >> 8 ) % 10 ) == 0 );
+
+            if( !connection->filter( _worldIDs[world], forward ) )
+            {
+                ++wrong;
+            }
+            ++decisions;
+        }
+
+        return wrong;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    Worlds worlds;
+    worlds.join( "alice", _worldIDs[0], true );
+    worlds.join( "alice", _worldIDs[1], false );
+    worlds.join( "bob", _worldIDs[0], true );
+    worlds.join( "bob", _worldIDs[3], true );
+
+    FakeTimerFactory timerFactory;
+    Authorisations authorisations( timerFactory );
+
+    Vector< Connection* > connections;
+    connections.push_back( new Connection( worlds, authorisations, "alice" ) ); // Phone.
+    connections.push_back( new Connection( worlds, authorisations, "alice" ) ); // Tablet.
+    connections.push_back( new Connection( worlds, authorisations, "bob" ) );
+
+    int decisions( 0 );
+    int wrong( replay( worlds, authorisations, connections, decisions ) );
+
+    Authorisations::Counters counters( authorisations.counters() );
+    std::cout << decisions << " decisions, " << worlds.m_queries << " queries" << std::endl;
+    std::cout << "Local hits " << counters.m_localHits
+              << ", shared hits " << counters.m_sharedHits
+              << ", refusal hits " << counters.m_refusalHits
+              << ", misses " << counters.m_misses
+              << ", expired " << counters.m_expired
+              << ", invalidations " << counters.m_invalidations << std::endl;
+
+    bool correct( wrong == 0 );
+    std::cout << "Decisions match the store: " << ( correct ? "OK" : "FAILED" ) << std::endl;
+
+    // Every query is either a miss shared by all an account's devices, or a
+    // refresh after expiry or invalidation.
+    bool cached( ( worlds.m_queries == counters.m_misses ) &&
+                 ( worlds.m_queries < ( decisions / 100 ) ) );
+    std::cout << "Queries: " << ( cached ? "OK" : "FAILED" ) << std::endl;
+
+    // Once everything has expired, what the phone finds out the tablet
+    // needn't ask again.
+    _nowms += 120000;
+    connections[0]->m_cache.decide( _worldIDs[2] );
+    int queries( worlds.m_queries );
+    Authorisations::Decision decision( connections[1]->m_cache.decide( _worldIDs[2] ) );
+    bool shared( decision.m_joined && ( worlds.m_queries == queries ) );
+    std::cout << "Shared between devices: " << ( shared ? "OK" : "FAILED" ) << std::endl;
+
+    // Alice's memberships changing, even while Bob is asking about a world,
+    // leaves Bob's decisions cached, his own and the shared ones.
+    connections[2]->m_cache.decide( _worldIDs[3] );
+    long localHits( authorisations.counters().m_localHits );
+    connections[0]->m_cache.invalidate();
+    connections[2]->m_cache.decide( _worldIDs[3] );
+    bool isolated( authorisations.counters().m_localHits == localHits + 1 );
+
+    connections[2]->m_meanwhile = connections[0];
+    connections[2]->m_cache.decide( _worldIDs[4] );
+    queries = worlds.m_queries;
+    Connection bobTablet( worlds, authorisations, "bob" );
+    bobTablet.m_cache.decide( _worldIDs[4] );
+    isolated = isolated && ( worlds.m_queries == queries );
+    std::cout << "Isolated between accounts: " << ( isolated ? "OK" : "FAILED" ) << std::endl;
+
+    for( Vector< Connection* >::iterator it( connections.begin() ); it != connections.end(); ++it )
+    {
+        delete( *it );
+    }
+
+    return( ( correct && cached && shared && isolated ) ? 0 : 1 );
+}
+
+#endif // AUTHORISATIONS_TEST
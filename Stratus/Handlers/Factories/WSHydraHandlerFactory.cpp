@@ -2,6 +2,7 @@
 #include "AssetLoaders/Linda2AssetLoaderResponder.h"
 #include "Clocks/Clock.h"
 #include "Clocks/CClock.h"
+#include "Compressors/LZCompressor.h"
 #include "Encryptors/AES/AESEncryptor.h"
 #include "Encryptors/Factories/AESEncryptorFactory.h"
 #include "Encryptors/Factories/EncryptorsFactory.h"
@@ -9,6 +10,7 @@
 #include "EntropySources/DevRandom.h"
 #include "Handlers/WSHydraHandler.h"
 #include "Handlers/Factories/WSHydraHandlerFactory.h"
+#include "Metrics/Registry.h"
 #include "Network/WebSocketsConnection.h"
 #include "PresenceLoaders/Factories/SharedPresenceLoaderFactory.h"
 #include "PresenceLoaders/Linda2PresenceLoaderResponder.h"
@@ -31,14 +33,25 @@
 #include "KeyUtilities.h"
 #include "PushNotifier.h"
 #include "RWBuffer.h"
+#include "RWCompressor.h"
+#include "StatsServer.h"
 #include "TupleDispatcher.h"
 #include "TupleRouter.h"
 #include "TupleRoutingCriteria.h"
+#include "UpdateImages.h"
 #include "Updater.h"
 #include "WebSockets.h"
 
 #include <sstream>
 
+namespace
+{
+    const int _flushDeadline( 5 ); // ms
+    const int _flushSize( 4096 ); // One compressed block.
+    const int _clientQueueCapacity( 4096 ); // Tuples from Hydra to the client.
+    const int _hydraQueueCapacity( 16384 ); // Tuples from the client to Hydra.
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -50,7 +63,7 @@ HandlerFactory::HandlerFactory() :
 {
 }
 
-Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hydra& hydra, PresenceLoaders::SharedPresenceStore& sharedPresenceStore )
+Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hydra& hydra, PresenceLoaders::SharedPresenceStore& sharedPresenceStore, UpdateImages& updateImages, AccountStore& accountStore, Authorisations& authorisations )
 {
     String machineID( uintToHex( rand() ) );
 
@@ -68,7 +81,7 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hy
     Clocks::C* _clock( new Clocks::C );
     Linda2::TupleRouter* tupleRouter( new TupleRouter( *tupleDispatcher, clientName, *timerFactory ) );
     KeyUtilities* keyUtilities( new KeyUtilities( *entropySource, *encryptorFactory, *hash ) );
-    Authenticator* authenticator( new Authenticator( *tupleRouter, *keyUtilities ) );
+    Authenticator* authenticator( new Authenticator( *tupleRouter, *keyUtilities, accountStore, authorisations ) );
     AssetLoaders::Factory* assetLoaderFactory( new AssetLoaders::Factories::Mongo( "Assets", true, *authenticator ) ); // true = encrypted names
     AssetLoaders::Linda2Responder* assetLoaderResponder( new AssetLoaders::Linda2Responder( *tupleRouter, *assetLoaderFactory, "Assets" ) );
     AssetLoaders::Factory* programAssetLoaderFactory( new AssetLoaders::Factories::Mongo( "Programs", true, *authenticator ) ); // true = encrypted names
@@ -84,15 +97,34 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hy
     WorldLoaders::Factory* worldLoaderFactory( new WorldLoaders::Factories::Mongo( *authenticator ) );
     WorldLoaders::Linda2Responder* worldLoaderResponder( new WorldLoaders::Linda2Responder( *tupleRouter, *worldLoaderFactory ) );
     Network::WebSocketsConnection* webSocketsConnection( new Network::WebSocketsConnection( connection ) );
-    RWBuffer* rwBuffer( new RWBuffer( 1024, *webSocketsConnection ) );
+    RWBuffer* rwBuffer( new RWBuffer( 8192, *webSocketsConnection ) ); // Holds a whole coalesced batch, so it goes as one message.
     //RWBuffer* rwBuffer( new RWBuffer( 128, *webSocketsConnection ) );
-    Linda2::TupleRoute* incomingTupleRoute( new Linda2::TupleRoutes::ReadableWritable( clientName, *rwBuffer ) );
+    Compressor* compressor( new Compressors::LZ );
+    RWCompressor* rwCompressor( new RWCompressor( *compressor, *rwBuffer, true, true ) ); // true = compress output, true = detect older, uncompressed clients.
+    Linda2::TupleRoutes::ReadableWritable* incomingTupleRoute( new Linda2::TupleRoutes::ReadableWritable( clientName, *rwCompressor ) );
     //Linda2::TupleRoute* incomingTupleRoute( new Linda2::TupleRoutes::ReadableWritable( handlerID + "<->H" + handlerID, *webSocketsConnection ) );
     Linda2::TupleRoutes::Queueing* hydraNearTupleRoute( new Linda2::TupleRoutes::Queueing( "Hydra" ) );
     Linda2::TupleRoutes::Queueing* hydraFarTupleRoute( new Linda2::TupleRoutes::Queueing( clientName ) );
     Inviter* inviter( new Inviter( *tupleRouter, *authenticator ) );
     PushNotifier* pushNotifier( new PushNotifier( *tupleRouter, *authenticator, sharedPresenceStore, *telegramLoaderFactory, *webSocketsConnection ) );
-    Updater* updater( new Updater( *tupleRouter, *authenticator ) );
+    Updater* updater( new Updater( *tupleRouter, *authenticator, updateImages ) );
+    StatsServer* statsServer( new StatsServer( *tupleRouter, *authenticator ) );
+
+    // From Hydra to a slow client, keep only the latest clock and moves,
+    // and shed the oldest beyond that. From the client to Hydra only moves
+    // and the clock may be shed; blocking there would stall before the
+    // handler signals Hydra, so anything else overflowing disconnects.
+    hydraNearTupleRoute->setCapacity( _clientQueueCapacity, Linda2::TupleRoutes::Queueing::overflowCoalesce );
+    hydraNearTupleRoute->addCoalescingKey( _Time );
+    hydraNearTupleRoute->addCoalescingKey( _Moved, _sourceID );
+    hydraFarTupleRoute->setCapacity( _hydraQueueCapacity, Linda2::TupleRoutes::Queueing::overflowDropKeyed );
+    hydraFarTupleRoute->addCoalescingKey( _Time );
+    hydraFarTupleRoute->addCoalescingKey( _Moved, _sourceID );
+
+    // How long tuples wait for Hydra, and then for this client's handler.
+    Metrics::Registry& metrics( Metrics::Registry::getInstance() );
+    hydraFarTupleRoute->setWaitHistogram( &metrics.histogram( "queue.hydra.wait" ) );
+    hydraNearTupleRoute->setWaitHistogram( &metrics.histogram( "queue.client.wait" ) );
 
     hydraNearTupleRoute->setPartner( hydraFarTupleRoute );
     hydraFarTupleRoute->setPartner( hydraNearTupleRoute );
@@ -101,6 +133,10 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hy
 
     tupleRouter->setMyID( machineID );
 
+    // Coalesce bursts (ticks, presence) bound for the client into fewer,
+    // larger WebSocket messages.
+    incomingTupleRoute->setCoalescing( *timerFactory, _flushDeadline, _flushSize );
+
     tupleRouter->addRoute( incomingTupleRoute, false );
     tupleRouter->addRoute( hydraNearTupleRoute, true ); // Default route.
 
@@ -140,6 +176,8 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hy
                         tupleRouter,
                         webSocketsConnection,
                         rwBuffer,
+                        compressor,
+                        rwCompressor,
                         incomingTupleRoute,
                         hydra,
                         hydraNearTupleRoute,
@@ -148,7 +186,8 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Hy
                         _clock,
                         inviter,
                         pushNotifier,
-                        updater );
+                        updater,
+                        statsServer );
 }
 
 } // namespace Stratus
@@ -15,14 +15,17 @@ class SharedPresenceStore;
 namespace Stratus
 {
 
+class AccountStore;
+class Authorisations;
 class Hydra;
+class UpdateImages;
 
 class HandlerFactory
 {
 public:
     HandlerFactory();
 
-    Handler* makeHandler( ::WSTLSServer::connection_ptr connection, Hydra& hydra, PresenceLoaders::SharedPresenceStore& sharedPresenceStore );
+    Handler* makeHandler( ::WSTLSServer::connection_ptr connection, Hydra& hydra, PresenceLoaders::SharedPresenceStore& sharedPresenceStore, UpdateImages& updateImages, AccountStore& accountStore, Authorisations& authorisations );
 
 private:
     int m_clientNumber;
@@ -2,6 +2,7 @@
 #include "AssetLoaders/Linda2AssetLoaderResponder.h"
 #include "Clocks/Clock.h"
 #include "Clocks/CClock.h"
+#include "Compressors/LZCompressor.h"
 #include "Encryptors/AES/AESEncryptor.h"
 #include "Encryptors/Factories/AESEncryptorFactory.h"
 #include "Encryptors/Factories/EncryptorsFactory.h"
@@ -30,9 +31,12 @@
 #include "KeyUtilities.h"
 #include "PushNotifier.h"
 #include "RWBuffer.h"
+#include "RWCompressor.h"
+#include "StatsServer.h"
 #include "TupleDispatcher.h"
 #include "TupleRouter.h"
 #include "TupleRoutingCriteria.h"
+#include "UpdateImages.h"
 #include "Updater.h"
 #include "WebSockets.h"
 
@@ -40,6 +44,12 @@
 
 #include <stdlib.h>
 
+namespace
+{
+    const int _flushDeadline( 5 ); // ms
+    const int _flushSize( 4096 ); // One compressed block.
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -51,7 +61,7 @@ HandlerFactory::HandlerFactory() :
 {
 }
 
-Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, PresenceLoaders::SharedPresenceStore& sharedPresenceStore )
+Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, PresenceLoaders::SharedPresenceStore& sharedPresenceStore, UpdateImages& updateImages, AccountStore& accountStore, Authorisations& authorisations )
 {
     String machineID( uintToHex( rand() ) );
 
@@ -69,7 +79,7 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Pr
     Clocks::C* _clock( new Clocks::C );
     Linda2::TupleRouter* tupleRouter( new TupleRouter( *tupleDispatcher, clientName, *timerFactory ) );
     KeyUtilities* keyUtilities( new KeyUtilities( *entropySource, *encryptorFactory, *hash ) );
-    Authenticator* authenticator( new Authenticator( *tupleRouter, *keyUtilities ) );
+    Authenticator* authenticator( new Authenticator( *tupleRouter, *keyUtilities, accountStore, authorisations ) );
     AssetLoaders::Factory* assetLoaderFactory( new AssetLoaders::Factories::Mongo( "Assets", true, *authenticator ) ); // true = encrypted names
     AssetLoaders::Linda2Responder* assetLoaderResponder( new AssetLoaders::Linda2Responder( *tupleRouter, *assetLoaderFactory, "Assets" ) );
     AssetLoaders::Factory* programAssetLoaderFactory( new AssetLoaders::Factories::Mongo( "Programs", true, *authenticator ) ); // true = encrypted names
@@ -85,18 +95,25 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Pr
     WorldLoaders::Factory* worldLoaderFactory( new WorldLoaders::Factories::Mongo( *authenticator ) );
     WorldLoaders::Linda2Responder* worldLoaderResponder( new WorldLoaders::Linda2Responder( *tupleRouter, *worldLoaderFactory ) );
     Network::WebSocketsConnection* webSocketsConnection( new Network::WebSocketsConnection( connection ) );
-    RWBuffer* rwBuffer( new RWBuffer( 1024, *webSocketsConnection ) );
+    RWBuffer* rwBuffer( new RWBuffer( 8192, *webSocketsConnection ) ); // Holds a whole coalesced batch, so it goes as one message.
     //RWBuffer* rwBuffer( new RWBuffer( 128, *webSocketsConnection ) );
-    Linda2::TupleRoute* incomingTupleRoute( new Linda2::TupleRoutes::ReadableWritable( clientName, *rwBuffer ) );
+    Compressor* compressor( new Compressors::LZ );
+    RWCompressor* rwCompressor( new RWCompressor( *compressor, *rwBuffer, true, true ) ); // true = compress output, true = detect older, uncompressed clients.
+    Linda2::TupleRoutes::ReadableWritable* incomingTupleRoute( new Linda2::TupleRoutes::ReadableWritable( clientName, *rwCompressor ) );
     //Linda2::TupleRoute* incomingTupleRoute( new Linda2::TupleRoutes::ReadableWritable( handlerID + "<->H" + handlerID, *webSocketsConnection ) );
     Linda2::TupleRoutes::Redis* redisTupleRoute( new Linda2::TupleRoutes::Redis( "Redis" ) );
     redisTupleRoute->connect();
     Inviter* inviter( new Inviter( *tupleRouter, *authenticator ) );
     PushNotifier* pushNotifier( new PushNotifier( *tupleRouter, *authenticator, sharedPresenceStore, *telegramLoaderFactory, *webSocketsConnection ) );
-    Updater* updater( new Updater( *tupleRouter, *authenticator ) );
+    Updater* updater( new Updater( *tupleRouter, *authenticator, updateImages ) );
+    StatsServer* statsServer( new StatsServer( *tupleRouter, *authenticator ) );
 
     tupleRouter->setMyID( machineID );
 
+    // Coalesce bursts (ticks, presence) bound for the client into fewer,
+    // larger WebSocket messages.
+    incomingTupleRoute->setCoalescing( *timerFactory, _flushDeadline, _flushSize );
+
     tupleRouter->addRoute( incomingTupleRoute, false );
     tupleRouter->addRoute( redisTupleRoute, true ); // Default route.
 
@@ -136,13 +153,16 @@ Handler* HandlerFactory::makeHandler( WSTLSServer::connection_ptr connection, Pr
                         tupleRouter,
                         webSocketsConnection,
                         rwBuffer,
+                        compressor,
+                        rwCompressor,
                         incomingTupleRoute,
                         redisTupleRoute,
                         timerFactory,
                         _clock,
                         inviter,
                         pushNotifier,
-                        updater );
+                        updater,
+                        statsServer );
 }
 
 } // namespace Stratus
@@ -15,12 +15,16 @@ class SharedPresenceStore;
 namespace Stratus
 {
 
+class AccountStore;
+class Authorisations;
+class UpdateImages;
+
 class HandlerFactory
 {
 public:
     HandlerFactory();
 
-    Handler* makeHandler( ::WSTLSServer::connection_ptr connection, PresenceLoaders::SharedPresenceStore& sharedPresenceStore );
+    Handler* makeHandler( ::WSTLSServer::connection_ptr connection, PresenceLoaders::SharedPresenceStore& sharedPresenceStore, UpdateImages& updateImages, AccountStore& accountStore, Authorisations& authorisations );
 
 private:
     int m_clientNumber;
@@ -1,12 +1,14 @@
 #include "AssetLoaders/Factories/AssetLoadersFactory.h"
 #include "AssetLoaders/Linda2AssetLoaderResponder.h"
 #include "Clocks/Clock.h"
+#include "Compressors/Compressor.h"
 #include "Encryptors/Factories/EncryptorsFactory.h"
 #include "Encryptors/Encryptor.h"
 #include "Encryptors/Hash.h"
 #include "EntropySources/EntropySource.h"
 #include "Handlers/WSHydraHandler.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "Network/WebSocketsConnection.h"
 #include "PresenceLoaders/Factories/PresenceLoadersFactory.h"
 #include "PresenceLoaders/Linda2PresenceLoaderResponder.h"
@@ -18,6 +20,7 @@
 #include "Timers/Factories/TimerFactory.h"
 #include "TupleFilters/TupleFilter.h"
 #include "TupleRoutes/QueueingTupleRoute.h"
+#include "TupleRoutes/ReadableWritableTupleRoute.h"
 #include "TupleRoutes/TupleRoute.h"
 #include "WorldLoaders/Factories/WorldLoadersFactory.h"
 #include "WorldLoaders/Linda2WorldLoaderResponder.h"
@@ -27,6 +30,8 @@
 #include "KeyUtilities.h"
 #include "PushNotifier.h"
 #include "RWBuffer.h"
+#include "RWCompressor.h"
+#include "StatsServer.h"
 #include "TupleDispatcher.h"
 #include "TupleRouter.h"
 #include "Updater.h"
@@ -68,7 +73,9 @@ Handler::Handler( EntropySource* entropySource,
                   Linda2::TupleRouter* tupleRouter,
                   Network::WebSocketsConnection* webSocketsConnection,
                   RWBuffer* rwBuffer,
-                  Linda2::TupleRoute* incomingTupleRoute,
+                  Compressor* compressor,
+                  RWCompressor* rwCompressor,
+                  Linda2::TupleRoutes::ReadableWritable* incomingTupleRoute,
                   Hydra& hydra,
                   Linda2::TupleRoutes::Queueing* hydraNearTupleRoute,
                   Linda2::TupleRoutes::Queueing* hydraFarTupleRoute,
@@ -76,7 +83,8 @@ Handler::Handler( EntropySource* entropySource,
                   Agape::Clock* clock,
                   Inviter* inviter,
                   PushNotifier* pushNotifier,
-                  Updater* updater ) :
+                  Updater* updater,
+                  StatsServer* statsServer ) :
   m_entropySource( entropySource ),
   m_encryptorFactory( encryptorFactory ),
   m_encryptor( encryptor ),
@@ -102,6 +110,8 @@ Handler::Handler( EntropySource* entropySource,
   m_tupleRouter( tupleRouter ),
   m_webSocketsConnection( webSocketsConnection ),
   m_rwBuffer( rwBuffer ),
+  m_compressor( compressor ),
+  m_rwCompressor( rwCompressor ),
   m_incomingTupleRoute( incomingTupleRoute ),
   m_hydra( hydra ),
   m_hydraNearTupleRoute( hydraNearTupleRoute ),
@@ -111,6 +121,7 @@ Handler::Handler( EntropySource* entropySource,
   m_inviter( inviter ),
   m_pushNotifier( pushNotifier ),
   m_updater( updater ),
+  m_statsServer( statsServer ),
   m_stopping( false ),
   m_stopped( false )
 {
@@ -153,9 +164,12 @@ Handler::~Handler()
     delete( m_inviter );
     delete( m_pushNotifier );
     delete( m_updater );
+    delete( m_statsServer );
     delete( m_tupleDispatcher );
     delete( m_tupleFilter );
     delete( m_tupleRouter );
+    delete( m_rwCompressor );
+    delete( m_compressor );
     delete( m_rwBuffer );
     delete( m_incomingTupleRoute );
     delete( m_timerFactory );
@@ -180,6 +194,21 @@ bool Handler::stopped()
     return m_stopped;
 }
 
+int Handler::queueDepth()
+{
+    return m_hydraNearTupleRoute->depth();
+}
+
+int Handler::queueDropped()
+{
+    return m_hydraNearTupleRoute->dropped();
+}
+
+int Handler::queueCoalesced()
+{
+    return m_hydraNearTupleRoute->coalesced();
+}
+
 void Handler::_handleIncoming()
 {
 #ifdef LOG_STRATUS
@@ -199,8 +228,12 @@ void Handler::_handleIncoming()
             LOG_DEBUG( "Handler: Running TupleRouter to handle incoming" );
 #endif
             std::scoped_lock lock( m_mutex );
+            METRICS_TIMED( "handler.incoming" );
             m_tupleRouter->run();
 
+            // Replies to the client go now, with anything else batched.
+            m_incomingTupleRoute->flushOutgoing();
+
 #ifdef LOG_STRATUS
             LOG_DEBUG( "Handler: Signalling Hydra" );
 #endif
@@ -213,6 +246,11 @@ void Handler::_handleIncoming()
 #endif
                 m_stopping = true;
             }
+            else if( m_hydraFarTupleRoute->overflowed() )
+            {
+                LOG_DEBUG( "Handler: Incoming: Hydra queue overflowed. Stopping thread." );
+                m_stopping = true;
+            }
         }
     }
 
@@ -227,12 +265,22 @@ void Handler::_handleOutgoing()
 #ifdef LOG_STRATUS
     LOG_DEBUG( "Handler: Outgoing thread starting" );
 #endif
+    // While a batch of outgoing tuples is waiting, only wait for more until
+    // it's due; running the router then flushes it.
+    int flushDue( -1 );
     while( !m_stopping )
     {
 #ifdef LOG_STRATUS
         LOG_DEBUG( "Handler: Waiting for Hydra" );
 #endif
-        m_hydraNearTupleRoute->waitIncoming();
+        if( flushDue < 0 )
+        {
+            m_hydraNearTupleRoute->waitIncoming();
+        }
+        else if( flushDue > 0 )
+        {
+            m_hydraNearTupleRoute->waitIncoming( flushDue );
+        }
 
         if( !m_stopping )
         {
@@ -240,7 +288,9 @@ void Handler::_handleOutgoing()
             LOG_DEBUG( "Handler: Running TupleRouter to handle outgoing" );
 #endif
             std::scoped_lock lock( m_mutex );
+            METRICS_TIMED( "handler.outgoing" );
             m_tupleRouter->run();
+            flushDue = m_incomingTupleRoute->flushDue();
 
             if( m_tupleRouter->routeError() )
             {
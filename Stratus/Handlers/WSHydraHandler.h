@@ -24,6 +24,7 @@ namespace Linda2
 namespace TupleRoutes
 {
 class Queueing;
+class ReadableWritable;
 } // namespace TupleRoutes
 class TupleDispatcher;
 class TupleFilter;
@@ -70,7 +71,9 @@ class Encryptor;
 class EntropySource;
 class Hash;
 class KeyUtilities;
+class Compressor;
 class RWBuffer;
+class RWCompressor;
 
 namespace Stratus
 {
@@ -79,6 +82,7 @@ class Authenticator;
 class Hydra;
 class Inviter;
 class PushNotifier;
+class StatsServer;
 class Updater;
 
 class Handler
@@ -109,7 +113,9 @@ public:
              Linda2::TupleRouter* tupleRouter,
              Network::WebSocketsConnection* webSocketsConnection,
              RWBuffer* rwBuffer,
-             Linda2::TupleRoute* incomingTupleRoute,
+             Compressor* compressor,
+             RWCompressor* rwCompressor,
+             Linda2::TupleRoutes::ReadableWritable* incomingTupleRoute,
              Hydra& hydra,
              Linda2::TupleRoutes::Queueing* hydraNearTupleRoute,
              Linda2::TupleRoutes::Queueing* hydraFarTupleRoute,
@@ -117,7 +123,8 @@ public:
              Agape::Clock* clock,
              Inviter* inviter,
              PushNotifier* pushNotifier,
-             Updater* updater
+             Updater* updater,
+             StatsServer* statsServer
     );
 
     ~Handler();
@@ -126,6 +133,11 @@ public:
 
     bool stopped();
 
+    // Tuples from Hydra waiting for this client, and how many were shed.
+    int queueDepth();
+    int queueDropped();
+    int queueCoalesced();
+
 private:
     void _handleIncoming();
     void _handleOutgoing();
@@ -155,7 +167,9 @@ private:
     Linda2::TupleRouter* m_tupleRouter;
     Network::WebSocketsConnection* m_webSocketsConnection;
     RWBuffer* m_rwBuffer;
-    Linda2::TupleRoute* m_incomingTupleRoute;
+    Compressor* m_compressor;
+    RWCompressor* m_rwCompressor;
+    Linda2::TupleRoutes::ReadableWritable* m_incomingTupleRoute;
     Hydra& m_hydra;
     Linda2::TupleRoutes::Queueing* m_hydraNearTupleRoute;
     Linda2::TupleRoutes::Queueing* m_hydraFarTupleRoute;
@@ -164,6 +178,7 @@ private:
     Inviter* m_inviter;
     PushNotifier* m_pushNotifier;
     Updater* m_updater;
+    StatsServer* m_statsServer;
 
     std::unique_ptr< std::thread > m_incomingTuplesThread;
     std::unique_ptr< std::thread > m_outgoingTuplesThread;
@@ -1,12 +1,14 @@
 #include "AssetLoaders/Factories/AssetLoadersFactory.h"
 #include "AssetLoaders/Linda2AssetLoaderResponder.h"
 #include "Clocks/Clock.h"
+#include "Compressors/Compressor.h"
 #include "Encryptors/Factories/EncryptorsFactory.h"
 #include "Encryptors/Encryptor.h"
 #include "Encryptors/Hash.h"
 #include "EntropySources/EntropySource.h"
 #include "Handlers/WSRedisHandler.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "Network/WebSocketsConnection.h"
 #include "PresenceLoaders/Factories/PresenceLoadersFactory.h"
 #include "PresenceLoaders/Linda2PresenceLoaderResponder.h"
@@ -17,6 +19,7 @@
 #include "TelegramLoaders/Linda2TelegramLoaderResponder.h"
 #include "Timers/Factories/TimerFactory.h"
 #include "TupleFilters/TupleFilter.h"
+#include "TupleRoutes/ReadableWritableTupleRoute.h"
 #include "TupleRoutes/RedisTupleRoute.h"
 #include "TupleRoutes/TupleRoute.h"
 #include "WorldLoaders/Factories/WorldLoadersFactory.h"
@@ -26,6 +29,8 @@
 #include "KeyUtilities.h"
 #include "PushNotifier.h"
 #include "RWBuffer.h"
+#include "RWCompressor.h"
+#include "StatsServer.h"
 #include "TupleDispatcher.h"
 #include "TupleRouter.h"
 #include "Updater.h"
@@ -67,13 +72,16 @@ Handler::Handler( EntropySource* entropySource,
                   Linda2::TupleRouter* tupleRouter,
                   Network::WebSocketsConnection* webSocketsConnection,
                   RWBuffer* rwBuffer,
-                  Linda2::TupleRoute* incomingTupleRoute,
+                  Compressor* compressor,
+                  RWCompressor* rwCompressor,
+                  Linda2::TupleRoutes::ReadableWritable* incomingTupleRoute,
                   Linda2::TupleRoutes::Redis* redisTupleRoute,
                   Timers::Factory* timerFactory,
                   Agape::Clock* clock,
                   Inviter* inviter,
                   PushNotifier* pushNotifier,
-                  Updater* updater ) :
+                  Updater* updater,
+                  StatsServer* statsServer ) :
   m_entropySource( entropySource ),
   m_encryptorFactory( encryptorFactory ),
   m_encryptor( encryptor ),
@@ -99,6 +107,8 @@ Handler::Handler( EntropySource* entropySource,
   m_tupleRouter( tupleRouter ),
   m_webSocketsConnection( webSocketsConnection ),
   m_rwBuffer( rwBuffer ),
+  m_compressor( compressor ),
+  m_rwCompressor( rwCompressor ),
   m_incomingTupleRoute( incomingTupleRoute ),
   m_redisTupleRoute( redisTupleRoute ),
   m_timerFactory( timerFactory ),
@@ -106,6 +116,7 @@ Handler::Handler( EntropySource* entropySource,
   m_inviter( inviter ),
   m_pushNotifier( pushNotifier ),
   m_updater( updater ),
+  m_statsServer( statsServer ),
   m_stopping( false ),
   m_stopped( false )
 {
@@ -144,9 +155,12 @@ Handler::~Handler()
     delete( m_inviter );
     delete( m_pushNotifier );
     delete( m_updater );
+    delete( m_statsServer );
     delete( m_tupleDispatcher );
     delete( m_tupleFilter );
     delete( m_tupleRouter );
+    delete( m_rwCompressor );
+    delete( m_compressor );
     delete( m_rwBuffer );
     delete( m_incomingTupleRoute );
     delete( m_timerFactory );
@@ -189,8 +203,12 @@ void Handler::_handleIncoming()
             LOG_DEBUG( "Handler: Running TupleRouter to handle incoming" );
 #endif
             std::scoped_lock lock( m_mutex );
+            METRICS_TIMED( "handler.incoming" );
             m_tupleRouter->run();
 
+            // Replies to the client go now, with anything else batched.
+            m_incomingTupleRoute->flushOutgoing();
+
             if( m_tupleRouter->routeError() )
             {
 #ifdef LOG_STRATUS
@@ -212,12 +230,22 @@ void Handler::_handleOutgoing()
 #ifdef LOG_STRATUS
     LOG_DEBUG( "Handler: Outgoing thread starting" );
 #endif
+    // While a batch of outgoing tuples is waiting, only wait for more until
+    // it's due; running the router then flushes it.
+    int flushDue( -1 );
     while( !m_stopping )
     {
 #ifdef LOG_STRATUS
         LOG_DEBUG( "Handler: Waiting for Hydra" );
 #endif
-        m_redisTupleRoute->waitIncoming();
+        if( flushDue < 0 )
+        {
+            m_redisTupleRoute->waitIncoming();
+        }
+        else if( flushDue > 0 )
+        {
+            m_redisTupleRoute->waitIncoming( flushDue );
+        }
 
         if( !m_stopping )
         {
@@ -225,7 +253,9 @@ void Handler::_handleOutgoing()
             LOG_DEBUG( "Handler: Running TupleRouter to handle outgoing" );
 #endif
             std::scoped_lock lock( m_mutex );
+            METRICS_TIMED( "handler.outgoing" );
             m_tupleRouter->run();
+            flushDue = m_incomingTupleRoute->flushDue();
 
             if( m_tupleRouter->routeError() )
             {
@@ -23,6 +23,7 @@ namespace Linda2
 {
 namespace TupleRoutes
 {
+class ReadableWritable;
 class Redis;
 } // namespace TupleRoutes
 class TupleDispatcher;
@@ -70,7 +71,9 @@ class Encryptor;
 class EntropySource;
 class Hash;
 class KeyUtilities;
+class Compressor;
 class RWBuffer;
+class RWCompressor;
 
 namespace Stratus
 {
@@ -78,6 +81,7 @@ namespace Stratus
 class Authenticator;
 class Inviter;
 class PushNotifier;
+class StatsServer;
 class Updater;
 
 class Handler
@@ -108,13 +112,16 @@ public:
              Linda2::TupleRouter* tupleRouter,
              Network::WebSocketsConnection* webSocketsConnection,
              RWBuffer* rwBuffer,
-             Linda2::TupleRoute* incomingTupleRoute,
+             Compressor* compressor,
+             RWCompressor* rwCompressor,
+             Linda2::TupleRoutes::ReadableWritable* incomingTupleRoute,
              Linda2::TupleRoutes::Redis* redisTupleRoute,
              Timers::Factory* timerFactory,
              Agape::Clock* clock,
              Inviter* inviter,
              PushNotifier* pushNotifier,
-             Updater* updater
+             Updater* updater,
+             StatsServer* statsServer
     );
 
     ~Handler();
@@ -152,13 +159,16 @@ private:
     Linda2::TupleRouter* m_tupleRouter;
     Network::WebSocketsConnection* m_webSocketsConnection;
     RWBuffer* m_rwBuffer;
-    Linda2::TupleRoute* m_incomingTupleRoute;
+    Compressor* m_compressor;
+    RWCompressor* m_rwCompressor;
+    Linda2::TupleRoutes::ReadableWritable* m_incomingTupleRoute;
     Linda2::TupleRoutes::Redis* m_redisTupleRoute;
     Timers::Factory* m_timerFactory;
     Agape::Clock* m_clock;
     Inviter* m_inviter;
     PushNotifier* m_pushNotifier;
     Updater* m_updater;
+    StatsServer* m_statsServer;
 
     std::unique_ptr< std::thread > m_incomingTuplesThread;
     std::unique_ptr< std::thread > m_outgoingTuplesThread;
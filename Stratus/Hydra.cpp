@@ -1,6 +1,9 @@
 #include "Hydra.h"
 
 #include "Loggers/Logger.h"
+#include "Metrics/Gauge.h"
+#include "Metrics/Registry.h"
+#include "Metrics/Timed.h"
 #include "Timers/Factories/CTimerFactory.h"
 #include "TupleRoutes/TupleRoute.h"
 #include "TupleRouter.h"
@@ -21,6 +24,7 @@ namespace Stratus
 
 Hydra::Hydra() :
   m_tupleRouter( m_tupleDispatcher, "Hydra", m_timerFactory ),
+  m_routes( Metrics::Registry::getInstance().gauge( "hydra.routes" ) ),
   m_stopping( false )
 {
     m_routingThread.reset( new std::thread( std::bind( &Hydra::route, this ) ) );
@@ -44,6 +48,7 @@ void Hydra::addRoute( TupleRoute* route )
 #endif
     std::scoped_lock lock( m_mutex );
     m_tupleRouter.addRoute( route, false );
+    m_routes.add( 1 );
 }
 
 void Hydra::removeRoute( TupleRoute* route )
@@ -53,6 +58,7 @@ void Hydra::removeRoute( TupleRoute* route )
 #endif
     std::scoped_lock lock( m_mutex );
     m_tupleRouter.removeRoute( route );
+    m_routes.add( -1 );
 }
 
 void Hydra::signalIncoming()
@@ -78,6 +84,7 @@ void Hydra::route()
 #ifdef LOG_STRATUS
         LOG_DEBUG( "Hydra: Handling incoming" );
 #endif
+        METRICS_TIMED( "hydra.route" );
         m_tupleRouter.run();
     }
 }
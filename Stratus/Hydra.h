@@ -20,6 +20,11 @@ namespace Linda2
 class TupleRoute;
 } // namespace Linda2
 
+namespace Metrics
+{
+class Gauge;
+} // namespace Metrics
+
 namespace Stratus
 {
 
@@ -42,6 +47,8 @@ private:
     TupleDispatcher m_tupleDispatcher;
     TupleRouter m_tupleRouter;
 
+    Metrics::Gauge& m_routes;
+
     std::unique_ptr< std::thread > m_routingThread;
 
     std::mutex m_mutex;
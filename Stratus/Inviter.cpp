@@ -3,6 +3,7 @@
 #include "Utils/LiteStream.h"
 #include "Authenticator.h"
 #include "Inviter.h"
+#include "Reply.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
@@ -104,15 +105,12 @@ bool Inviter::accept( Tuple& tuple )
             }
         }
 
-        Tuple response;
-        TupleRouter::setSourceActor( response, _InviteFriendServer );
-        TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( response, _InviteFriendResponse );
+        Reply reply( m_tupleRouter, tuple, _InviteFriendServer );
+        Tuple response( reply.tuple( _InviteFriendResponse ) );
         response[_success] = success ? 1 : 0;
 
         LOG_DEBUG( "Inviter: Sending InviteFriendResponse" );
-        m_tupleRouter.route( response );
+        reply.send( response );
 
         handled = true;
     }
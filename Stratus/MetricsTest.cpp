@@ -0,0 +1,253 @@
+#ifdef METRICS_TEST
+
+#include "Metrics/Counter.h"
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+#include "Metrics/Timed.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "TupleRoutes/QueueingTupleRoute.h"
+#include "Collections.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+#include "TupleRoutingCriteria.h"
+#include "Value.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <time.h>
+
+using namespace Agape;
+using Agape::Linda2::Tuple;
+using Agape::Linda2::TupleRouter;
+using Agape::Linda2::TupleRoutes::Queueing;
+
+namespace
+{
+    const int _numClients( 16 );
+    const int _numTuples( 8000 );
+    const int _tuplesPerRun( 32 ); // Between wake-ups of the routing thread.
+    const int _numTrials( 101 ); // Odd, for a middle one.
+    const double _maxOverhead( 0.02 );
+
+    // As Hydra and its handlers: one router, and a pair of Queueing routes
+    // per client, the far end of each added to the router.
+    class Hydra
+    {
+    public:
+        Hydra() :
+          m_tupleRouter( m_tupleDispatcher, "Hydra", m_timerFactory ),
+          m_measured( false )
+        {
+            for( int i( 0 ); i < _numClients; ++i )
+            {
+                String clientName( ( "Client" + std::to_string( i ) ).c_str() );
+                Queueing* near( new Queueing( "Hydra" ) );
+                Queueing* far( new Queueing( clientName ) );
+                near->setPartner( far );
+                far->setPartner( near );
+
+                Linda2::TupleRoutingCriteria routingCriteria;
+                routingCriteria.m_destinationIDs.push_back( new Value( clientName ) );
+                far->addRoutingCriteria( routingCriteria );
+
+                m_tupleRouter.addRoute( far, false );
+                m_nears.push_back( near );
+                m_fars.push_back( far );
+            }
+        }
+
+        ~Hydra()
+        {
+            for( int i( 0 ); i < _numClients; ++i )
+            {
+                m_tupleRouter.removeRoute( m_fars[i] );
+                delete( m_fars[i] );
+                delete( m_nears[i] );
+            }
+        }
+
+        void setMeasured( bool measured )
+        {
+            Metrics::Registry& metrics( Metrics::Registry::getInstance() );
+            for( int i( 0 ); i < _numClients; ++i )
+            {
+                m_fars[i]->setWaitHistogram( measured ? &metrics.histogram( "test.queue.hydra.wait" ) : nullptr );
+                m_nears[i]->setWaitHistogram( measured ? &metrics.histogram( "test.queue.client.wait" ) : nullptr );
+            }
+            m_measured = measured;
+        }
+
+        // Each client sends to the next, Hydra routes and each client drains
+        // what it was sent. Returns the number of tuples delivered.
+        int run( int numTuples )
+        {
+            int delivered( 0 );
+            for( int i( 0 ); i < numTuples; ++i )
+            {
+                int client( i % _numClients );
+                Tuple tuple;
+                TupleRouter::setTupleType( tuple, _Moved );
+                TupleRouter::setSourceID( tuple, m_fars[client]->name() );
+                TupleRouter::setDestinationID( tuple, m_fars[( client + 1 ) % _numClients]->name() );
+                tuple[_offset] = i;
+                m_nears[client]->sendTuple( tuple, true ); // As a default route.
+
+                if( ( ( i + 1 ) % _tuplesPerRun ) == 0 )
+                {
+                    route();
+                    delivered += drain();
+                }
+            }
+
+            route();
+            return delivered + drain();
+        }
+
+    private:
+        void route()
+        {
+            if( m_measured )
+            {
+                METRICS_TIMED( "test.hydra.route" );
+                m_tupleRouter.run();
+            }
+            else
+            {
+                m_tupleRouter.run();
+            }
+        }
+
+        int drain()
+        {
+            int drained( 0 );
+            for( int i( 0 ); i < _numClients; ++i )
+            {
+                Tuple tuple;
+                while( m_nears[i]->receiveTuple( tuple ) )
+                {
+                    ++drained;
+                }
+            }
+            return drained;
+        }
+
+        Timers::Factories::HighRes m_timerFactory;
+        Linda2::TupleDispatcher m_tupleDispatcher;
+        TupleRouter m_tupleRouter;
+        Vector< Queueing* > m_nears;
+        Vector< Queueing* > m_fars;
+        bool m_measured;
+    };
+
+    // CPU time in microseconds, so that time spent running anything else
+    // isn't counted.
+    long long cpuus()
+    {
+        struct timespec now;
+        ::clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &now );
+        return ( (long long)now.tv_sec * 1000000LL ) + ( now.tv_nsec / 1000 );
+    }
+
+    // CPU time for one run.
+    long long time( Hydra& hydra, bool measured, bool& delivered )
+    {
+        hydra.setMeasured( measured );
+        long long startus( cpuus() );
+        delivered = ( hydra.run( _numTuples ) == _numTuples ) && delivered;
+        return cpuus() - startus;
+    }
+
+    template< typename T >
+    T median( Vector< T >& values )
+    {
+        std::nth_element( values.begin(), values.begin() + values.size() / 2, values.end() );
+        return values[values.size() / 2];
+    }
+
+    bool check( const char* name, long actual, long expected )
+    {
+        bool success( actual == expected );
+        std::cout << name << ": " << actual << ( success ? " OK" : " FAILED" ) << std::endl;
+        return success;
+    }
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( true );
+
+    // Exact below 16us, then within an eighth.
+    Metrics::Histogram histogram;
+    for( long us( 1 ); us <= 1000; ++us )
+    {
+        histogram.record( us );
+    }
+    success = check( "Count", histogram.count(), 1000 ) && success;
+    success = check( "Mean", histogram.mean(), 500 ) && success;
+    success = check( "Max", histogram.max(), 1000 ) && success;
+    success = check( "p1", histogram.percentile( 0.01 ), 10 ) && success;
+    long p50( histogram.percentile( 0.5 ) );
+    long p99( histogram.percentile( 0.99 ) );
+    bool close( ( p50 >= 500 ) && ( p50 <= 500 + 500 / 8 ) && ( p99 >= 990 ) && ( p99 <= 1000 ) );
+    std::cout << "p50 " << p50 << ", p99 " << p99 << ( close ? " OK" : " FAILED" ) << std::endl;
+    success = close && success;
+
+    Metrics::Histogram huge;
+    huge.record( 86400L * 1000000L * 365L );
+    huge.record( -5 );
+    success = check( "Out of range", huge.count(), 2 ) && success;
+
+    // The registry hands out the same metric for the same name.
+    Metrics::Registry& metrics( Metrics::Registry::getInstance() );
+    metrics.counter( "test.counter" ).increment( 3 );
+    metrics.counter( "test.counter" ).increment();
+    success = check( "Counter", metrics.counter( "test.counter" ).value(), 4 ) && success;
+
+    // Routing with and without measurement, through the same routes and
+    // interleaved, so that each pair of runs sees the same conditions. The
+    // median of the pairs' overheads is checked, so neither the odd slow run
+    // nor the machine's load drifting between pairs decides it.
+    bool delivered( true );
+    Hydra hydra;
+    Vector< long long > plainus;
+    Vector< long long > measuredus;
+    Vector< double > overheads;
+    for( int trial( 0 ); trial < _numTrials; ++trial )
+    {
+        // Each goes first in turn, so neither gains from what the other
+        // leaves behind.
+        bool measuredFirst( ( trial % 2 ) == 1 );
+        if( measuredFirst ) measuredus.push_back( time( hydra, true, delivered ) );
+        plainus.push_back( time( hydra, false, delivered ) );
+        if( !measuredFirst ) measuredus.push_back( time( hydra, true, delivered ) );
+        overheads.push_back( (double)( measuredus.back() - plainus.back() ) / plainus.back() );
+    }
+
+    double overhead( median( overheads ) );
+    bool cheap( overhead < _maxOverhead );
+    std::cout << "Routing " << _numTuples << " tuples, median of " << _numTrials << ": "
+              << median( plainus ) << "us plain, " << median( measuredus ) << "us measured, overhead "
+              << ( overhead * 100.0 ) << "%" << ( cheap ? " OK" : " FAILED" ) << std::endl;
+    success = check( "Delivered", delivered, true ) && cheap && success;
+
+    Value stats;
+    metrics.toValue( stats );
+    long waits( (double)stats[String( "test.queue.hydra.wait" )][_count] );
+    long expected( (long)_numTrials * _numTuples / 8 ); // Queueing samples one in eight.
+    bool sampled( ( waits > expected * 0.98 ) && ( waits < expected * 1.02 ) );
+    std::cout << "Waits recorded: " << waits << ( sampled ? " OK" : " FAILED" ) << std::endl;
+    success = sampled && success;
+
+    std::cout << metrics.dump();
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+    return success ? 0 : 1;
+}
+
+#endif // METRICS_TEST
@@ -21,7 +21,8 @@ namespace Network
 
 WebSocketsConnection::WebSocketsConnection( WSTLSServer::connection_ptr connection ) :
   m_connection( connection ),
-  m_buffer( bufferCapacity )
+  m_buffer( bufferCapacity ),
+  m_readingPaused( false )
 {
     connection->set_message_handler( std::bind( &WebSocketsConnection::onMessage, this, _1, _2 ) );
 }
@@ -33,11 +34,11 @@ WebSocketsConnection::~WebSocketsConnection()
 
 int WebSocketsConnection::read( char* data, int len )
 {
-    int bufferSize( m_buffer.size() );
-    int numToRead( len > bufferSize ? bufferSize : len );
-    for( int i = 0; i < numToRead; ++i )
+    int numToRead( m_buffer.pop( data, len ) );
+
+    if( m_readingPaused )
     {
-        data[i] = m_buffer.pop();
+        refill();
     }
 
 #ifdef LOG_WS
@@ -100,21 +101,40 @@ void WebSocketsConnection::onMessage( websocketpp::connection_hdl connectionHand
     hexDump( &payload[0], payload.length() );
 #endif
 
-    int numBuffered( 0 );
-    while( !m_buffer.isFull() && numBuffered < payload.length() )
+    if( !m_overflow.empty() )
     {
-        m_buffer.push( payload[numBuffered] );
-        ++numBuffered;
+        // Already waiting for the reader; keep order.
+        m_overflow.append( payload );
     }
-
-    if( numBuffered < payload.length() )
+    else
     {
-        LOG_DEBUG( "WebSocketsConnection: Buffer overflow. Bytes lost." );
+        int numBuffered( m_buffer.push( payload.data(), payload.length() ) );
+        if( numBuffered < payload.length() )
+        {
+            LOG_DEBUG( "WebSocketsConnection: Buffer full. Pausing reads." );
+            m_overflow.assign( payload, numBuffered, std::string::npos );
+            m_readingPaused = true;
+            m_connection->pause_reading();
+        }
     }
 
     m_bufferPending.notify_all();
 }
 
+void WebSocketsConnection::refill()
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    int numBuffered( m_buffer.push( m_overflow.data(), m_overflow.length() ) );
+    m_overflow.erase( 0, numBuffered );
+
+    if( m_overflow.empty() )
+    {
+        m_readingPaused = false;
+        m_connection->resume_reading();
+    }
+}
+
 void WebSocketsConnection::sendOutOfBand( const String& message )
 {
     m_connection->send( message.c_str() );
@@ -6,8 +6,10 @@
 #include "String.h"
 #include "WebSockets.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <string>
 
 namespace Agape
 {
@@ -35,10 +37,18 @@ public:
     void sendOutOfBand( const String& message );
 
 private:
+    void refill();
+
     WSTLSServer::connection_ptr m_connection;
 
     RingBuffer< char > m_buffer;
 
+    // When m_buffer is full, the rest of the message (and any arriving
+    // before reading pauses) waits here, and the socket isn't read again
+    // until the reader has drained it.
+    std::string m_overflow;
+    std::atomic< bool > m_readingPaused;
+
     std::mutex m_mutex;
     std::condition_variable m_bufferPending;
 };
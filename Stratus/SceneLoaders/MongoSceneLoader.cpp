@@ -2,6 +2,7 @@
 #include "Databases/MongoDB/MongoDocumentBuilder.h"
 #include "Encryptors/Utils/SecureIdentifier.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "World/Scene.h"
 #include "World/SceneItem.h"
 #include "World/WorldCoordinates.h"
@@ -47,6 +48,8 @@ Mongo::Mongo( const World::Coordinates& coordinates,
 
 bool Mongo::load( World::Scene& scene )
 {
+    METRICS_TIMED( "mongo.scene.load" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoSceneLoader: Loading scene." );
 #endif
@@ -91,6 +94,8 @@ bool Mongo::load( World::Scene& scene )
 
 bool Mongo::request( const Vector< SceneRequest >& requests )
 {
+    METRICS_TIMED( "mongo.scene.request" );
+
     bool success( true );
 
     if( m_authenticator.writableWorld( m_coordinates.m_worldID ) )
@@ -126,6 +131,8 @@ Vector< SceneRequest > Mongo::getUpdates()
 bool Mongo::hasSceneItemAttribute( const String& snowflake,
                                    const String& name )
 {
+    METRICS_TIMED( "mongo.scene.hasSceneItemAttribute" );
+
     bool found( false );
 
     try
@@ -172,6 +179,8 @@ bool Mongo::hasSceneItemAttribute( const String& snowflake,
 bool Mongo::createSceneItemAttribute( const String& snowflake,
                                       const String& name )
 {
+    METRICS_TIMED( "mongo.scene.createSceneItemAttribute" );
+
     bool success( false );
 
     if( m_authenticator.writableWorld( m_coordinates.m_worldID ) )
@@ -220,6 +229,8 @@ bool Mongo::loadSceneItemAttribute( const String& snowflake,
                                     const String& name,
                                     Value& value )
 {
+    METRICS_TIMED( "mongo.scene.loadSceneItemAttribute" );
+
     bool success( true );
 
     try
@@ -281,6 +292,8 @@ bool Mongo::saveSceneItemAttribute( const String& snowflake,
                                     const String& name,
                                     const Value& value )
 {
+    METRICS_TIMED( "mongo.scene.saveSceneItemAttribute" );
+
     bool success( false );
 
     if( m_authenticator.writableWorld( m_coordinates.m_worldID ) )
@@ -377,6 +390,8 @@ bool Mongo::saveSceneItemAttribute( const String& snowflake,
 
 bool Mongo::deleteSceneItemAttributes( const String& snowflake )
 {
+    METRICS_TIMED( "mongo.scene.deleteSceneItemAttributes" );
+
     bool success( false );
 
     if( m_authenticator.writableWorld( m_coordinates.m_worldID ) )
@@ -452,6 +467,11 @@ bool Mongo::handleRequest( const SceneRequest& request )
                 )
             );
             success = ( result && ( ( result->matched_count() == 1 ) || ( result->upserted_count() == 1 ) ) );
+
+            if( result && ( ( result->modified_count() == 1 ) || ( result->upserted_count() == 1 ) ) )
+            {
+                adjustWorldItemCount( m_coordinates.m_worldID, 1 );
+            }
         }
     }
     else if( request.m_sceneOperation == SceneRequest::update )
@@ -487,6 +507,11 @@ bool Mongo::handleRequest( const SceneRequest& request )
                 )
             );
             success = ( result && ( result->modified_count() == 1 ) );
+
+            if( success )
+            {
+                adjustWorldItemCount( m_coordinates.m_worldID, -1 );
+            }
         }
     }
     else if( request.m_sceneOperation == SceneRequest::transport )
@@ -526,6 +551,12 @@ bool Mongo::handleRequest( const SceneRequest& request )
                 );
                 success = ( result && ( ( result->matched_count() == 1 ) || ( result->upserted_count() == 1 ) ) );
             }
+
+            if( success && ( request.m_newCoordinates.m_worldID != m_coordinates.m_worldID ) )
+            {
+                adjustWorldItemCount( m_coordinates.m_worldID, -1 );
+                adjustWorldItemCount( request.m_newCoordinates.m_worldID, 1 );
+            }
         }
     }
     else if( request.m_sceneOperation == SceneRequest::raise )
@@ -720,6 +751,19 @@ bool Mongo::handleRequest( const SceneRequest& request )
     return success;
 }
 
+void Mongo::adjustWorldItemCount( const String& worldID, int delta )
+{
+    // Only maintain counters which exist; worlds pre-dating them have their
+    // counts taken and stored by the world loader on first summary.
+    auto client( MongoDB::pool().acquire() );
+    auto collection( ( *client )[_Agape][_Worlds] );
+    collection.update_one(
+        document() << "worldID" << worldID
+                   << "itemCount" << open_document << "$exists" << true << close_document << finalize,
+        document() << "$inc" << open_document << "itemCount" << delta << close_document << finalize
+    );
+}
+
 bool Mongo::canCreate( const Scene& scene, const SceneItem& sceneItem )
 {
     // FIXME: STUB.
@@ -48,6 +48,7 @@ public:
 
 private:
     bool handleRequest( const SceneRequest& request );
+    void adjustWorldItemCount( const String& worldID, int delta );
 
     bool canCreate( const Scene& scene, const SceneItem& sceneItem );
     bool canUpdate( const Scene& scene, const SceneItem& sceneItem );
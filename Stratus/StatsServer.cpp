@@ -0,0 +1,59 @@
+#include "Actors/NativeActors/NativeActor.h"
+#include "Loggers/Logger.h"
+#include "Metrics/Registry.h"
+#include "Authenticator.h"
+#include "Reply.h"
+#include "StatsServer.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleRouter.h"
+
+namespace Agape
+{
+
+namespace Stratus
+{
+
+StatsServer::StatsServer( TupleRouter& tupleRouter, Authenticator& authenticator ) :
+  m_tupleRouter( tupleRouter ),
+  m_authenticator( authenticator ),
+  Native( _StatsServer )
+{
+    m_tupleRouter.registerActor( this );
+}
+
+StatsServer::~StatsServer()
+{
+    m_tupleRouter.deregisterActor( this );
+}
+
+bool StatsServer::accept( Tuple& tuple )
+{
+    if( TupleRouter::tupleType( tuple ) != _StatsRequest )
+    {
+        return false;
+    }
+
+#ifdef LOG_STRATUS
+    LOG_DEBUG( "StatsServer: Received StatsRequest" );
+#endif
+
+    Reply reply( m_tupleRouter, tuple, _StatsServer );
+    Tuple response( reply.tuple( _StatsResponse ) );
+
+    bool success( m_authenticator.credentialsValid() && m_authenticator.isOperator() );
+    if( success )
+    {
+        Metrics::Registry::getInstance().toValue( response[_stats] );
+    }
+    response[_success] = success ? 1 : 0;
+
+    reply.send( response );
+
+    return true;
+}
+
+} // namespace Stratus
+
+} // namespace Agape
@@ -0,0 +1,39 @@
+#ifndef AGAPE_STRATUS_STATS_SERVER_H
+#define AGAPE_STRATUS_STATS_SERVER_H
+
+#include "Actors/NativeActors/NativeActor.h"
+
+namespace Agape
+{
+
+namespace Linda2
+{
+class Tuple;
+class TupleRouter;
+} // namespace Linda2
+
+namespace Stratus
+{
+
+class Authenticator;
+
+/// @brief Answers StatsRequest tuples with this server's metrics, which are
+/// process-wide, so only for operators' accounts. Anyone else is refused.
+class StatsServer : public Actors::Native
+{
+public:
+    StatsServer( TupleRouter& tupleRouter, Authenticator& authenticator );
+    ~StatsServer();
+
+    virtual bool accept( Tuple& tuple );
+
+private:
+    TupleRouter& m_tupleRouter;
+    Authenticator& m_authenticator;
+};
+
+} // namespace Stratus
+
+} // namespace Agape
+
+#endif // AGAPE_STRATUS_STATS_SERVER_H
@@ -1,6 +1,7 @@
 #include "Databases/MongoDB/MongoDB.h"
 #include "Databases/MongoDB/MongoDocumentBuilder.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "World/Telegram.h"
 #include "Authenticator.h"
 #include "Collections.h"
@@ -40,6 +41,8 @@ Mongo::Mongo( const String& recipientSnowflake,
 
 bool Mongo::load( Vector< Telegram >& telegrams )
 {
+    METRICS_TIMED( "mongo.telegram.load" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoTelegramLoader: Loading telegrams for " + m_recipientSnowflake );
 #endif
@@ -80,8 +83,59 @@ bool Mongo::load( Vector< Telegram >& telegrams )
     return success;
 }
 
+bool Mongo::loadPage( Vector< Telegram >& telegrams,
+                      const String& afterSnowflake,
+                      int limit )
+{
+    METRICS_TIMED( "mongo.telegram.loadPage" );
+
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "MongoTelegramLoader: Loading telegrams for " + m_recipientSnowflake + " after " + afterSnowflake );
+#endif
+
+    bool success( true );
+
+    try
+    {
+        auto client( MongoDB::pool().acquire() );
+        auto collection( ( *client )[_Agape][_Telegrams] );
+
+        Value query;
+        query["recipientSnowflake"] = m_recipientSnowflake;
+        if( !afterSnowflake.empty() )
+        {
+            query["telegramSnowflake"]["$gt"] = afterSnowflake;
+        }
+
+        // Snowflakes are fixed width hex, so sort as they were issued, and
+        // the server only reads as far as the page.
+        options::find options;
+        options.sort( document() << "telegramSnowflake" << 1 << finalize );
+        options.limit( limit );
+
+        mongocxx::cursor telegramCursor( collection.find( DocumentBuilder::build( query ), options ) );
+
+        mongocxx::cursor::iterator it( telegramCursor.begin() );
+        for( ; it != telegramCursor.end(); ++it )
+        {
+            Value telegramValue( DocumentBuilder::unbuild( *it ) );
+            Telegram telegram( Telegram::fromValue( telegramValue ) );
+            telegrams.push_back( telegram );
+        }
+    }
+    catch( mongocxx::exception& e )
+    {
+        LOG_DEBUG( "MongoTelegramLoader: Exception loading telegram page: " + String( e.what() ) );
+        success = false;
+    }
+
+    return success;
+}
+
 bool Mongo::loadSent( Vector< Telegram >& telegrams )
 {
+    METRICS_TIMED( "mongo.telegram.loadSent" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoTelegramLoader: Loading sent telegrams for " + m_recipientSnowflake );
 #endif
@@ -124,6 +178,8 @@ bool Mongo::loadSent( Vector< Telegram >& telegrams )
 
 bool Mongo::send( const Telegram& telegram )
 {
+    METRICS_TIMED( "mongo.telegram.send" );
+
     // FIXME: Should check for the rare case of duplicate telegram snowflake
     // on insert. Speaking of which, we should do this in all cases where
     // snowflake collision might occur (due to re-use of machine numbers).
@@ -153,6 +209,8 @@ bool Mongo::send( const Telegram& telegram )
 
 bool Mongo::markRead( const Telegram& telegram )
 {
+    METRICS_TIMED( "mongo.telegram.markRead" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoTelegramLoader: Marking telegram read" );
 #endif
@@ -194,6 +252,8 @@ bool Mongo::markRead( const Telegram& telegram )
 
 bool Mongo::erase( const Telegram& telegram )
 {
+    METRICS_TIMED( "mongo.telegram.erase" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoTelegramLoader: Deleting telegram" );
 #endif
@@ -230,6 +290,8 @@ bool Mongo::erase( const Telegram& telegram )
 
 bool Mongo::unread( Map< String, int >& numUnread, bool allDevices )
 {
+    METRICS_TIMED( "mongo.telegram.unread" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoTelegramLoader: Looking for unread telegrams" );
 #endif
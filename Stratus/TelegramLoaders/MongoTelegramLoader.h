@@ -27,6 +27,9 @@ public:
            Authenticator& authenticator );
 
     virtual bool load( Vector< Telegram >& telegrams );
+    virtual bool loadPage( Vector< Telegram >& telegrams,
+                           const String& afterSnowflake,
+                           int limit );
     virtual bool loadSent( Vector< Telegram >& telegrams );
     virtual bool send( const Telegram& telegram );
     virtual bool markRead( const Telegram& telegram );
@@ -33,6 +33,13 @@ bool Stratus::permitIn( const Tuple& tuple )
         {
 #ifdef LOG_TUPLES
             LOG_DEBUG( "TupleFilters::Stratus: Routing criteria permitted" );
+#endif
+            permittedIn = true;
+        }
+        else if( TupleRouter::tupleType( tuple ) == _StatsRequest )
+        {
+#ifdef LOG_TUPLES
+            LOG_DEBUG( "TupleFilters::Stratus: Stats requests permitted, StatsServer checks for an operator" );
 #endif
             permittedIn = true;
         }
@@ -247,6 +254,7 @@ bool Stratus::permitOutDefault( const Tuple& tuple ) // Out *to* default route.
         if( ( tupleType != _PresenceResponse ) &&
             ( tupleType != _SceneResponse ) &&
             ( tupleType != _SceneItemSaveAttributeResponse ) &&
+            ( tupleType != _SceneItemSaveAttributesResponse ) &&
             ( tupleType != _SceneItemDeleteAttributesResponse ) &&
             ( tupleType != _InvalidateCachedAsset ) )
         {
@@ -12,6 +12,7 @@
 #include <hiredis/async.h>
 #include <hiredis/adapters/libevent.h>
 
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -152,6 +153,15 @@ void Redis::waitIncoming()
     }
 }
 
+void Redis::waitIncoming( int timeout )
+{
+    std::unique_lock< std::mutex > lock( m_queuesMutex );
+    if( m_incomingQueue.empty() )
+    {
+        m_incomingPending.wait_for( lock, std::chrono::milliseconds( timeout ) );
+    }
+}
+
 void Redis::stop()
 {
     m_incomingPending.notify_all();
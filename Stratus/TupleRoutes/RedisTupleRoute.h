@@ -40,6 +40,7 @@ public:
     virtual bool error() const;
 
     void waitIncoming();
+    void waitIncoming( int timeout ); // ms
     void stop();
 
 private:
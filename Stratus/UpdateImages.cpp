@@ -0,0 +1,242 @@
+#include "Loggers/Logger.h"
+#include "Utils/CRC32.h"
+#include "Utils/LiteStream.h"
+#include "String.h"
+#include "UpdateImages.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std::filesystem;
+
+namespace
+{
+    const int _versionOffsetFromEnd( 8 );
+    const char* _releasesDirectory( "releases" );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Stratus
+{
+
+UpdateImage::UpdateImage( const char* data, int size ) :
+  m_data( data ),
+  m_size( size ),
+  m_version( -1 ),
+  m_checksum( crc32( data, size ) )
+{
+    if( m_size >= _versionOffsetFromEnd )
+    {
+        ::memcpy( &m_version, m_data + m_size - _versionOffsetFromEnd, sizeof( int ) );
+    }
+}
+
+UpdateImage::~UpdateImage()
+{
+    ::munmap( (void*)m_data, m_size );
+}
+
+std::shared_ptr< const UpdateImage > UpdateImage::map( const std::string& filename )
+{
+    int fd( ::open( filename.c_str(), O_RDONLY ) );
+    if( fd == -1 )
+    {
+        LOG_DEBUG( String( "UpdateImage: Unable to open file " ) + filename.c_str() );
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    void* data( MAP_FAILED );
+    if( ( ::fstat( fd, &fileStat ) == 0 ) && ( fileStat.st_size >= _versionOffsetFromEnd ) )
+    {
+        data = ::mmap( nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    }
+    ::close( fd ); // The mapping holds its own reference.
+
+    if( data == MAP_FAILED )
+    {
+        LOG_DEBUG( String( "UpdateImage: Unable to map file " ) + filename.c_str() );
+        return nullptr;
+    }
+
+    return std::shared_ptr< const UpdateImage >( new UpdateImage( (const char*)data, fileStat.st_size ) );
+}
+
+const char* UpdateImage::data() const
+{
+    return m_data;
+}
+
+int UpdateImage::size() const
+{
+    return m_size;
+}
+
+int UpdateImage::version() const
+{
+    return m_version;
+}
+
+unsigned int UpdateImage::checksum() const
+{
+    return m_checksum;
+}
+
+UpdateImages::UpdateImages( int maxReleases ) :
+  m_maxReleases( maxReleases ),
+  m_uses( 0 )
+{
+}
+
+std::shared_ptr< const UpdateImage > UpdateImages::latest( const std::string& stream )
+{
+    std::string filename( stream + ".bin" );
+
+    std::error_code error;
+    file_time_type lastModified( last_write_time( filename, error ) );
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::map< std::string, Stream >::iterator it( m_streams.find( stream ) );
+    if( error )
+    {
+        if( it != m_streams.end() )
+        {
+            m_streams.erase( it );
+        }
+        return nullptr;
+    }
+
+    if( ( it != m_streams.end() ) && ( it->second.m_lastModified == lastModified ) )
+    {
+        return it->second.m_image;
+    }
+
+#ifdef LOG_LOADERS
+    LOG_DEBUG( "UpdateImages: Mapping " + String( filename.c_str() ) );
+#endif
+    std::shared_ptr< const UpdateImage > image( UpdateImage::map( filename ) );
+    if( it != m_streams.end() )
+    {
+        // Keep the superseded image for patching clients still running it.
+        const std::shared_ptr< const UpdateImage >& previous( it->second.m_image );
+        if( previous && ( !image || ( previous->version() != image->version() ) ) &&
+            ( m_releases.find( previous->version() ) == m_releases.end() ) )
+        {
+            keepRelease( previous->version(), previous );
+        }
+    }
+
+    if( !image )
+    {
+        if( it != m_streams.end() )
+        {
+            m_streams.erase( it );
+        }
+        return nullptr;
+    }
+
+    Stream& entry( m_streams[stream] );
+    entry.m_lastModified = lastModified;
+    entry.m_image = image;
+
+#ifdef LOG_LOADERS
+    LiteStream logStream;
+    logStream << "UpdateImages: Version for " << stream.c_str() << " is " << image->version();
+    LOG_DEBUG( logStream.str() );
+#endif
+
+    return image;
+}
+
+std::shared_ptr< const UpdateImage > UpdateImages::release( int version )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::map< int, Release >::iterator it( m_releases.find( version ) );
+    if( it != m_releases.end() )
+    {
+        it->second.m_lastUsed = ++m_uses;
+        return it->second.m_image;
+    }
+
+    for( std::map< std::string, Stream >::iterator streamIt( m_streams.begin() ); streamIt != m_streams.end(); ++streamIt )
+    {
+        if( streamIt->second.m_image->version() == version )
+        {
+            return streamIt->second.m_image;
+        }
+    }
+
+    LiteStream filenameStream;
+    filenameStream << _releasesDirectory << "/" << version << ".bin";
+    std::string filename( filenameStream.str().c_str() );
+
+    std::error_code error;
+    if( !exists( filename, error ) )
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr< const UpdateImage > image( UpdateImage::map( filename ) );
+    if( image && ( image->version() != version ) )
+    {
+        LOG_DEBUG( String( "UpdateImages: Version in trailer does not match " ) + filename.c_str() );
+        image = nullptr;
+    }
+
+    if( image )
+    {
+        keepRelease( version, image );
+    }
+
+    return image;
+}
+
+int UpdateImages::releasesMapped()
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    return m_releases.size();
+}
+
+void UpdateImages::keepRelease( int version, const std::shared_ptr< const UpdateImage >& image )
+{
+    Release& release( m_releases[version] );
+    release.m_image = image;
+    release.m_lastUsed = ++m_uses;
+
+    while( (int)m_releases.size() > m_maxReleases )
+    {
+        std::map< int, Release >::iterator oldest( m_releases.begin() );
+        for( std::map< int, Release >::iterator it( m_releases.begin() ); it != m_releases.end(); ++it )
+        {
+            if( it->second.m_lastUsed < oldest->second.m_lastUsed )
+            {
+                oldest = it;
+            }
+        }
+
+#ifdef LOG_LOADERS
+        LiteStream logStream;
+        logStream << "UpdateImages: Unmapping release " << oldest->first;
+        LOG_DEBUG( logStream.str() );
+#endif
+        m_releases.erase( oldest ); // Clients still reading it hold their own reference.
+    }
+}
+
+} // namespace Stratus
+
+} // namespace Agape
@@ -0,0 +1,88 @@
+#ifndef AGAPE_STRATUS_UPDATE_IMAGES_H
+#define AGAPE_STRATUS_UPDATE_IMAGES_H
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace Agape
+{
+
+namespace Stratus
+{
+
+/// @brief A firmware image mapped read-only into memory. The version is read
+/// from the image's trailer, as the client's build number.
+class UpdateImage
+{
+public:
+    ~UpdateImage();
+
+    static std::shared_ptr< const UpdateImage > map( const std::string& filename );
+
+    const char* data() const;
+    int size() const;
+    int version() const;
+    unsigned int checksum() const;
+
+private:
+    UpdateImage( const char* data, int size );
+
+    const char* m_data;
+    int m_size;
+    int m_version;
+    unsigned int m_checksum;
+};
+
+/// @brief Update images shared by all connections, so that updating many
+/// clients maps each image once rather than reopening and rereading it for
+/// every block. The newest image for each stream is "<stream>.bin" in the
+/// working directory. Earlier releases, which clients can be patched from,
+/// are "releases/<version>.bin"; images replaced on disk are also kept for
+/// this. Replace images by renaming over them rather than rewriting them in
+/// place, so that images still mapped stay intact. At most maxReleases
+/// earlier releases stay mapped, the least recently used going first; those
+/// not in "releases" can then no longer be patched from.
+class UpdateImages
+{
+public:
+    UpdateImages( int maxReleases = 8 );
+
+    // Remaps if the file has changed on disk.
+    std::shared_ptr< const UpdateImage > latest( const std::string& stream );
+
+    std::shared_ptr< const UpdateImage > release( int version );
+
+    int releasesMapped();
+
+private:
+    struct Stream
+    {
+        std::filesystem::file_time_type m_lastModified;
+        std::shared_ptr< const UpdateImage > m_image;
+    };
+
+    struct Release
+    {
+        std::shared_ptr< const UpdateImage > m_image;
+        unsigned long m_lastUsed;
+    };
+
+    void keepRelease( int version, const std::shared_ptr< const UpdateImage >& image );
+
+    int m_maxReleases;
+    unsigned long m_uses;
+
+    std::map< std::string, Stream > m_streams;
+    std::map< int, Release > m_releases;
+
+    std::mutex m_mutex;
+};
+
+} // namespace Stratus
+
+} // namespace Agape
+
+#endif // AGAPE_STRATUS_UPDATE_IMAGES_H
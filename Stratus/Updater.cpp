@@ -1,23 +1,40 @@
 #include "Actors/NativeActors/NativeActor.h"
 #include "Loggers/Logger.h"
 #include "Utils/LiteStream.h"
+#include "Utils/StrToHex.h"
 #include "Authenticator.h"
+#include "Reply.h"
 #include "String.h"
 #include "StringConstants.h"
 #include "Tuple.h"
 #include "TupleRouter.h"
+#include "UpdateImages.h"
 #include "Updater.h"
 
-#include <cstdio>
-#include <filesystem>
-#include <map>
+#include <memory>
 #include <string>
 
-using namespace std::filesystem;
+#include <string.h>
 
 namespace
 {
     const Agape::String defaultUpdateStream( "stable" );
+
+    const int _maxReadLength( 65536 );
+    const int _maxDeltaUnit( 1048576 );
+
+    bool isErased( const char* data, int len )
+    {
+        for( int i = 0; i < len; ++i )
+        {
+            if( data[i] != '\xff' )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
 } // Anonymous namespace
 
 namespace Agape
@@ -26,11 +43,12 @@ namespace Agape
 namespace Stratus
 {
 
-Updater::Updater( TupleRouter& tupleRouter, Authenticator& authenticator ) :
+Updater::Updater( TupleRouter& tupleRouter,
+                  Authenticator& authenticator,
+                  UpdateImages& updateImages ) :
   m_tupleRouter( tupleRouter ),
   m_authenticator( authenticator ),
-  m_currentFile( nullptr ),
-  m_currentFileSize( 0 ),
+  m_updateImages( updateImages ),
   Native( _UpdateServer )
 {
     m_tupleRouter.registerActor( this );
@@ -42,11 +60,6 @@ Updater::Updater( TupleRouter& tupleRouter, Authenticator& authenticator ) :
 Updater::~Updater()
 {
     m_tupleRouter.deregisterActor( this );
-
-    if( m_currentFile )
-    {
-        std::fclose( m_currentFile );
-    }
 }
 
 bool Updater::accept( Tuple& tuple )
@@ -60,46 +73,18 @@ bool Updater::accept( Tuple& tuple )
         LOG_DEBUG( "Updater: Received UpdateMetadataRequest" );
 #endif
 
-        bool success( false );
-
-        updateFromFilesystem();
+        std::shared_ptr< const UpdateImage > image( latestImage() );
 
-        String updateStream( m_authenticator.updateStream() );
-        if( updateStream.empty() ) updateStream = defaultUpdateStream;
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Updater: Update stream for client is " + updateStream );
-#endif
-
-        success = ( m_streamMetadata.find( updateStream.c_str() ) != m_streamMetadata.end() );
-#ifdef LOG_LOADERS
-        if( success )
-        {
-            LiteStream stream;
-            stream << "Updater: Found firmware file version "
-                   << m_streamMetadata[updateStream.c_str()].m_version
-                   << " for stream "
-                   << updateStream;
-            LOG_DEBUG( stream.str() );
-        }
-        else
-        {
-            LOG_DEBUG( "Updater: No firmware file found for update stream " + updateStream );
-        }
-#endif
-
-        Tuple response;
-        TupleRouter::setSourceActor( response, _UpdateServer );
-        TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( response, _UpdateMetadataResponse );
-        response[_version] = success ? m_streamMetadata[updateStream.c_str()].m_version : -1;
-        response[_success] = success ? 1 : 0;
+        Reply reply( m_tupleRouter, tuple, _UpdateServer );
+        Tuple response( reply.tuple( _UpdateMetadataResponse ) );
+        response[_version] = image ? image->version() : -1;
+        response[_success] = image ? 1 : 0;
 
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Updater: Sending UpdateMetadataResponse" );
 #endif
 
-        m_tupleRouter.route( response );
+        reply.send( response );
 
         handled = true;
     }
@@ -109,74 +94,23 @@ bool Updater::accept( Tuple& tuple )
         LOG_DEBUG( "Updater: Received UpdateOpenRequest" );
 #endif
 
-        bool success( false );
-
-        updateFromFilesystem();
-
-        String updateStream( m_authenticator.updateStream() );
-        if( updateStream.empty() ) updateStream = defaultUpdateStream;
-#ifdef LOG_LOADERS
-        LOG_DEBUG( "Updater: Update stream for client is " + updateStream );
-#endif
-
-        success = ( m_streamMetadata.find( updateStream.c_str() ) != m_streamMetadata.end() );
-        if( success )
-        {
-#ifdef LOG_LOADERS
-            LiteStream stream;
-            stream << "Updater: Found firmware file version "
-                   << m_streamMetadata[updateStream.c_str()].m_version
-                   << " for stream "
-                   << updateStream;
-            LOG_DEBUG( stream.str() );
-#endif
+        // Hold the image for the whole download, even if a newer one lands.
+        m_currentImage = latestImage();
 
-            if( m_currentFile )
-            {
-                std::fclose( m_currentFile );
-                m_currentFile = nullptr;
-            }
-            m_currentFileSize = 0;
+        Reply reply( m_tupleRouter, tuple, _UpdateServer );
+        Tuple response( reply.tuple( _UpdateOpenResponse ) );
+        response[_size] = (double)( m_currentImage ? m_currentImage->size() : 0 );
+        response[_success] = m_currentImage ? 1 : 0;
 
-            LiteStream filenameStream;
-            filenameStream << updateStream << ".bin";
-            m_currentFile = std::fopen( filenameStream.str().c_str(), "rb" );
-            if( m_currentFile )
-            {
-                if( ( std::fseek( m_currentFile, 0, SEEK_END ) == 0 ) &&
-                    ( ( m_currentFileSize = std::ftell( m_currentFile ) ) != -1L ) )
-                {
-                    success = true;
-                }
-                else
-                {
-                    LOG_DEBUG( "Updater: Failed to find size of firmware file " + filenameStream.str() );
-                }
-            }
-            else
-            {
-                LOG_DEBUG( "Updater: Failed to open firmware file " + filenameStream.str() );
-            }
-        }
-        else
+        if( m_currentImage )
         {
-#ifdef LOG_LOADERS
-            LOG_DEBUG( "Updater: No firmware file found for update stream " + updateStream );
-#endif
+            addDelta( response, tuple );
         }
 
-        Tuple response;
-        TupleRouter::setSourceActor( response, _UpdateServer );
-        TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( response, _UpdateOpenResponse );
-        response[_size] = (double)m_currentFileSize;
-        response[_success] = success ? 1 : 0;
-
 #ifdef LOG_LOADERS
-        LOG_DEBUG( "Updater: Sending UpdateMetadataResponse" );
+        LOG_DEBUG( "Updater: Sending UpdateOpenResponse" );
 #endif
-        m_tupleRouter.route( response );
+        reply.send( response );
 
         handled = true;
     }
@@ -188,68 +122,39 @@ bool Updater::accept( Tuple& tuple )
 
         bool success( false );
 
-        Tuple response;
-        TupleRouter::setSourceActor( response, _UpdateServer );
-        TupleRouter::setSourceID( response, m_tupleRouter.myID() );
-        TupleRouter::setDestinationID( response, TupleRouter::sourceID( tuple ) );
-        TupleRouter::setTupleType( response, _UpdateReadResponse );
+        Reply reply( m_tupleRouter, tuple, _UpdateServer );
+        Tuple response( reply.tuple( _UpdateReadResponse ) );
 
-        if( m_currentFile )
+        if( m_currentImage )
         {
             int offset( tuple[_offset] );
             int length( tuple[_length] );
+            int size( m_currentImage->size() );
 
-            if( ( offset >= 0 ) &&
-                ( ( offset + length ) <= m_currentFileSize ) )
+            if( ( offset >= 0 ) && ( offset < size ) &&
+                ( length > 0 ) && ( length <= _maxReadLength ) )
             {
-                if( std::fseek( m_currentFile, offset, SEEK_SET ) == 0 )
+                // The last block may be short.
+                if( length > ( size - offset ) )
                 {
-                    String data( length, '\0' );
-                    size_t numRead( std::fread( &data[0], 1, length, m_currentFile ) );
-                    if( ( numRead > 0 ) &&
-                        !std::feof( m_currentFile ) &&
-                        !std::ferror( m_currentFile ) )
-                    {
-                        data.resize( numRead );
-
-                        bool isEmpty( true );
-                        for( int i = 0; i < numRead; ++i )
-                        {
-                            if( data[i] != '\xff' )
-                            {
-                                isEmpty = false;
-                                break;
-                            }
-                        }
-
-                        response[_offset] = offset;
-                        response[_length] = (double)numRead;
-                        if( isEmpty )
-                        {
-                            response[_empty] = 1;
-                        }
-                        else
-                        {
-                            response[_data] = data;
-                            response[_data].markBinary();
-                        }
-
-                        success = true;
-                    }
-                    else
-                    {
-                        LOG_DEBUG( "Updater: Short read/EOF/error reading update file" );
-                    }
+                    length = size - offset;
+                }
+
+                const char* data( m_currentImage->data() + offset );
+
+                response[_offset] = offset;
+                response[_length] = (double)length;
+                if( isErased( data, length ) )
+                {
+                    response[_empty] = 1;
                 }
                 else
                 {
-                    LiteStream stream;
-                    stream << "Updater: Failed to seek to offset "
-                           << offset
-                           << ". File size is "
-                           << m_currentFileSize;
-                    LOG_DEBUG( stream.str() );
+                    response[_data] = String( data, length );
+                    response[_data].markBinary();
                 }
+
+                success = true;
             }
             else
             {
@@ -259,7 +164,7 @@ bool Updater::accept( Tuple& tuple )
                        << " and/or length "
                        << length
                        << " invalid. File size is "
-                       << m_currentFileSize;
+                       << size;
                 LOG_DEBUG( stream.str() );
             }
         }
@@ -273,7 +178,7 @@ bool Updater::accept( Tuple& tuple )
 #ifdef LOG_LOADERS
         LOG_DEBUG( "Updater: Sending UpdateReadResponse" );
 #endif
-        m_tupleRouter.route( response );
+        reply.send( response );
 
         handled = true;
     }
@@ -281,124 +186,108 @@ bool Updater::accept( Tuple& tuple )
     return handled;
 }
 
-void Updater::updateFromFilesystem()
+std::shared_ptr< const UpdateImage > Updater::latestImage()
 {
-    for( auto const& directoryEntry : directory_iterator( "." ) )
-    {
+    String updateStream( m_authenticator.updateStream() );
+    if( updateStream.empty() ) updateStream = defaultUpdateStream;
 #ifdef LOG_LOADERS
-        LiteStream dstream;
-        dstream << directoryEntry.path().filename().c_str() << "; "
-                << directoryEntry.path().extension().c_str() << "; "
-                << (directoryEntry.is_regular_file() ? "r" : "n");
-        LOG_DEBUG( dstream.str() );
+    LOG_DEBUG( "Updater: Update stream for client is " + updateStream );
 #endif
-        if( directoryEntry.is_regular_file() &&
-            ( directoryEntry.path().extension() == ".bin" ) )
+
+    bool allowed( false );
+    for( auto allowedName : m_allowedStreams )
+    {
+        if( allowedName == updateStream.c_str() )
         {
+            allowed = true;
+            break;
+        }
+    }
+
+    std::shared_ptr< const UpdateImage > image;
+    if( allowed )
+    {
+        image = m_updateImages.latest( updateStream.c_str() );
+    }
+
 #ifdef LOG_LOADERS
-            LOG_DEBUG( String( "Updater: Found firmware file " ) + directoryEntry.path().filename().c_str() );
+    if( image )
+    {
+        LiteStream stream;
+        stream << "Updater: Found firmware file version "
+               << image->version()
+               << " for stream "
+               << updateStream;
+        LOG_DEBUG( stream.str() );
+    }
+    else
+    {
+        LOG_DEBUG( "Updater: No firmware file found for update stream " + updateStream );
+    }
 #endif
-            std::string streamName = directoryEntry.path().stem();
 
-            bool allowed( false );
-            for( auto allowedName : m_allowedStreams )
-            {
-                if( streamName == allowedName )
-                {
-                    allowed = true;
-                    break;
-                }
-            }
+    return image;
+}
 
-            if( !allowed ) continue;
+void Updater::addDelta( Tuple& response, const Tuple& request )
+{
+    // Clients that say which version they run, and in what units they can
+    // rewrite their update memory, need only fetch the units that changed
+    // since, provided they still hold that version.
+    if( !request.hasValue( _version ) || !request.hasValue( _length ) )
+    {
+        return;
+    }
 
-            if( m_streamMetadata.find( streamName ) != m_streamMetadata.end() )
-            {
-                if( m_streamMetadata[streamName].m_lastModified < directoryEntry.last_write_time() )
-                {
-#ifdef LOG_LOADERS
-                    LOG_DEBUG( "Updater: File changed on disk. Re-reading version from file." );
-#endif
-                    m_streamMetadata[streamName].m_lastModified = directoryEntry.last_write_time();
-                    int version( versionFromFile( directoryEntry.path().filename() ) );
-                    if( version != -1 )
-                    {
-#ifdef LOG_LOADERS
-                        LiteStream stream;
-                        stream << "Updater: New version for "
-                               << streamName.c_str()
-                               << " is "
-                               << version;
-                        LOG_DEBUG( stream.str() );
-#endif
-                        m_streamMetadata[streamName].m_version = version;
-                    }
-                    else
-                    {
-#ifdef LOG_LOADERS
-                        LOG_DEBUG( String( "Updater: Erasing metadata for stream " ) + streamName.c_str() );
-#endif
-                        m_streamMetadata.erase( streamName );
-                    }
-                }
-                else
-                {
-#ifdef LOG_LOADERS
-                    LOG_DEBUG( "Updater: File not changed on disk since last read" );
-#endif
-                }
-            }
-            else
-            {
+    int version( request[_version] );
+    int unit( request[_length] );
+    if( ( unit <= 0 ) || ( unit > _maxDeltaUnit ) || ( version == m_currentImage->version() ) )
+    {
+        return;
+    }
+
+    std::shared_ptr< const UpdateImage > base( m_updateImages.release( version ) );
+    if( !base )
+    {
 #ifdef LOG_LOADERS
-                LOG_DEBUG( "Updater: Reading version from file" );
+        LOG_DEBUG( "Updater: No release to patch from. Sending whole image." );
 #endif
-                int version( versionFromFile( directoryEntry.path().filename() ) );
-                if( version != -1 )
-                {
-                    struct UpdateMetadata updateMetadata;
-                    updateMetadata.m_version = version;
-                    updateMetadata.m_lastModified = directoryEntry.last_write_time();
-                    m_streamMetadata[streamName] = updateMetadata;
-                }
-            }
-        }
+        return;
     }
-}
 
-int Updater::versionFromFile( const std::string& filename )
-{
-    std::FILE* file( std::fopen( filename.c_str(), "rb" ) );
-    if( file )
+    const char* from( base->data() );
+    const char* to( m_currentImage->data() );
+    int size( m_currentImage->size() );
+
+    int changed( 0 );
+    Value offsets;
+    for( int offset( 0 ); offset < size; offset += unit )
     {
-        if( std::fseek( file, -8, SEEK_END ) == 0 )
+        int length( ( size - offset ) < unit ? ( size - offset ) : unit );
+        if( ( ( offset + length ) > base->size() ) ||
+            ( ::memcmp( from + offset, to + offset, length ) != 0 ) )
         {
-            int version( 0 );
-            if( std::fread( (char*)( &version ), 1, sizeof( int ), file ) == sizeof( int ) )
-            {
-                std::fclose( file );
-                return version;
-            }
-            else
-            {
-                LOG_DEBUG( String( "Updater: Unable to read version from file " ) + filename.c_str() );
-                if( std::feof( file ) ) LOG_DEBUG( "EOF" );
-                if( std::ferror( file ) ) LOG_DEBUG( "ERROR" );
-            }
+            offsets.push_back( new Value( offset ) );
+            ++changed;
         }
-        else
-        {
-            LOG_DEBUG( String( "Updater: Unable to seek in file " ) + filename.c_str() );
-        }
-
-        std::fclose( file );
     }
-    else
+
+    if( changed == 0 )
     {
-        LOG_DEBUG( String( "Updater: Unable to open file " ) + filename.c_str() );
+        // The trailers differ, so this should never happen.
+        return;
     }
 
-    return -1;
+    response[_delta] = offsets;
+    response[_baseSize] = (double)base->size();
+    response[_checksum] = uintToHex( base->checksum() );
+
+#ifdef LOG_LOADERS
+    LiteStream stream;
+    stream << "Updater: Patching from version " << version << ": "
+           << changed << " of " << ( ( size + unit - 1 ) / unit ) << " units changed";
+    LOG_DEBUG( stream.str() );
+#endif
 }
 
 } // namespace Stratus
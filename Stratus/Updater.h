@@ -4,10 +4,9 @@
 #include "Actors/NativeActors/NativeActor.h"
 #include "String.h"
 
-#include <cstdio>
-#include <filesystem>
-#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Agape
 {
@@ -18,40 +17,34 @@ class Tuple;
 class TupleRouter;
 } // namespace Linda2
 
-using namespace std::filesystem;
-
 namespace Stratus
 {
 
 class Authenticator;
+class UpdateImage;
+class UpdateImages;
 
 class Updater : public Actors::Native
 {
 public:
-    Updater( TupleRouter& tupleRouter, Authenticator& authenticator );
+    Updater( TupleRouter& tupleRouter,
+             Authenticator& authenticator,
+             UpdateImages& updateImages );
     ~Updater();
 
     virtual bool accept( Tuple& tuple );
 
 private:
-    struct UpdateMetadata
-    {
-        int m_version;
-        file_time_type m_lastModified;
-    };
-
-    void updateFromFilesystem();
-    int versionFromFile( const std::string& filename );
+    std::shared_ptr< const UpdateImage > latestImage();
+    void addDelta( Tuple& response, const Tuple& request );
 
     TupleRouter& m_tupleRouter;
     Authenticator& m_authenticator;
+    UpdateImages& m_updateImages;
 
     std::vector< std::string > m_allowedStreams;
 
-    std::map< std::string, UpdateMetadata > m_streamMetadata;
-
-    std::FILE* m_currentFile;
-    int m_currentFileSize;
+    std::shared_ptr< const UpdateImage > m_currentImage;
 };
 
 } // namespace Stratus
@@ -0,0 +1,333 @@
+#ifdef UPDATER_TEST
+
+#include "AccountStores/AccountStore.h"
+#include "Actors/NativeActors/NativeActor.h"
+#include "Encryptors/Factories/AESEncryptorFactory.h"
+#include "Encryptors/SHA256/SHA256Hash.h"
+#include "EntropySources/DummyEntropySource.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "Utils/base64/base64.h"
+#include "Utils/CRC32.h"
+#include "Utils/StrToHex.h"
+#include "Authenticator.h"
+#include "Authorisations.h"
+#include "KeyUtilities.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+#include "UpdateImages.h"
+#include "Updater.h"
+#include "Value.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Agape;
+using namespace std::filesystem;
+using Agape::Linda2::Tuple;
+using Agape::Linda2::TupleRouter;
+
+namespace
+{
+    const int _imageSize( 512 * 1024 );
+    const int _grownBy( 10 * 1024 );
+    const int _memorySize( 1024 * 1024 );
+    const int _blockSize( 4096 ); // As UpdateStrategy.
+    const int _eraseUnit( 4096 );
+    const int _oldVersion( 41 );
+    const int _newVersion( 42 );
+    const char* _stream( "dev" ); // Not the default, so it must come from the account.
+    const char* _image( "dev.bin" );
+    const int _maxReleases( 4 );
+    const int _releaseSize( 16 * 1024 );
+
+    std::string makeImage( int size, int version, unsigned int seed )
+    {
+        std::string image( size, '\xff' );
+        for( int i( 0 ); i < size - ( 64 * 1024 ); ++i ) // Leave an erased tail.
+        {
+            seed = seed * 1103515245 + 12345;
+            image[i] = (char)( seed >> 16 );
+        }
+        ::memcpy( &image[size - 8], &version, sizeof( int ) );
+        return image;
+    }
+
+    void writeImage( const std::string& filename, const std::string& image )
+    {
+        // Write elsewhere then rename, as the server expects.
+        std::ofstream file( "incoming.bin.tmp", std::ios::binary );
+        file.write( image.data(), image.size() );
+        file.close();
+        rename( "incoming.bin.tmp", filename );
+    }
+
+    // Stands in for the accounts collection: one account, on the dev stream.
+    class FakeAccountStore : public Stratus::AccountStore
+    {
+    public:
+        virtual bool findAccount( const String& accountAuthKeyHash,
+                                  const String& deviceAuthKeyHash,
+                                  Value& account,
+                                  bool& found )
+        {
+            account = Value();
+            account[_updateStream] = _stream;
+            found = true;
+            return true;
+        }
+
+        virtual bool findWorld( const String& worldID, Value& world, bool& found )
+        {
+            found = false;
+            return true;
+        }
+
+        virtual bool findUserSnowflakes( const String& accountAuthKeyHash,
+                                         const String& deviceAuthKeyHash,
+                                         Vector< String >& snowflakes )
+        {
+            snowflakes.clear();
+            return true;
+        }
+    };
+
+    String encoded( int size )
+    {
+        String key( size, 'k' );
+        String encodedKey( Base64encode_len( size ), '\0' );
+        Base64encode( &encodedKey[0], key.c_str(), size );
+        encodedKey.resize( encodedKey.length() - 1 );
+        return encodedKey;
+    }
+
+    void authenticate( Stratus::Authenticator& authenticator, KeyUtilities& keyUtilities )
+    {
+        Tuple authenticate;
+        TupleRouter::setTupleType( authenticate, _Authenticate );
+        authenticate[_accountAuthKey] = encoded( keyUtilities.accountSubKeySize() );
+        authenticate[_deviceAuthKey] = encoded( keyUtilities.deviceAuthKeySize() );
+        authenticator.accept( authenticate );
+    }
+
+    // Stands in for UpdateStrategy and the flash behind it.
+    class Client : public Linda2::Actors::Native
+    {
+    public:
+        Client( TupleRouter& tupleRouter ) :
+          Native( _UpdateClient ),
+          m_tupleRouter( tupleRouter ),
+          m_memory( _memorySize, '\xff' ),
+          m_fetched( 0 )
+        {
+            m_tupleRouter.registerActor( this );
+        }
+
+        ~Client()
+        {
+            m_tupleRouter.deregisterActor( this );
+        }
+
+        virtual bool accept( Tuple& tuple )
+        {
+            if( ( TupleRouter::tupleType( tuple ) == _UpdateOpenResponse ) ||
+                ( TupleRouter::tupleType( tuple ) == _UpdateReadResponse ) )
+            {
+                m_response = tuple;
+                return true;
+            }
+
+            return false;
+        }
+
+        // Returns the number of units patched, or -1 for a full update, or
+        // -2 on error.
+        int update( int currentVersion )
+        {
+            Tuple open( request( _UpdateOpenRequest ) );
+            open[_version] = currentVersion;
+            open[_length] = _eraseUnit;
+            if( !send( open ) ) return -2;
+
+            int size( m_response[_size] );
+            std::vector< int > delta;
+            if( m_response.hasValue( _delta ) )
+            {
+                const Value& offsets( m_response[_delta] );
+                for( ConstListIterator it( offsets.listBegin() ); it != offsets.listEnd(); ++it )
+                {
+                    delta.push_back( (int)**it );
+                }
+
+                int baseSize( m_response[_baseSize] );
+                if( uintToHex( crc32( m_memory.data(), baseSize ) ) != (const String&)m_response[_checksum] )
+                {
+                    delta.clear();
+                }
+            }
+
+            if( delta.empty() )
+            {
+                m_memory.assign( _memorySize, '\xff' );
+                return fetch( 0, size ) ? -1 : -2;
+            }
+
+            for( std::vector< int >::iterator it( delta.begin() ); it != delta.end(); ++it )
+            {
+                ::memset( &m_memory[*it], '\xff', _eraseUnit );
+                int end( ( *it + _eraseUnit ) < size ? ( *it + _eraseUnit ) : size );
+                if( !fetch( *it, end ) ) return -2;
+            }
+
+            return delta.size();
+        }
+
+        unsigned int checksum( int size ) const
+        {
+            return crc32( m_memory.data(), size );
+        }
+
+        int m_fetched;
+
+    private:
+        Tuple request( const char* type )
+        {
+            Tuple tuple;
+            TupleRouter::setSourceActor( tuple, _UpdateClient );
+            TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
+            TupleRouter::setTupleType( tuple, type );
+            return tuple;
+        }
+
+        bool send( Tuple& tuple )
+        {
+            m_response = Tuple();
+            m_tupleRouter.route( tuple ); // Updater replies while handling it.
+            return( m_response.hasValue( _success ) && ( (int)m_response[_success] == 1 ) );
+        }
+
+        bool fetch( int offset, int end )
+        {
+            while( offset < end )
+            {
+                Tuple read( request( _UpdateReadRequest ) );
+                read[_offset] = offset;
+                read[_length] = _blockSize;
+                if( !send( read ) || ( (int)m_response[_offset] != offset ) ) return false;
+
+                int length( m_response[_length] );
+                if( !m_response.hasValue( _empty ) )
+                {
+                    const Value& data( m_response[_data] );
+                    ::memcpy( &m_memory[offset], data.raw(), data.rawSize() );
+                    m_fetched += data.rawSize();
+                }
+                offset += length;
+            }
+
+            return true;
+        }
+
+        TupleRouter& m_tupleRouter;
+        std::string m_memory;
+        Tuple m_response;
+    };
+} // Anonymous namespace
+
+int main( int argc, char* argv[] )
+{
+    bool success( crc32( "123456789", 9 ) == 0xCBF43926 );
+    std::cout << "CRC-32 check value: " << ( success ? "OK" : "FAILED" ) << std::endl;
+
+    char directory[] = "/tmp/UpdaterTestXXXXXX";
+    if( !::mkdtemp( directory ) ) return 1;
+    current_path( directory );
+
+    std::string oldImage( makeImage( _imageSize, _oldVersion, 1 ) );
+    writeImage( _image, oldImage );
+
+    Timers::Factories::HighRes timerFactory;
+    Linda2::TupleDispatcher tupleDispatcher;
+    TupleRouter tupleRouter( tupleDispatcher, "Test", timerFactory );
+    tupleRouter.setMyID( "Client" );
+    EntropySources::Dummy entropySource;
+    Encryptors::Factories::AES encryptorFactory( entropySource );
+    Hashes::SHA256 hash;
+    KeyUtilities keyUtilities( entropySource, encryptorFactory, hash );
+    FakeAccountStore accountStore;
+    Stratus::Authorisations authorisations( timerFactory );
+    Stratus::Authenticator authenticator( tupleRouter, keyUtilities, accountStore, authorisations );
+    authenticate( authenticator, keyUtilities );
+    Stratus::UpdateImages updateImages;
+    Stratus::Updater updater( tupleRouter, authenticator, updateImages );
+    Client client( tupleRouter );
+
+    // First install: the client has nothing to patch.
+    int result( client.update( 0 ) );
+    bool installed( ( result == -1 ) && ( client.checksum( oldImage.size() ) == crc32( oldImage.data(), oldImage.size() ) ) );
+    std::cout << "Full update to v" << _oldVersion << ": fetched " << client.m_fetched << " bytes: "
+              << ( installed ? "OK" : "FAILED" ) << std::endl;
+    success = success && installed;
+
+    // Change a few scattered blocks, grow the image and release it.
+    std::string newImage( makeImage( _imageSize + _grownBy, _newVersion, 1 ) );
+    const int changes[] = { 1000, 200000, 300001 };
+    for( unsigned int i( 0 ); i < sizeof( changes ) / sizeof( changes[0] ); ++i )
+    {
+        newImage[changes[i]] ^= 0x5A;
+    }
+    writeImage( _image, newImage );
+    last_write_time( _image, last_write_time( _image ) + std::chrono::seconds( 2 ) );
+
+    client.m_fetched = 0;
+    result = client.update( _oldVersion );
+    bool patched( ( result > 0 ) && ( client.checksum( newImage.size() ) == crc32( newImage.data(), newImage.size() ) ) );
+    std::cout << "Patch v" << _oldVersion << " to v" << _newVersion << ": " << result << " of "
+              << ( newImage.size() + _eraseUnit - 1 ) / _eraseUnit << " units, fetched "
+              << client.m_fetched << " bytes: " << ( patched ? "OK" : "FAILED" ) << std::endl;
+    success = success && patched;
+
+    // A client running a version the server no longer has gets everything.
+    client.m_fetched = 0;
+    result = client.update( 7 );
+    bool fallback( ( result == -1 ) && ( client.checksum( newImage.size() ) == crc32( newImage.data(), newImage.size() ) ) );
+    std::cout << "Unknown version: fetched " << client.m_fetched << " bytes: " << ( fallback ? "OK" : "FAILED" ) << std::endl;
+    success = success && fallback;
+
+    // Clients on many old releases don't keep them all mapped. The least
+    // recently used goes, and is mapped again from disk if asked for.
+    create_directory( "releases" );
+    for( int version( 1 ); version <= _maxReleases * 2; ++version )
+    {
+        writeImage( "releases/" + std::to_string( version ) + ".bin", makeImage( _releaseSize, version, version ) );
+    }
+    Stratus::UpdateImages releaseImages( _maxReleases );
+    bool bounded( true );
+    for( int version( 1 ); version <= _maxReleases * 2; ++version )
+    {
+        releaseImages.release( 1 ); // Kept as it's in use.
+        bounded = bounded && releaseImages.release( version ) && ( releaseImages.releasesMapped() <= _maxReleases );
+    }
+    std::shared_ptr< const Stratus::UpdateImage > evicted( releaseImages.release( 2 ) );
+    bounded = bounded && evicted && ( evicted->version() == 2 ) && ( releaseImages.releasesMapped() == _maxReleases );
+    std::cout << "Releases mapped: " << releaseImages.releasesMapped() << " of " << _maxReleases * 2 << ": "
+              << ( bounded ? "OK" : "FAILED" ) << std::endl;
+    success = success && bounded;
+
+    current_path( "/tmp" );
+    remove_all( directory );
+
+    std::cout << ( success ? "All OK" : "FAILED" ) << std::endl;
+
+    return success ? 0 : 1;
+}
+
+#endif // UPDATER_TEST
@@ -1,9 +1,13 @@
 #include "Handlers/Factories/WSHydraHandlerFactory.h"
 #include "Handlers/WSHydraHandler.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Counter.h"
+#include "Metrics/Gauge.h"
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+#include "Metrics/Timed.h"
 #include "Timers/Factories/CTimerFactory.h"
 #include "Timers/Factories/HighResTimerFactory.h"
-#include "Utils/LiteStream.h"
 #include "HydraMasterClock.h"
 #include "ReadableWritable.h"
 #include "Warp.h"
@@ -12,6 +16,8 @@
 
 #include <unistd.h>
 
+#include <cstdio>
+#include <fstream>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -20,6 +26,12 @@
 
 using namespace std::placeholders;
 
+namespace
+{
+    const char* _statsFilename( "stats.txt" );
+    const char* _statsTemporaryFilename( "stats.txt.tmp" );
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -30,9 +42,10 @@ Stratus::Stratus( int port ) :
   m_port( port ),
   m_masterClock( m_hydra ),
   m_stopping( false ),
-  m_failTLS( 0 ),
-  m_failValidate( 0 ),
-  m_fail( 0 )
+  m_failTLS( Metrics::Registry::getInstance().counter( "connections.failed.tls" ) ),
+  m_failValidate( Metrics::Registry::getInstance().counter( "connections.failed.validate" ) ),
+  m_fail( Metrics::Registry::getInstance().counter( "connections.failed" ) ),
+  m_handshakeHistogram( Metrics::Registry::getInstance().histogram( "tls.handshake" ) )
 {
     // FIXME: We also build a timer factory in each handler - could probably
     // have this and other shared things in here and pass them to makeHandler()
@@ -41,6 +54,7 @@ Stratus::Stratus( int port ) :
     ReadableWritable::setTimerFactory( m_timerFactory );
     m_performanceTimerFactory = new Timers::Factories::HighRes;
     Warp::setTimerFactory( m_performanceTimerFactory );
+    m_authorisations.reset( new Authorisations( *m_timerFactory ) );
 
     m_wsEndpoint.set_error_channels( websocketpp::log::elevel::all );
     m_wsEndpoint.set_access_channels( websocketpp::log::alevel::all ^ websocketpp::log::alevel::frame_payload );
@@ -114,6 +128,11 @@ context_ptr Stratus::onTLSInit( websocketpp::connection_hdl hdl)
     LOG_DEBUG( "Stratus: TLS init" );
 #endif
 
+    {
+    std::scoped_lock lock( m_handlersMutex );
+    m_handshakes[hdl] = Metrics::nowus();
+    }
+
     namespace asio = websocketpp::lib::asio;
 
     context_ptr ctx = websocketpp::lib::make_shared< asio::ssl::context >( asio::ssl::context::sslv23 );
@@ -185,7 +204,7 @@ context_ptr Stratus::onTLSInit( websocketpp::connection_hdl hdl)
 #ifdef LOG_STRATUS
         LOG_DEBUG( String( "TLS init exception: " ) + e.what() );
 #endif
-        ++m_failTLS;
+        m_failTLS.increment();
     }
 
     return ctx;
@@ -215,7 +234,7 @@ bool Stratus::onValidate( websocketpp::connection_hdl connectionHandle )
     LOG_DEBUG( "Stratus: Missing subprotocol Linda2. Validation failed." );
 #endif
     connection->set_status( websocketpp::http::status_code::bad_request );
-    ++m_failValidate;
+    m_failValidate.increment();
     return false;
 }
 
@@ -232,7 +251,14 @@ void Stratus::onOpen( websocketpp::connection_hdl connectionHandle )
 #endif
     std::scoped_lock lock( m_handlersMutex );
 
-    Handler* handler( m_handlerFactory.makeHandler( connection, m_hydra, m_sharedPresenceStore ) );
+    auto handshake( m_handshakes.find( connectionHandle ) );
+    if( handshake != m_handshakes.end() )
+    {
+        m_handshakeHistogram.record( Metrics::nowus() - handshake->second );
+        m_handshakes.erase( handshake );
+    }
+
+    Handler* handler( m_handlerFactory.makeHandler( connection, m_hydra, m_sharedPresenceStore, m_updateImages, m_accountStore, *m_authorisations ) );
     m_handlers[connectionHandle] = handler;
     handler->handle();
 }
@@ -247,7 +273,10 @@ void Stratus::onFail( websocketpp::connection_hdl connectionHandle )
 
     websocketpp::lib::asio::error_code ec( connection->get_transport_ec() );
 
-    ++m_fail;
+    m_fail.increment();
+
+    std::scoped_lock lock( m_handlersMutex );
+    m_handshakes.erase( connectionHandle );
 }
 
 void Stratus::onClose( websocketpp::connection_hdl connectionHandle )
@@ -258,6 +287,8 @@ void Stratus::onClose( websocketpp::connection_hdl connectionHandle )
 
     std::scoped_lock lock( m_handlersMutex );
 
+    m_handshakes.erase( connectionHandle );
+
     auto it( m_handlers.find( connectionHandle ) );
     if( it != m_handlers.end() )
     {
@@ -277,18 +308,56 @@ void Stratus::runClock()
 
 void Stratus::runStats()
 {
+    Metrics::Registry& metrics( Metrics::Registry::getInstance() );
+    Metrics::Gauge& connections( metrics.gauge( "connections" ) );
+    Metrics::Gauge& maxQueueDepth( metrics.gauge( "queue.client.depth.max" ) );
+    Metrics::Gauge& queueDropped( metrics.gauge( "queue.client.dropped" ) );
+    Metrics::Gauge& queueCoalesced( metrics.gauge( "queue.client.coalesced" ) );
+    Metrics::Gauge& authLocalHits( metrics.gauge( "auth.hits.local" ) );
+    Metrics::Gauge& authSharedHits( metrics.gauge( "auth.hits.shared" ) );
+    Metrics::Gauge& authRefusalHits( metrics.gauge( "auth.hits.refused" ) );
+    Metrics::Gauge& authMisses( metrics.gauge( "auth.misses" ) );
+    Metrics::Gauge& authExpired( metrics.gauge( "auth.expired" ) );
+    Metrics::Gauge& authInvalidations( metrics.gauge( "auth.invalidations" ) );
+
     while( !m_stopping )
     {
         {
         std::scoped_lock lock( m_handlersMutex );
-        LiteStream stream;
-        stream << "Connections: " << m_handlers.size()
-               << " Failed TLS: " << m_failTLS
-               << " Failed val: " << m_failValidate
-               << " Fail: " << m_fail;
-        LOG_DEBUG( stream.str() );
+
+        connections.set( m_handlers.size() );
+
+        int maxDepth( 0 );
+        long dropped( 0 );
+        long coalesced( 0 );
+        for( auto it( m_handlers.begin() ); it != m_handlers.end(); ++it )
+        {
+            int queueDepth( it->second->queueDepth() );
+            if( queueDepth > maxDepth ) maxDepth = queueDepth;
+            dropped += it->second->queueDropped();
+            coalesced += it->second->queueCoalesced();
+        }
+
+        maxQueueDepth.set( maxDepth );
+        queueDropped.set( dropped );
+        queueCoalesced.set( coalesced );
         }
 
+        Authorisations::Counters authorisations( m_authorisations->counters() );
+        authLocalHits.set( authorisations.m_localHits );
+        authSharedHits.set( authorisations.m_sharedHits );
+        authRefusalHits.set( authorisations.m_refusalHits );
+        authMisses.set( authorisations.m_misses );
+        authExpired.set( authorisations.m_expired );
+        authInvalidations.set( authorisations.m_invalidations );
+
+        // Write elsewhere then rename, so that readers never see half a file.
+        String dump( metrics.dump() );
+        std::ofstream file( _statsTemporaryFilename );
+        file.write( dump.c_str(), dump.length() );
+        file.close();
+        ::rename( _statsTemporaryFilename, _statsFilename );
+
         usleep( 1000000 );
     }
 }
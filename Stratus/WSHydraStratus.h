@@ -1,10 +1,13 @@
 #ifndef AGAPE_STRATUS_H
 #define AGAPE_STRATUS_H
 
+#include "AccountStores/MongoAccountStore.h"
 #include "Handlers/Factories/WSHydraHandlerFactory.h"
 #include "PresenceLoaders/SharedPresenceStore.h"
 #include "Hydra.h"
 #include "HydraMasterClock.h"
+#include "Authorisations.h"
+#include "UpdateImages.h"
 #include "WebSockets.h"
 
 #include "Timers/Factories/TimerFactory.h"
@@ -17,6 +20,12 @@
 namespace Agape
 {
 
+namespace Metrics
+{
+class Counter;
+class Histogram;
+} // namespace Metrics
+
 namespace Stratus
 {
 
@@ -51,6 +60,12 @@ private:
 
     PresenceLoaders::SharedPresenceStore m_sharedPresenceStore;
 
+    UpdateImages m_updateImages;
+
+    AccountStores::Mongo m_accountStore;
+
+    std::unique_ptr< Authorisations > m_authorisations;
+
     HandlerFactory m_handlerFactory;
 
     std::map< websocketpp::connection_hdl, Handler*, std::owner_less< websocketpp::connection_hdl > > m_handlers;
@@ -63,9 +78,13 @@ private:
     Timers::Factory* m_performanceTimerFactory;
 
     std::mutex m_handlersMutex;
-    int m_failTLS;
-    int m_failValidate;
-    int m_fail;
+    Metrics::Counter& m_failTLS;
+    Metrics::Counter& m_failValidate;
+    Metrics::Counter& m_fail;
+
+    // When each connection's TLS handshake began, until it opens or fails.
+    std::map< websocketpp::connection_hdl, long long, std::owner_less< websocketpp::connection_hdl > > m_handshakes;
+    Metrics::Histogram& m_handshakeHistogram;
     std::unique_ptr< std::thread > m_statsThread;
 };
 
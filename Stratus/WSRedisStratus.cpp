@@ -1,9 +1,13 @@
 #include "Handlers/Factories/WSRedisHandlerFactory.h"
 #include "Handlers/WSRedisHandler.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Counter.h"
+#include "Metrics/Gauge.h"
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+#include "Metrics/Timed.h"
 #include "Timers/Factories/CTimerFactory.h"
 #include "Timers/Factories/HighResTimerFactory.h"
-#include "Utils/LiteStream.h"
 #include "ReadableWritable.h"
 #include "RedisMasterClock.h"
 #include "Warp.h"
@@ -12,6 +16,8 @@
 
 #include <unistd.h>
 
+#include <cstdio>
+#include <fstream>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -20,6 +26,12 @@
 
 using namespace std::placeholders;
 
+namespace
+{
+    const char* _statsFilename( "stats.txt" );
+    const char* _statsTemporaryFilename( "stats.txt.tmp" );
+} // Anonymous namespace
+
 namespace Agape
 {
 
@@ -29,9 +41,10 @@ namespace Stratus
 Stratus::Stratus( int port ) :
   m_port( port ),
   m_stopping( false ),
-  m_failTLS( 0 ),
-  m_failValidate( 0 ),
-  m_fail( 0 )
+  m_failTLS( Metrics::Registry::getInstance().counter( "connections.failed.tls" ) ),
+  m_failValidate( Metrics::Registry::getInstance().counter( "connections.failed.validate" ) ),
+  m_fail( Metrics::Registry::getInstance().counter( "connections.failed" ) ),
+  m_handshakeHistogram( Metrics::Registry::getInstance().histogram( "tls.handshake" ) )
 {
     // FIXME: We also build a timer factory in each handler - could probably
     // have this and other shared things in here and pass them to makeHandler()
@@ -40,6 +53,7 @@ Stratus::Stratus( int port ) :
     ReadableWritable::setTimerFactory( m_timerFactory );
     m_performanceTimerFactory = new Timers::Factories::HighRes;
     Warp::setTimerFactory( m_performanceTimerFactory );
+    m_authorisations.reset( new Authorisations( *m_timerFactory ) );
 
     m_wsEndpoint.set_error_channels( websocketpp::log::elevel::all );
     m_wsEndpoint.set_access_channels( websocketpp::log::alevel::all ^ websocketpp::log::alevel::frame_payload );
@@ -113,6 +127,11 @@ context_ptr Stratus::onTLSInit( websocketpp::connection_hdl hdl)
     LOG_DEBUG( "Stratus: TLS init" );
 #endif
 
+    {
+    std::scoped_lock lock( m_handlersMutex );
+    m_handshakes[hdl] = Metrics::nowus();
+    }
+
     namespace asio = websocketpp::lib::asio;
 
     context_ptr ctx = websocketpp::lib::make_shared< asio::ssl::context >( asio::ssl::context::sslv23 );
@@ -184,7 +203,7 @@ context_ptr Stratus::onTLSInit( websocketpp::connection_hdl hdl)
 #ifdef LOG_STRATUS
         LOG_DEBUG( String( "TLS init exception: " ) + e.what() );
 #endif
-        ++m_failTLS;
+        m_failTLS.increment();
     }
 
     return ctx;
@@ -214,7 +233,7 @@ bool Stratus::onValidate( websocketpp::connection_hdl connectionHandle )
     LOG_DEBUG( "Stratus: Missing subprotocol Linda2. Validation failed." );
 #endif
     connection->set_status( websocketpp::http::status_code::bad_request );
-    ++m_failValidate;
+    m_failValidate.increment();
     return false;
 }
 
@@ -231,7 +250,14 @@ void Stratus::onOpen( websocketpp::connection_hdl connectionHandle )
 #endif
     std::scoped_lock lock( m_handlersMutex );
 
-    Handler* handler( m_handlerFactory.makeHandler( connection, m_sharedPresenceStore ) );
+    auto handshake( m_handshakes.find( connectionHandle ) );
+    if( handshake != m_handshakes.end() )
+    {
+        m_handshakeHistogram.record( Metrics::nowus() - handshake->second );
+        m_handshakes.erase( handshake );
+    }
+
+    Handler* handler( m_handlerFactory.makeHandler( connection, m_sharedPresenceStore, m_updateImages, m_accountStore, *m_authorisations ) );
     m_handlers[connectionHandle] = handler;
     handler->handle();
 }
@@ -246,7 +272,10 @@ void Stratus::onFail( websocketpp::connection_hdl connectionHandle )
 
     websocketpp::lib::asio::error_code ec( connection->get_transport_ec() );
 
-    ++m_fail;
+    m_fail.increment();
+
+    std::scoped_lock lock( m_handlersMutex );
+    m_handshakes.erase( connectionHandle );
 }
 
 void Stratus::onClose( websocketpp::connection_hdl connectionHandle )
@@ -257,6 +286,8 @@ void Stratus::onClose( websocketpp::connection_hdl connectionHandle )
 
     std::scoped_lock lock( m_handlersMutex );
 
+    m_handshakes.erase( connectionHandle );
+
     auto it( m_handlers.find( connectionHandle ) );
     if( it != m_handlers.end() )
     {
@@ -276,18 +307,38 @@ void Stratus::runClock()
 
 void Stratus::runStats()
 {
+    Metrics::Registry& metrics( Metrics::Registry::getInstance() );
+    Metrics::Gauge& connections( metrics.gauge( "connections" ) );
+    Metrics::Gauge& authLocalHits( metrics.gauge( "auth.hits.local" ) );
+    Metrics::Gauge& authSharedHits( metrics.gauge( "auth.hits.shared" ) );
+    Metrics::Gauge& authRefusalHits( metrics.gauge( "auth.hits.refused" ) );
+    Metrics::Gauge& authMisses( metrics.gauge( "auth.misses" ) );
+    Metrics::Gauge& authExpired( metrics.gauge( "auth.expired" ) );
+    Metrics::Gauge& authInvalidations( metrics.gauge( "auth.invalidations" ) );
+
     while( !m_stopping )
     {
         {
         std::scoped_lock lock( m_handlersMutex );
-        LiteStream stream;
-        stream << "Connections: " << m_handlers.size()
-               << " Failed TLS: " << m_failTLS
-               << " Failed val: " << m_failValidate
-               << " Fail: " << m_fail;
-        LOG_DEBUG( stream.str() );
+
+        connections.set( m_handlers.size() );
         }
 
+        Authorisations::Counters authorisations( m_authorisations->counters() );
+        authLocalHits.set( authorisations.m_localHits );
+        authSharedHits.set( authorisations.m_sharedHits );
+        authRefusalHits.set( authorisations.m_refusalHits );
+        authMisses.set( authorisations.m_misses );
+        authExpired.set( authorisations.m_expired );
+        authInvalidations.set( authorisations.m_invalidations );
+
+        // Write elsewhere then rename, so that readers never see half a file.
+        String dump( metrics.dump() );
+        std::ofstream file( _statsTemporaryFilename );
+        file.write( dump.c_str(), dump.length() );
+        file.close();
+        ::rename( _statsTemporaryFilename, _statsFilename );
+
         usleep( 1000000 );
     }
 }
@@ -1,6 +1,7 @@
 #include "Databases/MongoDB/MongoDB.h"
 #include "Databases/MongoDB/MongoDocumentBuilder.h"
 #include "Loggers/Logger.h"
+#include "Metrics/Timed.h"
 #include "World/Teleport.h"
 #include "World/UniverseStats.h"
 #include "World/WorldMetadata.h"
@@ -41,6 +42,8 @@ Mongo::Mongo( Stratus::Authenticator& authenticator ) :
 
 bool Mongo::create( const World::Metadata& metadata, String& reason )
 {
+    METRICS_TIMED( "mongo.world.create" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoWorldLoader: Creating world." );
 #endif
@@ -54,6 +57,8 @@ bool Mongo::create( const World::Metadata& metadata, String& reason )
     Value metadataValue;
     metadata.toValue( metadataValue );
     metadataValue.erase( _privateKey ); // Don't save private key to Worlds collection!
+    metadataValue["userCount"] = int( metadata.m_users.size() );
+    metadataValue["itemCount"] = int( 0 );
     bsoncxx::document::value bsonDocument( DocumentBuilder::build( metadataValue ) );
 
     try
@@ -99,6 +104,8 @@ bool Mongo::create( const World::Metadata& metadata, String& reason )
 
 bool Mongo::join( World::Metadata& metadata, String& reason )
 {
+    METRICS_TIMED( "mongo.world.join" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoWorldLoader: Joining world." );
 #endif
@@ -129,11 +136,44 @@ bool Mongo::join( World::Metadata& metadata, String& reason )
                     auto client( MongoDB::pool().acquire() );
                     auto collection( ( *client )[_Agape][_Worlds] );
 
+                    // Add the user and recount in one update, so that
+                    // concurrent joins can't leave userCount behind the
+                    // list. The user is a $literal in case any of its
+                    // strings start with '$'.
+                    mongocxx::pipeline pipeline;
+                    pipeline.add_fields( document() << "users"
+                                                    << open_document
+                                                      << "$setUnion"
+                                                      << open_array
+                                                        << open_document
+                                                          << "$ifNull"
+                                                          << open_array
+                                                            << "$users"
+                                                            << open_array
+                                                            << close_array
+                                                          << close_array
+                                                        << close_document
+                                                        << open_document
+                                                          << "$literal"
+                                                          << open_array
+                                                            << bsonUser
+                                                          << close_array
+                                                        << close_document
+                                                      << close_array
+                                                    << close_document
+                                                    << finalize );
+                    pipeline.add_fields( document() << "userCount"
+                                                    << open_document
+                                                      << "$size"
+                                                      << "$users"
+                                                    << close_document
+                                                    << finalize );
+
                     options::find_one_and_update options;
                     bsoncxx::stdx::optional< bsoncxx::document::value > world(
                         collection.find_one_and_update(
                             document() << "worldAuthKey" << metadata.m_worldAuthKey << finalize,
-                            document() << "$addToSet" << open_document << "users" << bsonUser << close_document << finalize,
+                            pipeline,
                             options.return_document( options::return_document::k_after )
                         )
                     );
@@ -192,6 +232,8 @@ bool Mongo::join( World::Metadata& metadata, String& reason )
 
 bool Mongo::load( World::Metadata& metadata, String& reason )
 {
+    METRICS_TIMED( "mongo.world.load" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoWorldLoader: Loading world." );
 #endif
@@ -240,6 +282,8 @@ bool Mongo::load( World::Metadata& metadata, String& reason )
 
 bool Mongo::loadJoinedWorlds( Vector< World::Metadata >& joinedWorlds, bool allDevices, String& reason )
 {
+    METRICS_TIMED( "mongo.world.loadJoinedWorlds" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoWorldLoader: Loading joined worlds." );
 #endif
@@ -254,6 +298,8 @@ bool Mongo::loadJoinedWorlds( Vector< World::Metadata >& joinedWorlds, bool allD
 
 bool Mongo::loadTeleports( Vector< World::Teleport >& teleports, bool allDevices, String& reason )
 {
+    METRICS_TIMED( "mongo.world.loadTeleports" );
+
 #ifdef LOG_LOADERS
     LOG_DEBUG( "MongoWorldLoader: Loading teleports." );
 #endif
@@ -268,6 +314,8 @@ bool Mongo::loadTeleports( Vector< World::Teleport >& teleports, bool allDevices
 
 bool Mongo::createTeleport( World::Teleport& teleport, String& reason )
 {
+    METRICS_TIMED( "mongo.world.createTeleport" );
+
     // Add this teleport to the current user's teleports (for the
     // current device).
 
@@ -318,6 +366,8 @@ bool Mongo::createTeleport( World::Teleport& teleport, String& reason )
 
 bool Mongo::deleteTeleport( World::Teleport& teleport, String& reason )
 {
+    METRICS_TIMED( "mongo.world.deleteTeleport" );
+
     // Delete this teleport from the current user's teleports (for the
     // current device).
 
@@ -359,117 +409,107 @@ bool Mongo::deleteTeleport( World::Teleport& teleport, String& reason )
 
 bool Mongo::loadWorldSummaries( Vector< World::Summary >& worldSummaries, int from, int size, String& reason )
 {
-    // FIXME: This whole process is probably horrifically slow and we likely
-    // need to cache world item and user counts (either in RAM or in the
-    // database itself...). Also, given loadJoinedWorlds only returns a single
-    // user (the current user) for each world, we need to do a second lookup
-    // for each joined world, which will slow us down.
-    bool success( true );
+    METRICS_TIMED( "mongo.world.loadWorldSummaries" );
 
-    Vector< World::Metadata > joinedWorlds;
-    success = loadJoinedWorlds( joinedWorlds, false, reason );
+    // Joined worlds are listed first, in the order joined, followed by all
+    // other worlds in world ID order. User and item counts are read from the
+    // counters kept on each world document, so only the requested page of
+    // worlds is ever read.
+    Vector< String > joinedWorldIDs;
+    const String& accountAuthKeyHash( m_authenticator.accountAuthKeyHash() );
+    const String& deviceAuthKeyHash( m_authenticator.deviceAuthKeyHash() );
+    if( !withDevice( accountAuthKeyHash,
+                     deviceAuthKeyHash,
+                     false,
+                     reason,
+                     std::bind( &Mongo::getDeviceJoinedWorldIDs, this, std::ref( joinedWorldIDs ), _1, _2 ) ) )
+    {
+        return false;
+    }
 
-    Vector< World::Summary > allWorldSummaries;
+    bool success( true );
+    int joinedCount( joinedWorldIDs.size() );
 
-    if( success )
+    try
     {
-        Vector< World::Metadata >::const_iterator joinedWorldsIt( joinedWorlds.begin() );
-        for( ; joinedWorldsIt != joinedWorlds.end(); ++joinedWorldsIt )
+        auto client( MongoDB::pool().acquire() );
+        auto collection( ( *client )[_Agape][_Worlds] );
+
+        options::find options;
+        options.projection( document() << "worldID" << 1 << "userCount" << 1 << "itemCount" << 1 << finalize );
+
+        if( from < joinedCount )
         {
-            int itemCount( 0 );
-            if( !worldItemCount( joinedWorldsIt->m_worldID, itemCount, reason ) )
+            int joinedEnd( ( from + size ) < joinedCount ? ( from + size ) : joinedCount );
+
+            Value query;
+            Value& worldIDs( query["worldID"]["$in"] );
+            for( int idx( from ); idx < joinedEnd; ++idx )
             {
-                success = false;
-                break;
+                worldIDs.push_back( new Value( joinedWorldIDs[idx] ) );
             }
 
-            // Load just this world, as loadJoinedWorlds doesn't give us all
-            // users, but this will.
-            World::Metadata thisWorldMetadata;
-            thisWorldMetadata.m_worldAuthKey = joinedWorldsIt->m_worldAuthKey;
-            if( load( thisWorldMetadata, reason ) )
+            Map< String, World::Summary > joinedSummaries;
+            mongocxx::cursor worldsCursor( collection.find( DocumentBuilder::build( query ), options ) );
+            mongocxx::cursor::iterator cursorIt( worldsCursor.begin() );
+            for( ; success && ( cursorIt != worldsCursor.end() ); ++cursorIt )
             {
                 World::Summary summary;
-                summary.m_worldID = joinedWorldsIt->m_worldID;
-                summary.m_users = thisWorldMetadata.m_users.size();
-                summary.m_items = itemCount;
-                allWorldSummaries.push_back( summary );
+                success = summaryFromDocument( Value( DocumentBuilder::unbuild( *cursorIt ) ), summary, reason );
+                joinedSummaries[summary.m_worldID] = summary;
             }
-            else
+
+            // Restore joined order.
+            for( int idx( from ); success && ( idx < joinedEnd ); ++idx )
             {
-                success = false;
-                break;
+                Map< String, World::Summary >::const_iterator summaryIt( joinedSummaries.find( joinedWorldIDs[idx] ) );
+                if( summaryIt != joinedSummaries.end() )
+                {
+                    worldSummaries.push_back( summaryIt->second );
+                }
+                else
+                {
+                    LOG_DEBUG( "MongoWorldLoader: Unable to find world for joined world ID " + joinedWorldIDs[idx] );
+                }
             }
         }
 
-        if( success )
+        int remain( size - worldSummaries.size() );
+        if( success && ( remain > 0 ) )
         {
-            try
+            Value query;
+            if( joinedCount > 0 )
             {
-                auto client( MongoDB::pool().acquire() );
-                auto worldsCollection( ( *client )[_Agape][_Worlds] );
-                
-                mongocxx::cursor distinctCursor(
-                    worldsCollection.distinct( "worldID",
-                                            document() << finalize )
-                );
-
-                bsoncxx::document::view resultView( *distinctCursor.begin() );
-                Value resultValue( DocumentBuilder::unbuild( resultView ) );
-                Value resultValueValues( resultValue[_values] );
-                
-                ListIterator listIt( resultValueValues.listBegin() );
-                for( ; listIt != resultValueValues.listEnd(); ++listIt )
+                Value& worldIDs( query["worldID"]["$nin"] );
+                Vector< String >::const_iterator joinedIt( joinedWorldIDs.begin() );
+                for( ; joinedIt != joinedWorldIDs.end(); ++joinedIt )
                 {
-                    // FIXME: O(n^2)! Refactor.
-                    Vector< World::Summary >::const_iterator existingIt( allWorldSummaries.begin() );
-                    for( ; existingIt != allWorldSummaries.end(); ++existingIt )
-                    {
-                        if( existingIt->m_worldID == **listIt )
-                        {
-                            break;
-                        }
-                    }
-
-                    if( existingIt == allWorldSummaries.end() )
-                    {
-                        int userCount( 0 );
-                        int itemCount( 0 );
-
-                        if( worldUserCount( **listIt, userCount, reason ) &&
-                            worldItemCount( **listIt, itemCount, reason ) )
-                        {
-                            World::Summary summary;
-                            summary.m_worldID = **listIt;
-                            summary.m_users = userCount;
-                            summary.m_items = itemCount;
-                            allWorldSummaries.push_back( summary );
-                        }
-                        else
-                        {
-                            success = false;
-                            break;
-                        }
-                    }
+                    worldIDs.push_back( new Value( *joinedIt ) );
                 }
             }
-            catch( mongocxx::exception& e )
+
+            options.sort( document() << "worldID" << 1 << finalize );
+            options.skip( from > joinedCount ? ( from - joinedCount ) : 0 );
+            options.limit( remain );
+
+            mongocxx::cursor worldsCursor( collection.find( DocumentBuilder::build( query ), options ) );
+            mongocxx::cursor::iterator cursorIt( worldsCursor.begin() );
+            for( ; success && ( cursorIt != worldsCursor.end() ); ++cursorIt )
             {
-                LOG_DEBUG( "MongoWorldLoader: Exception loading world IDs: " + String( e.what() ) );
-                success = false;
+                World::Summary summary;
+                success = summaryFromDocument( Value( DocumentBuilder::unbuild( *cursorIt ) ), summary, reason );
+                if( success )
+                {
+                    worldSummaries.push_back( summary );
+                }
             }
         }
     }
-
-    if( success )
+    catch( mongocxx::exception& e )
     {
-        for( int idx = 0; ( ( idx < ( from + size ) ) && ( idx < allWorldSummaries.size() ) ); ++idx )
-        {
-            if( idx >= from )
-            {
-                worldSummaries.push_back( allWorldSummaries[idx] );
-            }
-        }
+        LOG_DEBUG( "MongoWorldLoader: Exception loading world summaries: " + String( e.what() ) );
+        reason = "Server error";
+        success = false;
     }
 
     return success;
@@ -477,6 +517,8 @@ bool Mongo::loadWorldSummaries( Vector< World::Summary >& worldSummaries, int fr
 
 bool Mongo::loadUniverseStats( World::UniverseStats& universeStats, String& reason )
 {
+    METRICS_TIMED( "mongo.world.loadUniverseStats" );
+
     return( worldItemCount( String(), universeStats.m_items, reason ) ); // With no world ID, will get universe count.
 }
 
@@ -660,6 +702,49 @@ bool Mongo::getDeviceTeleports( Vector< World::Teleport >& teleports, const Valu
     return true;
 }
 
+bool Mongo::getDeviceJoinedWorldIDs( Vector< String >& joinedWorldIDs, const Value* deviceValue, String& reason )
+{
+    const Value& joinedWorldsValue( ( *deviceValue )[_joinedWorlds] );
+    Vector< Value* >::const_iterator joinedWorldsIt( joinedWorldsValue.listBegin() );
+    for( ; joinedWorldsIt != joinedWorldsValue.listEnd(); ++joinedWorldsIt )
+    {
+        joinedWorldIDs.push_back( ( **joinedWorldsIt )[_worldID] );
+    }
+
+    return true;
+}
+
+bool Mongo::summaryFromDocument( const Value& worldValue, World::Summary& summary, String& reason )
+{
+    summary.m_worldID = worldValue["worldID"];
+
+    if( worldValue.hasValue( "userCount" ) && worldValue.hasValue( "itemCount" ) )
+    {
+        summary.m_users = worldValue["userCount"];
+        summary.m_items = worldValue["itemCount"];
+        return true;
+    }
+
+    // World pre-dates the counters, so count the slow way, once, and store
+    // the counts for scene and world loaders to maintain from now on.
+    if( !worldUserCount( summary.m_worldID, summary.m_users, reason ) ||
+        !worldItemCount( summary.m_worldID, summary.m_items, reason ) )
+    {
+        return false;
+    }
+
+    auto client( MongoDB::pool().acquire() );
+    auto collection( ( *client )[_Agape][_Worlds] );
+    collection.update_one(
+        document() << "worldID" << summary.m_worldID << finalize,
+        document() << "$set" << open_document << "userCount" << summary.m_users
+                                              << "itemCount" << summary.m_items
+                             << close_document << finalize
+    );
+
+    return true;
+}
+
 bool Mongo::worldUserCount( const String& worldID, int& count, String& reason )
 {
     bool success( true );
@@ -729,9 +814,14 @@ bool Mongo::worldItemCount( const String& worldID, int& count, String& reason )
             collection.aggregate( pipeline )
         );
 
-        bsoncxx::document::view resultView( *aggregateCursor.begin() );
-        Value resultValue( DocumentBuilder::unbuild( resultView ) );
-        count = resultValue["itemCount"];
+        // No scenes means no result document.
+        count = 0;
+        mongocxx::cursor::iterator resultIt( aggregateCursor.begin() );
+        if( resultIt != aggregateCursor.end() )
+        {
+            Value resultValue( DocumentBuilder::unbuild( *resultIt ) );
+            count = resultValue["itemCount"];
+        }
     }
     catch( mongocxx::exception& e )
     {
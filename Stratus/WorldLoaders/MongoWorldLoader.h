@@ -2,6 +2,8 @@
 #define AGAPE_WORLD_LOADERS_MONGO_H
 
 #include "World/WorldMetadata.h"
+#include "World/WorldSummary.h"
+#include "Collections.h"
 #include "String.h"
 #include "WorldLoader.h"
 
@@ -49,6 +51,9 @@ private:
                      std::function< bool( const Value*, String& ) > deviceCallback );
     bool getDeviceJoinedWorlds( Vector< World::Metadata >& joinedWorlds, const Value* deviceValue, String& reason );
     bool getDeviceTeleports( Vector< World::Teleport >& teleports, const Value* deviceValue, String& reason );
+    bool getDeviceJoinedWorldIDs( Vector< String >& joinedWorldIDs, const Value* deviceValue, String& reason );
+
+    bool summaryFromDocument( const Value& worldValue, World::Summary& summary, String& reason );
 
     bool worldUserCount( const String& worldID, int& count, String& reason );
     bool worldItemCount( const String& worldID, int& count, String& reason );
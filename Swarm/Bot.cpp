@@ -0,0 +1,361 @@
+#include "Loggers/Logger.h"
+#include "Metrics/Counter.h"
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+#include "Metrics/Timed.h"
+#include "Timers/Factories/TimerFactory.h"
+#include "Timers/Timer.h"
+#include "Utils/base64/base64.h"
+#include "Utils/StrToHex.h"
+#include "World/Direction.h"
+#include "Bot.h"
+#include "Latencies.h"
+#include "Scenario.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleRouter.h"
+#include "TupleRoutingCriteria.h"
+#include "Value.h"
+
+#include <string>
+
+#include <stdlib.h>
+
+namespace
+{
+    const int _configurationSize( 0x1000 );
+    const int _authKeyLength( 32 );
+    const int _rwBufferSize( 8192 ); // As the client: a whole compressed frame per message.
+
+    const long _connectTimeoutms( 30000 );
+    const long _walkIntervalms( 150 ); // About as fast as anyone holds down a key.
+
+    const int _userGlyph( 0x02 );
+
+    Agape::String base64( const Agape::String& raw )
+    {
+        Agape::String encoded;
+        encoded.resize( Base64encode_len( raw.length() ), '\0' );
+        Base64encode( &encoded[0], raw.data(), raw.length() );
+        encoded.resize( encoded.length() - 1 );
+        return encoded;
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Swarm
+{
+
+Bot::Bot( int number,
+          WSTLSClient& endpoint,
+          const String& url,
+          const Scenario& scenario,
+          Latencies& latencies,
+          Timers::Factory& timerFactory,
+          long startms ) :
+  m_name( ( "Bot" + std::to_string( number ) ).c_str() ),
+  m_url( url ),
+  m_scenario( scenario ),
+  m_seed( number + 1 ),
+  m_configurationMemory( _configurationSize, _configurationSize, _configurationSize, Memory::eeprom ),
+  m_configurationStore( m_configurationMemory ),
+  m_worldbook( m_configurationStore ),
+  m_connection( endpoint ),
+  m_rwBuffer( _rwBufferSize, m_connection ),
+  m_rwCompressor( m_compressor, m_rwBuffer ),
+  m_rwRoute( "Stratus", m_rwCompressor ),
+  m_route( "Timing", m_rwRoute, latencies ),
+  m_tupleRouter( m_tupleDispatcher, m_name, timerFactory ),
+  m_programManager( m_tupleRouter, m_functionDispatcher ),
+  m_sceneLoaderFactory( m_tupleRouter, timerFactory ),
+  m_assetLoaderFactory( m_tupleRouter, timerFactory, "Assets" ),
+  m_programAssetLoaderFactory( m_tupleRouter, timerFactory, "Programs" ),
+  m_presenceLoaderFactory( m_tupleRouter, timerFactory ),
+  m_terminal( 80, 25, _Map, m_graphicsDriver, m_animationTimer ),
+  m_midiPlayer( m_assetLoaderFactory ),
+  m_compositor( m_terminal,
+                m_sceneLoaderFactory,
+                m_assetLoaderFactory,
+                m_presenceLoaderFactory,
+                m_worldbook,
+                m_tupleRouter,
+                m_programManager,
+                m_programAssetLoaderFactory,
+                timerFactory,
+                m_clock,
+                m_midiPlayer ),
+  m_entered( false ),
+  m_timer( timerFactory.makeTimer() ),
+  m_duems( startms ),
+  m_opened( false ),
+  m_failed( false ),
+  m_step( 0 ),
+  m_walked( 0 ),
+  m_chats( 0 ),
+  m_connectHistogram( Metrics::Registry::getInstance().histogram( "swarm.connect" ) ),
+  m_enterHistogram( Metrics::Registry::getInstance().histogram( "swarm.enter" ) ),
+  m_connected( Metrics::Registry::getInstance().counter( "swarm.connected" ) ),
+  m_failures( Metrics::Registry::getInstance().counter( "swarm.failed" ) )
+{
+    m_tupleRouter.addRoute( &m_route );
+    m_tupleRouter.setMyID( m_name );
+
+    // A store of our own, with keys no account has. Stratus built with
+    // LOCUST lets anyone in.
+    String accountAuthKey;
+    String deviceAuthKey;
+    for( int i( 0 ); i < _authKeyLength; ++i )
+    {
+        accountAuthKey.push_back( (char)rand_r( &m_seed ) );
+        deviceAuthKey.push_back( (char)rand_r( &m_seed ) );
+    }
+    m_configurationStore.get( _accountAuthKey ) = accountAuthKey;
+    m_configurationStore.get( _deviceAuthKey ) = deviceAuthKey;
+
+    m_user.m_snowflake = uintToHex( ( (unsigned int)number << 16 ) ^ rand_r( &m_seed ) );
+    m_user.m_name = m_name;
+    m_user.m_glyph = _userGlyph;
+    m_user.m_attributes = 1 + ( number % 15 );
+    m_compositor.setUser( m_user );
+}
+
+Bot::~Bot()
+{
+    m_tupleRouter.removeRoute( &m_route );
+    m_connection.close();
+    delete( m_timer );
+}
+
+bool Bot::run()
+{
+    if( m_failed )
+    {
+        return false;
+    }
+
+    if( !m_opened )
+    {
+        if( m_timer->ms() < m_duems )
+        {
+            return true;
+        }
+
+        m_opened = true;
+        m_duems = m_timer->ms();
+        if( !m_connection.open( m_url ) )
+        {
+            fail();
+            return false;
+        }
+    }
+
+    if( m_connection.error() )
+    {
+        fail();
+        return false;
+    }
+
+    if( m_connection.isOpen() )
+    {
+        m_tupleRouter.run();
+        if( m_entered )
+        {
+            m_compositor.run();
+        }
+    }
+
+    if( m_timer->ms() < m_duems )
+    {
+        return true;
+    }
+
+    const Vector< Scenario::Step >& steps( m_scenario.steps() );
+    if( m_step >= steps.size() )
+    {
+        return false;
+    }
+
+    const Scenario::Step& step( steps[m_step] );
+    switch( step.m_type )
+    {
+        case Scenario::Step::login:
+            if( !m_connection.isOpen() )
+            {
+                if( ( m_timer->ms() - m_duems ) > _connectTimeoutms )
+                {
+                    fail();
+                    return false;
+                }
+                return true;
+            }
+            m_connectHistogram.record( ( m_timer->ms() - m_duems ) * 1000 );
+            login();
+            ++m_step;
+            break;
+
+        case Scenario::Step::enter:
+            enter( World::Coordinates( step.m_text, step.m_x, step.m_y ),
+                   m_compositor.height() / 2,
+                   m_compositor.width() / 2 );
+            ++m_step;
+            break;
+
+        case Scenario::Step::walk:
+            if( m_entered )
+            {
+                walk( ( step.m_direction == World::Direction::none ) ?
+                      (enum World::Direction::_Direction)( rand_r( &m_seed ) % 4 ) : step.m_direction );
+            }
+            m_duems = m_timer->ms() + _walkIntervalms;
+            if( ++m_walked >= step.m_count )
+            {
+                m_walked = 0;
+                ++m_step;
+            }
+            break;
+
+        case Scenario::Step::chat:
+            if( m_entered )
+            {
+                chat( step.m_text );
+            }
+            ++m_step;
+            break;
+
+        case Scenario::Step::teleport:
+            if( m_entered )
+            {
+                enter( World::Coordinates( m_coordinates.m_worldID, step.m_x, step.m_y ),
+                       m_compositor.positionRow(),
+                       m_compositor.positionCol() );
+            }
+            ++m_step;
+            break;
+
+        case Scenario::Step::wait:
+            m_duems = m_timer->ms() + step.m_count;
+            ++m_step;
+            break;
+
+        case Scenario::Step::repeat:
+            m_step = m_scenario.repeatFrom();
+            break;
+    }
+
+    return true;
+}
+
+bool Bot::failed() const
+{
+    return m_failed;
+}
+
+// As ConnectionMonitor on connecting.
+void Bot::login()
+{
+    Tuple keyTuple;
+    TupleRouter::setSourceID( keyTuple, m_tupleRouter.myID() );
+    TupleRouter::setTupleType( keyTuple, _Authenticate );
+    keyTuple[_accountAuthKey] = base64( m_configurationStore.get( _accountAuthKey ) );
+    keyTuple[_deviceAuthKey] = base64( m_configurationStore.get( _deviceAuthKey ) );
+    m_tupleRouter.route( keyTuple );
+
+    TupleRoutingCriteria tupleRoutingCriteria;
+    tupleRoutingCriteria.m_destinationIDs.push_back( new Value( m_tupleRouter.myID() ) );
+    m_route.sendAddRoutingCriteriaRequest( tupleRoutingCriteria );
+
+    m_connected.increment();
+}
+
+void Bot::enter( const World::Coordinates& coordinates, int row, int col )
+{
+    {
+    Metrics::Timed timed( m_enterHistogram );
+    m_coordinates = coordinates;
+    m_compositor.render( m_coordinates );
+    m_compositor.setPosition( row, col );
+    }
+
+    m_entered = true;
+    addChatRoutingCriteria();
+}
+
+// As WalkStrategy, which moves on to the next scene at an edge.
+void Bot::walk( enum World::Direction::_Direction direction )
+{
+    bool atEdge( false );
+    m_compositor.walk( direction, atEdge );
+    if( !atEdge )
+    {
+        return;
+    }
+
+    World::Coordinates coordinates( m_coordinates );
+    int row( m_compositor.positionRow() );
+    int col( m_compositor.positionCol() );
+    switch( direction )
+    {
+        case World::Direction::up:    ++coordinates.m_y; row = m_compositor.height() - 1; break;
+        case World::Direction::down:  --coordinates.m_y; row = 0; break;
+        case World::Direction::left:  --coordinates.m_x; col = m_compositor.width() - 1; break;
+        case World::Direction::right: ++coordinates.m_x; col = 0; break;
+        default: break;
+    }
+
+    enter( coordinates, row, col );
+}
+
+// As Chat, but unencrypted, and with a message no one else will send so that
+// whoever hears it can tell when it was said.
+void Bot::chat( const String& text )
+{
+    Tuple tuple;
+    TupleRouter::setSourceActor( tuple, _Chat );
+    TupleRouter::setSourceID( tuple, m_tupleRouter.myID() );
+    TupleRouter::setTupleType( tuple, _ChatMessage );
+    m_coordinates.toValue( tuple[_coordinates] );
+    m_user.toValue( tuple[_user] );
+    tuple[_message] = text + " (" + m_name + "." + String( std::to_string( ++m_chats ).c_str() ) + ")";
+
+    m_tupleRouter.route( tuple );
+}
+
+// As Chat, when its coordinates change.
+void Bot::addChatRoutingCriteria()
+{
+    if( m_chatCoordinates == m_coordinates )
+    {
+        return;
+    }
+
+    TupleRoutingCriteria tupleRoutingCriteria;
+    tupleRoutingCriteria.m_types.push_back( new Value( _ChatMessage ) );
+    m_coordinates.toRoutingCriteria( tupleRoutingCriteria );
+    m_tupleRouter.sendAddRoutingCriteriaRequest( tupleRoutingCriteria );
+
+    if( !m_chatCoordinates.m_worldID.empty() )
+    {
+        TupleRoutingCriteria previousRoutingCriteria;
+        previousRoutingCriteria.m_types.push_back( new Value( _ChatMessage ) );
+        m_chatCoordinates.toRoutingCriteria( previousRoutingCriteria );
+        m_tupleRouter.sendRemoveRoutingCriteriaRequest( previousRoutingCriteria );
+    }
+
+    m_chatCoordinates = m_coordinates;
+}
+
+void Bot::fail()
+{
+#ifdef LOG_SWARM
+    LOG_DEBUG( m_name + ": Connection failed" );
+#endif
+    m_failed = true;
+    m_failures.increment();
+}
+
+} // namespace Swarm
+
+} // namespace Agape
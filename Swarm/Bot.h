@@ -0,0 +1,138 @@
+#ifndef AGAPE_SWARM_BOT_H
+#define AGAPE_SWARM_BOT_H
+
+#include "AssetLoaders/Factories/Linda2AssetLoaderFactory.h"
+#include "Audio/MIDIPlayers/NullMIDIPlayer.h"
+#include "Clocks/CClock.h"
+#include "Compressors/LZCompressor.h"
+#include "GraphicsDrivers/Headless.h"
+#include "Memories/RAMMemory.h"
+#include "Network/WebSocketsClientConnection.h"
+#include "PresenceLoaders/Factories/Linda2PresenceLoaderFactory.h"
+#include "SceneLoaders/Factories/Linda2SceneLoaderFactory.h"
+#include "Timers/NullTimer.h"
+#include "TupleRoutes/ReadableWritableTupleRoute.h"
+#include "TupleRoutes/TimingTupleRoute.h"
+#include "World/Compositor.h"
+#include "World/User.h"
+#include "World/WorldCoordinates.h"
+#include "ANSITerminal.h"
+#include "ConfigurationStore.h"
+#include "FunctionDispatcher.h"
+#include "ProgramManager.h"
+#include "RWBuffer.h"
+#include "RWCompressor.h"
+#include "Scenario.h"
+#include "String.h"
+#include "TupleDispatcher.h"
+#include "TupleRouter.h"
+#include "WebSockets.h"
+#include "Worldbook.h"
+
+namespace Agape
+{
+
+namespace Metrics
+{
+class Counter;
+class Histogram;
+} // namespace Metrics
+
+namespace Timers
+{
+class Factory;
+} // namespace Timers
+
+namespace Swarm
+{
+
+class Latencies;
+
+/// @brief One synthetic user: the client's own router, loaders and Compositor
+/// on a headless terminal, connected to Stratus and following a scenario.
+/// Everything but the connection's socket runs on whichever thread calls
+/// run(), which blocks while scenes load, as the client does.
+class Bot
+{
+public:
+    Bot( int number,
+         WSTLSClient& endpoint,
+         const String& url,
+         const Scenario& scenario,
+         Latencies& latencies,
+         Timers::Factory& timerFactory,
+         long startms );
+    ~Bot();
+
+    // Does the next step if it is due. Returns false once the scenario has
+    // finished or the connection has failed.
+    bool run();
+
+    bool failed() const;
+
+private:
+    void login();
+    void enter( const World::Coordinates& coordinates, int row, int col );
+    void walk( enum World::Direction::_Direction direction );
+    void chat( const String& text );
+    void addChatRoutingCriteria();
+    void fail();
+
+    String m_name;
+    const String m_url;
+    const Scenario& m_scenario;
+    unsigned int m_seed;
+
+    Memories::RAM m_configurationMemory;
+    ConfigurationStore m_configurationStore;
+    Worldbook m_worldbook;
+
+    Network::WebSocketsClientConnection m_connection;
+    RWBuffer m_rwBuffer;
+    Compressors::LZ m_compressor;
+    RWCompressor m_rwCompressor;
+    Linda2::TupleRoutes::ReadableWritable m_rwRoute;
+    Linda2::TupleRoutes::Timing m_route;
+    Linda2::TupleDispatcher m_tupleDispatcher;
+    Linda2::TupleRouter m_tupleRouter;
+
+    Carlo::FunctionDispatcher m_functionDispatcher;
+    Carlo::ProgramManager m_programManager;
+
+    SceneLoaders::Factories::Linda2 m_sceneLoaderFactory;
+    AssetLoaders::Factories::Linda2 m_assetLoaderFactory;
+    AssetLoaders::Factories::Linda2 m_programAssetLoaderFactory;
+    PresenceLoaders::Factories::Linda2 m_presenceLoaderFactory;
+
+    GraphicsDrivers::Headless m_graphicsDriver;
+    Timers::Null m_animationTimer;
+    ANSITerminal m_terminal;
+    Clocks::C m_clock;
+    Audio::MIDIPlayers::Null m_midiPlayer;
+    World::Compositor m_compositor;
+
+    World::User m_user;
+    World::Coordinates m_coordinates;
+    World::Coordinates m_chatCoordinates;
+    bool m_entered;
+
+    Timer* m_timer;
+    long m_duems;
+    bool m_opened;
+    bool m_failed;
+
+    unsigned int m_step;
+    int m_walked;
+    int m_chats;
+
+    Metrics::Histogram& m_connectHistogram;
+    Metrics::Histogram& m_enterHistogram;
+    Metrics::Counter& m_connected;
+    Metrics::Counter& m_failures;
+};
+
+} // namespace Swarm
+
+} // namespace Agape
+
+#endif // AGAPE_SWARM_BOT_H
@@ -0,0 +1,70 @@
+#include "Collections.h"
+#include "Latencies.h"
+#include "String.h"
+
+#include <mutex>
+
+namespace
+{
+    // Messages still unheard after this long aren't going to be.
+    const long long _forgetus( 60000000LL );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Swarm
+{
+
+Latencies::Latencies() :
+  m_prunedus( 0 )
+{
+}
+
+void Latencies::sent( const String& message, long long us )
+{
+    std::scoped_lock lock( m_mutex );
+
+    if( ( us - m_prunedus ) > _forgetus )
+    {
+        prune( us );
+    }
+
+    m_sent[message] = us;
+}
+
+bool Latencies::received( const String& message, long long& sentus )
+{
+    std::scoped_lock lock( m_mutex );
+
+    Map< String, long long >::const_iterator it( m_sent.find( message ) );
+    if( it == m_sent.end() )
+    {
+        return false;
+    }
+
+    sentus = it->second;
+    return true;
+}
+
+void Latencies::prune( long long nowus )
+{
+    Map< String, long long >::iterator it( m_sent.begin() );
+    while( it != m_sent.end() )
+    {
+        if( ( nowus - it->second ) > _forgetus )
+        {
+            it = m_sent.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    m_prunedus = nowus;
+}
+
+} // namespace Swarm
+
+} // namespace Agape
@@ -0,0 +1,41 @@
+#ifndef AGAPE_SWARM_LATENCIES_H
+#define AGAPE_SWARM_LATENCIES_H
+
+#include "Collections.h"
+#include "String.h"
+
+#include <mutex>
+
+namespace Agape
+{
+
+namespace Swarm
+{
+
+/// @brief When each chat message was sent, shared by every bot, so that each
+/// bot that hears it can tell how long it took to reach them.
+class Latencies
+{
+public:
+    Latencies();
+
+    void sent( const String& message, long long us );
+
+    // Returns false if the message wasn't one of ours, or was sent so long
+    // ago it has been forgotten.
+    bool received( const String& message, long long& sentus );
+
+private:
+    void prune( long long nowus );
+
+    Map< String, long long > m_sent;
+    long long m_prunedus;
+
+    std::mutex m_mutex;
+};
+
+} // namespace Swarm
+
+} // namespace Agape
+
+#endif // AGAPE_SWARM_LATENCIES_H
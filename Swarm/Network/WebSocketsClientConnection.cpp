@@ -0,0 +1,173 @@
+#include "Loggers/Logger.h"
+#include "Utils/LiteStream.h"
+#include "Utils/StrToHex.h"
+#include "WebSockets.h"
+#include "WebSocketsClientConnection.h"
+
+#include <functional>
+#include <mutex>
+#include <string>
+
+using namespace std::placeholders;
+
+namespace
+{
+    const int bufferCapacity( 32768 );
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Network
+{
+
+WebSocketsClientConnection::WebSocketsClientConnection( WSTLSClient& endpoint ) :
+  m_endpoint( endpoint ),
+  m_buffer( bufferCapacity ),
+  m_isOpen( false ),
+  m_error( false )
+{
+}
+
+WebSocketsClientConnection::~WebSocketsClientConnection()
+{
+    close();
+}
+
+bool WebSocketsClientConnection::open( const String& url )
+{
+    websocketpp::lib::error_code ec;
+    m_connection = m_endpoint.get_connection( url.c_str(), ec );
+    if( ec )
+    {
+#ifdef LOG_SWARM
+        LOG_DEBUG( String( "WebSocketsClientConnection: " ) + ec.message().c_str() );
+#endif
+        m_error = true;
+        return false;
+    }
+
+    m_connection->add_subprotocol( "Linda2" );
+    m_connection->set_open_handler( std::bind( &WebSocketsClientConnection::onOpen, this, _1 ) );
+    m_connection->set_fail_handler( std::bind( &WebSocketsClientConnection::onFail, this, _1 ) );
+    m_connection->set_close_handler( std::bind( &WebSocketsClientConnection::onClose, this, _1 ) );
+    m_connection->set_message_handler( std::bind( &WebSocketsClientConnection::onMessage, this, _1, _2 ) );
+
+    m_error = false;
+    m_endpoint.connect( m_connection );
+
+    return true;
+}
+
+void WebSocketsClientConnection::close()
+{
+    if( m_connection && m_isOpen )
+    {
+        websocketpp::lib::error_code ec;
+        m_connection->close( websocketpp::close::status::going_away, "", ec );
+    }
+
+    m_isOpen = false;
+}
+
+bool WebSocketsClientConnection::isOpen() const
+{
+    return m_isOpen;
+}
+
+bool WebSocketsClientConnection::error()
+{
+    return m_error;
+}
+
+int WebSocketsClientConnection::read( char* data, int len )
+{
+    std::scoped_lock lock( m_mutex );
+
+    int numRead( m_buffer.pop( data, len ) );
+
+    if( !m_overflow.empty() )
+    {
+        int numBuffered( m_buffer.push( m_overflow.data(), m_overflow.length() ) );
+        m_overflow.erase( 0, numBuffered );
+    }
+
+    return numRead;
+}
+
+int WebSocketsClientConnection::write( const char* data, int len )
+{
+    if( !m_isOpen )
+    {
+        return 0;
+    }
+
+#ifdef LOG_WS
+    if( len > 0 )
+    {
+        LOG_DEBUG( "WebSocketsClientConnection: Writing" );
+        hexDump( data, len );
+    }
+#endif
+
+    websocketpp::lib::error_code ec( m_connection->send( data, len, websocketpp::frame::opcode::binary ) );
+    if( ec )
+    {
+        m_error = true;
+        return 0;
+    }
+
+    return len;
+}
+
+void WebSocketsClientConnection::onOpen( websocketpp::connection_hdl connectionHandle )
+{
+    m_isOpen = true;
+}
+
+void WebSocketsClientConnection::onFail( websocketpp::connection_hdl connectionHandle )
+{
+#ifdef LOG_SWARM
+    LOG_DEBUG( String( "WebSocketsClientConnection: Failed: " ) + m_connection->get_ec().message().c_str() );
+#endif
+    m_isOpen = false;
+    m_error = true;
+}
+
+void WebSocketsClientConnection::onClose( websocketpp::connection_hdl connectionHandle )
+{
+    m_isOpen = false;
+    m_error = true;
+}
+
+void WebSocketsClientConnection::onMessage( websocketpp::connection_hdl connectionHandle,
+                                            WSTLSClient::message_ptr message )
+{
+    std::scoped_lock lock( m_mutex );
+
+    const std::string& payload( message->get_payload() );
+
+#ifdef LOG_WS
+    LiteStream stream;
+    stream << "WS Read " << (unsigned int)payload.length();
+    LOG_DEBUG( stream.str() );
+    hexDump( &payload[0], payload.length() );
+#endif
+
+    if( !m_overflow.empty() )
+    {
+        m_overflow.append( payload );
+    }
+    else
+    {
+        int numBuffered( m_buffer.push( payload.data(), payload.length() ) );
+        if( numBuffered < (int)payload.length() )
+        {
+            m_overflow.assign( payload, numBuffered, std::string::npos );
+        }
+    }
+}
+
+} // namespace Network
+
+} // namespace Agape
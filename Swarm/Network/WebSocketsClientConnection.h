@@ -0,0 +1,62 @@
+#ifndef AGAPE_NETWORK_WEBSOCKETSCLIENTCONNECTION_H
+#define AGAPE_NETWORK_WEBSOCKETSCLIENTCONNECTION_H
+
+#include "Utils/RingBuffer.h"
+#include "ReadableWritable.h"
+#include "String.h"
+#include "WebSockets.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+namespace Agape
+{
+
+namespace Network
+{
+
+/// @brief One client's connection to Stratus, as the server's
+/// WebSocketsConnection but from the other end. Many share one endpoint, and
+/// so one thread handling their sockets.
+class WebSocketsClientConnection : public ReadableWritable
+{
+public:
+    WebSocketsClientConnection( WSTLSClient& endpoint );
+    ~WebSocketsClientConnection();
+
+    bool open( const String& url );
+    void close();
+
+    bool isOpen() const;
+    virtual bool error();
+
+    virtual int read( char* data, int len );
+    virtual int write( const char* data, int len );
+
+private:
+    void onOpen( websocketpp::connection_hdl connectionHandle );
+    void onFail( websocketpp::connection_hdl connectionHandle );
+    void onClose( websocketpp::connection_hdl connectionHandle );
+    void onMessage( websocketpp::connection_hdl connectionHandle,
+                    WSTLSClient::message_ptr message );
+
+    WSTLSClient& m_endpoint;
+    WSTLSClient::connection_ptr m_connection;
+
+    RingBuffer< char > m_buffer;
+
+    // As WebSocketsConnection: what doesn't fit in m_buffer waits here, in
+    // order, until read.
+    std::string m_overflow;
+
+    std::mutex m_mutex;
+    std::atomic< bool > m_isOpen;
+    std::atomic< bool > m_error;
+};
+
+} // namespace Network
+
+} // namespace Agape
+
+#endif // AGAPE_NETWORK_WEBSOCKETSCLIENTCONNECTION_H
@@ -0,0 +1,142 @@
+#include "World/Direction.h"
+#include "Collections.h"
+#include "Scenario.h"
+#include "String.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace Agape
+{
+
+namespace Swarm
+{
+
+Scenario::Scenario() :
+  m_repeatFrom( 0 )
+{
+}
+
+bool Scenario::load( const String& filename, String& error )
+{
+    m_steps.clear();
+    m_repeatFrom = -1;
+
+    std::ifstream file( filename.c_str() );
+    if( !file )
+    {
+        error = "Can't read " + filename;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber( 0 );
+    while( std::getline( file, line ) )
+    {
+        ++lineNumber;
+
+        size_t start( line.find_first_not_of( " \t\r" ) );
+        if( ( start == std::string::npos ) || ( line[start] == '#' ) )
+        {
+            continue;
+        }
+
+        Step step;
+        if( !parse( String( line.c_str() + start ), step ) )
+        {
+            error = filename + ":" + String( std::to_string( lineNumber ).c_str() ) + ": Can't understand \"" + String( line.c_str() ) + "\"";
+            return false;
+        }
+
+        if( ( step.m_type == Step::enter ) && ( m_repeatFrom < 0 ) )
+        {
+            m_repeatFrom = m_steps.size() + 1;
+        }
+
+        m_steps.push_back( step );
+    }
+
+    if( m_repeatFrom < 0 )
+    {
+        m_repeatFrom = 0;
+    }
+
+    return true;
+}
+
+const Vector< Scenario::Step >& Scenario::steps() const
+{
+    return m_steps;
+}
+
+int Scenario::repeatFrom() const
+{
+    return m_repeatFrom;
+}
+
+bool Scenario::parse( const String& line, Step& step )
+{
+    std::istringstream stream( line.c_str() );
+    std::string command;
+    stream >> command;
+
+    if( command == "login" )
+    {
+        step.m_type = Step::login;
+        return true;
+    }
+    else if( command == "enter" )
+    {
+        std::string worldID;
+        step.m_type = Step::enter;
+        stream >> worldID >> step.m_x >> step.m_y;
+        step.m_text = worldID.c_str();
+        return !stream.fail();
+    }
+    else if( command == "walk" )
+    {
+        std::string direction;
+        step.m_type = Step::walk;
+        stream >> direction >> step.m_count;
+
+        if( direction == "up" ) step.m_direction = World::Direction::up;
+        else if( direction == "down" ) step.m_direction = World::Direction::down;
+        else if( direction == "left" ) step.m_direction = World::Direction::left;
+        else if( direction == "right" ) step.m_direction = World::Direction::right;
+        else if( direction != "random" ) return false;
+
+        return !stream.fail() && ( step.m_count > 0 );
+    }
+    else if( command == "chat" )
+    {
+        std::string text;
+        step.m_type = Step::chat;
+        std::getline( stream >> std::ws, text );
+        step.m_text = text.c_str();
+        return !step.m_text.empty();
+    }
+    else if( command == "teleport" )
+    {
+        step.m_type = Step::teleport;
+        stream >> step.m_x >> step.m_y;
+        return !stream.fail();
+    }
+    else if( command == "wait" )
+    {
+        step.m_type = Step::wait;
+        stream >> step.m_count;
+        return !stream.fail() && ( step.m_count >= 0 );
+    }
+    else if( command == "repeat" )
+    {
+        step.m_type = Step::repeat;
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace Swarm
+
+} // namespace Agape
@@ -0,0 +1,73 @@
+#ifndef AGAPE_SWARM_SCENARIO_H
+#define AGAPE_SWARM_SCENARIO_H
+
+#include "World/Direction.h"
+#include "Collections.h"
+#include "String.h"
+
+namespace Agape
+{
+
+namespace Swarm
+{
+
+/// @brief What each bot does, read from a text file with one step per line.
+/// Blank lines and those starting '#' are ignored.
+///
+///   login                      Authenticate, once connected.
+///   enter <worldID> <x> <y>    Render the scene and appear in it.
+///   walk <direction> <steps>   up, down, left, right or random, crossing
+///                              into the next scene at an edge.
+///   chat <text>                Say something to the scene.
+///   teleport <x> <y>           Jump to another scene in the same world.
+///   wait <ms>                  Do nothing for a while.
+///   repeat                     Start again from just after the first enter.
+class Scenario
+{
+public:
+    struct Step
+    {
+        enum Type
+        {
+            login,
+            enter,
+            walk,
+            chat,
+            teleport,
+            wait,
+            repeat
+        };
+
+        Step() : m_type( wait ), m_direction( World::Direction::none ), m_x( 0 ), m_y( 0 ), m_count( 0 ) {}
+
+        enum Type m_type;
+        String m_text; // World ID or chat message.
+        enum World::Direction::_Direction m_direction; // none for random.
+        int m_x;
+        int m_y;
+        int m_count; // Steps to walk or ms to wait.
+    };
+
+    // Returns false, with a message naming the line, if the file can't be
+    // read or a step isn't understood.
+    Scenario();
+
+    bool load( const String& filename, String& error );
+
+    const Vector< Step >& steps() const;
+
+    // Where repeat goes back to.
+    int repeatFrom() const;
+
+private:
+    bool parse( const String& line, Step& step );
+
+    Vector< Step > m_steps;
+    int m_repeatFrom;
+};
+
+} // namespace Swarm
+
+} // namespace Agape
+
+#endif // AGAPE_SWARM_SCENARIO_H
@@ -0,0 +1,125 @@
+#include "Metrics/Histogram.h"
+#include "Metrics/Registry.h"
+#include "Metrics/Timed.h"
+#include "TupleRoutes/TimingTupleRoute.h"
+#include "Collections.h"
+#include "Latencies.h"
+#include "String.h"
+#include "StringConstants.h"
+#include "Tuple.h"
+#include "TupleRouter.h"
+
+namespace
+{
+    const Agape::String _request( "Request" );
+    const Agape::String _response( "Response" );
+    const Agape::String _prefix( "swarm." );
+
+    // A response that never came shouldn't hold up those that follow forever.
+    const unsigned int _maxPending( 64 );
+
+    bool endsWith( const Agape::String& type, const Agape::String& suffix, Agape::String& kind )
+    {
+        if( ( type.length() <= suffix.length() ) ||
+            ( type.compare( type.length() - suffix.length(), suffix.length(), suffix ) != 0 ) )
+        {
+            return false;
+        }
+
+        kind = type.substr( 0, type.length() - suffix.length() );
+        return true;
+    }
+} // Anonymous namespace
+
+namespace Agape
+{
+
+namespace Linda2
+{
+
+namespace TupleRoutes
+{
+
+Timing::Timing( const String& routeName, TupleRoute& route, Swarm::Latencies& latencies ) :
+  TupleRoute( routeName ),
+  m_route( route ),
+  m_latencies( latencies )
+{
+}
+
+bool Timing::haveIncoming()
+{
+    return m_route.haveIncoming();
+}
+
+bool Timing::receiveTuple( Tuple& tuple )
+{
+    if( !m_route.receiveTuple( tuple ) )
+    {
+        return false;
+    }
+
+    const String& type( TupleRouter::tupleType( tuple ) );
+    String kind;
+    if( endsWith( type, _response, kind ) )
+    {
+        Map< String, Deque< long long > >::iterator it( m_pending.find( kind ) );
+        if( ( it != m_pending.end() ) && !it->second.empty() )
+        {
+            record( kind, Metrics::nowus() - it->second.front() );
+            it->second.pop_front();
+        }
+    }
+    else if( ( type == _ChatMessage ) && tuple.hasValue( _message ) )
+    {
+        long long sentus;
+        if( m_latencies.received( (const String&)tuple[_message], sentus ) )
+        {
+            record( type, Metrics::nowus() - sentus );
+        }
+    }
+
+    return true;
+}
+
+void Timing::run()
+{
+    m_route.run();
+}
+
+bool Timing::error() const
+{
+    return m_route.error();
+}
+
+bool Timing::_sendTuple( const Tuple& tuple )
+{
+    const String& type( TupleRouter::tupleType( tuple ) );
+    String kind;
+    if( endsWith( type, _request, kind ) )
+    {
+        Deque< long long >& pending( m_pending[kind] );
+        if( pending.size() >= _maxPending )
+        {
+            pending.pop_front();
+        }
+        pending.push_back( Metrics::nowus() );
+    }
+    else if( ( type == _ChatMessage ) && tuple.hasValue( _message ) )
+    {
+        m_latencies.sent( (const String&)tuple[_message], Metrics::nowus() );
+    }
+
+    return m_route.sendTuple( tuple, true );
+}
+
+void Timing::record( const String& kind, long long us )
+{
+    Metrics::Registry::getInstance().histogram( _prefix + kind ).record( us );
+}
+
+} // namespace TupleRoutes
+
+} // namespace Linda2
+
+} // namespace Agape
@@ -0,0 +1,59 @@
+#ifndef AGAPE_LINDA2_TUPLE_ROUTES_TIMING_H
+#define AGAPE_LINDA2_TUPLE_ROUTES_TIMING_H
+
+#include "TupleRoutes/TupleRoute.h"
+#include "Collections.h"
+#include "String.h"
+
+namespace Agape
+{
+
+namespace Swarm
+{
+class Latencies;
+} // namespace Swarm
+
+namespace Linda2
+{
+
+class Tuple;
+
+namespace TupleRoutes
+{
+
+/// @brief Passes everything to and from another route, timing the round trip
+/// of each request to its response in histograms named for the request, e.g.
+/// "swarm.Scene" for a SceneRequest answered by a SceneResponse, and of each
+/// chat message to everyone who hears it, in "swarm.ChatMessage".
+///
+/// Responses are matched to the oldest outstanding request of their kind,
+/// which is exact for the synchronous loaders.
+class Timing : public TupleRoute
+{
+public:
+    Timing( const String& routeName, TupleRoute& route, Swarm::Latencies& latencies );
+
+    virtual bool haveIncoming();
+    virtual bool receiveTuple( Tuple& tuple );
+    virtual void run();
+    virtual bool error() const;
+
+private:
+    virtual bool _sendTuple( const Tuple& tuple );
+
+    void record( const String& kind, long long us );
+
+    TupleRoute& m_route;
+    Swarm::Latencies& m_latencies;
+
+    // Send times of requests awaiting responses, oldest first, by kind.
+    Map< String, Deque< long long > > m_pending;
+};
+
+} // namespace TupleRoutes
+
+} // namespace Linda2
+
+} // namespace Agape
+
+#endif // AGAPE_LINDA2_TUPLE_ROUTES_TIMING_H
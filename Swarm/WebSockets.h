@@ -0,0 +1,11 @@
+#ifndef AGAPE_SWARM_WEBSOCKETS_H
+#define AGAPE_SWARM_WEBSOCKETS_H
+
+#include <websocketpp/config/asio_client.hpp>
+#include <websocketpp/client.hpp>
+
+typedef websocketpp::client< websocketpp::config::asio_tls_client > WSTLSClient;
+
+typedef websocketpp::lib::shared_ptr<websocketpp::lib::asio::ssl::context> context_ptr;
+
+#endif // AGAPE_SWARM_WEBSOCKETS_H
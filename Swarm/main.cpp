@@ -0,0 +1,157 @@
+#include "Loggers/Logger.h"
+#include "Loggers/StreamLogger.h"
+#include "Metrics/Registry.h"
+#include "Timers/Factories/HighResTimerFactory.h"
+#include "Bot.h"
+#include "Collections.h"
+#include "Latencies.h"
+#include "ReadableWritable.h"
+#include "Scenario.h"
+#include "String.h"
+#include "WebSockets.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <stdlib.h>
+
+using namespace Agape;
+
+namespace
+{
+    const int _defaultThreads( 8 );
+    const long _connectIntervalms( 5 ); // So that thousands don't all arrive at once.
+    const int _idlems( 1 );
+
+    context_ptr onTLSInit( websocketpp::connection_hdl hdl )
+    {
+        namespace asio = websocketpp::lib::asio;
+
+        context_ptr ctx = websocketpp::lib::make_shared< asio::ssl::context >( asio::ssl::context::sslv23 );
+        try
+        {
+            ctx->set_options( asio::ssl::context::default_workarounds |
+                              asio::ssl::context::no_sslv2 |
+                              asio::ssl::context::no_sslv3 |
+                              asio::ssl::context::single_dh_use );
+            ctx->set_verify_mode( asio::ssl::verify_none ); // Our own Stratus, on loopback.
+        }
+        catch( std::exception& e )
+        {
+            LOG_DEBUG( String( "Swarm: TLS init: " ) + e.what() );
+        }
+
+        return ctx;
+    }
+
+    // Each thread drives its share of the bots, in turn, until all are done.
+    void runBots( Vector< Swarm::Bot* >& bots, int first, int stride, std::atomic< bool >& stopping )
+    {
+        bool running( true );
+        while( running && !stopping )
+        {
+            running = false;
+            for( unsigned int i( first ); i < bots.size(); i += stride )
+            {
+                running = bots[i]->run() || running;
+            }
+
+            std::this_thread::sleep_for( std::chrono::milliseconds( _idlems ) );
+        }
+    }
+} // Anonymous namespace
+
+int main( int argc, char** argv )
+{
+    Agape::Loggers::Stream streamLogger;
+    Agape::Logger::setInstance( &streamLogger );
+
+    if( argc < 4 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <wss://host:port> <scenario> <users> [threads] [seconds]" << std::endl;
+        return 1;
+    }
+
+    String url( argv[1] );
+    int numUsers( atoi( argv[3] ) );
+    int numThreads( ( argc > 4 ) ? atoi( argv[4] ) : _defaultThreads );
+    int seconds( ( argc > 5 ) ? atoi( argv[5] ) : 0 );
+    if( ( numUsers <= 0 ) || ( numThreads <= 0 ) )
+    {
+        std::cerr << "Need at least one user and one thread" << std::endl;
+        return 1;
+    }
+
+    Swarm::Scenario scenario;
+    String error;
+    if( !scenario.load( argv[2], error ) )
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    LOG_DEBUG( "Swarm starting" );
+    LOG_DEBUG( "(C) Lauren Glina 2019-2026" );
+
+    Timers::Factories::HighRes timerFactory;
+    ReadableWritable::setTimerFactory( &timerFactory );
+
+    WSTLSClient endpoint;
+    endpoint.clear_access_channels( websocketpp::log::alevel::all );
+    endpoint.set_error_channels( websocketpp::log::elevel::fatal );
+    endpoint.init_asio();
+    endpoint.set_tls_init_handler( std::bind( &onTLSInit, std::placeholders::_1 ) );
+    endpoint.start_perpetual();
+    std::thread endpointThread( std::bind( &WSTLSClient::run, &endpoint ) );
+
+    Swarm::Latencies latencies;
+    Vector< Swarm::Bot* > bots;
+    for( int i( 0 ); i < numUsers; ++i )
+    {
+        bots.push_back( new Swarm::Bot( i, endpoint, url, scenario, latencies, timerFactory, i * _connectIntervalms ) );
+    }
+
+    std::atomic< bool > stopping( false );
+    Vector< std::thread* > threads;
+    for( int i( 0 ); i < numThreads; ++i )
+    {
+        threads.push_back( new std::thread( std::bind( &runBots, std::ref( bots ), i, numThreads, std::ref( stopping ) ) ) );
+    }
+
+    if( seconds > 0 )
+    {
+        std::this_thread::sleep_for( std::chrono::seconds( seconds ) );
+        stopping = true;
+    }
+
+    for( Vector< std::thread* >::iterator it( threads.begin() ); it != threads.end(); ++it )
+    {
+        ( *it )->join();
+        delete( *it );
+    }
+
+    int failed( 0 );
+    for( Vector< Swarm::Bot* >::iterator it( bots.begin() ); it != bots.end(); ++it )
+    {
+        if( ( *it )->failed() ) ++failed;
+    }
+
+    // Stop the endpoint before the bots whose connections it calls back.
+    endpoint.stop_perpetual();
+    endpoint.stop();
+    endpointThread.join();
+
+    for( Vector< Swarm::Bot* >::iterator it( bots.begin() ); it != bots.end(); ++it )
+    {
+        delete( *it );
+    }
+
+    std::cout << Metrics::Registry::getInstance().dump();
+    std::cout << numUsers << " users, " << failed << " failed" << std::endl;
+
+    return( ( failed == 0 ) ? 0 : 1 );
+}
@@ -8,6 +8,7 @@
 #include "Audio/MIDIPlayers/ALSAMIDIPlayer.h"
 #include "Audio/MIDIPlayers/NullMIDIPlayer.h"
 #include "Clocks/VRTimeClock.h"
+#include "Compressors/LZCompressor.h"
 #include "Encryptors/AES/AESBlockEncryptor.h"
 #include "Encryptors/BlockEncryptor.h"
 #include "EntropySources/CRand.h"
@@ -22,7 +23,9 @@
 #include "Platforms/SimulatedPlatform.h"
 #include "PresenceLoaders/Factories/EncryptedPresenceLoaderFactory.h"
 #include "PresenceLoaders/Factories/Linda2PresenceLoaderFactory.h"
+#include "SceneLoaders/Factories/CacheSceneLoaderFactory.h"
 #include "SceneLoaders/Factories/EncryptedSceneLoaderFactory.h"
+#include "SceneLoaders/Factories/KiamaFSSceneLoaderFactory.h"
 #include "SceneLoaders/Factories/Linda2SceneLoaderFactory.h"
 #include "TelegramLoaders/Factories/Linda2TelegramLoaderFactory.h"
 #include "Timers/Factories/CTimerFactory.h"
@@ -35,6 +38,7 @@
 #include "ConfigurationStore.h"
 #include "KiamaFS.h"
 #include "RWBuffer.h"
+#include "RWCompressor.h"
 #include "SimulatedOnlineClientBuilder.h"
 #include "TupleRouter.h"
 
@@ -70,9 +74,9 @@ void SimulatedOnline::_unbuild()
 void SimulatedOnline::_deleteMembers()
 {
     LOG_DEBUG( "SimulatedOnlineClientBuilder: Deleting members" );
-    delete( m_miniMapAssetCache );
-    delete( m_miniMapAssetLoaderBackingFactory );
     delete( m_presenceLoaderBackingFactory );
+    delete( m_sceneLoaderCacheFactory );
+    delete( m_sceneLoaderReplicaFactory );
     delete( m_sceneLoaderBackingFactory );
     delete( m_telegramAssetLoaderBackingFactory );
     delete( m_programAssetCache );
@@ -100,9 +104,9 @@ void SimulatedOnline::_setMembersNull()
     m_programAssetCache = nullptr;
     m_telegramAssetLoaderBackingFactory = nullptr;
     m_sceneLoaderBackingFactory = nullptr;
+    m_sceneLoaderReplicaFactory = nullptr;
+    m_sceneLoaderCacheFactory = nullptr;
     m_presenceLoaderBackingFactory = nullptr;
-    m_miniMapAssetLoaderBackingFactory = nullptr;
-    m_miniMapAssetCache = nullptr;
 }
 
 void SimulatedOnline::getMachineID()
@@ -162,8 +166,10 @@ void SimulatedOnline::buildInputDevice()
 
 void SimulatedOnline::buildTupleRoute()
 {
-    m_rwBuffer = new RWBuffer( 512, *m_lineDriver );
-    m_tupleRoute = new Linda2::TupleRoutes::ReadableWritable( "Modem", *m_rwBuffer );
+    m_rwBuffer = new RWBuffer( 8192, *m_lineDriver ); // A whole compressed frame per message.
+    m_compressor = new Compressors::LZ;
+    m_rwCompressor = new RWCompressor( *m_compressor, *m_rwBuffer );
+    m_tupleRoute = new Linda2::TupleRoutes::ReadableWritable( "Modem", *m_rwCompressor );
 }
 
 void SimulatedOnline::buildClock()
@@ -247,7 +253,12 @@ void SimulatedOnline::buildSceneLoaderFactory()
     m_sceneLoaderBackingFactory = new SceneLoaders::Factories::Linda2( *m_tupleRouter,
                                                                        *m_timerFactory,
                                                                        true ); // true = attributes have encrypted names.
-    m_sceneLoaderFactory = new SceneLoaders::Factories::Encrypted( *m_sceneLoaderBackingFactory,
+    // Scenes are kept on flash as they come from the server, i.e. encrypted.
+    m_sceneLoaderReplicaFactory = new SceneLoaders::Factories::KiamaFS( *m_fs );
+    m_sceneLoaderCacheFactory = new SceneLoaders::Factories::Cache( *m_sceneLoaderBackingFactory,
+                                                                    *m_sceneLoaderReplicaFactory,
+                                                                    *m_timerFactory );
+    m_sceneLoaderFactory = new SceneLoaders::Factories::Encrypted( *m_sceneLoaderCacheFactory,
                                                                    *m_worldMetadata,
                                                                    *m_encryptorFactory,
                                                                    *m_hash );
@@ -264,6 +275,7 @@ void SimulatedOnline::buildPresenceLoaderFactory()
 void SimulatedOnline::buildTelegramLoaderFactory()
 {
     m_telegramLoaderFactory = new TelegramLoaders::Factories::Linda2( *m_tupleRouter, *m_timerFactory );
+    m_telegramIndexFS = m_fs;
 }
 
 void SimulatedOnline::buildMIDIPlayer()
@@ -299,16 +311,7 @@ void SimulatedOnline::buildSplash()
 
 void SimulatedOnline::buildMiniMapAssetLoaderFactory()
 {
-    m_miniMapAssetLoaderBackingFactory = new AssetLoaders::Factories::MiniMap( *m_miniMap );
-    m_miniMapAssetCache = new AssetLoaders::Caches::KiamaFSAssetCache( 200,
-                                                                       512,
-                                                                       *m_fs,
-                                                                       "map",
-                                                                       *m_hash,
-                                                                       *m_clock );
-    m_miniMapAssetLoaderFactory = new AssetLoaders::Factories::Cache( *m_miniMapAssetLoaderBackingFactory,
-                                                                      *m_miniMapAssetCache,
-                                                                      false );
+    m_miniMapAssetLoaderFactory = new AssetLoaders::Factories::MiniMap( *m_miniMap );
 }
 
 void SimulatedOnline::buildUpdate()
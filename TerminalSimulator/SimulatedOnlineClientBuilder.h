@@ -67,9 +67,9 @@ private:
     AssetLoaders::AssetCache* m_programAssetCache;
     AssetLoaders::Factory* m_telegramAssetLoaderBackingFactory;
     SceneLoaders::Factory* m_sceneLoaderBackingFactory;
+    SceneLoaders::Factory* m_sceneLoaderReplicaFactory;
+    SceneLoaders::Factory* m_sceneLoaderCacheFactory;
     PresenceLoaders::Factory* m_presenceLoaderBackingFactory;
-    AssetLoaders::Factory* m_miniMapAssetLoaderBackingFactory;
-    AssetLoaders::AssetCache* m_miniMapAssetCache;
 };
 
 } // namespace ClientBuilders
@@ -23,6 +23,11 @@ TerminalSimulator::TerminalSimulator( Chooser& chooser ) :
   m_currentBuilder( nullptr ),
   m_client( nullptr )
 {
+    // Run the client again once it has something to do, leaving Qt to wait
+    // for events in between.
+    m_timer.setSingleShot( true );
+    QObject::connect( &m_timer, &QTimer::timeout, this, &TerminalSimulator::run );
+    m_timer.start( 0 );
 }
 
 TerminalSimulator::~TerminalSimulator()
@@ -46,6 +51,8 @@ void TerminalSimulator::run()
     }
 
     m_client->run();
+
+    m_timer.start( m_client->msUntilReady() );
 }
 
 } // namespace Agape
@@ -67,10 +74,6 @@ int main( int argc, char** argv )
 
     Agape::TerminalSimulator ts( chooser );
 
-    QTimer timer;
-    QObject::connect( &timer, &QTimer::timeout, &ts, &Agape::TerminalSimulator::run );
-    timer.start( 10 );
-
     int retcode( app.exec() );
 
     return retcode;
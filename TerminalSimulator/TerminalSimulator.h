@@ -2,6 +2,7 @@
 #define AGAPE_TERMINAL_SIMULATOR_H
 
 #include <QObject>
+#include <QTimer>
 #include <memory>
 
 namespace Agape
@@ -25,6 +26,8 @@ private:
     ClientBuilder* m_currentBuilder;
     Client* m_client;
 
+    QTimer m_timer;
+
 public slots:
     void run();
 };
@@ -36,12 +36,15 @@ SOURCES += ../Agape/AssetLoaders/Caches/KiamaFSAssetCache.cpp \
            ../Agape/Audio/MIDIPlayers/NullMIDIPlayer.cpp \
            ../Agape/Audio/MIDIPlayer.cpp \
            ../Agape/Clocks/Clock.cpp \
+           ../Agape/Clocks/DisciplinedClock.cpp \
            ../Agape/Clocks/VRTimeClock.cpp \
+           ../Agape/Compressors/*.cpp \
            ../Agape/Encryptors/AES/*.cpp \
            ../Agape/Encryptors/AES/tiny-AES-c/aes.c \
            ../Agape/Encryptors/Factories/*.cpp \
            ../Agape/Encryptors/SHA256/*.c* \
            ../Agape/Encryptors/Utils/BIP39/*.c* \
+           ../Agape/Encryptors/Utils/BatchDecryptor.cpp \
            ../Agape/Encryptors/Utils/SecureIdentifier.cpp \
            ../Agape/Encryptors/*.cpp \
            ../Agape/EntropySources/CRand.cpp \
@@ -73,19 +76,25 @@ SOURCES += ../Agape/AssetLoaders/Caches/KiamaFSAssetCache.cpp \
            ../Agape/PresenceLoaders/OfflinePresenceLoader.cpp \
            ../Agape/PresenceLoaders/PresenceLoader.cpp \
            ../Agape/PresenceLoaders/PresenceRequest.cpp \
+           ../Agape/SceneLoaders/Factories/CacheSceneLoaderFactory.cpp \
            ../Agape/SceneLoaders/Factories/EncryptedSceneLoaderFactory.cpp \
            ../Agape/SceneLoaders/Factories/FileSceneLoaderFactory.cpp \
+           ../Agape/SceneLoaders/Factories/KiamaFSSceneLoaderFactory.cpp \
            ../Agape/SceneLoaders/Factories/Linda2SceneLoaderFactory.cpp \
+           ../Agape/SceneLoaders/CacheSceneLoader.cpp \
            ../Agape/SceneLoaders/EncryptedSceneLoader.cpp \
            ../Agape/SceneLoaders/FileSceneLoader.cpp \
+           ../Agape/SceneLoaders/KiamaFSSceneLoader.cpp \
            ../Agape/SceneLoaders/Linda2SceneLoader.cpp \
            ../Agape/SceneLoaders/Linda2SceneLoaderResponder.cpp \
            ../Agape/SceneLoaders/SceneLoader.cpp \
            ../Agape/SceneLoaders/SceneRequest.cpp \
+           ../Agape/SceneLoaders/WriteBehindSceneLoader.cpp \
            ../Agape/TelegramLoaders/Factories/FileTelegramLoaderFactory.cpp \
            ../Agape/TelegramLoaders/Factories/Linda2TelegramLoaderFactory.cpp \
            ../Agape/TelegramLoaders/FileTelegramLoader.cpp \
            ../Agape/TelegramLoaders/Linda2TelegramLoader.cpp \
+           ../Agape/TelegramLoaders/TelegramIndex.cpp \
            ../Agape/TelegramLoaders/TelegramLoader.cpp \
            ../Agape/Timers/Factories/*.cpp \
            ../Agape/Timers/*.cpp \
@@ -116,6 +125,8 @@ SOURCES += ../Agape/AssetLoaders/Caches/KiamaFSAssetCache.cpp \
            ../Agape/RandomReadableWritable.cpp \
            ../Agape/ReadableWritable.cpp \
            ../Agape/RWBuffer.cpp \
+           ../Agape/RWCompressor.cpp \
+           ../Agape/Scheduler.cpp \
            ../Agape/Session.cpp \
            ../Agape/String.cpp \
            ../Agape/StringConstants.cpp \
@@ -148,6 +159,8 @@ SOURCES += ../Agape/AssetLoaders/Caches/KiamaFSAssetCache.cpp \
            ../Linda2/TupleRoutes/ReadableWritableTupleRoute.cpp \
            ../Linda2/TupleRoutes/TupleRoute.cpp \
            ../Linda2/Promise.cpp \
+           ../Linda2/Reply.cpp \
+           ../Linda2/Requester.cpp \
            ../Linda2/Tuple.cpp \
            ../Linda2/TupleDispatcher.cpp \
            ../Linda2/TupleHandler.cpp \
@@ -164,6 +177,7 @@ HEADERS += ../Agape/AssetLoaders/*.h \
            ../Agape/Audio/*.h \
            ../Agape/Audio/MIDIPlayers/*.h \
            ../Agape/Clocks/*.h \
+           ../Agape/Compressors/*.h \
            ../Agape/Encryptors/*.h \
            ../Agape/Encryptors/AES/*.h \
            ../Agape/Encryptors/AES/tiny-AES-c/aes.h* \